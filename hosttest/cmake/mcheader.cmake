@@ -0,0 +1,43 @@
+#
+# Generates the C header for a message compiler (.mc) file.
+#
+#     cmake -DMC_SOURCE=<file.mc> -DMC_HEADER=<file.h> -P mcheader.cmake
+#
+# Lines starting with ';' are passed through to the header without the ';',
+# and every MessageId entry becomes a #define of its NTSTATUS value.  Only the
+# severity and facility names declared by the driver message files in this
+# tree are recognized; the message text itself is dropped.
+#
+
+set(SEVERITY_Success 0)
+set(SEVERITY_Informational 1)
+set(SEVERITY_Warning 2)
+set(SEVERITY_Error 3)
+set(FACILITY_System 0)
+set(FACILITY_RpcRuntime 2)
+set(FACILITY_RpcStubs 3)
+set(FACILITY_Io 4)
+set(FACILITY_Serial 6)
+
+file(STRINGS ${MC_SOURCE} LINES)
+set(HEADER "")
+foreach(LINE IN LISTS LINES)
+    if(LINE MATCHES "^;(.*)$")
+        string(APPEND HEADER "${CMAKE_MATCH_1}\n")
+    elseif(LINE MATCHES "^MessageId=(0x[0-9A-Fa-f]+) +Facility=([A-Za-z]+) +Severity=([A-Za-z]+) +SymbolicName=([A-Za-z0-9_]+)")
+        set(ID ${CMAKE_MATCH_1})
+        set(FACILITY ${FACILITY_${CMAKE_MATCH_2}})
+        set(SEVERITY ${SEVERITY_${CMAKE_MATCH_3}})
+        set(NAME ${CMAKE_MATCH_4})
+        if("${FACILITY}" STREQUAL "" OR "${SEVERITY}" STREQUAL "")
+            message(FATAL_ERROR "${MC_SOURCE}: unknown facility or severity for ${NAME}")
+        endif()
+
+        math(EXPR VALUE "(${SEVERITY} << 30) | (${FACILITY} << 16) | ${ID}"
+             OUTPUT_FORMAT HEXADECIMAL)
+
+        string(APPEND HEADER "#define ${NAME} ((NTSTATUS)${VALUE}L)\n")
+    endif()
+endforeach()
+
+file(WRITE ${MC_HEADER} "${HEADER}")
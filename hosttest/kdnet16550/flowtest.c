@@ -0,0 +1,261 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    flowtest.c
+
+Abstract:
+
+    Host unit test for the flow control threshold requests of the 16550
+    KDNET serial module, run against the 16750 register model.
+
+    KD_DEVICE_CONTROL_SERIAL_SET_FLOW_THRESHOLDS must round each request
+    down to a supported receive trigger level.
+    KD_DEVICE_CONTROL_SERIAL_TUNE_FLOW_THRESHOLDS must program a level that
+    loops back without overruns, and must leave the link statistics exactly
+    as the real traffic left them.
+
+--*/
+
+#include <stdio.h>
+#include "pch.h"
+#include "hostkdnet.h"
+#include "uart16550model.h"
+#include "hosttest.h"
+
+#define TEST_PORT 0x3F8
+#define TEST_BAUD_RATE 115200
+#define TEST_TRAFFIC_BYTES 200
+
+static UART16550_MODEL Model;
+static DEBUG_DEVICE_DESCRIPTOR Device;
+static KDNET_SHARED_DATA KdNet;
+
+static
+NTSTATUS
+DeviceControl (
+    __in ULONG RequestCode,
+    __in PVOID InputBuffer,
+    __in ULONG InputBufferLength,
+    __out PVOID OutputBuffer,
+    __in ULONG OutputBufferLength
+    )
+{
+    return HostKdNetExports.KdDeviceControl(KdNet.Hardware,
+                                            RequestCode,
+                                            InputBuffer,
+                                            InputBufferLength,
+                                            OutputBuffer,
+                                            OutputBufferLength);
+}
+
+static
+VOID
+StartModule (
+    VOID
+    )
+{
+    NTSTATUS Status;
+
+    Uart16550ModelInitialize(&Model, TEST_PORT, 16, TRUE);
+    Model.AccessNanoseconds = 1000;
+    HostSetIoModel(&Model.Io);
+    RtlZeroMemory(&Device, sizeof(Device));
+    Device.BaseAddress[0].Valid = TRUE;
+    Device.BaseAddress[0].Type = CmResourceTypePort;
+    Device.BaseAddress[0].TranslatedAddress = (PUCHAR)TEST_PORT;
+    Status = HostKdNetInitialize(NULL, &Device, KDNET_EXT_EXPORTS);
+    CHECK(NT_SUCCESS(Status), "KdInitializeLibrary %08x", Status);
+    RtlZeroMemory(&KdNet, sizeof(KdNet));
+    KdNet.SerialBaudRate = TEST_BAUD_RATE;
+    Status = HostKdNetStart(&KdNet, &Device);
+    CHECK(NT_SUCCESS(Status), "KdInitializeController %08x", Status);
+}
+
+static
+VOID
+TestSetRoundsDown (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Each requested watermark must come back as the highest supported receive
+    trigger level that does not exceed it.
+
+--*/
+
+{
+    static const ULONG Requests[][2] = {
+        { 1, 1 }, { 3, 1 }, { 4, 4 }, { 7, 4 }, { 8, 8 }, { 10, 8 },
+        { 13, 8 }, { 14, 14 }, { 15, 14 },
+    };
+
+    ULONG Index;
+    NTSTATUS Status;
+    KD_SERIAL_FLOW_THRESHOLDS Thresholds;
+
+    for (Index = 0; Index < RTL_NUMBER_OF(Requests); Index += 1) {
+        RtlZeroMemory(&Thresholds, sizeof(Thresholds));
+        Thresholds.FlowHighWatermark = Requests[Index][0];
+        Status = DeviceControl(KD_DEVICE_CONTROL_SERIAL_SET_FLOW_THRESHOLDS,
+                               &Thresholds,
+                               sizeof(Thresholds),
+                               &Thresholds,
+                               sizeof(Thresholds));
+
+        CHECK(NT_SUCCESS(Status), "request %u: status %08x",
+              Requests[Index][0], Status);
+
+        CHECK(Thresholds.FlowHighWatermark == Requests[Index][1],
+              "request %u: got %u, expected %u", Requests[Index][0],
+              Thresholds.FlowHighWatermark, Requests[Index][1]);
+
+        CHECK(Thresholds.FlowHighWatermark <= Requests[Index][0],
+              "request %u rounded up to %u", Requests[Index][0],
+              Thresholds.FlowHighWatermark);
+    }
+
+    RtlZeroMemory(&Thresholds, sizeof(Thresholds));
+    Thresholds.FlowHighWatermark = 16;
+    Status = DeviceControl(KD_DEVICE_CONTROL_SERIAL_SET_FLOW_THRESHOLDS,
+                           &Thresholds,
+                           sizeof(Thresholds),
+                           NULL,
+                           0);
+
+    CHECK(Status == STATUS_INVALID_PARAMETER,
+          "a full FIFO watermark returned %08x", Status);
+}
+
+static
+VOID
+TestTuneKeepsStatistics (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Runs real traffic in both directions, then tunes.  The statistics after
+    tuning must match those before it, even though the tuner pushed several
+    kilobytes through the UART in loopback.
+
+--*/
+
+{
+    KD_SERIAL_STATISTICS After;
+    KD_SERIAL_STATISTICS Before;
+    UCHAR Byte;
+    ULONG Index;
+    UCHAR PeerReceived[TEST_TRAFFIC_BYTES];
+    ULONG PollInterval;
+    ULONG Received;
+    UCHAR Traffic[TEST_TRAFFIC_BYTES];
+    ULONG Sent;
+    NTSTATUS Status;
+    KD_SERIAL_FLOW_THRESHOLDS Thresholds;
+
+    for (Index = 0; Index < sizeof(Traffic); Index += 1) {
+        Traffic[Index] = (UCHAR)(Index * 7);
+    }
+
+    Model.PeerHonorsRts = TRUE;
+    Uart16550ModelPeerSend(&Model, Traffic, sizeof(Traffic));
+    Uart16550ModelPeerReceive(&Model, PeerReceived, sizeof(PeerReceived));
+    Received = 0;
+    Sent = 0;
+    for (Index = 0; (Index < 100000) && (Received < sizeof(Traffic)); ++Index) {
+        if ((Sent < sizeof(Traffic)) &&
+            NT_SUCCESS(HostKdNetExports.KdWriteSerialByte(KdNet.Hardware,
+                                                          Traffic[Sent]))) {
+
+            Sent += 1;
+        }
+
+        if (NT_SUCCESS(HostKdNetExports.KdReadSerialByte(KdNet.Hardware,
+                                                         &Byte))) {
+
+            CHECK(Byte == Traffic[Received], "byte %u corrupted", Received);
+            Received += 1;
+        }
+
+        KeStallExecutionProcessor(20);
+    }
+
+    CHECK(Received == sizeof(Traffic), "received %u of %u", Received,
+          (ULONG)sizeof(Traffic));
+
+    Status = DeviceControl(KD_DEVICE_CONTROL_SERIAL_QUERY_STATISTICS,
+                           NULL,
+                           0,
+                           &Before,
+                           sizeof(Before));
+
+    CHECK(NT_SUCCESS(Status), "query %08x", Status);
+    CHECK(Before.BytesReceived == sizeof(Traffic), "counted %llu received",
+          (unsigned long long)Before.BytesReceived);
+
+    PollInterval = 400;
+    Status = DeviceControl(KD_DEVICE_CONTROL_SERIAL_TUNE_FLOW_THRESHOLDS,
+                           &PollInterval,
+                           sizeof(PollInterval),
+                           &Thresholds,
+                           sizeof(Thresholds));
+
+    CHECK(NT_SUCCESS(Status), "tune %08x", Status);
+    CHECK((Thresholds.FlowHighWatermark == 4) ||
+          (Thresholds.FlowHighWatermark == 8) ||
+          (Thresholds.FlowHighWatermark == 14),
+          "tuned to %u", Thresholds.FlowHighWatermark);
+
+    Status = DeviceControl(KD_DEVICE_CONTROL_SERIAL_QUERY_STATISTICS,
+                           NULL,
+                           0,
+                           &After,
+                           sizeof(After));
+
+    CHECK(NT_SUCCESS(Status), "query %08x", Status);
+    CHECK(After.BytesReceived == Before.BytesReceived,
+          "received %llu before tuning, %llu after",
+          (unsigned long long)Before.BytesReceived,
+          (unsigned long long)After.BytesReceived);
+
+    CHECK(After.BytesTransmitted == Before.BytesTransmitted,
+          "transmitted %llu before tuning, %llu after",
+          (unsigned long long)Before.BytesTransmitted,
+          (unsigned long long)After.BytesTransmitted);
+
+    CHECK(After.Overruns == Before.Overruns,
+          "%u overruns before tuning, %u after", Before.Overruns,
+          After.Overruns);
+
+    CHECK(After.NotClearToSend == Before.NotClearToSend,
+          "%u CTS stalls before tuning, %u after", Before.NotClearToSend,
+          After.NotClearToSend);
+
+    CHECK(After.CtsStallMicroseconds == Before.CtsStallMicroseconds,
+          "%llu us stalled before tuning, %llu after",
+          (unsigned long long)Before.CtsStallMicroseconds,
+          (unsigned long long)After.CtsStallMicroseconds);
+
+    CHECK(Model.Overruns == 0, "the model saw %llu overruns",
+          (unsigned long long)Model.Overruns);
+}
+
+int
+main (
+    VOID
+    )
+{
+    StartModule();
+    TestSetRoundsDown();
+    TestTuneKeepsStatistics();
+    HostKdNetStop(&KdNet);
+    return HostTestExit();
+}
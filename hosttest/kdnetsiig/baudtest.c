@@ -0,0 +1,332 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    baudtest.c
+
+Abstract:
+
+    Table driven host unit test for OX16PCI95XSolveBaudDivisor.
+
+    Each table entry gives a clock input and a requested rate along with the
+    status and, where they are known exactly, the register settings the
+    solver must produce.  Every result is also checked for consistency (the
+    settings must produce the reported rate) and against an independent
+    search of the TCR/CPR/divisor space, so that the solver is never worse
+    than the best achievable setting.
+
+--*/
+
+#include <stdio.h>
+#include "pch.h"
+#include "hosttest.h"
+
+#define SIIG_CLOCK 18432000
+#define OX16PCI954_MAX_CLOCK 60000000
+
+#define ANY_SETTING 0xFFFF
+
+typedef struct _BAUD_TEST_CASE {
+    ULONG ClockFrequency;
+    ULONG Rate;
+    NTSTATUS Status;
+    USHORT SampleClock;
+    USHORT Prescaler;
+    ULONG Divisor;
+    ULONG ActualRate;
+} BAUD_TEST_CASE, *PBAUD_TEST_CASE;
+
+static const BAUD_TEST_CASE BaudTestCases[] = {
+
+    //
+    // Standard rates the legacy table covered.  The 16x sample clock is
+    // encoded as zero in TCR and CPR 8 is a prescaler of 1.
+    //
+
+    { SIIG_CLOCK, 9600, STATUS_SUCCESS, 0, 8, 120, 9600 },
+    { SIIG_CLOCK, 115200, STATUS_SUCCESS, 0, 8, 10, 115200 },
+    { SIIG_CLOCK, 230400, STATUS_SUCCESS, 0, 8, 5, 230400 },
+    { SIIG_CLOCK, 921600, STATUS_SUCCESS, 0, 10, 1, 921600 },
+
+    //
+    // Rates that need the fractional prescaler or a reduced sample clock.
+    // The last three cannot be produced exactly from this clock, so only the
+    // reference search bounds their error.
+    //
+
+    { SIIG_CLOCK, 1152000, STATUS_SUCCESS, 0, 8, 1, 1152000 },
+    { SIIG_CLOCK, 1536000, STATUS_SUCCESS, 12, 8, 1, 1536000 },
+    { SIIG_CLOCK, 3072000, STATUS_SUCCESS, 6, 8, 1, 3072000 },
+    { SIIG_CLOCK, 4608000, STATUS_SUCCESS, 4, 8, 1, 4608000 },
+    { SIIG_CLOCK, 250000, STATUS_SUCCESS, ANY_SETTING, ANY_SETTING,
+      ANY_SETTING, 0 },
+    { SIIG_CLOCK, 1000000, STATUS_SUCCESS, ANY_SETTING, ANY_SETTING,
+      ANY_SETTING, 0 },
+    { SIIG_CLOCK, 2000000, STATUS_SUCCESS, ANY_SETTING, ANY_SETTING,
+      ANY_SETTING, 0 },
+
+    //
+    // Rates past what the clock can produce are reported with the closest
+    // setting, which is the fastest one.
+    //
+
+    { SIIG_CLOCK, 6000000, STATUS_NOT_SUPPORTED, 4, 8, 1, 4608000 },
+    { SIIG_CLOCK, 15000000, STATUS_NOT_SUPPORTED, 4, 8, 1, 4608000 },
+
+    //
+    // The slowest rates need the full divisor latch.
+    //
+
+    { SIIG_CLOCK, 50, STATUS_SUCCESS, ANY_SETTING, ANY_SETTING,
+      ANY_SETTING, 50 },
+    { SIIG_CLOCK, 300, STATUS_SUCCESS, 0, 8, 3840, 300 },
+
+    //
+    // A faster clock input reaches 15 Mbaud.
+    //
+
+    { OX16PCI954_MAX_CLOCK, 15000000, STATUS_SUCCESS, 4, 8, 1, 15000000 },
+    { OX16PCI954_MAX_CLOCK, 12000000, STATUS_SUCCESS, 5, 8, 1, 12000000 },
+
+    //
+    // Invalid parameters.
+    //
+
+    { SIIG_CLOCK, 0, STATUS_INVALID_PARAMETER, 0, 0, 0, 0 },
+    { 0, 115200, STATUS_INVALID_PARAMETER, 0, 0, 0, 0 },
+};
+
+static
+ULONG
+DecodeSampleClock (
+    __in UCHAR SampleClock
+    )
+{
+    return (SampleClock == 0) ? 16 : SampleClock;
+}
+
+static
+ULONG64
+RateFromSettings (
+    __in ULONG ClockFrequency,
+    __in POX16PCI95X_BAUD_SETTINGS Settings
+    )
+{
+    ULONG64 Denominator;
+
+    Denominator = (ULONG64)DecodeSampleClock(Settings->SampleClock) *
+                  Settings->Prescaler * Settings->Divisor;
+
+    return (((ULONG64)ClockFrequency * 8) + (Denominator / 2)) / Denominator;
+}
+
+static
+ULONG
+ReferenceErrorPpm (
+    __in ULONG ClockFrequency,
+    __in ULONG Rate
+    )
+
+/*++
+
+Routine Description:
+
+    Finds the lowest achievable error for Rate independently of the solver.
+    For each sample clock and prescaler only the two divisors that bracket
+    the exact quotient can be best, so only those are tried.
+
+--*/
+
+{
+    ULONG64 ActualRate;
+    ULONG64 BestError;
+    ULONG64 Denominator;
+    ULONG64 Divisor;
+    ULONG64 Error;
+    ULONG64 Exact;
+    ULONG Prescaler;
+    ULONG SampleClock;
+    ULONG Step;
+
+    BestError = MAXULONG64;
+    for (SampleClock = 4; SampleClock <= 16; SampleClock += 1) {
+        for (Prescaler = 8; Prescaler <= 255; Prescaler += 1) {
+            Exact = ((ULONG64)ClockFrequency * 8) /
+                    ((ULONG64)SampleClock * Prescaler * Rate);
+
+            for (Step = 0; Step < 2; Step += 1) {
+                Divisor = Exact + Step;
+                if ((Divisor == 0) || (Divisor > 0xFFFF)) {
+                    continue;
+                }
+
+                Denominator = (ULONG64)SampleClock * Prescaler * Divisor;
+                ActualRate = (((ULONG64)ClockFrequency * 8) +
+                              (Denominator / 2)) / Denominator;
+
+                Error = (ActualRate > Rate) ? ActualRate - Rate :
+                                              Rate - ActualRate;
+
+                Error = (Error * 1000000) / Rate;
+                if (Error < BestError) {
+                    BestError = Error;
+                }
+            }
+        }
+    }
+
+    return (ULONG)BestError;
+}
+
+static
+BOOLEAN
+CheckResult (
+    __in ULONG ClockFrequency,
+    __in ULONG Rate,
+    __in NTSTATUS Status,
+    __in POX16PCI95X_BAUD_SETTINGS Settings
+    )
+{
+    ULONG ReferencePpm;
+
+    if (RateFromSettings(ClockFrequency, Settings) != Settings->ActualRate) {
+        printf("FAIL clock %u rate %u: settings give %llu, reported %u\n",
+               ClockFrequency, Rate,
+               (unsigned long long)RateFromSettings(ClockFrequency, Settings),
+               Settings->ActualRate);
+
+        return FALSE;
+    }
+
+    ReferencePpm = ReferenceErrorPpm(ClockFrequency, Rate);
+    if (Settings->ErrorPpm > ReferencePpm) {
+        printf("FAIL clock %u rate %u: error %u ppm, %u ppm achievable\n",
+               ClockFrequency, Rate, Settings->ErrorPpm, ReferencePpm);
+
+        return FALSE;
+    }
+
+    if ((Status == STATUS_SUCCESS) && (Settings->ErrorPpm > 20000)) {
+        printf("FAIL clock %u rate %u: success with %u ppm error\n",
+               ClockFrequency, Rate, Settings->ErrorPpm);
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static
+ULONG
+RunTableTests (
+    VOID
+    )
+{
+    ULONG Failures;
+    ULONG Index;
+    OX16PCI95X_BAUD_SETTINGS Settings;
+    NTSTATUS Status;
+    const BAUD_TEST_CASE *Test;
+
+    Failures = 0;
+    for (Index = 0; Index < RTL_NUMBER_OF(BaudTestCases); Index += 1) {
+        Test = &BaudTestCases[Index];
+        Status = OX16PCI95XSolveBaudDivisor(Test->ClockFrequency,
+                                            Test->Rate,
+                                            &Settings);
+
+        if (Status != Test->Status) {
+            printf("FAIL clock %u rate %u: status %08x, expected %08x\n",
+                   Test->ClockFrequency, Test->Rate, Status, Test->Status);
+
+            Failures += 1;
+            continue;
+        }
+
+        if (Status == STATUS_INVALID_PARAMETER) {
+            continue;
+        }
+
+        if (((Test->SampleClock != ANY_SETTING) &&
+             (Settings.SampleClock != Test->SampleClock)) ||
+            ((Test->Prescaler != ANY_SETTING) &&
+             (Settings.Prescaler != Test->Prescaler)) ||
+            ((Test->Divisor != ANY_SETTING) &&
+             (Settings.Divisor != Test->Divisor)) ||
+            ((Test->ActualRate != 0) &&
+             (Settings.ActualRate != Test->ActualRate))) {
+
+            printf("FAIL clock %u rate %u: got TCR %u CPR %u DL %u "
+                   "(%u baud), expected TCR %u CPR %u DL %u (%u baud)\n",
+                   Test->ClockFrequency, Test->Rate, Settings.SampleClock,
+                   Settings.Prescaler, Settings.Divisor, Settings.ActualRate,
+                   Test->SampleClock, Test->Prescaler, Test->Divisor,
+                   Test->ActualRate);
+
+            Failures += 1;
+            continue;
+        }
+
+        if (CheckResult(Test->ClockFrequency, Test->Rate, Status,
+                        &Settings) == FALSE) {
+
+            Failures += 1;
+        }
+    }
+
+    return Failures;
+}
+
+static
+ULONG
+RunSweepTests (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Solves a geometric sweep of rates from 50 baud to 15 Mbaud and checks
+    every result against the reference search.
+
+--*/
+
+{
+    ULONG Failures;
+    ULONG64 Rate;
+    OX16PCI95X_BAUD_SETTINGS Settings;
+    NTSTATUS Status;
+
+    Failures = 0;
+    for (Rate = 50; Rate <= 15000000; Rate += (Rate / 7) + 1) {
+        Status = OX16PCI95XSolveBaudDivisor(SIIG_CLOCK, (ULONG)Rate,
+                                            &Settings);
+
+        if ((Status != STATUS_SUCCESS) && (Status != STATUS_NOT_SUPPORTED)) {
+            printf("FAIL rate %llu: status %08x\n", (unsigned long long)Rate,
+                   Status);
+
+            Failures += 1;
+            continue;
+        }
+
+        if (CheckResult(SIIG_CLOCK, (ULONG)Rate, Status, &Settings) == FALSE) {
+            Failures += 1;
+        }
+    }
+
+    return Failures;
+}
+
+int
+main (
+    VOID
+    )
+{
+    HostTestFailures += RunTableTests();
+    HostTestFailures += RunSweepTests();
+    return HostTestExit();
+}
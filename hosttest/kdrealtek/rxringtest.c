@@ -0,0 +1,584 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    rxringtest.c
+
+Abstract:
+
+    Host test for the receive ring of the Realtek KDNET module, run against
+    the RTL8168 register model with the ring self check compiled in.
+
+    Frames are received by the model's DMA engine into the ring the module
+    programmed, and are taken and released through the module's exports.
+    Every frame carries a pattern derived from its sequence number, which is
+    checked when the frame is taken and again when it is released, so a
+    descriptor handed back to the model while software still holds it shows
+    up as a corrupted frame.  The module's own ring check runs after every
+    receive and release and must never fail.
+
+    The test covers releases in ring order, releases out of order while the
+    model keeps receiving, a ring held entirely by software, a model running
+    low on descriptors and jumbo frames chained over several descriptors.
+    Refill batching is observed through the interrupt status register, which
+    the module clears once per refill.
+
+--*/
+
+#include <stdio.h>
+#include "pch.h"
+#include "hostkdnet.h"
+#include "rtl8168model.h"
+#include "hosttest.h"
+
+#define TEST_RING_OPTIONS "rxdepth=32 txdepth=16"
+#define TEST_JUMBO_OPTIONS "rxdepth=32 txdepth=16 bufsize=9000"
+#define TEST_RING_SIZE 32
+#define TEST_FRAME_LENGTH 1514
+#define TEST_MIN_FRAME_LENGTH 60
+#define TEST_JUMBO_LENGTH 9000
+#define TEST_MAX_HELD TEST_RING_SIZE
+
+extern ULONG KdNetRxRingCheckFailures;
+
+typedef struct _HELD_FRAME {
+    ULONG Handle;
+    PUCHAR Packet;
+    ULONG Length;
+    ULONG Sequence;
+} HELD_FRAME, *PHELD_FRAME;
+
+static const UCHAR ModelMac[6] = { 0x00, 0xE0, 0x4C, 0x68, 0x00, 0x01 };
+
+static RTL8168_MODEL Model;
+static DEBUG_DEVICE_DESCRIPTOR Device;
+static KDNET_SHARED_DATA KdNet;
+static UCHAR Frame[TEST_JUMBO_LENGTH];
+static ULONG Sequence;
+
+static
+BOOLEAN
+StartModule (
+    __in PCHAR LoaderOptions
+    )
+{
+    NTSTATUS Status;
+
+    Rtl8168ModelInitialize(&Model, RTL8168_MODEL_VERSION_8168B, ModelMac);
+    HostSetIoModel(&Model.Io);
+    RtlZeroMemory(&Device, sizeof(Device));
+    Device.BaseClass = PCI_CLASS_NETWORK_CTLR;
+    Device.VendorID = PCI_VID_REALTEK;
+    Device.BaseAddress[0].Valid = TRUE;
+    Device.BaseAddress[0].Type = CmResourceTypeMemory;
+    Device.BaseAddress[0].TranslatedAddress = Model.Registers;
+    Status = HostKdNetInitialize(LoaderOptions, &Device, KDNET_EXT_EXPORTS);
+    CHECK(NT_SUCCESS(Status), "KdInitializeLibrary %08x", Status);
+    RtlZeroMemory(&KdNet, sizeof(KdNet));
+    Status = HostKdNetStart(&KdNet, &Device);
+    CHECK(NT_SUCCESS(Status), "KdInitializeController %08x", Status);
+    KdNetRxRingCheckFailures = 0;
+    Sequence = 0;
+    return NT_SUCCESS(Status);
+}
+
+static
+VOID
+StopModule (
+    VOID
+    )
+{
+    CHECK(KdNetRxRingCheckFailures == 0, "%u ring check failures",
+          KdNetRxRingCheckFailures);
+
+    HostKdNetStop(&KdNet);
+    HostSetIoModel(NULL);
+}
+
+static
+UCHAR
+PatternByte (
+    __in ULONG FrameSequence,
+    __in ULONG Offset
+    )
+{
+    return (UCHAR)((FrameSequence * 31) + Offset + (Offset >> 8));
+}
+
+static
+BOOLEAN
+ReceiveFrame (
+    __in ULONG Length
+    )
+
+/*++
+
+Routine Description:
+
+    Has the model receive the next frame in sequence.
+
+Return Value:
+
+    TRUE if the model wrote the frame to the ring.
+
+--*/
+
+{
+    ULONG Offset;
+
+    for (Offset = 0; Offset < Length; Offset += 1) {
+        Frame[Offset] = PatternByte(Sequence, Offset);
+    }
+
+    if (Rtl8168ModelReceive(&Model, Frame, Length) == FALSE) {
+        return FALSE;
+    }
+
+    Sequence += 1;
+    return TRUE;
+}
+
+static
+BOOLEAN
+FrameIntact (
+    __in PHELD_FRAME Held
+    )
+{
+    ULONG Offset;
+
+    for (Offset = 0; Offset < Held->Length; Offset += 1) {
+        if (Held->Packet[Offset] != PatternByte(Held->Sequence, Offset)) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static
+BOOLEAN
+TakeFrame (
+    __out PHELD_FRAME Held,
+    __in ULONG FrameSequence,
+    __in ULONG Length
+    )
+
+/*++
+
+Routine Description:
+
+    Takes the next received frame from the module and checks that it is the
+    expected one.
+
+Return Value:
+
+    TRUE if a frame was taken.
+
+--*/
+
+{
+    PVOID Packet;
+    NTSTATUS Status;
+
+    Status = HostKdNetExports.KdGetRxPacket(KdNet.Hardware,
+                                            &Held->Handle,
+                                            &Packet,
+                                            &Held->Length);
+
+    CHECK(NT_SUCCESS(Status), "frame %u not received", FrameSequence);
+    if (!NT_SUCCESS(Status)) {
+        return FALSE;
+    }
+
+    Held->Packet = Packet;
+    Held->Sequence = FrameSequence;
+    CHECK(Held->Length == Length, "frame %u is %u bytes, sent %u",
+          FrameSequence, Held->Length, Length);
+
+    CHECK(FrameIntact(Held), "frame %u corrupted on receive", FrameSequence);
+    return TRUE;
+}
+
+static
+VOID
+ReleaseFrame (
+    __in PHELD_FRAME Held
+    )
+{
+    CHECK(FrameIntact(Held), "frame %u corrupted while held", Held->Sequence);
+    HostKdNetExports.KdReleaseRxPacket(KdNet.Hardware, Held->Handle);
+}
+
+static
+BOOLEAN
+RingEmpty (
+    VOID
+    )
+{
+    ULONG Handle;
+    ULONG Length;
+    PVOID Packet;
+
+    return !NT_SUCCESS(HostKdNetExports.KdGetRxPacket(KdNet.Hardware,
+                                                      &Handle,
+                                                      &Packet,
+                                                      &Length));
+}
+
+static
+VOID
+TestInOrder (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Frames taken and released one at a time go back to the model in batches
+    of REALTEK_RX_REFILL_BATCH.
+
+--*/
+
+{
+    ULONG Count;
+    HELD_FRAME Held;
+    ULONG64 Refills;
+
+    if (!StartModule(TEST_RING_OPTIONS)) {
+        return;
+    }
+
+    Refills = Model.InterruptStatusWrites;
+    for (Count = 0; Count < 1000; Count += 1) {
+        CHECK(ReceiveFrame(TEST_FRAME_LENGTH), "frame %u missed", Sequence);
+        if (TakeFrame(&Held, Sequence - 1, TEST_FRAME_LENGTH)) {
+            ReleaseFrame(&Held);
+        }
+    }
+
+    Refills = Model.InterruptStatusWrites - Refills;
+    CHECK(Refills == Count / REALTEK_RX_REFILL_BATCH,
+          "%llu refills for %u frames", (unsigned long long)Refills, Count);
+
+    CHECK(Model.RxMissed == 0, "%llu frames missed",
+          (unsigned long long)Model.RxMissed);
+
+    CHECK(Model.RxWraps == Count / TEST_RING_SIZE, "%llu ring wraps",
+          (unsigned long long)Model.RxWraps);
+
+    StopModule();
+}
+
+static
+VOID
+TestOutOfOrder (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Several frames are held at once and released in a different order each
+    round, while the model keeps receiving into the rest of the ring.  Held
+    frames must not be overwritten, and nothing may be missed.
+
+--*/
+
+{
+    static const ULONG Orders[][6] = {
+        { 5, 4, 3, 2, 1, 0 },
+        { 3, 0, 5, 1, 4, 2 },
+        { 1, 2, 3, 4, 5, 0 },
+        { 0, 2, 4, 1, 3, 5 },
+    };
+
+    HELD_FRAME Held[RTL_NUMBER_OF(Orders[0])];
+    ULONG Index;
+    ULONG Length;
+    ULONG Round;
+
+    if (!StartModule(TEST_RING_OPTIONS)) {
+        return;
+    }
+
+    for (Round = 0; Round < 200; Round += 1) {
+        for (Index = 0; Index < RTL_NUMBER_OF(Held); Index += 1) {
+            Length = TEST_MIN_FRAME_LENGTH + ((Round * 97 + Index * 251) %
+                     (TEST_FRAME_LENGTH - TEST_MIN_FRAME_LENGTH));
+
+            CHECK(ReceiveFrame(Length), "round %u frame %u missed", Round,
+                  Index);
+
+            TakeFrame(&Held[Index], Sequence - 1, Length);
+        }
+
+        //
+        // Keep the model receiving while the frames are held.
+        //
+
+        for (Index = 0; Index < 4; Index += 1) {
+            CHECK(ReceiveFrame(TEST_FRAME_LENGTH), "round %u extra %u missed",
+                  Round, Index);
+        }
+
+        for (Index = 0; Index < RTL_NUMBER_OF(Held); Index += 1) {
+            ReleaseFrame(&Held[Orders[Round % RTL_NUMBER_OF(Orders)][Index]]);
+        }
+
+        for (Index = 0; Index < 4; Index += 1) {
+            if (TakeFrame(&Held[0], Sequence - 4 + Index, TEST_FRAME_LENGTH)) {
+                ReleaseFrame(&Held[0]);
+            }
+        }
+    }
+
+    CHECK(RingEmpty(), "stray frame in the ring");
+    CHECK(Model.RxMissed == 0, "%llu frames missed",
+          (unsigned long long)Model.RxMissed);
+
+    StopModule();
+}
+
+static
+VOID
+TestFullRing (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    With every descriptor held by software the model misses frames and the
+    module has nothing new to return.  Releasing the oldest frame last keeps
+    the whole ring back until then, and it then goes back in one refill.
+
+--*/
+
+{
+    HELD_FRAME Held[TEST_MAX_HELD];
+    ULONG Index;
+    ULONG64 Refills;
+
+    if (!StartModule(TEST_RING_OPTIONS)) {
+        return;
+    }
+
+    for (Index = 0; Index < TEST_RING_SIZE; Index += 1) {
+        CHECK(ReceiveFrame(TEST_FRAME_LENGTH), "frame %u missed", Index);
+    }
+
+    CHECK(ReceiveFrame(TEST_FRAME_LENGTH) == FALSE,
+          "frame received into a full ring");
+
+    for (Index = 0; Index < TEST_RING_SIZE; Index += 1) {
+        TakeFrame(&Held[Index], Index, TEST_FRAME_LENGTH);
+    }
+
+    CHECK(RingEmpty(), "held frame returned again from a full ring");
+
+    Refills = Model.InterruptStatusWrites;
+    for (Index = TEST_RING_SIZE; Index > 0; Index -= 1) {
+        ReleaseFrame(&Held[Index - 1]);
+        if (Index > 1) {
+            CHECK(Model.InterruptStatusWrites == Refills,
+                  "refilled before the oldest frame was released");
+        }
+    }
+
+    CHECK(Model.InterruptStatusWrites == Refills + 1,
+          "%llu refills for the whole ring",
+          (unsigned long long)(Model.InterruptStatusWrites - Refills));
+
+    for (Index = 0; Index < TEST_RING_SIZE; Index += 1) {
+        CHECK(ReceiveFrame(TEST_FRAME_LENGTH), "frame %u missed after refill",
+              Index);
+
+        if (TakeFrame(&Held[0], Sequence - 1, TEST_FRAME_LENGTH)) {
+            ReleaseFrame(&Held[0]);
+        }
+    }
+
+    StopModule();
+}
+
+static
+VOID
+TestLowWater (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Once the model is left with fewer than a batch of descriptors, each
+    released frame goes straight back to it.
+
+--*/
+
+{
+    HELD_FRAME Held[TEST_MAX_HELD];
+    ULONG HeldCount;
+    ULONG Index;
+    ULONG64 Refills;
+
+    if (!StartModule(TEST_RING_OPTIONS)) {
+        return;
+    }
+
+    HeldCount = TEST_RING_SIZE - (REALTEK_RX_REFILL_BATCH / 2);
+    for (Index = 0; Index < HeldCount; Index += 1) {
+        ReceiveFrame(TEST_FRAME_LENGTH);
+        TakeFrame(&Held[Index], Index, TEST_FRAME_LENGTH);
+    }
+
+    for (Index = 0; Index < 4; Index += 1) {
+        Refills = Model.InterruptStatusWrites;
+        ReleaseFrame(&Held[Index]);
+        CHECK(Model.InterruptStatusWrites == Refills + 1,
+              "release %u with the model low was not refilled", Index);
+    }
+
+    //
+    // The model now owns every descriptor not held.
+    //
+
+    for (Index = 0; Index < TEST_RING_SIZE - (HeldCount - 4); Index += 1) {
+        CHECK(ReceiveFrame(TEST_FRAME_LENGTH), "frame %u missed", Index);
+    }
+
+    CHECK(ReceiveFrame(TEST_FRAME_LENGTH) == FALSE,
+          "frame received into a descriptor held by software");
+
+    StopModule();
+}
+
+static
+VOID
+TestJumboFrames (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Jumbo frames span several descriptors, wrap around the end of the ring
+    and are released out of order.  Each must still be contiguous.  The
+    requested buffer size is above what the chip supports, so the module
+    must clamp it and program RMS to match: the largest supported frame is
+    received and a 9000 byte frame is dropped by the model.
+
+--*/
+
+{
+    static const ULONG Lengths[] = {
+        REALTEK_MAX_JUMBO_SIZE, 4000, TEST_MIN_FRAME_LENGTH, 2049, 6144,
+        TEST_FRAME_LENGTH, 6143,
+    };
+
+    HELD_FRAME Held[3];
+    ULONG Index;
+    ULONG Length;
+    ULONG Round;
+
+    if (!StartModule(TEST_JUMBO_OPTIONS)) {
+        return;
+    }
+
+    CHECK(((PREALTEK_ADAPTER)KdNet.Hardware)->DescPerFrame > 1,
+          "jumbo frames not enabled");
+
+    for (Round = 0; Round < 150; Round += 1) {
+        for (Index = 0; Index < RTL_NUMBER_OF(Held); Index += 1) {
+            Length = Lengths[(Round + Index) % RTL_NUMBER_OF(Lengths)];
+            CHECK(ReceiveFrame(Length), "round %u frame %u missed", Round,
+                  Index);
+
+            TakeFrame(&Held[Index], Sequence - 1, Length);
+        }
+
+        ReleaseFrame(&Held[(Round + 1) % RTL_NUMBER_OF(Held)]);
+        ReleaseFrame(&Held[(Round + 2) % RTL_NUMBER_OF(Held)]);
+        ReleaseFrame(&Held[Round % RTL_NUMBER_OF(Held)]);
+    }
+
+    CHECK(Model.RxWraps > 0, "no frame wrapped around the ring");
+    CHECK(Model.RxMissed == 0, "%llu frames missed",
+          (unsigned long long)Model.RxMissed);
+
+    CHECK(ReceiveFrame(TEST_JUMBO_LENGTH) == FALSE,
+          "%u byte frame received", TEST_JUMBO_LENGTH);
+
+    CHECK(Model.RxTooLong == 1, "%llu frames too long",
+          (unsigned long long)Model.RxTooLong);
+
+    CHECK(RingEmpty(), "frame taken after the ring drained");
+    StopModule();
+}
+
+static
+VOID
+TestRingCheck (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    The ring check itself must notice broken bookkeeping: a descriptor the
+    model owns that is marked as released, and a held count that does not
+    match the indices.
+
+--*/
+
+{
+    PREALTEK_ADAPTER Adapter;
+    HELD_FRAME Held;
+    ULONG Index;
+
+    if (!StartModule(TEST_RING_OPTIONS)) {
+        return;
+    }
+
+    Adapter = (PREALTEK_ADAPTER)KdNet.Hardware;
+    ReceiveFrame(TEST_FRAME_LENGTH);
+    TakeFrame(&Held, 0, TEST_FRAME_LENGTH);
+
+    Index = (Adapter->RxIndex + 4) % Adapter->NumRxDesc;
+    Adapter->rxReleased[Index] = TRUE;
+    RingEmpty();
+    CHECK(KdNetRxRingCheckFailures != 0,
+          "released flag on a model owned descriptor not caught");
+
+    Adapter->rxReleased[Index] = FALSE;
+    KdNetRxRingCheckFailures = 0;
+    Adapter->RxHeld += 1;
+    RingEmpty();
+    CHECK(KdNetRxRingCheckFailures != 0, "wrong held count not caught");
+
+    Adapter->RxHeld -= 1;
+    KdNetRxRingCheckFailures = 0;
+    ReleaseFrame(&Held);
+    StopModule();
+}
+
+int
+main (
+    VOID
+    )
+{
+    TestInOrder();
+    TestOutOfOrder();
+    TestFullRing();
+    TestLowWater();
+    TestJumboFrames();
+    TestRingCheck();
+    return HostTestExit();
+}
@@ -0,0 +1,227 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    pollbench.c
+
+Abstract:
+
+    Host benchmark for the kdserial receive poll scheduler.
+
+    The 16550 hardware driver is polled through GetByte against the 16550
+    register model the way the debugger polls it: a loop which does a fixed
+    amount of work per call, receiving bursts of packet data separated by
+    idle periods.  The benchmark reports the register reads spent per
+    received byte with the scheduler active and with it bypassed (a port
+    whose baud rate is inherited is always polled), and fails if either run
+    loses or corrupts data or overruns the receive FIFO.
+
+    The last workload's loop does several character times of work on every
+    call that finds no data, as a debugger checking for other work while
+    the line is idle does.  It stays within the half of the FIFO the
+    scheduler leaves to the caller, and checks that backoff windows are
+    bounded in time rather than in calls.
+
+--*/
+
+#include <stdio.h>
+#include "common.h"
+#include "kdcom.h"
+#include "uart16550model.h"
+#include "hosttest.h"
+
+#define BENCH_PORT 0x3F8
+#define BENCH_BAUD_RATE 115200
+#define BENCH_BURSTS 16
+#define BENCH_BURST_BYTES 256
+#define BENCH_IDLE_NANOSECONDS (20ULL * 1000 * 1000)
+#define BENCH_IDLE_STEP_NANOSECONDS (131ULL * 1000)
+
+extern UART_HARDWARE_DRIVER Uart16550HardwareDriver;
+
+typedef struct _POLL_BENCH_RESULT {
+    ULONG64 Received;
+    ULONG64 Calls;
+    ULONG64 Reads;
+    ULONG64 Overruns;
+    ULONG Corrupted;
+} POLL_BENCH_RESULT, *PPOLL_BENCH_RESULT;
+
+typedef struct _POLL_BENCH_LOOP {
+    ULONG LoopNanoseconds;
+    ULONG IdleNanoseconds;
+} POLL_BENCH_LOOP, *PPOLL_BENCH_LOOP;
+
+static UART16550_MODEL Model;
+
+static
+VOID
+RunWorkload (
+    __inout PCPPORT Port,
+    __in BOOLEAN Scheduled,
+    __in const POLL_BENCH_LOOP *Loop,
+    __out PPOLL_BENCH_RESULT Result
+    )
+
+/*++
+
+Routine Description:
+
+    Initializes the port against a fresh model, then receives every burst
+    and waits out the idle period after it, calling GetByte once per loop
+    iteration.  The idle period grows a little with every burst so that
+    bursts start at different points of the scheduler's backoff.  Only the
+    receive loop is counted.
+
+Arguments:
+
+    Port - Supplies a port object not used by any earlier run, so that the
+        scheduler starts from its initial state.
+
+    Scheduled - Supplies FALSE to bypass the scheduler.
+
+    Loop - Supplies the caller's own work per loop iteration, after a call
+        which returned a byte and after one which did not.
+
+    Result - Receives the counts for the run.
+
+--*/
+
+{
+
+    UCHAR Burst[BENCH_BURST_BYTES];
+    ULONG BurstIndex;
+    UCHAR Byte;
+    ULONG Index;
+    ULONG64 IdleEnd;
+    ULONG Received;
+    BOOLEAN Success;
+
+    RtlZeroMemory(Result, sizeof(*Result));
+    Uart16550ModelInitialize(&Model, BENCH_PORT, 16, FALSE);
+    Model.AccessNanoseconds = 1000;
+    HostSetIoModel(&Model.Io);
+    Port->Address = (PUCHAR)BENCH_PORT;
+    Port->BaudRate = BENCH_BAUD_RATE;
+    Success = Uart16550HardwareDriver.InitializePort(NULL,
+                                                     Port,
+                                                     FALSE,
+                                                     AcpiGenericAccessSizeByte,
+                                                     8);
+
+    CHECK(Success != FALSE, "port initialization failed");
+    if (Scheduled == FALSE) {
+        Port->Flags |= PORT_DEFAULT_RATE;
+    }
+
+    HostResetCounters();
+    for (BurstIndex = 0; BurstIndex < BENCH_BURSTS; BurstIndex += 1) {
+        for (Index = 0; Index < sizeof(Burst); Index += 1) {
+            Burst[Index] = (UCHAR)((BurstIndex * 31) + (Index * 7));
+        }
+
+        Uart16550ModelPeerSend(&Model, Burst, sizeof(Burst));
+        Received = 0;
+        IdleEnd = HostGetTime() +
+                  (sizeof(Burst) * Uart16550ModelCharacterTime(&Model)) +
+                  BENCH_IDLE_NANOSECONDS +
+                  (BurstIndex * BENCH_IDLE_STEP_NANOSECONDS);
+
+        while (HostGetTime() < IdleEnd) {
+            Result->Calls += 1;
+            if (Uart16550HardwareDriver.GetByte(Port, &Byte) == UartSuccess) {
+                if ((Received >= sizeof(Burst)) ||
+                    (Byte != Burst[Received])) {
+
+                    Result->Corrupted += 1;
+                }
+
+                Received += 1;
+                HostAdvanceTime(Loop->LoopNanoseconds);
+
+            } else {
+                HostAdvanceTime(Loop->IdleNanoseconds);
+            }
+        }
+
+        Result->Received += Received;
+    }
+
+    Result->Reads = HostIoCounters.Reads;
+    Result->Overruns = Model.Overruns;
+    HostSetIoModel(NULL);
+    return;
+}
+
+static
+VOID
+CheckResult (
+    __in PCSTR Name,
+    __in PPOLL_BENCH_RESULT Result
+    )
+{
+    CHECK(Result->Received == BENCH_BURSTS * BENCH_BURST_BYTES,
+          "%s: received %llu of %u", Name,
+          (unsigned long long)Result->Received,
+          BENCH_BURSTS * BENCH_BURST_BYTES);
+
+    CHECK(Result->Corrupted == 0, "%s: %u bytes corrupted", Name,
+          Result->Corrupted);
+
+    CHECK(Result->Overruns == 0, "%s: %llu overruns", Name,
+          (unsigned long long)Result->Overruns);
+
+    printf("%-32s %10llu calls %10llu reads %8.2f reads/byte\n",
+           Name,
+           (unsigned long long)Result->Calls,
+           (unsigned long long)Result->Reads,
+           (double)Result->Reads / (double)Result->Received);
+
+    return;
+}
+
+int
+main (
+    VOID
+    )
+{
+    static const POLL_BENCH_LOOP Loops[] = {
+        { 200, 200 },
+        { 1000, 1000 },
+        { 5000, 5000 },
+        { 1000, 250000 },
+    };
+
+    ULONG Index;
+    CHAR Name[64];
+    CPPORT Ports[RTL_NUMBER_OF(Loops) * 2];
+    POLL_BENCH_RESULT Polled;
+    POLL_BENCH_RESULT Scheduled;
+
+    RtlZeroMemory(Ports, sizeof(Ports));
+    printf("%u bursts of %u bytes at %u baud, %llu ms idle between bursts\n",
+           BENCH_BURSTS, BENCH_BURST_BYTES, BENCH_BAUD_RATE,
+           (unsigned long long)(BENCH_IDLE_NANOSECONDS / 1000000));
+
+    for (Index = 0; Index < RTL_NUMBER_OF(Loops); Index += 1) {
+        RunWorkload(&Ports[Index * 2], FALSE, &Loops[Index], &Polled);
+        snprintf(Name, sizeof(Name), "always polled, %u/%u ns loop",
+                 Loops[Index].LoopNanoseconds, Loops[Index].IdleNanoseconds);
+
+        CheckResult(Name, &Polled);
+        RunWorkload(&Ports[(Index * 2) + 1], TRUE, &Loops[Index], &Scheduled);
+        snprintf(Name, sizeof(Name), "scheduled, %u/%u ns loop",
+                 Loops[Index].LoopNanoseconds, Loops[Index].IdleNanoseconds);
+
+        CheckResult(Name, &Scheduled);
+        CHECK(Scheduled.Reads < Polled.Reads,
+              "%u/%u ns loop: %llu reads scheduled, %llu always polled",
+              Loops[Index].LoopNanoseconds, Loops[Index].IdleNanoseconds,
+              (unsigned long long)Scheduled.Reads,
+              (unsigned long long)Polled.Reads);
+    }
+
+    return HostTestExit();
+}
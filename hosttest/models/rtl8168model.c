@@ -0,0 +1,301 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    rtl8168model.c
+
+Abstract:
+
+    Register level model of a Realtek RTL8168 family network controller.
+    See rtl8168model.h.
+
+    Register offsets and descriptor bits follow the RTL8168 datasheet rather
+    than the driver's headers, so that the model checks the driver instead
+    of sharing its mistakes.
+
+--*/
+
+#include <ntddk.h>
+#include "rtl8168model.h"
+
+#define REG_ID0 0x00
+#define REG_CMD 0x37
+#define REG_ISR 0x3E
+#define REG_TCR 0x40
+#define REG_RMS 0xDA
+#define REG_RDSAR_LOW 0xE4
+#define REG_RDSAR_HIGH 0xE8
+
+#define CMD_RESET 0x10
+#define CMD_RX_ENABLE 0x08
+
+#define ISR_RX_OK 0x0001
+#define ISR_RX_DESCRIPTOR_UNAVAILABLE 0x0010
+
+#define TCR_VERSION_MASK 0x7CF00000
+
+#define RMS_MASK 0x3FFF
+
+//
+// The first double word of a receive descriptor: the buffer size, or the
+// received length once the descriptor is returned, in the low 14 bits and
+// the status in the high 16.
+//
+
+#define DESC_LENGTH_MASK 0x00003FFF
+#define DESC_OWN 0x80000000
+#define DESC_EOR 0x40000000
+#define DESC_FS 0x20000000
+#define DESC_LS 0x10000000
+
+typedef struct _RTL8168_MODEL_DESC {
+    volatile ULONG Opts1;
+    volatile ULONG Opts2;
+    volatile ULONG64 BufferAddress;
+} RTL8168_MODEL_DESC, *PRTL8168_MODEL_DESC;
+
+static
+ULONG
+RegisterValue (
+    __in PRTL8168_MODEL Model,
+    __in ULONG Offset,
+    __in ULONG Width
+    )
+{
+    ULONG Value;
+
+    Value = 0;
+    memcpy(&Value, &Model->Registers[Offset], Width);
+    return Value;
+}
+
+static
+VOID
+SetRegisterValue (
+    __inout PRTL8168_MODEL Model,
+    __in ULONG Offset,
+    __in ULONG Width,
+    __in ULONG Value
+    )
+{
+    memcpy(&Model->Registers[Offset], &Value, Width);
+}
+
+static
+ULONG
+Rtl8168ModelRead (
+    __in PHOST_IO_MODEL Io,
+    __in ULONG_PTR Address,
+    __in ULONG Width
+    )
+{
+    PRTL8168_MODEL Model;
+    ULONG Offset;
+    ULONG Value;
+
+    Model = (PRTL8168_MODEL)Io->Context;
+    Offset = (ULONG)(Address - (ULONG_PTR)Model->Registers);
+    if ((Address < (ULONG_PTR)Model->Registers) ||
+        (Offset + Width > RTL8168_MODEL_REGISTERS)) {
+
+        return MAXULONG;
+    }
+
+    Value = RegisterValue(Model, Offset, Width);
+    if ((Offset == REG_TCR) && (Width == sizeof(ULONG))) {
+        Value = (Value & ~TCR_VERSION_MASK) | Model->Version;
+    }
+
+    return Value;
+}
+
+static
+VOID
+Rtl8168ModelWrite (
+    __in PHOST_IO_MODEL Io,
+    __in ULONG_PTR Address,
+    __in ULONG Width,
+    __in ULONG Value
+    )
+{
+    PRTL8168_MODEL Model;
+    ULONG Offset;
+
+    Model = (PRTL8168_MODEL)Io->Context;
+    Offset = (ULONG)(Address - (ULONG_PTR)Model->Registers);
+    if ((Address < (ULONG_PTR)Model->Registers) ||
+        (Offset + Width > RTL8168_MODEL_REGISTERS)) {
+
+        return;
+    }
+
+    switch (Offset) {
+    case REG_CMD:
+
+        //
+        // Reset completes at once and stops receive.
+        //
+
+        if ((Value & CMD_RESET) != 0) {
+            Value = 0;
+            Model->RxIndex = 0;
+        }
+
+        break;
+
+    case REG_ISR:
+        Model->InterruptStatusWrites += 1;
+        Value = RegisterValue(Model, Offset, Width) & ~Value;
+        break;
+
+    case REG_RDSAR_LOW:
+        Model->RxIndex = 0;
+        break;
+    }
+
+    SetRegisterValue(Model, Offset, Width, Value);
+}
+
+VOID
+Rtl8168ModelInitialize (
+    __out PRTL8168_MODEL Model,
+    __in ULONG Version,
+    __in_ecount(6) const UCHAR *MacAddress
+    )
+{
+    RtlZeroMemory(Model, sizeof(*Model));
+    Model->Io.Read = Rtl8168ModelRead;
+    Model->Io.Write = Rtl8168ModelWrite;
+    Model->Io.Context = Model;
+    Model->Version = Version;
+    memcpy(&Model->Registers[REG_ID0], MacAddress, 6);
+}
+
+BOOLEAN
+Rtl8168ModelReceive (
+    __inout PRTL8168_MODEL Model,
+    __in_bcount(Length) const UCHAR *Frame,
+    __in ULONG Length
+    )
+
+/*++
+
+Routine Description:
+
+    Receives a frame from the wire into the descriptor ring.
+
+Arguments:
+
+    Model - Supplies the model.
+
+    Frame - Supplies the frame.
+
+    Length - Supplies the length of the frame.
+
+Return Value:
+
+    TRUE if the frame was written to the ring, FALSE if receive is disabled,
+    the frame is longer than RMS allows or it was missed for lack of
+    descriptors.
+
+--*/
+
+{
+    ULONG Chunk;
+    ULONG Count;
+    ULONG Copied;
+    PRTL8168_MODEL_DESC Descriptor;
+    ULONG Index;
+    ULONG Opts1;
+    PRTL8168_MODEL_DESC Ring;
+    ULONG Size;
+
+    if ((RegisterValue(Model, REG_CMD, 1) & CMD_RX_ENABLE) == 0) {
+        Model->RxMissed += 1;
+        return FALSE;
+    }
+
+    //
+    // Frames longer than the receive packet size are dropped by the MAC
+    // before they reach the ring.
+    //
+
+    if (Length > (RegisterValue(Model, REG_RMS, 2) & RMS_MASK)) {
+        Model->RxTooLong += 1;
+        return FALSE;
+    }
+
+    Ring = (PRTL8168_MODEL_DESC)(ULONG_PTR)
+           (RegisterValue(Model, REG_RDSAR_LOW, 4) |
+            ((ULONG64)RegisterValue(Model, REG_RDSAR_HIGH, 4) << 32));
+
+    //
+    // Make sure the whole frame fits in descriptors the model owns before
+    // writing any of it.
+    //
+
+    Index = Model->RxIndex;
+    Size = 0;
+    for (Count = 0; Size < Length; Count += 1) {
+        Opts1 = Ring[Index].Opts1;
+        if (((Opts1 & DESC_OWN) == 0) ||
+            ((Opts1 & DESC_LENGTH_MASK) == 0) ||
+            (Count == RTL8168_MODEL_MAX_RING)) {
+
+            SetRegisterValue(Model,
+                             REG_ISR,
+                             2,
+                             RegisterValue(Model, REG_ISR, 2) |
+                                ISR_RX_DESCRIPTOR_UNAVAILABLE);
+
+            Model->RxMissed += 1;
+            return FALSE;
+        }
+
+        Size += Opts1 & DESC_LENGTH_MASK;
+        Index = ((Opts1 & DESC_EOR) != 0) ? 0 : Index + 1;
+    }
+
+    Copied = 0;
+    while (Copied < Length) {
+        Descriptor = &Ring[Model->RxIndex];
+        Opts1 = Descriptor->Opts1;
+        Chunk = min(Length - Copied, Opts1 & DESC_LENGTH_MASK);
+        memcpy((PVOID)(ULONG_PTR)Descriptor->BufferAddress,
+               &Frame[Copied],
+               Chunk);
+
+        Opts1 &= DESC_EOR;
+        if (Copied == 0) {
+            Opts1 |= DESC_FS;
+        }
+
+        Copied += Chunk;
+        if (Copied == Length) {
+            Opts1 |= DESC_LS | Length;
+
+        } else {
+            Opts1 |= Chunk;
+        }
+
+        Descriptor->Opts1 = Opts1;
+        Model->RxDescriptors += 1;
+        if ((Opts1 & DESC_EOR) != 0) {
+            Model->RxIndex = 0;
+            Model->RxWraps += 1;
+
+        } else {
+            Model->RxIndex += 1;
+        }
+    }
+
+    SetRegisterValue(Model,
+                     REG_ISR,
+                     2,
+                     RegisterValue(Model, REG_ISR, 2) | ISR_RX_OK);
+
+    Model->RxFrames += 1;
+    return TRUE;
+}
@@ -0,0 +1,93 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    rtl8168model.h
+
+Abstract:
+
+    Register level model of a Realtek RTL8168 family network controller for
+    the host tests.
+
+    The model covers what the KDNET Realtek module needs to bring the
+    controller up (the chip version in TCR, the self clearing reset bit, the
+    write one to clear interrupt status register and the PCI Express
+    configuration space window) and the receive DMA engine.  Registers the
+    model does not interpret read back what was written.
+
+    Received frames are written into the descriptor ring at the address
+    programmed into RDSAR, which the host stand in for KDNET identity maps.
+    Like the hardware, the model fills the ring in order, only uses
+    descriptors the driver has handed it (OWN set), wraps after the
+    descriptor with EOR set and spreads a frame larger than one buffer over
+    consecutive descriptors marked FS and LS, reporting the frame length in
+    the last one.  A frame longer than the RMS register allows is dropped,
+    and a frame that does not fit in the descriptors the model owns is
+    missed and raises RDU.
+
+--*/
+
+#pragma once
+
+#define RTL8168_MODEL_REGISTERS 256
+#define RTL8168_MODEL_MAX_RING 1024
+
+//
+// TCR version bits of an RTL8168B, which the Realtek module brings up
+// without touching the PHY.
+//
+
+#define RTL8168_MODEL_VERSION_8168B 0x30000000
+
+typedef struct _RTL8168_MODEL {
+    HOST_IO_MODEL Io;
+
+    //
+    // Configuration, set before the model is used.  Version is returned in
+    // the version bits of TCR.
+    //
+
+    ULONG Version;
+
+    //
+    // Register file.  The driver's register base is the address of
+    // Registers, so accesses the driver makes without the register access
+    // routines land here too.
+    //
+
+    DECLSPEC_ALIGN(8) UCHAR Registers[RTL8168_MODEL_REGISTERS];
+
+    //
+    // Receive DMA state: the next descriptor the model fills.
+    //
+
+    ULONG RxIndex;
+
+    //
+    // Counters.
+    //
+
+    ULONG64 RxFrames;
+    ULONG64 RxDescriptors;
+    ULONG64 RxMissed;
+    ULONG64 RxTooLong;
+    ULONG64 RxWraps;
+    ULONG64 InterruptStatusWrites;
+
+} RTL8168_MODEL, *PRTL8168_MODEL;
+
+VOID
+Rtl8168ModelInitialize (
+    __out PRTL8168_MODEL Model,
+    __in ULONG Version,
+    __in_ecount(6) const UCHAR *MacAddress
+    );
+
+BOOLEAN
+Rtl8168ModelReceive (
+    __inout PRTL8168_MODEL Model,
+    __in_bcount(Length) const UCHAR *Frame,
+    __in ULONG Length
+    );
@@ -0,0 +1,696 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    uart16550model.c
+
+Abstract:
+
+    Register level model of a 16550 family UART.  See uart16550model.h.
+
+    The model is event driven.  Every register access first charges the bus
+    cost to the virtual clock and then runs the line forward to the current
+    time, completing characters on the wire in the order they finish.
+
+--*/
+
+#include <ntddk.h>
+#include "uart16550model.h"
+
+#define REG_DATA 0
+#define REG_IER 1
+#define REG_IIR_FCR 2
+#define REG_LCR 3
+#define REG_MCR 4
+#define REG_LSR 5
+#define REG_MSR 6
+#define REG_SCR 7
+
+#define LCR_DLAB 0x80
+#define LCR_PARITY 0x08
+#define LCR_STOP 0x04
+#define LCR_LENGTH 0x03
+
+#define FCR_ENABLE 0x01
+#define FCR_CLEAR_RX 0x02
+#define FCR_CLEAR_TX 0x04
+#define FCR_TRIGGER_SHIFT 6
+
+#define MCR_DTR 0x01
+#define MCR_RTS 0x02
+#define MCR_OUT1 0x04
+#define MCR_OUT2 0x08
+#define MCR_LOOP 0x10
+#define MCR_AFE 0x20
+
+#define LSR_DR 0x01
+#define LSR_OE 0x02
+#define LSR_THRE 0x20
+#define LSR_TEMT 0x40
+
+#define MSR_CTS 0x10
+#define MSR_DSR 0x20
+#define MSR_RI 0x40
+#define MSR_DCD 0x80
+
+#define IER_RDA 0x01
+#define IER_THRE 0x02
+#define IER_RLS 0x04
+#define IER_MS 0x08
+
+#define IIR_NONE 0x01
+#define IIR_MS 0x00
+#define IIR_THRE 0x02
+#define IIR_RDA 0x04
+#define IIR_RLS 0x06
+#define IIR_TIMEOUT 0x0C
+#define IIR_FIFOS_ENABLED 0xC0
+
+static const UCHAR Uart16550ModelTriggers16[] = { 1, 4, 8, 14 };
+static const UCHAR Uart16550ModelTriggers64[] = { 1, 16, 32, 56 };
+
+static
+BOOLEAN
+FifoEnabled (
+    __in PUART16550_MODEL Model
+    )
+{
+    return ((Model->Fcr & FCR_ENABLE) != 0) && (Model->FifoDepth > 1);
+}
+
+static
+ULONG
+FifoCapacity (
+    __in PUART16550_MODEL Model
+    )
+{
+    return FifoEnabled(Model) ? Model->FifoDepth : 1;
+}
+
+static
+ULONG
+TriggerLevel (
+    __in PUART16550_MODEL Model
+    )
+{
+    ULONG Index;
+
+    if (!FifoEnabled(Model)) {
+        return 1;
+    }
+
+    Index = Model->Fcr >> FCR_TRIGGER_SHIFT;
+    if (Model->FifoDepth >= 64) {
+        return Uart16550ModelTriggers64[Index];
+    }
+
+    return Uart16550ModelTriggers16[Index];
+}
+
+static
+BOOLEAN
+RtsLine (
+    __in PUART16550_MODEL Model
+    )
+
+/*++
+
+Routine Description:
+
+    Returns the state of RTS as seen by whatever is listening to it.  With
+    automatic flow control the MCR bit only enables RTS, which the receiver
+    then drives from the FIFO level.
+
+--*/
+
+{
+    if ((Model->Mcr & MCR_RTS) == 0) {
+        return FALSE;
+    }
+
+    if ((Model->Mcr & MCR_AFE) != 0) {
+        return Model->RtsOut;
+    }
+
+    return TRUE;
+}
+
+static
+BOOLEAN
+CtsLine (
+    __in PUART16550_MODEL Model
+    )
+{
+    if ((Model->Mcr & MCR_LOOP) != 0) {
+        return RtsLine(Model);
+    }
+
+    return Model->PeerRts;
+}
+
+static
+UCHAR
+ModemStatus (
+    __in PUART16550_MODEL Model
+    )
+{
+    UCHAR Msr;
+
+    if ((Model->Mcr & MCR_LOOP) != 0) {
+        Msr = 0;
+        if (RtsLine(Model)) {
+            Msr |= MSR_CTS;
+        }
+
+        if ((Model->Mcr & MCR_DTR) != 0) {
+            Msr |= MSR_DSR;
+        }
+
+        if ((Model->Mcr & MCR_OUT1) != 0) {
+            Msr |= MSR_RI;
+        }
+
+        if ((Model->Mcr & MCR_OUT2) != 0) {
+            Msr |= MSR_DCD;
+        }
+
+        return Msr;
+    }
+
+    Msr = MSR_DSR | MSR_DCD;
+    if (Model->PeerRts) {
+        Msr |= MSR_CTS;
+    }
+
+    return Msr;
+}
+
+ULONG64
+Uart16550ModelCharacterTime (
+    __in PUART16550_MODEL Model
+    )
+
+/*++
+
+Routine Description:
+
+    Returns the time in nanoseconds one character takes on the wire with the
+    programmed divisor and frame format.
+
+--*/
+
+{
+    ULONG Bits;
+    ULONG Divisor;
+
+    Divisor = ((ULONG)Model->Dlm << 8) | Model->Dll;
+    if (Divisor == 0) {
+        Divisor = 0x10000;
+    }
+
+    Bits = 1 + 5 + (Model->Lcr & LCR_LENGTH) + 1;
+    if ((Model->Lcr & LCR_PARITY) != 0) {
+        Bits += 1;
+    }
+
+    if ((Model->Lcr & LCR_STOP) != 0) {
+        Bits += 1;
+    }
+
+    return ((ULONG64)Bits * 16 * Divisor * 1000000000ULL) / Model->ClockRate;
+}
+
+static
+VOID
+ReceiveCharacter (
+    __inout PUART16550_MODEL Model,
+    __in UCHAR Byte
+    )
+{
+    if (Model->RxCount >= FifoCapacity(Model)) {
+        Model->LineErrors |= LSR_OE;
+        Model->Overruns += 1;
+        return;
+    }
+
+    Model->Rx[(Model->RxHead + Model->RxCount) % UART_MODEL_MAX_FIFO] = Byte;
+    Model->RxCount += 1;
+    Model->LastRxTime = Model->Now;
+    if (Model->RxCount >= TriggerLevel(Model)) {
+        Model->RtsOut = FALSE;
+    }
+}
+
+static
+VOID
+StartCharacters (
+    __inout PUART16550_MODEL Model
+    )
+
+/*++
+
+Routine Description:
+
+    Starts the next character from the transmit FIFO and from the peer, if
+    each is idle and allowed to send.
+
+--*/
+
+{
+    if (!Model->Shifting && (Model->TxCount != 0)) {
+        if (((Model->Mcr & MCR_AFE) == 0) || CtsLine(Model)) {
+            Model->ShiftByte = Model->Tx[Model->TxHead];
+            Model->TxHead = (Model->TxHead + 1) % UART_MODEL_MAX_FIFO;
+            Model->TxCount -= 1;
+            Model->Shifting = TRUE;
+            Model->ShiftDone = Model->Now + Uart16550ModelCharacterTime(Model);
+            if (Model->TxCount == 0) {
+                Model->ThrInterrupt = TRUE;
+            }
+
+        } else {
+            Model->CtsHolds += 1;
+        }
+    }
+}
+
+static
+BOOLEAN
+PeerMaySend (
+    __in PUART16550_MODEL Model
+    )
+{
+    if (((Model->Mcr & MCR_LOOP) != 0) ||
+        (Model->PeerSent >= Model->PeerLength)) {
+
+        return FALSE;
+    }
+
+    return !Model->PeerHonorsRts || RtsLine(Model);
+}
+
+VOID
+Uart16550ModelRun (
+    __inout PUART16550_MODEL Model
+    )
+
+/*++
+
+Routine Description:
+
+    Runs the line forward to the current virtual time.  A peer that honors
+    RTS samples it before starting each character, and a character it has
+    started always completes.
+
+--*/
+
+{
+    ULONG64 CharacterTime;
+    ULONG64 Next;
+    ULONG64 Target;
+
+    Target = HostGetTime();
+    if (Target < Model->Now) {
+        Target = Model->Now;
+    }
+
+    CharacterTime = Uart16550ModelCharacterTime(Model);
+    for (;;) {
+        StartCharacters(Model);
+        if (!Model->PeerInFlight && PeerMaySend(Model) &&
+            (Model->PeerNextTime <= Model->Now)) {
+
+            Model->PeerInFlight = TRUE;
+            Model->PeerArrival = Model->PeerNextTime + CharacterTime;
+        }
+
+        Next = MAXULONG64;
+        if (Model->Shifting) {
+            Next = Model->ShiftDone;
+        }
+
+        if (Model->PeerInFlight) {
+            Next = min(Next, Model->PeerArrival);
+
+        } else if (PeerMaySend(Model)) {
+            Next = min(Next, Model->PeerNextTime);
+        }
+
+        if (Next > Target) {
+            break;
+        }
+
+        Model->Now = Next;
+        if (Model->Shifting && (Model->ShiftDone == Next)) {
+            Model->Shifting = FALSE;
+            if ((Model->Mcr & MCR_LOOP) != 0) {
+                ReceiveCharacter(Model, Model->ShiftByte);
+
+            } else if (Model->PeerReceivedCount < Model->PeerReceivedSize) {
+                Model->PeerReceived[Model->PeerReceivedCount] =
+                    Model->ShiftByte;
+
+                if (Model->PeerReceivedTimes != NULL) {
+                    Model->PeerReceivedTimes[Model->PeerReceivedCount] = Next;
+                }
+
+                Model->PeerReceivedCount += 1;
+            }
+        }
+
+        if (Model->PeerInFlight && (Model->PeerArrival == Next)) {
+            Model->PeerInFlight = FALSE;
+            ReceiveCharacter(Model, Model->PeerData[Model->PeerSent]);
+            Model->PeerSent += 1;
+            Model->PeerNextTime = Next;
+        }
+    }
+
+    Model->Now = Target;
+    if (!Model->PeerInFlight && !PeerMaySend(Model) &&
+        (Model->PeerNextTime < Model->Now)) {
+
+        //
+        // A peer held off by RTS starts again from when it is released, not
+        // from when it stopped.
+        //
+
+        Model->PeerNextTime = Model->Now;
+    }
+}
+
+static
+UCHAR
+InterruptIdentification (
+    __in PUART16550_MODEL Model
+    )
+{
+    ULONG64 Timeout;
+
+    if (((Model->Ier & IER_RLS) != 0) && (Model->LineErrors != 0)) {
+        return IIR_RLS;
+    }
+
+    if (((Model->Ier & IER_RDA) != 0) && (Model->RxCount != 0)) {
+        if (Model->RxCount >= TriggerLevel(Model)) {
+            return IIR_RDA;
+        }
+
+        Timeout = 4 * Uart16550ModelCharacterTime(Model);
+        if (Model->Now - Model->LastRxTime >= Timeout) {
+            return IIR_TIMEOUT;
+        }
+    }
+
+    if (((Model->Ier & IER_THRE) != 0) && Model->ThrInterrupt) {
+        return IIR_THRE;
+    }
+
+    if (((Model->Ier & IER_MS) != 0) &&
+        ((ModemStatus(Model) ^ Model->LastMsr) != 0)) {
+
+        return IIR_MS;
+    }
+
+    return IIR_NONE;
+}
+
+BOOLEAN
+Uart16550ModelInterruptPending (
+    __inout PUART16550_MODEL Model
+    )
+{
+    Uart16550ModelRun(Model);
+    return (InterruptIdentification(Model) & IIR_NONE) == 0;
+}
+
+static
+ULONG
+Uart16550ModelRead (
+    __in PHOST_IO_MODEL Io,
+    __in ULONG_PTR Address,
+    __in ULONG Width
+    )
+{
+    PUART16550_MODEL Model;
+    ULONG Register;
+    UCHAR Value;
+
+    UNREFERENCED_PARAMETER(Width);
+
+    Model = CONTAINING_RECORD(Io, UART16550_MODEL, Io);
+    HostAdvanceTime(Model->AccessNanoseconds);
+    Uart16550ModelRun(Model);
+    Register = (ULONG)((Address - Model->Base) / Model->Stride);
+    Value = 0xFF;
+    switch (Register) {
+    case REG_DATA:
+        if ((Model->Lcr & LCR_DLAB) != 0) {
+            Value = Model->Dll;
+            break;
+        }
+
+        Model->DataReads += 1;
+        Value = 0;
+        if (Model->RxCount != 0) {
+            Value = Model->Rx[Model->RxHead];
+            Model->RxHead = (Model->RxHead + 1) % UART_MODEL_MAX_FIFO;
+            Model->RxCount -= 1;
+            if (Model->RxCount == 0) {
+                Model->RtsOut = TRUE;
+            }
+        }
+
+        break;
+
+    case REG_IER:
+        Value = ((Model->Lcr & LCR_DLAB) != 0) ? Model->Dlm : Model->Ier;
+        break;
+
+    case REG_IIR_FCR:
+        Value = InterruptIdentification(Model);
+        if (Value == IIR_THRE) {
+            Model->ThrInterrupt = FALSE;
+        }
+
+        if (FifoEnabled(Model)) {
+            Value |= IIR_FIFOS_ENABLED;
+        }
+
+        break;
+
+    case REG_LCR:
+        Value = Model->Lcr;
+        break;
+
+    case REG_MCR:
+        Value = Model->Mcr;
+        break;
+
+    case REG_LSR:
+        Model->StatusReads += 1;
+        Value = Model->LineErrors;
+        Model->LineErrors = 0;
+        if (Model->RxCount != 0) {
+            Value |= LSR_DR;
+        }
+
+        if (Model->TxCount == 0) {
+            Value |= LSR_THRE;
+            if (!Model->Shifting) {
+                Value |= LSR_TEMT;
+            }
+        }
+
+        break;
+
+    case REG_MSR:
+        Model->StatusReads += 1;
+        Value = ModemStatus(Model);
+        Value |= ((Value ^ Model->LastMsr) >> 4) & 0x0B;
+        Model->LastMsr = Value & 0xF0;
+        break;
+
+    case REG_SCR:
+        Value = Model->Scr;
+        break;
+
+    default:
+        break;
+    }
+
+    return Value;
+}
+
+static
+VOID
+Uart16550ModelWrite (
+    __in PHOST_IO_MODEL Io,
+    __in ULONG_PTR Address,
+    __in ULONG Width,
+    __in ULONG Value
+    )
+{
+    PUART16550_MODEL Model;
+    ULONG Register;
+
+    UNREFERENCED_PARAMETER(Width);
+
+    Model = CONTAINING_RECORD(Io, UART16550_MODEL, Io);
+    HostAdvanceTime(Model->AccessNanoseconds);
+    Uart16550ModelRun(Model);
+    Register = (ULONG)((Address - Model->Base) / Model->Stride);
+    switch (Register) {
+    case REG_DATA:
+        if ((Model->Lcr & LCR_DLAB) != 0) {
+            Model->Dll = (UCHAR)Value;
+            break;
+        }
+
+        Model->DataWrites += 1;
+        Model->ThrInterrupt = FALSE;
+        if (Model->TxCount < FifoCapacity(Model)) {
+            Model->Tx[(Model->TxHead + Model->TxCount) % UART_MODEL_MAX_FIFO] =
+                (UCHAR)Value;
+
+            Model->TxCount += 1;
+        }
+
+        break;
+
+    case REG_IER:
+        if ((Model->Lcr & LCR_DLAB) != 0) {
+            Model->Dlm = (UCHAR)Value;
+
+        } else {
+
+            //
+            // Enabling the transmit holding register interrupt while the
+            // holding register is empty raises it at once, which is how
+            // interrupt driven drivers start a transmission.
+            //
+
+            if (((Model->Ier & IER_THRE) == 0) &&
+                ((Value & IER_THRE) != 0) &&
+                (Model->TxCount == 0)) {
+
+                Model->ThrInterrupt = TRUE;
+            }
+
+            Model->Ier = (UCHAR)(Value & 0x0F);
+        }
+
+        break;
+
+    case REG_IIR_FCR:
+        if (((Value & FCR_ENABLE) == 0) ||
+            ((Model->Fcr & FCR_ENABLE) == 0)) {
+
+            Model->RxCount = 0;
+            Model->TxCount = 0;
+        }
+
+        if ((Value & FCR_CLEAR_RX) != 0) {
+            Model->RxCount = 0;
+            Model->RtsOut = TRUE;
+        }
+
+        if ((Value & FCR_CLEAR_TX) != 0) {
+            Model->TxCount = 0;
+        }
+
+        Model->Fcr = (UCHAR)(Value & 0xC1);
+        break;
+
+    case REG_LCR:
+        Model->Lcr = (UCHAR)Value;
+        break;
+
+    case REG_MCR:
+        Value &= 0x1F | (Model->AutoFlowCapable ? MCR_AFE : 0);
+        if (((Value & MCR_AFE) != 0) && ((Model->Mcr & MCR_AFE) == 0)) {
+            Model->RtsOut = TRUE;
+        }
+
+        Model->Mcr = (UCHAR)Value;
+        break;
+
+    case REG_SCR:
+        Model->Scr = (UCHAR)Value;
+        break;
+
+    default:
+        break;
+    }
+
+    //
+    // A write may have released CTS or loaded an idle transmitter.
+    //
+
+    Uart16550ModelRun(Model);
+}
+
+VOID
+Uart16550ModelInitialize (
+    __out PUART16550_MODEL Model,
+    __in ULONG_PTR Base,
+    __in ULONG FifoDepth,
+    __in BOOLEAN AutoFlowCapable
+    )
+
+/*++
+
+Routine Description:
+
+    Puts the model in its reset state: 115200 baud from a 1.8432 MHz clock,
+    8N1, FIFOs disabled, and a peer that asserts RTS and has nothing to send.
+
+--*/
+
+{
+    RtlZeroMemory(Model, sizeof(UART16550_MODEL));
+    Model->Io.Read = Uart16550ModelRead;
+    Model->Io.Write = Uart16550ModelWrite;
+    Model->Io.Context = Model;
+    Model->Base = Base;
+    Model->Stride = 1;
+    Model->FifoDepth = min(FifoDepth, (ULONG)UART_MODEL_MAX_FIFO);
+    Model->AutoFlowCapable = AutoFlowCapable;
+    Model->ClockRate = 1843200;
+    Model->AccessNanoseconds = 0;
+    Model->Dll = 1;
+    Model->Lcr = 0x03;
+    Model->RtsOut = TRUE;
+    Model->PeerRts = TRUE;
+    Model->Now = HostGetTime();
+    Model->LastMsr = 0;
+}
+
+VOID
+Uart16550ModelPeerSend (
+    __inout PUART16550_MODEL Model,
+    __in const UCHAR *Data,
+    __in ULONG Length
+    )
+{
+    Uart16550ModelRun(Model);
+    Model->PeerData = Data;
+    Model->PeerLength = Length;
+    Model->PeerSent = 0;
+    Model->PeerNextTime = Model->Now;
+    Model->PeerInFlight = FALSE;
+}
+
+VOID
+Uart16550ModelPeerReceive (
+    __inout PUART16550_MODEL Model,
+    __out PUCHAR Buffer,
+    __in ULONG Size
+    )
+{
+    Model->PeerReceived = Buffer;
+    Model->PeerReceivedSize = Size;
+    Model->PeerReceivedCount = 0;
+}
@@ -0,0 +1,153 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    uart16550model.h
+
+Abstract:
+
+    Register level model of a 16550 family UART for the host tests.
+
+    The model covers the register file (including the divisor latch, the
+    FIFO control register and the interrupt identification register), the
+    receive and transmit FIFOs, the transmit shift register, the line and
+    modem status registers, internal loopback and 16750 automatic RTS/CTS
+    flow control.  Characters take their real time on the wire at the
+    programmed baud rate and frame format, measured on the host virtual
+    clock.
+
+    The far end of the line is a peer which sends a queued byte stream (and
+    optionally honors RTS) and collects everything the UART transmits.
+
+--*/
+
+#pragma once
+
+#define UART_MODEL_MAX_FIFO 128
+
+typedef struct _UART16550_MODEL {
+    HOST_IO_MODEL Io;
+
+    //
+    // Configuration, set before the model is used.
+    //
+    // Base is the address the driver uses for register zero and Stride the
+    // distance between registers.  FifoDepth is 1 for a 16450, 16 for a
+    // 16550 and 64 for a 16750.  AutoFlowCapable makes MCR[5] writable, as
+    // on a 16750.  ClockRate is the UART input clock (the baud rate is
+    // ClockRate / (16 * divisor)).  AccessNanoseconds is charged to the
+    // virtual clock on every register access, modelling the bus cost.
+    //
+
+    ULONG_PTR Base;
+    ULONG Stride;
+    ULONG FifoDepth;
+    BOOLEAN AutoFlowCapable;
+    ULONG ClockRate;
+    ULONG AccessNanoseconds;
+
+    //
+    // Register file.
+    //
+
+    UCHAR Ier;
+    UCHAR Fcr;
+    UCHAR Lcr;
+    UCHAR Mcr;
+    UCHAR Scr;
+    UCHAR Dll;
+    UCHAR Dlm;
+    UCHAR LineErrors;
+    UCHAR LastMsr;
+    BOOLEAN ThrInterrupt;
+    BOOLEAN RtsOut;
+
+    //
+    // FIFOs and the transmit shift register.
+    //
+
+    UCHAR Rx[UART_MODEL_MAX_FIFO];
+    ULONG RxHead;
+    ULONG RxCount;
+    UCHAR Tx[UART_MODEL_MAX_FIFO];
+    ULONG TxHead;
+    ULONG TxCount;
+    BOOLEAN Shifting;
+    UCHAR ShiftByte;
+    ULONG64 ShiftDone;
+    ULONG64 LastRxTime;
+    ULONG64 Now;
+
+    //
+    // The far end of the line.
+    //
+
+    const UCHAR *PeerData;
+    ULONG PeerLength;
+    ULONG PeerSent;
+    ULONG64 PeerNextTime;
+    ULONG64 PeerArrival;
+    BOOLEAN PeerInFlight;
+    BOOLEAN PeerHonorsRts;
+    BOOLEAN PeerRts;
+    PUCHAR PeerReceived;
+    ULONG PeerReceivedSize;
+    ULONG PeerReceivedCount;
+
+    //
+    // Optional, PeerReceivedSize entries: when each received character's
+    // stop bit ended, in nanoseconds.
+    //
+
+    PULONG64 PeerReceivedTimes;
+
+    //
+    // Counters.
+    //
+
+    ULONG64 DataReads;
+    ULONG64 DataWrites;
+    ULONG64 StatusReads;
+    ULONG64 Overruns;
+    ULONG64 CtsHolds;
+
+} UART16550_MODEL, *PUART16550_MODEL;
+
+VOID
+Uart16550ModelInitialize (
+    __out PUART16550_MODEL Model,
+    __in ULONG_PTR Base,
+    __in ULONG FifoDepth,
+    __in BOOLEAN AutoFlowCapable
+    );
+
+VOID
+Uart16550ModelPeerSend (
+    __inout PUART16550_MODEL Model,
+    __in const UCHAR *Data,
+    __in ULONG Length
+    );
+
+VOID
+Uart16550ModelPeerReceive (
+    __inout PUART16550_MODEL Model,
+    __out PUCHAR Buffer,
+    __in ULONG Size
+    );
+
+VOID
+Uart16550ModelRun (
+    __inout PUART16550_MODEL Model
+    );
+
+ULONG64
+Uart16550ModelCharacterTime (
+    __in PUART16550_MODEL Model
+    );
+
+BOOLEAN
+Uart16550ModelInterruptPending (
+    __inout PUART16550_MODEL Model
+    );
@@ -0,0 +1,344 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    serialbench.c
+
+Abstract:
+
+    Host benchmark for the KMDF serial driver, run against the framework
+    emulation and the 16550 register model.
+
+    Each workload moves a fixed amount of data through the driver's ISR,
+    DPCs and queues and reports the real CPU cycles spent in driver code
+    (framework emulation included, register model excluded) per byte,
+    along with the interrupts and DPCs per byte:
+
+    read      - the peer streams data while reads of READ_CHUNK bytes are
+                kept outstanding.
+
+    write     - writes of WRITE_CHUNK bytes are sent back to back.
+
+    xon/xoff  - as write, with automatic transmit flow control on and the
+                peer pausing the line with XOFF and XON every XOFF_PERIOD.
+
+    wait mask - the peer sends one byte at a time; each is waited for with
+                IOCTL_SERIAL_WAIT_ON_MASK (SERIAL_EV_RXCHAR) and then read.
+
+    Every workload also checks that the data arrived intact.  The cycle
+    counts depend on the host processor; compare runs on the same machine.
+
+--*/
+
+#include <stdio.h>
+#include "serialharness.h"
+#include "hosttest.h"
+
+#define BENCH_BYTES 8192
+#define BENCH_WAIT_BYTES 1024
+#define READ_CHUNK 256
+#define WRITE_CHUNK 256
+#define XOFF_PERIOD (2ULL * 1000 * 1000)
+#define BENCH_XON 0x11
+#define BENCH_XOFF 0x13
+
+typedef struct _SERIAL_BENCH_RESULT {
+    ULONG64 Bytes;
+    ULONG64 Cycles;
+    ULONG64 Interrupts;
+    ULONG64 Dpcs;
+    ULONG Corrupted;
+} SERIAL_BENCH_RESULT, *PSERIAL_BENCH_RESULT;
+
+static SERIAL_HARNESS Harness;
+static UCHAR Data[BENCH_BYTES];
+static UCHAR Received[BENCH_BYTES];
+
+static
+VOID
+BeginWorkload (
+    VOID
+    )
+{
+    ULONG Index;
+
+    for (Index = 0; Index < sizeof(Data); Index += 1) {
+        Data[Index] = (UCHAR)(0x20 + (((Index * 7) + (Index >> 8)) % 0x5F));
+    }
+
+    RtlZeroMemory(Received, sizeof(Received));
+    RtlZeroMemory(&HostWdfCounters, sizeof(HostWdfCounters));
+    HostResetCounters();
+    return;
+}
+
+static
+VOID
+EndWorkload (
+    __in ULONG Bytes,
+    __out PSERIAL_BENCH_RESULT Result
+    )
+{
+    Result->Bytes = Bytes;
+    Result->Cycles = HostWdfCounters.DriverCycles;
+    Result->Interrupts = HostWdfCounters.Interrupts;
+    Result->Dpcs = HostWdfCounters.Dpcs;
+    Result->Corrupted = Bytes - (ULONG)RtlCompareMemory(Received, Data, Bytes);
+    return;
+}
+
+static
+VOID
+RunRead (
+    __out PSERIAL_BENCH_RESULT Result
+    )
+{
+    HOST_WDF_IO Io;
+    ULONG Offset;
+
+    BeginWorkload();
+    Uart16550ModelPeerSend(&Harness.Model, Data, BENCH_BYTES);
+    for (Offset = 0; Offset < BENCH_BYTES; Offset += READ_CHUNK) {
+        HarnessInitializeIo(&Io,
+                            WdfRequestTypeRead,
+                            0,
+                            NULL,
+                            0,
+                            &Received[Offset],
+                            READ_CHUNK);
+
+        HostWdfSend(Harness.Device, &Io);
+        if (HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) == FALSE) {
+            HostWdfCancel(&Io);
+        }
+
+        CHECK(NT_SUCCESS(Io.Status) && (Io.Information == READ_CHUNK),
+              "read at %u: %08x %llu", Offset, Io.Status,
+              (unsigned long long)Io.Information);
+    }
+
+    EndWorkload(BENCH_BYTES, Result);
+    CHECK(Harness.Model.Overruns == 0, "%llu overruns",
+          (unsigned long long)Harness.Model.Overruns);
+
+    return;
+}
+
+static
+VOID
+RunWrite (
+    __in BOOLEAN FlowControl,
+    __out PSERIAL_BENCH_RESULT Result
+    )
+
+/*++
+
+Routine Description:
+
+    Sends the data as back to back writes.  With flow control, the peer
+    sends XOFF, waits XOFF_PERIOD, sends XON and waits again, for as long
+    as a write is outstanding.
+
+--*/
+
+{
+    HOST_WDF_IO Io;
+    ULONG Offset;
+    BOOLEAN Paused;
+    static const UCHAR Xoff = BENCH_XOFF;
+    static const UCHAR Xon = BENCH_XON;
+
+    BeginWorkload();
+    Uart16550ModelPeerReceive(&Harness.Model, Received, BENCH_BYTES);
+    Paused = FALSE;
+    for (Offset = 0; Offset < BENCH_BYTES; Offset += WRITE_CHUNK) {
+        HarnessInitializeIo(&Io,
+                            WdfRequestTypeWrite,
+                            0,
+                            &Data[Offset],
+                            WRITE_CHUNK,
+                            NULL,
+                            0);
+
+        HostWdfSend(Harness.Device, &Io);
+        if (FlowControl == FALSE) {
+            HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT);
+
+        } else {
+            while ((Io.Completed == FALSE) || (Paused != FALSE)) {
+                Uart16550ModelPeerSend(&Harness.Model,
+                                       (Paused != FALSE) ? &Xon : &Xoff,
+                                       1);
+
+                Paused = !Paused;
+                HostWdfRun(XOFF_PERIOD);
+            }
+        }
+
+        if (Io.Completed == FALSE) {
+            HostWdfCancel(&Io);
+        }
+
+        CHECK(NT_SUCCESS(Io.Status) && (Io.Information == WRITE_CHUNK),
+              "write at %u: %08x %llu", Offset, Io.Status,
+              (unsigned long long)Io.Information);
+    }
+
+    CHECK(HarnessWaitForTransmit(&Harness, BENCH_BYTES) != FALSE,
+          "peer received %u of %u", Harness.Model.PeerReceivedCount,
+          BENCH_BYTES);
+
+    EndWorkload(BENCH_BYTES, Result);
+    return;
+}
+
+static
+VOID
+RunWaitMask (
+    __out PSERIAL_BENCH_RESULT Result
+    )
+{
+    ULONG Events;
+    HOST_WDF_IO Io;
+    ULONG Mask;
+    ULONG Offset;
+    NTSTATUS Status;
+
+    Mask = SERIAL_EV_RXCHAR;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_WAIT_MASK,
+                          &Mask,
+                          sizeof(Mask),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_WAIT_MASK %08x", Status);
+    BeginWorkload();
+    for (Offset = 0; Offset < BENCH_WAIT_BYTES; Offset += 1) {
+        Events = 0;
+        HarnessInitializeIo(&Io,
+                            WdfRequestTypeDeviceControl,
+                            IOCTL_SERIAL_WAIT_ON_MASK,
+                            NULL,
+                            0,
+                            &Events,
+                            sizeof(Events));
+
+        HostWdfSend(Harness.Device, &Io);
+        Uart16550ModelPeerSend(&Harness.Model, &Data[Offset], 1);
+        if (HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) == FALSE) {
+            HostWdfCancel(&Io);
+        }
+
+        CHECK(NT_SUCCESS(Io.Status) && (Events == SERIAL_EV_RXCHAR),
+              "wait at %u: %08x events %08x", Offset, Io.Status, Events);
+
+        HarnessInitializeIo(&Io,
+                            WdfRequestTypeRead,
+                            0,
+                            NULL,
+                            0,
+                            &Received[Offset],
+                            1);
+
+        HostWdfSend(Harness.Device, &Io);
+        if (HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) == FALSE) {
+            HostWdfCancel(&Io);
+        }
+
+        CHECK(NT_SUCCESS(Io.Status) && (Io.Information == 1),
+              "read at %u: %08x", Offset, Io.Status);
+    }
+
+    EndWorkload(BENCH_WAIT_BYTES, Result);
+    Mask = 0;
+    HarnessIoctl(&Harness,
+                 IOCTL_SERIAL_SET_WAIT_MASK,
+                 &Mask,
+                 sizeof(Mask),
+                 NULL,
+                 0);
+
+    return;
+}
+
+static
+VOID
+Report (
+    __in PCSTR Name,
+    __in PSERIAL_BENCH_RESULT Result
+    )
+{
+    CHECK(Result->Corrupted == 0, "%s: %u bytes corrupted", Name,
+          Result->Corrupted);
+
+    printf("%-10s %6llu bytes %10.1f cycles/byte %6.3f interrupts/byte "
+           "%6.3f DPCs/byte\n",
+           Name,
+           (unsigned long long)Result->Bytes,
+           (double)Result->Cycles / (double)Result->Bytes,
+           (double)Result->Interrupts / (double)Result->Bytes,
+           (double)Result->Dpcs / (double)Result->Bytes);
+
+    return;
+}
+
+int
+main (
+    VOID
+    )
+{
+    SERIAL_CHARS Chars;
+    SERIAL_HANDFLOW HandFlow;
+    SERIAL_BENCH_RESULT Result;
+    NTSTATUS Status;
+
+    Status = HarnessStart(&Harness, 16);
+    CHECK(NT_SUCCESS(Status), "start %08x", Status);
+    if (!NT_SUCCESS(Status)) {
+        goto End;
+    }
+
+    RtlZeroMemory(&HandFlow, sizeof(HandFlow));
+    HandFlow.ControlHandShake = SERIAL_DTR_CONTROL;
+    HandFlow.FlowReplace = SERIAL_RTS_CONTROL;
+    HandFlow.XonLimit = 256;
+    HandFlow.XoffLimit = 256;
+    Status = HarnessConfigure(&Harness, HARNESS_BAUD_RATE, &HandFlow);
+    CHECK(NT_SUCCESS(Status), "configure %08x", Status);
+    printf("%u baud, 16 byte FIFOs\n", HARNESS_BAUD_RATE);
+
+    RunRead(&Result);
+    Report("read", &Result);
+    RunWrite(FALSE, &Result);
+    Report("write", &Result);
+
+    RtlZeroMemory(&Chars, sizeof(Chars));
+    Chars.XonChar = BENCH_XON;
+    Chars.XoffChar = BENCH_XOFF;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_CHARS,
+                          &Chars,
+                          sizeof(Chars),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_CHARS %08x", Status);
+    HandFlow.FlowReplace |= SERIAL_AUTO_TRANSMIT;
+    Status = HarnessConfigure(&Harness, HARNESS_BAUD_RATE, &HandFlow);
+    CHECK(NT_SUCCESS(Status), "SET_HANDFLOW %08x", Status);
+    RunWrite(TRUE, &Result);
+    Report("xon/xoff", &Result);
+
+    HandFlow.FlowReplace &= ~SERIAL_AUTO_TRANSMIT;
+    Status = HarnessConfigure(&Harness, HARNESS_BAUD_RATE, &HandFlow);
+    CHECK(NT_SUCCESS(Status), "SET_HANDFLOW %08x", Status);
+    RunWaitMask(&Result);
+    Report("wait mask", &Result);
+
+End:
+    HarnessStop(&Harness);
+    return HostTestExit();
+}
@@ -0,0 +1,283 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    serialharness.c
+
+Abstract:
+
+    Bring-up of the KMDF serial driver on the framework emulation, for the
+    serial host tests and benchmarks.
+
+--*/
+
+#include "serialharness.h"
+
+static
+BOOLEAN
+HarnessInterruptLine (
+    __in PVOID Context
+    )
+
+/*++
+
+Routine Description:
+
+    Samples the UART interrupt line.  On a PC the 16550 interrupt output
+    only reaches the interrupt controller while OUT2 is set.
+
+--*/
+
+{
+    PUART16550_MODEL Model;
+
+    Model = Context;
+    if ((Model->Mcr & SERIAL_MCR_OUT2) == 0) {
+        return FALSE;
+    }
+
+    return Uart16550ModelInterruptPending(Model);
+}
+
+NTSTATUS
+HarnessStart (
+    __out PSERIAL_HARNESS Harness,
+    __in ULONG FifoDepth
+    )
+
+/*++
+
+Routine Description:
+
+    Loads the driver and brings up a device at COM1 against a fresh model,
+    then opens it.
+
+Arguments:
+
+    Harness - Receives the model, the device and the open file.
+
+    FifoDepth - Supplies the depth of the modelled UART FIFOs.
+
+Return Value:
+
+    NTSTATUS of the first step that failed.
+
+--*/
+
+{
+    CM_PARTIAL_RESOURCE_DESCRIPTOR Resources[2];
+    NTSTATUS Status;
+
+    RtlZeroMemory(Harness, sizeof(*Harness));
+    Uart16550ModelInitialize(&Harness->Model, HARNESS_PORT, FifoDepth, FALSE);
+    HostSetIoModel(&Harness->Model.Io);
+    HostWdfSetRegistryString(L"PortName", L"COM1");
+    Status = HostWdfLoadDriver(DriverEntry);
+    if (!NT_SUCCESS(Status)) {
+        goto End;
+    }
+
+    Status = HostWdfAddDevice(&Harness->Device);
+    if (!NT_SUCCESS(Status)) {
+        goto End;
+    }
+
+    RtlZeroMemory(Resources, sizeof(Resources));
+    Resources[0].Type = CmResourceTypePort;
+    Resources[0].Flags = CM_RESOURCE_PORT_IO;
+    Resources[0].u.Port.Start.QuadPart = HARNESS_PORT;
+    Resources[0].u.Port.Length = SERIAL_REGISTER_SPAN;
+    Resources[1].Type = CmResourceTypeInterrupt;
+    Resources[1].ShareDisposition = CmResourceShareDeviceExclusive;
+    Resources[1].Flags = CM_RESOURCE_INTERRUPT_LATCHED;
+    Resources[1].u.Interrupt.Level = HARNESS_VECTOR;
+    Resources[1].u.Interrupt.Vector = HARNESS_VECTOR;
+    Resources[1].u.Interrupt.Affinity = 1;
+    Status = HostWdfStartDevice(Harness->Device,
+                                Resources,
+                                RTL_NUMBER_OF(Resources),
+                                HarnessInterruptLine,
+                                &Harness->Model);
+
+    if (!NT_SUCCESS(Status)) {
+        goto End;
+    }
+
+    Status = HostWdfOpen(Harness->Device, &Harness->File);
+
+End:
+    return Status;
+}
+
+VOID
+HarnessStop (
+    __inout PSERIAL_HARNESS Harness
+    )
+{
+    if (Harness->File != NULL) {
+        HostWdfClose(Harness->File);
+        Harness->File = NULL;
+    }
+
+    if (Harness->Device != NULL) {
+        HostWdfRemoveDevice(Harness->Device);
+        Harness->Device = NULL;
+    }
+
+    HostWdfUnloadDriver();
+    HostSetIoModel(NULL);
+    return;
+}
+
+VOID
+HarnessInitializeIo (
+    __out PHOST_WDF_IO Io,
+    __in WDF_REQUEST_TYPE Type,
+    __in ULONG IoControlCode,
+    __in_opt PVOID InputBuffer,
+    __in ULONG InputLength,
+    __out_opt PVOID OutputBuffer,
+    __in ULONG OutputLength
+    )
+{
+    RtlZeroMemory(Io, sizeof(*Io));
+    Io->Type = Type;
+    Io->IoControlCode = IoControlCode;
+    Io->InputBuffer = InputBuffer;
+    Io->InputLength = InputLength;
+    Io->OutputBuffer = OutputBuffer;
+    Io->OutputLength = OutputLength;
+    return;
+}
+
+NTSTATUS
+HarnessIoctl (
+    __inout PSERIAL_HARNESS Harness,
+    __in ULONG IoControlCode,
+    __in_opt PVOID InputBuffer,
+    __in ULONG InputLength,
+    __out_opt PVOID OutputBuffer,
+    __in ULONG OutputLength
+    )
+{
+    HOST_WDF_IO Io;
+
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeDeviceControl,
+                        IoControlCode,
+                        InputBuffer,
+                        InputLength,
+                        OutputBuffer,
+                        OutputLength);
+
+    HostWdfSend(Harness->Device, &Io);
+    if (HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) == FALSE) {
+        HostWdfCancel(&Io);
+        return STATUS_TIMEOUT;
+    }
+
+    return Io.Status;
+}
+
+NTSTATUS
+HarnessConfigure (
+    __inout PSERIAL_HARNESS Harness,
+    __in ULONG BaudRate,
+    __in_opt PSERIAL_HANDFLOW HandFlow
+    )
+
+/*++
+
+Routine Description:
+
+    Sets the port up the way a terminal program does: the baud rate, eight
+    data bits, no parity and one stop bit, reads that return as soon as the
+    requested count has arrived, no write timeout, and the given (or the
+    default) handshake and flow control.
+
+--*/
+
+{
+    SERIAL_BAUD_RATE Baud;
+    SERIAL_LINE_CONTROL LineControl;
+    NTSTATUS Status;
+    SERIAL_TIMEOUTS Timeouts;
+
+    Baud.BaudRate = BaudRate;
+    Status = HarnessIoctl(Harness,
+                          IOCTL_SERIAL_SET_BAUD_RATE,
+                          &Baud,
+                          sizeof(Baud),
+                          NULL,
+                          0);
+
+    if (!NT_SUCCESS(Status)) {
+        goto End;
+    }
+
+    LineControl.StopBits = STOP_BIT_1;
+    LineControl.Parity = NO_PARITY;
+    LineControl.WordLength = 8;
+    Status = HarnessIoctl(Harness,
+                          IOCTL_SERIAL_SET_LINE_CONTROL,
+                          &LineControl,
+                          sizeof(LineControl),
+                          NULL,
+                          0);
+
+    if (!NT_SUCCESS(Status)) {
+        goto End;
+    }
+
+    RtlZeroMemory(&Timeouts, sizeof(Timeouts));
+    Status = HarnessIoctl(Harness,
+                          IOCTL_SERIAL_SET_TIMEOUTS,
+                          &Timeouts,
+                          sizeof(Timeouts),
+                          NULL,
+                          0);
+
+    if (!NT_SUCCESS(Status) || (HandFlow == NULL)) {
+        goto End;
+    }
+
+    Status = HarnessIoctl(Harness,
+                          IOCTL_SERIAL_SET_HANDFLOW,
+                          HandFlow,
+                          sizeof(*HandFlow),
+                          NULL,
+                          0);
+
+End:
+    return Status;
+}
+
+BOOLEAN
+HarnessWaitForTransmit (
+    __inout PSERIAL_HARNESS Harness,
+    __in ULONG Count
+    )
+
+/*++
+
+Routine Description:
+
+    Lets time pass until the peer has received the given number of bytes
+    in total, or until the harness timeout.
+
+--*/
+
+{
+    ULONG64 End;
+
+    End = HostGetTime() + HARNESS_TIMEOUT;
+    while ((Harness->Model.PeerReceivedCount < Count) &&
+           (HostGetTime() < End)) {
+
+        HostWdfRun(Uart16550ModelCharacterTime(&Harness->Model));
+    }
+
+    return (Harness->Model.PeerReceivedCount >= Count) ? TRUE : FALSE;
+}
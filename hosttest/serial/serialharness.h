@@ -0,0 +1,85 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    serialharness.h
+
+Abstract:
+
+    Bring-up of the KMDF serial driver on the framework emulation, for the
+    serial host tests and benchmarks.
+
+    The harness loads the driver, adds a device at COM1 (port 0x3F8) wired
+    to a 16550 register model whose interrupt line is gated by OUT2 as on a
+    PC, starts it and opens it, and sends it requests synchronously.
+
+--*/
+
+#pragma once
+
+#include "precomp.h"
+#include "hostwdf.h"
+#include "uart16550model.h"
+
+#define HARNESS_PORT 0x3F8
+#define HARNESS_VECTOR 4
+#define HARNESS_BAUD_RATE 115200
+
+//
+// Synchronous requests give up after this much virtual time.
+//
+
+#define HARNESS_TIMEOUT (2ULL * 1000 * 1000 * 1000)
+
+typedef struct _SERIAL_HARNESS {
+    UART16550_MODEL Model;
+    WDFDEVICE Device;
+    WDFFILEOBJECT File;
+} SERIAL_HARNESS, *PSERIAL_HARNESS;
+
+NTSTATUS
+HarnessStart (
+    __out PSERIAL_HARNESS Harness,
+    __in ULONG FifoDepth
+    );
+
+VOID
+HarnessStop (
+    __inout PSERIAL_HARNESS Harness
+    );
+
+VOID
+HarnessInitializeIo (
+    __out PHOST_WDF_IO Io,
+    __in WDF_REQUEST_TYPE Type,
+    __in ULONG IoControlCode,
+    __in_opt PVOID InputBuffer,
+    __in ULONG InputLength,
+    __out_opt PVOID OutputBuffer,
+    __in ULONG OutputLength
+    );
+
+NTSTATUS
+HarnessIoctl (
+    __inout PSERIAL_HARNESS Harness,
+    __in ULONG IoControlCode,
+    __in_opt PVOID InputBuffer,
+    __in ULONG InputLength,
+    __out_opt PVOID OutputBuffer,
+    __in ULONG OutputLength
+    );
+
+NTSTATUS
+HarnessConfigure (
+    __inout PSERIAL_HARNESS Harness,
+    __in ULONG BaudRate,
+    __in_opt PSERIAL_HANDFLOW HandFlow
+    );
+
+BOOLEAN
+HarnessWaitForTransmit (
+    __inout PSERIAL_HARNESS Harness,
+    __in ULONG Count
+    );
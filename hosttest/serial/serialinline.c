@@ -0,0 +1,25 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    serialinline.c
+
+Abstract:
+
+    External definitions of the serial driver's __inline register helpers.
+
+    Under C99 inline rules an __inline definition in a header is an inline
+    definition only, so one translation unit must also provide the external
+    definition for the calls the compiler chooses not to inline.  The
+    Microsoft compiler does not need this.
+
+--*/
+
+#include "precomp.h"
+
+extern UCHAR SerialReadPortUChar (UCHAR *x);
+extern VOID SerialWritePortUChar (UCHAR *x, UCHAR y);
+extern UCHAR SerialReadRegisterUChar (UCHAR *x);
+extern VOID SerialWriteRegisterUChar (UCHAR *x, UCHAR y);
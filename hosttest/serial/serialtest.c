@@ -0,0 +1,612 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    serialtest.c
+
+Abstract:
+
+    Host unit test for the KMDF serial driver, run against the framework
+    emulation and the 16550 register model.
+
+    The driver is loaded, started and opened, then reads, writes, segmented
+    writes, XON/XOFF transmit flow control, wait masks, cancellation and
+    purges are each checked end to end through the ISR, the DPCs and the
+    manual queues, along with the private driver statistics.
+    Closing, removing and unloading must leave no framework objects and no
+    pool behind.
+
+--*/
+
+#include <stdio.h>
+#include "serialharness.h"
+#include "hosttest.h"
+
+#define TEST_XON 0x11
+#define TEST_XOFF 0x13
+#define SEGMENT_COUNT 3
+#define SEGMENT_BYTES 40
+#define SEGMENT_DATA_OFFSET                                  \
+    (FIELD_OFFSET(SERIAL_WRITE_SEGMENTS, Segments) +         \
+     (SEGMENT_COUNT * sizeof(SERIAL_WRITE_SEGMENT)))
+#define SEGMENT_BUFFER_BYTES \
+    (SEGMENT_DATA_OFFSET + (SEGMENT_COUNT * SEGMENT_BYTES))
+
+static SERIAL_HARNESS Harness;
+
+static
+VOID
+FillPattern (
+    __out_bcount(Length) PUCHAR Buffer,
+    __in ULONG Length,
+    __in ULONG Seed
+    )
+{
+    ULONG Index;
+
+    //
+    // Stay clear of the flow control characters, which the driver consumes
+    // when transmit flow control is on.
+    //
+
+    for (Index = 0; Index < Length; Index += 1) {
+        Buffer[Index] = (UCHAR)(0x20 + (((Seed * 31) + (Index * 7)) % 0x5F));
+    }
+
+    return;
+}
+
+static
+ULONG
+InQueue (
+    VOID
+    )
+{
+    SERIAL_STATUS CommStatus;
+    NTSTATUS Status;
+
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_GET_COMMSTATUS,
+                          NULL,
+                          0,
+                          &CommStatus,
+                          sizeof(CommStatus));
+
+    CHECK(NT_SUCCESS(Status), "GET_COMMSTATUS %08x", Status);
+    return CommStatus.AmountInInQueue;
+}
+
+static
+VOID
+TestConfiguration (
+    VOID
+    )
+{
+    SERIAL_BAUD_RATE Baud;
+    NTSTATUS Status;
+
+    Status = HarnessConfigure(&Harness, HARNESS_BAUD_RATE, NULL);
+    CHECK(NT_SUCCESS(Status), "configure %08x", Status);
+    Baud.BaudRate = 0;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_GET_BAUD_RATE,
+                          NULL,
+                          0,
+                          &Baud,
+                          sizeof(Baud));
+
+    CHECK(NT_SUCCESS(Status) && (Baud.BaudRate == HARNESS_BAUD_RATE),
+          "GET_BAUD_RATE %08x %u", Status, Baud.BaudRate);
+
+    CHECK((Harness.Model.Dll == 1) && (Harness.Model.Dlm == 0),
+          "divisor %02x%02x", Harness.Model.Dlm, Harness.Model.Dll);
+
+    return;
+}
+
+static
+VOID
+TestRead (
+    VOID
+    )
+{
+    UCHAR Data[64];
+    HOST_WDF_IO Io;
+    UCHAR Received[sizeof(Data)];
+
+    FillPattern(Data, sizeof(Data), 1);
+    RtlZeroMemory(Received, sizeof(Received));
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeRead,
+                        0,
+                        NULL,
+                        0,
+                        Received,
+                        sizeof(Received));
+
+    HostWdfSend(Harness.Device, &Io);
+    HostWdfRun(1000 * 1000);
+    CHECK(Io.Completed == FALSE, "read completed with no data");
+    Uart16550ModelPeerSend(&Harness.Model, Data, sizeof(Data));
+    CHECK(HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) != FALSE,
+          "read never completed");
+
+    CHECK(NT_SUCCESS(Io.Status) && (Io.Information == sizeof(Data)),
+          "read %08x %llu", Io.Status, (unsigned long long)Io.Information);
+
+    CHECK(RtlCompareMemory(Received, Data, sizeof(Data)) == sizeof(Data),
+          "read data corrupted");
+
+    CHECK(Harness.Model.Overruns == 0, "%llu overruns",
+          (unsigned long long)Harness.Model.Overruns);
+
+    return;
+}
+
+static
+VOID
+TestWrite (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    A write must put exactly the request buffer on the wire.  It is longer
+    than a page so that a write path sending from any fixed buffer, rather
+    than the request, shows up as corrupted data.
+
+--*/
+
+{
+    UCHAR Data[PAGE_SIZE + 200];
+    HOST_WDF_IO Io;
+    UCHAR Received[sizeof(Data)];
+
+    FillPattern(Data, sizeof(Data), 2);
+    Uart16550ModelPeerReceive(&Harness.Model, Received, sizeof(Received));
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeWrite,
+                        0,
+                        Data,
+                        sizeof(Data),
+                        NULL,
+                        0);
+
+    HostWdfSend(Harness.Device, &Io);
+    CHECK(HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) != FALSE,
+          "write never completed");
+
+    CHECK(NT_SUCCESS(Io.Status) && (Io.Information == sizeof(Data)),
+          "write %08x %llu", Io.Status, (unsigned long long)Io.Information);
+
+    CHECK(HarnessWaitForTransmit(&Harness, sizeof(Data)) != FALSE,
+          "peer received %u of %u", Harness.Model.PeerReceivedCount,
+          (ULONG)sizeof(Data));
+
+    CHECK(RtlCompareMemory(Received, Data, sizeof(Data)) == sizeof(Data),
+          "written data corrupted");
+    return;
+}
+
+static
+VOID
+TestWriteSegments (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    A segmented write must leave the line idle for at least the requested
+    gap after a segment, counted from the end of its last character rather
+    than from when that character was loaded into the FIFO.
+
+--*/
+
+{
+    ULONG Buffer[SEGMENT_BUFFER_BYTES / sizeof(ULONG)];
+    ULONG64 CharacterTime;
+    PUCHAR Data;
+    ULONG64 Idle;
+    HOST_WDF_IO Io;
+    ULONG Last;
+    UCHAR Received[SEGMENT_COUNT * SEGMENT_BYTES];
+    ULONG Segment;
+    ULONG64 Times[SEGMENT_COUNT * SEGMENT_BYTES];
+    PSERIAL_WRITE_SEGMENTS Write;
+    ULONG Written;
+    static const ULONG Gaps[SEGMENT_COUNT] = { 1000, 3000, 0 };
+
+    RtlZeroMemory(Buffer, sizeof(Buffer));
+    Write = (PSERIAL_WRITE_SEGMENTS)Buffer;
+    Write->SegmentCount = SEGMENT_COUNT;
+    Data = (PUCHAR)Buffer + SEGMENT_DATA_OFFSET;
+    for (Segment = 0; Segment < SEGMENT_COUNT; Segment += 1) {
+        Write->Segments[Segment].Offset =
+            SEGMENT_DATA_OFFSET + (Segment * SEGMENT_BYTES);
+
+        Write->Segments[Segment].Length = SEGMENT_BYTES;
+        Write->Segments[Segment].GapMicroseconds = Gaps[Segment];
+    }
+
+    FillPattern(Data, sizeof(Received), 4);
+    Uart16550ModelPeerReceive(&Harness.Model, Received, sizeof(Received));
+    Harness.Model.PeerReceivedTimes = Times;
+    Written = 0;
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeDeviceControl,
+                        IOCTL_SERIAL_WRITE_SEGMENTS,
+                        Buffer,
+                        sizeof(Buffer),
+                        &Written,
+                        sizeof(Written));
+
+    HostWdfSend(Harness.Device, &Io);
+    CHECK(HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) != FALSE,
+          "segmented write never completed");
+
+    CHECK(NT_SUCCESS(Io.Status) && (Written == sizeof(Received)),
+          "segmented write %08x %u", Io.Status, Written);
+
+    CHECK(HarnessWaitForTransmit(&Harness, sizeof(Received)) != FALSE,
+          "peer received %u of %u", Harness.Model.PeerReceivedCount,
+          (ULONG)sizeof(Received));
+
+    Harness.Model.PeerReceivedTimes = NULL;
+    CHECK(RtlCompareMemory(Received, Data, sizeof(Received)) ==
+              sizeof(Received),
+          "segmented write data corrupted");
+
+    //
+    // The times are when each stop bit ended, so the line was idle from
+    // the end of a segment's last character until one character time
+    // before the end of the next segment's first.
+    //
+
+    CharacterTime = Uart16550ModelCharacterTime(&Harness.Model);
+    for (Segment = 0; Segment < (SEGMENT_COUNT - 1); Segment += 1) {
+        Last = ((Segment + 1) * SEGMENT_BYTES) - 1;
+        Idle = Times[Last + 1] - CharacterTime - Times[Last];
+        CHECK(Idle >= (Gaps[Segment] * 1000ULL),
+              "line idle %llu us after segment %u, asked for %u us",
+              (unsigned long long)(Idle / 1000), Segment, Gaps[Segment]);
+    }
+
+    return;
+}
+
+static
+VOID
+TestXonXoff (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    With automatic transmit flow control on, an XOFF from the peer must
+    hold a write until the peer sends XON, and the hold must be reported
+    by IOCTL_SERIAL_GET_COMMSTATUS.
+
+--*/
+
+{
+    SERIAL_CHARS Chars;
+    SERIAL_STATUS CommStatus;
+    UCHAR Data[32];
+    SERIAL_HANDFLOW HandFlow;
+    HOST_WDF_IO Io;
+    UCHAR Received[sizeof(Data)];
+    NTSTATUS Status;
+    static const UCHAR Xoff = TEST_XOFF;
+    static const UCHAR Xon = TEST_XON;
+
+    RtlZeroMemory(&Chars, sizeof(Chars));
+    Chars.XonChar = TEST_XON;
+    Chars.XoffChar = TEST_XOFF;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_CHARS,
+                          &Chars,
+                          sizeof(Chars),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_CHARS %08x", Status);
+    RtlZeroMemory(&HandFlow, sizeof(HandFlow));
+    HandFlow.ControlHandShake = SERIAL_DTR_CONTROL;
+    HandFlow.FlowReplace = SERIAL_RTS_CONTROL | SERIAL_AUTO_TRANSMIT;
+    HandFlow.XonLimit = 256;
+    HandFlow.XoffLimit = 256;
+    Status = HarnessConfigure(&Harness, HARNESS_BAUD_RATE, &HandFlow);
+    CHECK(NT_SUCCESS(Status), "SET_HANDFLOW %08x", Status);
+
+    //
+    // A lone character below the receive trigger level is only reported by
+    // the character timeout, four character times after it arrives.
+    //
+
+    Uart16550ModelPeerSend(&Harness.Model, &Xoff, 1);
+    HostWdfRun(8 * Uart16550ModelCharacterTime(&Harness.Model));
+    FillPattern(Data, sizeof(Data), 3);
+    Uart16550ModelPeerReceive(&Harness.Model, Received, sizeof(Received));
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeWrite,
+                        0,
+                        Data,
+                        sizeof(Data),
+                        NULL,
+                        0);
+
+    HostWdfSend(Harness.Device, &Io);
+    HostWdfRun(10 * 1000 * 1000);
+    CHECK(Io.Completed == FALSE, "write completed during XOFF");
+    CHECK(Harness.Model.PeerReceivedCount == 0,
+          "%u bytes sent during XOFF", Harness.Model.PeerReceivedCount);
+
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_GET_COMMSTATUS,
+                          NULL,
+                          0,
+                          &CommStatus,
+                          sizeof(CommStatus));
+
+    CHECK(NT_SUCCESS(Status) &&
+          ((CommStatus.HoldReasons & SERIAL_TX_WAITING_FOR_XON) != 0),
+          "GET_COMMSTATUS %08x hold reasons %08x", Status,
+          CommStatus.HoldReasons);
+
+    Uart16550ModelPeerSend(&Harness.Model, &Xon, 1);
+    CHECK(HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) != FALSE,
+          "write never resumed after XON");
+
+    CHECK(NT_SUCCESS(Io.Status) && (Io.Information == sizeof(Data)),
+          "write %08x %llu", Io.Status, (unsigned long long)Io.Information);
+
+    CHECK(HarnessWaitForTransmit(&Harness, sizeof(Data)) != FALSE,
+          "peer received %u of %u", Harness.Model.PeerReceivedCount,
+          (ULONG)sizeof(Data));
+
+    CHECK(RtlCompareMemory(Received, Data, sizeof(Data)) == sizeof(Data),
+          "written data corrupted");
+
+    CHECK(InQueue() == 0, "flow control characters were queued for read");
+    HandFlow.FlowReplace = SERIAL_RTS_CONTROL;
+    Status = HarnessConfigure(&Harness, HARNESS_BAUD_RATE, &HandFlow);
+    CHECK(NT_SUCCESS(Status), "SET_HANDFLOW %08x", Status);
+    return;
+}
+
+static
+VOID
+TestWaitMask (
+    VOID
+    )
+{
+    UCHAR Byte;
+    ULONG Events;
+    HOST_WDF_IO Io;
+    ULONG Mask;
+    UCHAR Received;
+    NTSTATUS Status;
+
+    Mask = SERIAL_EV_RXCHAR;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_WAIT_MASK,
+                          &Mask,
+                          sizeof(Mask),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_WAIT_MASK %08x", Status);
+    Events = 0;
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeDeviceControl,
+                        IOCTL_SERIAL_WAIT_ON_MASK,
+                        NULL,
+                        0,
+                        &Events,
+                        sizeof(Events));
+
+    HostWdfSend(Harness.Device, &Io);
+    HostWdfRun(1000 * 1000);
+    CHECK(Io.Completed == FALSE, "wait completed with no event");
+    Byte = 'W';
+    Uart16550ModelPeerSend(&Harness.Model, &Byte, 1);
+    CHECK(HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) != FALSE,
+          "wait never completed");
+
+    CHECK(NT_SUCCESS(Io.Status) && (Io.Information == sizeof(Events)) &&
+          (Events == SERIAL_EV_RXCHAR),
+          "wait %08x %llu events %08x", Io.Status,
+          (unsigned long long)Io.Information, Events);
+
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeRead,
+                        0,
+                        NULL,
+                        0,
+                        &Received,
+                        sizeof(Received));
+
+    HostWdfSend(Harness.Device, &Io);
+    CHECK(HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) != FALSE,
+          "read after wait never completed");
+
+    CHECK(NT_SUCCESS(Io.Status) && (Received == Byte),
+          "read after wait %08x %02x", Io.Status, Received);
+
+    //
+    // Changing the mask completes an outstanding wait with no events.
+    //
+
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeDeviceControl,
+                        IOCTL_SERIAL_WAIT_ON_MASK,
+                        NULL,
+                        0,
+                        &Events,
+                        sizeof(Events));
+
+    HostWdfSend(Harness.Device, &Io);
+    Mask = 0;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_WAIT_MASK,
+                          &Mask,
+                          sizeof(Mask),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_WAIT_MASK %08x", Status);
+    CHECK((Io.Completed != FALSE) && NT_SUCCESS(Io.Status) && (Events == 0),
+          "superseded wait %u %08x events %08x", Io.Completed, Io.Status,
+          Events);
+
+    return;
+}
+
+static
+VOID
+TestCancelAndPurge (
+    VOID
+    )
+{
+    UCHAR Data[10];
+    HOST_WDF_IO Io;
+    ULONG Purge;
+    UCHAR Received[sizeof(Data)];
+    NTSTATUS Status;
+
+    HarnessInitializeIo(&Io,
+                        WdfRequestTypeRead,
+                        0,
+                        NULL,
+                        0,
+                        Received,
+                        sizeof(Received));
+
+    HostWdfSend(Harness.Device, &Io);
+    HostWdfRun(1000 * 1000);
+    CHECK(Io.Completed == FALSE, "read completed with no data");
+    HostWdfCancel(&Io);
+    CHECK((Io.Completed != FALSE) && (Io.Status == STATUS_CANCELLED),
+          "cancelled read %u %08x", Io.Completed, Io.Status);
+
+    FillPattern(Data, sizeof(Data), 4);
+    Uart16550ModelPeerSend(&Harness.Model, Data, sizeof(Data));
+    HostWdfRun(sizeof(Data) * 2 * Uart16550ModelCharacterTime(&Harness.Model));
+    CHECK(InQueue() == sizeof(Data), "%u bytes queued before purge",
+          InQueue());
+
+    Purge = SERIAL_PURGE_RXCLEAR;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_PURGE,
+                          &Purge,
+                          sizeof(Purge),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "PURGE %08x", Status);
+    CHECK(InQueue() == 0, "%u bytes queued after purge", InQueue());
+    return;
+}
+
+static
+VOID
+TestDriverStats (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    IOCTL_SERIAL_GET_DRIVER_STATS must succeed after the traffic above
+    and account for the one purge.  The emulation runs one dpc at a
+    time, so the read and write completion dpcs never overlap and no
+    contention may be counted.  IOCTL_SERIAL_CLEAR_STATS must reset it
+    all.
+
+--*/
+
+{
+    SERIAL_DRIVER_STATS Stats;
+    NTSTATUS Status;
+
+    RtlFillMemory(&Stats, sizeof(Stats), 0xFF);
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_GET_DRIVER_STATS,
+                          NULL,
+                          0,
+                          &Stats,
+                          sizeof(Stats));
+
+    CHECK(NT_SUCCESS(Status), "GET_DRIVER_STATS %08x", Status);
+    CHECK(Stats.CompletionContentionCount == 0, "%u completion contentions",
+          Stats.CompletionContentionCount);
+
+    CHECK((Stats.PurgeCount == 1) &&
+          (Stats.PurgeTicks == Stats.LastPurgeTicks) &&
+          (Stats.LastPurgeTicks >= 0) &&
+          (Stats.Frequency > 0),
+          "purge stats %u %lld %lld %lld", Stats.PurgeCount,
+          (long long)Stats.PurgeTicks, (long long)Stats.LastPurgeTicks,
+          (long long)Stats.Frequency);
+
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_CLEAR_STATS,
+                          NULL,
+                          0,
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "CLEAR_STATS %08x", Status);
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_GET_DRIVER_STATS,
+                          NULL,
+                          0,
+                          &Stats,
+                          sizeof(Stats));
+
+    CHECK(NT_SUCCESS(Status) && (Stats.PurgeCount == 0) &&
+          (Stats.PurgeTicks == 0) && (Stats.LastPurgeTicks == 0),
+          "cleared purge stats %08x %u %lld", Status, Stats.PurgeCount,
+          (long long)Stats.PurgeTicks);
+
+    return;
+}
+
+int
+main (
+    VOID
+    )
+{
+    NTSTATUS Status;
+
+    Status = HarnessStart(&Harness, 16);
+    CHECK(NT_SUCCESS(Status), "start %08x", Status);
+    if (NT_SUCCESS(Status)) {
+        TestConfiguration();
+        TestRead();
+        TestWrite();
+        TestWriteSegments();
+        TestXonXoff();
+        TestWaitMask();
+        TestCancelAndPurge();
+        TestDriverStats();
+    }
+
+    HarnessStop(&Harness);
+    CHECK(HostWdfObjectCount() == 0, "%u framework objects leaked",
+          HostWdfObjectCount());
+
+    CHECK(HostPoolAllocations == 0, "%u pool allocations leaked",
+          HostPoolAllocations);
+
+    return HostTestExit();
+}
@@ -0,0 +1,430 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    specialchartest.c
+
+Abstract:
+
+    Differential host test for the receive path's special character map.
+
+    The ISR looks each received character up in SpecialCharMap and only
+    runs the null stripping, XON/XOFF, EV_RXFLAG and escape checks for the
+    values marked there.  A map with every entry set sends every character
+    through all of those checks, which is the per-character path the map
+    replaced.
+
+    The same pseudo random stream, heavy in null, flow control, event and
+    escape characters, is received twice on a fresh device: once with the
+    map as the driver maintains it and once with it forced full after every
+    change.  The characters read, the events reported and the transmit hold
+    state after every burst must match.  The settings change between
+    phases of the stream, so entries left behind by earlier special
+    characters are exercised too.
+
+--*/
+
+#include <stdio.h>
+#include "serialharness.h"
+#include "hosttest.h"
+
+#define BURST_BYTES 16
+#define PHASE_BYTES 1024
+#define READ_BYTES 64
+#define TRANSCRIPT_BYTES (64 * 1024)
+
+typedef struct _SPECIAL_PHASE {
+    UCHAR WordLength;
+    UCHAR XonChar;
+    UCHAR XoffChar;
+    UCHAR EventChar;
+    UCHAR EscapeChar;
+    ULONG FlowReplace;
+} SPECIAL_PHASE, *PSPECIAL_PHASE;
+
+//
+// The 7 bit phase folds characters with the high bit set onto the special
+// ones and uses null as the event character, and the last phase makes the
+// escape character the same as the event character.
+//
+
+static const SPECIAL_PHASE Phases[] = {
+    { 8, 0x11, 0x13, '\n', 0xFF,
+      SERIAL_RTS_CONTROL | SERIAL_AUTO_TRANSMIT | SERIAL_NULL_STRIPPING },
+    { 7, 0x11, 0x13, 0x00, 0x1B,
+      SERIAL_RTS_CONTROL | SERIAL_AUTO_TRANSMIT },
+    { 8, 'Q', 'S', 'E', 'E',
+      SERIAL_RTS_CONTROL },
+};
+
+typedef struct _SPECIAL_RUN {
+    UCHAR Transcript[TRANSCRIPT_BYTES];
+    ULONG Length;
+    ULONG Events;
+    ULONG Holds;
+    ULONG Escapes;
+} SPECIAL_RUN, *PSPECIAL_RUN;
+
+static SERIAL_HARNESS Harness;
+static SPECIAL_RUN Runs[2];
+
+static
+UCHAR
+NextCharacter (
+    __inout PULONG Seed,
+    __in const SPECIAL_PHASE *Phase
+    )
+
+/*++
+
+Routine Description:
+
+    Returns the next character of the stream.  Half of them are one of the
+    special characters of the phase, or that character with the high bit
+    set, and the rest are uniformly random.
+
+--*/
+
+{
+    UCHAR Character;
+    ULONG Value;
+
+    *Seed = (*Seed * 1103515245) + 12345;
+    Value = *Seed >> 16;
+    switch (Value % 12) {
+    case 0:
+        Character = 0;
+        break;
+
+    case 1:
+        Character = Phase->XonChar;
+        break;
+
+    case 2:
+        Character = Phase->XoffChar;
+        break;
+
+    case 3:
+        Character = Phase->EventChar;
+        break;
+
+    case 4:
+        Character = Phase->EscapeChar;
+        break;
+
+    case 5:
+        Character = (UCHAR)(Phases[(Value >> 4) % RTL_NUMBER_OF(Phases)].XonChar |
+                            0x80);
+
+        break;
+
+    default:
+        Character = (UCHAR)(Value >> 8);
+        break;
+    }
+
+    return Character;
+}
+
+static
+VOID
+Record (
+    __inout PSPECIAL_RUN Run,
+    __in_bcount(Length) const VOID *Data,
+    __in ULONG Length
+    )
+{
+    if ((Run->Length + Length) > sizeof(Run->Transcript)) {
+        CHECK(FALSE, "transcript overflow");
+        return;
+    }
+
+    RtlCopyMemory(&Run->Transcript[Run->Length], Data, Length);
+    Run->Length += Length;
+    return;
+}
+
+static
+VOID
+ForceFullMap (
+    __in BOOLEAN Legacy
+    )
+{
+    PSERIAL_DEVICE_EXTENSION Extension;
+
+    if (Legacy != FALSE) {
+        Extension = SerialGetDeviceExtension(Harness.Device);
+        RtlFillMemory(Extension->SpecialCharMap,
+                      sizeof(Extension->SpecialCharMap),
+                      1);
+    }
+
+    return;
+}
+
+static
+VOID
+ApplyPhase (
+    __in const SPECIAL_PHASE *Phase,
+    __in BOOLEAN Legacy
+    )
+{
+    SERIAL_CHARS Chars;
+    SERIAL_HANDFLOW HandFlow;
+    SERIAL_LINE_CONTROL LineControl;
+    NTSTATUS Status;
+    SERIAL_TIMEOUTS Timeouts;
+    ULONG Mask;
+    UCHAR Escape;
+
+    RtlZeroMemory(&HandFlow, sizeof(HandFlow));
+    HandFlow.ControlHandShake = SERIAL_DTR_CONTROL;
+    HandFlow.FlowReplace = Phase->FlowReplace;
+    HandFlow.XonLimit = 256;
+    HandFlow.XoffLimit = 256;
+    Status = HarnessConfigure(&Harness, HARNESS_BAUD_RATE, &HandFlow);
+    CHECK(NT_SUCCESS(Status), "configure %08x", Status);
+
+    LineControl.StopBits = STOP_BIT_1;
+    LineControl.Parity = NO_PARITY;
+    LineControl.WordLength = Phase->WordLength;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_LINE_CONTROL,
+                          &LineControl,
+                          sizeof(LineControl),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_LINE_CONTROL %08x", Status);
+
+    //
+    // Reads return at once with whatever has been received.
+    //
+
+    RtlZeroMemory(&Timeouts, sizeof(Timeouts));
+    Timeouts.ReadIntervalTimeout = MAXULONG;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_TIMEOUTS,
+                          &Timeouts,
+                          sizeof(Timeouts),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_TIMEOUTS %08x", Status);
+
+    RtlZeroMemory(&Chars, sizeof(Chars));
+    Chars.XonChar = Phase->XonChar;
+    Chars.XoffChar = Phase->XoffChar;
+    Chars.EventChar = Phase->EventChar;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_CHARS,
+                          &Chars,
+                          sizeof(Chars),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_CHARS %08x", Status);
+    ForceFullMap(Legacy);
+
+    Escape = Phase->EscapeChar;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_LSRMST_INSERT,
+                          &Escape,
+                          sizeof(Escape),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "LSRMST_INSERT %08x", Status);
+    ForceFullMap(Legacy);
+
+    Mask = SERIAL_EV_RXCHAR | SERIAL_EV_RXFLAG;
+    Status = HarnessIoctl(&Harness,
+                          IOCTL_SERIAL_SET_WAIT_MASK,
+                          &Mask,
+                          sizeof(Mask),
+                          NULL,
+                          0);
+
+    CHECK(NT_SUCCESS(Status), "SET_WAIT_MASK %08x", Status);
+
+    //
+    // Start every phase with transmission released.
+    //
+
+    SerialGetDeviceExtension(Harness.Device)->TXHolding &= ~SERIAL_TX_XOFF;
+    return;
+}
+
+static
+VOID
+Collect (
+    __inout PSPECIAL_RUN Run,
+    __in UCHAR EscapeChar
+    )
+
+/*++
+
+Routine Description:
+
+    Appends to the transcript everything the driver has received since the
+    last burst, the events it has noted and whether it is holding
+    transmission for XOFF.
+
+--*/
+
+{
+    ULONG Events;
+    PSERIAL_DEVICE_EXTENSION Extension;
+    ULONG Hold;
+    ULONG Index;
+    HOST_WDF_IO Io;
+    UCHAR Received[READ_BYTES];
+    NTSTATUS Status;
+
+    Extension = SerialGetDeviceExtension(Harness.Device);
+    do {
+        HarnessInitializeIo(&Io,
+                            WdfRequestTypeRead,
+                            0,
+                            NULL,
+                            0,
+                            Received,
+                            sizeof(Received));
+
+        HostWdfSend(Harness.Device, &Io);
+        if (HostWdfRunUntilComplete(&Io, HARNESS_TIMEOUT) == FALSE) {
+            HostWdfCancel(&Io);
+        }
+
+        CHECK(NT_SUCCESS(Io.Status), "read %08x", Io.Status);
+        Record(Run, Received, (ULONG)Io.Information);
+        for (Index = 1; Index < Io.Information; Index += 1) {
+            if ((EscapeChar != 0) &&
+                (Received[Index - 1] == EscapeChar) &&
+                (Received[Index] == SERIAL_LSRMST_ESCAPE)) {
+
+                Run->Escapes += 1;
+            }
+        }
+
+    } while (Io.Information == sizeof(Received));
+
+    //
+    // A wait completes at once with the events noted so far and clears
+    // them.  With nothing noted it would stay pending, so only ask then.
+    //
+
+    Events = 0;
+    if (Extension->HistoryMask != 0) {
+        Status = HarnessIoctl(&Harness,
+                              IOCTL_SERIAL_WAIT_ON_MASK,
+                              NULL,
+                              0,
+                              &Events,
+                              sizeof(Events));
+
+        CHECK(NT_SUCCESS(Status), "WAIT_ON_MASK %08x", Status);
+    }
+
+    Hold = Extension->TXHolding & SERIAL_TX_XOFF;
+    Record(Run, &Events, sizeof(Events));
+    Record(Run, &Hold, sizeof(Hold));
+    if ((Events & SERIAL_EV_RXFLAG) != 0) {
+        Run->Events += 1;
+    }
+
+    if (Hold != 0) {
+        Run->Holds += 1;
+    }
+
+    return;
+}
+
+static
+VOID
+RunStream (
+    __out PSPECIAL_RUN Run,
+    __in BOOLEAN Legacy
+    )
+{
+    UCHAR Burst[BURST_BYTES];
+    ULONG Index;
+    ULONG Offset;
+    ULONG Phase;
+    ULONG Seed;
+    NTSTATUS Status;
+
+    RtlZeroMemory(Run, sizeof(*Run));
+    Status = HarnessStart(&Harness, 16);
+    CHECK(NT_SUCCESS(Status), "start %08x", Status);
+    if (!NT_SUCCESS(Status)) {
+        goto End;
+    }
+
+    Seed = 1;
+    for (Phase = 0; Phase < RTL_NUMBER_OF(Phases); Phase += 1) {
+        ApplyPhase(&Phases[Phase], Legacy);
+        for (Offset = 0; Offset < PHASE_BYTES; Offset += BURST_BYTES) {
+            for (Index = 0; Index < BURST_BYTES; Index += 1) {
+                Burst[Index] = NextCharacter(&Seed, &Phases[Phase]);
+            }
+
+            Uart16550ModelPeerSend(&Harness.Model, Burst, BURST_BYTES);
+            HostWdfRun((BURST_BYTES + 8) *
+                       Uart16550ModelCharacterTime(&Harness.Model));
+
+            Collect(Run, Phases[Phase].EscapeChar);
+        }
+    }
+
+End:
+    HarnessStop(&Harness);
+    return;
+}
+
+int
+main (
+    VOID
+    )
+{
+    ULONG Index;
+
+    RunStream(&Runs[0], FALSE);
+    RunStream(&Runs[1], TRUE);
+
+    //
+    // The stream has to have reached the paths being compared.
+    //
+
+    CHECK((Runs[1].Events != 0) && (Runs[1].Holds != 0) &&
+          (Runs[1].Escapes != 0),
+          "stream reached %u event, %u hold and %u escape bursts",
+          Runs[1].Events, Runs[1].Holds, Runs[1].Escapes);
+
+    CHECK(Runs[0].Length == Runs[1].Length,
+          "transcript %u bytes with the map, %u without",
+          Runs[0].Length, Runs[1].Length);
+
+    for (Index = 0; Index < min(Runs[0].Length, Runs[1].Length); Index += 1) {
+        if (Runs[0].Transcript[Index] != Runs[1].Transcript[Index]) {
+            CHECK(FALSE, "transcripts differ at %u: %02x with the map, "
+                  "%02x without", Index, Runs[0].Transcript[Index],
+                  Runs[1].Transcript[Index]);
+
+            break;
+        }
+    }
+
+    CHECK(HostWdfObjectCount() == 0, "%u framework objects leaked",
+          HostWdfObjectCount());
+
+    CHECK(HostPoolAllocations == 0, "%u pool allocations leaked",
+          HostPoolAllocations);
+
+    printf("%u byte transcripts, %u event, %u hold and %u escape bursts\n",
+           Runs[1].Length, Runs[1].Events, Runs[1].Holds, Runs[1].Escapes);
+
+    return HostTestExit();
+}
@@ -0,0 +1,357 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hostkdnet.c
+
+Abstract:
+
+    Host stand in for KDNET.  See hostkdnet.h.
+
+    Physical addresses are identity mapped: a module's virtual addresses are
+    handed back as physical addresses and mapping a physical address returns
+    the same pointer.  PCI configuration space reads come from
+    HostPciConfigSpace.
+
+--*/
+
+#define _KDNET_INTERNAL_
+#define _KDNETEXTENSIBILITY_C_
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <ntddk.h>
+#include "hostkdnet.h"
+
+KDNET_EXTENSIBILITY_EXPORTS HostKdNetExports;
+UCHAR HostPciConfigSpace[256];
+
+static NTSTATUS HostKdNetErrorStatus;
+static PWCHAR HostKdNetErrorString;
+static ULONG HostKdNetHardwareID;
+static UCHAR HostTargetMacAddress[MAC_ADDRESS_SIZE];
+static UCHAR HostLinkState;
+
+static
+ULONG
+HostGetPciDataByOffset (
+    __in ULONG BusNumber,
+    __in ULONG SlotNumber,
+    __out_bcount(Length) PVOID Buffer,
+    __in ULONG Offset,
+    __in ULONG Length
+    )
+{
+    UNREFERENCED_PARAMETER(BusNumber);
+    UNREFERENCED_PARAMETER(SlotNumber);
+    if (Offset >= sizeof(HostPciConfigSpace)) {
+        return 0;
+    }
+
+    Length = min(Length, (ULONG)sizeof(HostPciConfigSpace) - Offset);
+    RtlCopyMemory(Buffer, &HostPciConfigSpace[Offset], Length);
+    return Length;
+}
+
+static
+ULONG
+HostSetPciDataByOffset (
+    __in ULONG BusNumber,
+    __in ULONG SlotNumber,
+    __in_bcount(Length) PVOID Buffer,
+    __in ULONG Offset,
+    __in ULONG Length
+    )
+{
+    UNREFERENCED_PARAMETER(BusNumber);
+    UNREFERENCED_PARAMETER(SlotNumber);
+    if (Offset >= sizeof(HostPciConfigSpace)) {
+        return 0;
+    }
+
+    Length = min(Length, (ULONG)sizeof(HostPciConfigSpace) - Offset);
+    RtlCopyMemory(&HostPciConfigSpace[Offset], Buffer, Length);
+    return Length;
+}
+
+static
+PHYSICAL_ADDRESS
+HostGetPhysicalAddress (
+    __in PVOID Va
+    )
+{
+    PHYSICAL_ADDRESS Pa;
+
+    Pa.QuadPart = (LONG64)(ULONG_PTR)Va;
+    return Pa;
+}
+
+static UCHAR HostReadRegisterUChar (PUCHAR Register)
+{
+    return READ_REGISTER_UCHAR(Register);
+}
+
+static USHORT HostReadRegisterUShort (PUSHORT Register)
+{
+    return READ_REGISTER_USHORT(Register);
+}
+
+static ULONG HostReadRegisterULong (PULONG Register)
+{
+    return READ_REGISTER_ULONG(Register);
+}
+
+static ULONG64 HostReadRegisterULong64 (PULONG64 Register)
+{
+    ULONG64 Value;
+
+    Value = READ_REGISTER_ULONG((PULONG)Register);
+    Value |= (ULONG64)READ_REGISTER_ULONG((PULONG)Register + 1) << 32;
+    return Value;
+}
+
+static VOID HostWriteRegisterUChar (PUCHAR Register, UCHAR Value)
+{
+    WRITE_REGISTER_UCHAR(Register, Value);
+}
+
+static VOID HostWriteRegisterUShort (PUSHORT Register, USHORT Value)
+{
+    WRITE_REGISTER_USHORT(Register, Value);
+}
+
+static VOID HostWriteRegisterULong (PULONG Register, ULONG Value)
+{
+    WRITE_REGISTER_ULONG(Register, Value);
+}
+
+static VOID HostWriteRegisterULong64 (PULONG64 Register, ULONG64 Value)
+{
+    WRITE_REGISTER_ULONG((PULONG)Register, (ULONG)Value);
+    WRITE_REGISTER_ULONG((PULONG)Register + 1, (ULONG)(Value >> 32));
+}
+
+static ULONG HostReadPortULong64 (PULONG64 Port)
+{
+    return READ_PORT_ULONG((PULONG)Port);
+}
+
+static VOID HostWritePortULong64 (PULONG Port, ULONG64 Value)
+{
+    WRITE_PORT_ULONG(Port, (ULONG)Value);
+}
+
+static
+VOID
+HostSetHiberRange (
+    _In_opt_ PVOID MemoryMap,
+    _In_ ULONG Flags,
+    _In_ PVOID Address,
+    _In_ ULONG_PTR Length,
+    _In_ ULONG Tag
+    )
+{
+    UNREFERENCED_PARAMETER(MemoryMap);
+    UNREFERENCED_PARAMETER(Flags);
+    UNREFERENCED_PARAMETER(Address);
+    UNREFERENCED_PARAMETER(Length);
+    UNREFERENCED_PARAMETER(Tag);
+}
+
+static
+VOID
+HostBugCheckEx (
+    __in ULONG BugCheckCode,
+    __in ULONG_PTR BugCheckParameter1,
+    __in ULONG_PTR BugCheckParameter2,
+    __in ULONG_PTR BugCheckParameter3,
+    __in ULONG_PTR BugCheckParameter4
+    )
+{
+    fprintf(stderr, "bugcheck %x (%lx, %lx, %lx, %lx)\n", BugCheckCode,
+            (unsigned long)BugCheckParameter1,
+            (unsigned long)BugCheckParameter2,
+            (unsigned long)BugCheckParameter3,
+            (unsigned long)BugCheckParameter4);
+
+    abort();
+}
+
+static
+PVOID
+HostMapPhysicalMemory64 (
+    _In_ PHYSICAL_ADDRESS PhysicalAddress,
+    _In_ ULONG NumberPages,
+    _In_ BOOLEAN FlushCurrentTLB
+    )
+{
+    UNREFERENCED_PARAMETER(NumberPages);
+    UNREFERENCED_PARAMETER(FlushCurrentTLB);
+    return (PVOID)(ULONG_PTR)PhysicalAddress.QuadPart;
+}
+
+static
+VOID
+HostUnmapVirtualAddress (
+    _In_ PVOID VirtualAddress,
+    _In_ ULONG NumberPages,
+    _In_ BOOLEAN FlushCurrentTLB
+    )
+{
+    UNREFERENCED_PARAMETER(VirtualAddress);
+    UNREFERENCED_PARAMETER(NumberPages);
+    UNREFERENCED_PARAMETER(FlushCurrentTLB);
+}
+
+static
+ULONG64
+HostReadCycleCounter (
+    __out_opt PULONG64 Frequency
+    )
+{
+    if (Frequency != NULL) {
+        *Frequency = HOST_CYCLES_PER_MICROSECOND * 1000000;
+    }
+
+    return ReadTimeStampCounter();
+}
+
+static
+VOID
+HostDbgPrintf (
+    _Printf_format_string_ PCHAR pFmt,
+    ...
+    )
+{
+    UNREFERENCED_PARAMETER(pFmt);
+}
+
+static KDNET_EXTENSIBILITY_IMPORTS HostKdNetImports = {
+    KDNET_EXT_IMPORTS,
+    &HostKdNetExports,
+    HostGetPciDataByOffset,
+    HostSetPciDataByOffset,
+    HostGetPhysicalAddress,
+    KeStallExecutionProcessor,
+    HostReadRegisterUChar,
+    HostReadRegisterUShort,
+    HostReadRegisterULong,
+    HostReadRegisterULong64,
+    HostWriteRegisterUChar,
+    HostWriteRegisterUShort,
+    HostWriteRegisterULong,
+    HostWriteRegisterULong64,
+    READ_PORT_UCHAR,
+    READ_PORT_USHORT,
+    READ_PORT_ULONG,
+    HostReadPortULong64,
+    WRITE_PORT_UCHAR,
+    WRITE_PORT_USHORT,
+    WRITE_PORT_ULONG,
+    HostWritePortULong64,
+    HostSetHiberRange,
+    HostBugCheckEx,
+    HostMapPhysicalMemory64,
+    HostUnmapVirtualAddress,
+    HostReadCycleCounter,
+    HostDbgPrintf,
+    &HostKdNetErrorStatus,
+    &HostKdNetErrorString,
+    &HostKdNetHardwareID,
+};
+
+NTSTATUS
+HostKdNetInitialize (
+    __in_opt PCHAR LoaderOptions,
+    __inout PDEBUG_DEVICE_DESCRIPTOR Device,
+    __in ULONG ExportCount
+    )
+
+/*++
+
+Routine Description:
+
+    Loads the extensibility module linked into the test, the way KDNET does.
+
+Arguments:
+
+    LoaderOptions - Supplies the loadoptions string handed to the module.
+
+    Device - Supplies the debug device descriptor.  The module returns the
+        hardware context size it needs in Device->Memory.Length.
+
+    ExportCount - Supplies the FunctionCount of the export table, so that a
+        test can stand in for an older KDNET.
+
+Return Value:
+
+    The status returned by KdInitializeLibrary.
+
+--*/
+
+{
+    RtlZeroMemory(&HostKdNetExports, sizeof(HostKdNetExports));
+    HostKdNetExports.FunctionCount = ExportCount;
+    return KdInitializeLibrary(&HostKdNetImports, LoaderOptions, Device);
+}
+
+NTSTATUS
+HostKdNetStart (
+    __inout PKDNET_SHARED_DATA KdNet,
+    __in PDEBUG_DEVICE_DESCRIPTOR Device
+    )
+
+/*++
+
+Routine Description:
+
+    Allocates the hardware context the module asked for and initializes the
+    controller.
+
+Arguments:
+
+    KdNet - Supplies the shared data to hand to the module.  The caller
+        initializes any fields it wants the module to see, such as
+        SerialBaudRate.
+
+    Device - Supplies the debug device descriptor passed to
+        HostKdNetInitialize.
+
+Return Value:
+
+    The status returned by KdInitializeController.
+
+--*/
+
+{
+    ULONG Length;
+
+    Length = (ULONG)ALIGN_UP_BY(Device->Memory.Length, PAGE_SIZE);
+    KdNet->Hardware = aligned_alloc(PAGE_SIZE, Length);
+    if (KdNet->Hardware == NULL) {
+        return STATUS_NO_MEMORY;
+    }
+
+    RtlZeroMemory(KdNet->Hardware, Length);
+    Device->Memory.VirtualAddress = KdNet->Hardware;
+    Device->Memory.Start.QuadPart = (LONG64)(ULONG_PTR)KdNet->Hardware;
+    KdNet->Device = Device;
+    KdNet->TargetMacAddress = HostTargetMacAddress;
+    KdNet->LinkState = &HostLinkState;
+    return HostKdNetExports.KdInitializeController(KdNet);
+}
+
+VOID
+HostKdNetStop (
+    __inout PKDNET_SHARED_DATA KdNet
+    )
+{
+    if (KdNet->Hardware != NULL) {
+        HostKdNetExports.KdShutdownController(KdNet->Hardware);
+        free(KdNet->Hardware);
+        KdNet->Hardware = NULL;
+    }
+}
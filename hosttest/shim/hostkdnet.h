@@ -0,0 +1,40 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hostkdnet.h
+
+Abstract:
+
+    Host stand in for KDNET, the loader of the extensibility modules.  It
+    supplies the import table a module expects, backed by the host build
+    shim, and loads the module the way KDNET does.
+
+--*/
+
+#pragma once
+
+#include "kdnetshareddata.h"
+#include "kdnetextensibility.h"
+
+extern KDNET_EXTENSIBILITY_EXPORTS HostKdNetExports;
+
+NTSTATUS
+HostKdNetInitialize (
+    __in_opt PCHAR LoaderOptions,
+    __inout PDEBUG_DEVICE_DESCRIPTOR Device,
+    __in ULONG ExportCount
+    );
+
+NTSTATUS
+HostKdNetStart (
+    __inout PKDNET_SHARED_DATA KdNet,
+    __in PDEBUG_DEVICE_DESCRIPTOR Device
+    );
+
+VOID
+HostKdNetStop (
+    __inout PKDNET_SHARED_DATA KdNet
+    );
@@ -0,0 +1,530 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hostkernel.c
+
+Abstract:
+
+    Host implementations of the executive, I/O manager, kernel, memory
+    manager and run time library routines declared by the host ntddk.h for
+    the KMDF serial driver.
+
+    The machine is a quiet one with HOST_PROCESSOR_COUNT processors in a
+    single group.  Pool comes from the C heap, filled with a pattern so that
+    code reading memory it never wrote does not see zeros by luck.  Delays
+    run the framework emulation for the requested time (see hostwdf.c), so
+    that a driver waiting for its own DPCs sees them run.
+
+--*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "ntddk.h"
+#include "wdf.h"
+#include "hostwdf.h"
+
+#define HOST_PROCESSOR_COUNT 4
+#define HOST_POOL_PATTERN 0xCD
+
+//
+// The system time starts on 1 January 2026, in 100ns units since 1601.
+//
+
+#define HOST_SYSTEM_TIME_BASE 134116992000000000LL
+
+ULONG HostPoolAllocations;
+ULONG HostErrorLogEntries;
+NTSTATUS HostLastErrorLogCode;
+
+static CONFIGURATION_INFORMATION HostConfigurationInformation;
+static KIRQL HostIrql = PASSIVE_LEVEL;
+static PUCHAR HostKdComPortInUse;
+
+PUCHAR *KdComPortInUse = &HostKdComPortInUse;
+POBJECT_TYPE *ExEventObjectType;
+
+PVOID
+ExAllocatePoolWithTag (
+    POOL_TYPE PoolType,
+    SIZE_T NumberOfBytes,
+    ULONG Tag
+    )
+{
+    PVOID Buffer;
+
+    UNREFERENCED_PARAMETER(PoolType);
+    UNREFERENCED_PARAMETER(Tag);
+
+    Buffer = malloc(NumberOfBytes);
+    if (Buffer != NULL) {
+        memset(Buffer, HOST_POOL_PATTERN, NumberOfBytes);
+        HostPoolAllocations += 1;
+    }
+
+    return Buffer;
+}
+
+PVOID
+ExAllocatePoolWithQuotaTag (
+    POOL_TYPE PoolType,
+    SIZE_T NumberOfBytes,
+    ULONG Tag
+    )
+{
+    return ExAllocatePoolWithTag(PoolType, NumberOfBytes, Tag);
+}
+
+VOID
+ExFreePool (
+    PVOID P
+    )
+{
+    HostAssert(P != NULL, "ExFreePool(NULL)", __FILE__, __LINE__);
+    HostPoolAllocations -= 1;
+    free(P);
+}
+
+PIO_STACK_LOCATION
+IoGetCurrentIrpStackLocation (
+    PIRP Irp
+    )
+{
+    return &Irp->Stack;
+}
+
+VOID
+IoCompleteRequest (
+    PIRP Irp,
+    CHAR PriorityBoost
+    )
+{
+    UNREFERENCED_PARAMETER(PriorityBoost);
+
+    HostAssert(Irp->Completed == FALSE, "IRP completed twice", __FILE__,
+               __LINE__);
+
+    Irp->Completed = TRUE;
+}
+
+PVOID
+IoAllocateErrorLogEntry (
+    PVOID IoObject,
+    UCHAR EntrySize
+    )
+{
+    UNREFERENCED_PARAMETER(IoObject);
+
+    return calloc(1, EntrySize);
+}
+
+VOID
+IoWriteErrorLogEntry (
+    PVOID ElEntry
+    )
+{
+    HostErrorLogEntries += 1;
+    HostLastErrorLogCode = ((PIO_ERROR_LOG_PACKET)ElEntry)->ErrorCode;
+    free(ElEntry);
+}
+
+PCONFIGURATION_INFORMATION
+IoGetConfigurationInformation (
+    VOID
+    )
+{
+    return &HostConfigurationInformation;
+}
+
+NTSTATUS
+KeDelayExecutionThread (
+    KPROCESSOR_MODE WaitMode,
+    BOOLEAN Alertable,
+    PLARGE_INTEGER Interval
+    )
+
+/*++
+
+Routine Description:
+
+    Lets the rest of the machine run for the interval.  Only relative
+    intervals are used by the driver.
+
+--*/
+
+{
+    UNREFERENCED_PARAMETER(WaitMode);
+    UNREFERENCED_PARAMETER(Alertable);
+
+    HostAssert(Interval->QuadPart <= 0, "absolute delay", __FILE__,
+               __LINE__);
+
+    HostWdfRun((ULONG64)(-Interval->QuadPart) * 100);
+    return STATUS_SUCCESS;
+}
+
+VOID
+KeQuerySystemTime (
+    PLARGE_INTEGER CurrentTime
+    )
+{
+    CurrentTime->QuadPart = HOST_SYSTEM_TIME_BASE +
+                            (LONG64)(HostGetTime() / 100);
+}
+
+ULONGLONG
+KeQueryInterruptTime (
+    VOID
+    )
+{
+    return HostGetTime() / 100;
+}
+
+VOID
+KeRaiseIrql (
+    KIRQL NewIrql,
+    PKIRQL OldIrql
+    )
+{
+    HostAssert(NewIrql >= HostIrql, "KeRaiseIrql lowers", __FILE__,
+               __LINE__);
+
+    *OldIrql = HostIrql;
+    HostIrql = NewIrql;
+}
+
+VOID
+KeLowerIrql (
+    KIRQL NewIrql
+    )
+{
+    HostAssert(NewIrql <= HostIrql, "KeLowerIrql raises", __FILE__,
+               __LINE__);
+
+    HostIrql = NewIrql;
+}
+
+LONG
+KeSetEvent (
+    PRKEVENT Event,
+    KPRIORITY Increment,
+    BOOLEAN Wait
+    )
+{
+    LONG Previous;
+
+    UNREFERENCED_PARAMETER(Increment);
+    UNREFERENCED_PARAMETER(Wait);
+
+    Previous = Event->SignalState;
+    Event->SignalState = 1;
+    return Previous;
+}
+
+ULONG
+KeQueryActiveProcessorCountEx (
+    USHORT GroupNumber
+    )
+{
+    UNREFERENCED_PARAMETER(GroupNumber);
+
+    return HOST_PROCESSOR_COUNT;
+}
+
+NTSTATUS
+KeGetProcessorNumberFromIndex (
+    ULONG ProcIndex,
+    PPROCESSOR_NUMBER ProcNumber
+    )
+{
+    if (ProcIndex >= HOST_PROCESSOR_COUNT) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    RtlZeroMemory(ProcNumber, sizeof(*ProcNumber));
+    ProcNumber->Number = (UCHAR)ProcIndex;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+KeSetTargetProcessorDpcEx (
+    PKDPC Dpc,
+    PPROCESSOR_NUMBER ProcNumber
+    )
+{
+    Dpc->TargetProcessor = *ProcNumber;
+    Dpc->Targeted = TRUE;
+    return STATUS_SUCCESS;
+}
+
+//
+// None of the optional routines the driver looks up are present, so it
+// takes its down level paths.
+//
+
+PVOID
+MmGetSystemRoutineAddress (
+    PUNICODE_STRING SystemRoutineName
+    )
+{
+    UNREFERENCED_PARAMETER(SystemRoutineName);
+
+    return NULL;
+}
+
+//
+// Register space is identity mapped: the models decode the physical
+// address the driver was given.
+//
+
+PVOID
+MmMapIoSpace (
+    PHYSICAL_ADDRESS PhysicalAddress,
+    SIZE_T NumberOfBytes,
+    MEMORY_CACHING_TYPE CacheType
+    )
+{
+    UNREFERENCED_PARAMETER(NumberOfBytes);
+    UNREFERENCED_PARAMETER(CacheType);
+
+    return (PVOID)(ULONG_PTR)PhysicalAddress.QuadPart;
+}
+
+VOID
+MmUnmapIoSpace (
+    PVOID BaseAddress,
+    SIZE_T NumberOfBytes
+    )
+{
+    UNREFERENCED_PARAMETER(BaseAddress);
+    UNREFERENCED_PARAMETER(NumberOfBytes);
+}
+
+PHYSICAL_ADDRESS
+MmGetPhysicalAddress (
+    PVOID BaseAddress
+    )
+{
+    PHYSICAL_ADDRESS Address;
+
+    Address.QuadPart = (LONG64)(ULONG_PTR)BaseAddress;
+    return Address;
+}
+
+MM_SYSTEMSIZE
+MmQuerySystemSize (
+    VOID
+    )
+{
+    return MmLargeSystem;
+}
+
+//
+// No handles are valid; the only object the driver references by handle
+// is the receive ring event, which the host tests do not map.
+//
+
+NTSTATUS
+ObReferenceObjectByHandle (
+    HANDLE Handle,
+    ACCESS_MASK DesiredAccess,
+    POBJECT_TYPE ObjectType,
+    KPROCESSOR_MODE AccessMode,
+    PVOID *Object,
+    PVOID HandleInformation
+    )
+{
+    UNREFERENCED_PARAMETER(Handle);
+    UNREFERENCED_PARAMETER(DesiredAccess);
+    UNREFERENCED_PARAMETER(ObjectType);
+    UNREFERENCED_PARAMETER(AccessMode);
+    UNREFERENCED_PARAMETER(HandleInformation);
+
+    *Object = NULL;
+    return STATUS_INVALID_HANDLE;
+}
+
+VOID
+ObDereferenceObject (
+    PVOID Object
+    )
+{
+    HostAssert(Object != NULL, "ObDereferenceObject(NULL)", __FILE__,
+               __LINE__);
+}
+
+VOID
+RtlInitUnicodeString (
+    PUNICODE_STRING DestinationString,
+    PCWSTR SourceString
+    )
+{
+    SIZE_T Length;
+
+    Length = 0;
+    if (SourceString != NULL) {
+        while (SourceString[Length] != UNICODE_NULL) {
+            Length += 1;
+        }
+    }
+
+    DestinationString->Buffer = (PWSTR)SourceString;
+    DestinationString->Length = (USHORT)(Length * sizeof(WCHAR));
+    DestinationString->MaximumLength =
+        (SourceString == NULL) ? 0 : (USHORT)((Length + 1) * sizeof(WCHAR));
+}
+
+BOOLEAN
+RtlIsNtDdiVersionAvailable (
+    ULONG Version
+    )
+{
+    UNREFERENCED_PARAMETER(Version);
+
+    return TRUE;
+}
+
+//
+// The device map is write only as far as the driver is concerned.
+//
+
+NTSTATUS
+RtlWriteRegistryValue (
+    ULONG RelativeTo,
+    PCWSTR Path,
+    PCWSTR ValueName,
+    ULONG ValueType,
+    PVOID ValueData,
+    ULONG ValueLength
+    )
+{
+    UNREFERENCED_PARAMETER(RelativeTo);
+    UNREFERENCED_PARAMETER(Path);
+    UNREFERENCED_PARAMETER(ValueName);
+    UNREFERENCED_PARAMETER(ValueType);
+    UNREFERENCED_PARAMETER(ValueData);
+    UNREFERENCED_PARAMETER(ValueLength);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+RtlDeleteRegistryValue (
+    ULONG RelativeTo,
+    PCWSTR Path,
+    PCWSTR ValueName
+    )
+{
+    UNREFERENCED_PARAMETER(RelativeTo);
+    UNREFERENCED_PARAMETER(Path);
+    UNREFERENCED_PARAMETER(ValueName);
+
+    return STATUS_SUCCESS;
+}
+
+//
+// RtlUnicodeStringPrintf supports the conversions the driver uses: %ws and
+// %s (both wide here), %u, %d and %x.
+//
+
+static
+BOOLEAN
+HostAppendWide (
+    PUNICODE_STRING Destination,
+    WCHAR Character
+    )
+{
+    if ((ULONG)Destination->Length + sizeof(WCHAR) >
+        Destination->MaximumLength) {
+
+        return FALSE;
+    }
+
+    Destination->Buffer[Destination->Length / sizeof(WCHAR)] = Character;
+    Destination->Length += sizeof(WCHAR);
+    return TRUE;
+}
+
+NTSTATUS
+RtlUnicodeStringPrintf (
+    PUNICODE_STRING DestinationString,
+    PCWSTR Format,
+    ...
+    )
+{
+    va_list Arguments;
+    CHAR Digits[24];
+    ULONG Index;
+    PCWSTR String;
+    NTSTATUS Status;
+
+    Status = STATUS_SUCCESS;
+    DestinationString->Length = 0;
+    va_start(Arguments, Format);
+    while (*Format != UNICODE_NULL) {
+        if (*Format != L'%') {
+            if (HostAppendWide(DestinationString, *Format) == FALSE) {
+                Status = STATUS_BUFFER_OVERFLOW;
+                break;
+            }
+
+            Format += 1;
+            continue;
+        }
+
+        Format += 1;
+        Digits[0] = '\0';
+        String = NULL;
+        if ((Format[0] == L'w') && (Format[1] == L's')) {
+            String = va_arg(Arguments, PCWSTR);
+            Format += 2;
+
+        } else if (*Format == L's') {
+            String = va_arg(Arguments, PCWSTR);
+            Format += 1;
+
+        } else if (*Format == L'u') {
+            snprintf(Digits, sizeof(Digits), "%u", va_arg(Arguments, ULONG));
+            Format += 1;
+
+        } else if (*Format == L'd') {
+            snprintf(Digits, sizeof(Digits), "%d", va_arg(Arguments, LONG));
+            Format += 1;
+
+        } else if (*Format == L'x') {
+            snprintf(Digits, sizeof(Digits), "%x", va_arg(Arguments, ULONG));
+            Format += 1;
+
+        } else {
+            Status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (String != NULL) {
+            for (Index = 0; String[Index] != UNICODE_NULL; Index += 1) {
+                if (HostAppendWide(DestinationString, String[Index]) == FALSE) {
+                    Status = STATUS_BUFFER_OVERFLOW;
+                    break;
+                }
+            }
+
+        } else {
+            for (Index = 0; Digits[Index] != '\0'; Index += 1) {
+                if (HostAppendWide(DestinationString, Digits[Index]) == FALSE) {
+                    Status = STATUS_BUFFER_OVERFLOW;
+                    break;
+                }
+            }
+        }
+
+        if (!NT_SUCCESS(Status)) {
+            break;
+        }
+    }
+
+    va_end(Arguments);
+    return Status;
+}
@@ -0,0 +1,285 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hostshim.c
+
+Abstract:
+
+    Host implementations of the HAL and kernel routines declared by the host
+    build shim.  See hostshim.h.
+
+--*/
+
+#include <stdio.h>
+#include <time.h>
+#include <ntddk.h>
+
+HOST_IO_COUNTERS HostIoCounters;
+ULONG HostAssertFailures;
+
+static PHOST_IO_MODEL HostIoModel;
+static ULONG64 HostTime;
+
+VOID
+HostSetIoModel (
+    __in_opt PHOST_IO_MODEL Model
+    )
+{
+    HostIoModel = Model;
+}
+
+ULONG64
+HostGetTime (
+    VOID
+    )
+{
+    return HostTime;
+}
+
+VOID
+HostAdvanceTime (
+    __in ULONG64 Nanoseconds
+    )
+{
+    HostTime += Nanoseconds;
+}
+
+VOID
+HostResetCounters (
+    VOID
+    )
+{
+    RtlZeroMemory(&HostIoCounters, sizeof(HostIoCounters));
+}
+
+ULONG64
+HostCycles (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Returns the host processor cycle counter, for benchmarks that measure the
+    real cost of the code under test rather than virtual device time.
+
+--*/
+
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return ((ULONG64)Now.tv_sec * 1000000000ULL) + (ULONG64)Now.tv_nsec;
+#endif
+}
+
+VOID
+HostAssert (
+    int Condition,
+    const char *Expression,
+    const char *File,
+    int Line
+    )
+{
+    if (Condition == 0) {
+        HostAssertFailures += 1;
+        fprintf(stderr, "%s(%d): assertion failed: %s\n", File, Line,
+                Expression);
+    }
+}
+
+SIZE_T
+HostCompareMemory (
+    const void *Source1,
+    const void *Source2,
+    SIZE_T Length
+    )
+{
+    const UCHAR *Left;
+    SIZE_T Index;
+    const UCHAR *Right;
+
+    Left = Source1;
+    Right = Source2;
+    for (Index = 0; Index < Length; Index += 1) {
+        if (Left[Index] != Right[Index]) {
+            break;
+        }
+    }
+
+    return Index;
+}
+
+VOID
+KeStallExecutionProcessor (
+    ULONG MicroSeconds
+    )
+{
+    HostIoCounters.Stalls += 1;
+    HostIoCounters.StalledMicroseconds += MicroSeconds;
+    HostTime += (ULONG64)MicroSeconds * 1000;
+}
+
+LARGE_INTEGER
+KeQueryPerformanceCounter (
+    PLARGE_INTEGER PerformanceFrequency
+    )
+{
+    LARGE_INTEGER Counter;
+
+    HostIoCounters.ClockQueries += 1;
+    if (PerformanceFrequency != NULL) {
+        PerformanceFrequency->QuadPart = HOST_PERFORMANCE_FREQUENCY;
+    }
+
+    Counter.QuadPart = HostTime / (1000000000ULL / HOST_PERFORMANCE_FREQUENCY);
+    return Counter;
+}
+
+ULONG64
+ReadTimeStampCounter (
+    VOID
+    )
+{
+    HostIoCounters.ClockQueries += 1;
+    return (HostTime * HOST_CYCLES_PER_MICROSECOND) / 1000;
+}
+
+static
+ULONG
+HostRead (
+    ULONG_PTR Address,
+    ULONG Width
+    )
+{
+    ULONG64 Start;
+    ULONG Value;
+
+    HostIoCounters.Reads += 1;
+    if (HostIoModel == NULL) {
+        return (Width >= 4) ? MAXULONG : ((1UL << (Width * 8)) - 1);
+    }
+
+    Start = HostCycles();
+    Value = HostIoModel->Read(HostIoModel, Address, Width);
+    HostIoCounters.ModelCycles += HostCycles() - Start;
+    return Value;
+}
+
+static
+VOID
+HostWrite (
+    ULONG_PTR Address,
+    ULONG Width,
+    ULONG Value
+    )
+{
+    ULONG64 Start;
+
+    HostIoCounters.Writes += 1;
+    if (HostIoModel != NULL) {
+        Start = HostCycles();
+        HostIoModel->Write(HostIoModel, Address, Width, Value);
+        HostIoCounters.ModelCycles += HostCycles() - Start;
+    }
+}
+
+UCHAR READ_PORT_UCHAR (PUCHAR Port)
+{
+    return (UCHAR)HostRead((ULONG_PTR)Port, 1);
+}
+
+USHORT READ_PORT_USHORT (PUSHORT Port)
+{
+    return (USHORT)HostRead((ULONG_PTR)Port, 2);
+}
+
+ULONG READ_PORT_ULONG (PULONG Port)
+{
+    return HostRead((ULONG_PTR)Port, 4);
+}
+
+VOID WRITE_PORT_UCHAR (PUCHAR Port, UCHAR Value)
+{
+    HostWrite((ULONG_PTR)Port, 1, Value);
+}
+
+VOID WRITE_PORT_USHORT (PUSHORT Port, USHORT Value)
+{
+    HostWrite((ULONG_PTR)Port, 2, Value);
+}
+
+VOID WRITE_PORT_ULONG (PULONG Port, ULONG Value)
+{
+    HostWrite((ULONG_PTR)Port, 4, Value);
+}
+
+VOID READ_PORT_BUFFER_UCHAR (PUCHAR Port, PUCHAR Buffer, ULONG Count)
+{
+    while (Count != 0) {
+        *Buffer = (UCHAR)HostRead((ULONG_PTR)Port, 1);
+        Buffer += 1;
+        Count -= 1;
+    }
+}
+
+VOID WRITE_PORT_BUFFER_UCHAR (PUCHAR Port, PUCHAR Buffer, ULONG Count)
+{
+    while (Count != 0) {
+        HostWrite((ULONG_PTR)Port, 1, *Buffer);
+        Buffer += 1;
+        Count -= 1;
+    }
+}
+
+UCHAR READ_REGISTER_UCHAR (volatile UCHAR *Register)
+{
+    return (UCHAR)HostRead((ULONG_PTR)Register, 1);
+}
+
+USHORT READ_REGISTER_USHORT (volatile USHORT *Register)
+{
+    return (USHORT)HostRead((ULONG_PTR)Register, 2);
+}
+
+ULONG READ_REGISTER_ULONG (volatile ULONG *Register)
+{
+    return HostRead((ULONG_PTR)Register, 4);
+}
+
+VOID WRITE_REGISTER_UCHAR (volatile UCHAR *Register, UCHAR Value)
+{
+    HostWrite((ULONG_PTR)Register, 1, Value);
+}
+
+VOID WRITE_REGISTER_USHORT (volatile USHORT *Register, USHORT Value)
+{
+    HostWrite((ULONG_PTR)Register, 2, Value);
+}
+
+VOID WRITE_REGISTER_ULONG (volatile ULONG *Register, ULONG Value)
+{
+    HostWrite((ULONG_PTR)Register, 4, Value);
+}
+
+//
+// Models are at most 32 bits wide, so the upper half of a 64 bit register
+// reads as zero and is dropped on writes.
+//
+
+ULONG64 READ_REGISTER_ULONG64 (volatile ULONG64 *Register)
+{
+    return HostRead((ULONG_PTR)Register, 8);
+}
+
+VOID WRITE_REGISTER_ULONG64 (volatile ULONG64 *Register, ULONG64 Value)
+{
+    HostWrite((ULONG_PTR)Register, 8, (ULONG)Value);
+}
@@ -0,0 +1,97 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hostshim.h
+
+Abstract:
+
+    Device model and clock hooks behind the host build shim.
+
+    Every port and register access made by the code under test is handed to
+    the installed HOST_IO_MODEL, which sees the access width and the address
+    the driver used.  Without a model, reads return all ones and writes are
+    dropped, which is what an empty bus looks like.
+
+    The shim keeps a virtual clock in nanoseconds.  KeStallExecutionProcessor
+    advances it, and models may advance it too (for example, by the time a
+    character takes on the wire).  KeQueryPerformanceCounter and
+    ReadTimeStampCounter read it, so timing dependent code behaves the same
+    on every run.
+
+--*/
+
+#pragma once
+
+typedef struct _HOST_IO_MODEL HOST_IO_MODEL, *PHOST_IO_MODEL;
+
+typedef
+ULONG
+(*HOST_IO_READ) (
+    __in PHOST_IO_MODEL Model,
+    __in ULONG_PTR Address,
+    __in ULONG Width
+    );
+
+typedef
+VOID
+(*HOST_IO_WRITE) (
+    __in PHOST_IO_MODEL Model,
+    __in ULONG_PTR Address,
+    __in ULONG Width,
+    __in ULONG Value
+    );
+
+struct _HOST_IO_MODEL {
+    HOST_IO_READ Read;
+    HOST_IO_WRITE Write;
+    PVOID Context;
+};
+
+//
+// Counters kept by the shim for benchmarks.  ModelCycles is the real time
+// stamp counter time spent inside the installed model, which benchmarks
+// subtract to get the cost of the code under test alone.
+//
+
+typedef struct _HOST_IO_COUNTERS {
+    ULONG64 Reads;
+    ULONG64 Writes;
+    ULONG64 Stalls;
+    ULONG64 StalledMicroseconds;
+    ULONG64 ClockQueries;
+    ULONG64 ModelCycles;
+} HOST_IO_COUNTERS, *PHOST_IO_COUNTERS;
+
+#define HOST_PERFORMANCE_FREQUENCY 10000000ULL
+#define HOST_CYCLES_PER_MICROSECOND 1000ULL
+
+extern HOST_IO_COUNTERS HostIoCounters;
+extern ULONG HostAssertFailures;
+
+VOID
+HostSetIoModel (
+    __in_opt PHOST_IO_MODEL Model
+    );
+
+ULONG64
+HostGetTime (
+    VOID
+    );
+
+VOID
+HostAdvanceTime (
+    __in ULONG64 Nanoseconds
+    );
+
+VOID
+HostResetCounters (
+    VOID
+    );
+
+ULONG64
+HostCycles (
+    VOID
+    );
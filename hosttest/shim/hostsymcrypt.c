@@ -0,0 +1,257 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hostsymcrypt.c
+
+Abstract:
+
+    Host implementation of the SymCrypt routines declared by the host build
+    shim.  See symcrypt.h.  Speed is not a concern; the hash runs over a
+    message held in memory in one call.
+
+--*/
+
+#include <ntddk.h>
+#include <symcrypt.h>
+
+#define ROTR32(Value, Count) (((Value) >> (Count)) | ((Value) << (32 - (Count))))
+
+static const ULONG Sha256K[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+    0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+    0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+    0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+    0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+    0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+    0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+    0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+    0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+typedef struct _HOST_SHA256_STATE {
+    ULONG Hash[8];
+    BYTE Block[SYMCRYPT_SHA256_INPUT_BLOCK_SIZE];
+    ULONG BlockLength;
+    ULONG64 MessageLength;
+} HOST_SHA256_STATE, *PHOST_SHA256_STATE;
+
+static
+VOID
+HostSha256Block (
+    __inout PHOST_SHA256_STATE State
+    )
+{
+    ULONG A[8];
+    ULONG Index;
+    ULONG S0;
+    ULONG S1;
+    ULONG T1;
+    ULONG T2;
+    ULONG W[64];
+
+    for (Index = 0; Index < 16; Index += 1) {
+        W[Index] = ((ULONG)State->Block[Index * 4] << 24) |
+                   ((ULONG)State->Block[(Index * 4) + 1] << 16) |
+                   ((ULONG)State->Block[(Index * 4) + 2] << 8) |
+                   (ULONG)State->Block[(Index * 4) + 3];
+    }
+
+    for (Index = 16; Index < 64; Index += 1) {
+        S0 = ROTR32(W[Index - 15], 7) ^ ROTR32(W[Index - 15], 18) ^
+             (W[Index - 15] >> 3);
+
+        S1 = ROTR32(W[Index - 2], 17) ^ ROTR32(W[Index - 2], 19) ^
+             (W[Index - 2] >> 10);
+
+        W[Index] = W[Index - 16] + S0 + W[Index - 7] + S1;
+    }
+
+    RtlCopyMemory(A, State->Hash, sizeof(A));
+    for (Index = 0; Index < 64; Index += 1) {
+        S1 = ROTR32(A[4], 6) ^ ROTR32(A[4], 11) ^ ROTR32(A[4], 25);
+        T1 = A[7] + S1 + ((A[4] & A[5]) ^ (~A[4] & A[6])) +
+             Sha256K[Index] + W[Index];
+
+        S0 = ROTR32(A[0], 2) ^ ROTR32(A[0], 13) ^ ROTR32(A[0], 22);
+        T2 = S0 + ((A[0] & A[1]) ^ (A[0] & A[2]) ^ (A[1] & A[2]));
+        A[7] = A[6];
+        A[6] = A[5];
+        A[5] = A[4];
+        A[4] = A[3] + T1;
+        A[3] = A[2];
+        A[2] = A[1];
+        A[1] = A[0];
+        A[0] = T1 + T2;
+    }
+
+    for (Index = 0; Index < 8; Index += 1) {
+        State->Hash[Index] += A[Index];
+    }
+}
+
+static
+VOID
+HostSha256Init (
+    __out PHOST_SHA256_STATE State
+    )
+{
+    static const ULONG InitialHash[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+        0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+    };
+
+    RtlZeroMemory(State, sizeof(*State));
+    RtlCopyMemory(State->Hash, InitialHash, sizeof(InitialHash));
+}
+
+static
+VOID
+HostSha256Append (
+    __inout PHOST_SHA256_STATE State,
+    __in_bcount(cbData) PCBYTE pbData,
+    __in SIZE_T cbData
+    )
+{
+    State->MessageLength += cbData;
+    while (cbData > 0) {
+        State->Block[State->BlockLength] = *pbData;
+        State->BlockLength += 1;
+        pbData += 1;
+        cbData -= 1;
+        if (State->BlockLength == SYMCRYPT_SHA256_INPUT_BLOCK_SIZE) {
+            HostSha256Block(State);
+            State->BlockLength = 0;
+        }
+    }
+}
+
+static
+VOID
+HostSha256Result (
+    __inout PHOST_SHA256_STATE State,
+    __out_bcount(SYMCRYPT_SHA256_RESULT_SIZE) PBYTE pbResult
+    )
+{
+    ULONG64 BitLength;
+    ULONG Index;
+
+    BitLength = State->MessageLength * 8;
+    State->Block[State->BlockLength] = 0x80;
+    State->BlockLength += 1;
+    if (State->BlockLength > SYMCRYPT_SHA256_INPUT_BLOCK_SIZE - 8) {
+        RtlZeroMemory(&State->Block[State->BlockLength],
+                      SYMCRYPT_SHA256_INPUT_BLOCK_SIZE - State->BlockLength);
+
+        HostSha256Block(State);
+        State->BlockLength = 0;
+    }
+
+    RtlZeroMemory(&State->Block[State->BlockLength],
+                  SYMCRYPT_SHA256_INPUT_BLOCK_SIZE - State->BlockLength);
+
+    for (Index = 0; Index < 8; Index += 1) {
+        State->Block[SYMCRYPT_SHA256_INPUT_BLOCK_SIZE - 1 - Index] =
+            (BYTE)(BitLength >> (Index * 8));
+    }
+
+    HostSha256Block(State);
+    for (Index = 0; Index < 8; Index += 1) {
+        pbResult[Index * 4] = (BYTE)(State->Hash[Index] >> 24);
+        pbResult[(Index * 4) + 1] = (BYTE)(State->Hash[Index] >> 16);
+        pbResult[(Index * 4) + 2] = (BYTE)(State->Hash[Index] >> 8);
+        pbResult[(Index * 4) + 3] = (BYTE)State->Hash[Index];
+    }
+}
+
+VOID
+SymCryptSha256 (
+    __in_bcount(cbData) PCBYTE pbData,
+    __in SIZE_T cbData,
+    __out_bcount(SYMCRYPT_SHA256_RESULT_SIZE) PBYTE pbResult
+    )
+{
+    HOST_SHA256_STATE State;
+
+    HostSha256Init(&State);
+    HostSha256Append(&State, pbData, cbData);
+    HostSha256Result(&State, pbResult);
+}
+
+SYMCRYPT_ERROR
+SymCryptHmacSha256ExpandKey (
+    __out PSYMCRYPT_HMAC_SHA256_EXPANDED_KEY pExpandedKey,
+    __in_bcount(cbKey) PCBYTE pbKey,
+    __in SIZE_T cbKey
+    )
+{
+    BYTE Key[SYMCRYPT_SHA256_INPUT_BLOCK_SIZE];
+    ULONG Index;
+
+    RtlZeroMemory(Key, sizeof(Key));
+    if (cbKey > sizeof(Key)) {
+        SymCryptSha256(pbKey, cbKey, Key);
+
+    } else {
+        RtlCopyMemory(Key, pbKey, cbKey);
+    }
+
+    for (Index = 0; Index < sizeof(Key); Index += 1) {
+        pExpandedKey->InnerBlock[Index] = Key[Index] ^ 0x36;
+        pExpandedKey->OuterBlock[Index] = Key[Index] ^ 0x5C;
+    }
+
+    return SYMCRYPT_NO_ERROR;
+}
+
+VOID
+SymCryptHmacSha256 (
+    __in PCSYMCRYPT_HMAC_SHA256_EXPANDED_KEY pExpandedKey,
+    __in_bcount(cbData) PCBYTE pbData,
+    __in SIZE_T cbData,
+    __out_bcount(SYMCRYPT_HMAC_SHA256_RESULT_SIZE) PBYTE pbResult
+    )
+{
+    BYTE Inner[SYMCRYPT_SHA256_RESULT_SIZE];
+    HOST_SHA256_STATE State;
+
+    HostSha256Init(&State);
+    HostSha256Append(&State,
+                     pExpandedKey->InnerBlock,
+                     sizeof(pExpandedKey->InnerBlock));
+
+    HostSha256Append(&State, pbData, cbData);
+    HostSha256Result(&State, Inner);
+    HostSha256Init(&State);
+    HostSha256Append(&State,
+                     pExpandedKey->OuterBlock,
+                     sizeof(pExpandedKey->OuterBlock));
+
+    HostSha256Append(&State, Inner, sizeof(Inner));
+    HostSha256Result(&State, pbResult);
+}
+
+VOID
+SymCryptWipe (
+    __out_bcount(cbData) PVOID pbData,
+    __in SIZE_T cbData
+    )
+{
+    volatile BYTE *Bytes;
+
+    Bytes = (volatile BYTE *)pbData;
+    while (cbData > 0) {
+        *Bytes = 0;
+        Bytes += 1;
+        cbData -= 1;
+    }
+}
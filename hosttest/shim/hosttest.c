@@ -0,0 +1,44 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hosttest.c
+
+Abstract:
+
+    Result reporting for the host tests.  See hosttest.h.
+
+--*/
+
+#include "hosttest.h"
+
+ULONG HostTestFailures;
+
+int
+HostTestExit (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Reports the result of a host test run.
+
+Return Value:
+
+    0 if no check or shim assertion failed, 1 otherwise.
+
+--*/
+
+{
+    ULONG Failures;
+
+    Failures = HostTestFailures + HostAssertFailures;
+    printf("%s: %u failure(s)\n", (Failures == 0) ? "PASS" : "FAIL",
+           Failures);
+
+    return (Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hosttest.h
+
+Abstract:
+
+    Check macro and result reporting shared by the host tests and
+    benchmarks.
+
+    CHECK prints the failing routine and message and counts the failure
+    without stopping the test.  main returns HostTestExit(), which adds the
+    shim's own assertion failures, prints PASS or FAIL and returns the exit
+    code CTest expects.
+
+--*/
+
+#pragma once
+
+#include <stdio.h>
+#include <ntddk.h>
+
+extern ULONG HostTestFailures;
+
+#define CHECK(Condition, ...)                       \
+    do {                                            \
+        if (!(Condition)) {                         \
+            printf("FAIL %s: ", __FUNCTION__);      \
+            printf(__VA_ARGS__);                    \
+            printf("\n");                           \
+            HostTestFailures += 1;                  \
+        }                                           \
+    } while (0)
+
+int
+HostTestExit (
+    VOID
+    );
@@ -0,0 +1,3011 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hostwdf.c
+
+Abstract:
+
+    Host emulation of the Kernel-Mode Driver Framework subset declared by the
+    host wdf.h, for running the KMDF serial driver as a Linux process.
+
+    Every framework object is a HOST_WDF_OBJECT on a single list, with a
+    parent, up to two typed contexts and type specific state.  Deleting an
+    object deletes its children first, then runs its cleanup callbacks.
+
+    The machine has one processor and no threads.  Driver callbacks are
+    invoked from HostWdfSend, HostWdfCancel and HostWdfPump; the pump runs
+    the ISR while the interrupt line is asserted, then queued DPCs in order,
+    then expired timers.  A callback that is serialized with the device
+    (queue callbacks, cancel routines, and DPCs and timers with automatic
+    serialization under a device with device synchronization scope) holds
+    the device lock while it runs; a serialized DPC or timer that comes due
+    while the driver holds the lock waits for the next pump after it is
+    released, as it would spin on another processor.  Requests forwarded to
+    a manual queue stay queued until the driver retrieves them, and are
+    cancelled through EvtIoCanceledOnQueue when the sender cancels them or
+    the queue is purged.
+
+    There are no power transitions while requests are outstanding, so
+    EvtIoStop and EvtIoResume are never delivered, and WDM preprocess
+    callbacks are accepted but never called.
+
+--*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "ntddk.h"
+#include "wdf.h"
+#include "hostwdf.h"
+
+#define HOST_WDF_CONTEXTS 2
+#define HOST_WDF_NAME_LENGTH 64
+#define HOST_WDF_REGISTRY_VALUES 32
+#define HOST_WDF_INTERRUPT_STORM 1000
+
+//
+// StopSynchronously lets virtual time run for at most this long waiting for
+// the driver to complete the requests it owns.
+//
+
+#define HOST_WDF_STOP_TIMEOUT (10ULL * 1000 * 1000 * 1000)
+
+typedef enum _HOST_WDF_TYPE {
+    HostWdfTypeDriver = 1,
+    HostWdfTypeDevice,
+    HostWdfTypeQueue,
+    HostWdfTypeRequest,
+    HostWdfTypeInterrupt,
+    HostWdfTypeDpc,
+    HostWdfTypeTimer,
+    HostWdfTypeKey,
+    HostWdfTypeString,
+    HostWdfTypeWaitLock,
+    HostWdfTypeWmiInstance,
+    HostWdfTypeFileObject,
+    HostWdfTypeResourceList,
+} HOST_WDF_TYPE;
+
+typedef struct _HOST_WDF_CONTEXT {
+    PCWDF_OBJECT_CONTEXT_TYPE_INFO TypeInfo;
+    PVOID Data;
+    PFN_WDF_OBJECT_CONTEXT_CLEANUP EvtCleanupCallback;
+    PFN_WDF_OBJECT_CONTEXT_DESTROY EvtDestroyCallback;
+} HOST_WDF_CONTEXT, *PHOST_WDF_CONTEXT;
+
+typedef struct _HOST_WDF_OBJECT HOST_WDF_OBJECT, *PHOST_WDF_OBJECT;
+
+struct _WDFDEVICE_INIT {
+    UNICODE_STRING Name;
+    WCHAR NameBuffer[HOST_WDF_NAME_LENGTH];
+    WDF_PNPPOWER_EVENT_CALLBACKS PnpPower;
+    WDF_FILEOBJECT_CONFIG FileConfig;
+    PFN_WDF_IO_IN_CALLER_CONTEXT EvtIoInCallerContext;
+    WDF_OBJECT_ATTRIBUTES RequestAttributes;
+};
+
+struct _HOST_WDF_OBJECT {
+    HOST_WDF_TYPE Type;
+    LIST_ENTRY ObjectLink;
+    PHOST_WDF_OBJECT Parent;
+    WDF_SYNCHRONIZATION_SCOPE SynchronizationScope;
+    BOOLEAN Deleting;
+    HOST_WDF_CONTEXT Context[HOST_WDF_CONTEXTS];
+    union {
+        struct {
+            PFN_WDF_DRIVER_DEVICE_ADD EvtDriverDeviceAdd;
+            PVOID EvtDriverUnload;
+        } Driver;
+
+        struct {
+            BOOLEAN LockHeld;
+            struct _WDFDEVICE_INIT Init;
+            DEVICE_OBJECT DeviceObject;
+            PHOST_WDF_OBJECT DefaultQueue;
+            PHOST_WDF_OBJECT Interrupt;
+            PHOST_WDF_OBJECT RawResources;
+            PHOST_WDF_OBJECT TranslatedResources;
+        } Device;
+
+        struct {
+            WDF_IO_QUEUE_CONFIG Config;
+            LIST_ENTRY Requests;
+            ULONG Queued;
+            ULONG DriverOwned;
+            BOOLEAN Accepting;
+            BOOLEAN Stopped;
+        } Queue;
+
+        struct {
+            PHOST_WDF_IO Io;
+            WDF_REQUEST_PARAMETERS Parameters;
+            PUCHAR SystemBuffer;
+            PHOST_WDF_OBJECT Device;
+            PHOST_WDF_OBJECT Queue;
+            LIST_ENTRY QueueLink;
+            BOOLEAN OnQueue;
+            BOOLEAN CancelRequested;
+            BOOLEAN CancelRoutineCalled;
+            PFN_WDF_REQUEST_CANCEL CancelRoutine;
+            NTSTATUS Status;
+        } Request;
+
+        struct {
+            WDF_INTERRUPT_CONFIG Config;
+            WDF_INTERRUPT_EXTENDED_POLICY Policy;
+            BOOLEAN Connected;
+            BOOLEAN LockHeld;
+            HOST_INTERRUPT_LINE Line;
+            PVOID LineContext;
+            ULONG Vector;
+            KIRQL Irql;
+            KAFFINITY Affinity;
+        } Interrupt;
+
+        struct {
+            WDF_DPC_CONFIG Config;
+            KDPC Dpc;
+            LIST_ENTRY QueueLink;
+            BOOLEAN Queued;
+            BOOLEAN Running;
+        } Dpc;
+
+        struct {
+            WDF_TIMER_CONFIG Config;
+            ULONG64 Due;
+            BOOLEAN Queued;
+            BOOLEAN Running;
+        } Timer;
+
+        struct {
+            UNICODE_STRING String;
+        } String;
+
+        struct {
+            BOOLEAN Held;
+        } WaitLock;
+
+        struct {
+            WDF_WMI_INSTANCE_CONFIG Config;
+        } WmiInstance;
+
+        struct {
+            PCM_PARTIAL_RESOURCE_DESCRIPTOR Descriptors;
+            ULONG Count;
+        } ResourceList;
+    } u;
+};
+
+typedef struct _HOST_WDF_REGISTRY_VALUE {
+    WCHAR Name[HOST_WDF_NAME_LENGTH];
+    BOOLEAN IsString;
+    ULONG Value;
+    WCHAR String[HOST_WDF_NAME_LENGTH];
+} HOST_WDF_REGISTRY_VALUE, *PHOST_WDF_REGISTRY_VALUE;
+
+HOST_WDF_COUNTERS HostWdfCounters;
+ULONG64 HostWdfStepNanoseconds = 10 * 1000;
+
+static LIST_ENTRY HostWdfObjects = { &HostWdfObjects, &HostWdfObjects };
+static LIST_ENTRY HostWdfDpcQueue = { &HostWdfDpcQueue, &HostWdfDpcQueue };
+static HOST_WDF_REGISTRY_VALUE HostWdfRegistry[HOST_WDF_REGISTRY_VALUES];
+static DRIVER_OBJECT HostWdfDriverObject;
+static DEVICE_OBJECT HostWdfLowerDevice;
+static DEVICE_OBJECT HostWdfPhysicalDevice;
+static PHOST_WDF_OBJECT HostWdfDriver;
+static PHOST_WDF_OBJECT HostWdfNewDevice;
+static ULONG HostWdfDepth;
+static ULONG64 HostWdfEnterCycles;
+static ULONG64 HostWdfEnterModelCycles;
+
+//
+// Cycle accounting.
+//
+
+static
+VOID
+HostWdfEnter (
+    VOID
+    )
+{
+    if (HostWdfDepth == 0) {
+        HostWdfEnterModelCycles = HostIoCounters.ModelCycles;
+        HostWdfEnterCycles = HostCycles();
+    }
+
+    HostWdfDepth += 1;
+}
+
+static
+VOID
+HostWdfLeave (
+    VOID
+    )
+{
+    ULONG64 Cycles;
+    ULONG64 ModelCycles;
+
+    HostWdfDepth -= 1;
+    if (HostWdfDepth == 0) {
+        Cycles = HostCycles() - HostWdfEnterCycles;
+        ModelCycles = HostIoCounters.ModelCycles - HostWdfEnterModelCycles;
+        if (Cycles > ModelCycles) {
+            HostWdfCounters.DriverCycles += Cycles - ModelCycles;
+        }
+    }
+}
+
+//
+// Objects and contexts.
+//
+
+static
+PHOST_WDF_OBJECT
+HostWdfGetDevice (
+    __in PHOST_WDF_OBJECT Object
+    )
+{
+    while ((Object != NULL) && (Object->Type != HostWdfTypeDevice)) {
+        if (Object->Type == HostWdfTypeRequest) {
+            return Object->u.Request.Device;
+        }
+
+        Object = Object->Parent;
+    }
+
+    return Object;
+}
+
+static
+NTSTATUS
+HostWdfAttachContext (
+    __in PHOST_WDF_OBJECT Object,
+    __in PWDF_OBJECT_ATTRIBUTES Attributes,
+    __out_opt PVOID *Context
+    )
+{
+    PHOST_WDF_CONTEXT Slot;
+    size_t Size;
+    ULONG Index;
+
+    Slot = NULL;
+    for (Index = 0; Index < HOST_WDF_CONTEXTS; Index += 1) {
+        if ((Object->Context[Index].TypeInfo == NULL) &&
+            (Object->Context[Index].EvtCleanupCallback == NULL) &&
+            (Object->Context[Index].EvtDestroyCallback == NULL)) {
+
+            Slot = &Object->Context[Index];
+            break;
+        }
+    }
+
+    if (Slot == NULL) {
+        HostAssert(FALSE, "too many object contexts", __FILE__, __LINE__);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (Attributes->ContextTypeInfo != NULL) {
+        Size = Attributes->ContextTypeInfo->ContextSize;
+        if (Attributes->ContextSizeOverride > Size) {
+            Size = Attributes->ContextSizeOverride;
+        }
+
+        Slot->Data = calloc(1, Size);
+        if (Slot->Data == NULL) {
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+
+        Slot->TypeInfo = Attributes->ContextTypeInfo;
+    }
+
+    Slot->EvtCleanupCallback = Attributes->EvtCleanupCallback;
+    Slot->EvtDestroyCallback = Attributes->EvtDestroyCallback;
+    if (Context != NULL) {
+        *Context = Slot->Data;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+static
+PHOST_WDF_OBJECT
+HostWdfCreateObject (
+    __in HOST_WDF_TYPE Type,
+    __in_opt PWDF_OBJECT_ATTRIBUTES Attributes,
+    __in_opt PHOST_WDF_OBJECT DefaultParent
+    )
+
+/*++
+
+Routine Description:
+
+    Allocates an object, links it under its parent and attaches the context
+    and callbacks named by the attributes.
+
+Arguments:
+
+    Type - Supplies the object type.
+
+    Attributes - Supplies the optional object attributes.
+
+    DefaultParent - Supplies the parent used when the attributes do not
+        name one.
+
+Return Value:
+
+    The new object, or NULL.
+
+--*/
+
+{
+    PHOST_WDF_OBJECT Object;
+
+    Object = calloc(1, sizeof(HOST_WDF_OBJECT));
+    if (Object == NULL) {
+        return NULL;
+    }
+
+    Object->Type = Type;
+    Object->Parent = DefaultParent;
+    Object->SynchronizationScope = WdfSynchronizationScopeInheritFromParent;
+    InsertTailList(&HostWdfObjects, &Object->ObjectLink);
+    if (Attributes == NULL) {
+        return Object;
+    }
+
+    if (Attributes->ParentObject != NULL) {
+        Object->Parent = Attributes->ParentObject;
+    }
+
+    Object->SynchronizationScope = Attributes->SynchronizationScope;
+    if ((Attributes->ContextTypeInfo != NULL) ||
+        (Attributes->EvtCleanupCallback != NULL) ||
+        (Attributes->EvtDestroyCallback != NULL)) {
+
+        if (!NT_SUCCESS(HostWdfAttachContext(Object, Attributes, NULL))) {
+            RemoveEntryList(&Object->ObjectLink);
+            free(Object);
+            return NULL;
+        }
+    }
+
+    return Object;
+}
+
+static
+VOID
+HostWdfDeleteObject (
+    __in PHOST_WDF_OBJECT Object
+    )
+
+/*++
+
+Routine Description:
+
+    Deletes the children of an object, newest first, then runs the object's
+    cleanup and destroy callbacks and frees it.
+
+--*/
+
+{
+    PLIST_ENTRY Entry;
+    ULONG Index;
+    PHOST_WDF_OBJECT Child;
+
+    if (Object->Deleting != FALSE) {
+        return;
+    }
+
+    Object->Deleting = TRUE;
+
+Restart:
+    for (Entry = HostWdfObjects.Blink;
+         Entry != &HostWdfObjects;
+         Entry = Entry->Blink) {
+
+        Child = CONTAINING_RECORD(Entry, HOST_WDF_OBJECT, ObjectLink);
+        if ((Child->Parent == Object) && (Child->Deleting == FALSE)) {
+            HostWdfDeleteObject(Child);
+            goto Restart;
+        }
+    }
+
+    HostWdfEnter();
+    for (Index = 0; Index < HOST_WDF_CONTEXTS; Index += 1) {
+        if (Object->Context[Index].EvtCleanupCallback != NULL) {
+            Object->Context[Index].EvtCleanupCallback(Object);
+        }
+    }
+
+    for (Index = 0; Index < HOST_WDF_CONTEXTS; Index += 1) {
+        if (Object->Context[Index].EvtDestroyCallback != NULL) {
+            Object->Context[Index].EvtDestroyCallback(Object);
+        }
+    }
+
+    HostWdfLeave();
+    switch (Object->Type) {
+    case HostWdfTypeRequest:
+        HostAssert(Object->u.Request.OnQueue == FALSE,
+                   "deleting a queued request", __FILE__, __LINE__);
+
+        free(Object->u.Request.SystemBuffer);
+        break;
+
+    case HostWdfTypeQueue:
+        HostAssert(IsListEmpty(&Object->u.Queue.Requests),
+                   "deleting a queue that holds requests", __FILE__,
+                   __LINE__);
+
+        break;
+
+    case HostWdfTypeDpc:
+        if (Object->u.Dpc.Queued != FALSE) {
+            RemoveEntryList(&Object->u.Dpc.QueueLink);
+        }
+
+        break;
+
+    case HostWdfTypeString:
+        free(Object->u.String.String.Buffer);
+        break;
+
+    case HostWdfTypeResourceList:
+        free(Object->u.ResourceList.Descriptors);
+        break;
+
+    default:
+        break;
+    }
+
+    for (Index = 0; Index < HOST_WDF_CONTEXTS; Index += 1) {
+        free(Object->Context[Index].Data);
+    }
+
+    if (Object == HostWdfDriver) {
+        HostWdfDriver = NULL;
+    }
+
+    RemoveEntryList(&Object->ObjectLink);
+    free(Object);
+}
+
+PVOID
+WdfObjectGetTypedContextWorker (
+    __in WDFOBJECT Handle,
+    __in PCWDF_OBJECT_CONTEXT_TYPE_INFO TypeInfo
+    )
+
+/*++
+
+Routine Description:
+
+    Returns the context of the given type.  Each translation unit has its
+    own copy of the type information, so types are matched by name.
+
+--*/
+
+{
+    PCWDF_OBJECT_CONTEXT_TYPE_INFO Attached;
+    ULONG Index;
+
+    for (Index = 0; Index < HOST_WDF_CONTEXTS; Index += 1) {
+        Attached = Handle->Context[Index].TypeInfo;
+        if ((Attached != NULL) &&
+            ((Attached == TypeInfo) ||
+             (strcmp(Attached->ContextName, TypeInfo->ContextName) == 0))) {
+
+            return Handle->Context[Index].Data;
+        }
+    }
+
+    HostAssert(FALSE, TypeInfo->ContextName, __FILE__, __LINE__);
+    return NULL;
+}
+
+NTSTATUS
+WdfObjectAllocateContext (
+    __in WDFOBJECT Handle,
+    __in PWDF_OBJECT_ATTRIBUTES ContextAttributes,
+    __out_opt PVOID *Context
+    )
+{
+    return HostWdfAttachContext(Handle, ContextAttributes, Context);
+}
+
+VOID
+WdfObjectDelete (
+    __in WDFOBJECT Object
+    )
+{
+    HostWdfDeleteObject(Object);
+}
+
+VOID
+WdfObjectAcquireLock (
+    __in WDFOBJECT Object
+    )
+{
+    PHOST_WDF_OBJECT Device;
+
+    Device = HostWdfGetDevice(Object);
+    HostAssert(Device->u.Device.LockHeld == FALSE,
+               "WdfObjectAcquireLock with the lock held (deadlock)", __FILE__,
+               __LINE__);
+
+    Device->u.Device.LockHeld = TRUE;
+}
+
+VOID
+WdfObjectReleaseLock (
+    __in WDFOBJECT Object
+    )
+{
+    PHOST_WDF_OBJECT Device;
+
+    Device = HostWdfGetDevice(Object);
+    HostAssert(Device->u.Device.LockHeld != FALSE,
+               "WdfObjectReleaseLock without the lock", __FILE__, __LINE__);
+
+    Device->u.Device.LockHeld = FALSE;
+}
+
+//
+// Callback serialization.  A serialized callback invoked while the lock is
+// already held was invoked by the framework on behalf of a driver routine
+// that holds it, which the framework allows, so it runs under that hold.
+//
+
+static
+BOOLEAN
+HostWdfSerialized (
+    __in PHOST_WDF_OBJECT Object
+    )
+{
+    PHOST_WDF_OBJECT Device;
+
+    Device = HostWdfGetDevice(Object);
+    if ((Device == NULL) ||
+        (Device->SynchronizationScope != WdfSynchronizationScopeDevice)) {
+
+        return FALSE;
+    }
+
+    switch (Object->Type) {
+    case HostWdfTypeDpc:
+        return Object->u.Dpc.Config.AutomaticSerialization;
+
+    case HostWdfTypeTimer:
+        return Object->u.Timer.Config.AutomaticSerialization;
+
+    case HostWdfTypeQueue:
+    case HostWdfTypeRequest:
+        return (Object->SynchronizationScope ==
+                WdfSynchronizationScopeInheritFromParent) ||
+               (Object->SynchronizationScope ==
+                WdfSynchronizationScopeDevice);
+
+    default:
+        return FALSE;
+    }
+}
+
+static
+BOOLEAN
+HostWdfBeginCallback (
+    __in PHOST_WDF_OBJECT Object
+    )
+{
+    PHOST_WDF_OBJECT Device;
+
+    HostWdfEnter();
+    if (HostWdfSerialized(Object) == FALSE) {
+        return FALSE;
+    }
+
+    Device = HostWdfGetDevice(Object);
+    if (Device->u.Device.LockHeld != FALSE) {
+        return FALSE;
+    }
+
+    Device->u.Device.LockHeld = TRUE;
+    return TRUE;
+}
+
+static
+VOID
+HostWdfEndCallback (
+    __in PHOST_WDF_OBJECT Object,
+    __in BOOLEAN Locked
+    )
+{
+    PHOST_WDF_OBJECT Device;
+
+    if (Locked != FALSE) {
+        Device = HostWdfGetDevice(Object);
+        HostAssert(Device->u.Device.LockHeld != FALSE,
+                   "callback released the framework lock", __FILE__,
+                   __LINE__);
+
+        Device->u.Device.LockHeld = FALSE;
+    }
+
+    HostWdfLeave();
+}
+
+static
+BOOLEAN
+HostWdfBlocked (
+    __in PHOST_WDF_OBJECT Object
+    )
+{
+    return (HostWdfSerialized(Object) != FALSE) &&
+           (HostWdfGetDevice(Object)->u.Device.LockHeld != FALSE);
+}
+
+//
+// Driver.
+//
+
+NTSTATUS
+WdfDriverCreate (
+    __in PDRIVER_OBJECT DriverObject,
+    __in PCUNICODE_STRING RegistryPath,
+    __in_opt PWDF_OBJECT_ATTRIBUTES DriverAttributes,
+    __in PWDF_DRIVER_CONFIG DriverConfig,
+    __out_opt WDFDRIVER *Driver
+    )
+{
+    PHOST_WDF_OBJECT Object;
+
+    UNREFERENCED_PARAMETER(DriverObject);
+    UNREFERENCED_PARAMETER(RegistryPath);
+
+    HostAssert(HostWdfDriver == NULL, "second WdfDriverCreate", __FILE__,
+               __LINE__);
+
+    Object = HostWdfCreateObject(HostWdfTypeDriver, DriverAttributes, NULL);
+    if (Object == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Object->u.Driver.EvtDriverDeviceAdd = DriverConfig->EvtDriverDeviceAdd;
+    Object->u.Driver.EvtDriverUnload = DriverConfig->EvtDriverUnload;
+    HostWdfDriver = Object;
+    if (Driver != NULL) {
+        *Driver = Object;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+PDRIVER_OBJECT
+WdfDriverWdmGetDriverObject (
+    __in WDFDRIVER Driver
+    )
+{
+    UNREFERENCED_PARAMETER(Driver);
+
+    return &HostWdfDriverObject;
+}
+
+static
+NTSTATUS
+HostWdfOpenKey (
+    __out WDFKEY *Key
+    )
+{
+    *Key = HostWdfCreateObject(HostWdfTypeKey, NULL, NULL);
+    return (*Key != NULL) ? STATUS_SUCCESS : STATUS_INSUFFICIENT_RESOURCES;
+}
+
+NTSTATUS
+WdfDriverOpenParametersRegistryKey (
+    __in WDFDRIVER Driver,
+    __in ACCESS_MASK DesiredAccess,
+    __in_opt PWDF_OBJECT_ATTRIBUTES KeyAttributes,
+    __out WDFKEY *Key
+    )
+{
+    UNREFERENCED_PARAMETER(Driver);
+    UNREFERENCED_PARAMETER(DesiredAccess);
+    UNREFERENCED_PARAMETER(KeyAttributes);
+
+    return HostWdfOpenKey(Key);
+}
+
+//
+// Device initialization and creation.
+//
+
+NTSTATUS
+WdfDeviceInitAssignName (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in_opt PCUNICODE_STRING DeviceName
+    )
+{
+    DeviceInit->Name.Buffer = DeviceInit->NameBuffer;
+    DeviceInit->Name.MaximumLength = sizeof(DeviceInit->NameBuffer);
+    DeviceInit->Name.Length = 0;
+    if (DeviceName == NULL) {
+        return STATUS_SUCCESS;
+    }
+
+    if (DeviceName->Length >= sizeof(DeviceInit->NameBuffer)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    RtlCopyMemory(DeviceInit->NameBuffer,
+                  DeviceName->Buffer,
+                  DeviceName->Length);
+
+    DeviceInit->NameBuffer[DeviceName->Length / sizeof(WCHAR)] = 0;
+    DeviceInit->Name.Length = DeviceName->Length;
+    return STATUS_SUCCESS;
+}
+
+VOID
+WdfDeviceInitSetExclusive (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in BOOLEAN IsExclusive
+    )
+{
+    UNREFERENCED_PARAMETER(DeviceInit);
+    UNREFERENCED_PARAMETER(IsExclusive);
+}
+
+VOID
+WdfDeviceInitSetDeviceType (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in ULONG DeviceType
+    )
+{
+    UNREFERENCED_PARAMETER(DeviceInit);
+    UNREFERENCED_PARAMETER(DeviceType);
+}
+
+VOID
+WdfDeviceInitSetRequestAttributes (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PWDF_OBJECT_ATTRIBUTES RequestAttributes
+    )
+{
+    DeviceInit->RequestAttributes = *RequestAttributes;
+}
+
+VOID
+WdfDeviceInitSetIoInCallerContextCallback (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PFN_WDF_IO_IN_CALLER_CONTEXT EvtIoInCallerContext
+    )
+{
+    DeviceInit->EvtIoInCallerContext = EvtIoInCallerContext;
+}
+
+VOID
+WdfDeviceInitSetPnpPowerEventCallbacks (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PWDF_PNPPOWER_EVENT_CALLBACKS PnpPowerEventCallbacks
+    )
+{
+    DeviceInit->PnpPower = *PnpPowerEventCallbacks;
+}
+
+VOID
+WdfDeviceInitSetPowerPolicyOwnership (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in BOOLEAN IsPowerPolicyOwner
+    )
+{
+    UNREFERENCED_PARAMETER(DeviceInit);
+    UNREFERENCED_PARAMETER(IsPowerPolicyOwner);
+}
+
+VOID
+WdfDeviceInitSetFileObjectConfig (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PWDF_FILEOBJECT_CONFIG FileObjectConfig,
+    __in_opt PWDF_OBJECT_ATTRIBUTES FileObjectAttributes
+    )
+{
+    UNREFERENCED_PARAMETER(FileObjectAttributes);
+
+    DeviceInit->FileConfig = *FileObjectConfig;
+}
+
+NTSTATUS
+WdfDeviceInitAssignWdmIrpPreprocessCallback (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PFN_WDFDEVICE_WDM_IRP_PREPROCESS EvtDeviceWdmIrpPreprocess,
+    __in UCHAR MajorFunction,
+    __in_opt PUCHAR MinorFunctions,
+    __in ULONG NumMinorFunctions
+    )
+{
+    UNREFERENCED_PARAMETER(DeviceInit);
+    UNREFERENCED_PARAMETER(EvtDeviceWdmIrpPreprocess);
+    UNREFERENCED_PARAMETER(MajorFunction);
+    UNREFERENCED_PARAMETER(MinorFunctions);
+    UNREFERENCED_PARAMETER(NumMinorFunctions);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfFdoInitOpenRegistryKey (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in ULONG DeviceInstanceKeyType,
+    __in ACCESS_MASK DesiredAccess,
+    __in_opt PWDF_OBJECT_ATTRIBUTES KeyAttributes,
+    __out WDFKEY *Key
+    )
+{
+    UNREFERENCED_PARAMETER(DeviceInit);
+    UNREFERENCED_PARAMETER(DeviceInstanceKeyType);
+    UNREFERENCED_PARAMETER(DesiredAccess);
+    UNREFERENCED_PARAMETER(KeyAttributes);
+
+    return HostWdfOpenKey(Key);
+}
+
+NTSTATUS
+WdfDeviceCreate (
+    __inout PWDFDEVICE_INIT *DeviceInit,
+    __in_opt PWDF_OBJECT_ATTRIBUTES DeviceAttributes,
+    __out WDFDEVICE *Device
+    )
+{
+    PHOST_WDF_OBJECT Object;
+
+    Object = HostWdfCreateObject(HostWdfTypeDevice,
+                                 DeviceAttributes,
+                                 HostWdfDriver);
+
+    if (Object == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Object->u.Device.Init = **DeviceInit;
+    Object->u.Device.Init.Name.Buffer = Object->u.Device.Init.NameBuffer;
+    Object->u.Device.DeviceObject.DriverObject = &HostWdfDriverObject;
+    Object->u.Device.DeviceObject.DeviceExtension = Object;
+    HostWdfDriverObject.DeviceObject = &Object->u.Device.DeviceObject;
+    free(*DeviceInit);
+    *DeviceInit = NULL;
+    HostWdfNewDevice = Object;
+    *Device = Object;
+    return STATUS_SUCCESS;
+}
+
+PDEVICE_OBJECT
+WdfDeviceWdmGetDeviceObject (
+    __in WDFDEVICE Device
+    )
+{
+    return &Device->u.Device.DeviceObject;
+}
+
+PDEVICE_OBJECT
+WdfDeviceWdmGetAttachedDevice (
+    __in WDFDEVICE Device
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+
+    return &HostWdfLowerDevice;
+}
+
+PDEVICE_OBJECT
+WdfDeviceWdmGetPhysicalDevice (
+    __in WDFDEVICE Device
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+
+    return &HostWdfPhysicalDevice;
+}
+
+NTSTATUS
+WdfDeviceAssignS0IdleSettings (
+    __in WDFDEVICE Device,
+    __in PWDF_DEVICE_POWER_POLICY_IDLE_SETTINGS Settings
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(Settings);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfDeviceAssignSxWakeSettings (
+    __in WDFDEVICE Device,
+    __in PWDF_DEVICE_POWER_POLICY_WAKE_SETTINGS Settings
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(Settings);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfDeviceSetPowerPolicyEventCallbacks (
+    __in WDFDEVICE Device,
+    __in PWDF_POWER_POLICY_EVENT_CALLBACKS Callbacks
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(Callbacks);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfDeviceStopIdle (
+    __in WDFDEVICE Device,
+    __in BOOLEAN WaitForD0
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(WaitForD0);
+
+    return STATUS_SUCCESS;
+}
+
+VOID
+WdfDeviceResumeIdle (
+    __in WDFDEVICE Device
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+}
+
+VOID
+WdfDeviceSetStaticStopRemove (
+    __in WDFDEVICE Device,
+    __in BOOLEAN Stoppable
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(Stoppable);
+}
+
+VOID
+WdfDeviceSetFailed (
+    __in WDFDEVICE Device,
+    __in WDF_DEVICE_FAILED_ACTION FailedAction
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(FailedAction);
+
+    HostAssert(FALSE, "WdfDeviceSetFailed", __FILE__, __LINE__);
+}
+
+NTSTATUS
+WdfDeviceOpenRegistryKey (
+    __in WDFDEVICE Device,
+    __in ULONG DeviceInstanceKeyType,
+    __in ACCESS_MASK DesiredAccess,
+    __in_opt PWDF_OBJECT_ATTRIBUTES KeyAttributes,
+    __out WDFKEY *Key
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(DeviceInstanceKeyType);
+    UNREFERENCED_PARAMETER(DesiredAccess);
+    UNREFERENCED_PARAMETER(KeyAttributes);
+
+    return HostWdfOpenKey(Key);
+}
+
+static
+NTSTATUS
+HostWdfSetString (
+    __in PHOST_WDF_OBJECT String,
+    __in_opt PCUNICODE_STRING Value
+    )
+{
+    PUNICODE_STRING Target;
+    USHORT Length;
+
+    Target = &String->u.String.String;
+    Length = (Value != NULL) ? Value->Length : 0;
+    free(Target->Buffer);
+    Target->Buffer = calloc(1, Length + sizeof(WCHAR));
+    if (Target->Buffer == NULL) {
+        Target->Length = 0;
+        Target->MaximumLength = 0;
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (Length != 0) {
+        RtlCopyMemory(Target->Buffer, Value->Buffer, Length);
+    }
+
+    Target->Length = Length;
+    Target->MaximumLength = Length + sizeof(WCHAR);
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfDeviceRetrieveDeviceName (
+    __in WDFDEVICE Device,
+    __in WDFSTRING String
+    )
+{
+    return HostWdfSetString(String, &Device->u.Device.Init.Name);
+}
+
+NTSTATUS
+WdfDeviceCreateSymbolicLink (
+    __in WDFDEVICE Device,
+    __in PCUNICODE_STRING SymbolicLinkName
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(SymbolicLinkName);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfDeviceCreateDeviceInterface (
+    __in WDFDEVICE Device,
+    __in const GUID *InterfaceClassGUID,
+    __in_opt PCUNICODE_STRING ReferenceString
+    )
+{
+    UNREFERENCED_PARAMETER(Device);
+    UNREFERENCED_PARAMETER(InterfaceClassGUID);
+    UNREFERENCED_PARAMETER(ReferenceString);
+
+    return STATUS_SUCCESS;
+}
+
+WDFDEVICE
+WdfFileObjectGetDevice (
+    __in WDFFILEOBJECT FileObject
+    )
+{
+    return FileObject->Parent;
+}
+
+//
+// Resources.
+//
+
+ULONG
+WdfCmResourceListGetCount (
+    __in WDFCMRESLIST List
+    )
+{
+    return List->u.ResourceList.Count;
+}
+
+PCM_PARTIAL_RESOURCE_DESCRIPTOR
+WdfCmResourceListGetDescriptor (
+    __in WDFCMRESLIST List,
+    __in ULONG Index
+    )
+{
+    if (Index >= List->u.ResourceList.Count) {
+        return NULL;
+    }
+
+    return &List->u.ResourceList.Descriptors[Index];
+}
+
+//
+// Registry and strings.  Every key sees the same values.
+//
+
+static
+ULONG
+HostWdfWideLength (
+    __in PCWSTR String
+    )
+{
+    ULONG Length;
+
+    Length = 0;
+    while (String[Length] != 0) {
+        Length += 1;
+    }
+
+    return Length;
+}
+
+static
+PHOST_WDF_REGISTRY_VALUE
+HostWdfFindValue (
+    __in PCWSTR Name,
+    __in ULONG NameLength,
+    __in BOOLEAN Create
+    )
+{
+    PHOST_WDF_REGISTRY_VALUE Value;
+    ULONG Index;
+
+    for (Index = 0; Index < HOST_WDF_REGISTRY_VALUES; Index += 1) {
+        Value = &HostWdfRegistry[Index];
+        if ((Value->Name[0] != 0) &&
+            (HostWdfWideLength(Value->Name) == NameLength) &&
+            (memcmp(Value->Name, Name, NameLength * sizeof(WCHAR)) == 0)) {
+
+            return Value;
+        }
+    }
+
+    if (Create == FALSE) {
+        return NULL;
+    }
+
+    HostAssert(NameLength < HOST_WDF_NAME_LENGTH, "registry name too long",
+               __FILE__, __LINE__);
+
+    for (Index = 0; Index < HOST_WDF_REGISTRY_VALUES; Index += 1) {
+        Value = &HostWdfRegistry[Index];
+        if (Value->Name[0] == 0) {
+            RtlCopyMemory(Value->Name, Name, NameLength * sizeof(WCHAR));
+            return Value;
+        }
+    }
+
+    HostAssert(FALSE, "registry full", __FILE__, __LINE__);
+    return NULL;
+}
+
+VOID
+HostWdfSetRegistryValue (
+    __in PCWSTR Name,
+    __in ULONG Value
+    )
+{
+    PHOST_WDF_REGISTRY_VALUE Entry;
+
+    Entry = HostWdfFindValue(Name, HostWdfWideLength(Name), TRUE);
+    if (Entry != NULL) {
+        Entry->IsString = FALSE;
+        Entry->Value = Value;
+    }
+}
+
+VOID
+HostWdfSetRegistryString (
+    __in PCWSTR Name,
+    __in PCWSTR Value
+    )
+{
+    PHOST_WDF_REGISTRY_VALUE Entry;
+    ULONG Length;
+
+    Length = HostWdfWideLength(Value);
+    HostAssert(Length < HOST_WDF_NAME_LENGTH, "registry string too long",
+               __FILE__, __LINE__);
+
+    Entry = HostWdfFindValue(Name, HostWdfWideLength(Name), TRUE);
+    if ((Entry != NULL) && (Length < HOST_WDF_NAME_LENGTH)) {
+        Entry->IsString = TRUE;
+        RtlZeroMemory(Entry->String, sizeof(Entry->String));
+        RtlCopyMemory(Entry->String, Value, Length * sizeof(WCHAR));
+    }
+}
+
+NTSTATUS
+WdfRegistryQueryULong (
+    __in WDFKEY Key,
+    __in PCUNICODE_STRING ValueName,
+    __out PULONG Value
+    )
+{
+    PHOST_WDF_REGISTRY_VALUE Entry;
+
+    UNREFERENCED_PARAMETER(Key);
+
+    Entry = HostWdfFindValue(ValueName->Buffer,
+                             ValueName->Length / sizeof(WCHAR),
+                             FALSE);
+
+    if ((Entry == NULL) || (Entry->IsString != FALSE)) {
+        return STATUS_OBJECT_NAME_NOT_FOUND;
+    }
+
+    *Value = Entry->Value;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfRegistryAssignULong (
+    __in WDFKEY Key,
+    __in PCUNICODE_STRING ValueName,
+    __in ULONG Value
+    )
+{
+    PHOST_WDF_REGISTRY_VALUE Entry;
+
+    UNREFERENCED_PARAMETER(Key);
+
+    Entry = HostWdfFindValue(ValueName->Buffer,
+                             ValueName->Length / sizeof(WCHAR),
+                             TRUE);
+
+    if (Entry == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Entry->IsString = FALSE;
+    Entry->Value = Value;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfRegistryQueryUnicodeString (
+    __in WDFKEY Key,
+    __in PCUNICODE_STRING ValueName,
+    __out_opt PUSHORT ValueByteLength,
+    __inout_opt PUNICODE_STRING Value
+    )
+{
+    PHOST_WDF_REGISTRY_VALUE Entry;
+    USHORT Length;
+
+    UNREFERENCED_PARAMETER(Key);
+
+    Entry = HostWdfFindValue(ValueName->Buffer,
+                             ValueName->Length / sizeof(WCHAR),
+                             FALSE);
+
+    if ((Entry == NULL) || (Entry->IsString == FALSE)) {
+        return STATUS_OBJECT_NAME_NOT_FOUND;
+    }
+
+    Length = (USHORT)(HostWdfWideLength(Entry->String) * sizeof(WCHAR));
+    if (ValueByteLength != NULL) {
+        *ValueByteLength = Length;
+    }
+
+    if ((Value == NULL) || (Value->MaximumLength < Length)) {
+        return STATUS_BUFFER_OVERFLOW;
+    }
+
+    RtlCopyMemory(Value->Buffer, Entry->String, Length);
+    Value->Length = Length;
+    return STATUS_SUCCESS;
+}
+
+VOID
+WdfRegistryClose (
+    __in WDFKEY Key
+    )
+{
+    HostWdfDeleteObject(Key);
+}
+
+NTSTATUS
+WdfStringCreate (
+    __in_opt PCUNICODE_STRING UnicodeString,
+    __in_opt PWDF_OBJECT_ATTRIBUTES StringAttributes,
+    __out WDFSTRING *String
+    )
+{
+    PHOST_WDF_OBJECT Object;
+    NTSTATUS Status;
+
+    Object = HostWdfCreateObject(HostWdfTypeString, StringAttributes, NULL);
+    if (Object == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Status = HostWdfSetString(Object, UnicodeString);
+    if (!NT_SUCCESS(Status)) {
+        HostWdfDeleteObject(Object);
+        return Status;
+    }
+
+    *String = Object;
+    return STATUS_SUCCESS;
+}
+
+VOID
+WdfStringGetUnicodeString (
+    __in WDFSTRING String,
+    __out PUNICODE_STRING UnicodeString
+    )
+{
+    *UnicodeString = String->u.String.String;
+}
+
+//
+// Queues and requests.
+//
+
+static
+VOID
+HostWdfInvokeCancel (
+    __in PHOST_WDF_OBJECT Request
+    )
+{
+    PFN_WDF_REQUEST_CANCEL CancelRoutine;
+    BOOLEAN Locked;
+    PHOST_WDF_OBJECT Queue;
+
+    //
+    // The cancel routine usually completes the request, so nothing of it
+    // may be used once the routine returns.
+    //
+
+    CancelRoutine = Request->u.Request.CancelRoutine;
+    Queue = Request->u.Request.Queue;
+    Request->u.Request.CancelRoutine = NULL;
+    Request->u.Request.CancelRoutineCalled = TRUE;
+    Request->u.Request.Status = STATUS_CANCELLED;
+    Locked = HostWdfBeginCallback(Queue);
+    CancelRoutine(Request);
+    HostWdfEndCallback(Queue, Locked);
+}
+
+static
+VOID
+HostWdfCancelOnQueue (
+    __in PHOST_WDF_OBJECT Request
+    )
+
+/*++
+
+Routine Description:
+
+    Takes a cancelled request off the manual queue that holds it and gives
+    it back to the driver through EvtIoCanceledOnQueue, or completes it.
+
+--*/
+
+{
+    PHOST_WDF_OBJECT Queue;
+    BOOLEAN Locked;
+
+    Queue = Request->u.Request.Queue;
+    RemoveEntryList(&Request->u.Request.QueueLink);
+    Request->u.Request.OnQueue = FALSE;
+    Queue->u.Queue.Queued -= 1;
+    Queue->u.Queue.DriverOwned += 1;
+    Request->u.Request.Status = STATUS_CANCELLED;
+    if (Queue->u.Queue.Config.EvtIoCanceledOnQueue == NULL) {
+        WdfRequestComplete(Request, STATUS_CANCELLED);
+        return;
+    }
+
+    Locked = HostWdfBeginCallback(Queue);
+    Queue->u.Queue.Config.EvtIoCanceledOnQueue(Queue, Request);
+    HostWdfEndCallback(Queue, Locked);
+}
+
+NTSTATUS
+WdfIoQueueCreate (
+    __in WDFDEVICE Device,
+    __in PWDF_IO_QUEUE_CONFIG Config,
+    __in_opt PWDF_OBJECT_ATTRIBUTES QueueAttributes,
+    __out_opt WDFQUEUE *Queue
+    )
+{
+    PHOST_WDF_OBJECT Object;
+
+    Object = HostWdfCreateObject(HostWdfTypeQueue, QueueAttributes, Device);
+    if (Object == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Object->Parent = Device;
+    Object->u.Queue.Config = *Config;
+    Object->u.Queue.Accepting = TRUE;
+    InitializeListHead(&Object->u.Queue.Requests);
+    if (Config->DefaultQueue != FALSE) {
+        Device->u.Device.DefaultQueue = Object;
+    }
+
+    if (Queue != NULL) {
+        *Queue = Object;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+WDFDEVICE
+WdfIoQueueGetDevice (
+    __in WDFQUEUE Queue
+    )
+{
+    return Queue->Parent;
+}
+
+WDF_IO_QUEUE_STATE
+WdfIoQueueGetState (
+    __in WDFQUEUE Queue,
+    __out_opt PULONG QueueRequests,
+    __out_opt PULONG DriverRequests
+    )
+{
+    ULONG State;
+
+    State = 0;
+    if (Queue->u.Queue.Accepting != FALSE) {
+        State |= WdfIoQueueAcceptRequests;
+    }
+
+    if (Queue->u.Queue.Stopped == FALSE) {
+        State |= WdfIoQueueDispatchRequests;
+    }
+
+    if (Queue->u.Queue.Queued == 0) {
+        State |= WdfIoQueueNoRequests;
+    }
+
+    if (Queue->u.Queue.DriverOwned == 0) {
+        State |= WdfIoQueueDriverNoRequests;
+    }
+
+    if (QueueRequests != NULL) {
+        *QueueRequests = Queue->u.Queue.Queued;
+    }
+
+    if (DriverRequests != NULL) {
+        *DriverRequests = Queue->u.Queue.DriverOwned;
+    }
+
+    return (WDF_IO_QUEUE_STATE)State;
+}
+
+VOID
+WdfIoQueuePurge (
+    __in WDFQUEUE Queue,
+    __in_opt PFN_WDF_IO_QUEUE_STATE PurgeComplete,
+    __in_opt WDFCONTEXT Context
+    )
+
+/*++
+
+Routine Description:
+
+    Stops the queue accepting requests until WdfIoQueueStart, cancels the
+    requests it holds, and cancels the requests delivered from it that the
+    driver has marked cancelable.
+
+--*/
+
+{
+    PLIST_ENTRY Entry;
+    PHOST_WDF_OBJECT Request;
+
+    Queue->u.Queue.Accepting = FALSE;
+    while (IsListEmpty(&Queue->u.Queue.Requests) == FALSE) {
+        Request = CONTAINING_RECORD(Queue->u.Queue.Requests.Flink,
+                                    HOST_WDF_OBJECT,
+                                    u.Request.QueueLink);
+
+        HostWdfCancelOnQueue(Request);
+    }
+
+Restart:
+    for (Entry = HostWdfObjects.Flink;
+         Entry != &HostWdfObjects;
+         Entry = Entry->Flink) {
+
+        Request = CONTAINING_RECORD(Entry, HOST_WDF_OBJECT, ObjectLink);
+        if ((Request->Type == HostWdfTypeRequest) &&
+            (Request->u.Request.Queue == Queue) &&
+            (Request->u.Request.CancelRoutine != NULL)) {
+
+            Request->u.Request.CancelRequested = TRUE;
+            HostWdfInvokeCancel(Request);
+            goto Restart;
+        }
+    }
+
+    if (PurgeComplete != NULL) {
+        HostWdfEnter();
+        PurgeComplete(Queue, Context);
+        HostWdfLeave();
+    }
+}
+
+VOID
+WdfIoQueueStart (
+    __in WDFQUEUE Queue
+    )
+{
+    Queue->u.Queue.Accepting = TRUE;
+    Queue->u.Queue.Stopped = FALSE;
+}
+
+VOID
+WdfIoQueueStopSynchronously (
+    __in WDFQUEUE Queue
+    )
+{
+    ULONG64 Deadline;
+
+    Queue->u.Queue.Stopped = TRUE;
+    Deadline = HostGetTime() + HOST_WDF_STOP_TIMEOUT;
+    while ((Queue->u.Queue.DriverOwned != 0) && (HostGetTime() < Deadline)) {
+        HostWdfRun(HostWdfStepNanoseconds);
+    }
+
+    HostAssert(Queue->u.Queue.DriverOwned == 0,
+               "WdfIoQueueStopSynchronously never finished", __FILE__,
+               __LINE__);
+}
+
+NTSTATUS
+WdfIoQueueRetrieveNextRequest (
+    __in WDFQUEUE Queue,
+    __out WDFREQUEST *OutRequest
+    )
+{
+    PHOST_WDF_OBJECT Request;
+
+    *OutRequest = NULL;
+    if ((Queue->u.Queue.Stopped != FALSE) ||
+        (IsListEmpty(&Queue->u.Queue.Requests) != FALSE)) {
+
+        return STATUS_NO_MORE_ENTRIES;
+    }
+
+    Request = CONTAINING_RECORD(RemoveHeadList(&Queue->u.Queue.Requests),
+                                HOST_WDF_OBJECT,
+                                u.Request.QueueLink);
+
+    Request->u.Request.OnQueue = FALSE;
+    Queue->u.Queue.Queued -= 1;
+    Queue->u.Queue.DriverOwned += 1;
+    *OutRequest = Request;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfRequestForwardToIoQueue (
+    __in WDFREQUEST Request,
+    __in WDFQUEUE DestinationQueue
+    )
+{
+    PHOST_WDF_OBJECT Source;
+
+    HostAssert(Request->u.Request.OnQueue == FALSE,
+               "forwarding a queued request", __FILE__, __LINE__);
+
+    HostAssert(Request->u.Request.CancelRoutine == NULL,
+               "forwarding a cancelable request", __FILE__, __LINE__);
+
+    if (DestinationQueue->u.Queue.Accepting == FALSE) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    Source = Request->u.Request.Queue;
+    if (Source != NULL) {
+        Source->u.Queue.DriverOwned -= 1;
+    }
+
+    Request->u.Request.Queue = DestinationQueue;
+    Request->u.Request.OnQueue = TRUE;
+    InsertTailList(&DestinationQueue->u.Queue.Requests,
+                   &Request->u.Request.QueueLink);
+
+    DestinationQueue->u.Queue.Queued += 1;
+    if (Request->u.Request.CancelRequested != FALSE) {
+        HostWdfCancelOnQueue(Request);
+    }
+
+    return STATUS_SUCCESS;
+}
+
+WDFQUEUE
+WdfRequestGetIoQueue (
+    __in WDFREQUEST Request
+    )
+{
+    return Request->u.Request.Queue;
+}
+
+VOID
+WdfRequestGetParameters (
+    __in WDFREQUEST Request,
+    __out PWDF_REQUEST_PARAMETERS Parameters
+    )
+{
+    *Parameters = Request->u.Request.Parameters;
+}
+
+KPROCESSOR_MODE
+WdfRequestGetRequestorMode (
+    __in WDFREQUEST Request
+    )
+{
+    UNREFERENCED_PARAMETER(Request);
+
+    return UserMode;
+}
+
+NTSTATUS
+WdfRequestGetStatus (
+    __in WDFREQUEST Request
+    )
+{
+    return Request->u.Request.Status;
+}
+
+NTSTATUS
+WdfRequestRetrieveInputBuffer (
+    __in WDFREQUEST Request,
+    __in size_t MinimumRequiredLength,
+    __deref_out PVOID *Buffer,
+    __out_opt size_t *Length
+    )
+{
+    PWDF_REQUEST_PARAMETERS Parameters;
+    size_t Available;
+
+    Parameters = &Request->u.Request.Parameters;
+    *Buffer = NULL;
+    switch (Parameters->Type) {
+    case WdfRequestTypeWrite:
+        Available = Parameters->Parameters.Write.Length;
+        break;
+
+    case WdfRequestTypeDeviceControl:
+    case WdfRequestTypeDeviceControlInternal:
+        Available = Parameters->Parameters.DeviceIoControl.InputBufferLength;
+        break;
+
+    default:
+        return STATUS_INVALID_DEVICE_REQUEST;
+    }
+
+    if ((Available == 0) || (Available < MinimumRequiredLength)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    *Buffer = Request->u.Request.SystemBuffer;
+    if (Length != NULL) {
+        *Length = Available;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+WdfRequestRetrieveOutputBuffer (
+    __in WDFREQUEST Request,
+    __in size_t MinimumRequiredSize,
+    __deref_out PVOID *Buffer,
+    __out_opt size_t *Length
+    )
+{
+    PWDF_REQUEST_PARAMETERS Parameters;
+    size_t Available;
+
+    Parameters = &Request->u.Request.Parameters;
+    *Buffer = NULL;
+    switch (Parameters->Type) {
+    case WdfRequestTypeRead:
+        Available = Parameters->Parameters.Read.Length;
+        break;
+
+    case WdfRequestTypeDeviceControl:
+    case WdfRequestTypeDeviceControlInternal:
+        Available = Parameters->Parameters.DeviceIoControl.OutputBufferLength;
+        break;
+
+    default:
+        return STATUS_INVALID_DEVICE_REQUEST;
+    }
+
+    if ((Available == 0) || (Available < MinimumRequiredSize)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    *Buffer = Request->u.Request.SystemBuffer;
+    if (Length != NULL) {
+        *Length = Available;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+VOID
+WdfRequestMarkCancelable (
+    __in WDFREQUEST Request,
+    __in PFN_WDF_REQUEST_CANCEL EvtRequestCancel
+    )
+
+/*++
+
+Routine Description:
+
+    Makes a driver owned request cancelable.  A request that was cancelled
+    while it was not cancelable has its cancel routine called before this
+    returns, as the framework does.
+
+--*/
+
+{
+    HostAssert(Request->u.Request.CancelRoutine == NULL,
+               "request already cancelable", __FILE__, __LINE__);
+
+    Request->u.Request.CancelRoutine = EvtRequestCancel;
+    if (Request->u.Request.CancelRequested != FALSE) {
+        Request->u.Request.CancelRoutine = NULL;
+        Request->u.Request.CancelRoutineCalled = TRUE;
+        Request->u.Request.Status = STATUS_CANCELLED;
+        EvtRequestCancel(Request);
+    }
+}
+
+NTSTATUS
+WdfRequestUnmarkCancelable (
+    __in WDFREQUEST Request
+    )
+{
+    if ((Request->u.Request.CancelRoutine == NULL) &&
+        (Request->u.Request.CancelRoutineCalled != FALSE)) {
+
+        return STATUS_CANCELLED;
+    }
+
+    Request->u.Request.CancelRoutine = NULL;
+    return STATUS_SUCCESS;
+}
+
+VOID
+WdfRequestStopAcknowledge (
+    __in WDFREQUEST Request,
+    __in BOOLEAN Requeue
+    )
+{
+    UNREFERENCED_PARAMETER(Request);
+    UNREFERENCED_PARAMETER(Requeue);
+
+    HostAssert(FALSE, "EvtIoStop is never delivered", __FILE__, __LINE__);
+}
+
+VOID
+WdfRequestComplete (
+    __in WDFREQUEST Request,
+    __in NTSTATUS Status
+    )
+{
+    WdfRequestCompleteWithInformation(Request, Status, 0);
+}
+
+VOID
+WdfRequestCompleteWithInformation (
+    __in WDFREQUEST Request,
+    __in NTSTATUS Status,
+    __in ULONG_PTR Information
+    )
+
+/*++
+
+Routine Description:
+
+    Completes a request: copies the output back to the sender, records the
+    status and deletes the request.
+
+--*/
+
+{
+    PHOST_WDF_IO Io;
+    ULONG_PTR Length;
+
+    HostAssert(Request->u.Request.OnQueue == FALSE,
+               "completing a queued request", __FILE__, __LINE__);
+
+    HostAssert(Request->u.Request.CancelRoutine == NULL,
+               "completing a cancelable request", __FILE__, __LINE__);
+
+    if (Request->u.Request.Queue != NULL) {
+        Request->u.Request.Queue->u.Queue.DriverOwned -= 1;
+        Request->u.Request.Queue = NULL;
+    }
+
+    Io = Request->u.Request.Io;
+    if (((Io->Type == WdfRequestTypeRead) ||
+         (Io->Type == WdfRequestTypeDeviceControl) ||
+         (Io->Type == WdfRequestTypeDeviceControlInternal)) &&
+        (Io->OutputBuffer != NULL)) {
+
+        Length = Information;
+        if (Length > Io->OutputLength) {
+            Length = Io->OutputLength;
+        }
+
+        RtlCopyMemory(Io->OutputBuffer, Request->u.Request.SystemBuffer, Length);
+    }
+
+    Io->Status = Status;
+    Io->Information = Information;
+    Io->Completed = TRUE;
+    Io->Request = NULL;
+    HostWdfCounters.RequestsCompleted += 1;
+    HostWdfDeleteObject(Request);
+}
+
+NTSTATUS
+WdfDeviceEnqueueRequest (
+    __in WDFDEVICE Device,
+    __in WDFREQUEST Request
+    )
+
+/*++
+
+Routine Description:
+
+    Delivers a request to the device's default queue, which dispatches it to
+    the queue callback for its type.
+
+--*/
+
+{
+    PWDF_IO_QUEUE_CONFIG Config;
+    BOOLEAN Locked;
+    PWDF_REQUEST_PARAMETERS Parameters;
+    PHOST_WDF_OBJECT Queue;
+
+    Queue = Device->u.Device.DefaultQueue;
+    if ((Queue == NULL) || (Queue->u.Queue.Accepting == FALSE)) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    Config = &Queue->u.Queue.Config;
+    Parameters = &Request->u.Request.Parameters;
+    Request->u.Request.Queue = Queue;
+    Queue->u.Queue.DriverOwned += 1;
+    if ((Config->AllowZeroLengthRequests == FALSE) &&
+        (((Parameters->Type == WdfRequestTypeRead) &&
+          (Parameters->Parameters.Read.Length == 0)) ||
+         ((Parameters->Type == WdfRequestTypeWrite) &&
+          (Parameters->Parameters.Write.Length == 0)))) {
+
+        WdfRequestComplete(Request, STATUS_SUCCESS);
+        return STATUS_SUCCESS;
+    }
+
+    Locked = HostWdfBeginCallback(Queue);
+    switch (Parameters->Type) {
+    case WdfRequestTypeRead:
+        if (Config->EvtIoRead == NULL) {
+            goto Unhandled;
+        }
+
+        Config->EvtIoRead(Queue, Request, Parameters->Parameters.Read.Length);
+        break;
+
+    case WdfRequestTypeWrite:
+        if (Config->EvtIoWrite == NULL) {
+            goto Unhandled;
+        }
+
+        Config->EvtIoWrite(Queue,
+                           Request,
+                           Parameters->Parameters.Write.Length);
+
+        break;
+
+    case WdfRequestTypeDeviceControl:
+        if (Config->EvtIoDeviceControl == NULL) {
+            goto Unhandled;
+        }
+
+        Config->EvtIoDeviceControl(
+            Queue,
+            Request,
+            Parameters->Parameters.DeviceIoControl.OutputBufferLength,
+            Parameters->Parameters.DeviceIoControl.InputBufferLength,
+            Parameters->Parameters.DeviceIoControl.IoControlCode);
+
+        break;
+
+    case WdfRequestTypeDeviceControlInternal:
+        if (Config->EvtIoInternalDeviceControl == NULL) {
+            goto Unhandled;
+        }
+
+        Config->EvtIoInternalDeviceControl(
+            Queue,
+            Request,
+            Parameters->Parameters.DeviceIoControl.OutputBufferLength,
+            Parameters->Parameters.DeviceIoControl.InputBufferLength,
+            Parameters->Parameters.DeviceIoControl.IoControlCode);
+
+        break;
+
+    default:
+        goto Unhandled;
+    }
+
+    HostWdfEndCallback(Queue, Locked);
+    return STATUS_SUCCESS;
+
+Unhandled:
+    HostWdfEndCallback(Queue, Locked);
+    WdfRequestComplete(Request, STATUS_INVALID_DEVICE_REQUEST);
+    return STATUS_SUCCESS;
+}
+
+//
+// Interrupts.
+//
+
+NTSTATUS
+WdfInterruptCreate (
+    __in WDFDEVICE Device,
+    __in PWDF_INTERRUPT_CONFIG Configuration,
+    __in_opt PWDF_OBJECT_ATTRIBUTES Attributes,
+    __out WDFINTERRUPT *Interrupt
+    )
+{
+    PHOST_WDF_OBJECT Object;
+
+    Object = HostWdfCreateObject(HostWdfTypeInterrupt, Attributes, Device);
+    if (Object == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Object->Parent = Device;
+    Object->u.Interrupt.Config = *Configuration;
+    WDF_INTERRUPT_EXTENDED_POLICY_INIT(&Object->u.Interrupt.Policy);
+    Device->u.Device.Interrupt = Object;
+    *Interrupt = Object;
+    return STATUS_SUCCESS;
+}
+
+BOOLEAN
+WdfInterruptSynchronize (
+    __in WDFINTERRUPT Interrupt,
+    __in PFN_WDF_INTERRUPT_SYNCHRONIZE Callback,
+    __in WDFCONTEXT Context
+    )
+{
+    BOOLEAN Result;
+
+    HostAssert(Interrupt->u.Interrupt.LockHeld == FALSE,
+               "WdfInterruptSynchronize with the interrupt lock held "
+               "(deadlock)", __FILE__, __LINE__);
+
+    Interrupt->u.Interrupt.LockHeld = TRUE;
+    Result = Callback(Interrupt, Context);
+    Interrupt->u.Interrupt.LockHeld = FALSE;
+    return Result;
+}
+
+WDFDEVICE
+WdfInterruptGetDevice (
+    __in WDFINTERRUPT Interrupt
+    )
+{
+    return Interrupt->Parent;
+}
+
+VOID
+WdfInterruptGetInfo (
+    __in WDFINTERRUPT Interrupt,
+    __out PWDF_INTERRUPT_INFO Info
+    )
+{
+    WDF_INTERRUPT_INFO_INIT(Info);
+    Info->Vector = Interrupt->u.Interrupt.Vector;
+    Info->Irql = Interrupt->u.Interrupt.Irql;
+    Info->TargetProcessorSet = Interrupt->u.Interrupt.Affinity;
+    Info->Mode = Latched;
+}
+
+VOID
+WdfInterruptSetExtendedPolicy (
+    __in WDFINTERRUPT Interrupt,
+    __in PWDF_INTERRUPT_EXTENDED_POLICY PolicyAndGroup
+    )
+{
+    Interrupt->u.Interrupt.Policy = *PolicyAndGroup;
+}
+
+//
+// DPCs and timers.
+//
+
+NTSTATUS
+WdfDpcCreate (
+    __in PWDF_DPC_CONFIG Config,
+    __in PWDF_OBJECT_ATTRIBUTES Attributes,
+    __out WDFDPC *Dpc
+    )
+{
+    PHOST_WDF_OBJECT Object;
+
+    Object = HostWdfCreateObject(HostWdfTypeDpc, Attributes, NULL);
+    if (Object == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Object->u.Dpc.Config = *Config;
+    *Dpc = Object;
+    return STATUS_SUCCESS;
+}
+
+BOOLEAN
+WdfDpcEnqueue (
+    __in WDFDPC Dpc
+    )
+{
+    if (Dpc->u.Dpc.Queued != FALSE) {
+        return FALSE;
+    }
+
+    Dpc->u.Dpc.Queued = TRUE;
+    InsertTailList(&HostWdfDpcQueue, &Dpc->u.Dpc.QueueLink);
+    return TRUE;
+}
+
+BOOLEAN
+WdfDpcCancel (
+    __in WDFDPC Dpc,
+    __in BOOLEAN Wait
+    )
+{
+    BOOLEAN Queued;
+
+    HostAssert((Wait == FALSE) || (Dpc->u.Dpc.Running == FALSE),
+               "WdfDpcCancel waits for itself (deadlock)", __FILE__,
+               __LINE__);
+
+    HostAssert((Wait == FALSE) || (HostWdfBlocked(Dpc) == FALSE),
+               "WdfDpcCancel waits under the lock its DPC needs (deadlock)",
+               __FILE__, __LINE__);
+
+    Queued = Dpc->u.Dpc.Queued;
+    if (Queued != FALSE) {
+        RemoveEntryList(&Dpc->u.Dpc.QueueLink);
+        Dpc->u.Dpc.Queued = FALSE;
+    }
+
+    return Queued;
+}
+
+WDFOBJECT
+WdfDpcGetParentObject (
+    __in WDFDPC Dpc
+    )
+{
+    return Dpc->Parent;
+}
+
+PKDPC
+WdfDpcWdmGetDpc (
+    __in WDFDPC Dpc
+    )
+{
+    return &Dpc->u.Dpc.Dpc;
+}
+
+NTSTATUS
+WdfTimerCreate (
+    __in PWDF_TIMER_CONFIG Config,
+    __in PWDF_OBJECT_ATTRIBUTES Attributes,
+    __out WDFTIMER *Timer
+    )
+{
+    PHOST_WDF_OBJECT Object;
+
+    Object = HostWdfCreateObject(HostWdfTypeTimer, Attributes, NULL);
+    if (Object == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Object->u.Timer.Config = *Config;
+    *Timer = Object;
+    return STATUS_SUCCESS;
+}
+
+BOOLEAN
+WdfTimerStart (
+    __in WDFTIMER Timer,
+    __in LONGLONG DueTime
+    )
+{
+    BOOLEAN Queued;
+
+    HostAssert(DueTime <= 0, "absolute timer due time", __FILE__, __LINE__);
+
+    Queued = Timer->u.Timer.Queued;
+    Timer->u.Timer.Queued = TRUE;
+    Timer->u.Timer.Due = HostGetTime() + ((ULONG64)(-DueTime) * 100);
+    return Queued;
+}
+
+BOOLEAN
+WdfTimerStop (
+    __in WDFTIMER Timer,
+    __in BOOLEAN Wait
+    )
+{
+    BOOLEAN Queued;
+
+    HostAssert((Wait == FALSE) || (Timer->u.Timer.Running == FALSE),
+               "WdfTimerStop waits for itself (deadlock)", __FILE__,
+               __LINE__);
+
+    HostAssert((Wait == FALSE) || (HostWdfBlocked(Timer) == FALSE),
+               "WdfTimerStop waits under the lock its timer needs (deadlock)",
+               __FILE__, __LINE__);
+
+    Queued = Timer->u.Timer.Queued;
+    Timer->u.Timer.Queued = FALSE;
+    return Queued;
+}
+
+WDFOBJECT
+WdfTimerGetParentObject (
+    __in WDFTIMER Timer
+    )
+{
+    return Timer->Parent;
+}
+
+//
+// Wait locks.
+//
+
+NTSTATUS
+WdfWaitLockCreate (
+    __in_opt PWDF_OBJECT_ATTRIBUTES LockAttributes,
+    __out WDFWAITLOCK *Lock
+    )
+{
+    *Lock = HostWdfCreateObject(HostWdfTypeWaitLock, LockAttributes, NULL);
+    return (*Lock != NULL) ? STATUS_SUCCESS : STATUS_INSUFFICIENT_RESOURCES;
+}
+
+NTSTATUS
+WdfWaitLockAcquire (
+    __in WDFWAITLOCK Lock,
+    __in_opt PLONGLONG Timeout
+    )
+{
+    if (Lock->u.WaitLock.Held != FALSE) {
+        if ((Timeout != NULL) && (*Timeout == 0)) {
+            return STATUS_TIMEOUT;
+        }
+
+        HostAssert(FALSE, "WdfWaitLockAcquire with the lock held (deadlock)",
+                   __FILE__, __LINE__);
+    }
+
+    Lock->u.WaitLock.Held = TRUE;
+    return STATUS_SUCCESS;
+}
+
+VOID
+WdfWaitLockRelease (
+    __in WDFWAITLOCK Lock
+    )
+{
+    HostAssert(Lock->u.WaitLock.Held != FALSE,
+               "WdfWaitLockRelease without the lock", __FILE__, __LINE__);
+
+    Lock->u.WaitLock.Held = FALSE;
+}
+
+//
+// WMI.
+//
+
+NTSTATUS
+WdfWmiInstanceCreate (
+    __in WDFDEVICE Device,
+    __in PWDF_WMI_INSTANCE_CONFIG InstanceConfig,
+    __in_opt PWDF_OBJECT_ATTRIBUTES InstanceAttributes,
+    __out_opt WDFWMIINSTANCE *Instance
+    )
+{
+    PHOST_WDF_OBJECT Object;
+
+    Object = HostWdfCreateObject(HostWdfTypeWmiInstance,
+                                 InstanceAttributes,
+                                 Device);
+
+    if (Object == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    Object->Parent = Device;
+    Object->u.WmiInstance.Config = *InstanceConfig;
+    if (Instance != NULL) {
+        *Instance = Object;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+WDFDEVICE
+WdfWmiInstanceGetDevice (
+    __in WDFWMIINSTANCE WmiInstance
+    )
+{
+    return WmiInstance->Parent;
+}
+
+//
+// Dispatcher.
+//
+
+static
+BOOLEAN
+HostWdfServiceInterrupts (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Runs the ISR of every connected interrupt whose line is asserted.
+
+Return Value:
+
+    TRUE if an ISR claimed an interrupt.
+
+--*/
+
+{
+    BOOLEAN Claimed;
+    PLIST_ENTRY Entry;
+    PHOST_WDF_OBJECT Interrupt;
+    BOOLEAN Serviced;
+
+    Serviced = FALSE;
+    for (Entry = HostWdfObjects.Flink;
+         Entry != &HostWdfObjects;
+         Entry = Entry->Flink) {
+
+        Interrupt = CONTAINING_RECORD(Entry, HOST_WDF_OBJECT, ObjectLink);
+        if ((Interrupt->Type != HostWdfTypeInterrupt) ||
+            (Interrupt->u.Interrupt.Connected == FALSE) ||
+            (Interrupt->u.Interrupt.LockHeld != FALSE) ||
+            (Interrupt->u.Interrupt.Line == NULL) ||
+            (Interrupt->u.Interrupt.Line(
+                 Interrupt->u.Interrupt.LineContext) == FALSE)) {
+
+            continue;
+        }
+
+        HostWdfEnter();
+        Interrupt->u.Interrupt.LockHeld = TRUE;
+        Claimed = Interrupt->u.Interrupt.Config.EvtInterruptIsr(Interrupt, 0);
+        Interrupt->u.Interrupt.LockHeld = FALSE;
+        HostWdfLeave();
+        HostWdfCounters.Interrupts += 1;
+        if (Claimed == FALSE) {
+            HostWdfCounters.SpuriousInterrupts += 1;
+            continue;
+        }
+
+        Serviced = TRUE;
+    }
+
+    return Serviced;
+}
+
+static
+BOOLEAN
+HostWdfRunDpc (
+    VOID
+    )
+{
+    PLIST_ENTRY Entry;
+    PHOST_WDF_OBJECT Dpc;
+    BOOLEAN Locked;
+
+    for (Entry = HostWdfDpcQueue.Flink;
+         Entry != &HostWdfDpcQueue;
+         Entry = Entry->Flink) {
+
+        Dpc = CONTAINING_RECORD(Entry, HOST_WDF_OBJECT, u.Dpc.QueueLink);
+        if (HostWdfBlocked(Dpc) != FALSE) {
+            continue;
+        }
+
+        RemoveEntryList(&Dpc->u.Dpc.QueueLink);
+        Dpc->u.Dpc.Queued = FALSE;
+        Dpc->u.Dpc.Running = TRUE;
+        Locked = HostWdfBeginCallback(Dpc);
+        Dpc->u.Dpc.Config.EvtDpcFunc(Dpc);
+        HostWdfEndCallback(Dpc, Locked);
+        Dpc->u.Dpc.Running = FALSE;
+        HostWdfCounters.Dpcs += 1;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+static
+PHOST_WDF_OBJECT
+HostWdfNextTimer (
+    __in BOOLEAN Runnable
+    )
+{
+    PLIST_ENTRY Entry;
+    PHOST_WDF_OBJECT Next;
+    PHOST_WDF_OBJECT Timer;
+
+    Next = NULL;
+    for (Entry = HostWdfObjects.Flink;
+         Entry != &HostWdfObjects;
+         Entry = Entry->Flink) {
+
+        Timer = CONTAINING_RECORD(Entry, HOST_WDF_OBJECT, ObjectLink);
+        if ((Timer->Type != HostWdfTypeTimer) ||
+            (Timer->u.Timer.Queued == FALSE) ||
+            ((Runnable != FALSE) && (HostWdfBlocked(Timer) != FALSE))) {
+
+            continue;
+        }
+
+        if ((Next == NULL) || (Timer->u.Timer.Due < Next->u.Timer.Due)) {
+            Next = Timer;
+        }
+    }
+
+    return Next;
+}
+
+static
+BOOLEAN
+HostWdfFireTimer (
+    VOID
+    )
+{
+    BOOLEAN Locked;
+    ULONG64 Period;
+    PHOST_WDF_OBJECT Timer;
+
+    Timer = HostWdfNextTimer(TRUE);
+    if ((Timer == NULL) || (Timer->u.Timer.Due > HostGetTime())) {
+        return FALSE;
+    }
+
+    Period = (ULONG64)Timer->u.Timer.Config.Period * 1000 * 1000;
+    if (Period != 0) {
+        Timer->u.Timer.Due += Period;
+        if (Timer->u.Timer.Due <= HostGetTime()) {
+            Timer->u.Timer.Due = HostGetTime() + Period;
+        }
+
+    } else {
+        Timer->u.Timer.Queued = FALSE;
+    }
+
+    Timer->u.Timer.Running = TRUE;
+    Locked = HostWdfBeginCallback(Timer);
+    Timer->u.Timer.Config.EvtTimerFunc(Timer);
+    HostWdfEndCallback(Timer, Locked);
+    Timer->u.Timer.Running = FALSE;
+    HostWdfCounters.TimerExpirations += 1;
+    return TRUE;
+}
+
+VOID
+HostWdfPump (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Runs everything that is ready at the current virtual time: interrupts
+    first, then DPCs, then timers, until nothing more is ready.
+
+--*/
+
+{
+    ULONG Interrupts;
+
+    Interrupts = 0;
+    for (;;) {
+        if (HostWdfServiceInterrupts() != FALSE) {
+            Interrupts += 1;
+            if (Interrupts < HOST_WDF_INTERRUPT_STORM) {
+                continue;
+            }
+
+            HostAssert(FALSE, "interrupt storm", __FILE__, __LINE__);
+            return;
+        }
+
+        if (HostWdfRunDpc() != FALSE) {
+            continue;
+        }
+
+        if (HostWdfFireTimer() != FALSE) {
+            continue;
+        }
+
+        break;
+    }
+}
+
+static
+VOID
+HostWdfStep (
+    __in ULONG64 End
+    )
+{
+    ULONG64 Now;
+    ULONG64 Step;
+    PHOST_WDF_OBJECT Timer;
+
+    Now = HostGetTime();
+    Step = HostWdfStepNanoseconds;
+    if (Step > End - Now) {
+        Step = End - Now;
+    }
+
+    Timer = HostWdfNextTimer(FALSE);
+    if ((Timer != NULL) &&
+        (Timer->u.Timer.Due > Now) &&
+        (Timer->u.Timer.Due - Now < Step)) {
+
+        Step = Timer->u.Timer.Due - Now;
+    }
+
+    HostAdvanceTime(Step);
+    HostWdfPump();
+}
+
+VOID
+HostWdfRun (
+    __in ULONG64 Nanoseconds
+    )
+{
+    ULONG64 End;
+
+    End = HostGetTime() + Nanoseconds;
+    HostWdfPump();
+    while (HostGetTime() < End) {
+        HostWdfStep(End);
+    }
+}
+
+BOOLEAN
+HostWdfRunUntilComplete (
+    __in PHOST_WDF_IO Io,
+    __in ULONG64 TimeoutNanoseconds
+    )
+{
+    ULONG64 End;
+
+    End = HostGetTime() + TimeoutNanoseconds;
+    HostWdfPump();
+    while ((Io->Completed == FALSE) && (HostGetTime() < End)) {
+        HostWdfStep(End);
+    }
+
+    return Io->Completed;
+}
+
+//
+// Test side.
+//
+
+NTSTATUS
+HostWdfLoadDriver (
+    __in DRIVER_INITIALIZE *DriverEntry
+    )
+{
+    static UNICODE_STRING RegistryPath;
+    NTSTATUS Status;
+
+    RtlInitUnicodeString(&RegistryPath,
+                         L"\\Registry\\Machine\\System\\CurrentControlSet"
+                         L"\\Services\\Serial");
+
+    RtlZeroMemory(&HostWdfDriverObject, sizeof(HostWdfDriverObject));
+    HostWdfEnter();
+    Status = DriverEntry(&HostWdfDriverObject, &RegistryPath);
+    HostWdfLeave();
+    if (!NT_SUCCESS(Status) && (HostWdfDriver != NULL)) {
+        HostWdfDeleteObject(HostWdfDriver);
+    }
+
+    return Status;
+}
+
+VOID
+HostWdfUnloadDriver (
+    VOID
+    )
+{
+    VOID (*Unload)(WDFDRIVER);
+
+    if (HostWdfDriver == NULL) {
+        return;
+    }
+
+    Unload = (VOID (*)(WDFDRIVER))HostWdfDriver->u.Driver.EvtDriverUnload;
+    if (Unload != NULL) {
+        HostWdfEnter();
+        Unload(HostWdfDriver);
+        HostWdfLeave();
+    }
+
+    HostWdfDeleteObject(HostWdfDriver);
+}
+
+NTSTATUS
+HostWdfAddDevice (
+    __out WDFDEVICE *Device
+    )
+{
+    PWDFDEVICE_INIT DeviceInit;
+    NTSTATUS Status;
+
+    *Device = NULL;
+    DeviceInit = calloc(1, sizeof(*DeviceInit));
+    if (DeviceInit == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    HostWdfNewDevice = NULL;
+    HostWdfEnter();
+    Status = HostWdfDriver->u.Driver.EvtDriverDeviceAdd(HostWdfDriver,
+                                                        DeviceInit);
+
+    HostWdfLeave();
+    if (HostWdfNewDevice == NULL) {
+        free(DeviceInit);
+        return NT_SUCCESS(Status) ? STATUS_UNSUCCESSFUL : Status;
+    }
+
+    if (!NT_SUCCESS(Status)) {
+        HostWdfDeleteObject(HostWdfNewDevice);
+        return Status;
+    }
+
+    *Device = HostWdfNewDevice;
+    return STATUS_SUCCESS;
+}
+
+static
+PHOST_WDF_OBJECT
+HostWdfCreateResourceList (
+    __in WDFDEVICE Device,
+    __in_ecount(Count) PCM_PARTIAL_RESOURCE_DESCRIPTOR Resources,
+    __in ULONG Count
+    )
+{
+    PHOST_WDF_OBJECT List;
+
+    List = HostWdfCreateObject(HostWdfTypeResourceList, NULL, Device);
+    if (List == NULL) {
+        return NULL;
+    }
+
+    List->u.ResourceList.Descriptors =
+        calloc(Count + 1, sizeof(CM_PARTIAL_RESOURCE_DESCRIPTOR));
+
+    if (List->u.ResourceList.Descriptors == NULL) {
+        HostWdfDeleteObject(List);
+        return NULL;
+    }
+
+    RtlCopyMemory(List->u.ResourceList.Descriptors,
+                  Resources,
+                  Count * sizeof(CM_PARTIAL_RESOURCE_DESCRIPTOR));
+
+    List->u.ResourceList.Count = Count;
+    return List;
+}
+
+NTSTATUS
+HostWdfStartDevice (
+    __in WDFDEVICE Device,
+    __in_ecount(ResourceCount) PCM_PARTIAL_RESOURCE_DESCRIPTOR Resources,
+    __in ULONG ResourceCount,
+    __in HOST_INTERRUPT_LINE InterruptLine,
+    __in PVOID InterruptLineContext
+    )
+
+/*++
+
+Routine Description:
+
+    Starts the device the way the framework does on its first start:
+    prepare hardware, D0 entry, connect and enable the interrupt, then the
+    post interrupt enable callback.
+
+--*/
+
+{
+    PWDF_PNPPOWER_EVENT_CALLBACKS Callbacks;
+    ULONG Index;
+    PHOST_WDF_OBJECT Interrupt;
+    NTSTATUS Status;
+
+    Callbacks = &Device->u.Device.Init.PnpPower;
+    Interrupt = Device->u.Device.Interrupt;
+    Device->u.Device.RawResources =
+        HostWdfCreateResourceList(Device, Resources, ResourceCount);
+
+    Device->u.Device.TranslatedResources =
+        HostWdfCreateResourceList(Device, Resources, ResourceCount);
+
+    if ((Device->u.Device.RawResources == NULL) ||
+        (Device->u.Device.TranslatedResources == NULL)) {
+
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    for (Index = 0; Index < ResourceCount; Index += 1) {
+        if ((Interrupt != NULL) &&
+            (Resources[Index].Type == CmResourceTypeInterrupt)) {
+
+            Interrupt->u.Interrupt.Vector = Resources[Index].u.Interrupt.Vector;
+            Interrupt->u.Interrupt.Irql =
+                (KIRQL)Resources[Index].u.Interrupt.Level;
+
+            Interrupt->u.Interrupt.Affinity =
+                Resources[Index].u.Interrupt.Affinity;
+        }
+    }
+
+    Status = STATUS_SUCCESS;
+    HostWdfEnter();
+    if (Callbacks->EvtDevicePrepareHardware != NULL) {
+        Status = Callbacks->EvtDevicePrepareHardware(
+                     Device,
+                     Device->u.Device.RawResources,
+                     Device->u.Device.TranslatedResources);
+
+        if (!NT_SUCCESS(Status)) {
+            goto End;
+        }
+    }
+
+    if (Callbacks->EvtDeviceD0Entry != NULL) {
+        Status = Callbacks->EvtDeviceD0Entry(Device, WdfPowerDeviceD3Final);
+        if (!NT_SUCCESS(Status)) {
+            goto End;
+        }
+    }
+
+    if (Interrupt != NULL) {
+        Interrupt->u.Interrupt.Line = InterruptLine;
+        Interrupt->u.Interrupt.LineContext = InterruptLineContext;
+        Interrupt->u.Interrupt.Connected = TRUE;
+        if (Interrupt->u.Interrupt.Config.EvtInterruptEnable != NULL) {
+            Interrupt->u.Interrupt.LockHeld = TRUE;
+            Status = Interrupt->u.Interrupt.Config.EvtInterruptEnable(
+                         Interrupt,
+                         Device);
+
+            Interrupt->u.Interrupt.LockHeld = FALSE;
+            if (!NT_SUCCESS(Status)) {
+                goto End;
+            }
+        }
+    }
+
+    if (Callbacks->EvtDeviceD0EntryPostInterruptsEnabled != NULL) {
+        Status = Callbacks->EvtDeviceD0EntryPostInterruptsEnabled(
+                     Device,
+                     WdfPowerDeviceD3Final);
+    }
+
+End:
+    HostWdfLeave();
+    HostWdfPump();
+    return Status;
+}
+
+VOID
+HostWdfRemoveDevice (
+    __in WDFDEVICE Device
+    )
+
+/*++
+
+Routine Description:
+
+    Removes a started device: the D0 exit sequence in the reverse of the
+    start order, release hardware, then deletion of the device and all of
+    its children.
+
+--*/
+
+{
+    PWDF_PNPPOWER_EVENT_CALLBACKS Callbacks;
+    PHOST_WDF_OBJECT Interrupt;
+    PLIST_ENTRY Entry;
+    PHOST_WDF_OBJECT Object;
+
+    Callbacks = &Device->u.Device.Init.PnpPower;
+    Interrupt = Device->u.Device.Interrupt;
+    HostWdfPump();
+    HostWdfEnter();
+    if (Callbacks->EvtDeviceD0ExitPreInterruptsDisabled != NULL) {
+        Callbacks->EvtDeviceD0ExitPreInterruptsDisabled(Device,
+                                                        WdfPowerDeviceD3Final);
+    }
+
+    if ((Interrupt != NULL) && (Interrupt->u.Interrupt.Connected != FALSE)) {
+        if (Interrupt->u.Interrupt.Config.EvtInterruptDisable != NULL) {
+            Interrupt->u.Interrupt.LockHeld = TRUE;
+            Interrupt->u.Interrupt.Config.EvtInterruptDisable(Interrupt,
+                                                              Device);
+
+            Interrupt->u.Interrupt.LockHeld = FALSE;
+        }
+
+        Interrupt->u.Interrupt.Connected = FALSE;
+    }
+
+    if (Callbacks->EvtDeviceD0Exit != NULL) {
+        Callbacks->EvtDeviceD0Exit(Device, WdfPowerDeviceD3Final);
+    }
+
+    if ((Callbacks->EvtDeviceReleaseHardware != NULL) &&
+        (Device->u.Device.TranslatedResources != NULL)) {
+
+        Callbacks->EvtDeviceReleaseHardware(
+            Device,
+            Device->u.Device.TranslatedResources);
+    }
+
+    HostWdfLeave();
+    for (Entry = HostWdfObjects.Flink;
+         Entry != &HostWdfObjects;
+         Entry = Entry->Flink) {
+
+        Object = CONTAINING_RECORD(Entry, HOST_WDF_OBJECT, ObjectLink);
+        HostAssert((Object->Type != HostWdfTypeRequest) ||
+                   (Object->u.Request.Device != Device),
+                   "device removed with requests outstanding", __FILE__,
+                   __LINE__);
+    }
+
+    HostWdfDeleteObject(Device);
+}
+
+static
+PHOST_WDF_OBJECT
+HostWdfCreateRequest (
+    __in WDFDEVICE Device,
+    __in PHOST_WDF_IO Io
+    )
+{
+    PWDF_REQUEST_PARAMETERS Parameters;
+    PHOST_WDF_OBJECT Request;
+    PWDF_OBJECT_ATTRIBUTES Attributes;
+    ULONG Size;
+
+    Attributes = NULL;
+    if (Device->u.Device.Init.RequestAttributes.Size != 0) {
+        Attributes = &Device->u.Device.Init.RequestAttributes;
+    }
+
+    Request = HostWdfCreateObject(HostWdfTypeRequest, Attributes, NULL);
+    if (Request == NULL) {
+        return NULL;
+    }
+
+    Request->Parent = NULL;
+    Size = (Io->InputLength > Io->OutputLength) ? Io->InputLength :
+                                                   Io->OutputLength;
+
+    Request->u.Request.SystemBuffer = calloc(1, Size + 1);
+    if (Request->u.Request.SystemBuffer == NULL) {
+        HostWdfDeleteObject(Request);
+        return NULL;
+    }
+
+    if ((Io->InputBuffer != NULL) && (Io->InputLength != 0)) {
+        RtlCopyMemory(Request->u.Request.SystemBuffer,
+                      Io->InputBuffer,
+                      Io->InputLength);
+    }
+
+    Parameters = &Request->u.Request.Parameters;
+    WDF_REQUEST_PARAMETERS_INIT(Parameters);
+    Parameters->Type = Io->Type;
+    switch (Io->Type) {
+    case WdfRequestTypeRead:
+        Parameters->Parameters.Read.Length = Io->OutputLength;
+        break;
+
+    case WdfRequestTypeWrite:
+        Parameters->Parameters.Write.Length = Io->InputLength;
+        break;
+
+    case WdfRequestTypeDeviceControl:
+    case WdfRequestTypeDeviceControlInternal:
+        Parameters->Parameters.DeviceIoControl.IoControlCode =
+            Io->IoControlCode;
+
+        Parameters->Parameters.DeviceIoControl.InputBufferLength =
+            Io->InputLength;
+
+        Parameters->Parameters.DeviceIoControl.OutputBufferLength =
+            Io->OutputLength;
+
+        break;
+
+    default:
+        break;
+    }
+
+    Request->u.Request.Io = Io;
+    Request->u.Request.Device = Device;
+    Request->u.Request.Status = STATUS_PENDING;
+    Io->Completed = FALSE;
+    Io->Status = STATUS_PENDING;
+    Io->Information = 0;
+    Io->Request = Request;
+    return Request;
+}
+
+NTSTATUS
+HostWdfOpen (
+    __in WDFDEVICE Device,
+    __out WDFFILEOBJECT *FileObject
+    )
+{
+    HOST_WDF_IO Io;
+    PHOST_WDF_OBJECT File;
+    PHOST_WDF_OBJECT Request;
+
+    *FileObject = NULL;
+    File = HostWdfCreateObject(HostWdfTypeFileObject, NULL, Device);
+    if (File == NULL) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    RtlZeroMemory(&Io, sizeof(Io));
+    Io.Type = WdfRequestTypeCreate;
+    Request = HostWdfCreateRequest(Device, &Io);
+    if (Request == NULL) {
+        HostWdfDeleteObject(File);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (Device->u.Device.Init.FileConfig.EvtDeviceFileCreate == NULL) {
+        WdfRequestComplete(Request, STATUS_SUCCESS);
+
+    } else {
+        HostWdfEnter();
+        Device->u.Device.Init.FileConfig.EvtDeviceFileCreate(Device,
+                                                             Request,
+                                                             File);
+
+        HostWdfLeave();
+    }
+
+    HostWdfPump();
+    HostAssert(Io.Completed != FALSE, "create left pending", __FILE__,
+               __LINE__);
+
+    if ((Io.Completed == FALSE) || !NT_SUCCESS(Io.Status)) {
+        HostWdfDeleteObject(File);
+        return (Io.Completed != FALSE) ? Io.Status : STATUS_UNSUCCESSFUL;
+    }
+
+    *FileObject = File;
+    return STATUS_SUCCESS;
+}
+
+VOID
+HostWdfClose (
+    __in WDFFILEOBJECT FileObject
+    )
+{
+    PWDF_FILEOBJECT_CONFIG Config;
+
+    Config = &FileObject->Parent->u.Device.Init.FileConfig;
+    HostWdfEnter();
+    if (Config->EvtFileCleanup != NULL) {
+        Config->EvtFileCleanup(FileObject);
+    }
+
+    if (Config->EvtFileClose != NULL) {
+        Config->EvtFileClose(FileObject);
+    }
+
+    HostWdfLeave();
+    HostWdfDeleteObject(FileObject);
+    HostWdfPump();
+}
+
+VOID
+HostWdfSend (
+    __in WDFDEVICE Device,
+    __inout PHOST_WDF_IO Io
+    )
+
+/*++
+
+Routine Description:
+
+    Sends a request to the device: through EvtIoInCallerContext if the
+    driver has one, otherwise straight to the default queue.  The request
+    may complete before this returns; otherwise the caller runs the
+    machine until it does.
+
+--*/
+
+{
+    PHOST_WDF_OBJECT Request;
+    NTSTATUS Status;
+
+    Request = HostWdfCreateRequest(Device, Io);
+    if (Request == NULL) {
+        Io->Completed = TRUE;
+        Io->Status = STATUS_INSUFFICIENT_RESOURCES;
+        return;
+    }
+
+    if (Device->u.Device.Init.EvtIoInCallerContext != NULL) {
+        HostWdfEnter();
+        Device->u.Device.Init.EvtIoInCallerContext(Device, Request);
+        HostWdfLeave();
+
+    } else {
+        Status = WdfDeviceEnqueueRequest(Device, Request);
+        if (!NT_SUCCESS(Status)) {
+            WdfRequestComplete(Request, Status);
+        }
+    }
+
+    HostWdfPump();
+}
+
+VOID
+HostWdfCancel (
+    __inout PHOST_WDF_IO Io
+    )
+{
+    PHOST_WDF_OBJECT Request;
+
+    Request = Io->Request;
+    if ((Io->Completed != FALSE) || (Request == NULL)) {
+        return;
+    }
+
+    Request->u.Request.CancelRequested = TRUE;
+    if (Request->u.Request.OnQueue != FALSE) {
+        HostWdfCancelOnQueue(Request);
+
+    } else if (Request->u.Request.CancelRoutine != NULL) {
+        HostWdfInvokeCancel(Request);
+    }
+
+    HostWdfPump();
+}
+
+ULONG
+HostWdfObjectCount (
+    VOID
+    )
+{
+    PLIST_ENTRY Entry;
+    ULONG Count;
+
+    Count = 0;
+    for (Entry = HostWdfObjects.Flink;
+         Entry != &HostWdfObjects;
+         Entry = Entry->Flink) {
+
+        Count += 1;
+    }
+
+    return Count;
+}
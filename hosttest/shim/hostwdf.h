@@ -0,0 +1,169 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    hostwdf.h
+
+Abstract:
+
+    Test side of the host framework emulation in hostwdf.c.
+
+    A test loads the driver, adds and starts a device with a resource list
+    and an interrupt line, opens it and sends it requests, then lets virtual
+    time pass while the emulation delivers interrupts, DPCs and timers the
+    way the framework would on a single processor: the ISR runs whenever the
+    line is asserted and the interrupt is connected, then queued DPCs run in
+    order, then expired timers fire.
+
+    The emulation enforces the framework locking rules it implements.  A
+    driver that acquires the device or interrupt lock while it already holds
+    it would deadlock on a real machine, and fails a host assertion here.
+
+--*/
+
+#pragma once
+
+//
+// The interrupt line is sampled between driver callbacks; it returns TRUE
+// while the device asserts its interrupt.
+//
+
+typedef
+BOOLEAN
+(*HOST_INTERRUPT_LINE) (
+    __in PVOID Context
+    );
+
+//
+// A request as the sender sees it.  The emulation copies the input buffer
+// into a system buffer when the request is sent, and copies the output back
+// when the driver completes it.
+//
+
+typedef struct _HOST_WDF_IO {
+    WDF_REQUEST_TYPE Type;
+    ULONG IoControlCode;
+    PVOID InputBuffer;
+    ULONG InputLength;
+    PVOID OutputBuffer;
+    ULONG OutputLength;
+
+    BOOLEAN Completed;
+    NTSTATUS Status;
+    ULONG_PTR Information;
+    WDFREQUEST Request;
+} HOST_WDF_IO, *PHOST_WDF_IO;
+
+//
+// DriverCycles counts the real time stamp counter cycles spent in driver
+// callbacks (including the framework routines they call), less the time
+// spent inside the device models.  Callbacks nested inside another callback
+// are counted once, by the outer one.
+//
+
+typedef struct _HOST_WDF_COUNTERS {
+    ULONG64 DriverCycles;
+    ULONG64 Interrupts;
+    ULONG64 SpuriousInterrupts;
+    ULONG64 Dpcs;
+    ULONG64 TimerExpirations;
+    ULONG64 RequestsCompleted;
+} HOST_WDF_COUNTERS, *PHOST_WDF_COUNTERS;
+
+extern HOST_WDF_COUNTERS HostWdfCounters;
+
+//
+// Granularity at which HostWdfRun samples the interrupt line.
+//
+
+extern ULONG64 HostWdfStepNanoseconds;
+
+extern ULONG HostPoolAllocations;
+extern ULONG HostErrorLogEntries;
+extern NTSTATUS HostLastErrorLogCode;
+
+NTSTATUS
+HostWdfLoadDriver (
+    __in DRIVER_INITIALIZE *DriverEntry
+    );
+
+VOID
+HostWdfUnloadDriver (
+    VOID
+    );
+
+VOID
+HostWdfSetRegistryValue (
+    __in PCWSTR Name,
+    __in ULONG Value
+    );
+
+VOID
+HostWdfSetRegistryString (
+    __in PCWSTR Name,
+    __in PCWSTR Value
+    );
+
+NTSTATUS
+HostWdfAddDevice (
+    __out WDFDEVICE *Device
+    );
+
+NTSTATUS
+HostWdfStartDevice (
+    __in WDFDEVICE Device,
+    __in_ecount(ResourceCount) PCM_PARTIAL_RESOURCE_DESCRIPTOR Resources,
+    __in ULONG ResourceCount,
+    __in HOST_INTERRUPT_LINE InterruptLine,
+    __in PVOID InterruptLineContext
+    );
+
+VOID
+HostWdfRemoveDevice (
+    __in WDFDEVICE Device
+    );
+
+NTSTATUS
+HostWdfOpen (
+    __in WDFDEVICE Device,
+    __out WDFFILEOBJECT *FileObject
+    );
+
+VOID
+HostWdfClose (
+    __in WDFFILEOBJECT FileObject
+    );
+
+VOID
+HostWdfSend (
+    __in WDFDEVICE Device,
+    __inout PHOST_WDF_IO Io
+    );
+
+VOID
+HostWdfCancel (
+    __inout PHOST_WDF_IO Io
+    );
+
+VOID
+HostWdfPump (
+    VOID
+    );
+
+VOID
+HostWdfRun (
+    __in ULONG64 Nanoseconds
+    );
+
+BOOLEAN
+HostWdfRunUntilComplete (
+    __in PHOST_WDF_IO Io,
+    __in ULONG64 TimeoutNanoseconds
+    );
+
+ULONG
+HostWdfObjectCount (
+    VOID
+    );
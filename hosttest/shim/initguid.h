@@ -0,0 +1,19 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    initguid.h
+
+Abstract:
+
+    Host build shim for the GUID definition header.  DEFINE_GUID in the
+    kernel header shim always defines the GUID, so there is nothing to
+    switch on here.
+
+--*/
+
+#pragma once
+
+#define INITGUID
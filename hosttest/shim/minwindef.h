@@ -0,0 +1,18 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    minwindef.h
+
+Abstract:
+
+    Host build shim for the minimal Windows type header.  Everything the
+    sources under test use from it is supplied by the kernel header shim.
+
+--*/
+
+#pragma once
+
+#include <ntddk.h>
@@ -0,0 +1,907 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    ntddk.h
+
+Abstract:
+
+    Host build shim for the kernel headers.  This supplies just enough of the
+    NT kernel types, annotations and HAL routines for the debugger transport
+    and serial driver sources to compile, unmodified, into a Linux process so
+    that their hardware independent logic can be unit tested and benchmarked.
+
+    Register and port accesses are routed through the HOST_IO_MODEL callbacks
+    in hostshim.h, so a test can place a device model behind them.  Time only
+    advances when the code under test stalls or when a model advances it.
+
+--*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+//
+// Calling conventions and storage classes.
+//
+
+#define NTAPI
+#define NTSYSAPI
+#define WINAPI
+#define FASTCALL
+#define FORCEINLINE static inline __attribute__((always_inline))
+#define DECLSPEC_NOINLINE __attribute__((noinline))
+#define DECLSPEC_CACHEALIGN __attribute__((aligned(64)))
+#define DECLSPEC_ALIGN(x) __attribute__((aligned(x)))
+#define __declspec(x) __declspec_##x
+#define __declspec_align(x) __attribute__((aligned(x)))
+#define UNALIGNED
+#define C_ASSERT(e) _Static_assert(e, #e)
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+#define CONTAINING_RECORD(address, type, field) \
+    ((type *)((char *)(address) - offsetof(type, field)))
+#define FIELD_OFFSET(type, field) ((LONG)offsetof(type, field))
+#define RTL_FIELD_SIZE(type, field) (sizeof(((type *)0)->field))
+#define RTL_NUMBER_OF(A) (sizeof(A) / sizeof((A)[0]))
+#define ARRAYSIZE(A) RTL_NUMBER_OF(A)
+#define ALIGN_UP_BY(Length, Alignment) \
+    (((ULONG_PTR)(Length) + (Alignment) - 1) & ~((ULONG_PTR)(Alignment) - 1))
+#define ALIGN_DOWN_BY(Length, Alignment) \
+    ((ULONG_PTR)(Length) & ~((ULONG_PTR)(Alignment) - 1))
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+
+//
+// Source annotations.
+//
+
+#define __in
+#define __in_opt
+#define __out
+#define __out_opt
+#define __inout
+#define __inout_opt
+#define __in_bcount(x)
+#define __out_bcount(x)
+#define __in_ecount(x)
+#define __out_ecount(x)
+#define __out_bcount_part(x, y)
+#define __out_ecount_part(x, y)
+#define __in_bcount_opt(x)
+#define __out_bcount_opt(x)
+#define __drv_aliasesMem
+#define _In_
+#define _In_opt_
+#define _Out_
+#define _Out_opt_
+#define _Inout_
+#define _Inout_opt_
+#define _In_reads_(x)
+#define _In_reads_bytes_(x)
+#define _In_reads_bytes_opt_(x)
+#define __deref_out
+#define __deref_out_opt
+#define _Out_writes_(x)
+#define _Out_writes_bytes_(x)
+#define _Out_writes_to_(x, y)
+#define _Out_writes_bytes_to_(x, y)
+#define _Use_decl_annotations_
+#define _Must_inspect_result_
+#define _IRQL_requires_(x)
+#define _IRQL_requires_max_(x)
+#define _IRQL_requires_same_
+#define _Requires_lock_held_(x)
+#define _Requires_lock_not_held_(x)
+#define _Acquires_lock_(x)
+#define _Releases_lock_(x)
+#define _Function_class_(x)
+#define _Analysis_assume_(x)
+#define _Printf_format_string_
+#define _Null_terminated_
+#define _Notliteral_
+#define __fallthrough
+#define OPTIONAL
+
+//
+// Basic types.  The Windows data model is LLP64, so ULONG stays 32 bits.
+//
+
+#define VOID void
+typedef void *PVOID;
+typedef char CHAR, *PCHAR, *PSTR;
+typedef const char *PCSTR, *PCCHAR;
+typedef uint8_t UCHAR, *PUCHAR, BYTE, *PBYTE, BOOLEAN, *PBOOLEAN;
+typedef int16_t SHORT, CSHORT;
+typedef uint16_t USHORT, *PUSHORT, WORD, WCHAR, *PWCHAR, *PWSTR;
+typedef int32_t LONG, *PLONG, INT, NTSTATUS;
+typedef uint32_t ULONG, *PULONG, UINT, DWORD, *PDWORD;
+typedef int64_t LONG64, LONGLONG, *PLONG64, *PLONGLONG;
+typedef uint64_t ULONG64, *PULONG64, ULONGLONG, DWORD64, UINT64;
+typedef uint16_t UINT16;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t ULONG_PTR, *PULONG_PTR, SIZE_T, *PSIZE_T, KAFFINITY;
+typedef UCHAR KIRQL, *PKIRQL;
+typedef LONG KPRIORITY;
+
+typedef union _LARGE_INTEGER {
+    struct {
+        ULONG LowPart;
+        LONG HighPart;
+    };
+    LONG64 QuadPart;
+} LARGE_INTEGER, *PLARGE_INTEGER, PHYSICAL_ADDRESS, *PPHYSICAL_ADDRESS;
+
+typedef union _ULARGE_INTEGER {
+    struct {
+        ULONG LowPart;
+        ULONG HighPart;
+    };
+    ULONG64 QuadPart;
+} ULARGE_INTEGER, *PULARGE_INTEGER;
+
+typedef struct _GUID {
+    ULONG Data1;
+    USHORT Data2;
+    USHORT Data3;
+    UCHAR Data4[8];
+} GUID, *PGUID;
+
+//
+// GUIDs are defined static in every translation unit that names them, so
+// INITGUID makes no difference to the host build.
+//
+
+#define DEFINE_GUID(name, l, w1, w2, b1, b2, b3, b4, b5, b6, b7, b8) \
+    static const GUID name __attribute__((unused)) = \
+        { l, w1, w2, { b1, b2, b3, b4, b5, b6, b7, b8 } }
+
+typedef struct _LIST_ENTRY {
+    struct _LIST_ENTRY *Flink;
+    struct _LIST_ENTRY *Blink;
+} LIST_ENTRY, *PLIST_ENTRY;
+
+typedef struct _DRIVER_OBJECT *PDRIVER_OBJECT;
+typedef struct _DEVICE_OBJECT *PDEVICE_OBJECT;
+
+typedef struct _UNICODE_STRING {
+    USHORT Length;
+    USHORT MaximumLength;
+    PWSTR Buffer;
+} UNICODE_STRING, *PUNICODE_STRING;
+
+typedef const UNICODE_STRING *PCUNICODE_STRING;
+
+#define TRUE 1
+#define FALSE 0
+#ifndef NULL
+#define NULL ((void *)0)
+#endif
+
+#define MAXUCHAR 0xff
+#define MAXUSHORT 0xffff
+#define MAXULONG 0xffffffffUL
+#define MAXLONG 0x7fffffffL
+#define MAXULONG64 0xffffffffffffffffULL
+#define MAXULONG_PTR UINTPTR_MAX
+#define PAGE_SIZE 0x1000
+#define PAGE_SHIFT 12
+#define BYTE_OFFSET(Va) ((ULONG)((ULONG_PTR)(Va) & (PAGE_SIZE - 1)))
+#define ADDRESS_AND_SIZE_TO_SPAN_PAGES(Va, Size) \
+    ((ULONG)((((ULONG_PTR)(Size)) >> PAGE_SHIFT) + \
+     ((BYTE_OFFSET(Va) + ((ULONG_PTR)(Size) & (PAGE_SIZE - 1)) + \
+       (PAGE_SIZE - 1)) >> PAGE_SHIFT)))
+
+//
+// Status codes.
+//
+
+#define NT_SUCCESS(Status) (((NTSTATUS)(Status)) >= 0)
+#define STATUS_SUCCESS ((NTSTATUS)0x00000000L)
+#define STATUS_PENDING ((NTSTATUS)0x00000103L)
+#define STATUS_MORE_PROCESSING_REQUIRED ((NTSTATUS)0xC0000016L)
+#define STATUS_BUFFER_OVERFLOW ((NTSTATUS)0x80000005L)
+#define STATUS_UNSUCCESSFUL ((NTSTATUS)0xC0000001L)
+#define STATUS_NOT_IMPLEMENTED ((NTSTATUS)0xC0000002L)
+#define STATUS_INVALID_PARAMETER ((NTSTATUS)0xC000000DL)
+#define STATUS_INVALID_HANDLE ((NTSTATUS)0xC0000008L)
+#define STATUS_NO_SUCH_DEVICE ((NTSTATUS)0xC000000EL)
+#define STATUS_INVALID_DEVICE_REQUEST ((NTSTATUS)0xC0000010L)
+#define STATUS_NO_MEMORY ((NTSTATUS)0xC0000017L)
+#define STATUS_ACCESS_DENIED ((NTSTATUS)0xC0000022L)
+#define STATUS_BUFFER_TOO_SMALL ((NTSTATUS)0xC0000023L)
+#define STATUS_DATA_ERROR ((NTSTATUS)0xC000003EL)
+#define STATUS_NOT_FOUND ((NTSTATUS)0xC0000225L)
+#define STATUS_INSUFFICIENT_RESOURCES ((NTSTATUS)0xC000009AL)
+#define STATUS_DEVICE_NOT_READY ((NTSTATUS)0xC00000A3L)
+#define STATUS_IO_TIMEOUT ((NTSTATUS)0xC00000B5L)
+#define STATUS_NOT_SUPPORTED ((NTSTATUS)0xC00000BBL)
+#define STATUS_CANCELLED ((NTSTATUS)0xC0000120L)
+#define STATUS_DEVICE_NOT_CONNECTED ((NTSTATUS)0xC000009DL)
+#define STATUS_DEVICE_DATA_ERROR ((NTSTATUS)0xC000009CL)
+#define STATUS_DEVICE_PROTOCOL_ERROR ((NTSTATUS)0xC0000186L)
+#define STATUS_NO_DATA_DETECTED ((NTSTATUS)0x80000022L)
+#define STATUS_TIMEOUT ((NTSTATUS)0x00000102L)
+#define STATUS_INVALID_BUFFER_SIZE ((NTSTATUS)0xC0000206L)
+#define STATUS_INVALID_DEVICE_STATE ((NTSTATUS)0xC0000184L)
+
+//
+// Run time library.
+//
+
+#define RtlZeroMemory(Destination, Length) memset((Destination), 0, (Length))
+#define RtlFillMemory(Destination, Length, Fill) \
+    memset((Destination), (Fill), (Length))
+#define RtlCopyMemory(Destination, Source, Length) \
+    memcpy((Destination), (Source), (Length))
+#define RtlMoveMemory(Destination, Source, Length) \
+    memmove((Destination), (Source), (Length))
+#define RtlCompareMemory(Source1, Source2, Length) \
+    HostCompareMemory((Source1), (Source2), (Length))
+#define RtlEqualMemory(Source1, Source2, Length) \
+    (memcmp((Source1), (Source2), (Length)) == 0)
+
+SIZE_T
+HostCompareMemory (
+    const void *Source1,
+    const void *Source2,
+    SIZE_T Length
+    );
+
+#define NT_ASSERT(e) HostAssert((e) != 0, #e, __FILE__, __LINE__)
+#define ASSERT(e) NT_ASSERT(e)
+#define KdPrint(x)
+#define KdPrintEx(x)
+#define DbgPrint(...)
+#define DbgBreakPoint() HostAssert(0, "DbgBreakPoint", __FILE__, __LINE__)
+
+VOID
+HostAssert (
+    int Condition,
+    const char *Expression,
+    const char *File,
+    int Line
+    );
+
+//
+// Memory ordering and interlocked operations.  The code under test runs on a
+// single host thread unless a test says otherwise, so the compiler builtins
+// are enough.
+//
+
+#define KeMemoryBarrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define KeMemoryBarrierWithoutFence() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define _ReadWriteBarrier() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define MemoryBarrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define YieldProcessor() ((void)0)
+#define InterlockedIncrement(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedDecrement(p) __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedExchange(p, v) __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedExchangeAdd(p, v) \
+    __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedOr(p, v) __atomic_fetch_or((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedAnd(p, v) __atomic_fetch_and((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedCompareExchange(p, e, c) \
+    __sync_val_compare_and_swap((p), (c), (e))
+#define ReadNoFence(p) (*(volatile LONG *)(p))
+#define WriteNoFence(p, v) (*(volatile LONG *)(p) = (v))
+
+//
+// Time and processor routines.  Performance counter and cycle counter reads
+// return the host virtual clock (see hostshim.h).
+//
+
+VOID
+KeStallExecutionProcessor (
+    ULONG MicroSeconds
+    );
+
+LARGE_INTEGER
+KeQueryPerformanceCounter (
+    PLARGE_INTEGER PerformanceFrequency
+    );
+
+ULONG64
+ReadTimeStampCounter (
+    VOID
+    );
+
+#define __rdtsc() ReadTimeStampCounter()
+
+//
+// Port and register access.
+//
+
+UCHAR READ_PORT_UCHAR (PUCHAR Port);
+USHORT READ_PORT_USHORT (PUSHORT Port);
+ULONG READ_PORT_ULONG (PULONG Port);
+VOID WRITE_PORT_UCHAR (PUCHAR Port, UCHAR Value);
+VOID WRITE_PORT_USHORT (PUSHORT Port, USHORT Value);
+VOID WRITE_PORT_ULONG (PULONG Port, ULONG Value);
+VOID READ_PORT_BUFFER_UCHAR (PUCHAR Port, PUCHAR Buffer, ULONG Count);
+VOID WRITE_PORT_BUFFER_UCHAR (PUCHAR Port, PUCHAR Buffer, ULONG Count);
+UCHAR READ_REGISTER_UCHAR (volatile UCHAR *Register);
+USHORT READ_REGISTER_USHORT (volatile USHORT *Register);
+ULONG READ_REGISTER_ULONG (volatile ULONG *Register);
+VOID WRITE_REGISTER_UCHAR (volatile UCHAR *Register, UCHAR Value);
+VOID WRITE_REGISTER_USHORT (volatile USHORT *Register, USHORT Value);
+VOID WRITE_REGISTER_ULONG (volatile ULONG *Register, ULONG Value);
+ULONG64 READ_REGISTER_ULONG64 (volatile ULONG64 *Register);
+VOID WRITE_REGISTER_ULONG64 (volatile ULONG64 *Register, ULONG64 Value);
+
+//
+// Hibernation range flags, as passed to PoSetHiberRange.
+//
+
+#define PO_MEM_PRESERVE 0x00000001
+#define PO_MEM_CLONE 0x00000002
+#define PO_MEM_CL_OR_NCHK 0x00000004
+#define PO_MEM_DISCARD 0x00008000
+#define PO_MEM_PAGE_ADDRESS 0x00004000
+#define PO_MEM_BOOT_PHASE 0x00010000
+
+//
+// Resource types, as reported in DEBUG_DEVICE_ADDRESS.Type.
+//
+
+#define CmResourceTypeNull 0
+#define CmResourceTypePort 1
+#define CmResourceTypeInterrupt 2
+#define CmResourceTypeMemory 3
+
+//
+// PCI configuration space header.
+//
+
+#define PCI_TYPE0_ADDRESSES 6
+#define PCI_CLASS_NETWORK_CTLR 0x02
+
+typedef struct _PCI_COMMON_CONFIG {
+    USHORT VendorID;
+    USHORT DeviceID;
+    USHORT Command;
+    USHORT Status;
+    UCHAR RevisionID;
+    UCHAR ProgIf;
+    UCHAR SubClass;
+    UCHAR BaseClass;
+    UCHAR CacheLineSize;
+    UCHAR LatencyTimer;
+    UCHAR HeaderType;
+    UCHAR BIST;
+    ULONG BaseAddresses[PCI_TYPE0_ADDRESSES];
+    ULONG CIS;
+    USHORT SubVendorID;
+    USHORT SubSystemID;
+    ULONG ROMBaseAddress;
+    UCHAR CapabilitiesPtr;
+    UCHAR Reserved1[3];
+    ULONG Reserved2;
+    UCHAR InterruptLine;
+    UCHAR InterruptPin;
+    UCHAR MinimumGrant;
+    UCHAR MaximumLatency;
+    UCHAR DeviceSpecific[192];
+} PCI_COMMON_CONFIG, *PPCI_COMMON_CONFIG;
+
+//
+// Debug device descriptor, as handed to the debugger transports.
+//
+
+#define MAXIMUM_DEBUG_BARS 6
+
+typedef enum _KD_NAMESPACE_ENUM {
+    KdNameSpacePCI,
+    KdNameSpaceACPI,
+    KdNameSpaceAny,
+    KdNameSpaceNone,
+    KdNameSpaceMax,
+} KD_NAMESPACE_ENUM, *PKD_NAMESPACE_ENUM;
+
+typedef struct _DEBUG_DEVICE_ADDRESS {
+    UCHAR Type;
+    BOOLEAN Valid;
+    union {
+        UCHAR Reserved[2];
+        struct {
+            UCHAR BitWidth;
+            UCHAR AccessSize;
+        };
+    };
+    PUCHAR TranslatedAddress;
+    ULONG Length;
+} DEBUG_DEVICE_ADDRESS, *PDEBUG_DEVICE_ADDRESS;
+
+typedef struct _DEBUG_MEMORY_REQUIREMENTS {
+    PHYSICAL_ADDRESS Start;
+    PHYSICAL_ADDRESS MaxEnd;
+    PVOID VirtualAddress;
+    ULONG Length;
+    BOOLEAN Cached;
+    BOOLEAN Aligned;
+} DEBUG_MEMORY_REQUIREMENTS, *PDEBUG_MEMORY_REQUIREMENTS;
+
+typedef struct _DEBUG_TRANSPORT_DATA {
+    ULONG HwContextSize;
+    ULONG SharedVisibleDataSize;
+    BOOLEAN UseSerialFraming;
+    BOOLEAN ValidUSBCoreId;
+    UCHAR USBCoreId;
+} DEBUG_TRANSPORT_DATA, *PDEBUG_TRANSPORT_DATA;
+
+typedef struct _DEBUG_DEVICE_DESCRIPTOR {
+    ULONG Bus;
+    ULONG Slot;
+    USHORT Segment;
+    USHORT VendorID;
+    USHORT DeviceID;
+    UCHAR BaseClass;
+    UCHAR SubClass;
+    UCHAR ProgIf;
+    union {
+        UCHAR Flags;
+        struct {
+            UCHAR DbgHalScratchAllocated : 1;
+            UCHAR DbgBarsMapped : 1;
+            UCHAR DbgScratchAllocated : 1;
+        };
+    };
+    BOOLEAN Initialized;
+    BOOLEAN Configured;
+    DEBUG_DEVICE_ADDRESS BaseAddress[MAXIMUM_DEBUG_BARS];
+    DEBUG_MEMORY_REQUIREMENTS Memory;
+    ULONG Dbg2TableIndex;
+    USHORT PortType;
+    USHORT PortSubtype;
+    PVOID OemData;
+    ULONG OemDataLength;
+    KD_NAMESPACE_ENUM NameSpace;
+    PWCHAR NameSpacePath;
+    ULONG NameSpacePathLength;
+    ULONG TransportType;
+    DEBUG_TRANSPORT_DATA TransportData;
+} DEBUG_DEVICE_DESCRIPTOR, *PDEBUG_DEVICE_DESCRIPTOR;
+
+//
+// The rest of this header supplies the I/O manager, executive and memory
+// manager surface used by the KMDF serial driver.  The routines behave as
+// they would for a single device on a quiet machine; see hostwdf.h.
+//
+
+#define IN
+#define OUT
+#define _IRQL_saves_
+#define _IRQL_restores_
+#define _IRQL_raises_(x)
+#define _Dispatch_type_(x)
+#define __drv_dispatchType(x)
+#define __pragma(x)
+#define NOTHING
+#define IsNotNEC_98 (TRUE)
+#define DBG 0
+#define PAGED_CODE()
+#define ASSERTMSG(Message, e) HostAssert((e) != 0, (Message), __FILE__, __LINE__)
+#define NT_ERROR(Status) ((ULONG)(Status) >> 30 == 3)
+#define ARGUMENT_PRESENT(ArgumentPointer) ((CHAR *)((ULONG_PTR)(ArgumentPointer)) != (CHAR *)(NULL))
+#define ULongToPtr(ul) ((PVOID)(ULONG_PTR)((unsigned long)(ul)))
+#define PtrToUlong(p) ((ULONG)(ULONG_PTR)(p))
+#define PtrToUshort(p) ((USHORT)(ULONG_PTR)(p))
+#define UInt32x32To64(a, b) ((ULONG64)(ULONG)(a) * (ULONG64)(ULONG)(b))
+#define UNICODE_NULL ((WCHAR)0)
+#define ANYSIZE_ARRAY 1
+#define DECLARE_UNICODE_STRING_SIZE(_var, _size) \
+    WCHAR _var ## _buffer[_size]; \
+    UNICODE_STRING _var = { 0, (_size) * sizeof(WCHAR), _var ## _buffer }
+
+typedef void *HANDLE, **PHANDLE;
+typedef const WCHAR *PCWSTR;
+typedef GUID *LPGUID;
+typedef const GUID *LPCGUID;
+typedef int32_t INT32;
+typedef uint32_t UINT32;
+typedef uint64_t *PUINT64;
+typedef int16_t *PSHORT;
+typedef ULONG ACCESS_MASK;
+
+typedef struct _DRIVER_OBJECT {
+    PDEVICE_OBJECT DeviceObject;
+    ULONG Flags;
+} DRIVER_OBJECT;
+
+typedef struct _DEVICE_OBJECT {
+    PDRIVER_OBJECT DriverObject;
+    ULONG Flags;
+    PVOID DeviceExtension;
+} DEVICE_OBJECT;
+
+#define STATUS_DEVICE_BUSY ((NTSTATUS)0x80000011L)
+#define STATUS_NO_MORE_ENTRIES ((NTSTATUS)0x8000001AL)
+#define STATUS_NONE_MAPPED ((NTSTATUS)0xC0000073L)
+#define STATUS_DEVICE_CONFIGURATION_ERROR ((NTSTATUS)0xC0000182L)
+#define STATUS_SERIAL_NO_DEVICE_INITED ((NTSTATUS)0xC0000150L)
+#define STATUS_SERIAL_MORE_WRITES ((NTSTATUS)0x40000008L)
+#define STATUS_SERIAL_COUNTER_TIMEOUT ((NTSTATUS)0x4000000CL)
+#define STATUS_OBJECT_NAME_NOT_FOUND ((NTSTATUS)0xC0000034L)
+#define STATUS_OBJECT_TYPE_MISMATCH ((NTSTATUS)0xC0000024L)
+
+#define PASSIVE_LEVEL 0
+#define DISPATCH_LEVEL 2
+#define HIGH_LEVEL 15
+#define POWER_LEVEL 14
+#define IO_NO_INCREMENT 0
+#define IO_SERIAL_INCREMENT 2
+#define EVENT_MODIFY_STATE 0x0002
+#define STANDARD_RIGHTS_ALL 0x001F0000L
+#define PAGE_READWRITE 0x04
+#define PAGE_NOCACHE 0x200
+#define DO_POWER_PAGABLE 0x00002000
+#define POOL_QUOTA_FAIL_INSTEAD_OF_RAISE 8
+#define ALL_PROCESSOR_GROUPS 0xffff
+#define NTDDI_VISTA 0x06000000
+#define REG_SZ 1
+#define REG_DWORD 4
+#define RTL_REGISTRY_DEVICEMAP 4
+#define PLUGPLAY_REGKEY_DEVICE 1
+#define PLUGPLAY_REGKEY_DRIVER 2
+#define CM_RESOURCE_PORT_MEMORY 0x0000
+#define CM_RESOURCE_PORT_IO 0x0001
+#define CM_RESOURCE_INTERRUPT_LATCHED 0x0001
+#define FILE_ANY_ACCESS 0
+#define METHOD_BUFFERED 0
+#define METHOD_IN_DIRECT 1
+#define METHOD_OUT_DIRECT 2
+#define METHOD_NEITHER 3
+#define FILE_DEVICE_SERIAL_PORT 0x0000001b
+#define CTL_CODE(DeviceType, Function, Method, Access) \
+    (((DeviceType) << 16) | ((Access) << 14) | ((Function) << 2) | (Method))
+
+#define IRP_MJ_CREATE 0x00
+#define IRP_MJ_CLOSE 0x02
+#define IRP_MJ_READ 0x03
+#define IRP_MJ_WRITE 0x04
+#define IRP_MJ_QUERY_INFORMATION 0x05
+#define IRP_MJ_SET_INFORMATION 0x06
+#define IRP_MJ_FLUSH_BUFFERS 0x09
+#define IRP_MJ_DEVICE_CONTROL 0x0e
+#define IRP_MJ_INTERNAL_DEVICE_CONTROL 0x0f
+#define IRP_MJ_POWER 0x16
+#define IRP_MJ_PNP 0x1b
+#define IRP_MN_START_DEVICE 0x00
+#define IRP_MN_REMOVE_DEVICE 0x02
+#define IRP_MN_CANCEL_REMOVE_DEVICE 0x03
+#define IRP_MN_STOP_DEVICE 0x04
+#define IRP_MN_CANCEL_STOP_DEVICE 0x06
+#define IRP_MN_SET_POWER 0x02
+
+typedef enum _POOL_TYPE {
+    NonPagedPool,
+    PagedPool,
+    NonPagedPoolNx = 512,
+} POOL_TYPE;
+
+typedef enum _MODE {
+    KernelMode,
+    UserMode,
+} MODE, KPROCESSOR_MODE;
+
+typedef enum _KINTERRUPT_MODE {
+    LevelSensitive,
+    Latched,
+} KINTERRUPT_MODE;
+
+typedef enum _MM_SYSTEM_SIZE {
+    MmSmallSystem,
+    MmMediumSystem,
+    MmLargeSystem,
+} MM_SYSTEMSIZE;
+
+typedef enum _MEMORY_CACHING_TYPE {
+    MmNonCached,
+    MmCached,
+} MEMORY_CACHING_TYPE;
+
+typedef enum _DEVICE_POWER_STATE {
+    PowerDeviceUnspecified,
+    PowerDeviceD0,
+    PowerDeviceD1,
+    PowerDeviceD2,
+    PowerDeviceD3,
+    PowerDeviceMaximum,
+} DEVICE_POWER_STATE;
+
+typedef enum _FILE_INFORMATION_CLASS {
+    FileStandardInformation = 5,
+    FilePositionInformation = 14,
+    FileAllocationInformation = 19,
+    FileEndOfFileInformation = 20,
+} FILE_INFORMATION_CLASS;
+
+typedef enum _CM_SHARE_DISPOSITION {
+    CmResourceShareUndetermined,
+    CmResourceShareDeviceExclusive,
+    CmResourceShareDriverExclusive,
+    CmResourceShareShared,
+} CM_SHARE_DISPOSITION;
+
+typedef struct _PROCESSOR_NUMBER {
+    USHORT Group;
+    UCHAR Number;
+    UCHAR Reserved;
+} PROCESSOR_NUMBER, *PPROCESSOR_NUMBER;
+
+typedef struct _GROUP_AFFINITY {
+    KAFFINITY Mask;
+    USHORT Group;
+    USHORT Reserved[3];
+} GROUP_AFFINITY, *PGROUP_AFFINITY;
+
+typedef struct _KEVENT {
+    LONG SignalState;
+} KEVENT, *PKEVENT, *PRKEVENT;
+
+typedef struct _KDPC {
+    PROCESSOR_NUMBER TargetProcessor;
+    BOOLEAN Targeted;
+} KDPC, *PKDPC, *PRKDPC;
+
+typedef struct _OBJECT_TYPE *POBJECT_TYPE;
+
+typedef struct _CONFIGURATION_INFORMATION {
+    ULONG DiskCount;
+    ULONG FloppyCount;
+    ULONG CdRomCount;
+    ULONG TapeCount;
+    ULONG ScsiPortCount;
+    ULONG SerialCount;
+    ULONG ParallelCount;
+} CONFIGURATION_INFORMATION, *PCONFIGURATION_INFORMATION;
+
+typedef struct _FILE_STANDARD_INFORMATION {
+    LARGE_INTEGER AllocationSize;
+    LARGE_INTEGER EndOfFile;
+    ULONG NumberOfLinks;
+    BOOLEAN DeletePending;
+    BOOLEAN Directory;
+} FILE_STANDARD_INFORMATION, *PFILE_STANDARD_INFORMATION;
+
+typedef struct _FILE_POSITION_INFORMATION {
+    LARGE_INTEGER CurrentByteOffset;
+} FILE_POSITION_INFORMATION, *PFILE_POSITION_INFORMATION;
+
+typedef struct _IO_STATUS_BLOCK {
+    NTSTATUS Status;
+    ULONG_PTR Information;
+} IO_STATUS_BLOCK, *PIO_STATUS_BLOCK;
+
+typedef struct _IO_STACK_LOCATION {
+    UCHAR MajorFunction;
+    UCHAR MinorFunction;
+    union {
+        struct {
+            ULONG Length;
+            FILE_INFORMATION_CLASS FileInformationClass;
+        } QueryFile;
+        struct {
+            ULONG Length;
+            FILE_INFORMATION_CLASS FileInformationClass;
+        } SetFile;
+        struct {
+            ULONG OutputBufferLength;
+            ULONG InputBufferLength;
+            ULONG IoControlCode;
+            PVOID Type3InputBuffer;
+        } DeviceIoControl;
+    } Parameters;
+} IO_STACK_LOCATION, *PIO_STACK_LOCATION;
+
+typedef struct _IRP IRP, *PIRP;
+
+typedef
+VOID
+DRIVER_CANCEL (
+    PDEVICE_OBJECT DeviceObject,
+    PIRP Irp
+    );
+
+typedef DRIVER_CANCEL *PDRIVER_CANCEL;
+
+struct _IRP {
+    IO_STATUS_BLOCK IoStatus;
+    union {
+        PVOID SystemBuffer;
+    } AssociatedIrp;
+    PDRIVER_CANCEL CancelRoutine;
+    BOOLEAN Cancel;
+    BOOLEAN Completed;
+    IO_STACK_LOCATION Stack;
+};
+
+typedef struct _IO_ERROR_LOG_PACKET {
+    UCHAR MajorFunctionCode;
+    UCHAR RetryCount;
+    USHORT DumpDataSize;
+    USHORT NumberOfStrings;
+    USHORT StringOffset;
+    USHORT EventCategory;
+    NTSTATUS ErrorCode;
+    ULONG UniqueErrorValue;
+    NTSTATUS FinalStatus;
+    ULONG SequenceNumber;
+    ULONG IoControlCode;
+    LARGE_INTEGER DeviceOffset;
+    ULONG DumpData[1];
+} IO_ERROR_LOG_PACKET, *PIO_ERROR_LOG_PACKET;
+
+#pragma pack(push, 4)
+
+typedef struct _CM_PARTIAL_RESOURCE_DESCRIPTOR {
+    UCHAR Type;
+    UCHAR ShareDisposition;
+    USHORT Flags;
+    union {
+        struct {
+            PHYSICAL_ADDRESS Start;
+            ULONG Length;
+        } Port;
+        struct {
+            PHYSICAL_ADDRESS Start;
+            ULONG Length;
+        } Memory;
+        struct {
+            ULONG Level;
+            ULONG Vector;
+            KAFFINITY Affinity;
+        } Interrupt;
+    } u;
+} CM_PARTIAL_RESOURCE_DESCRIPTOR, *PCM_PARTIAL_RESOURCE_DESCRIPTOR;
+
+#pragma pack(pop)
+
+typedef
+NTSTATUS
+DRIVER_INITIALIZE (
+    PDRIVER_OBJECT DriverObject,
+    PUNICODE_STRING RegistryPath
+    );
+
+typedef
+PVOID
+(*PFN_MM_MAP_IO_SPACE_EX) (
+    PHYSICAL_ADDRESS PhysicalAddress,
+    SIZE_T NumberOfBytes,
+    ULONG Protect
+    );
+
+typedef
+USHORT
+(*PFN_KE_GET_ACTIVE_GROUP_COUNT) (
+    VOID
+    );
+
+typedef
+KAFFINITY
+(*PFN_KE_QUERY_GROUP_AFFINITY) (
+    USHORT GroupNumber
+    );
+
+extern PUCHAR *KdComPortInUse;
+extern POBJECT_TYPE *ExEventObjectType;
+
+//
+// List routines.
+//
+
+FORCEINLINE
+VOID
+InitializeListHead (
+    PLIST_ENTRY ListHead
+    )
+{
+    ListHead->Flink = ListHead->Blink = ListHead;
+}
+
+#define IsListEmpty(ListHead) ((ListHead)->Flink == (ListHead))
+
+FORCEINLINE
+BOOLEAN
+RemoveEntryList (
+    PLIST_ENTRY Entry
+    )
+{
+    PLIST_ENTRY Blink;
+    PLIST_ENTRY Flink;
+
+    Flink = Entry->Flink;
+    Blink = Entry->Blink;
+    Blink->Flink = Flink;
+    Flink->Blink = Blink;
+    return (BOOLEAN)(Flink == Blink);
+}
+
+FORCEINLINE
+PLIST_ENTRY
+RemoveHeadList (
+    PLIST_ENTRY ListHead
+    )
+{
+    PLIST_ENTRY Entry;
+
+    Entry = ListHead->Flink;
+    RemoveEntryList(Entry);
+    return Entry;
+}
+
+FORCEINLINE
+VOID
+InsertTailList (
+    PLIST_ENTRY ListHead,
+    PLIST_ENTRY Entry
+    )
+{
+    PLIST_ENTRY Blink;
+
+    Blink = ListHead->Blink;
+    Entry->Flink = ListHead;
+    Entry->Blink = Blink;
+    Blink->Flink = Entry;
+    ListHead->Blink = Entry;
+}
+
+FORCEINLINE
+VOID
+InsertHeadList (
+    PLIST_ENTRY ListHead,
+    PLIST_ENTRY Entry
+    )
+{
+    PLIST_ENTRY Flink;
+
+    Flink = ListHead->Flink;
+    Entry->Flink = Flink;
+    Entry->Blink = ListHead;
+    Flink->Blink = Entry;
+    ListHead->Flink = Entry;
+}
+
+//
+// Executive, I/O manager, kernel and memory manager routines.
+//
+
+PVOID ExAllocatePoolWithTag (POOL_TYPE PoolType, SIZE_T NumberOfBytes, ULONG Tag);
+PVOID ExAllocatePoolWithQuotaTag (POOL_TYPE PoolType, SIZE_T NumberOfBytes, ULONG Tag);
+VOID ExFreePool (PVOID P);
+
+PIO_STACK_LOCATION IoGetCurrentIrpStackLocation (PIRP Irp);
+VOID IoCompleteRequest (PIRP Irp, CHAR PriorityBoost);
+PVOID IoAllocateErrorLogEntry (PVOID IoObject, UCHAR EntrySize);
+VOID IoWriteErrorLogEntry (PVOID ElEntry);
+PCONFIGURATION_INFORMATION IoGetConfigurationInformation (VOID);
+
+NTSTATUS KeDelayExecutionThread (KPROCESSOR_MODE WaitMode, BOOLEAN Alertable, PLARGE_INTEGER Interval);
+VOID KeQuerySystemTime (PLARGE_INTEGER CurrentTime);
+ULONGLONG KeQueryInterruptTime (VOID);
+VOID KeRaiseIrql (KIRQL NewIrql, PKIRQL OldIrql);
+VOID KeLowerIrql (KIRQL NewIrql);
+LONG KeSetEvent (PRKEVENT Event, KPRIORITY Increment, BOOLEAN Wait);
+ULONG KeQueryActiveProcessorCountEx (USHORT GroupNumber);
+NTSTATUS KeGetProcessorNumberFromIndex (ULONG ProcIndex, PPROCESSOR_NUMBER ProcNumber);
+NTSTATUS KeSetTargetProcessorDpcEx (PKDPC Dpc, PPROCESSOR_NUMBER ProcNumber);
+
+PVOID MmGetSystemRoutineAddress (PUNICODE_STRING SystemRoutineName);
+PVOID MmMapIoSpace (PHYSICAL_ADDRESS PhysicalAddress, SIZE_T NumberOfBytes, MEMORY_CACHING_TYPE CacheType);
+VOID MmUnmapIoSpace (PVOID BaseAddress, SIZE_T NumberOfBytes);
+PHYSICAL_ADDRESS MmGetPhysicalAddress (PVOID BaseAddress);
+MM_SYSTEMSIZE MmQuerySystemSize (VOID);
+
+NTSTATUS ObReferenceObjectByHandle (HANDLE Handle, ACCESS_MASK DesiredAccess, POBJECT_TYPE ObjectType, KPROCESSOR_MODE AccessMode, PVOID *Object, PVOID HandleInformation);
+VOID ObDereferenceObject (PVOID Object);
+
+VOID RtlInitUnicodeString (PUNICODE_STRING DestinationString, PCWSTR SourceString);
+BOOLEAN RtlIsNtDdiVersionAvailable (ULONG Version);
+NTSTATUS RtlWriteRegistryValue (ULONG RelativeTo, PCWSTR Path, PCWSTR ValueName, ULONG ValueType, PVOID ValueData, ULONG ValueLength);
+NTSTATUS RtlDeleteRegistryValue (ULONG RelativeTo, PCWSTR Path, PCWSTR ValueName);
+
+#include "hostshim.h"
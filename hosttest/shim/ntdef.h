@@ -0,0 +1,18 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    ntdef.h
+
+Abstract:
+
+    Host build shim for the NT base definitions header.  The kernel header
+    shim already carries every type the sources under test take from it.
+
+--*/
+
+#pragma once
+
+#include "ntddk.h"
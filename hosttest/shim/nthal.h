@@ -0,0 +1,48 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    nthal.h
+
+Abstract:
+
+    Host build shim for the HAL header.  Most of what the sources under test
+    use from it is supplied by the kernel header shim.
+
+    The loader parameter block carries only the fields the sources under
+    test read.  The debugger's physical memory mapping routines are declared
+    here but not implemented by the shim: a test that links code calling
+    them supplies them, along with whatever it places at the physical
+    addresses it hands out.
+
+--*/
+
+#pragma once
+
+#include <ntddk.h>
+
+typedef struct _LOADER_PARAMETER_EXTENSION {
+    ULONG Size;
+    PVOID SMBiosEPSHeader;
+} LOADER_PARAMETER_EXTENSION, *PLOADER_PARAMETER_EXTENSION;
+
+typedef struct _LOADER_PARAMETER_BLOCK {
+    PCHAR LoadOptions;
+    PLOADER_PARAMETER_EXTENSION Extension;
+} LOADER_PARAMETER_BLOCK, *PLOADER_PARAMETER_BLOCK;
+
+PVOID
+KdMapPhysicalMemory64 (
+    __in PHYSICAL_ADDRESS PhysicalAddress,
+    __in ULONG NumberPages,
+    __in BOOLEAN FlushCurrentTLB
+    );
+
+VOID
+KdUnmapVirtualAddress (
+    __in PVOID VirtualAddress,
+    __in ULONG NumberPages,
+    __in BOOLEAN FlushCurrentTLB
+    );
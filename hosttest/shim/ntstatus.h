@@ -0,0 +1,18 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    ntstatus.h
+
+Abstract:
+
+    Host build shim for the status code header.  The status codes the
+    sources under test use are supplied by the kernel header shim.
+
+--*/
+
+#pragma once
+
+#include <ntddk.h>
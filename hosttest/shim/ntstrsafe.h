@@ -0,0 +1,34 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    ntstrsafe.h
+
+Abstract:
+
+    Host build shim for the safe string library.  The Unicode printf only
+    understands the conversions the sources under test use: %ws, %s (a wide
+    string, as in the kernel), %u, %d and %x.
+
+--*/
+
+#pragma once
+
+#include <stdarg.h>
+
+NTSTATUS
+RtlStringCbVPrintfA (
+    PCHAR Destination,
+    SIZE_T DestinationSize,
+    PCSTR Format,
+    va_list ArgumentList
+    );
+
+NTSTATUS
+RtlUnicodeStringPrintf (
+    PUNICODE_STRING DestinationString,
+    PCWSTR Format,
+    ...
+    );
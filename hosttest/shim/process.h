@@ -0,0 +1,18 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    process.h
+
+Abstract:
+
+    Host build shim for the C runtime process header.  The only routine the
+    sources under test use from it is the stack cookie initializer.
+
+--*/
+
+#pragma once
+
+#define __security_init_cookie() ((void)0)
@@ -0,0 +1,66 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    smbios.h
+
+Abstract:
+
+    Host build shim for the SMBIOS header.  The entry point and structure
+    layouts follow the DMTF System Management BIOS Reference Specification
+    and are byte packed, as the firmware lays them out.
+
+--*/
+
+#pragma once
+
+#include <ntddk.h>
+
+#pragma pack(push, 1)
+
+typedef struct _SMBIOS3_EPS_HEADER {
+    UCHAR Signature[5];
+    UCHAR Checksum;
+    UCHAR Length;
+    UCHAR MajorVersion;
+    UCHAR MinorVersion;
+    UCHAR Docrev;
+    UCHAR EntryPointRevision;
+    UCHAR Reserved;
+    ULONG StructureTableMaximumSize;
+    ULONG64 StructureTableAddress;
+} SMBIOS3_EPS_HEADER, *PSMBIOS3_EPS_HEADER;
+
+typedef struct _SMBIOS_STRUCT_HEADER {
+    UCHAR Type;
+    UCHAR Length;
+    USHORT Handle;
+} SMBIOS_STRUCT_HEADER, *PSMBIOS_STRUCT_HEADER;
+
+#define SMBIOS_SYSTEM_INFORMATION 1
+
+typedef struct _SMBIOS_SYSTEM_INFORMATION_STRUCT {
+    UCHAR Type;
+    UCHAR Length;
+    USHORT Handle;
+    UCHAR Manufacturer;
+    UCHAR ProductName;
+    UCHAR Version;
+    UCHAR SerialNumber;
+
+    //
+    // Present when Length > SMBIOS_SYSTEM_INFORMATION_LENGTH_20.
+    //
+
+    UCHAR Uuid[16];
+    UCHAR WakeupType;
+    UCHAR SKUNumber;
+    UCHAR Family;
+} SMBIOS_SYSTEM_INFORMATION_STRUCT, *PSMBIOS_SYSTEM_INFORMATION_STRUCT;
+
+#define SMBIOS_SYSTEM_INFORMATION_LENGTH_20 \
+    FIELD_OFFSET(SMBIOS_SYSTEM_INFORMATION_STRUCT, Uuid)
+
+#pragma pack(pop)
@@ -0,0 +1,67 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    symcrypt.h
+
+Abstract:
+
+    Host build shim for the SymCrypt library header.  Only HMAC-SHA256 is
+    supplied, by a plain implementation in hostsymcrypt.c that follows
+    FIPS 180-4 and RFC 2104.  The expanded key holds the key block already
+    combined with the inner and outer pads.
+
+--*/
+
+#pragma once
+
+#include <ntddk.h>
+
+typedef ULONG SYMCRYPT_ERROR;
+typedef const BYTE *PCBYTE;
+
+#define SYMCRYPT_NO_ERROR 0
+
+#define SYMCRYPT_SHA256_RESULT_SIZE 32
+#define SYMCRYPT_SHA256_INPUT_BLOCK_SIZE 64
+#define SYMCRYPT_HMAC_SHA256_RESULT_SIZE SYMCRYPT_SHA256_RESULT_SIZE
+
+typedef struct _SYMCRYPT_HMAC_SHA256_EXPANDED_KEY {
+    BYTE InnerBlock[SYMCRYPT_SHA256_INPUT_BLOCK_SIZE];
+    BYTE OuterBlock[SYMCRYPT_SHA256_INPUT_BLOCK_SIZE];
+} SYMCRYPT_HMAC_SHA256_EXPANDED_KEY, *PSYMCRYPT_HMAC_SHA256_EXPANDED_KEY;
+
+typedef const SYMCRYPT_HMAC_SHA256_EXPANDED_KEY
+    *PCSYMCRYPT_HMAC_SHA256_EXPANDED_KEY;
+
+VOID
+SymCryptSha256 (
+    __in_bcount(cbData) PCBYTE pbData,
+    __in SIZE_T cbData,
+    __out_bcount(SYMCRYPT_SHA256_RESULT_SIZE) PBYTE pbResult
+    );
+
+SYMCRYPT_ERROR
+SymCryptHmacSha256ExpandKey (
+    __out PSYMCRYPT_HMAC_SHA256_EXPANDED_KEY pExpandedKey,
+    __in_bcount(cbKey) PCBYTE pbKey,
+    __in SIZE_T cbKey
+    );
+
+VOID
+SymCryptHmacSha256 (
+    __in PCSYMCRYPT_HMAC_SHA256_EXPANDED_KEY pExpandedKey,
+    __in_bcount(cbData) PCBYTE pbData,
+    __in SIZE_T cbData,
+    __out_bcount(SYMCRYPT_HMAC_SHA256_RESULT_SIZE) PBYTE pbResult
+    );
+
+VOID
+SymCryptWipe (
+    __out_bcount(cbData) PVOID pbData,
+    __in SIZE_T cbData
+    );
+
+#define SymCryptWipeKnownSize(pbData, cbData) SymCryptWipe((pbData), (cbData))
@@ -0,0 +1,16 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    tracing.h
+
+Abstract:
+
+    Host build shim for the debug transport tracing header.  The sources
+    under test build without TRACE_DBG_PRINT, so no logging is compiled in.
+
+--*/
+
+#pragma once
@@ -0,0 +1,140 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    uart.h
+
+Abstract:
+
+    Host build shim for the serial port hardware driver interface that the
+    kdserial UART library implements.  It declares the port object, the
+    hardware driver and access tables and the status codes with the layout
+    the kdserial sources expect.
+
+--*/
+
+#pragma once
+
+// ---------------------------------------------------------------- Definitions
+
+#define PORT_DEFAULT_RATE       0x0001
+#define PORT_MODEM_CONTROL      0x0002
+#define PORT_SAVED              0x0004
+#define PORT_MODEMSTATUS        0x0008
+#define PORT_RING_INDICATOR     0x0010
+#define PORT_FORCE_32BIT_IO     0x0020
+
+// ----------------------------------------------------------------- Data Types
+
+typedef enum _UART_STATUS {
+    UartSuccess,
+    UartError,
+    UartNoData,
+    UartNotReady,
+    UartMaximum
+} UART_STATUS, *PUART_STATUS;
+
+typedef struct _CPPORT CPPORT, *PCPPORT;
+
+typedef
+VOID
+(*UART_HARDWARE_WRITE_INDEXED_UCHAR) (
+    _In_ PCPPORT Port,
+    const UCHAR Index,
+    const UCHAR Value
+    );
+
+typedef
+UCHAR
+(*UART_HARDWARE_READ_INDEXED_UCHAR) (
+    _In_ PCPPORT Port,
+    const UCHAR Index
+    );
+
+struct _CPPORT {
+    PUCHAR Address;
+    ULONG BaudRate;
+    USHORT Flags;
+    UCHAR ByteWidth;
+    UART_HARDWARE_READ_INDEXED_UCHAR Read;
+    UART_HARDWARE_WRITE_INDEXED_UCHAR Write;
+};
+
+typedef
+BOOLEAN
+(*UART_INITIALIZE_PORT) (
+    _In_opt_ _Null_terminated_ PCHAR LoadOptions,
+    _Inout_ PCPPORT Port,
+    BOOLEAN MemoryMapped,
+    UCHAR AccessSize,
+    UCHAR BitWidth
+    );
+
+typedef
+BOOLEAN
+(*UART_SET_BAUD) (
+    _Inout_ PCPPORT Port,
+    ULONG Rate
+    );
+
+typedef
+UART_STATUS
+(*UART_GET_BYTE) (
+    _Inout_ PCPPORT Port,
+    _Out_ PUCHAR Byte
+    );
+
+typedef
+UART_STATUS
+(*UART_PUT_BYTE) (
+    _Inout_ PCPPORT Port,
+    UCHAR Byte,
+    BOOLEAN BusyWait
+    );
+
+typedef
+BOOLEAN
+(*UART_RX_READY) (
+    _Inout_ PCPPORT Port
+    );
+
+typedef
+VOID
+(*UART_SET_POWER_D0) (
+    _Inout_ PCPPORT Port
+    );
+
+typedef
+VOID
+(*UART_SET_POWER_D3) (
+    _Inout_ PCPPORT Port
+    );
+
+typedef struct _UART_HARDWARE_DRIVER {
+    UART_INITIALIZE_PORT InitializePort;
+    UART_SET_BAUD SetBaud;
+    UART_GET_BYTE GetByte;
+    UART_PUT_BYTE PutByte;
+    UART_RX_READY RxReady;
+    UART_SET_POWER_D0 SetPowerD0;
+    UART_SET_POWER_D3 SetPowerD3;
+} UART_HARDWARE_DRIVER, *PUART_HARDWARE_DRIVER;
+
+typedef struct _UART_HARDWARE_ACCESS {
+    UCHAR (*ReadPort8) (PUCHAR Port);
+    VOID (*WritePort8) (PUCHAR Port, UCHAR Value);
+    USHORT (*ReadPort16) (PUSHORT Port);
+    VOID (*WritePort16) (PUSHORT Port, USHORT Value);
+    ULONG (*ReadPort32) (PULONG Port);
+    VOID (*WritePort32) (PULONG Port, ULONG Value);
+    UCHAR (*ReadRegister8) (volatile UCHAR *Register);
+    VOID (*WriteRegister8) (volatile UCHAR *Register, UCHAR Value);
+    USHORT (*ReadRegister16) (volatile USHORT *Register);
+    VOID (*WriteRegister16) (volatile USHORT *Register, USHORT Value);
+    ULONG (*ReadRegister32) (volatile ULONG *Register);
+    VOID (*WriteRegister32) (volatile ULONG *Register, ULONG Value);
+    ULONG64 (*ReadRegister64) (volatile ULONG64 *Register);
+    VOID (*WriteRegister64) (volatile ULONG64 *Register, ULONG64 Value);
+} UART_HARDWARE_ACCESS, *PUART_HARDWARE_ACCESS;
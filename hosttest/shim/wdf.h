@@ -0,0 +1,1429 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    wdf.h
+
+Abstract:
+
+    Host build shim for the subset of the Kernel-Mode Driver Framework used
+    by the serial driver.
+
+    Every framework handle is a pointer to a host object (see hostwdf.c),
+    so the handle types are interchangeable here even though the real
+    headers keep them distinct.  Configuration structures carry the fields
+    the driver touches, under their real names, and the _INIT routines set
+    the same defaults as the framework.
+
+--*/
+
+#pragma once
+
+typedef struct _HOST_WDF_OBJECT *WDFOBJECT, **PWDFOBJECT;
+typedef WDFOBJECT WDFDRIVER, *PWDFDRIVER;
+typedef WDFOBJECT WDFDEVICE, *PWDFDEVICE;
+typedef WDFOBJECT WDFQUEUE, *PWDFQUEUE;
+typedef WDFOBJECT WDFREQUEST, *PWDFREQUEST;
+typedef WDFOBJECT WDFINTERRUPT, *PWDFINTERRUPT;
+typedef WDFOBJECT WDFDPC, *PWDFDPC;
+typedef WDFOBJECT WDFTIMER, *PWDFTIMER;
+typedef WDFOBJECT WDFKEY, *PWDFKEY;
+typedef WDFOBJECT WDFSTRING, *PWDFSTRING;
+typedef WDFOBJECT WDFWAITLOCK, *PWDFWAITLOCK;
+typedef WDFOBJECT WDFWMIINSTANCE, *PWDFWMIINSTANCE;
+typedef WDFOBJECT WDFFILEOBJECT, *PWDFFILEOBJECT;
+typedef WDFOBJECT WDFCMRESLIST, *PWDFCMRESLIST;
+typedef PVOID WDFCONTEXT;
+
+typedef struct _WDFDEVICE_INIT WDFDEVICE_INIT, *PWDFDEVICE_INIT;
+
+typedef enum _WDF_TRI_STATE {
+    WdfFalse = FALSE,
+    WdfTrue = TRUE,
+    WdfUseDefault = 2,
+} WDF_TRI_STATE;
+
+#define WDF_NO_OBJECT_ATTRIBUTES NULL
+#define WDF_NO_EVENT_CALLBACK NULL
+#define WDF_NO_HANDLE NULL
+#define WDF_NO_CONTEXT NULL
+
+#define WDF_REL_TIMEOUT_IN_MS(Time) ((LONGLONG)(Time) * -10000)
+
+//
+// Object attributes and typed contexts.
+//
+
+typedef enum _WDF_EXECUTION_LEVEL {
+    WdfExecutionLevelInvalid = 0,
+    WdfExecutionLevelInheritFromParent,
+    WdfExecutionLevelPassive,
+    WdfExecutionLevelDispatch,
+} WDF_EXECUTION_LEVEL;
+
+typedef enum _WDF_SYNCHRONIZATION_SCOPE {
+    WdfSynchronizationScopeInvalid = 0,
+    WdfSynchronizationScopeInheritFromParent,
+    WdfSynchronizationScopeDevice,
+    WdfSynchronizationScopeQueue,
+    WdfSynchronizationScopeNone,
+} WDF_SYNCHRONIZATION_SCOPE;
+
+typedef struct _WDF_OBJECT_CONTEXT_TYPE_INFO {
+    ULONG Size;
+    PCSTR ContextName;
+    size_t ContextSize;
+} WDF_OBJECT_CONTEXT_TYPE_INFO, *PWDF_OBJECT_CONTEXT_TYPE_INFO;
+
+typedef const WDF_OBJECT_CONTEXT_TYPE_INFO *PCWDF_OBJECT_CONTEXT_TYPE_INFO;
+
+typedef
+VOID
+EVT_WDF_OBJECT_CONTEXT_CLEANUP (
+    __in WDFOBJECT Object
+    );
+
+typedef EVT_WDF_OBJECT_CONTEXT_CLEANUP *PFN_WDF_OBJECT_CONTEXT_CLEANUP;
+typedef EVT_WDF_OBJECT_CONTEXT_CLEANUP EVT_WDF_OBJECT_CONTEXT_DESTROY;
+typedef EVT_WDF_OBJECT_CONTEXT_DESTROY *PFN_WDF_OBJECT_CONTEXT_DESTROY;
+typedef EVT_WDF_OBJECT_CONTEXT_CLEANUP EVT_WDF_DEVICE_CONTEXT_CLEANUP;
+
+typedef struct _WDF_OBJECT_ATTRIBUTES {
+    ULONG Size;
+    PFN_WDF_OBJECT_CONTEXT_CLEANUP EvtCleanupCallback;
+    PFN_WDF_OBJECT_CONTEXT_DESTROY EvtDestroyCallback;
+    WDF_EXECUTION_LEVEL ExecutionLevel;
+    WDF_SYNCHRONIZATION_SCOPE SynchronizationScope;
+    WDFOBJECT ParentObject;
+    size_t ContextSizeOverride;
+    PCWDF_OBJECT_CONTEXT_TYPE_INFO ContextTypeInfo;
+} WDF_OBJECT_ATTRIBUTES, *PWDF_OBJECT_ATTRIBUTES;
+
+FORCEINLINE
+VOID
+WDF_OBJECT_ATTRIBUTES_INIT (
+    __out PWDF_OBJECT_ATTRIBUTES Attributes
+    )
+{
+    RtlZeroMemory(Attributes, sizeof(WDF_OBJECT_ATTRIBUTES));
+    Attributes->Size = sizeof(WDF_OBJECT_ATTRIBUTES);
+    Attributes->ExecutionLevel = WdfExecutionLevelInheritFromParent;
+    Attributes->SynchronizationScope = WdfSynchronizationScopeInheritFromParent;
+}
+
+#define WDF_GET_CONTEXT_TYPE_INFO(_contexttype) \
+    (&_WDF_ ## _contexttype ## _TYPE_INFO)
+
+#define WDF_OBJECT_ATTRIBUTES_INIT_CONTEXT_TYPE(_attributes, _contexttype) \
+    WDF_OBJECT_ATTRIBUTES_INIT(_attributes);                                \
+    (_attributes)->ContextTypeInfo = WDF_GET_CONTEXT_TYPE_INFO(_contexttype)
+
+PVOID
+WdfObjectGetTypedContextWorker (
+    __in WDFOBJECT Handle,
+    __in PCWDF_OBJECT_CONTEXT_TYPE_INFO TypeInfo
+    );
+
+#define WDF_DECLARE_CONTEXT_TYPE_WITH_NAME(_contexttype, _castingfunction)  \
+    static const WDF_OBJECT_CONTEXT_TYPE_INFO                               \
+    _WDF_ ## _contexttype ## _TYPE_INFO __attribute__((unused)) = {         \
+        sizeof(WDF_OBJECT_CONTEXT_TYPE_INFO),                               \
+        #_contexttype,                                                      \
+        sizeof(_contexttype),                                               \
+    };                                                                      \
+                                                                            \
+    __attribute__((unused))                                                 \
+    static inline _contexttype *                                            \
+    _castingfunction (                                                      \
+        __in WDFOBJECT Handle                                               \
+        )                                                                   \
+    {                                                                       \
+        return (_contexttype *)WdfObjectGetTypedContextWorker(              \
+            Handle, WDF_GET_CONTEXT_TYPE_INFO(_contexttype));               \
+    }
+
+NTSTATUS
+WdfObjectAllocateContext (
+    __in WDFOBJECT Handle,
+    __in PWDF_OBJECT_ATTRIBUTES ContextAttributes,
+    __out_opt PVOID *Context
+    );
+
+VOID
+WdfObjectDelete (
+    __in WDFOBJECT Object
+    );
+
+VOID
+WdfObjectAcquireLock (
+    __in WDFOBJECT Object
+    );
+
+VOID
+WdfObjectReleaseLock (
+    __in WDFOBJECT Object
+    );
+
+//
+// Driver.
+//
+
+typedef
+NTSTATUS
+EVT_WDF_DRIVER_DEVICE_ADD (
+    __in WDFDRIVER Driver,
+    __inout PWDFDEVICE_INIT DeviceInit
+    );
+
+typedef EVT_WDF_DRIVER_DEVICE_ADD *PFN_WDF_DRIVER_DEVICE_ADD;
+
+typedef struct _WDF_DRIVER_CONFIG {
+    ULONG Size;
+    PFN_WDF_DRIVER_DEVICE_ADD EvtDriverDeviceAdd;
+    PVOID EvtDriverUnload;
+    ULONG DriverInitFlags;
+    ULONG DriverPoolTag;
+} WDF_DRIVER_CONFIG, *PWDF_DRIVER_CONFIG;
+
+FORCEINLINE
+VOID
+WDF_DRIVER_CONFIG_INIT (
+    __out PWDF_DRIVER_CONFIG Config,
+    __in_opt PFN_WDF_DRIVER_DEVICE_ADD EvtDriverDeviceAdd
+    )
+{
+    RtlZeroMemory(Config, sizeof(WDF_DRIVER_CONFIG));
+    Config->Size = sizeof(WDF_DRIVER_CONFIG);
+    Config->EvtDriverDeviceAdd = EvtDriverDeviceAdd;
+}
+
+NTSTATUS
+WdfDriverCreate (
+    __in PDRIVER_OBJECT DriverObject,
+    __in PCUNICODE_STRING RegistryPath,
+    __in_opt PWDF_OBJECT_ATTRIBUTES DriverAttributes,
+    __in PWDF_DRIVER_CONFIG DriverConfig,
+    __out_opt WDFDRIVER *Driver
+    );
+
+PDRIVER_OBJECT
+WdfDriverWdmGetDriverObject (
+    __in WDFDRIVER Driver
+    );
+
+NTSTATUS
+WdfDriverOpenParametersRegistryKey (
+    __in WDFDRIVER Driver,
+    __in ACCESS_MASK DesiredAccess,
+    __in_opt PWDF_OBJECT_ATTRIBUTES KeyAttributes,
+    __out WDFKEY *Key
+    );
+
+//
+// Device initialization and creation.
+//
+
+typedef enum _WDF_POWER_DEVICE_STATE {
+    WdfPowerDeviceInvalid = 0,
+    WdfPowerDeviceD0,
+    WdfPowerDeviceD1,
+    WdfPowerDeviceD2,
+    WdfPowerDeviceD3,
+    WdfPowerDeviceD3Final,
+    WdfPowerDevicePrepareForHibernation,
+    WdfPowerDeviceMaximum,
+} WDF_POWER_DEVICE_STATE;
+
+typedef
+NTSTATUS
+EVT_WDF_DEVICE_D0_ENTRY (
+    __in WDFDEVICE Device,
+    __in WDF_POWER_DEVICE_STATE PreviousState
+    );
+
+typedef EVT_WDF_DEVICE_D0_ENTRY *PFN_WDF_DEVICE_D0_ENTRY;
+
+typedef
+NTSTATUS
+EVT_WDF_DEVICE_D0_ENTRY_POST_INTERRUPTS_ENABLED (
+    __in WDFDEVICE Device,
+    __in WDF_POWER_DEVICE_STATE PreviousState
+    );
+
+typedef EVT_WDF_DEVICE_D0_ENTRY_POST_INTERRUPTS_ENABLED
+    *PFN_WDF_DEVICE_D0_ENTRY_POST_INTERRUPTS_ENABLED;
+
+typedef
+NTSTATUS
+EVT_WDF_DEVICE_D0_EXIT (
+    __in WDFDEVICE Device,
+    __in WDF_POWER_DEVICE_STATE TargetState
+    );
+
+typedef EVT_WDF_DEVICE_D0_EXIT *PFN_WDF_DEVICE_D0_EXIT;
+
+typedef
+NTSTATUS
+EVT_WDF_DEVICE_D0_EXIT_PRE_INTERRUPTS_DISABLED (
+    __in WDFDEVICE Device,
+    __in WDF_POWER_DEVICE_STATE TargetState
+    );
+
+typedef EVT_WDF_DEVICE_D0_EXIT_PRE_INTERRUPTS_DISABLED
+    *PFN_WDF_DEVICE_D0_EXIT_PRE_INTERRUPTS_DISABLED;
+
+typedef
+NTSTATUS
+EVT_WDF_DEVICE_PREPARE_HARDWARE (
+    __in WDFDEVICE Device,
+    __in WDFCMRESLIST ResourcesRaw,
+    __in WDFCMRESLIST ResourcesTranslated
+    );
+
+typedef EVT_WDF_DEVICE_PREPARE_HARDWARE *PFN_WDF_DEVICE_PREPARE_HARDWARE;
+
+typedef
+NTSTATUS
+EVT_WDF_DEVICE_RELEASE_HARDWARE (
+    __in WDFDEVICE Device,
+    __in WDFCMRESLIST ResourcesTranslated
+    );
+
+typedef EVT_WDF_DEVICE_RELEASE_HARDWARE *PFN_WDF_DEVICE_RELEASE_HARDWARE;
+
+typedef struct _WDF_PNPPOWER_EVENT_CALLBACKS {
+    ULONG Size;
+    PFN_WDF_DEVICE_D0_ENTRY EvtDeviceD0Entry;
+    PFN_WDF_DEVICE_D0_ENTRY_POST_INTERRUPTS_ENABLED
+        EvtDeviceD0EntryPostInterruptsEnabled;
+    PFN_WDF_DEVICE_D0_EXIT EvtDeviceD0Exit;
+    PFN_WDF_DEVICE_D0_EXIT_PRE_INTERRUPTS_DISABLED
+        EvtDeviceD0ExitPreInterruptsDisabled;
+    PFN_WDF_DEVICE_PREPARE_HARDWARE EvtDevicePrepareHardware;
+    PFN_WDF_DEVICE_RELEASE_HARDWARE EvtDeviceReleaseHardware;
+} WDF_PNPPOWER_EVENT_CALLBACKS, *PWDF_PNPPOWER_EVENT_CALLBACKS;
+
+FORCEINLINE
+VOID
+WDF_PNPPOWER_EVENT_CALLBACKS_INIT (
+    __out PWDF_PNPPOWER_EVENT_CALLBACKS Callbacks
+    )
+{
+    RtlZeroMemory(Callbacks, sizeof(WDF_PNPPOWER_EVENT_CALLBACKS));
+    Callbacks->Size = sizeof(WDF_PNPPOWER_EVENT_CALLBACKS);
+}
+
+typedef struct _WDF_POWER_POLICY_EVENT_CALLBACKS {
+    ULONG Size;
+    PVOID EvtDeviceArmWakeFromS0;
+    PVOID EvtDeviceDisarmWakeFromS0;
+    PVOID EvtDeviceWakeFromS0Triggered;
+    PVOID EvtDeviceArmWakeFromSx;
+    PVOID EvtDeviceDisarmWakeFromSx;
+    PVOID EvtDeviceWakeFromSxTriggered;
+} WDF_POWER_POLICY_EVENT_CALLBACKS, *PWDF_POWER_POLICY_EVENT_CALLBACKS;
+
+FORCEINLINE
+VOID
+WDF_POWER_POLICY_EVENT_CALLBACKS_INIT (
+    __out PWDF_POWER_POLICY_EVENT_CALLBACKS Callbacks
+    )
+{
+    RtlZeroMemory(Callbacks, sizeof(WDF_POWER_POLICY_EVENT_CALLBACKS));
+    Callbacks->Size = sizeof(WDF_POWER_POLICY_EVENT_CALLBACKS);
+}
+
+typedef enum _WDF_POWER_POLICY_S0_IDLE_CAPABILITIES {
+    IdleCapsInvalid = 0,
+    IdleCannotWakeFromS0,
+    IdleCanWakeFromS0,
+    IdleUsbSelectiveSuspend,
+} WDF_POWER_POLICY_S0_IDLE_CAPABILITIES;
+
+typedef enum _WDF_POWER_POLICY_S0_IDLE_USER_CONTROL {
+    IdleUserControlInvalid = 0,
+    IdleDoNotAllowUserControl,
+    IdleAllowUserControl,
+} WDF_POWER_POLICY_S0_IDLE_USER_CONTROL;
+
+typedef struct _WDF_DEVICE_POWER_POLICY_IDLE_SETTINGS {
+    ULONG Size;
+    WDF_POWER_POLICY_S0_IDLE_CAPABILITIES IdleCaps;
+    DEVICE_POWER_STATE DxState;
+    ULONG IdleTimeout;
+    WDF_POWER_POLICY_S0_IDLE_USER_CONTROL UserControlOfIdleSettings;
+    WDF_TRI_STATE Enabled;
+} WDF_DEVICE_POWER_POLICY_IDLE_SETTINGS,
+    *PWDF_DEVICE_POWER_POLICY_IDLE_SETTINGS;
+
+FORCEINLINE
+VOID
+WDF_DEVICE_POWER_POLICY_IDLE_SETTINGS_INIT (
+    __out PWDF_DEVICE_POWER_POLICY_IDLE_SETTINGS Settings,
+    __in WDF_POWER_POLICY_S0_IDLE_CAPABILITIES IdleCaps
+    )
+{
+    RtlZeroMemory(Settings, sizeof(WDF_DEVICE_POWER_POLICY_IDLE_SETTINGS));
+    Settings->Size = sizeof(WDF_DEVICE_POWER_POLICY_IDLE_SETTINGS);
+    Settings->IdleCaps = IdleCaps;
+    Settings->IdleTimeout = 0;
+    Settings->UserControlOfIdleSettings = IdleAllowUserControl;
+    Settings->Enabled = WdfUseDefault;
+}
+
+typedef struct _WDF_DEVICE_POWER_POLICY_WAKE_SETTINGS {
+    ULONG Size;
+    DEVICE_POWER_STATE DxState;
+    WDF_POWER_POLICY_S0_IDLE_USER_CONTROL UserControlOfWakeSettings;
+    WDF_TRI_STATE Enabled;
+} WDF_DEVICE_POWER_POLICY_WAKE_SETTINGS,
+    *PWDF_DEVICE_POWER_POLICY_WAKE_SETTINGS;
+
+FORCEINLINE
+VOID
+WDF_DEVICE_POWER_POLICY_WAKE_SETTINGS_INIT (
+    __out PWDF_DEVICE_POWER_POLICY_WAKE_SETTINGS Settings
+    )
+{
+    RtlZeroMemory(Settings, sizeof(WDF_DEVICE_POWER_POLICY_WAKE_SETTINGS));
+    Settings->Size = sizeof(WDF_DEVICE_POWER_POLICY_WAKE_SETTINGS);
+    Settings->Enabled = WdfUseDefault;
+}
+
+typedef enum _WDF_DEVICE_FAILED_ACTION {
+    WdfDeviceFailedUndefined = 0,
+    WdfDeviceFailedAttemptRestart,
+    WdfDeviceFailedNoRestart,
+} WDF_DEVICE_FAILED_ACTION;
+
+typedef struct _WDF_FILEOBJECT_CONFIG WDF_FILEOBJECT_CONFIG,
+    *PWDF_FILEOBJECT_CONFIG;
+
+typedef
+VOID
+EVT_WDF_DEVICE_FILE_CREATE (
+    __in WDFDEVICE Device,
+    __in WDFREQUEST Request,
+    __in WDFFILEOBJECT FileObject
+    );
+
+typedef EVT_WDF_DEVICE_FILE_CREATE *PFN_WDF_DEVICE_FILE_CREATE;
+
+typedef
+VOID
+EVT_WDF_FILE_CLOSE (
+    __in WDFFILEOBJECT FileObject
+    );
+
+typedef EVT_WDF_FILE_CLOSE *PFN_WDF_FILE_CLOSE;
+
+typedef
+VOID
+EVT_WDF_FILE_CLEANUP (
+    __in WDFFILEOBJECT FileObject
+    );
+
+typedef EVT_WDF_FILE_CLEANUP *PFN_WDF_FILE_CLEANUP;
+
+struct _WDF_FILEOBJECT_CONFIG {
+    ULONG Size;
+    PFN_WDF_DEVICE_FILE_CREATE EvtDeviceFileCreate;
+    PFN_WDF_FILE_CLOSE EvtFileClose;
+    PFN_WDF_FILE_CLEANUP EvtFileCleanup;
+    WDF_TRI_STATE AutoForwardCleanupClose;
+};
+
+FORCEINLINE
+VOID
+WDF_FILEOBJECT_CONFIG_INIT (
+    __out PWDF_FILEOBJECT_CONFIG FileEventCallbacks,
+    __in_opt PFN_WDF_DEVICE_FILE_CREATE EvtDeviceFileCreate,
+    __in_opt PFN_WDF_FILE_CLOSE EvtFileClose,
+    __in_opt PFN_WDF_FILE_CLEANUP EvtFileCleanup
+    )
+{
+    RtlZeroMemory(FileEventCallbacks, sizeof(WDF_FILEOBJECT_CONFIG));
+    FileEventCallbacks->Size = sizeof(WDF_FILEOBJECT_CONFIG);
+    FileEventCallbacks->EvtDeviceFileCreate = EvtDeviceFileCreate;
+    FileEventCallbacks->EvtFileClose = EvtFileClose;
+    FileEventCallbacks->EvtFileCleanup = EvtFileCleanup;
+    FileEventCallbacks->AutoForwardCleanupClose = WdfUseDefault;
+}
+
+typedef
+NTSTATUS
+EVT_WDFDEVICE_WDM_IRP_PREPROCESS (
+    __in WDFDEVICE Device,
+    __inout PIRP Irp
+    );
+
+typedef EVT_WDFDEVICE_WDM_IRP_PREPROCESS *PFN_WDFDEVICE_WDM_IRP_PREPROCESS;
+
+typedef
+VOID
+EVT_WDF_IO_IN_CALLER_CONTEXT (
+    __in WDFDEVICE Device,
+    __in WDFREQUEST Request
+    );
+
+typedef EVT_WDF_IO_IN_CALLER_CONTEXT *PFN_WDF_IO_IN_CALLER_CONTEXT;
+
+NTSTATUS
+WdfDeviceInitAssignName (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in_opt PCUNICODE_STRING DeviceName
+    );
+
+VOID
+WdfDeviceInitSetExclusive (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in BOOLEAN IsExclusive
+    );
+
+VOID
+WdfDeviceInitSetDeviceType (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in ULONG DeviceType
+    );
+
+VOID
+WdfDeviceInitSetRequestAttributes (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PWDF_OBJECT_ATTRIBUTES RequestAttributes
+    );
+
+VOID
+WdfDeviceInitSetIoInCallerContextCallback (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PFN_WDF_IO_IN_CALLER_CONTEXT EvtIoInCallerContext
+    );
+
+VOID
+WdfDeviceInitSetPnpPowerEventCallbacks (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PWDF_PNPPOWER_EVENT_CALLBACKS PnpPowerEventCallbacks
+    );
+
+VOID
+WdfDeviceInitSetPowerPolicyOwnership (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in BOOLEAN IsPowerPolicyOwner
+    );
+
+VOID
+WdfDeviceInitSetFileObjectConfig (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PWDF_FILEOBJECT_CONFIG FileObjectConfig,
+    __in_opt PWDF_OBJECT_ATTRIBUTES FileObjectAttributes
+    );
+
+NTSTATUS
+WdfDeviceInitAssignWdmIrpPreprocessCallback (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in PFN_WDFDEVICE_WDM_IRP_PREPROCESS EvtDeviceWdmIrpPreprocess,
+    __in UCHAR MajorFunction,
+    __in_opt PUCHAR MinorFunctions,
+    __in ULONG NumMinorFunctions
+    );
+
+NTSTATUS
+WdfFdoInitOpenRegistryKey (
+    __in PWDFDEVICE_INIT DeviceInit,
+    __in ULONG DeviceInstanceKeyType,
+    __in ACCESS_MASK DesiredAccess,
+    __in_opt PWDF_OBJECT_ATTRIBUTES KeyAttributes,
+    __out WDFKEY *Key
+    );
+
+NTSTATUS
+WdfDeviceCreate (
+    __inout PWDFDEVICE_INIT *DeviceInit,
+    __in_opt PWDF_OBJECT_ATTRIBUTES DeviceAttributes,
+    __out WDFDEVICE *Device
+    );
+
+PDEVICE_OBJECT
+WdfDeviceWdmGetDeviceObject (
+    __in WDFDEVICE Device
+    );
+
+PDEVICE_OBJECT
+WdfDeviceWdmGetAttachedDevice (
+    __in WDFDEVICE Device
+    );
+
+PDEVICE_OBJECT
+WdfDeviceWdmGetPhysicalDevice (
+    __in WDFDEVICE Device
+    );
+
+NTSTATUS
+WdfDeviceAssignS0IdleSettings (
+    __in WDFDEVICE Device,
+    __in PWDF_DEVICE_POWER_POLICY_IDLE_SETTINGS Settings
+    );
+
+NTSTATUS
+WdfDeviceAssignSxWakeSettings (
+    __in WDFDEVICE Device,
+    __in PWDF_DEVICE_POWER_POLICY_WAKE_SETTINGS Settings
+    );
+
+NTSTATUS
+WdfDeviceSetPowerPolicyEventCallbacks (
+    __in WDFDEVICE Device,
+    __in PWDF_POWER_POLICY_EVENT_CALLBACKS Callbacks
+    );
+
+NTSTATUS
+WdfDeviceStopIdle (
+    __in WDFDEVICE Device,
+    __in BOOLEAN WaitForD0
+    );
+
+VOID
+WdfDeviceResumeIdle (
+    __in WDFDEVICE Device
+    );
+
+VOID
+WdfDeviceSetStaticStopRemove (
+    __in WDFDEVICE Device,
+    __in BOOLEAN Stoppable
+    );
+
+VOID
+WdfDeviceSetFailed (
+    __in WDFDEVICE Device,
+    __in WDF_DEVICE_FAILED_ACTION FailedAction
+    );
+
+NTSTATUS
+WdfDeviceOpenRegistryKey (
+    __in WDFDEVICE Device,
+    __in ULONG DeviceInstanceKeyType,
+    __in ACCESS_MASK DesiredAccess,
+    __in_opt PWDF_OBJECT_ATTRIBUTES KeyAttributes,
+    __out WDFKEY *Key
+    );
+
+NTSTATUS
+WdfDeviceRetrieveDeviceName (
+    __in WDFDEVICE Device,
+    __in WDFSTRING String
+    );
+
+NTSTATUS
+WdfDeviceCreateSymbolicLink (
+    __in WDFDEVICE Device,
+    __in PCUNICODE_STRING SymbolicLinkName
+    );
+
+NTSTATUS
+WdfDeviceCreateDeviceInterface (
+    __in WDFDEVICE Device,
+    __in const GUID *InterfaceClassGUID,
+    __in_opt PCUNICODE_STRING ReferenceString
+    );
+
+NTSTATUS
+WdfDeviceEnqueueRequest (
+    __in WDFDEVICE Device,
+    __in WDFREQUEST Request
+    );
+
+WDFDEVICE
+WdfFileObjectGetDevice (
+    __in WDFFILEOBJECT FileObject
+    );
+
+//
+// Resources.
+//
+
+ULONG
+WdfCmResourceListGetCount (
+    __in WDFCMRESLIST List
+    );
+
+PCM_PARTIAL_RESOURCE_DESCRIPTOR
+WdfCmResourceListGetDescriptor (
+    __in WDFCMRESLIST List,
+    __in ULONG Index
+    );
+
+//
+// Registry and strings.
+//
+
+NTSTATUS
+WdfRegistryQueryULong (
+    __in WDFKEY Key,
+    __in PCUNICODE_STRING ValueName,
+    __out PULONG Value
+    );
+
+NTSTATUS
+WdfRegistryAssignULong (
+    __in WDFKEY Key,
+    __in PCUNICODE_STRING ValueName,
+    __in ULONG Value
+    );
+
+NTSTATUS
+WdfRegistryQueryUnicodeString (
+    __in WDFKEY Key,
+    __in PCUNICODE_STRING ValueName,
+    __out_opt PUSHORT ValueByteLength,
+    __inout_opt PUNICODE_STRING Value
+    );
+
+VOID
+WdfRegistryClose (
+    __in WDFKEY Key
+    );
+
+NTSTATUS
+WdfStringCreate (
+    __in_opt PCUNICODE_STRING UnicodeString,
+    __in_opt PWDF_OBJECT_ATTRIBUTES StringAttributes,
+    __out WDFSTRING *String
+    );
+
+VOID
+WdfStringGetUnicodeString (
+    __in WDFSTRING String,
+    __out PUNICODE_STRING UnicodeString
+    );
+
+//
+// Queues and requests.
+//
+
+typedef enum _WDF_IO_QUEUE_DISPATCH_TYPE {
+    WdfIoQueueDispatchInvalid = 0,
+    WdfIoQueueDispatchSequential,
+    WdfIoQueueDispatchParallel,
+    WdfIoQueueDispatchManual,
+    WdfIoQueueDispatchMax,
+} WDF_IO_QUEUE_DISPATCH_TYPE;
+
+typedef enum _WDF_IO_QUEUE_STATE {
+    WdfIoQueueAcceptRequests = 0x01,
+    WdfIoQueueDispatchRequests = 0x02,
+    WdfIoQueueNoRequests = 0x04,
+    WdfIoQueueDriverNoRequests = 0x08,
+    WdfIoQueuePnpHeld = 0x10,
+} WDF_IO_QUEUE_STATE;
+
+FORCEINLINE
+BOOLEAN
+WDF_IO_QUEUE_IDLE (
+    __in WDF_IO_QUEUE_STATE State
+    )
+{
+    return ((State & WdfIoQueueNoRequests) &&
+            (State & WdfIoQueueDriverNoRequests)) ? TRUE : FALSE;
+}
+
+typedef enum _WDF_REQUEST_STOP_ACTION_FLAGS {
+    WdfRequestStopActionInvalid = 0,
+    WdfRequestStopActionSuspend = 0x01,
+    WdfRequestStopActionPurge = 0x2,
+    WdfRequestStopRequestCancelable = 0x10000000,
+} WDF_REQUEST_STOP_ACTION_FLAGS;
+
+typedef
+VOID
+EVT_WDF_IO_QUEUE_IO_READ (
+    __in WDFQUEUE Queue,
+    __in WDFREQUEST Request,
+    __in size_t Length
+    );
+
+typedef EVT_WDF_IO_QUEUE_IO_READ *PFN_WDF_IO_QUEUE_IO_READ;
+
+typedef
+VOID
+EVT_WDF_IO_QUEUE_IO_WRITE (
+    __in WDFQUEUE Queue,
+    __in WDFREQUEST Request,
+    __in size_t Length
+    );
+
+typedef EVT_WDF_IO_QUEUE_IO_WRITE *PFN_WDF_IO_QUEUE_IO_WRITE;
+
+typedef
+VOID
+EVT_WDF_IO_QUEUE_IO_DEVICE_CONTROL (
+    __in WDFQUEUE Queue,
+    __in WDFREQUEST Request,
+    __in size_t OutputBufferLength,
+    __in size_t InputBufferLength,
+    __in ULONG IoControlCode
+    );
+
+typedef EVT_WDF_IO_QUEUE_IO_DEVICE_CONTROL
+    *PFN_WDF_IO_QUEUE_IO_DEVICE_CONTROL;
+
+typedef EVT_WDF_IO_QUEUE_IO_DEVICE_CONTROL
+    EVT_WDF_IO_QUEUE_IO_INTERNAL_DEVICE_CONTROL;
+
+typedef EVT_WDF_IO_QUEUE_IO_INTERNAL_DEVICE_CONTROL
+    *PFN_WDF_IO_QUEUE_IO_INTERNAL_DEVICE_CONTROL;
+
+typedef
+VOID
+EVT_WDF_IO_QUEUE_IO_CANCELED_ON_QUEUE (
+    __in WDFQUEUE Queue,
+    __in WDFREQUEST Request
+    );
+
+typedef EVT_WDF_IO_QUEUE_IO_CANCELED_ON_QUEUE
+    *PFN_WDF_IO_QUEUE_IO_CANCELED_ON_QUEUE;
+
+typedef
+VOID
+EVT_WDF_IO_QUEUE_IO_STOP (
+    __in WDFQUEUE Queue,
+    __in WDFREQUEST Request,
+    __in ULONG ActionFlags
+    );
+
+typedef EVT_WDF_IO_QUEUE_IO_STOP *PFN_WDF_IO_QUEUE_IO_STOP;
+
+typedef
+VOID
+EVT_WDF_IO_QUEUE_IO_RESUME (
+    __in WDFQUEUE Queue,
+    __in WDFREQUEST Request
+    );
+
+typedef EVT_WDF_IO_QUEUE_IO_RESUME *PFN_WDF_IO_QUEUE_IO_RESUME;
+
+typedef struct _WDF_IO_QUEUE_CONFIG {
+    ULONG Size;
+    WDF_IO_QUEUE_DISPATCH_TYPE DispatchType;
+    WDF_TRI_STATE PowerManaged;
+    BOOLEAN AllowZeroLengthRequests;
+    BOOLEAN DefaultQueue;
+    PVOID EvtIoDefault;
+    PFN_WDF_IO_QUEUE_IO_READ EvtIoRead;
+    PFN_WDF_IO_QUEUE_IO_WRITE EvtIoWrite;
+    PFN_WDF_IO_QUEUE_IO_DEVICE_CONTROL EvtIoDeviceControl;
+    PFN_WDF_IO_QUEUE_IO_INTERNAL_DEVICE_CONTROL EvtIoInternalDeviceControl;
+    PFN_WDF_IO_QUEUE_IO_STOP EvtIoStop;
+    PFN_WDF_IO_QUEUE_IO_RESUME EvtIoResume;
+    PFN_WDF_IO_QUEUE_IO_CANCELED_ON_QUEUE EvtIoCanceledOnQueue;
+} WDF_IO_QUEUE_CONFIG, *PWDF_IO_QUEUE_CONFIG;
+
+FORCEINLINE
+VOID
+WDF_IO_QUEUE_CONFIG_INIT (
+    __out PWDF_IO_QUEUE_CONFIG Config,
+    __in WDF_IO_QUEUE_DISPATCH_TYPE DispatchType
+    )
+{
+    RtlZeroMemory(Config, sizeof(WDF_IO_QUEUE_CONFIG));
+    Config->Size = sizeof(WDF_IO_QUEUE_CONFIG);
+    Config->PowerManaged = WdfUseDefault;
+    Config->DispatchType = DispatchType;
+}
+
+FORCEINLINE
+VOID
+WDF_IO_QUEUE_CONFIG_INIT_DEFAULT_QUEUE (
+    __out PWDF_IO_QUEUE_CONFIG Config,
+    __in WDF_IO_QUEUE_DISPATCH_TYPE DispatchType
+    )
+{
+    WDF_IO_QUEUE_CONFIG_INIT(Config, DispatchType);
+    Config->DefaultQueue = TRUE;
+}
+
+typedef enum _WDF_REQUEST_TYPE {
+    WdfRequestTypeCreate = 0x0,
+    WdfRequestTypeClose = 0x2,
+    WdfRequestTypeRead = 0x3,
+    WdfRequestTypeWrite = 0x4,
+    WdfRequestTypeQueryInformation = 0x5,
+    WdfRequestTypeSetInformation = 0x6,
+    WdfRequestTypeFlushBuffers = 0x9,
+    WdfRequestTypeDeviceControl = 0xE,
+    WdfRequestTypeDeviceControlInternal = 0xF,
+    WdfRequestTypeOther = 0x1B,
+} WDF_REQUEST_TYPE;
+
+#define WdfRequestTypeDeviceIoControl WdfRequestTypeDeviceControl
+
+typedef struct _WDF_REQUEST_PARAMETERS {
+    USHORT Size;
+    UCHAR MinorFunction;
+    WDF_REQUEST_TYPE Type;
+    union {
+        struct {
+            size_t Length;
+            ULONG Key;
+            LONGLONG DeviceOffset;
+        } Read;
+
+        struct {
+            size_t Length;
+            ULONG Key;
+            LONGLONG DeviceOffset;
+        } Write;
+
+        struct {
+            size_t OutputBufferLength;
+            size_t InputBufferLength;
+            ULONG IoControlCode;
+            PVOID Type3InputBuffer;
+        } DeviceIoControl;
+    } Parameters;
+} WDF_REQUEST_PARAMETERS, *PWDF_REQUEST_PARAMETERS;
+
+FORCEINLINE
+VOID
+WDF_REQUEST_PARAMETERS_INIT (
+    __out PWDF_REQUEST_PARAMETERS Parameters
+    )
+{
+    RtlZeroMemory(Parameters, sizeof(WDF_REQUEST_PARAMETERS));
+    Parameters->Size = sizeof(WDF_REQUEST_PARAMETERS);
+}
+
+typedef
+VOID
+EVT_WDF_REQUEST_CANCEL (
+    __in WDFREQUEST Request
+    );
+
+typedef EVT_WDF_REQUEST_CANCEL *PFN_WDF_REQUEST_CANCEL;
+
+NTSTATUS
+WdfIoQueueCreate (
+    __in WDFDEVICE Device,
+    __in PWDF_IO_QUEUE_CONFIG Config,
+    __in_opt PWDF_OBJECT_ATTRIBUTES QueueAttributes,
+    __out_opt WDFQUEUE *Queue
+    );
+
+WDFDEVICE
+WdfIoQueueGetDevice (
+    __in WDFQUEUE Queue
+    );
+
+WDF_IO_QUEUE_STATE
+WdfIoQueueGetState (
+    __in WDFQUEUE Queue,
+    __out_opt PULONG QueueRequests,
+    __out_opt PULONG DriverRequests
+    );
+
+typedef
+VOID
+EVT_WDF_IO_QUEUE_STATE (
+    __in WDFQUEUE Queue,
+    __in WDFCONTEXT Context
+    );
+
+typedef EVT_WDF_IO_QUEUE_STATE *PFN_WDF_IO_QUEUE_STATE;
+
+VOID
+WdfIoQueuePurge (
+    __in WDFQUEUE Queue,
+    __in_opt PFN_WDF_IO_QUEUE_STATE PurgeComplete,
+    __in_opt WDFCONTEXT Context
+    );
+
+VOID
+WdfIoQueueStart (
+    __in WDFQUEUE Queue
+    );
+
+VOID
+WdfIoQueueStopSynchronously (
+    __in WDFQUEUE Queue
+    );
+
+NTSTATUS
+WdfIoQueueRetrieveNextRequest (
+    __in WDFQUEUE Queue,
+    __out WDFREQUEST *OutRequest
+    );
+
+NTSTATUS
+WdfRequestForwardToIoQueue (
+    __in WDFREQUEST Request,
+    __in WDFQUEUE DestinationQueue
+    );
+
+WDFQUEUE
+WdfRequestGetIoQueue (
+    __in WDFREQUEST Request
+    );
+
+VOID
+WdfRequestGetParameters (
+    __in WDFREQUEST Request,
+    __out PWDF_REQUEST_PARAMETERS Parameters
+    );
+
+KPROCESSOR_MODE
+WdfRequestGetRequestorMode (
+    __in WDFREQUEST Request
+    );
+
+NTSTATUS
+WdfRequestGetStatus (
+    __in WDFREQUEST Request
+    );
+
+NTSTATUS
+WdfRequestRetrieveInputBuffer (
+    __in WDFREQUEST Request,
+    __in size_t MinimumRequiredLength,
+    __deref_out PVOID *Buffer,
+    __out_opt size_t *Length
+    );
+
+NTSTATUS
+WdfRequestRetrieveOutputBuffer (
+    __in WDFREQUEST Request,
+    __in size_t MinimumRequiredSize,
+    __deref_out PVOID *Buffer,
+    __out_opt size_t *Length
+    );
+
+VOID
+WdfRequestMarkCancelable (
+    __in WDFREQUEST Request,
+    __in PFN_WDF_REQUEST_CANCEL EvtRequestCancel
+    );
+
+NTSTATUS
+WdfRequestUnmarkCancelable (
+    __in WDFREQUEST Request
+    );
+
+VOID
+WdfRequestStopAcknowledge (
+    __in WDFREQUEST Request,
+    __in BOOLEAN Requeue
+    );
+
+VOID
+WdfRequestComplete (
+    __in WDFREQUEST Request,
+    __in NTSTATUS Status
+    );
+
+VOID
+WdfRequestCompleteWithInformation (
+    __in WDFREQUEST Request,
+    __in NTSTATUS Status,
+    __in ULONG_PTR Information
+    );
+
+//
+// Interrupts.
+//
+
+typedef
+BOOLEAN
+EVT_WDF_INTERRUPT_ISR (
+    __in WDFINTERRUPT Interrupt,
+    __in ULONG MessageID
+    );
+
+typedef EVT_WDF_INTERRUPT_ISR *PFN_WDF_INTERRUPT_ISR;
+
+typedef
+VOID
+EVT_WDF_INTERRUPT_DPC (
+    __in WDFINTERRUPT Interrupt,
+    __in WDFOBJECT AssociatedObject
+    );
+
+typedef EVT_WDF_INTERRUPT_DPC *PFN_WDF_INTERRUPT_DPC;
+
+typedef
+NTSTATUS
+EVT_WDF_INTERRUPT_ENABLE (
+    __in WDFINTERRUPT Interrupt,
+    __in WDFDEVICE AssociatedDevice
+    );
+
+typedef EVT_WDF_INTERRUPT_ENABLE *PFN_WDF_INTERRUPT_ENABLE;
+
+typedef
+NTSTATUS
+EVT_WDF_INTERRUPT_DISABLE (
+    __in WDFINTERRUPT Interrupt,
+    __in WDFDEVICE AssociatedDevice
+    );
+
+typedef EVT_WDF_INTERRUPT_DISABLE *PFN_WDF_INTERRUPT_DISABLE;
+
+typedef
+BOOLEAN
+EVT_WDF_INTERRUPT_SYNCHRONIZE (
+    __in WDFINTERRUPT Interrupt,
+    __in WDFCONTEXT Context
+    );
+
+typedef EVT_WDF_INTERRUPT_SYNCHRONIZE *PFN_WDF_INTERRUPT_SYNCHRONIZE;
+
+typedef struct _WDF_INTERRUPT_CONFIG {
+    ULONG Size;
+    WDFOBJECT SpinLock;
+    WDF_TRI_STATE ShareVector;
+    BOOLEAN FloatingSave;
+    BOOLEAN AutomaticSerialization;
+    PFN_WDF_INTERRUPT_ISR EvtInterruptIsr;
+    PFN_WDF_INTERRUPT_DPC EvtInterruptDpc;
+    PFN_WDF_INTERRUPT_ENABLE EvtInterruptEnable;
+    PFN_WDF_INTERRUPT_DISABLE EvtInterruptDisable;
+} WDF_INTERRUPT_CONFIG, *PWDF_INTERRUPT_CONFIG;
+
+FORCEINLINE
+VOID
+WDF_INTERRUPT_CONFIG_INIT (
+    __out PWDF_INTERRUPT_CONFIG Configuration,
+    __in PFN_WDF_INTERRUPT_ISR EvtInterruptIsr,
+    __in_opt PFN_WDF_INTERRUPT_DPC EvtInterruptDpc
+    )
+{
+    RtlZeroMemory(Configuration, sizeof(WDF_INTERRUPT_CONFIG));
+    Configuration->Size = sizeof(WDF_INTERRUPT_CONFIG);
+    Configuration->ShareVector = WdfUseDefault;
+    Configuration->EvtInterruptIsr = EvtInterruptIsr;
+    Configuration->EvtInterruptDpc = EvtInterruptDpc;
+}
+
+typedef struct _WDF_INTERRUPT_INFO {
+    ULONG Size;
+    ULONG64 Reserved1;
+    KAFFINITY TargetProcessorSet;
+    ULONG Reserved2;
+    ULONG MessageNumber;
+    ULONG Vector;
+    KIRQL Irql;
+    KINTERRUPT_MODE Mode;
+    ULONG Polarity;
+    BOOLEAN MessageSignaled;
+    UCHAR ShareDisposition;
+    USHORT Group;
+} WDF_INTERRUPT_INFO, *PWDF_INTERRUPT_INFO;
+
+FORCEINLINE
+VOID
+WDF_INTERRUPT_INFO_INIT (
+    __out PWDF_INTERRUPT_INFO Info
+    )
+{
+    RtlZeroMemory(Info, sizeof(WDF_INTERRUPT_INFO));
+    Info->Size = sizeof(WDF_INTERRUPT_INFO);
+}
+
+typedef enum _WDF_INTERRUPT_POLICY {
+    WdfIrqPolicyMachineDefault = 0,
+    WdfIrqPolicyAllCloseProcessors,
+    WdfIrqPolicyOneCloseProcessor,
+    WdfIrqPolicyAllProcessorsInMachine,
+    WdfIrqPolicySpecifiedProcessors,
+    WdfIrqPolicySpreadMessagesAcrossAllProcessors,
+} WDF_INTERRUPT_POLICY;
+
+typedef enum _WDF_INTERRUPT_PRIORITY {
+    WdfIrqPriorityUndefined = 0,
+    WdfIrqPriorityLow,
+    WdfIrqPriorityNormal,
+    WdfIrqPriorityHigh,
+} WDF_INTERRUPT_PRIORITY;
+
+typedef struct _WDF_INTERRUPT_EXTENDED_POLICY {
+    ULONG Size;
+    WDF_INTERRUPT_POLICY Policy;
+    WDF_INTERRUPT_PRIORITY Priority;
+    GROUP_AFFINITY TargetProcessorSetAndGroup;
+} WDF_INTERRUPT_EXTENDED_POLICY, *PWDF_INTERRUPT_EXTENDED_POLICY;
+
+FORCEINLINE
+VOID
+WDF_INTERRUPT_EXTENDED_POLICY_INIT (
+    __out PWDF_INTERRUPT_EXTENDED_POLICY ExtendedPolicy
+    )
+{
+    RtlZeroMemory(ExtendedPolicy, sizeof(WDF_INTERRUPT_EXTENDED_POLICY));
+    ExtendedPolicy->Size = sizeof(WDF_INTERRUPT_EXTENDED_POLICY);
+    ExtendedPolicy->Policy = WdfIrqPolicyMachineDefault;
+    ExtendedPolicy->Priority = WdfIrqPriorityUndefined;
+}
+
+NTSTATUS
+WdfInterruptCreate (
+    __in WDFDEVICE Device,
+    __in PWDF_INTERRUPT_CONFIG Configuration,
+    __in_opt PWDF_OBJECT_ATTRIBUTES Attributes,
+    __out WDFINTERRUPT *Interrupt
+    );
+
+BOOLEAN
+WdfInterruptSynchronize (
+    __in WDFINTERRUPT Interrupt,
+    __in PFN_WDF_INTERRUPT_SYNCHRONIZE Callback,
+    __in WDFCONTEXT Context
+    );
+
+WDFDEVICE
+WdfInterruptGetDevice (
+    __in WDFINTERRUPT Interrupt
+    );
+
+VOID
+WdfInterruptGetInfo (
+    __in WDFINTERRUPT Interrupt,
+    __out PWDF_INTERRUPT_INFO Info
+    );
+
+VOID
+WdfInterruptSetExtendedPolicy (
+    __in WDFINTERRUPT Interrupt,
+    __in PWDF_INTERRUPT_EXTENDED_POLICY PolicyAndGroup
+    );
+
+//
+// DPCs and timers.
+//
+
+typedef
+VOID
+EVT_WDF_DPC (
+    __in WDFDPC Dpc
+    );
+
+typedef EVT_WDF_DPC *PFN_WDF_DPC;
+
+typedef struct _WDF_DPC_CONFIG {
+    ULONG Size;
+    PFN_WDF_DPC EvtDpcFunc;
+    BOOLEAN AutomaticSerialization;
+} WDF_DPC_CONFIG, *PWDF_DPC_CONFIG;
+
+FORCEINLINE
+VOID
+WDF_DPC_CONFIG_INIT (
+    __out PWDF_DPC_CONFIG Config,
+    __in PFN_WDF_DPC EvtDpcFunc
+    )
+{
+    RtlZeroMemory(Config, sizeof(WDF_DPC_CONFIG));
+    Config->Size = sizeof(WDF_DPC_CONFIG);
+    Config->EvtDpcFunc = EvtDpcFunc;
+    Config->AutomaticSerialization = TRUE;
+}
+
+NTSTATUS
+WdfDpcCreate (
+    __in PWDF_DPC_CONFIG Config,
+    __in PWDF_OBJECT_ATTRIBUTES Attributes,
+    __out WDFDPC *Dpc
+    );
+
+BOOLEAN
+WdfDpcEnqueue (
+    __in WDFDPC Dpc
+    );
+
+BOOLEAN
+WdfDpcCancel (
+    __in WDFDPC Dpc,
+    __in BOOLEAN Wait
+    );
+
+WDFOBJECT
+WdfDpcGetParentObject (
+    __in WDFDPC Dpc
+    );
+
+PKDPC
+WdfDpcWdmGetDpc (
+    __in WDFDPC Dpc
+    );
+
+typedef
+VOID
+EVT_WDF_TIMER (
+    __in WDFTIMER Timer
+    );
+
+typedef EVT_WDF_TIMER *PFN_WDF_TIMER;
+
+typedef struct _WDF_TIMER_CONFIG {
+    ULONG Size;
+    PFN_WDF_TIMER EvtTimerFunc;
+    ULONG Period;
+    BOOLEAN AutomaticSerialization;
+    ULONG TolerableDelay;
+} WDF_TIMER_CONFIG, *PWDF_TIMER_CONFIG;
+
+FORCEINLINE
+VOID
+WDF_TIMER_CONFIG_INIT (
+    __out PWDF_TIMER_CONFIG Config,
+    __in PFN_WDF_TIMER EvtTimerFunc
+    )
+{
+    RtlZeroMemory(Config, sizeof(WDF_TIMER_CONFIG));
+    Config->Size = sizeof(WDF_TIMER_CONFIG);
+    Config->EvtTimerFunc = EvtTimerFunc;
+    Config->AutomaticSerialization = TRUE;
+}
+
+FORCEINLINE
+VOID
+WDF_TIMER_CONFIG_INIT_PERIODIC (
+    __out PWDF_TIMER_CONFIG Config,
+    __in PFN_WDF_TIMER EvtTimerFunc,
+    __in LONG Period
+    )
+{
+    WDF_TIMER_CONFIG_INIT(Config, EvtTimerFunc);
+    Config->Period = Period;
+}
+
+NTSTATUS
+WdfTimerCreate (
+    __in PWDF_TIMER_CONFIG Config,
+    __in PWDF_OBJECT_ATTRIBUTES Attributes,
+    __out WDFTIMER *Timer
+    );
+
+BOOLEAN
+WdfTimerStart (
+    __in WDFTIMER Timer,
+    __in LONGLONG DueTime
+    );
+
+BOOLEAN
+WdfTimerStop (
+    __in WDFTIMER Timer,
+    __in BOOLEAN Wait
+    );
+
+WDFOBJECT
+WdfTimerGetParentObject (
+    __in WDFTIMER Timer
+    );
+
+//
+// Wait locks.
+//
+
+NTSTATUS
+WdfWaitLockCreate (
+    __in_opt PWDF_OBJECT_ATTRIBUTES LockAttributes,
+    __out WDFWAITLOCK *Lock
+    );
+
+NTSTATUS
+WdfWaitLockAcquire (
+    __in WDFWAITLOCK Lock,
+    __in_opt PLONGLONG Timeout
+    );
+
+VOID
+WdfWaitLockRelease (
+    __in WDFWAITLOCK Lock
+    );
+
+//
+// WMI.
+//
+
+typedef
+NTSTATUS
+EVT_WDF_WMI_INSTANCE_QUERY_INSTANCE (
+    __in WDFWMIINSTANCE WmiInstance,
+    __in ULONG OutBufferSize,
+    __out PVOID OutBuffer,
+    __out PULONG BufferUsed
+    );
+
+typedef EVT_WDF_WMI_INSTANCE_QUERY_INSTANCE
+    *PFN_WDF_WMI_INSTANCE_QUERY_INSTANCE;
+
+typedef struct _WDF_WMI_PROVIDER_CONFIG {
+    ULONG Size;
+    GUID Guid;
+    ULONG Flags;
+    ULONG MinInstanceBufferSize;
+} WDF_WMI_PROVIDER_CONFIG, *PWDF_WMI_PROVIDER_CONFIG;
+
+FORCEINLINE
+VOID
+WDF_WMI_PROVIDER_CONFIG_INIT (
+    __out PWDF_WMI_PROVIDER_CONFIG Config,
+    __in const GUID *Guid
+    )
+{
+    RtlZeroMemory(Config, sizeof(WDF_WMI_PROVIDER_CONFIG));
+    Config->Size = sizeof(WDF_WMI_PROVIDER_CONFIG);
+    RtlCopyMemory(&Config->Guid, Guid, sizeof(GUID));
+}
+
+typedef struct _WDF_WMI_INSTANCE_CONFIG {
+    ULONG Size;
+    PVOID Provider;
+    PWDF_WMI_PROVIDER_CONFIG ProviderConfig;
+    BOOLEAN UseContextForQuery;
+    BOOLEAN Register;
+    PFN_WDF_WMI_INSTANCE_QUERY_INSTANCE EvtWmiInstanceQueryInstance;
+} WDF_WMI_INSTANCE_CONFIG, *PWDF_WMI_INSTANCE_CONFIG;
+
+FORCEINLINE
+VOID
+WDF_WMI_INSTANCE_CONFIG_INIT_PROVIDER_CONFIG (
+    __out PWDF_WMI_INSTANCE_CONFIG Config,
+    __in PWDF_WMI_PROVIDER_CONFIG ProviderConfig
+    )
+{
+    RtlZeroMemory(Config, sizeof(WDF_WMI_INSTANCE_CONFIG));
+    Config->Size = sizeof(WDF_WMI_INSTANCE_CONFIG);
+    Config->ProviderConfig = ProviderConfig;
+}
+
+NTSTATUS
+WdfWmiInstanceCreate (
+    __in WDFDEVICE Device,
+    __in PWDF_WMI_INSTANCE_CONFIG InstanceConfig,
+    __in_opt PWDF_OBJECT_ATTRIBUTES InstanceAttributes,
+    __out_opt WDFWMIINSTANCE *Instance
+    );
+
+WDFDEVICE
+WdfWmiInstanceGetDevice (
+    __in WDFWMIINSTANCE WmiInstance
+    );
+
+FORCEINLINE
+NTSTATUS
+WDF_WMI_BUFFER_APPEND_STRING (
+    __out_bcount(BufferLength) PVOID Buffer,
+    __in ULONG BufferLength,
+    __in PCUNICODE_STRING String,
+    __out PULONG RequiredSize
+    )
+{
+    *RequiredSize = String->Length + sizeof(USHORT);
+    if ((Buffer == NULL) || (BufferLength < *RequiredSize)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    *(PUSHORT)Buffer = String->Length;
+    RtlCopyMemory((PUSHORT)Buffer + 1, String->Buffer, String->Length);
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,16 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    wmilib.h
+
+Abstract:
+
+    Host build shim for the WMI library header.  KMDF drivers reach WMI
+    through the framework, so nothing from the library itself is used.
+
+--*/
+
+#pragma once
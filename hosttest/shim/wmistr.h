@@ -0,0 +1,17 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    wmistr.h
+
+Abstract:
+
+    Host build shim for the WMI structure definitions.  The serial driver
+    registers its data blocks through the framework and needs nothing from
+    this header.
+
+--*/
+
+#pragma once
@@ -0,0 +1,674 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    smbiosblobs.h
+
+Abstract:
+
+    SMBIOS structure tables for the SMBIOS MAC address host test, modeled on
+    the tables the named platforms publish: the structure order, the
+    structure types and the string sets follow those platforms, with made up
+    serial numbers and UUIDs.  The expected MAC addresses were derived from
+    the UUIDs outside this test, with an independent HMAC-SHA256
+    implementation.
+
+    Each array is a structure table alone, in the form the kernel exposes it
+    in /sys/firmware/dmi/tables/DMI, ending with the end of table structure.
+    None of them is a capture.  Tables captured from real machines go in
+    captures/ as .bin files, either dmidecode --dump-bin output or a copy of
+    the DMI file, and the test runs every one of them through the same
+    checks.
+
+--*/
+
+#pragma once
+
+//
+// QEMU q35 machine with OVMF firmware.
+//
+
+static const UCHAR SmBiosQ35[] = {
+    0x00, 0x18, 0x00, 0x00, 0x01, 0x02, 0x00, 0xE8, 0x03, 0x00, 0x0B, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0xFF, 0xFF,
+    0x45, 0x46, 0x49, 0x20, 0x44, 0x65, 0x76, 0x65, 0x6C, 0x6F, 0x70, 0x6D,
+    0x65, 0x6E, 0x74, 0x20, 0x4B, 0x69, 0x74, 0x20, 0x49, 0x49, 0x20, 0x2F,
+    0x20, 0x4F, 0x56, 0x4D, 0x46, 0x00, 0x30, 0x2E, 0x30, 0x2E, 0x30, 0x00,
+    0x30, 0x32, 0x2F, 0x30, 0x36, 0x2F, 0x32, 0x30, 0x31, 0x35, 0x00, 0x00,
+    0x01, 0x1B, 0x00, 0x01, 0x01, 0x02, 0x03, 0x00, 0x38, 0x4C, 0x1E, 0x6B,
+    0x0A, 0x5D, 0x27, 0x4F, 0x9C, 0x61, 0x2E, 0x8A, 0x7F, 0x34, 0xD9, 0xB0,
+    0x06, 0x00, 0x00, 0x51, 0x45, 0x4D, 0x55, 0x00, 0x53, 0x74, 0x61, 0x6E,
+    0x64, 0x61, 0x72, 0x64, 0x20, 0x50, 0x43, 0x20, 0x28, 0x51, 0x33, 0x35,
+    0x20, 0x2B, 0x20, 0x49, 0x43, 0x48, 0x39, 0x2C, 0x20, 0x32, 0x30, 0x30,
+    0x39, 0x29, 0x00, 0x70, 0x63, 0x2D, 0x71, 0x33, 0x35, 0x2D, 0x38, 0x2E,
+    0x32, 0x00, 0x00, 0x03, 0x14, 0x00, 0x03, 0x01, 0x01, 0x02, 0x00, 0x00,
+    0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x51,
+    0x45, 0x4D, 0x55, 0x00, 0x70, 0x63, 0x2D, 0x71, 0x33, 0x35, 0x2D, 0x38,
+    0x2E, 0x32, 0x00, 0x00, 0x04, 0x27, 0x00, 0x04, 0x01, 0x03, 0x01, 0xA9,
+    0x06, 0x03, 0x00, 0xFD, 0xFB, 0x8B, 0x07, 0x03, 0x00, 0xD0, 0x07, 0xD0,
+    0x07, 0x00, 0x00, 0x41, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00,
+    0x00, 0x00, 0x01, 0x01, 0x01, 0x02, 0x00, 0x43, 0x50, 0x55, 0x20, 0x30,
+    0x00, 0x51, 0x45, 0x4D, 0x55, 0x00, 0x70, 0x63, 0x2D, 0x71, 0x33, 0x35,
+    0x2D, 0x38, 0x2E, 0x32, 0x00, 0x00, 0x10, 0x0F, 0x00, 0x10, 0x01, 0x03,
+    0x06, 0x00, 0x00, 0x80, 0x00, 0xFE, 0xFF, 0x01, 0x00, 0x00, 0x00, 0x11,
+    0x1F, 0x00, 0x11, 0x00, 0x10, 0xFE, 0xFF, 0x40, 0x00, 0x40, 0x00, 0x00,
+    0x20, 0x09, 0x00, 0x01, 0x00, 0x07, 0x02, 0x00, 0x00, 0x00, 0x00, 0x02,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0x49, 0x4D, 0x4D, 0x20, 0x30,
+    0x00, 0x51, 0x45, 0x4D, 0x55, 0x00, 0x00, 0x13, 0x0F, 0x00, 0x13, 0x00,
+    0x00, 0x00, 0x00, 0xFF, 0xFF, 0x1F, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00,
+    0x20, 0x0B, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x7F, 0x04, 0x00, 0x7F, 0x00, 0x00,
+};
+
+static const UCHAR SmBiosQ35Mac[MAC_ADDRESS_SIZE] = {
+    0xD2, 0x2B, 0xC1, 0xF9, 0xA0, 0xA3
+};
+
+//
+// Hyper-V generation 2 virtual machine.
+//
+
+static const UCHAR SmBiosHyperV[] = {
+    0x00, 0x18, 0x00, 0x00, 0x01, 0x02, 0x00, 0xE8, 0x03, 0x00, 0x0B, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0xFF, 0xFF,
+    0x4D, 0x69, 0x63, 0x72, 0x6F, 0x73, 0x6F, 0x66, 0x74, 0x20, 0x43, 0x6F,
+    0x72, 0x70, 0x6F, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x00, 0x48, 0x79,
+    0x70, 0x65, 0x72, 0x2D, 0x56, 0x20, 0x55, 0x45, 0x46, 0x49, 0x20, 0x52,
+    0x65, 0x6C, 0x65, 0x61, 0x73, 0x65, 0x20, 0x76, 0x34, 0x2E, 0x31, 0x00,
+    0x30, 0x34, 0x2F, 0x30, 0x36, 0x2F, 0x32, 0x30, 0x32, 0x32, 0x00, 0x00,
+    0x01, 0x1B, 0x01, 0x00, 0x01, 0x02, 0x03, 0x04, 0x91, 0x6A, 0x2F, 0x0D,
+    0xC4, 0x83, 0x5B, 0x4E, 0xA7, 0xD2, 0x9F, 0x10, 0xC3, 0xB8, 0xE6, 0x47,
+    0x06, 0x05, 0x06, 0x4D, 0x69, 0x63, 0x72, 0x6F, 0x73, 0x6F, 0x66, 0x74,
+    0x20, 0x43, 0x6F, 0x72, 0x70, 0x6F, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E,
+    0x00, 0x56, 0x69, 0x72, 0x74, 0x75, 0x61, 0x6C, 0x20, 0x4D, 0x61, 0x63,
+    0x68, 0x69, 0x6E, 0x65, 0x00, 0x48, 0x79, 0x70, 0x65, 0x72, 0x2D, 0x56,
+    0x20, 0x55, 0x45, 0x46, 0x49, 0x20, 0x52, 0x65, 0x6C, 0x65, 0x61, 0x73,
+    0x65, 0x20, 0x76, 0x34, 0x2E, 0x31, 0x00, 0x39, 0x38, 0x37, 0x30, 0x2D,
+    0x34, 0x34, 0x36, 0x33, 0x2D, 0x31, 0x38, 0x37, 0x34, 0x2D, 0x36, 0x36,
+    0x30, 0x31, 0x2D, 0x33, 0x32, 0x35, 0x38, 0x2D, 0x32, 0x31, 0x37, 0x31,
+    0x2D, 0x31, 0x37, 0x00, 0x4E, 0x6F, 0x6E, 0x65, 0x00, 0x56, 0x69, 0x72,
+    0x74, 0x75, 0x61, 0x6C, 0x20, 0x4D, 0x61, 0x63, 0x68, 0x69, 0x6E, 0x65,
+    0x00, 0x00, 0x03, 0x14, 0x02, 0x00, 0x01, 0x01, 0x02, 0x00, 0x00, 0x03,
+    0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4D, 0x69,
+    0x63, 0x72, 0x6F, 0x73, 0x6F, 0x66, 0x74, 0x20, 0x43, 0x6F, 0x72, 0x70,
+    0x6F, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x00, 0x48, 0x79, 0x70, 0x65,
+    0x72, 0x2D, 0x56, 0x20, 0x55, 0x45, 0x46, 0x49, 0x20, 0x52, 0x65, 0x6C,
+    0x65, 0x61, 0x73, 0x65, 0x20, 0x76, 0x34, 0x2E, 0x31, 0x00, 0x00, 0x04,
+    0x27, 0x03, 0x00, 0x01, 0x03, 0x01, 0xA9, 0x06, 0x03, 0x00, 0xFD, 0xFB,
+    0x8B, 0x07, 0x03, 0x00, 0xD0, 0x07, 0xD0, 0x07, 0x00, 0x00, 0x41, 0x01,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01,
+    0x02, 0x00, 0x4E, 0x6F, 0x6E, 0x65, 0x00, 0x49, 0x6E, 0x74, 0x65, 0x6C,
+    0x28, 0x52, 0x29, 0x20, 0x43, 0x6F, 0x72, 0x70, 0x6F, 0x72, 0x61, 0x74,
+    0x69, 0x6F, 0x6E, 0x00, 0x49, 0x6E, 0x74, 0x65, 0x6C, 0x28, 0x52, 0x29,
+    0x20, 0x58, 0x65, 0x6F, 0x6E, 0x28, 0x52, 0x29, 0x20, 0x47, 0x6F, 0x6C,
+    0x64, 0x20, 0x36, 0x32, 0x34, 0x38, 0x20, 0x43, 0x50, 0x55, 0x20, 0x40,
+    0x20, 0x32, 0x2E, 0x35, 0x30, 0x47, 0x48, 0x7A, 0x00, 0x00, 0x0B, 0x05,
+    0x04, 0x00, 0x03, 0x5B, 0x4D, 0x53, 0x5F, 0x56, 0x4D, 0x5F, 0x43, 0x45,
+    0x52, 0x54, 0x2F, 0x53, 0x48, 0x41, 0x31, 0x2F, 0x39, 0x62, 0x38, 0x30,
+    0x63, 0x61, 0x30, 0x64, 0x35, 0x64, 0x64, 0x30, 0x36, 0x31, 0x65, 0x63,
+    0x39, 0x64, 0x61, 0x34, 0x65, 0x34, 0x39, 0x34, 0x66, 0x34, 0x63, 0x33,
+    0x66, 0x64, 0x31, 0x31, 0x39, 0x36, 0x32, 0x37, 0x30, 0x63, 0x32, 0x32,
+    0x5D, 0x00, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x00, 0x54,
+    0x6F, 0x20, 0x62, 0x65, 0x20, 0x66, 0x69, 0x6C, 0x6C, 0x65, 0x64, 0x20,
+    0x62, 0x79, 0x20, 0x4F, 0x45, 0x4D, 0x00, 0x00, 0x10, 0x0F, 0x05, 0x00,
+    0x01, 0x03, 0x06, 0x00, 0x00, 0x80, 0x00, 0xFE, 0xFF, 0x01, 0x00, 0x00,
+    0x00, 0x11, 0x1F, 0x06, 0x00, 0x00, 0x10, 0xFE, 0xFF, 0x40, 0x00, 0x40,
+    0x00, 0x00, 0x20, 0x09, 0x00, 0x01, 0x00, 0x07, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4D, 0x30, 0x30, 0x30,
+    0x31, 0x00, 0x4D, 0x69, 0x63, 0x72, 0x6F, 0x73, 0x6F, 0x66, 0x74, 0x20,
+    0x43, 0x6F, 0x72, 0x70, 0x6F, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x00,
+    0x00, 0x13, 0x0F, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x1F,
+    0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x20, 0x0B, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x04, 0x09, 0x00, 0x00,
+    0x00,
+};
+
+static const UCHAR SmBiosHyperVMac[MAC_ADDRESS_SIZE] = {
+    0xCE, 0x85, 0x75, 0xCF, 0xBC, 0x95
+};
+
+//
+// Server firmware that publishes its OEM strings ahead of System Information.
+//
+
+static const UCHAR SmBiosOemStrings[] = {
+    0x00, 0x18, 0x00, 0x00, 0x01, 0x02, 0x00, 0xE8, 0x03, 0x00, 0x0B, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0xFF, 0xFF,
+    0x44, 0x65, 0x6C, 0x6C, 0x20, 0x49, 0x6E, 0x63, 0x2E, 0x00, 0x32, 0x2E,
+    0x31, 0x39, 0x2E, 0x30, 0x00, 0x30, 0x38, 0x2F, 0x31, 0x30, 0x2F, 0x32,
+    0x30, 0x32, 0x33, 0x00, 0x00, 0x0B, 0x05, 0x00, 0x0B, 0x02, 0x4F, 0x45,
+    0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x30, 0x30, 0x3A,
+    0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C,
+    0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69,
+    0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F,
+    0x63, 0x6B, 0x20, 0x30, 0x00, 0x00, 0x0B, 0x05, 0x01, 0x0B, 0x02, 0x4F,
+    0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x30, 0x31,
+    0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63,
+    0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E,
+    0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x33, 0x37, 0x00, 0x00, 0x0B,
+    0x05, 0x02, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69,
+    0x6E, 0x67, 0x20, 0x30, 0x32, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C,
+    0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69,
+    0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F,
+    0x63, 0x6B, 0x20, 0x37, 0x34, 0x00, 0x00, 0x0B, 0x05, 0x03, 0x0B, 0x02,
+    0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x30,
+    0x33, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61,
+    0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67,
+    0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63,
+    0x6B, 0x20, 0x31, 0x31, 0x31, 0x00, 0x00, 0x0B, 0x05, 0x04, 0x0B, 0x02,
+    0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x30,
+    0x34, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00,
+    0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E,
+    0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62,
+    0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x31, 0x34, 0x38, 0x00, 0x00, 0x0B, 0x05,
+    0x05, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E,
+    0x67, 0x20, 0x30, 0x35, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61,
+    0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x31,
+    0x38, 0x35, 0x00, 0x00, 0x0B, 0x05, 0x06, 0x0B, 0x02, 0x4F, 0x45, 0x4D,
+    0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x30, 0x36, 0x3A, 0x20,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20,
+    0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F,
+    0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x32, 0x32, 0x32, 0x00,
+    0x00, 0x0B, 0x05, 0x07, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74,
+    0x72, 0x69, 0x6E, 0x67, 0x20, 0x30, 0x37, 0x3A, 0x20, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61,
+    0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x32,
+    0x35, 0x39, 0x00, 0x00, 0x0B, 0x05, 0x08, 0x0B, 0x02, 0x4F, 0x45, 0x4D,
+    0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x30, 0x38, 0x3A, 0x20,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00,
+    0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E,
+    0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62,
+    0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x32, 0x39, 0x36, 0x00, 0x00, 0x0B, 0x05,
+    0x09, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E,
+    0x67, 0x20, 0x30, 0x39, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61,
+    0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67,
+    0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63,
+    0x6B, 0x20, 0x33, 0x33, 0x33, 0x00, 0x00, 0x0B, 0x05, 0x0A, 0x0B, 0x02,
+    0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x31,
+    0x30, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61,
+    0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67,
+    0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63,
+    0x6B, 0x20, 0x33, 0x37, 0x30, 0x00, 0x00, 0x0B, 0x05, 0x0B, 0x0B, 0x02,
+    0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x31,
+    0x31, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00,
+    0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E,
+    0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62,
+    0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x34, 0x30, 0x37, 0x00, 0x00, 0x0B, 0x05,
+    0x0C, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E,
+    0x67, 0x20, 0x31, 0x32, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61,
+    0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x34,
+    0x34, 0x34, 0x00, 0x00, 0x0B, 0x05, 0x0D, 0x0B, 0x02, 0x4F, 0x45, 0x4D,
+    0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x31, 0x33, 0x3A, 0x20,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20,
+    0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F,
+    0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x34, 0x38, 0x31, 0x00,
+    0x00, 0x0B, 0x05, 0x0E, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74,
+    0x72, 0x69, 0x6E, 0x67, 0x20, 0x31, 0x34, 0x3A, 0x20, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61,
+    0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x35,
+    0x31, 0x38, 0x00, 0x00, 0x0B, 0x05, 0x0F, 0x0B, 0x02, 0x4F, 0x45, 0x4D,
+    0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x31, 0x35, 0x3A, 0x20,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00,
+    0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E,
+    0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62,
+    0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x35, 0x35, 0x35, 0x00, 0x00, 0x0B, 0x05,
+    0x10, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E,
+    0x67, 0x20, 0x31, 0x36, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61,
+    0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67,
+    0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63,
+    0x6B, 0x20, 0x35, 0x39, 0x32, 0x00, 0x00, 0x0B, 0x05, 0x11, 0x0B, 0x02,
+    0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x31,
+    0x37, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61,
+    0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67,
+    0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63,
+    0x6B, 0x20, 0x36, 0x32, 0x39, 0x00, 0x00, 0x0B, 0x05, 0x12, 0x0B, 0x02,
+    0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x31,
+    0x38, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00,
+    0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E,
+    0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62,
+    0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x36, 0x36, 0x36, 0x00, 0x00, 0x0B, 0x05,
+    0x13, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E,
+    0x67, 0x20, 0x31, 0x39, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61,
+    0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x37,
+    0x30, 0x33, 0x00, 0x00, 0x0B, 0x05, 0x14, 0x0B, 0x02, 0x4F, 0x45, 0x4D,
+    0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x32, 0x30, 0x3A, 0x20,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20,
+    0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F,
+    0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x37, 0x34, 0x30, 0x00,
+    0x00, 0x0B, 0x05, 0x15, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74,
+    0x72, 0x69, 0x6E, 0x67, 0x20, 0x32, 0x31, 0x3A, 0x20, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F,
+    0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61,
+    0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x37,
+    0x37, 0x37, 0x00, 0x00, 0x0B, 0x05, 0x16, 0x0B, 0x02, 0x4F, 0x45, 0x4D,
+    0x20, 0x73, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x20, 0x32, 0x32, 0x3A, 0x20,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00,
+    0x50, 0x6C, 0x61, 0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E,
+    0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62,
+    0x6C, 0x6F, 0x63, 0x6B, 0x20, 0x38, 0x31, 0x34, 0x00, 0x00, 0x0B, 0x05,
+    0x17, 0x0B, 0x02, 0x4F, 0x45, 0x4D, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6E,
+    0x67, 0x20, 0x32, 0x33, 0x3A, 0x20, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78,
+    0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x00, 0x50, 0x6C, 0x61,
+    0x74, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x63, 0x6F, 0x6E, 0x66, 0x69, 0x67,
+    0x75, 0x72, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62, 0x6C, 0x6F, 0x63,
+    0x6B, 0x20, 0x38, 0x35, 0x31, 0x00, 0x00, 0x01, 0x1B, 0x00, 0x01, 0x01,
+    0x02, 0x03, 0x04, 0x44, 0x45, 0x4C, 0x4C, 0x52, 0x00, 0x10, 0x35, 0x80,
+    0x52, 0xB3, 0xC0, 0x4F, 0x4B, 0x37, 0x32, 0x06, 0x05, 0x06, 0x44, 0x65,
+    0x6C, 0x6C, 0x20, 0x49, 0x6E, 0x63, 0x2E, 0x00, 0x50, 0x6F, 0x77, 0x65,
+    0x72, 0x45, 0x64, 0x67, 0x65, 0x20, 0x52, 0x37, 0x34, 0x30, 0x00, 0x4E,
+    0x6F, 0x74, 0x20, 0x53, 0x70, 0x65, 0x63, 0x69, 0x66, 0x69, 0x65, 0x64,
+    0x00, 0x37, 0x4B, 0x35, 0x52, 0x51, 0x32, 0x33, 0x00, 0x53, 0x4B, 0x55,
+    0x3D, 0x30, 0x37, 0x31, 0x35, 0x3B, 0x4D, 0x6F, 0x64, 0x65, 0x6C, 0x4E,
+    0x61, 0x6D, 0x65, 0x3D, 0x50, 0x6F, 0x77, 0x65, 0x72, 0x45, 0x64, 0x67,
+    0x65, 0x20, 0x52, 0x37, 0x34, 0x30, 0x00, 0x50, 0x6F, 0x77, 0x65, 0x72,
+    0x45, 0x64, 0x67, 0x65, 0x00, 0x00, 0x03, 0x14, 0x00, 0x03, 0x01, 0x01,
+    0x02, 0x00, 0x00, 0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x44, 0x65, 0x6C, 0x6C, 0x20, 0x49, 0x6E, 0x63, 0x2E, 0x00,
+    0x4E, 0x6F, 0x74, 0x20, 0x53, 0x70, 0x65, 0x63, 0x69, 0x66, 0x69, 0x65,
+    0x64, 0x00, 0x00, 0x04, 0x27, 0x00, 0x04, 0x01, 0x03, 0x01, 0xA9, 0x06,
+    0x03, 0x00, 0xFD, 0xFB, 0x8B, 0x07, 0x03, 0x00, 0xD0, 0x07, 0xD0, 0x07,
+    0x00, 0x00, 0x41, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
+    0x00, 0x01, 0x01, 0x01, 0x02, 0x00, 0x43, 0x50, 0x55, 0x31, 0x00, 0x49,
+    0x6E, 0x74, 0x65, 0x6C, 0x00, 0x49, 0x6E, 0x74, 0x65, 0x6C, 0x28, 0x52,
+    0x29, 0x20, 0x58, 0x65, 0x6F, 0x6E, 0x28, 0x52, 0x29, 0x20, 0x53, 0x69,
+    0x6C, 0x76, 0x65, 0x72, 0x20, 0x34, 0x32, 0x31, 0x34, 0x20, 0x43, 0x50,
+    0x55, 0x20, 0x40, 0x20, 0x32, 0x2E, 0x32, 0x30, 0x47, 0x48, 0x7A, 0x00,
+    0x00, 0x7F, 0x04, 0x00, 0x7F, 0x00, 0x00,
+};
+
+static const UCHAR SmBiosOemStringsMac[MAC_ADDRESS_SIZE] = {
+    0x66, 0x9A, 0xDA, 0x5A, 0xDE, 0x1E
+};
+
+//
+// SMBIOS 2.0 firmware whose System Information has no UUID.
+//
+
+static const UCHAR SmBiosLegacy[] = {
+    0x00, 0x18, 0x00, 0x00, 0x01, 0x02, 0x00, 0xE8, 0x03, 0x00, 0x0B, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0xFF, 0xFF,
+    0x41, 0x77, 0x61, 0x72, 0x64, 0x20, 0x53, 0x6F, 0x66, 0x74, 0x77, 0x61,
+    0x72, 0x65, 0x20, 0x49, 0x6E, 0x74, 0x65, 0x72, 0x6E, 0x61, 0x74, 0x69,
+    0x6F, 0x6E, 0x61, 0x6C, 0x2C, 0x20, 0x49, 0x6E, 0x63, 0x2E, 0x00, 0x36,
+    0x2E, 0x30, 0x30, 0x20, 0x50, 0x47, 0x00, 0x31, 0x32, 0x2F, 0x32, 0x38,
+    0x2F, 0x32, 0x30, 0x30, 0x37, 0x00, 0x00, 0x01, 0x08, 0x01, 0x00, 0x01,
+    0x02, 0x00, 0x00, 0x53, 0x79, 0x73, 0x74, 0x65, 0x6D, 0x20, 0x4D, 0x61,
+    0x6E, 0x75, 0x66, 0x61, 0x63, 0x74, 0x75, 0x72, 0x65, 0x72, 0x00, 0x53,
+    0x79, 0x73, 0x74, 0x65, 0x6D, 0x20, 0x4E, 0x61, 0x6D, 0x65, 0x00, 0x00,
+    0x03, 0x14, 0x02, 0x00, 0x01, 0x01, 0x02, 0x00, 0x00, 0x03, 0x03, 0x03,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x43, 0x68, 0x61, 0x73,
+    0x73, 0x69, 0x73, 0x20, 0x4D, 0x61, 0x6E, 0x75, 0x66, 0x61, 0x63, 0x74,
+    0x75, 0x72, 0x65, 0x00, 0x43, 0x68, 0x61, 0x73, 0x73, 0x69, 0x73, 0x20,
+    0x56, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x00, 0x00, 0x7F, 0x04, 0x03,
+    0x00, 0x00, 0x00,
+};
+
+//
+// Firmware that publishes no System Information.
+//
+
+static const UCHAR SmBiosNoSystemInformation[] = {
+    0x00, 0x18, 0x00, 0x00, 0x01, 0x02, 0x00, 0xE8, 0x03, 0x00, 0x0B, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0xFF, 0xFF,
+    0x63, 0x6F, 0x72, 0x65, 0x62, 0x6F, 0x6F, 0x74, 0x00, 0x34, 0x2E, 0x32,
+    0x31, 0x00, 0x30, 0x39, 0x2F, 0x30, 0x31, 0x2F, 0x32, 0x30, 0x32, 0x33,
+    0x00, 0x00, 0x03, 0x14, 0x01, 0x00, 0x01, 0x01, 0x02, 0x00, 0x00, 0x03,
+    0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x47, 0x6F,
+    0x6F, 0x67, 0x6C, 0x65, 0x00, 0x31, 0x2E, 0x30, 0x00, 0x00, 0x10, 0x0F,
+    0x02, 0x00, 0x01, 0x03, 0x06, 0x00, 0x00, 0x80, 0x00, 0xFE, 0xFF, 0x01,
+    0x00, 0x00, 0x00, 0x13, 0x0F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+    0xFF, 0x1F, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x7F, 0x04, 0x04, 0x00,
+    0x00, 0x00,
+};
@@ -0,0 +1,715 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    smbiosmactest.c
+
+Abstract:
+
+    Host test for the USB debugger's SMBIOS derived MAC address.
+
+    The SMBIOS structure table is placed at a physical address of the
+    test's choosing so that it ends on a page boundary.  Every mapping the
+    module makes is a fresh read only copy of the pages asked for, followed
+    by an inaccessible guard page, so a read past the mapped window or past
+    the end of the table faults.  The test checks that mappings are balanced
+    and do not reach past the table, and, when the System Information
+    structure is found, that the window was not grown much past it.
+
+    For each table the derived address is checked against the one expected
+    from its UUID, and the cache is checked: an unchanged entry point reuses
+    the cached address without mapping the table, while a moved or resized
+    table, or an entry point with a new checksum, derives it again.
+    Malformed tables must fall back to the private address.
+
+    Structure tables given on the command line are put through the same
+    checks.  A file may be the raw table from /sys/firmware/dmi/tables/DMI,
+    or the output of dmidecode --dump-bin, which starts with the entry point.
+
+--*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "pch.h"
+#include "hostshim.h"
+#include "hosttest.h"
+
+#define MAC_ADDRESS_SIZE 6
+#define SMBIOS_UUID_SIZE 16
+
+#include "smbiosblobs.h"
+
+#define TEST_TABLE_PAGE 0x7FFE0000ULL
+#define TEST_MAX_MAPPINGS 4
+#define TEST_FILL_BYTE 0xFF
+
+extern UCHAR KdTargetMacAddress[MAC_ADDRESS_SIZE + 2];
+
+VOID
+MacAddressFromSmBiosUuid (
+    __in PLOADER_PARAMETER_BLOCK LoaderBlock,
+    __out_bcount(MAC_ADDRESS_SIZE) PUCHAR MacAddress
+    );
+
+typedef struct _TEST_MAPPING {
+    PUCHAR Base;
+    ULONG Pages;
+} TEST_MAPPING, *PTEST_MAPPING;
+
+static const UCHAR PrivateMac[MAC_ADDRESS_SIZE] = {
+    0xAC, 0xDE, 0x48, 0x00, 0x00, 0x00
+};
+
+static const UCHAR SentinelMac[MAC_ADDRESS_SIZE] = {
+    0x02, 0x11, 0x22, 0x33, 0x44, 0x55
+};
+
+static PUCHAR TestTable;
+static ULONG TestTableLength;
+static ULONG64 TestTableAddress;
+static TEST_MAPPING TestMappings[TEST_MAX_MAPPINGS];
+static ULONG TestMapCount;
+static ULONG TestMaxMapped;
+
+static SMBIOS3_EPS_HEADER TestEps;
+static LOADER_PARAMETER_EXTENSION TestExtension;
+static LOADER_PARAMETER_BLOCK TestLoaderBlock;
+
+
+PVOID
+KdMapPhysicalMemory64 (
+    __in PHYSICAL_ADDRESS PhysicalAddress,
+    __in ULONG NumberPages,
+    __in BOOLEAN FlushCurrentTLB
+    )
+
+/*++
+
+Routine Description:
+
+    Maps a copy of the given pages of the table, with a guard page after
+    them.  Physical memory outside the table is not mapped.
+
+--*/
+
+{
+    ULONG64 Address;
+    PUCHAR Base;
+    ULONG64 End;
+    ULONG Index;
+    ULONG64 PageAddress;
+    ULONG Span;
+
+    UNREFERENCED_PARAMETER(FlushCurrentTLB);
+
+    Address = (ULONG64)PhysicalAddress.QuadPart;
+    End = TestTableAddress + TestTableLength;
+    CHECK((Address >= TestTableAddress) && (Address < End),
+          "mapping %llx outside the table", (unsigned long long)Address);
+
+    if ((Address < TestTableAddress) || (Address >= End)) {
+        return NULL;
+    }
+
+    Span = ADDRESS_AND_SIZE_TO_SPAN_PAGES(Address, End - Address);
+    CHECK((NumberPages > 0) && (NumberPages <= Span),
+          "%u pages mapped, table spans %u", NumberPages, Span);
+
+    for (Index = 0; Index < TEST_MAX_MAPPINGS; Index += 1) {
+        if (TestMappings[Index].Base == NULL) {
+            break;
+        }
+    }
+
+    CHECK(Index < TEST_MAX_MAPPINGS, "more than %u mappings outstanding",
+          TEST_MAX_MAPPINGS);
+
+    if ((Index == TEST_MAX_MAPPINGS) || (NumberPages == 0)) {
+        return NULL;
+    }
+
+    Base = mmap(NULL,
+                (NumberPages + 1) * PAGE_SIZE,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS,
+                -1,
+                0);
+
+    if (Base == MAP_FAILED) {
+        CHECK(FALSE, "mmap failed");
+        return NULL;
+    }
+
+    memset(Base, TEST_FILL_BYTE, NumberPages * PAGE_SIZE);
+    PageAddress = Address - BYTE_OFFSET(Address);
+    memcpy(Base + BYTE_OFFSET(Address),
+           &TestTable[Address - TestTableAddress],
+           (size_t)min(End, PageAddress + (NumberPages * PAGE_SIZE)) - Address);
+
+    mprotect(Base, NumberPages * PAGE_SIZE, PROT_READ);
+    mprotect(Base + (NumberPages * PAGE_SIZE), PAGE_SIZE, PROT_NONE);
+    TestMappings[Index].Base = Base;
+    TestMappings[Index].Pages = NumberPages;
+    TestMapCount += 1;
+    TestMaxMapped = max(TestMaxMapped,
+                        (ULONG)(PageAddress + (NumberPages * PAGE_SIZE) -
+                                TestTableAddress));
+
+    return Base + BYTE_OFFSET(Address);
+}
+
+VOID
+KdUnmapVirtualAddress (
+    __in PVOID VirtualAddress,
+    __in ULONG NumberPages,
+    __in BOOLEAN FlushCurrentTLB
+    )
+{
+    PUCHAR Base;
+    ULONG Index;
+
+    UNREFERENCED_PARAMETER(FlushCurrentTLB);
+
+    Base = (PUCHAR)VirtualAddress - BYTE_OFFSET(VirtualAddress);
+    for (Index = 0; Index < TEST_MAX_MAPPINGS; Index += 1) {
+        if (TestMappings[Index].Base == Base) {
+            break;
+        }
+    }
+
+    CHECK(Index < TEST_MAX_MAPPINGS, "unmapping %p, which is not mapped",
+          VirtualAddress);
+
+    if (Index == TEST_MAX_MAPPINGS) {
+        return;
+    }
+
+    CHECK(TestMappings[Index].Pages == NumberPages,
+          "unmapping %u pages of a %u page mapping",
+          NumberPages, TestMappings[Index].Pages);
+
+    munmap(Base, (TestMappings[Index].Pages + 1) * PAGE_SIZE);
+    TestMappings[Index].Base = NULL;
+    TestMappings[Index].Pages = 0;
+}
+
+static
+VOID
+SetEntryPointChecksum (
+    VOID
+    )
+{
+    UCHAR Sum;
+    ULONG Index;
+
+    TestEps.Checksum = 0;
+    Sum = 0;
+    for (Index = 0; Index < sizeof(TestEps); Index += 1) {
+        Sum += ((PUCHAR)&TestEps)[Index];
+    }
+
+    TestEps.Checksum = (UCHAR)(0 - Sum);
+}
+
+static
+VOID
+MoveTable (
+    __in ULONG64 Address
+    )
+
+/*++
+
+Routine Description:
+
+    Republishes the table at another address, the way firmware that
+    rebuilds its tables would.
+
+--*/
+
+{
+    TestTableAddress = Address;
+    TestEps.StructureTableAddress = Address;
+    SetEntryPointChecksum();
+}
+
+static
+VOID
+SetTable (
+    __in PUCHAR Table,
+    __in ULONG Length
+    )
+
+/*++
+
+Routine Description:
+
+    Publishes a structure table through the entry point the loader block
+    points at, at an address that puts its end on a page boundary.
+
+--*/
+
+{
+    TestTable = Table;
+    TestTableLength = Length;
+    TestTableAddress = TEST_TABLE_PAGE +
+                       ((PAGE_SIZE - (Length % PAGE_SIZE)) % PAGE_SIZE);
+
+    RtlZeroMemory(&TestEps, sizeof(TestEps));
+    memcpy(TestEps.Signature, "_SM3_", sizeof(TestEps.Signature));
+    TestEps.Length = sizeof(TestEps);
+    TestEps.MajorVersion = 3;
+    TestEps.EntryPointRevision = 1;
+    TestEps.StructureTableMaximumSize = Length;
+    TestEps.StructureTableAddress = TestTableAddress;
+    SetEntryPointChecksum();
+    TestExtension.Size = sizeof(TestExtension);
+    TestExtension.SMBiosEPSHeader = &TestEps;
+    TestLoaderBlock.Extension = &TestExtension;
+}
+
+static
+VOID
+GetMac (
+    __in_opt PLOADER_PARAMETER_BLOCK LoaderBlock,
+    __out_bcount(MAC_ADDRESS_SIZE) PUCHAR MacAddress
+    )
+{
+    ULONG Index;
+
+    TestMapCount = 0;
+    TestMaxMapped = 0;
+    MacAddressFromSmBiosUuid(LoaderBlock, MacAddress);
+    for (Index = 0; Index < TEST_MAX_MAPPINGS; Index += 1) {
+        CHECK(TestMappings[Index].Base == NULL, "mapping left behind");
+    }
+}
+
+static
+BOOLEAN
+FindSystemInformation (
+    __in_bcount(Length) PUCHAR Table,
+    __in ULONG Length,
+    __out PULONG UuidOffset,
+    __out PULONG End
+    )
+
+/*++
+
+Routine Description:
+
+    Reference walk of a whole structure table in memory.
+
+Arguments:
+
+    Table - Supplies the structure table.
+
+    Length - Supplies the length of the table.
+
+    UuidOffset - Receives the offset of the System Information UUID.
+
+    End - Receives the offset of the end of the System Information
+        structure's formatted area.
+
+Return Value:
+
+    TRUE if the table has a System Information structure with a UUID.
+
+--*/
+
+{
+    ULONG Offset;
+
+    Offset = 0;
+    while (Offset + sizeof(SMBIOS_STRUCT_HEADER) <= Length) {
+        if ((Table[Offset + 1] < sizeof(SMBIOS_STRUCT_HEADER)) ||
+            (Table[Offset] == 127) ||
+            (Offset + Table[Offset + 1] > Length)) {
+
+            break;
+        }
+
+        if (Table[Offset] == SMBIOS_SYSTEM_INFORMATION) {
+            if (Table[Offset + 1] <= SMBIOS_SYSTEM_INFORMATION_LENGTH_20) {
+                break;
+            }
+
+            *UuidOffset = Offset + FIELD_OFFSET(SMBIOS_SYSTEM_INFORMATION_STRUCT,
+                                                Uuid);
+
+            *End = Offset + Table[Offset + 1];
+            return TRUE;
+        }
+
+        Offset += Table[Offset + 1];
+        while ((Offset + 1 < Length) &&
+               ((Table[Offset] != 0) || (Table[Offset + 1] != 0))) {
+
+            Offset += 1;
+        }
+
+        Offset += 2;
+    }
+
+    return FALSE;
+}
+
+static
+VOID
+MacFromUuid (
+    __in_bcount(SMBIOS_UUID_SIZE) PUCHAR Uuid,
+    __out_bcount(MAC_ADDRESS_SIZE) PUCHAR MacAddress
+    )
+{
+    SYMCRYPT_HMAC_SHA256_EXPANDED_KEY HmacKey;
+    BYTE HmacResult[SYMCRYPT_HMAC_SHA256_RESULT_SIZE];
+
+    SymCryptHmacSha256ExpandKey(&HmacKey, (PCBYTE)"MAC_KEY", sizeof("MAC_KEY"));
+    SymCryptHmacSha256(&HmacKey, Uuid, SMBIOS_UUID_SIZE, HmacResult);
+    memcpy(MacAddress, HmacResult, MAC_ADDRESS_SIZE);
+    MacAddress[0] |= 0x02;
+    MacAddress[0] &= ~0x01;
+}
+
+static
+VOID
+TestTableCache (
+    __in PCSTR Name,
+    __in_bcount(Length) const UCHAR *Blob,
+    __in ULONG Length,
+    __in_opt const UCHAR *BlobMac
+    )
+
+/*++
+
+Routine Description:
+
+    Derives the address from a table and checks that the cache is keyed on
+    the entry point alone: it is used without mapping the table while the
+    entry point is unchanged, and dropped when the table moves or shrinks or
+    the entry point's checksum changes.
+
+Arguments:
+
+    Name - Supplies the name of the table for failure messages.
+
+    Blob - Supplies the structure table.
+
+    Length - Supplies the length of the table.
+
+    BlobMac - Supplies the address expected from the table, or NULL to use
+        the reference walk alone.
+
+--*/
+
+{
+    ULONG End;
+    UCHAR Expected[MAC_ADDRESS_SIZE];
+    BOOLEAN Found;
+    UCHAR Mac[MAC_ADDRESS_SIZE];
+    UCHAR Modified[MAC_ADDRESS_SIZE];
+    PUCHAR Table;
+    ULONG UuidOffset;
+
+    Table = malloc(Length);
+    memcpy(Table, Blob, Length);
+    SetTable(Table, Length);
+    RtlZeroMemory(KdTargetMacAddress, sizeof(KdTargetMacAddress));
+
+    Found = FindSystemInformation(Table, Length, &UuidOffset, &End);
+    if (Found) {
+        MacFromUuid(&Table[UuidOffset], Expected);
+
+    } else {
+        memcpy(Expected, PrivateMac, MAC_ADDRESS_SIZE);
+    }
+
+    if (BlobMac != NULL) {
+        CHECK(memcmp(Expected, BlobMac, MAC_ADDRESS_SIZE) == 0,
+              "%s: reference derivation disagrees with the table's address",
+              Name);
+    }
+
+    GetMac(&TestLoaderBlock, Mac);
+    CHECK(memcmp(Mac, Expected, MAC_ADDRESS_SIZE) == 0,
+          "%s: wrong address %02x:%02x:%02x:%02x:%02x:%02x", Name,
+          Mac[0], Mac[1], Mac[2], Mac[3], Mac[4], Mac[5]);
+
+    if (Found) {
+        CHECK(TestMaxMapped <= max(PAGE_SIZE, 2 * End),
+              "%s: %u bytes mapped to find a structure ending at %u", Name,
+              TestMaxMapped, End);
+    }
+
+    //
+    // A cache hit returns whatever is cached, so plant an address no table
+    // produces and see whether it comes back.  A hit must not map the
+    // table.
+    //
+
+    memcpy(KdTargetMacAddress, SentinelMac, MAC_ADDRESS_SIZE);
+    GetMac(&TestLoaderBlock, Mac);
+    CHECK(memcmp(Mac, SentinelMac, MAC_ADDRESS_SIZE) == 0,
+          "%s: unchanged entry point did not hit the cache", Name);
+
+    CHECK(TestMapCount == 0, "%s: cache hit mapped the table %u times", Name,
+          TestMapCount);
+
+    GetMac(NULL, Mac);
+    CHECK(memcmp(Mac, SentinelMac, MAC_ADDRESS_SIZE) == 0,
+          "%s: no loader block did not return the cached address", Name);
+
+    //
+    // Firmware that rewrites the table in place without touching the entry
+    // point is not noticed.
+    //
+
+    if (Found) {
+        Table[UuidOffset + SMBIOS_UUID_SIZE - 1] ^= 0x5A;
+        GetMac(&TestLoaderBlock, Mac);
+        CHECK(memcmp(Mac, SentinelMac, MAC_ADDRESS_SIZE) == 0,
+              "%s: UUID rewritten in place missed the cache", Name);
+
+        Table[UuidOffset + SMBIOS_UUID_SIZE - 1] ^= 0x5A;
+    }
+
+    //
+    // A table rebuilt at a new address with a new UUID.
+    //
+
+    if (Found) {
+        Table[UuidOffset + SMBIOS_UUID_SIZE - 1] ^= 0x5A;
+        MacFromUuid(&Table[UuidOffset], Modified);
+        MoveTable(TestTableAddress + PAGE_SIZE);
+        GetMac(&TestLoaderBlock, Mac);
+        CHECK(memcmp(Mac, Modified, MAC_ADDRESS_SIZE) == 0,
+              "%s: address not derived again after the table moved", Name);
+
+        Table[UuidOffset + SMBIOS_UUID_SIZE - 1] ^= 0x5A;
+    }
+
+    //
+    // An entry point republished with a new revision, and so a new
+    // checksum, over a table at the same address.
+    //
+
+    TestEps.Docrev += 1;
+    SetEntryPointChecksum();
+    memcpy(KdTargetMacAddress, SentinelMac, MAC_ADDRESS_SIZE);
+    GetMac(&TestLoaderBlock, Mac);
+    CHECK(memcmp(Mac, Expected, MAC_ADDRESS_SIZE) == 0,
+          "%s: address not derived again after the checksum changed", Name);
+
+    CHECK(TestMapCount != 0, "%s: checksum change did not map the table",
+          Name);
+
+    //
+    // A table that shrinks, but still holds System Information.
+    //
+
+    if (Found && (End + 8 < Length)) {
+        TestEps.StructureTableMaximumSize = Length - 8;
+        SetEntryPointChecksum();
+        memcpy(KdTargetMacAddress, SentinelMac, MAC_ADDRESS_SIZE);
+        GetMac(&TestLoaderBlock, Mac);
+        CHECK(memcmp(Mac, Expected, MAC_ADDRESS_SIZE) == 0,
+              "%s: address not derived again after the table shrank", Name);
+    }
+
+    free(Table);
+}
+
+static
+VOID
+ExpectPrivateMac (
+    __in PCSTR Case,
+    __in_opt PLOADER_PARAMETER_BLOCK LoaderBlock
+    )
+{
+    UCHAR Mac[MAC_ADDRESS_SIZE];
+
+    RtlZeroMemory(KdTargetMacAddress, sizeof(KdTargetMacAddress));
+    GetMac(LoaderBlock, Mac);
+    CHECK(memcmp(Mac, PrivateMac, MAC_ADDRESS_SIZE) == 0,
+          "%s: expected the private address", Case);
+}
+
+static
+VOID
+TestMalformedTables (
+    VOID
+    )
+
+/*++
+
+Routine Description:
+
+    Checks that tables cut short, structures with bad lengths, string sets
+    that run off the end and missing entry points all end in the private
+    address without reading outside the table.
+
+--*/
+
+{
+    ULONG End;
+    UCHAR Mac[MAC_ADDRESS_SIZE];
+    UCHAR Table[3 * PAGE_SIZE];
+    ULONG UuidOffset;
+
+    memcpy(Table, SmBiosQ35, sizeof(SmBiosQ35));
+    FindSystemInformation(Table, sizeof(SmBiosQ35), &UuidOffset, &End);
+
+    SetTable(Table, UuidOffset + 4);
+    ExpectPrivateMac("table ends inside System Information",
+                     &TestLoaderBlock);
+
+    SetTable(Table, Table[1] + 3);
+    ExpectPrivateMac("table ends inside the first string set",
+                     &TestLoaderBlock);
+
+    SetTable(Table, 3);
+    ExpectPrivateMac("table shorter than a structure header",
+                     &TestLoaderBlock);
+
+    Table[1] = 2;
+    SetTable(Table, sizeof(SmBiosQ35));
+    ExpectPrivateMac("structure shorter than its header", &TestLoaderBlock);
+
+    //
+    // A string set with no terminator that runs to the end of a table
+    // spanning several pages.
+    //
+
+    memset(Table, 'A', sizeof(Table));
+    Table[0] = 0;
+    Table[1] = 0x18;
+    Table[2] = 0;
+    Table[3] = 0;
+    SetTable(Table, sizeof(Table) - 100);
+    ExpectPrivateMac("unterminated string set", &TestLoaderBlock);
+
+    memcpy(Table, SmBiosQ35, sizeof(SmBiosQ35));
+    SetTable(Table, sizeof(SmBiosQ35));
+    TestExtension.Size = sizeof(TestExtension) - 1;
+    ExpectPrivateMac("loader extension too small", &TestLoaderBlock);
+
+    TestExtension.Size = sizeof(TestExtension);
+    TestExtension.SMBiosEPSHeader = NULL;
+    ExpectPrivateMac("no entry point", &TestLoaderBlock);
+
+    TestLoaderBlock.Extension = NULL;
+    ExpectPrivateMac("no loader extension", &TestLoaderBlock);
+
+    //
+    // Without a loader block and nothing cached, the caller's buffer is left
+    // alone.
+    //
+
+    RtlZeroMemory(KdTargetMacAddress, sizeof(KdTargetMacAddress));
+    memcpy(Mac, SentinelMac, MAC_ADDRESS_SIZE);
+    GetMac(NULL, Mac);
+    CHECK(memcmp(Mac, SentinelMac, MAC_ADDRESS_SIZE) == 0,
+          "no loader block wrote an address with none cached");
+
+    CHECK(*(PULONG64)KdTargetMacAddress == 0,
+          "no loader block cached an address");
+}
+
+static
+VOID
+TestCapturedTable (
+    __in PCSTR Path
+    )
+
+/*++
+
+Routine Description:
+
+    Runs a structure table captured from a real machine through the cache
+    checks.
+
+--*/
+
+{
+    PUCHAR Data;
+    FILE *File;
+    long Length;
+    ULONG64 TableAddress;
+    ULONG TableLength;
+
+    File = fopen(Path, "rb");
+    CHECK(File != NULL, "cannot open %s", Path);
+    if (File == NULL) {
+        return;
+    }
+
+    fseek(File, 0, SEEK_END);
+    Length = ftell(File);
+    fseek(File, 0, SEEK_SET);
+    Data = malloc((Length > 0) ? Length : 1);
+    if (fread(Data, 1, Length, File) != (size_t)Length) {
+        Length = 0;
+    }
+
+    fclose(File);
+
+    //
+    // dmidecode --dump-bin writes the entry point first, pointing at the
+    // table that follows it in the file.
+    //
+
+    TableAddress = 0;
+    TableLength = (ULONG)Length;
+    if ((Length >= 0x18) && (memcmp(Data, "_SM3_", 5) == 0)) {
+        memcpy(&TableLength, &Data[0x0C], sizeof(ULONG));
+        memcpy(&TableAddress, &Data[0x10], sizeof(ULONG64));
+
+    } else if ((Length >= 0x1F) && (memcmp(Data, "_SM_", 4) == 0)) {
+        TableLength = Data[0x16] | (Data[0x17] << 8);
+        TableAddress = Data[0x18] | (Data[0x19] << 8) |
+                       (Data[0x1A] << 16) | ((ULONG)Data[0x1B] << 24);
+    }
+
+    CHECK((TableAddress <= (ULONG64)Length) &&
+          (TableLength <= Length - TableAddress) &&
+          (TableLength > 0),
+          "%s is not a structure table", Path);
+
+    if ((TableAddress <= (ULONG64)Length) &&
+        (TableLength <= Length - TableAddress) &&
+        (TableLength > 0)) {
+
+        TestTableCache(Path, &Data[TableAddress], TableLength, NULL);
+    }
+
+    free(Data);
+}
+
+int
+main (
+    int argc,
+    char **argv
+    )
+{
+    int Index;
+
+    TestTableCache("Q35", SmBiosQ35, sizeof(SmBiosQ35), SmBiosQ35Mac);
+    TestTableCache("HyperV", SmBiosHyperV, sizeof(SmBiosHyperV),
+                   SmBiosHyperVMac);
+
+    TestTableCache("OemStrings", SmBiosOemStrings, sizeof(SmBiosOemStrings),
+                   SmBiosOemStringsMac);
+
+    TestTableCache("Legacy", SmBiosLegacy, sizeof(SmBiosLegacy), NULL);
+    TestTableCache("NoSystemInformation", SmBiosNoSystemInformation,
+                   sizeof(SmBiosNoSystemInformation), NULL);
+
+    TestMalformedTables();
+    for (Index = 1; Index < argc; Index += 1) {
+        TestCapturedTable(argv[Index]);
+    }
+
+    return HostTestExit();
+}
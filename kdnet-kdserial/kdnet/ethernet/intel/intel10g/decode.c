@@ -1833,3 +1833,81 @@ badcdb:
   CdbPtr->StatCode  = PXE_STATCODE_INVALID_CDB;
   return ;
 }
+
+#ifdef INTEL_KDNET
+VOID
+XgbeUndiFastApiEntry (
+  IN UINT64 cdb
+  )
+/*++
+
+Routine Description:
+  This is the UNDI API entry KDNET binds to once the driver is loaded.  The
+  Transmit, Receive and Get Status commands KDNET issues while the debugger
+  is connected are built by KDNET itself and are only issued once the
+  adapter has been initialized, so they are dispatched straight to their
+  service routines after only the IFnum check, without the rest of the CDB
+  validation and the table lookup done by XgbeUndiApiEntry.  All other
+  commands go through XgbeUndiApiEntry.
+
+Arguments:
+  cdb            - Pointer to the command descriptor block.
+
+Returns:
+  None
+
+--*/
+{
+  PXE_CDB           *CdbPtr;
+  XGBE_DRIVER_DATA  *XgbeAdapter;
+
+  CdbPtr = (PXE_CDB *) (UINTN) cdb;
+  if (CdbPtr == NULL) {
+    DEBUGPRINT (CRITICAL, ("ERROR: FastApiEntry invalid CDB\n"));
+    return ;
+  }
+
+  //
+  // The IFnum check is the one part of the CDB validation that cannot be
+  // skipped, the device list is indexed with it.
+  //
+  if ((CdbPtr->IFnum > ixgbe_pxe_31->IFcnt) ||
+      (XgbeDeviceList[CdbPtr->IFnum] == NULL)) {
+    DEBUGPRINT (CRITICAL, ("Invalid IFnum %d\n", CdbPtr->IFnum));
+    CdbPtr->StatFlags = PXE_STATFLAGS_COMMAND_FAILED;
+    CdbPtr->StatCode  = PXE_STATCODE_INVALID_CDB;
+    return ;
+  }
+
+  XgbeAdapter = &(XgbeDeviceList[CdbPtr->IFnum]->NicInfo);
+  if (XgbeAdapter->State != PXE_STATFLAGS_GET_STATE_INITIALIZED) {
+    XgbeUndiApiEntry (cdb);
+    return ;
+  }
+
+  CdbPtr->StatFlags = PXE_STATFLAGS_COMMAND_COMPLETE;
+  CdbPtr->StatCode  = PXE_STATCODE_SUCCESS;
+
+  switch (CdbPtr->OpCode) {
+  case PXE_OPCODE_TRANSMIT:
+    UndiTransmit (CdbPtr, XgbeAdapter);
+    break;
+
+  case PXE_OPCODE_RECEIVE:
+    UndiReceive (CdbPtr, XgbeAdapter);
+    break;
+
+  case PXE_OPCODE_GET_STATUS:
+    UndiStatus (CdbPtr, XgbeAdapter);
+    break;
+
+  default:
+    CdbPtr->StatFlags = PXE_STATFLAGS_INITIALIZE;
+    CdbPtr->StatCode  = PXE_STATCODE_INITIALIZE;
+    XgbeUndiApiEntry (cdb);
+    break;
+  }
+
+  return ;
+}
+#endif
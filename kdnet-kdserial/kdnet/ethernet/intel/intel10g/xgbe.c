@@ -15,6 +15,15 @@ transport layer of Microsoft's Kernel Debugger.
 #include "DeviceSupport.h"
 #endif
 
+#ifdef INTEL_KDNET
+//
+// KDNET builds use the copy routine shared by all of the Intel UNDI drivers.
+//
+#include "kdintel.h"
+
+#define XgbeMemCopy(Dest, Source, Count) IntelMemCopy ((Dest), (Source), (Count))
+#endif
+
 extern XGBE_DRIVER_DATA *XgbeData;
 
 //
@@ -245,6 +254,7 @@ Returns:
 
 #endif
 
+#ifndef INTEL_KDNET
 VOID
 XgbeMemCopy (
   IN UINT8  *Dest,
@@ -310,6 +320,7 @@ Returns:
     BytesToCopy--;
   }
 }
+#endif
 
 UINTN
 XgbeStatistics (
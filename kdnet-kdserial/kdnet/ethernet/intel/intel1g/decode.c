@@ -1815,4 +1815,80 @@ badcdb:
   return ;
 }
 
+#ifdef INTEL_KDNET
+VOID
+e1000_UNDI_FastApiEntry (
+  IN  UINT64 cdb
+  )
+/*++
+
+Routine Description:
+  This is the UNDI API entry KDNET binds to once the driver is loaded.  The
+  Transmit, Receive and Get Status commands KDNET issues while the debugger
+  is connected are built by KDNET itself and are only issued once the
+  adapter has been initialized, so they are dispatched straight to their
+  service routines after only the IFnum check, without the rest of the CDB
+  validation and the table lookup done by e1000_UNDI_APIEntry.  All other
+  commands go through e1000_UNDI_APIEntry.
+
+Arguments:
+  cdb            - Pointer to the command descriptor block.
+
+Returns:
+  None
+
+--*/
+{
+  PXE_CDB         *CdbPtr;
+  GIG_DRIVER_DATA *GigAdapter;
+
+  CdbPtr = (PXE_CDB *) (UINTN) cdb;
+  if (CdbPtr == NULL) {
+    return ;
+  }
+
+  //
+  // The IFnum check is the one part of the CDB validation that cannot be
+  // skipped, the device list is indexed with it.
+  //
+  if ((CdbPtr->IFnum > e1000_pxe_31->IFcnt) ||
+      (e1000_UNDI32DeviceList[CdbPtr->IFnum] == NULL)) {
+    DEBUGPRINT(DECODE, ("Invalid IFnum %d\n", CdbPtr->IFnum));
+    CdbPtr->StatFlags = PXE_STATFLAGS_COMMAND_FAILED;
+    CdbPtr->StatCode  = PXE_STATCODE_INVALID_CDB;
+    return ;
+  }
+
+  GigAdapter = &(e1000_UNDI32DeviceList[CdbPtr->IFnum]->NicInfo);
+  if (GigAdapter->State != PXE_STATFLAGS_GET_STATE_INITIALIZED) {
+    e1000_UNDI_APIEntry (cdb);
+    return ;
+  }
+
+  CdbPtr->StatFlags = PXE_STATFLAGS_COMMAND_COMPLETE;
+  CdbPtr->StatCode  = PXE_STATCODE_SUCCESS;
+
+  switch (CdbPtr->OpCode) {
+  case PXE_OPCODE_TRANSMIT:
+    e1000_UNDI_Transmit (CdbPtr, GigAdapter);
+    break;
+
+  case PXE_OPCODE_RECEIVE:
+    e1000_UNDI_Receive (CdbPtr, GigAdapter);
+    break;
+
+  case PXE_OPCODE_GET_STATUS:
+    e1000_UNDI_Status (CdbPtr, GigAdapter);
+    break;
+
+  default:
+    CdbPtr->StatFlags = PXE_STATFLAGS_INITIALIZE;
+    CdbPtr->StatCode  = PXE_STATCODE_INITIALIZE;
+    e1000_UNDI_APIEntry (cdb);
+    break;
+  }
+
+  return ;
+}
+#endif
 
@@ -20,6 +20,15 @@ transport layer of Microsoft's Kernel Debugger.
 #endif
 
 
+#ifdef INTEL_KDNET
+//
+// KDNET builds use the copy routine shared by all of the Intel UNDI drivers.
+//
+#include "kdintel.h"
+
+#define e1000_MemCopy(Dest, Source, Count) IntelMemCopy ((Dest), (Source), (Count))
+#endif
+
 extern GIG_DRIVER_DATA  *e1000_NIC_Data;  // is actually an array of structures
 
 //
@@ -306,6 +315,7 @@ Returns:
   }
 }
 
+#ifndef INTEL_KDNET
 VOID
 e1000_MemCopy (
     IN UINT8* Dest,
@@ -370,6 +380,7 @@ Returns:
     BytesToCopy--;
   }
 }
+#endif
 
 BOOLEAN
 e1000_DownShift (
@@ -1969,3 +1969,75 @@ BadCdb:
   return;
 }
 
+
+#ifdef INTEL_KDNET
+/** This is the UNDI API entry KDNET binds to once the driver is loaded.
+
+   The Transmit, Receive and Get Status commands KDNET issues while the debugger
+   is connected are built by KDNET itself and are only issued once the adapter
+   has been initialized, so they are dispatched straight to their service
+   routines after only the IFnum check, without the rest of the Cdb validation
+   and the table lookup done by i40eUndiApiEntry.  All other commands go
+   through i40eUndiApiEntry.
+
+   @param[in]   Cdb    Pointer to the command descriptor block.
+
+   @retval      None
+**/
+VOID
+i40eUndiFastApiEntry (
+  IN UINT64 Cdb
+  )
+{
+  PXE_CDB           *CdbPtr;
+  I40E_DRIVER_DATA  *AdapterInfo;
+
+  CdbPtr = (PXE_CDB *) (UINTN) Cdb;
+  if (CdbPtr == NULL) {
+    DEBUGPRINT (CRITICAL, ("ERROR: FastApiEntry invalid CDB\n"));
+    return;
+  }
+
+  // The IFnum check is the one part of the Cdb validation that cannot be
+  // skipped, the device list is indexed with it.
+  if ((CdbPtr->IFnum > i40e_pxe_31->IFcnt)
+    || (Undi32DeviceList[CdbPtr->IFnum] == NULL))
+  {
+    DEBUGPRINT (CRITICAL, ("Invalid IFnum %d\n", CdbPtr->IFnum));
+    CdbPtr->StatFlags = PXE_STATFLAGS_COMMAND_FAILED;
+    CdbPtr->StatCode  = PXE_STATCODE_INVALID_CDB;
+    return;
+  }
+
+  AdapterInfo = &(Undi32DeviceList[CdbPtr->IFnum]->NicInfo);
+  if (AdapterInfo->State != PXE_STATFLAGS_GET_STATE_INITIALIZED) {
+    i40eUndiApiEntry (Cdb);
+    return;
+  }
+
+  CdbPtr->StatFlags = PXE_STATFLAGS_COMMAND_COMPLETE;
+  CdbPtr->StatCode  = PXE_STATCODE_SUCCESS;
+
+  switch (CdbPtr->OpCode) {
+  case PXE_OPCODE_TRANSMIT:
+    UndiTransmit (CdbPtr, AdapterInfo);
+    break;
+
+  case PXE_OPCODE_RECEIVE:
+    UndiReceive (CdbPtr, AdapterInfo);
+    break;
+
+  case PXE_OPCODE_GET_STATUS:
+    UndiStatus (CdbPtr, AdapterInfo);
+    break;
+
+  default:
+    CdbPtr->StatFlags = PXE_STATFLAGS_INITIALIZE;
+    CdbPtr->StatCode  = PXE_STATCODE_INITIALIZE;
+    i40eUndiApiEntry (Cdb);
+    break;
+  }
+
+  return;
+}
+#endif
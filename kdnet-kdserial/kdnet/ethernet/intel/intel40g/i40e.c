@@ -36,6 +36,15 @@ transport layer of Microsoft's Kernel Debugger.
 #endif
 #include "DeviceSupport.h"
 
+#ifdef INTEL_KDNET
+//
+// KDNET builds use the copy routine shared by all of the Intel UNDI drivers.
+//
+#include "kdintel.h"
+
+#define i40eMemCopy(Dest, Source, Count) IntelMemCopy ((Dest), (Source), (Count))
+#endif
+
 #ifndef INTEL_KDNET
 extern EFI_DRIVER_BINDING_PROTOCOL gUndiDriverBinding;
 #endif
@@ -153,6 +162,7 @@ Returns:
 #endif
 
 
+#ifndef INTEL_KDNET
 /**
   This is the drivers copy function so it does not need to rely on the BootServices
   copy which goes away at runtime. This copy function allows 64-bit or 32-bit copies
@@ -214,6 +224,7 @@ i40eMemCopy(
         BytesToCopy--;
     }
 }
+#endif
 
 
 //
@@ -3092,11 +3103,11 @@ Returns:
         goto ErrorReleaseController;
     }
 
-    // Wait at least 40ms due to I2C access issues
+    // Wait at least 40ms due to I2C access issues.  KDNET doesn't wait up
+    // front: IsQualifiedSfpModule polls Get Link Status and waits 50ms only
+    // between attempts that fail.
 #ifndef INTEL_KDNET
     gBS->Stall(100 * 1000);
-#else
-    KeStallExecutionProcessor(100 * 1000);
 #endif
 
     AdapterInfo->QualifiedSfpModule = IsQualifiedSfpModule(AdapterInfo);
@@ -3857,11 +3868,14 @@ Returns:
 
     // Workaround: Admin queue command Get Link Status sometimes fails
     // We need to wait for at least 40 ms before calling Get Link Status again.
+    // The EIO is reported by the firmware in asq_last_status; the call
+    // itself returns I40E_ERR_ADMIN_QUEUE_ERROR.
     do {
 
         I40eStatus = i40e_aq_get_link_info(&AdapterInfo->hw, TRUE, NULL, NULL);
 
-        if (I40eStatus == I40E_AQ_RC_EIO) {
+        if ((I40eStatus == I40E_ERR_ADMIN_QUEUE_ERROR) &&
+            (AdapterInfo->hw.aq.asq_last_status == I40E_AQ_RC_EIO)) {
 #ifndef INTEL_KDNET
             gBS->Stall(50 * 1000);
 #else
@@ -45,6 +45,11 @@ e1000_UNDI_APIEntry (
   IN  UINT64 cdb
   );
 
+VOID
+e1000_UNDI_FastApiEntry (
+  IN  UINT64 cdb
+  );
+
 //
 // Main entry points into the Intel 10Gbit EFI driver code.
 //
@@ -75,6 +80,11 @@ XgbeUndiApiEntry (
   IN  UINT64 cdb
   );
 
+VOID
+XgbeUndiFastApiEntry (
+  IN  UINT64 cdb
+  );
+
 //
 // Main entry points into the Intel 40Gbit EFI driver code.
 //
@@ -104,12 +114,70 @@ i40eUndiApiEntry (
   IN  UINT64 cdb
   );
 
+VOID
+i40eUndiFastApiEntry (
+  IN  UINT64 cdb
+  );
+
 
 UINT32
 CalcI40eContextSize(
     VOID
     );
 
+INTEL_INIT_TIMELINE IntelInitTimeline;
+
+//
+// Set when the loader options request that the hardware only receive frames
+// addressed to the target and broadcast frames.
+//
+
+BOOLEAN IntelRxFilter;
+
+//
+// Set once the receive filters of the initialized controller were narrowed.
+//
+
+BOOLEAN IntelRxFiltered;
+
+NTSTATUS
+IntelTimedInitializeController (
+    __in PKDNET_SHARED_DATA Adapter,
+    __in INTEL_INIT_STEP Step
+    )
+
+/*++
+
+Routine Description:
+
+    This function runs UndiInitializeController for the currently selected
+    UNDI driver and charges the time it takes to the given step of the
+    initialization timeline.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Step - Supplies the timeline step for the selected driver.
+
+Return Value:
+
+    The status returned by UndiInitializeController.
+
+--*/
+
+{
+    ULONG64 Cycles;
+    NTSTATUS Status;
+
+    Cycles = KdReadCycleCounter(&IntelInitTimeline.Frequency);
+    Status = UndiInitializeController(Adapter);
+    Cycles = KdReadCycleCounter(NULL) - Cycles;
+    IntelInitTimeline.StepCycles[Step] += Cycles;
+    IntelInitTimeline.TotalCycles += Cycles;
+    return Status;
+}
+
 ULONG
 IntelGetHardwareContextSize (
     __in PDEBUG_DEVICE_DESCRIPTOR Device
@@ -138,16 +206,154 @@ IntelInitializeLibrary (
     __inout PDEBUG_DEVICE_DESCRIPTOR Device
     )
 {
-    UNREFERENCED_PARAMETER(LoaderOptions);
-
     if (Device == NULL) {
         return STATUS_INVALID_PARAMETER;
     }
 
+    IntelRxFilter = FALSE;
+    if (KdNetParseLoaderOption(LoaderOptions, KDNET_RX_FILTER_OPTION) != 0) {
+        IntelRxFilter = TRUE;
+    }
+
     Device->Memory.Length = IntelGetHardwareContextSize(Device);
     return STATUS_SUCCESS;
 }
 
+BOOLEAN
+IntelIssueRxFilterCommand (
+    __in UINT16 OpFlags,
+    __in_opt PXE_CPB_RECEIVE_FILTERS *Cpb,
+    __in UINT16 CpbSize
+    )
+
+/*++
+
+Routine Description:
+
+    This function issues a Receive Filters command to the selected UNDI
+    driver.
+
+Arguments:
+
+    OpFlags - Supplies the operation and the filters it applies to.
+
+    Cpb - Supplies the multicast list for a filtered multicast enable.
+
+    CpbSize - Supplies the size of the multicast list in bytes.
+
+Return Value:
+
+    TRUE if the command completed successfully.
+
+--*/
+
+{
+    PXE_CDB Cdb;
+
+    RtlZeroMemory(&Cdb, sizeof(Cdb));
+    Cdb.OpCode = PXE_OPCODE_RECEIVE_FILTERS;
+    Cdb.OpFlags = OpFlags;
+    Cdb.CPBsize = PXE_CPBSIZE_NOT_USED;
+    Cdb.DBsize = PXE_DBSIZE_NOT_USED;
+    Cdb.CPBaddr = PXE_CPBADDR_NOT_USED;
+    if (Cpb != NULL) {
+        Cdb.CPBsize = CpbSize;
+        Cdb.CPBaddr = (UINT64)(UINTN)Cpb;
+    }
+
+    Cdb.DBaddr = PXE_DBADDR_NOT_USED;
+    Cdb.StatCode = PXE_STATCODE_INITIALIZE;
+    Cdb.StatFlags = PXE_STATFLAGS_INITIALIZE;
+    Cdb.IFnum = 0;
+    Cdb.Control = PXE_CONTROL_LAST_CDB_IN_LIST;
+    UndiApiEntry((UINT64)(UINTN)&Cdb);
+    if (((Cdb.StatFlags & PXE_STATFLAGS_STATUS_MASK) !=
+         PXE_STATFLAGS_COMMAND_COMPLETE) ||
+        (Cdb.StatCode != PXE_STATCODE_SUCCESS)) {
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+BOOLEAN
+IntelSetRxFilter (
+    __in PKDNET_SHARED_DATA Adapter
+    )
+
+/*++
+
+Routine Description:
+
+    This function narrows the receive filters of the initialized controller
+    to frames addressed to the station address (the receive address register
+    on all three families), broadcast frames, which ARP and DHCP need, and
+    the IPv6 neighbor discovery groups from KdNetGetRxFilterMulticast, which
+    are loaded as the multicast list.  Promiscuous and all multicast reception
+    are turned off.  The UNDI drivers have no interface to the UDP port
+    matching of the 10GBit and 40GBit flow director, so KDNET still classifies
+    every frame that is received.
+
+    If the driver rejects the multicast list, all multicast reception is
+    turned back on so that neighbor discovery keeps working, and the filters
+    are reported as not narrowed.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+Return Value:
+
+    TRUE if the receive filters were programmed.
+
+--*/
+
+{
+    PXE_CPB_RECEIVE_FILTERS Cpb;
+    UCHAR Groups[KDNET_RX_FILTER_MULTICAST_COUNT][MAC_ADDRESS_SIZE];
+    ULONG Index;
+
+    if (IntelIssueRxFilterCommand(
+            PXE_OPFLAGS_RECEIVE_FILTER_DISABLE |
+            PXE_OPFLAGS_RECEIVE_FILTER_RESET_MCAST_LIST |
+            PXE_OPFLAGS_RECEIVE_FILTER_FILTERED_MULTICAST |
+            PXE_OPFLAGS_RECEIVE_FILTER_PROMISCUOUS |
+            PXE_OPFLAGS_RECEIVE_FILTER_ALL_MULTICAST,
+            NULL,
+            0) == FALSE) {
+
+        return FALSE;
+    }
+
+    RtlZeroMemory(&Cpb, sizeof(Cpb));
+    KdNetGetRxFilterMulticast(Adapter->TargetMacAddress, Groups);
+    for (Index = 0; Index < KDNET_RX_FILTER_MULTICAST_COUNT; Index += 1) {
+        RtlCopyMemory(Cpb.MCastList[Index], Groups[Index], MAC_ADDRESS_SIZE);
+    }
+
+    if (IntelIssueRxFilterCommand(
+            PXE_OPFLAGS_RECEIVE_FILTER_ENABLE |
+            PXE_OPFLAGS_RECEIVE_FILTER_UNICAST |
+            PXE_OPFLAGS_RECEIVE_FILTER_BROADCAST |
+            PXE_OPFLAGS_RECEIVE_FILTER_FILTERED_MULTICAST,
+            &Cpb,
+            (UINT16)(KDNET_RX_FILTER_MULTICAST_COUNT * sizeof(PXE_MAC_ADDR)))
+        != FALSE) {
+
+        return TRUE;
+    }
+
+    IntelIssueRxFilterCommand(PXE_OPFLAGS_RECEIVE_FILTER_ENABLE |
+                              PXE_OPFLAGS_RECEIVE_FILTER_UNICAST |
+                              PXE_OPFLAGS_RECEIVE_FILTER_BROADCAST |
+                              PXE_OPFLAGS_RECEIVE_FILTER_ALL_MULTICAST,
+                              NULL,
+                              0);
+
+    return FALSE;
+}
+
 NTSTATUS
 IntelInitializeController(
     __in PKDNET_SHARED_DATA Adapter
@@ -184,15 +390,28 @@ Return Value:
 #else
 
     NTSTATUS Status;
+    INTEL_INIT_STEP Step;
 
     //
     // Select the function pointers only the first time this routine is called.
     //
 
     if (UndiInitializeDriver != NULL) {
+        if (UndiApiEntry == e1000_UNDI_FastApiEntry) {
+            Step = IntelInitStep1G;
+
+        } else if (UndiApiEntry == XgbeUndiFastApiEntry) {
+            Step = IntelInitStep10G;
+
+        } else {
+            Step = IntelInitStep40G;
+        }
+
         goto FunctionPointersInitialized;
     }
 
+    RtlZeroMemory(&IntelInitTimeline, sizeof(IntelInitTimeline));
+
     //
     // Immediately fail initialization if the device does not have an Intel
     // vendor ID.
@@ -226,13 +445,13 @@ Return Value:
     UndiInitializeDriver = InitializeGigUNDIDriver;
     UndiHardwareSupported = GigUndiDriverSupported;
     UndiDriverStart = GigUndiDriverStart;
-    UndiApiEntry = e1000_UNDI_APIEntry;
+    UndiApiEntry = e1000_UNDI_FastApiEntry;
 
     //
     // Initialize the kdnet UNDI driver.
     //
 
-    Status = UndiInitializeController(Adapter);
+    Status = IntelTimedInitializeController(Adapter, IntelInitStep1G);
     if (Status != STATUS_NO_SUCH_DEVICE) {
         goto IntelInitializeControllerEnd;
     }
@@ -244,13 +463,13 @@ Return Value:
     UndiInitializeDriver = InitializeXGigUndiDriver;
     UndiHardwareSupported = InitUndiDriverSupported;
     UndiDriverStart = InitUndiDriverStart;
-    UndiApiEntry = XgbeUndiApiEntry;
+    UndiApiEntry = XgbeUndiFastApiEntry;
 
     //
     // Initialize the kdnet UNDI driver.
     //
 
-    Status = UndiInitializeController(Adapter);
+    Status = IntelTimedInitializeController(Adapter, IntelInitStep10G);
     if (Status != STATUS_NO_SUCH_DEVICE) {
         goto IntelInitializeControllerEnd;
     }
@@ -262,7 +481,8 @@ Return Value:
     UndiInitializeDriver = i40eInitializeUNDIDriver ;
     UndiHardwareSupported = i40eUndiDriverSupported ;
     UndiDriverStart = i40eUndiDriverStart ;
-    UndiApiEntry = i40eUndiApiEntry;
+    UndiApiEntry = i40eUndiFastApiEntry;
+    Step = IntelInitStep40G;
 
 FunctionPointersInitialized:
 
@@ -270,15 +490,19 @@ FunctionPointersInitialized:
     // Initialize the kdnet UNDI driver.
     //
 
-    Status = UndiInitializeController(Adapter);
+    Status = IntelTimedInitializeController(Adapter, Step);
 
     //
     // On success, erase any KdNetErrorString set during the 1GBit
-    // initialization.
+    // initialization, and narrow the receive filters if that was requested.
     //
 
+    IntelRxFiltered = FALSE;
     if (NT_SUCCESS(Status)) {
         KdNetErrorString = NULL;
+        if (IntelRxFilter != FALSE) {
+            IntelRxFiltered = IntelSetRxFilter(Adapter);
+        }
     }
 
 IntelInitializeControllerEnd:
@@ -287,3 +511,82 @@ IntelInitializeControllerEnd:
 #endif
 
 }
+
+NTSTATUS
+IntelDeviceControl (
+    __in PVOID Adapter,
+    __in ULONG RequestCode,
+    __in_bcount(InputBufferSize) PVOID InputBuffer,
+    __in ULONG InputBufferSize,
+    __out_bcount(OutputBufferSize) PVOID OutputBuffer,
+    __in ULONG OutputBufferSize
+    )
+
+/*++
+
+Routine Description:
+
+    Synchronously handle a device control request.  The UNDI library uses a
+    single transmit and receive packet buffer regardless of what the loader
+    requested, and that is the ring configuration reported.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    RequestCode - The code for the request being sent
+
+    InputBuffer - The input data for the request
+
+    InputBufferSize - The size of the input buffer
+
+    OutputBuffer - The output data for the request
+
+    OutputBufferSize - The size of the output buffer
+
+Return Value:
+
+    NT status code.
+
+--*/
+
+{
+    PKDNET_RING_PARAMETERS Rings;
+    NTSTATUS Status;
+
+    UNREFERENCED_PARAMETER(Adapter);
+    UNREFERENCED_PARAMETER(InputBuffer);
+    UNREFERENCED_PARAMETER(InputBufferSize);
+
+    Status = STATUS_INVALID_DEVICE_REQUEST;
+    switch (RequestCode) {
+        case KD_DEVICE_CONTROL_NET_QUERY_RING_PARAMETERS:
+            if (OutputBufferSize < sizeof(KDNET_RING_PARAMETERS)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            Rings = (PKDNET_RING_PARAMETERS)OutputBuffer;
+            Rings->RxDepth = 1;
+            Rings->TxDepth = 1;
+            Rings->BufferSize = MAX_PKT_SIZE;
+            Rings->MaxInFlight = 1;
+            Status = STATUS_SUCCESS;
+            break;
+
+        case KD_DEVICE_CONTROL_NET_QUERY_RX_FILTER:
+            if (OutputBufferSize < sizeof(BOOLEAN)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            *((BOOLEAN *)OutputBuffer) = IntelRxFiltered;
+            Status = STATUS_SUCCESS;
+            break;
+
+        default:
+            break;
+    }
+
+    return Status;
+}
@@ -332,6 +332,51 @@ Return Value:
     UndiShutdownController(Adapter);
 }
 
+NTSTATUS
+KdDeviceControl(
+    __in PVOID Adapter,
+    __in ULONG RequestCode,
+    __in_bcount(InputBufferSize) PVOID InputBuffer,
+    __in ULONG InputBufferSize,
+    __out_bcount(OutputBufferSize) PVOID OutputBuffer,
+    __in ULONG OutputBufferSize
+    )
+
+/*++
+
+Routine Description:
+
+    Synchronously send a device control request.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    RequestCode - The code for the request being send
+
+    InputBuffer - The input data for the request
+
+    InputBufferSize - The size of the input buffer
+
+    OutputBuffer - The output data for the request
+
+    OutputBufferSize - The size of the output buffer
+
+Return Value:
+
+    NT status code.
+
+--*/
+
+{
+    return IntelDeviceControl(Adapter,
+                              RequestCode,
+                              InputBuffer,
+                              InputBufferSize,
+                              OutputBuffer,
+                              OutputBufferSize);
+}
+
 ULONG
 KdGetHardwareContextSize (
     __in PDEBUG_DEVICE_DESCRIPTOR Device
@@ -378,7 +423,8 @@ KdInitializeLibrary (
     }
 
     Exports = KdNetExtensibilityImports->Exports;
-    if ((Exports == NULL) || (Exports->FunctionCount != KDNET_EXT_EXPORTS)) {
+    if ((Exports == NULL) ||
+        !KDNET_EXT_EXPORTS_SUPPORTED(Exports->FunctionCount)) {
         Status = STATUS_INVALID_PARAMETER;
         goto KdInitializeLibraryEnd;
     }
@@ -397,6 +443,7 @@ KdInitializeLibrary (
     Exports->KdGetPacketAddress = KdGetPacketAddress;
     Exports->KdGetPacketLength = KdGetPacketLength;
     Exports->KdGetHardwareContextSize = KdGetHardwareContextSize;
+    Exports->KdDeviceControl = KdDeviceControl;
 
 #if TRACE_DBG_PRINT
 
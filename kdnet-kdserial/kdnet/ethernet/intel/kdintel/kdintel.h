@@ -16,8 +16,32 @@ Author:
 
 --*/
 
+#pragma once
+
 #define PCI_VID_INTEL 0x8086
 
+//
+// IntelInitializeController tries each UNDI driver in turn.  The time each
+// attempt took is kept in IntelInitTimeline, so the time to first packet can
+// be broken down from the debugger: a slow probe of the wrong family shows
+// up separately from the initialization of the controller that is present.
+//
+
+typedef enum _INTEL_INIT_STEP {
+    IntelInitStep1G,
+    IntelInitStep10G,
+    IntelInitStep40G,
+    IntelInitStepCount
+} INTEL_INIT_STEP;
+
+typedef struct _INTEL_INIT_TIMELINE {
+    ULONG64 Frequency;
+    ULONG64 StepCycles[IntelInitStepCount];
+    ULONG64 TotalCycles;
+} INTEL_INIT_TIMELINE, *PINTEL_INIT_TIMELINE;
+
+extern INTEL_INIT_TIMELINE IntelInitTimeline;
+
 //
 // kdintel.c
 //
@@ -38,3 +62,24 @@ IntelInitializeController(
     __in PKDNET_SHARED_DATA Adapter
     );
 
+NTSTATUS
+IntelDeviceControl (
+    __in PVOID Adapter,
+    __in ULONG RequestCode,
+    __in_bcount(InputBufferSize) PVOID InputBuffer,
+    __in ULONG InputBufferSize,
+    __out_bcount(OutputBufferSize) PVOID OutputBuffer,
+    __in ULONG OutputBufferSize
+    );
+
+//
+// memcopy.c
+//
+
+VOID
+IntelMemCopy (
+    __out_bcount(Count) PVOID Destination,
+    __in_bcount(Count) PVOID Source,
+    __in ULONG Count
+    );
+
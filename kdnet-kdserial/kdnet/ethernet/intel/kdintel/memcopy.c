@@ -0,0 +1,184 @@
+/*++
+
+Copyright (c) Microsoft Corporation
+
+Module Name:
+
+    memcopy.c
+
+Abstract:
+
+    Network Kernel Debug Extensibility Support.  This module implements the
+    copy routine shared by the Intel 1GBit, 10GBit and 40GBit UNDI drivers for
+    moving packets between their DMA buffers and the KDNET packet buffers.
+
+--*/
+
+#include "pch.h"
+
+#if defined(_M_AMD64)
+#include <emmintrin.h>
+#elif defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+//
+// Copies shorter than this are done a word at a time.  Every debug packet
+// carries at least an Ethernet, IP and UDP header plus the KDNET header, so
+// anything on the packet path takes the vector loop.
+//
+
+#define INTEL_MEMCOPY_VECTOR_THRESHOLD 64
+
+VOID
+IntelMemCopy (
+    __out_bcount(Count) PVOID Destination,
+    __in_bcount(Count) PVOID Source,
+    __in ULONG Count
+    )
+
+/*++
+
+Routine Description:
+
+    This routine copies a packet between non overlapping buffers.
+
+    On amd64 the copy moves 64 bytes per iteration through SSE2 registers.
+    The destination is aligned to 16 bytes first so that every store in the
+    loop is aligned, and the unaligned remainder is finished with a single
+    16 byte copy that ends on the last byte.  On arm64 the same loop is built
+    from NEON loads and stores.  AVX is not used since the debugger runs with
+    the rest of the system frozen and cannot rely on the extended state
+    having been saved for it.
+
+    Short copies, and copies on other architectures, are done a UINT_PTR at a
+    time followed by a byte tail.
+
+Arguments:
+
+    Destination - Supplies the buffer to copy to.
+
+    Source - Supplies the buffer to copy from.
+
+    Count - Supplies the number of bytes to copy.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+
+    PUCHAR Dest;
+    PUCHAR Src;
+
+#if defined(_M_AMD64) || defined(_M_ARM64)
+
+    ULONG Head;
+
+#endif
+
+    Dest = (PUCHAR)Destination;
+    Src = (PUCHAR)Source;
+
+#if defined(_M_AMD64)
+
+    if (Count >= INTEL_MEMCOPY_VECTOR_THRESHOLD) {
+        Head = (ULONG)((0 - (ULONG_PTR)Dest) & 15);
+        if (Head != 0) {
+            _mm_storeu_si128((__m128i *)Dest, _mm_loadu_si128((__m128i *)Src));
+            Dest += Head;
+            Src += Head;
+            Count -= Head;
+        }
+
+        while (Count >= 64) {
+            __m128i Data0 = _mm_loadu_si128((__m128i *)(Src + 0));
+            __m128i Data1 = _mm_loadu_si128((__m128i *)(Src + 16));
+            __m128i Data2 = _mm_loadu_si128((__m128i *)(Src + 32));
+            __m128i Data3 = _mm_loadu_si128((__m128i *)(Src + 48));
+
+            _mm_store_si128((__m128i *)(Dest + 0), Data0);
+            _mm_store_si128((__m128i *)(Dest + 16), Data1);
+            _mm_store_si128((__m128i *)(Dest + 32), Data2);
+            _mm_store_si128((__m128i *)(Dest + 48), Data3);
+            Dest += 64;
+            Src += 64;
+            Count -= 64;
+        }
+
+        while (Count >= 16) {
+            _mm_store_si128((__m128i *)Dest, _mm_loadu_si128((__m128i *)Src));
+            Dest += 16;
+            Src += 16;
+            Count -= 16;
+        }
+
+        if (Count != 0) {
+            _mm_storeu_si128((__m128i *)(Dest + Count - 16),
+                             _mm_loadu_si128((__m128i *)(Src + Count - 16)));
+        }
+
+        return;
+    }
+
+#elif defined(_M_ARM64)
+
+    if (Count >= INTEL_MEMCOPY_VECTOR_THRESHOLD) {
+        Head = (ULONG)((0 - (ULONG_PTR)Dest) & 15);
+        if (Head != 0) {
+            vst1q_u8(Dest, vld1q_u8(Src));
+            Dest += Head;
+            Src += Head;
+            Count -= Head;
+        }
+
+        while (Count >= 64) {
+            uint8x16_t Data0 = vld1q_u8(Src + 0);
+            uint8x16_t Data1 = vld1q_u8(Src + 16);
+            uint8x16_t Data2 = vld1q_u8(Src + 32);
+            uint8x16_t Data3 = vld1q_u8(Src + 48);
+
+            vst1q_u8(Dest + 0, Data0);
+            vst1q_u8(Dest + 16, Data1);
+            vst1q_u8(Dest + 32, Data2);
+            vst1q_u8(Dest + 48, Data3);
+            Dest += 64;
+            Src += 64;
+            Count -= 64;
+        }
+
+        while (Count >= 16) {
+            vst1q_u8(Dest, vld1q_u8(Src));
+            Dest += 16;
+            Src += 16;
+            Count -= 16;
+        }
+
+        if (Count != 0) {
+            vst1q_u8(Dest + Count - 16, vld1q_u8(Src + Count - 16));
+        }
+
+        return;
+    }
+
+#endif
+
+    while (Count >= sizeof(ULONG_PTR)) {
+        *(ULONG_PTR UNALIGNED *)Dest = *(ULONG_PTR UNALIGNED *)Src;
+        Dest += sizeof(ULONG_PTR);
+        Src += sizeof(ULONG_PTR);
+        Count -= sizeof(ULONG_PTR);
+    }
+
+    while (Count > 0) {
+        *Dest = *Src;
+        Dest += 1;
+        Src += 1;
+        Count -= 1;
+    }
+
+    return;
+}
+
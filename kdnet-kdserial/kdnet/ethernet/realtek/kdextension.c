@@ -298,7 +298,7 @@ Return Value:
 
 NTSTATUS
 KdInitializeController(
-    __in PVOID Adapter
+    __in PKDNET_SHARED_DATA KdNet
     )
 
 /*++
@@ -313,7 +313,7 @@ Routine Description:
 
 Arguments:
 
-    Adapter - Supplies a pointer to the debug adapter object.
+    KdNet - Supplies a pointer to the data shared with KdNet.
 
 Return Value:
 
@@ -323,7 +323,7 @@ Return Value:
 --*/
 
 {
-    return RealtekInitializeController(Adapter);
+    return RealtekInitializeController(KdNet);
 }
 
 VOID
@@ -353,6 +353,51 @@ Return Value:
     return;
 }
 
+NTSTATUS
+KdDeviceControl(
+    __in PVOID Adapter,
+    __in ULONG RequestCode,
+    __in_bcount(InputBufferSize) PVOID InputBuffer,
+    __in ULONG InputBufferSize,
+    __out_bcount(OutputBufferSize) PVOID OutputBuffer,
+    __in ULONG OutputBufferSize
+    )
+
+/*++
+
+Routine Description:
+
+    Synchronously send a device control request.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    RequestCode - The code for the request being send
+
+    InputBuffer - The input data for the request
+
+    InputBufferSize - The size of the input buffer
+
+    OutputBuffer - The output data for the request
+
+    OutputBufferSize - The size of the output buffer
+
+Return Value:
+
+    NT status code.
+
+--*/
+
+{
+    return RealtekDeviceControl(Adapter,
+                                RequestCode,
+                                InputBuffer,
+                                InputBufferSize,
+                                OutputBuffer,
+                                OutputBufferSize);
+}
+
 ULONG
 KdGetHardwareContextSize (
     __in PDEBUG_DEVICE_DESCRIPTOR Device
@@ -428,7 +473,6 @@ Return Value:
     PKDNET_EXTENSIBILITY_EXPORTS Exports;
 
     __security_init_cookie();
-    UNREFERENCED_PARAMETER(LoaderOptions);
     Status = STATUS_SUCCESS;
     KdNetExtensibilityImports = ImportTable;
     if ((KdNetExtensibilityImports == NULL) ||
@@ -438,7 +482,8 @@ Return Value:
     }
 
     Exports = KdNetExtensibilityImports->Exports;
-    if ((Exports == NULL) || (Exports->FunctionCount != KDNET_EXT_EXPORTS)) {
+    if ((Exports == NULL) ||
+        !KDNET_EXT_EXPORTS_SUPPORTED(Exports->FunctionCount)) {
         Status = STATUS_INVALID_PARAMETER;
         goto KdInitializeLibraryEnd;
     }
@@ -457,11 +502,15 @@ Return Value:
     Exports->KdGetPacketAddress = KdGetPacketAddress;
     Exports->KdGetPacketLength = KdGetPacketLength;
     Exports->KdGetHardwareContextSize = KdGetHardwareContextSize;
+    Exports->KdDeviceControl = KdDeviceControl;
 
     //
-    // Return the hardware context size required to support this device.
+    // Return the hardware context size required to support this device with
+    // the ring configuration requested in the loader options.
     //
 
+    RealtekSetRingParameters(LoaderOptions);
+    RealtekSetRxFilter(LoaderOptions);
     Device->Memory.Length = RealtekGetHardwareContextSize(Device);
 
 KdInitializeLibraryEnd:
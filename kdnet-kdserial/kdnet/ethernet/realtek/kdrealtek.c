@@ -72,14 +72,378 @@ ULONG KdNetRxError;
 ULONG KdNetRxNoDescriptorAvailable;
 ULONG KdNetRxFifoOverflow;
 
+#if REALTEK_RX_RING_CHECK
+
+ULONG KdNetRxRingCheckFailures;
+
+#endif
+
+//
+// The ring configuration requested through the loader options, clamped to
+// what the hardware supports.  Every adapter initialized by this module
+// instance is laid out with it.
+//
+
+KDNET_RING_PARAMETERS RealtekRings = {
+    REALTEK_DEFAULT_RX_DESC,
+    REALTEK_DEFAULT_TX_DESC,
+    REALTEK_MAX_PKT_SIZE,
+    REALTEK_DEFAULT_TX_DESC
+};
+
+//
+// Set when the loader options request that the hardware only receive frames
+// addressed to the target and broadcast frames.
+//
+
+BOOLEAN RealtekRxFilter;
+
+ULONG
+RealtekClampDescriptorCount (
+    __in ULONG Count,
+    __in ULONG Default
+    )
+{
+    if (Count == 0) {
+        return Default;
+    }
+
+    if (Count < REALTEK_MIN_DESC) {
+        Count = REALTEK_MIN_DESC;
+
+    } else if (Count > REALTEK_MAX_DESC) {
+        Count = REALTEK_MAX_DESC;
+    }
+
+    return ALIGN_UP_BY(Count, REALTEK_DESC_ALIGNMENT / sizeof(TX_DESC));
+}
+
+VOID
+RealtekSetRingParameters (
+    __in_opt PCHAR LoaderOptions
+    )
+
+/*++
+
+Routine Description:
+
+    This function sets the ring configuration from the rxdepth, txdepth,
+    bufsize and inflight loader options.  It runs in both the loader and the
+    kernel instance of the module with the same options, so both size the
+    hardware context the same.
+
+Arguments:
+
+    LoaderOptions - Supplies the loader options passed to the module.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    ULONG BufferSize;
+    ULONG MaxInFlight;
+
+    RealtekRings.RxDepth =
+        RealtekClampDescriptorCount(
+            KdNetParseLoaderOption(LoaderOptions, KDNET_RX_DEPTH_OPTION),
+            REALTEK_DEFAULT_RX_DESC);
+
+    RealtekRings.TxDepth =
+        RealtekClampDescriptorCount(
+            KdNetParseLoaderOption(LoaderOptions, KDNET_TX_DEPTH_OPTION),
+            REALTEK_DEFAULT_TX_DESC);
+
+    //
+    // Packets larger than a 2 KB buffer are only possible as jumbo frames.
+    //
+
+    BufferSize = KdNetParseLoaderOption(LoaderOptions, KDNET_BUFFER_SIZE_OPTION);
+    if (BufferSize <= REALTEK_MAX_PKT_SIZE) {
+        BufferSize = REALTEK_MAX_PKT_SIZE;
+
+    } else if (BufferSize > REALTEK_MAX_JUMBO_SIZE) {
+        BufferSize = REALTEK_MAX_JUMBO_SIZE;
+    }
+
+    RealtekRings.BufferSize = BufferSize;
+
+    //
+    // Every TX descriptor can be in flight at once unless a lower limit is
+    // requested.
+    //
+
+    MaxInFlight = KdNetParseLoaderOption(LoaderOptions, KDNET_IN_FLIGHT_OPTION);
+    if ((MaxInFlight == 0) || (MaxInFlight > RealtekRings.TxDepth)) {
+        MaxInFlight = RealtekRings.TxDepth;
+    }
+
+    RealtekRings.MaxInFlight = MaxInFlight;
+    return;
+}
+
+VOID
+RealtekSetRxFilter (
+    __in_opt PCHAR LoaderOptions
+    )
+
+/*++
+
+Routine Description:
+
+    This function records whether the rxfilter loader option requested
+    hardware receive filtering.
+
+Arguments:
+
+    LoaderOptions - Supplies the loader options passed to the module.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    RealtekRxFilter = FALSE;
+    if (KdNetParseLoaderOption(LoaderOptions, KDNET_RX_FILTER_OPTION) != 0) {
+        RealtekRxFilter = TRUE;
+    }
+
+    return;
+}
+
+VOID
+RealtekGetRxFilterHash (
+    __in PUCHAR MacAddress,
+    __out_ecount(8) PUCHAR Hash
+    )
+
+/*++
+
+Routine Description:
+
+    This function computes the MAR multicast hash that lets the multicast
+    groups KdNetGetRxFilterMulticast returns through.  A group selects the
+    hash bit given by the top 6 bits of the big endian CRC-32 of its address.
+    The RTL8169 and the later RTL8168/8101 parts store the 64 bit hash in
+    opposite byte order, so each bit is set at both positions rather than
+    tracking the chip version.  The few extra multicast frames this can let
+    in are dropped by KDNET's own classification.
+
+Arguments:
+
+    MacAddress - Supplies the target MAC address.
+
+    Hash - Receives the 8 bytes to write to MAR0 through MAR7.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    ULONG Bit;
+    ULONG Crc;
+    ULONG Group;
+    UCHAR Groups[KDNET_RX_FILTER_MULTICAST_COUNT][MAC_ADDRESS_SIZE];
+    ULONG Index;
+    UCHAR Octet;
+
+    RtlZeroMemory(Hash, 8);
+    KdNetGetRxFilterMulticast(MacAddress, Groups);
+    for (Group = 0; Group < KDNET_RX_FILTER_MULTICAST_COUNT; Group += 1) {
+        Crc = 0xFFFFFFFF;
+        for (Index = 0; Index < MAC_ADDRESS_SIZE; Index += 1) {
+            Octet = Groups[Group][Index];
+            for (Bit = 0; Bit < 8; Bit += 1) {
+                if (((Crc >> 31) ^ (Octet & 1)) != 0) {
+                    Crc = (Crc << 1) ^ 0x04C11DB7;
+
+                } else {
+                    Crc <<= 1;
+                }
+
+                Octet >>= 1;
+            }
+        }
+
+        Bit = Crc >> 26;
+        Hash[Bit >> 3] |= (UCHAR)(1 << (Bit & 7));
+        Hash[7 - (Bit >> 3)] |= (UCHAR)(1 << (Bit & 7));
+    }
+
+    return;
+}
+
+ULONG
+RealtekGetDescriptorsPerFrame (
+    VOID
+    )
+{
+    return (RealtekRings.BufferSize + REALTEK_MAX_PKT_SIZE - 1) /
+           REALTEK_MAX_PKT_SIZE;
+}
+
+ULONG
+RealtekGetDescriptorOffset (
+    VOID
+    )
+{
+    return ALIGN_UP_BY(sizeof(REALTEK_ADAPTER), REALTEK_DESC_ALIGNMENT);
+}
+
+ULONG
+RealtekGetBufferOffset (
+    VOID
+    )
+{
+    ULONG Offset;
+
+    Offset = RealtekGetDescriptorOffset();
+    Offset += RealtekRings.TxDepth * sizeof(TX_DESC);
+    Offset += RealtekRings.RxDepth * sizeof(RX_DESC);
+    return ALIGN_UP_BY(Offset, PAGE_SIZE);
+}
+
 ULONG
 RealtekGetHardwareContextSize (
     __in PDEBUG_DEVICE_DESCRIPTOR Device
 )
+
+/*++
+
+Routine Description:
+
+    This function returns the size of the hardware context: the adapter, the
+    descriptor rings and the packet buffer pools for the configured number of
+    descriptors, including the spare buffers jumbo frames need at the end of
+    each pool and the RX release flags.
+
+Arguments:
+
+    Device - Supplies a pointer to the debug device descriptor.
+
+Return Value:
+
+    The size of the hardware context in bytes.
+
+--*/
+
 {
     UNREFERENCED_PARAMETER(Device);
 
-    return sizeof(REALTEK_ADAPTER);
+    return RealtekGetBufferOffset() +
+           ((RealtekRings.TxDepth + RealtekRings.RxDepth +
+             ((RealtekGetDescriptorsPerFrame() - 1) * 2)) *
+            sizeof(REALTEK_PKT_BUFF)) +
+           (RealtekRings.RxDepth * sizeof(BOOLEAN));
+}
+
+BOOLEAN
+RealtekJumboFramesSupported (
+    __in PREALTEK_ADAPTER Adapter
+    )
+
+/*++
+
+Routine Description:
+
+    This function determines whether jumbo frames were requested and can be
+    used with the controller.  The RTL8169 counts MTPS in 32 byte chunks and
+    cannot send packets larger than 2 KB, and the RTL8136 and RTL8101 fast
+    Ethernet controllers do not support jumbo frames at all.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+Return Value:
+
+    TRUE if jumbo frames should be enabled.
+
+--*/
+
+{
+    if (RealtekRings.BufferSize <= REALTEK_MAX_PKT_SIZE) {
+        return FALSE;
+    }
+
+    switch (Adapter->ChipType) {
+    case RTL8168B:
+    case RTL8168B_REV_E:
+    case RTL8168B_REV_F:
+    case RTL8168C:
+    case RTL8168C_REV_G:
+    case RTL8168C_REV_K:
+    case RTL8168C_REV_M:
+    case RTL8168CP:
+    case RTL8168CP_REV_B:
+    case RTL8168CP_REV_C:
+    case RTL8168CP_REV_D:
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+VOID
+RealtekLayoutContext (
+    __in PREALTEK_ADAPTER Adapter
+    )
+
+/*++
+
+Routine Description:
+
+    This function carves the descriptor rings and the packet buffer pools out
+    of the hardware context that follows the adapter.  Jumbo frames are only
+    enabled if the controller supports them, but the pools are always laid
+    out for the requested buffer size since the context was sized for it.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    PUCHAR Context;
+    ULONG Spare;
+
+    Context = (PUCHAR)Adapter;
+    Spare = RealtekGetDescriptorsPerFrame() - 1;
+    Adapter->NumTxDesc = RealtekRings.TxDepth;
+    Adapter->NumRxDesc = RealtekRings.RxDepth;
+    Adapter->DescPerFrame = 1;
+    if (RealtekJumboFramesSupported(Adapter) != FALSE) {
+        Adapter->DescPerFrame = Spare + 1;
+    }
+
+    //
+    // The in flight limit is kept in descriptors.
+    //
+
+    Adapter->MaxTxInFlight = RealtekRings.MaxInFlight * Adapter->DescPerFrame;
+    if (Adapter->MaxTxInFlight > Adapter->NumTxDesc) {
+        Adapter->MaxTxInFlight = Adapter->NumTxDesc;
+    }
+
+    Adapter->TxReserved = FALSE;
+    Adapter->txDesc = (PTX_DESC)(Context + RealtekGetDescriptorOffset());
+    Adapter->rxDesc = (PRX_DESC)(Adapter->txDesc + Adapter->NumTxDesc);
+    Adapter->txBuffers = (PREALTEK_PKT_BUFF)(Context + RealtekGetBufferOffset());
+    Adapter->rxBuffers = Adapter->txBuffers + Adapter->NumTxDesc + Spare;
+    Adapter->rxReleased = (PBOOLEAN)(Adapter->rxBuffers + Adapter->NumRxDesc + Spare);
+    return;
 }
 
 NTSTATUS
@@ -206,7 +570,7 @@ MP_WritePhyUshort(
 
 {
     ULONG TmpUlong=0x80000000;
-    ULONG Timeout=0,WaitCount=10;
+    ULONG Timeout;
 
     TmpUlong |= ( ((ULONG)RegAddr<<16) | (ULONG)RegData );
     WriteRegister(PhyAccessReg, TmpUlong);
@@ -215,13 +579,15 @@ MP_WritePhyUshort(
     // Wait for writing to Phy ok 
     //
 
-    do {
-        KeStallExecutionProcessor(20);
+    for (Timeout = 0; Timeout < PHY_ACCESS_TIME; Timeout += PHY_ACCESS_POLL) {
+        KeStallExecutionProcessor(PHY_ACCESS_POLL);
         TmpUlong = ReadRegister(PhyAccessReg);
-        Timeout++;
-    } while ((TmpUlong & PHYAR_Flag) && (Timeout<WaitCount));
+        if ((TmpUlong & PHYAR_Flag) == 0) {
+            break;
+        }
+    }
 
-    KeStallExecutionProcessor(5);
+    KeStallExecutionProcessor(PHY_ACCESS_SETTLE);
     return;
 }
 
@@ -234,7 +600,7 @@ MP_ReadPhyUshort(
 {
     USHORT RegData;
     ULONG TmpUlong=0x00000000;
-    ULONG Timeout=0,WaitCount=10;
+    ULONG Timeout;
 
     TmpUlong |= ( (ULONG)RegAddr << 16);
     WriteRegister(PhyAccessReg, TmpUlong);
@@ -243,15 +609,17 @@ MP_ReadPhyUshort(
     // Wait for reading from Phy ok 
     //
 
-    do {
-        KeStallExecutionProcessor(20);
+    for (Timeout = 0; Timeout < PHY_ACCESS_TIME; Timeout += PHY_ACCESS_POLL) {
+        KeStallExecutionProcessor(PHY_ACCESS_POLL);
         TmpUlong = ReadRegister(PhyAccessReg);
-        Timeout++;
-    } while ( (!(TmpUlong & PHYAR_Flag)) && (Timeout<WaitCount) );
+        if (TmpUlong & PHYAR_Flag) {
+            break;
+        }
+    }
 
     TmpUlong = ReadRegister(PhyAccessReg);
     RegData = (USHORT)(TmpUlong & 0x0000ffff);
-    KeStallExecutionProcessor(5);
+    KeStallExecutionProcessor(PHY_ACCESS_SETTLE);
     return RegData;
 }
 
@@ -283,15 +651,15 @@ WritePciExpressPhyUshort(
 
     Timeout = 0;
     do {
-        KeStallExecutionProcessor(10);
+        KeStallExecutionProcessor(PHY_ACCESS_POLL);
         Value=Adapter->BaseAddress->EPhy8168.EPhyAccessReg;
         if ((Value & EPHYAR_Flag) == FALSE) {
             Status = STATUS_SUCCESS;
             break;
         }
 
-        Timeout++;
-    } while (Timeout < 100);
+        Timeout += PHY_ACCESS_POLL;
+    } while (Timeout < EPHY_ACCESS_TIME);
 
     return Status;
 }
@@ -662,17 +1030,20 @@ Return Value:
 }
 
 NTSTATUS
-RealtekGetTxPacket (
+RealtekGetTxFrame (
     __in PREALTEK_ADAPTER Adapter,
     __out PULONG Handle
-)
+    )
 
 /*++
 
 Routine Description:
 
-    This function acquires the hardware resources needed to send a packet and
-    returns a handle to those resources.
+    This function reserves the transmit descriptors for a jumbo frame.  The
+    length of the packet is not known until it is sent, so enough consecutive
+    descriptors for the largest packet must be free, and only one packet can
+    be reserved at a time.  The descriptors actually used are handed to the
+    hardware, and the transmit index advanced past them, by RealtekSendTxFrame.
 
 Arguments:
 
@@ -687,97 +1058,288 @@ Return Value:
 
     STATUS_IO_TIMEOUT if the hardware resources could not be reserved.
 
-    STATUS_INVALID_PARAMETER if an invalid Handle pointer or Adapter is passed.
-
 --*/
 
 {
     ULONG Index;
-    NTSTATUS Status;
+    ULONG Last;
+    ULONG Oldest;
 
-    if ((Adapter == NULL) || (Handle == NULL)) {
-        Status = STATUS_INVALID_PARAMETER;
-        goto GetTxPacketEnd;
+    if (Adapter->TxReserved != FALSE) {
+        return STATUS_IO_TIMEOUT;
     }
 
     Index = Adapter->TxIndex;
-    Status = STATUS_IO_TIMEOUT;
-    if ((Adapter->txDesc[Index].status & RXS_OWN) == FALSE) {
-        *Handle = Index | TRANSMIT_HANDLE;
-
-        //
-        // Reinitialize the packet transmit descriptor.  (Except for the buffer
-        // address which is written only during initialization since it does not
-        // change.)
-        //
+    Last = Index + Adapter->DescPerFrame - 1;
+    if (Last >= Adapter->NumTxDesc) {
+        Last -= Adapter->NumTxDesc;
+    }
 
-        Adapter->txDesc[Index].VLAN_TAG.Value = 0;
-        Adapter->txDesc[Index].TAGC = 0;
-        Adapter->txDesc[Index].length = 0;
-        Adapter->txDesc[Index].status = TXS_LS | TXS_FS;
-        if (Index == (NUM_TX_DESC - 1)) {
-            Adapter->txDesc[Index].status |= TXS_EOR;
-        }
+    Oldest = Index + Adapter->NumTxDesc - Adapter->MaxTxInFlight;
+    if (Oldest >= Adapter->NumTxDesc) {
+        Oldest -= Adapter->NumTxDesc;
+    }
 
-        //
-        // Calculate the next transmit index.
-        //
+    if (((Adapter->txDesc[Last].status & TXS_OWN) != FALSE) ||
+        ((Adapter->txDesc[Oldest].status & TXS_OWN) != FALSE)) {
 
-        Index += 1;
-        if (Index >= NUM_TX_DESC) {
-            Index = 0;
-        }
+        return STATUS_IO_TIMEOUT;
+    }
 
-        Adapter->TxIndex = Index;
-        Status = STATUS_SUCCESS;
+    Adapter->txDesc[Index].VLAN_TAG.Value = 0;
+    Adapter->txDesc[Index].TAGC = 0;
+    Adapter->txDesc[Index].length = 0;
+    Adapter->txDesc[Index].status = TXS_LS | TXS_FS;
+    if (Index == (Adapter->NumTxDesc - 1)) {
+        Adapter->txDesc[Index].status |= TXS_EOR;
     }
 
-GetTxPacketEnd:
-    return Status;
+    Adapter->TxReserved = TRUE;
+    *Handle = Index | TRANSMIT_HANDLE;
+    return STATUS_SUCCESS;
 }
 
-NTSTATUS
-RealtekSendTxPacket (
+ULONG
+RealtekSendTxFrame (
     __in PREALTEK_ADAPTER Adapter,
-    ULONG Handle,
+    ULONG Index,
     ULONG Length
-)
+    )
 
 /*++
 
 Routine Description:
 
-    This function sends the packet associated with the passed Handle out to the
-    network.  It does not return until the packet has been sent.
+    This function hands a jumbo frame reserved by RealtekGetTxFrame to the
+    hardware.  The packet is split over as many 2 KB buffers as it needs.
+    Ownership of the first descriptor is passed last so that the hardware
+    never sees a partially built chain.
 
 Arguments:
 
     Adapter - Supplies a pointer to the debug adapter object.
 
-    Handle - Supplies the handle of the packet to send.
+    Index - Supplies the index of the first descriptor of the packet.
 
     Length - Supplies the length of the packet to send.
 
 Return Value:
 
-    STATUS_SUCCESS when a packet has been successfully sent.
-
-    STATUS_IO_TIMEOUT if the packet could not be sent within 100ms.
-
-    STATUS_INVALID_PARAMETER if an invalid Handle or Adapter is passed.
+    The index of the last descriptor of the packet.
 
 --*/
 
 {
-    ULONG Index;
+    ULONG Chunk;
+    ULONG Count;
+    ULONG Descriptor;
+    ULONG Last;
+    USHORT Options;
+    USHORT TxStatus;
+    ULONG Wrapped;
+
+    Count = (Length + REALTEK_MAX_PKT_SIZE - 1) / REALTEK_MAX_PKT_SIZE;
+    if (Count == 0) {
+        Count = 1;
+    }
+
+    //
+    // The caller filled the packet in contiguously, so the part of it that
+    // runs past the end of the ring sits in the spare buffers after the pool.
+    // Move it to the buffers the wrapped descriptors point at.
+    //
+
+    if ((Index + Count) > Adapter->NumTxDesc) {
+        Wrapped = Index + Count - Adapter->NumTxDesc;
+        RtlCopyMemory(&Adapter->txBuffers[0],
+                      &Adapter->txBuffers[Adapter->NumTxDesc],
+                      Wrapped * sizeof(REALTEK_PKT_BUFF));
+    }
+
+    Last = Index + Count - 1;
+    if (Last >= Adapter->NumTxDesc) {
+        Last -= Adapter->NumTxDesc;
+    }
+
+    Adapter->TxIndex = Last + 1;
+    if (Adapter->TxIndex >= Adapter->NumTxDesc) {
+        Adapter->TxIndex = 0;
+    }
+
+    Adapter->TxReserved = FALSE;
+
+    //
+    // Build the chain from the last descriptor back to the first.
+    //
+
+    Options = Adapter->txDesc[Index].TAGC;
+    Descriptor = Last;
+    for (Chunk = Count; Chunk > 0; Chunk -= 1) {
+        TxStatus = TXS_OWN;
+        if (Chunk == 1) {
+            TxStatus |= TXS_FS;
+        }
+
+        if (Chunk == Count) {
+            TxStatus |= TXS_LS;
+        }
+
+        if (Descriptor == (Adapter->NumTxDesc - 1)) {
+            TxStatus |= TXS_EOR;
+        }
+
+        Adapter->txDesc[Descriptor].VLAN_TAG.Value = 0;
+        Adapter->txDesc[Descriptor].TAGC = Options;
+        Adapter->txDesc[Descriptor].length =
+            (USHORT)(Length - ((Chunk - 1) * REALTEK_MAX_PKT_SIZE));
+
+        Length = (Chunk - 1) * REALTEK_MAX_PKT_SIZE;
+        Adapter->txDesc[Descriptor].status = TxStatus;
+        Descriptor = (Descriptor == 0) ? (Adapter->NumTxDesc - 1) :
+                                         (Descriptor - 1);
+    }
+
+    return Last;
+}
+
+NTSTATUS
+RealtekGetTxPacket (
+    __in PREALTEK_ADAPTER Adapter,
+    __out PULONG Handle
+)
+
+/*++
+
+Routine Description:
+
+    This function acquires the hardware resources needed to send a packet and
+    returns a handle to those resources.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Handle - Supplies a pointer to the handle for the packet for which hardware
+        resources have been reserved.
+
+Return Value:
+
+    STATUS_SUCCESS when hardware resources have been successfully reserved.
+
+    STATUS_IO_TIMEOUT if the hardware resources could not be reserved.
+
+    STATUS_INVALID_PARAMETER if an invalid Handle pointer or Adapter is passed.
+
+--*/
+
+{
+    ULONG Index;
+    ULONG Oldest;
+    NTSTATUS Status;
+
+    if ((Adapter == NULL) || (Handle == NULL)) {
+        Status = STATUS_INVALID_PARAMETER;
+        goto GetTxPacketEnd;
+    }
+
+    if (Adapter->DescPerFrame > 1) {
+        Status = RealtekGetTxFrame(Adapter, Handle);
+        goto GetTxPacketEnd;
+    }
+
+    //
+    // Transmits complete in ring order, so handing out this descriptor keeps
+    // no more than MaxTxInFlight packets outstanding as long as the descriptor
+    // MaxTxInFlight entries back has been released by the hardware.  With no
+    // in flight limit that is this same descriptor.
+    //
+
+    Index = Adapter->TxIndex;
+    Oldest = Index + Adapter->NumTxDesc - Adapter->MaxTxInFlight;
+    if (Oldest >= Adapter->NumTxDesc) {
+        Oldest -= Adapter->NumTxDesc;
+    }
+
+    Status = STATUS_IO_TIMEOUT;
+    if (((Adapter->txDesc[Index].status & RXS_OWN) == FALSE) &&
+        ((Adapter->txDesc[Oldest].status & RXS_OWN) == FALSE)) {
+        *Handle = Index | TRANSMIT_HANDLE;
+
+        //
+        // Reinitialize the packet transmit descriptor.  (Except for the buffer
+        // address which is written only during initialization since it does not
+        // change.)
+        //
+
+        Adapter->txDesc[Index].VLAN_TAG.Value = 0;
+        Adapter->txDesc[Index].TAGC = 0;
+        Adapter->txDesc[Index].length = 0;
+        Adapter->txDesc[Index].status = TXS_LS | TXS_FS;
+        if (Index == (Adapter->NumTxDesc - 1)) {
+            Adapter->txDesc[Index].status |= TXS_EOR;
+        }
+
+        //
+        // Calculate the next transmit index.
+        //
+
+        Index += 1;
+        if (Index >= Adapter->NumTxDesc) {
+            Index = 0;
+        }
+
+        Adapter->TxIndex = Index;
+        Status = STATUS_SUCCESS;
+    }
+
+GetTxPacketEnd:
+    return Status;
+}
+
+NTSTATUS
+RealtekSendTxPacket (
+    __in PREALTEK_ADAPTER Adapter,
+    ULONG Handle,
+    ULONG Length
+)
+
+/*++
+
+Routine Description:
+
+    This function sends the packet associated with the passed Handle out to the
+    network.  It does not return until the packet has been sent.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Handle - Supplies the handle of the packet to send.
+
+    Length - Supplies the length of the packet to send.
+
+Return Value:
+
+    STATUS_SUCCESS when a packet has been successfully sent.
+
+    STATUS_IO_TIMEOUT if the packet could not be sent within 100ms.
+
+    STATUS_INVALID_PARAMETER if an invalid Handle or Adapter is passed.
+
+--*/
+
+{
+    ULONG Index;
     USHORT InterruptStatus;
+    ULONG Last;
     NTSTATUS Status;
     ULONG Timeout;
     USHORT TxStatus;
 
     Index = (Handle & ~HANDLE_FLAGS);
     if ((Adapter == NULL) || ((Handle & TRANSMIT_HANDLE) == FALSE) ||
-        (Index >= NUM_TX_DESC) || (Length > 0xffff)) {
+        (Index >= Adapter->NumTxDesc) || (Length > 0xffff) ||
+        ((Adapter->DescPerFrame > 1) && (Length > RealtekRings.BufferSize))) {
         Status = STATUS_INVALID_PARAMETER;
         goto SendTxPacketEnd;
     }
@@ -795,12 +1357,19 @@ Return Value:
 
         //
         // Write the packet length into the packet descriptor.  Then mark the
-        // descriptor as owned by the hardware.
+        // descriptor as owned by the hardware.  Jumbo frames are chained over
+        // as many descriptors as they need.
         //
 
-        Adapter->txDesc[Index].length = (USHORT)Length;
-        TxStatus |= TXS_OWN;
-        Adapter->txDesc[Index].status = TxStatus;
+        if (Adapter->DescPerFrame > 1) {
+            Last = RealtekSendTxFrame(Adapter, Index, Length);
+
+        } else {
+            Adapter->txDesc[Index].length = (USHORT)Length;
+            TxStatus |= TXS_OWN;
+            Adapter->txDesc[Index].status = TxStatus;
+            Last = Index;
+        }
 
         //
         // Tell the adapter to start DMA.
@@ -826,7 +1395,7 @@ Return Value:
 
         Timeout = 100000;
         for (;;) {
-            TxStatus = Adapter->txDesc[Index].status;
+            TxStatus = Adapter->txDesc[Last].status;
             if ((TxStatus & TXS_OWN) == FALSE) {
                 InterruptStatus = ReadRegister(ISR);
                 if ((InterruptStatus & ISRIMR_TER) == ISRIMR_TER) {
@@ -865,51 +1434,430 @@ SetTxOptions (
     NTSTATUS Status;
     USHORT TxStatus;
 
-    Index = (Handle & ~HANDLE_FLAGS);
-    if ((Adapter == NULL) || ((Handle & TRANSMIT_HANDLE) == FALSE) ||
-        (Index >= NUM_TX_DESC)) {
-        Status = STATUS_INVALID_PARAMETER;
-        goto SetTxOptionsEnd;
+    Index = (Handle & ~HANDLE_FLAGS);
+    if ((Adapter == NULL) || ((Handle & TRANSMIT_HANDLE) == FALSE) ||
+        (Index >= Adapter->NumTxDesc)) {
+        Status = STATUS_INVALID_PARAMETER;
+        goto SetTxOptionsEnd;
+    }
+
+    Status = STATUS_UNSUCCESSFUL;
+    TxStatus = Adapter->txDesc[Index].status;
+    if ((TxStatus & TXS_OWN) == FALSE) {
+        Adapter->txDesc[Index].TAGC= Options;
+        Status = STATUS_SUCCESS;
+    }
+
+SetTxOptionsEnd:
+    return Status;
+}
+
+NTSTATUS
+GetTxOptions (
+    __in PREALTEK_ADAPTER Adapter,
+    ULONG Handle,
+    __out PUSHORT Options
+)
+{
+    ULONG Index;
+    NTSTATUS Status;
+    USHORT TxStatus;
+
+    Index = (Handle & ~HANDLE_FLAGS);
+    if ((Adapter == NULL) || ((Handle & TRANSMIT_HANDLE) == FALSE) ||
+        (Index >= Adapter->NumTxDesc) || (Options == NULL)) {
+        Status = STATUS_INVALID_PARAMETER;
+        goto SetTxOptionsEnd;
+    }
+
+    Status = STATUS_UNSUCCESSFUL;
+    TxStatus = Adapter->txDesc[Index].status;
+    if ((TxStatus & TXS_OWN) == FALSE) {
+        *Options = Adapter->txDesc[Index].TAGC;
+        Status = STATUS_SUCCESS;
+    }
+
+SetTxOptionsEnd:
+    return Status;
+}
+
+VOID
+RealtekRecycleRxDescriptors (
+    __in PREALTEK_ADAPTER Adapter,
+    ULONG Index,
+    ULONG Count
+    )
+
+/*++
+
+Routine Description:
+
+    This function hands a run of receive descriptors back to the hardware.
+    Every descriptor is reinitialized first, and ownership of the whole run is
+    passed to the hardware after a single memory barrier.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Index - Supplies the index of the first descriptor to hand back.
+
+    Count - Supplies the number of descriptors to hand back.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    ULONG First;
+    ULONG Remaining;
+    USHORT Status;
+
+    First = Index;
+    Remaining = Count;
+    while (Remaining > 0) {
+
+        //
+        // Zero out the packet buffer.
+        //
+
+        RtlZeroMemory(&Adapter->rxBuffers[Index],
+                      sizeof(Adapter->rxBuffers[Index]));
+
+        //
+        // Reinitialize the packet receive descriptor.  (Except for the buffer
+        // address which is written only during initialization since it does
+        // not change.)
+        //
+
+        Adapter->rxDesc[Index].VLAN_TAG.Value = 0;
+        Adapter->rxDesc[Index].TAVA = 0;
+        Adapter->rxDesc[Index].length = REALTEK_MAX_PKT_SIZE;
+        Adapter->rxDesc[Index].CheckSumStatus = 0;
+        Adapter->rxReleased[Index] = FALSE;
+
+        Index += 1;
+        if (Index >= Adapter->NumRxDesc) {
+            Index = 0;
+        }
+
+        Remaining -= 1;
+    }
+
+    KeMemoryBarrier();
+
+    //
+    // Pass ownership to the hardware.  Make sure to set the end of ring bit if
+    // the Index points to the last descriptor in the ring.
+    //
+
+    Index = First;
+    while (Count > 0) {
+        Status = RXS_OWN;
+        if (Index == (Adapter->NumRxDesc - 1)) {
+            Status |= RXS_EOR;
+        }
+
+        Adapter->rxDesc[Index].status = Status;
+        Index += 1;
+        if (Index >= Adapter->NumRxDesc) {
+            Index = 0;
+        }
+
+        Count -= 1;
+    }
+
+    return;
+}
+
+VOID
+RealtekRefillRxDescriptors (
+    __in PREALTEK_ADAPTER Adapter
+    )
+
+/*++
+
+Routine Description:
+
+    This function hands released receive descriptors back to the hardware.
+    Only the run of released descriptors starting at the oldest one held by
+    software can be handed back, since the hardware fills the ring in order.
+    The run is held back until it reaches REALTEK_RX_REFILL_BATCH descriptors
+    unless the hardware is left with fewer than that to receive into.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    ULONG Index;
+    USHORT InterruptStatus;
+    ULONG Run;
+
+    Index = Adapter->RxRefillIndex;
+    Run = 0;
+    while ((Run < Adapter->RxHeld) && (Adapter->rxReleased[Index] != FALSE)) {
+        Run += 1;
+        Index += 1;
+        if (Index >= Adapter->NumRxDesc) {
+            Index = 0;
+        }
+    }
+
+    if ((Run == 0) ||
+        ((Run < REALTEK_RX_REFILL_BATCH) &&
+         ((Adapter->NumRxDesc - Adapter->RxHeld) >= REALTEK_RX_REFILL_BATCH))) {
+
+        return;
+    }
+
+    RealtekRecycleRxDescriptors(Adapter, Adapter->RxRefillIndex, Run);
+    Adapter->RxRefillIndex = Index;
+    Adapter->RxHeld -= Run;
+
+    //
+    // Check the Interrupt Status register and track which receive bits are set.
+    //
+
+    InterruptStatus = ReadRegister(ISR);
+    InterruptStatus &= (ISRIMR_RX_FOVW | ISRIMR_RDU | ISRIMR_RER | ISRIMR_ROK);
+    KdNetRxOk += ((InterruptStatus & ISRIMR_ROK) != FALSE);
+    KdNetRxError += ((InterruptStatus & ISRIMR_RER) != FALSE);
+    KdNetRxNoDescriptorAvailable += ((InterruptStatus & ISRIMR_RDU) != FALSE);
+    KdNetRxFifoOverflow += ((InterruptStatus & ISRIMR_RX_FOVW) != FALSE);
+
+    //
+    // Clear the receive status bits in the ISR.  This will restart the DMA
+    // engine if it stopped because it ran out of receive descriptors, or the
+    // FIFO overflowed.
+    //
+
+    WriteRegister(ISR, InterruptStatus);
+    return;
+}
+
+VOID
+RealtekReleaseRxDescriptors (
+    __in PREALTEK_ADAPTER Adapter,
+    ULONG Index,
+    ULONG Count
+    )
+
+/*++
+
+Routine Description:
+
+    This function marks a run of receive descriptors held by software as
+    released, and hands any that are ready back to the hardware.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Index - Supplies the index of the first descriptor to release.
+
+    Count - Supplies the number of descriptors to release.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    while (Count > 0) {
+        Adapter->rxReleased[Index] = TRUE;
+        Index += 1;
+        if (Index >= Adapter->NumRxDesc) {
+            Index = 0;
+        }
+
+        Count -= 1;
+    }
+
+    RealtekRefillRxDescriptors(Adapter);
+    return;
+}
+
+#if REALTEK_RX_RING_CHECK
+
+VOID
+RealtekCheckRxRing (
+    __in PREALTEK_ADAPTER Adapter
+    )
+
+/*++
+
+Routine Description:
+
+    This function validates the receive ring bookkeeping.  The descriptors
+    from RxRefillIndex up to RxIndex are held by software, so none of them
+    may be owned by the hardware, and no descriptor outside of them may be
+    marked as released.  Failures are counted in KdNetRxRingCheckFailures.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    ULONG Count;
+    ULONG Index;
+
+    if ((Adapter->RxHeld > Adapter->NumRxDesc) ||
+        (Adapter->RxRefillIndex >= Adapter->NumRxDesc) ||
+        (Adapter->RxIndex >= Adapter->NumRxDesc) ||
+        (((Adapter->RxRefillIndex + Adapter->RxHeld) % Adapter->NumRxDesc) !=
+         Adapter->RxIndex)) {
+
+        KdNetRxRingCheckFailures += 1;
+        return;
+    }
+
+    Index = Adapter->RxRefillIndex;
+    for (Count = 0; Count < Adapter->NumRxDesc; Count += 1) {
+        if (Count < Adapter->RxHeld) {
+            if ((Adapter->rxDesc[Index].status & RXS_OWN) != FALSE) {
+                KdNetRxRingCheckFailures += 1;
+                return;
+            }
+
+        } else if (Adapter->rxReleased[Index] != FALSE) {
+            KdNetRxRingCheckFailures += 1;
+            return;
+        }
+
+        Index += 1;
+        if (Index >= Adapter->NumRxDesc) {
+            Index = 0;
+        }
+    }
+
+    return;
+}
+
+#endif
+
+NTSTATUS
+RealtekGetRxFrame (
+    __in PREALTEK_ADAPTER Adapter,
+    __out PULONG Handle,
+    __out PVOID *Packet,
+    __out PULONG Length
+    )
+
+/*++
+
+Routine Description:
+
+    This function returns the next received packet when jumbo frames are
+    enabled.  A packet is available once every descriptor from the one with
+    the FS bit to the one with the LS bit has been released by the hardware.
+    The length of the whole packet, which the hardware reports in the last
+    descriptor, is recorded in the first one so that the packet handle
+    describes the whole chain.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Handle - Supplies a pointer to the handle for this packet.
+
+    Packet - Supplies a pointer that will be written with the address of the
+        start of the packet.
+
+    Length - Supplies a pointer that will be written with the length of the
+        recieved packet.
+
+Return Value:
+
+    STATUS_SUCCESS when a packet has been received.
+
+    STATUS_IO_TIMEOUT otherwise.
+
+--*/
+
+{
+    ULONG Count;
+    ULONG First;
+    ULONG Index;
+    USHORT RxStatus;
+
+    First = Adapter->RxIndex;
+    Index = First;
+    Count = 1;
+    for (;;) {
+        if ((Adapter->RxHeld + Count) > Adapter->NumRxDesc) {
+            return STATUS_IO_TIMEOUT;
+        }
+
+        RxStatus = Adapter->rxDesc[Index].status;
+        if ((RxStatus & RXS_OWN) != FALSE) {
+            return STATUS_IO_TIMEOUT;
+        }
+
+        if (((RxStatus & RXS_LS) != FALSE) ||
+            (Count == Adapter->DescPerFrame)) {
+
+            break;
+        }
+
+        Index += 1;
+        if (Index >= Adapter->NumRxDesc) {
+            Index = 0;
+        }
+
+        Count += 1;
     }
 
-    Status = STATUS_UNSUCCESSFUL;
-    TxStatus = Adapter->txDesc[Index].status;
-    if ((TxStatus & TXS_OWN) == FALSE) {
-        Adapter->txDesc[Index].TAGC= Options;
-        Status = STATUS_SUCCESS;
+    Adapter->RxIndex = Index + 1;
+    if (Adapter->RxIndex >= Adapter->NumRxDesc) {
+        Adapter->RxIndex = 0;
     }
 
-SetTxOptionsEnd:
-    return Status;
-}
+    Adapter->RxHeld += Count;
 
-NTSTATUS
-GetTxOptions (
-    __in PREALTEK_ADAPTER Adapter,
-    ULONG Handle,
-    __out PUSHORT Options
-)
-{
-    ULONG Index;
-    NTSTATUS Status;
-    USHORT TxStatus;
+    //
+    // Drop anything that is not a whole packet that fits the buffers.
+    //
 
-    Index = (Handle & ~HANDLE_FLAGS);
-    if ((Adapter == NULL) || ((Handle & TRANSMIT_HANDLE) == FALSE) ||
-        (Index >= NUM_TX_DESC) || (Options == NULL)) {
-        Status = STATUS_INVALID_PARAMETER;
-        goto SetTxOptionsEnd;
+    if (((Adapter->rxDesc[First].status & RXS_FS) == FALSE) ||
+        ((RxStatus & RXS_LS) == FALSE)) {
+
+        RealtekReleaseRxDescriptors(Adapter, First, Count);
+        return STATUS_IO_TIMEOUT;
     }
 
-    Status = STATUS_UNSUCCESSFUL;
-    TxStatus = Adapter->txDesc[Index].status;
-    if ((TxStatus & TXS_OWN) == FALSE) {
-        *Options = Adapter->txDesc[Index].TAGC;
-        Status = STATUS_SUCCESS;
+    //
+    // Copy the part of the packet that wrapped to the start of the ring into
+    // the spare buffers after the pool so that the packet is contiguous.
+    //
+
+    if ((First + Count) > Adapter->NumRxDesc) {
+        RtlCopyMemory(&Adapter->rxBuffers[Adapter->NumRxDesc],
+                      &Adapter->rxBuffers[0],
+                      (First + Count - Adapter->NumRxDesc) *
+                        sizeof(REALTEK_PKT_BUFF));
     }
 
-SetTxOptionsEnd:
-    return Status;
+    Adapter->rxDesc[First].length = Adapter->rxDesc[Index].length;
+    *Packet = &Adapter->rxBuffers[First].u.buffer[0];
+    *Length = Adapter->rxDesc[First].length;
+    *Handle = First;
+    return STATUS_SUCCESS;
 }
 
 NTSTATUS
@@ -952,9 +1900,27 @@ Return Value:
     ULONG Index;
     NTSTATUS Status;
 
+    if (Adapter->DescPerFrame > 1) {
+        Status = RealtekGetRxFrame(Adapter, Handle, Packet, Length);
+
+#if REALTEK_RX_RING_CHECK
+
+        RealtekCheckRxRing(Adapter);
+
+#endif
+
+        return Status;
+    }
+
+    //
+    // Once every descriptor is held by software, the one at RxIndex is the
+    // oldest held packet rather than a new one.
+    //
+
     Index = Adapter->RxIndex;
     Status = STATUS_IO_TIMEOUT;
-    if ((Adapter->rxDesc[Index].status & RXS_OWN) == FALSE) {
+    if ((Adapter->RxHeld < Adapter->NumRxDesc) &&
+        ((Adapter->rxDesc[Index].status & RXS_OWN) == FALSE)) {
         *Packet = &Adapter->rxBuffers[Index].u.buffer[0];
         *Length = Adapter->rxDesc[Index].length;
         *Handle = Index;
@@ -964,14 +1930,21 @@ Return Value:
         //
 
         Index += 1;
-        if (Index >= NUM_RX_DESC) {
+        if (Index >= Adapter->NumRxDesc) {
             Index = 0;
         }
 
         Adapter->RxIndex = Index;
+        Adapter->RxHeld += 1;
         Status = STATUS_SUCCESS;
     }
 
+#if REALTEK_RX_RING_CHECK
+
+    RealtekCheckRxRing(Adapter);
+
+#endif
+
     return Status;
 }
 
@@ -986,8 +1959,9 @@ RealtekReleaseRxPacket (
 Routine Description:
 
     This function reclaims the hardware resources used for the packet
-    associated with the passed Handle.  It reprograms the hardware to use those
-    resources to receive another packet.
+    associated with the passed Handle.  Packets can be released in any order.
+    The resources are handed back to the hardware in ring order, in batches,
+    to receive other packets.
 
 Arguments:
 
@@ -1003,58 +1977,33 @@ Return Value:
 --*/
 
 {
-    ULONG Index;
-    USHORT InterruptStatus;
-    USHORT Status;
-
-    Index = Handle;
+    ULONG Count;
 
     //
-    // Calculate the status bits for this descriptor.  Make sure to set the
-    // end of ring bit if the Index points to the last descriptor in the ring.
+    // A jumbo frame occupies as many descriptors as its length needs.
     //
 
-    Status = RXS_OWN;
-    if (Index == (NUM_RX_DESC - 1)) {
-        Status |= RXS_EOR;
-    }
-
-    //
-    // Zero out the packet buffer.
-    //
+    Count = 1;
+    if (Adapter->DescPerFrame > 1) {
+        Count = (Adapter->rxDesc[Handle].length + REALTEK_MAX_PKT_SIZE - 1) /
+                REALTEK_MAX_PKT_SIZE;
 
-    RtlZeroMemory(&Adapter->rxBuffers[Index], sizeof(Adapter->rxBuffers[Index]));
+        if (Count == 0) {
+            Count = 1;
 
-    //
-    // Reinitialize the packet receive descriptor.  (Except for the buffer
-    // address which is written only during initialization since it does not
-    // change.)
-    //
+        } else if (Count > Adapter->DescPerFrame) {
+            Count = Adapter->DescPerFrame;
+        }
+    }
 
-    Adapter->rxDesc[Index].VLAN_TAG.Value = 0;
-    Adapter->rxDesc[Index].TAVA = 0;
-    Adapter->rxDesc[Index].length = REALTEK_MAX_PKT_SIZE;
-    Adapter->rxDesc[Index].CheckSumStatus = 0;
-    Adapter->rxDesc[Index].status = Status;
+    RealtekReleaseRxDescriptors(Adapter, Handle, Count);
 
-    //
-    // Check the Interrupt Status register and track which receive bits are set.
-    //
+#if REALTEK_RX_RING_CHECK
 
-    InterruptStatus = ReadRegister(ISR);
-    InterruptStatus &= (ISRIMR_RX_FOVW | ISRIMR_RDU | ISRIMR_RER | ISRIMR_ROK);
-    KdNetRxOk += ((InterruptStatus & ISRIMR_ROK) != FALSE);
-    KdNetRxError += ((InterruptStatus & ISRIMR_RER) != FALSE);
-    KdNetRxNoDescriptorAvailable += ((InterruptStatus & ISRIMR_RDU) != FALSE);
-    KdNetRxFifoOverflow += ((InterruptStatus & ISRIMR_RX_FOVW) != FALSE);
+    RealtekCheckRxRing(Adapter);
 
-    //
-    // Clear the receive status bits in the ISR.  This will restart the DMA
-    // engine if it stopped because it ran out of receive descriptors, or the
-    // FIFO overflowed.
-    //
+#endif
 
-    WriteRegister(ISR, InterruptStatus);
     return;
 }
 
@@ -1092,17 +2041,32 @@ NTSTATUS
 InitializePhysicalLayer (
     __in PREALTEK_ADAPTER Adapter
 )
+
+/*++
+
+Routine Description:
+
+    This function resets and configures the PHY and restarts
+    auto-negotiation.  It does not wait for auto-negotiation to finish, so
+    that the rest of the controller can be set up while the link comes up;
+    WaitForPhysicalLayer completes the job.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+Return Value:
+
+    STATUS_SUCCESS if auto-negotiation was started.
+
+--*/
+
 {
-    USHORT PhyRegData;
     USHORT PhyRegDataANAR;
-    USHORT PhyRegDataANER;
-    USHORT PhyRegDataBMSR;
     USHORT PhyRegDataGBCR;
-    UCHAR PhyStatus;
     ULONG TmpUlong;
     USHORT PhyRegValue;
     NTSTATUS Status;
-    ULONG Wait;
 
     Status = ResetPhysicalLayer(Adapter);
     if (!NT_SUCCESS(Status)) {
@@ -2073,17 +3037,52 @@ InitializePhysicalLayer (
                       PHY_REG_BMCR,
                       MDI_CR_AUTO_SELECT | MDI_CR_RESTART_AUTO_NEG);
 
+InitializePhysicalLayerEnd:
+    return Status;
+}
+
+NTSTATUS
+WaitForPhysicalLayer (
+    __in PREALTEK_ADAPTER Adapter
+)
+
+/*++
+
+Routine Description:
+
+    This function waits for the auto-negotiation started by
+    InitializePhysicalLayer to complete and records the resulting link speed
+    and duplex.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+Return Value:
+
+    STATUS_SUCCESS if a valid link was established.
+
+--*/
+
+{
+    USHORT PhyRegData;
+    USHORT PhyRegDataANER;
+    USHORT PhyRegDataBMSR;
+    UCHAR PhyStatus;
+    NTSTATUS Status;
+    ULONG64 Deadline;
+    ULONG64 Frequency;
+
     //
-    // Wait up to 3.5 seconds for auto-negotiation to complete.
+    // Wait up to 3.5 seconds for auto-negotiation to complete.  Poll BMSR
+    // back to back; each PHY read already waits for the MDIO transaction,
+    // so there is no need to stall in between.
     //
 
+    Deadline = KdReadCycleCounter(&Frequency);
+    Deadline += (Frequency * PHY_AUTO_NEGOTIATE_TIME) / 1000000;
     Status = STATUS_UNSUCCESSFUL;
-    for (Wait = 0; Wait < PHY_MAX_AUTO_NEGOTIATE; Wait += 1) {
-
-        //
-        // MP_ReadPhyUshort takes a minimum of 25 usec per call.
-        //
-
+    do {
         PhyRegData=MP_ReadPhyUshort(Adapter, PHY_REG_BMSR);
 
         //
@@ -2095,12 +3094,11 @@ InitializePhysicalLayer (
             break;
         }
 
-        KeStallExecutionProcessor(25);
-    }
+    } while (KdReadCycleCounter(NULL) < Deadline);
 
     if (!NT_SUCCESS(Status)) {
         KdNetErrorString = L"NIC auto-negotiation timed out.";
-        goto InitializePhysicalLayerEnd;
+        goto WaitForPhysicalLayerEnd;
     }
 
     PhyRegData=MP_ReadPhyUshort(Adapter, PHY_REG_BMSR);
@@ -2171,10 +3169,79 @@ InitializePhysicalLayer (
         KdNetErrorString = L"No valid link.  The network cable might not be properly connected.";
     }
 
-InitializePhysicalLayerEnd:
+WaitForPhysicalLayerEnd:
     return Status;
 }
 
+VOID
+RealtekInitTimelineStart (
+    __in PREALTEK_ADAPTER Adapter
+    )
+
+/*++
+
+Routine Description:
+
+    This function clears the initialization timeline and starts timing the
+    first step.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    PREALTEK_INIT_TIMELINE Timeline;
+
+    Timeline = &Adapter->InitTimeline;
+    RtlZeroMemory(Timeline, sizeof(*Timeline));
+    Timeline->Start = KdReadCycleCounter(&Timeline->Frequency);
+    Timeline->Last = Timeline->Start;
+    return;
+}
+
+VOID
+RealtekInitTimelineMark (
+    __in PREALTEK_ADAPTER Adapter,
+    __in REALTEK_INIT_STEP Step
+    )
+
+/*++
+
+Routine Description:
+
+    This function charges the time since the previous mark to the given
+    initialization step.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Step - Supplies the step that just finished.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    ULONG64 Now;
+    PREALTEK_INIT_TIMELINE Timeline;
+
+    Timeline = &Adapter->InitTimeline;
+    Now = KdReadCycleCounter(NULL);
+    Timeline->StepCycles[Step] += Now - Timeline->Last;
+    Timeline->TotalCycles = Now - Timeline->Start;
+    Timeline->Last = Now;
+    return;
+}
+
 NTSTATUS
 RealtekInitializeController(
     __in PKDNET_SHARED_DATA KdNet
@@ -2203,12 +3270,15 @@ Return Value:
 
 {
     PREALTEK_ADAPTER Adapter;
+    UCHAR Hash[8];
     PHYSICAL_ADDRESS    physAddr;
     ULONG Index;
     NTSTATUS Status;
+    BOOLEAN WaitForLink;
 
     Adapter = (PREALTEK_ADAPTER)KdNet->Hardware;
     Adapter->KdNet = KdNet;
+    RealtekInitTimelineStart(Adapter);
 
     //
     // Immediately fail initialization if the device does not have a Realtek
@@ -2258,6 +3328,8 @@ Return Value:
         goto InitializeControllerEnd;
     }
 
+    RealtekLayoutContext(Adapter);
+
     //
     // Patch various hardware settings.
     //
@@ -2267,11 +3339,14 @@ Return Value:
         goto InitializeControllerEnd;
     }
 
+    RealtekInitTimelineMark(Adapter, RealtekInitStepPatchHardware);
+
     //
     // Modify PCI config space for certain NICs.
     //
 
     SetupPCIConfigSpace(Adapter);
+    RealtekInitTimelineMark(Adapter, RealtekInitStepPciConfig);
 
     //
     // Reset the NIC and disable transmit and receive.
@@ -2282,6 +3357,8 @@ Return Value:
         goto InitializeControllerEnd;
     }
 
+    RealtekInitTimelineMark(Adapter, RealtekInitStepReset);
+
     //
     // Mask all interrupts from the NIC.
     //
@@ -2297,6 +3374,8 @@ Return Value:
         goto InitializeControllerEnd;
     }
 
+    RealtekInitTimelineMark(Adapter, RealtekInitStepPciExpressPhy);
+
     //
     // Do not set the 8168B chips to 1 GBit/sec speeds until restart on Intel
     // prototype machines is fixed to power off the chip, since otherwise the
@@ -2304,7 +3383,13 @@ Return Value:
     // 8169.  Assume a speed of 100Mb/s and a full duplex connection for cards
     // which do not get their PHY initialized.
     //
+    // Auto-negotiation takes far longer than anything else here, so it is
+    // only started now.  The MAC and the descriptor rings are set up while
+    // it runs and the link is waited for just before enabling transmit and
+    // receive.
+    //
 
+    WaitForLink = FALSE;
     switch (Adapter->ChipType) {
         case RTL8168C:
         case RTL8168C_REV_G:
@@ -2319,6 +3404,7 @@ Return Value:
                 goto InitializeControllerEnd;
             }
 
+            WaitForLink = TRUE;
             break;
 
         default:
@@ -2327,6 +3413,8 @@ Return Value:
             break;
     }
 
+    RealtekInitTimelineMark(Adapter, RealtekInitStepPhyStart);
+
     //
     // Configure C+CR register.  MUST BE DONE FIRST!
     // Disable PCI Multiple R/W Enable - bit 3
@@ -2357,6 +3445,9 @@ Return Value:
 
     Adapter->TxIndex = 0;
     Adapter->RxIndex = 0;
+    Adapter->RxRefillIndex = 0;
+    Adapter->RxHeld = 0;
+    RtlZeroMemory(Adapter->rxReleased, Adapter->NumRxDesc * sizeof(BOOLEAN));
 
     //
     // Read the hardware MAC address.
@@ -2376,13 +3467,12 @@ Return Value:
     WriteRegister(MTPS, MAX_TX_PKT_SIZE);
 
     //
-    // Initialize the transmit descriptors.  Only the first 128 will be used.
-    // Mark each as pointing to a complete packet, and then mark the last one
-    // as the last in the ring of descriptors.  The unused 128 TX descriptors
-    // are left zeroed out.
+    // Initialize the transmit descriptors.  Mark each as pointing to a
+    // complete packet, and then mark the last one as the last in the ring of
+    // descriptors.
     //
 
-    for (Index = 0; Index < NUM_TX_DESC; Index++) {
+    for (Index = 0; Index < Adapter->NumTxDesc; Index++) {
         Adapter->txDesc[Index].BufferAddress = KdGetPhysicalAddress(&Adapter->txBuffers[Index]);
         Adapter->txDesc[Index].VLAN_TAG.Value = 0;
         Adapter->txDesc[Index].TAGC = 0;
@@ -2390,7 +3480,7 @@ Return Value:
         Adapter->txDesc[Index].status = TXS_LS | TXS_FS;
     }
 
-    Adapter->txDesc[NUM_TX_DESC - 1].status |= TXS_EOR;
+    Adapter->txDesc[Adapter->NumTxDesc - 1].status |= TXS_EOR;
 
     //
     // Write the TX descriptor base physical address into the NIC.
@@ -2405,7 +3495,7 @@ Return Value:
     // will never change.
     //
 
-    for (Index = 0; Index < NUM_RX_DESC; Index++)
+    for (Index = 0; Index < Adapter->NumRxDesc; Index++)
     {
         Adapter->rxDesc[Index].BufferAddress = KdGetPhysicalAddress(&Adapter->rxBuffers[Index]);
         Adapter->rxDesc[Index].VLAN_TAG.Value = 0;
@@ -2415,7 +3505,7 @@ Return Value:
         Adapter->rxDesc[Index].status = RXS_OWN;
     }
 
-    Adapter->rxDesc[NUM_RX_DESC-1].status |= RXS_EOR;
+    Adapter->rxDesc[Adapter->NumRxDesc-1].status |= RXS_EOR;
 
     //
     // Write the RX descriptor base physical address into the NIC.
@@ -2426,18 +3516,65 @@ Return Value:
     WriteRegister(RDSARHigh, physAddr.HighPart);
 
     //
-    // Set the maximum receive packet size.
+    // Set the maximum receive packet size.  Jumbo frames additionally need
+    // the jumbo enable bits in CONFIG3 and CONFIG4, which are only writable
+    // while the CONFIG registers are unlocked.
+    //
+
+    if (Adapter->DescPerFrame > 1) {
+        WriteRegister(CR9346, CR9346_CONFIG_WRITE);
+        WriteRegister(CONFIG3, ReadRegister(CONFIG3) | CONFIG3_Jumbo_En0);
+        WriteRegister(CONFIG4, ReadRegister(CONFIG4) | CONFIG4_Jumbo_En1);
+        WriteRegister(CR9346, 0);
+        WriteRegister(RMS, RealtekRings.BufferSize);
+
+    } else {
+        WriteRegister(RMS, REALTEK_MAX_PKT_SIZE);
+    }
+
     //
+    // Configure the receive control register.  Set to recieve ALL packets,
+    // unless hardware filtering was requested.  In that case only frames that
+    // match the station address, broadcast frames, and multicast frames that
+    // hit the IPv6 neighbor discovery groups in the multicast hash are
+    // received.  The hardware cannot match UDP ports, so KDNET still
+    // classifies every frame that is received.
+    //
+
+    if (RealtekRxFilter != FALSE) {
+        RealtekGetRxFilterHash(Adapter->KdNet->TargetMacAddress, Hash);
+        WriteRegister(MulticastReg0, Hash[0]);
+        WriteRegister(MulticastReg1, Hash[1]);
+        WriteRegister(MulticastReg2, Hash[2]);
+        WriteRegister(MulticastReg3, Hash[3]);
+        WriteRegister(MulticastReg4, Hash[4]);
+        WriteRegister(MulticastReg5, Hash[5]);
+        WriteRegister(MulticastReg6, Hash[6]);
+        WriteRegister(MulticastReg7, Hash[7]);
+        WriteRegister(RCR, (TCR_RCR_MXDMA_UNLIMITED << RCR_MXDMA_OFFSET) |
+                           (RCR_RX_NO_THRESHOLD << RCR_FIFO_OFFSET) |
+                           RCR_AB | RCR_AM | RCR_APM);
+
+    } else {
+        WriteRegister(RCR, (TCR_RCR_MXDMA_UNLIMITED << RCR_MXDMA_OFFSET) |
+                           (RCR_RX_NO_THRESHOLD << RCR_FIFO_OFFSET) |
+                           RCR_AR | RCR_AB | RCR_APM | RCR_AAP);
+    }
 
-    WriteRegister(RMS, REALTEK_MAX_PKT_SIZE);
+    RealtekInitTimelineMark(Adapter, RealtekInitStepRings);
 
     //
-    // Configure the receive control register.  Set to recieve ALL packets.
+    // Wait for the link to come up.
     //
 
-    WriteRegister(RCR, (TCR_RCR_MXDMA_UNLIMITED << RCR_MXDMA_OFFSET) |
-                       (RCR_RX_NO_THRESHOLD << RCR_FIFO_OFFSET) |
-                       RCR_AR | RCR_AB | RCR_APM | RCR_AAP);
+    if (WaitForLink != FALSE) {
+        Status = WaitForPhysicalLayer(Adapter);
+        if (!NT_SUCCESS(Status)) {
+            goto InitializeControllerEnd;
+        }
+
+        RealtekInitTimelineMark(Adapter, RealtekInitStepAutoNegotiation);
+    }
 
     //
     // Enable transmit and receive.
@@ -2490,6 +3627,90 @@ Return Value:
 
 }
 
+NTSTATUS
+RealtekDeviceControl (
+    __in PREALTEK_ADAPTER Adapter,
+    __in ULONG RequestCode,
+    __in_bcount(InputBufferSize) PVOID InputBuffer,
+    __in ULONG InputBufferSize,
+    __out_bcount(OutputBufferSize) PVOID OutputBuffer,
+    __in ULONG OutputBufferSize
+    )
+
+/*++
+
+Routine Description:
+
+    Synchronously handle a device control request.  The ring configuration
+    reported is the one the adapter context was laid out with, after the
+    loader requests were clamped to what the hardware supports.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    RequestCode - The code for the request being sent
+
+    InputBuffer - The input data for the request
+
+    InputBufferSize - The size of the input buffer
+
+    OutputBuffer - The output data for the request
+
+    OutputBufferSize - The size of the output buffer
+
+Return Value:
+
+    NT status code.
+
+--*/
+
+{
+    PKDNET_RING_PARAMETERS Rings;
+    NTSTATUS Status;
+
+    UNREFERENCED_PARAMETER(InputBuffer);
+    UNREFERENCED_PARAMETER(InputBufferSize);
+
+    Status = STATUS_INVALID_DEVICE_REQUEST;
+    switch (RequestCode) {
+        case KD_DEVICE_CONTROL_NET_QUERY_RING_PARAMETERS:
+            if (OutputBufferSize < sizeof(KDNET_RING_PARAMETERS)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            Rings = (PKDNET_RING_PARAMETERS)OutputBuffer;
+            Rings->RxDepth = Adapter->NumRxDesc;
+            Rings->TxDepth = Adapter->NumTxDesc;
+            Rings->MaxInFlight = Adapter->MaxTxInFlight / Adapter->DescPerFrame;
+            if (Adapter->DescPerFrame > 1) {
+                Rings->BufferSize = RealtekRings.BufferSize;
+
+            } else {
+                Rings->BufferSize = REALTEK_MAX_PKT_SIZE;
+            }
+
+            Status = STATUS_SUCCESS;
+            break;
+
+        case KD_DEVICE_CONTROL_NET_QUERY_RX_FILTER:
+            if (OutputBufferSize < sizeof(BOOLEAN)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            *((BOOLEAN *)OutputBuffer) = RealtekRxFilter;
+            Status = STATUS_SUCCESS;
+            break;
+
+        default:
+            break;
+    }
+
+    return Status;
+}
+
 #pragma warning(default:4127 4310)
 #if _MSC_VER >= 1200
 #pragma warning(pop)
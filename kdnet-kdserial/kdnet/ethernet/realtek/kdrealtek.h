@@ -17,24 +17,50 @@ Author:
 --*/
 
 #define PCI_VID_REALTEK 0x10ec
-#define ALLOCATED_DESCRIPTORS 256
 
 //
-// Although 256 TX descriptors will be allocated only 128 will be used.
-// Realtek hw requires the start of the descriptors be 256 byte aligned.
-// TX descriptors are 16 bytes so the number of TX descriptors must be a
-// multiple of 16 so that the RX descriptor block starts on a 256 byte
-// boundary.
+// The number of TX and RX descriptors can be set with the txdepth= and
+// rxdepth= loader options, so that memory constrained targets can trade
+// burst capacity for a smaller hardware context.  Realtek hw requires the
+// start of each descriptor ring be 256 byte aligned.  Descriptors are 16 bytes
+// so both counts are rounded up to a multiple of 16, which keeps the RX ring
+// that follows the TX ring aligned.
 //
 
-#define NUM_TX_DESC 128
+#define REALTEK_DEFAULT_TX_DESC 128
+#define REALTEK_DEFAULT_RX_DESC 256
+#define REALTEK_MIN_DESC 16
+#define REALTEK_MAX_DESC 1024
+#define REALTEK_DESC_ALIGNMENT 256
+#define REALTEK_MAX_PKT_SIZE 2048
 
 //
-// All 256 RX descriptors will be used.
+// The RTL8168 family supports jumbo frames up to the largest packet the MTPS
+// register can describe.  When a bufsize= above 2 KB is requested, packets
+// are spread over consecutive 2 KB buffers and chained through the FS and LS
+// descriptor bits.  The buffer pools are followed by enough spare buffers to
+// hold a packet that wraps around the end of the ring, so that every packet
+// is contiguous in memory.
 //
 
-#define NUM_RX_DESC ALLOCATED_DESCRIPTORS
-#define REALTEK_MAX_PKT_SIZE 2048
+#define REALTEK_MAX_JUMBO_SIZE (MAX_TX_PKT_SIZE * 128)
+
+//
+// Received packets may be released in any order, but the hardware fills the
+// RX ring in order, so descriptors are handed back to it in ring order.
+// Released descriptors are collected until a batch of them is ready to go
+// back behind a single memory barrier, or until the hardware is running low
+// on descriptors to receive into.
+//
+// Building with REALTEK_RX_RING_CHECK set to 1 validates the receive ring
+// bookkeeping after every receive and release, for use under a simulator.
+//
+
+#define REALTEK_RX_REFILL_BATCH 8
+
+#ifndef REALTEK_RX_RING_CHECK
+#define REALTEK_RX_RING_CHECK 0
+#endif
 
 //
 // Set the hardware to its maximum possible TX packet size.
@@ -187,26 +213,88 @@ typedef struct _CSR_STRUC {
 
 #pragma pack()
 
-typedef struct _REALTEK_ADAPTER {
-    TX_DESC txDesc[ALLOCATED_DESCRIPTORS];    // 1024 bytes (64 * 4 dwords)
-    RX_DESC rxDesc[ALLOCATED_DESCRIPTORS];    // 1024 bytes (64 * 4 dwords)
-    REALTEK_PKT_BUFF txBuffers[NUM_TX_DESC];  // 128 * 2048 bytes
-    REALTEK_PKT_BUFF rxBuffers[NUM_RX_DESC];  // 256 * 2048 bytes
-    GDUMP_TALLY HardwareStatistics;           // Dump Tally
+//
+// Controller initialization is timed step by step so that regressions in the
+// time to first packet can be tracked down.  Each entry holds the cycles
+// spent in one step of RealtekInitializeController; the timeline of the last
+// initialization can be dumped from the debugger.
+//
+
+typedef enum _REALTEK_INIT_STEP {
+    RealtekInitStepPatchHardware,
+    RealtekInitStepPciConfig,
+    RealtekInitStepReset,
+    RealtekInitStepPciExpressPhy,
+    RealtekInitStepPhyStart,
+    RealtekInitStepRings,
+    RealtekInitStepAutoNegotiation,
+    RealtekInitStepCount
+} REALTEK_INIT_STEP;
+
+typedef struct _REALTEK_INIT_TIMELINE {
+    ULONG64 Frequency;
+    ULONG64 Start;
+    ULONG64 Last;
+    ULONG64 StepCycles[RealtekInitStepCount];
+    ULONG64 TotalCycles;
+} REALTEK_INIT_TIMELINE, *PREALTEK_INIT_TIMELINE;
+
+//
+// The adapter context only holds the state of the adapter.  The fields used
+// on every packet come first so that they are packed into as few cache lines
+// as possible.  The descriptor rings follow the adapter in the hardware
+// context, and the packet buffers are placed in a page aligned pool after the
+// rings so that no buffer crosses a page.  The per descriptor RX release
+// flags follow the packet buffers.  RealtekGetHardwareContextSize sizes the
+// context for the configured number of descriptors.
+//
+
+typedef struct DECLSPEC_CACHEALIGN _REALTEK_ADAPTER {
+    PTX_DESC txDesc;
+    PRX_DESC rxDesc;
+    PREALTEK_PKT_BUFF txBuffers;
+    PREALTEK_PKT_BUFF rxBuffers;
     PCSR_STRUC BaseAddress;
-    NIC_CHIP_TYPE ChipType;
-    ULONG IsPCIExpress;
     ULONG RxIndex;
     ULONG TxIndex;
+    ULONG NumTxDesc;
+    ULONG NumRxDesc;
+    ULONG MaxTxInFlight;
+    ULONG DescPerFrame;
+    BOOLEAN TxReserved;
+    PBOOLEAN rxReleased;
+    ULONG RxRefillIndex;
+    ULONG RxHeld;
+
+    DECLSPEC_CACHEALIGN GDUMP_TALLY HardwareStatistics; // Dump Tally
+    NIC_CHIP_TYPE ChipType;
+    ULONG IsPCIExpress;
     ULONG NwayLink;
     ULONG ParallelLink;
     PKDNET_SHARED_DATA KdNet;
+    REALTEK_INIT_TIMELINE InitTimeline;
 } REALTEK_ADAPTER, *PREALTEK_ADAPTER;
 
 //
 // kdrealtek.c
 //
 
+VOID
+RealtekSetRingParameters (
+    __in_opt PCHAR LoaderOptions
+    );
+
+VOID
+RealtekSetRxFilter (
+    __in_opt PCHAR LoaderOptions
+    );
+
+VOID
+RealtekGetRxFilterHash (
+    __in PUCHAR MacAddress,
+    __out_ecount(8) PUCHAR Hash
+    );
+
 ULONG
 RealtekGetHardwareContextSize (
     __in PDEBUG_DEVICE_DESCRIPTOR Device
@@ -222,6 +310,16 @@ RealtekShutdownController (
     __in PREALTEK_ADAPTER Adapter
     );
 
+NTSTATUS
+RealtekDeviceControl (
+    __in PREALTEK_ADAPTER Adapter,
+    __in ULONG RequestCode,
+    __in_bcount(InputBufferSize) PVOID InputBuffer,
+    __in ULONG InputBufferSize,
+    __out_bcount(OutputBufferSize) PVOID OutputBuffer,
+    __in ULONG OutputBufferSize
+    );
+
 NTSTATUS
 RealtekGetRxPacket (
     __in PREALTEK_ADAPTER Adapter,
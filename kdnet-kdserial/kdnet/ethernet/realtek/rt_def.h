@@ -178,7 +178,11 @@ typedef enum _NIC_CHIP_TYPE
 #define RCR_AER         0x00000020		// accept error packet
 
 #define CONFIG3_Magic  	0x20			// Wake on Magic packet
+#define CONFIG3_Jumbo_En0	0x04	// Jumbo frame enable, 8168 only
 #define CONFIG4_iMode		0x01	// IP/TCP checksum compatibility with Intel NIC for RTL8169SB
+#define CONFIG4_Jumbo_En1	0x02	// Jumbo frame enable, 8168 only
+
+#define CR9346_CONFIG_WRITE	0xc0	// Unlock the CONFIG registers for writes
 
 
 enum {
@@ -22,7 +22,18 @@
 //
 #define RENEGOTIATE_TIME         7 // (4200 / 600)
 #define PHY_RESET_TIME        2400 // (2400 * 25)
-#define PHY_MAX_AUTO_NEGOTIATE (3500000 / 50)
+#define PHY_AUTO_NEGOTIATE_TIME 3500000 // usec
+
+//
+// PHY and PCIe PHY register accesses are polled every PHY_ACCESS_POLL usec
+// for up to the given time rather than stalling a fixed time per poll.
+// The PHY needs PHY_ACCESS_SETTLE usec after an MDIO access completes
+// before the next one.
+//
+#define PHY_ACCESS_POLL          2 // usec
+#define PHY_ACCESS_TIME        200 // usec
+#define PHY_ACCESS_SETTLE       20 // usec
+#define EPHY_ACCESS_TIME      1000 // usec
 
 /*
 #define CONNECTOR_AUTO          0
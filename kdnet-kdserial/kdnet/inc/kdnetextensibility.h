@@ -146,6 +146,34 @@ NTSTATUS
     __in const UCHAR Byte
     );
 
+//
+// The serial buffer routines move as many bytes as the hardware can take or
+// has available in one call, checking the line and FIFO status once per
+// FIFO load instead of once per byte.  KdWriteSerialBuffer returns
+// STATUS_SUCCESS with the number of bytes queued for transmission, which may
+// be fewer than Length, or STATUS_IO_TIMEOUT if the transmitter cannot take
+// any.  KdReadSerialBuffer returns STATUS_SUCCESS with the number of bytes
+// read, or STATUS_IO_TIMEOUT if none are available.
+//
+
+typedef
+NTSTATUS
+(*KD_READ_SERIAL_BUFFER) (
+    __in PVOID Adapter,
+    __out_bcount(Length) PUCHAR Buffer,
+    __in ULONG Length,
+    __out PULONG BytesRead
+    );
+
+typedef
+NTSTATUS
+(*KD_WRITE_SERIAL_BUFFER) (
+    __in PVOID Adapter,
+    __in_bcount(Length) const UCHAR *Buffer,
+    __in ULONG Length,
+    __out PULONG BytesWritten
+    );
+
 //
 // Serial Device Control Requests:
 //
@@ -202,7 +230,135 @@ NTSTATUS
 
 #define KD_DEVICE_CONTROL_SERIAL_SET_REMOTE_FLOW 0x00000003
 
-#define KDNET_EXT_EXPORTS 13
+//
+// SERIAL_SET_FLOW_THRESHOLDS:
+//
+// Input: KD_SERIAL_FLOW_THRESHOLDS
+// Output: KD_SERIAL_FLOW_THRESHOLDS (optional)
+//
+// Sent to the serial device to set the FIFO trigger levels and the watermarks
+// at which automatic flow control deasserts (FlowHighWatermark) and
+// reasserts (FlowLowWatermark) RTS.  All values are in bytes.  A field of
+// zero leaves that setting unchanged.  The device rounds each value down to
+// the closest level the hardware supports, so a watermark is never raised
+// past what was requested; if an output buffer is supplied, the levels
+// actually in effect are returned in it with zero for any level the hardware
+// does not have.
+//
+
+#define KD_DEVICE_CONTROL_SERIAL_SET_FLOW_THRESHOLDS 0x00000004
+
+//
+// SERIAL_TUNE_FLOW_THRESHOLDS:
+//
+// Input: ULONG (optional)
+// Output: KD_SERIAL_FLOW_THRESHOLDS
+//
+// Sent to the serial device to run a loopback benchmark over the supported
+// flow control watermarks.  The input is the interval in microseconds
+// between polls of the receive FIFO that the benchmark should model; if it
+// is not supplied a default is used.  The watermark giving the highest
+// throughput without overruns is programmed and returned.  The UART is
+// placed in internal loopback for the duration, so this must only be sent
+// while nothing is connected on the other side of the link.  The loopback
+// traffic is not counted in the link statistics.
+//
+
+#define KD_DEVICE_CONTROL_SERIAL_TUNE_FLOW_THRESHOLDS 0x00000005
+
+typedef struct _KD_SERIAL_FLOW_THRESHOLDS
+{
+    ULONG RxTriggerLevel;
+    ULONG TxTriggerLevel;
+    ULONG FlowLowWatermark;
+    ULONG FlowHighWatermark;
+} KD_SERIAL_FLOW_THRESHOLDS, *PKD_SERIAL_FLOW_THRESHOLDS;
+
+//
+// SERIAL_QUERY_STATISTICS:
+//
+// Input: BOOLEAN (optional)
+// Output: KD_SERIAL_STATISTICS
+//
+// Sent to the serial device to fetch the link statistics accumulated since
+// initialization or since they were last reset.  If the input is supplied
+// and TRUE, the statistics are reset after being returned.
+//
+// CtsStallMicroseconds is the total time the transmit path found CTS
+// deasserted.  RxFifoHighWater is the deepest the receive FIFO was seen by
+// the device.  Devices that cannot report their FIFO level report the most
+// bytes drained from the FIFO back to back, or zero if they never drain more
+// than one byte at a time.
+//
+
+#define KD_DEVICE_CONTROL_SERIAL_QUERY_STATISTICS 0x00000006
+
+typedef struct _KD_SERIAL_STATISTICS
+{
+    ULONG64 BytesReceived;
+    ULONG64 BytesTransmitted;
+    ULONG Overruns;
+    ULONG FramingErrors;
+    ULONG ParityErrors;
+    ULONG NotClearToSend;
+    ULONG64 CtsStallMicroseconds;
+    ULONG RxFifoHighWater;
+    ULONG Reserved;
+} KD_SERIAL_STATISTICS, *PKD_SERIAL_STATISTICS;
+
+//
+// NET_QUERY_RING_PARAMETERS:
+//
+// Input: NULL
+// Output: KDNET_RING_PARAMETERS
+//
+// Sent to a packet based device after KdInitializeController succeeds to
+// fetch the packet ring configuration it is running with, once the rxdepth,
+// txdepth, bufsize and inflight loadoptions requests have been clamped to
+// what the hardware supports.  A BufferSize above KDNET_STANDARD_FRAME_SIZE
+// means the device accepts and receives jumbo frames up to that size.
+//
+// Devices that do not support this request use fixed rings, and KDNET must
+// not send them packets larger than KDNET_STANDARD_FRAME_SIZE.
+//
+
+#define KD_DEVICE_CONTROL_NET_QUERY_RING_PARAMETERS 0x00000007
+
+//
+// NET_QUERY_RX_FILTER:
+//
+// Input: NULL
+// Output: BOOLEAN
+//
+// Sent to a packet based device after KdInitializeController succeeds to
+// find out whether the rxfilter loadoptions setting took effect.  TRUE means
+// the hardware receive filters only pass frames addressed to the target MAC
+// address, broadcast frames, and the IPv6 neighbor discovery groups returned
+// by KdNetGetRxFilterMulticast; promiscuous reception and all other multicast
+// groups are turned off.  Broadcasts are still accepted since ARP and DHCP
+// depend on them.  Frames that reach the ring are still classified by KDNET,
+// so devices that cannot filter in hardware return FALSE or do not support
+// the request.
+//
+
+#define KD_DEVICE_CONTROL_NET_QUERY_RX_FILTER 0x00000008
+
+//
+// KDNET_EXT_EXPORTS is the FunctionCount of the current export table.  The
+// export table of a KDNET that predates the serial buffer routines has a
+// FunctionCount of KDNET_EXT_EXPORTS_NO_SERIAL_BUFFER and ends at
+// DebugSerialOutputByte.  Modules accept either count, and only fill in
+// KdReadSerialBuffer and KdWriteSerialBuffer when the table has room for
+// them.  KDNET clears both before calling KdInitializeLibrary and uses the
+// byte routines with modules that leave them NULL.
+//
+
+#define KDNET_EXT_EXPORTS_NO_SERIAL_BUFFER 13
+#define KDNET_EXT_EXPORTS 15
+
+#define KDNET_EXT_EXPORTS_SUPPORTED(Count)              \
+    (((Count) == KDNET_EXT_EXPORTS) ||                  \
+     ((Count) == KDNET_EXT_EXPORTS_NO_SERIAL_BUFFER))
 
 typedef struct _KDNET_EXTENSIBLITY_EXPORTS
 {
@@ -222,6 +378,8 @@ typedef struct _KDNET_EXTENSIBLITY_EXPORTS
     KD_WRITE_SERIAL_BYTE KdWriteSerialByte;
     DEBUG_SERIAL_OUTPUT_INIT DebugSerialOutputInit;
     DEBUG_SERIAL_OUTPUT_BYTE DebugSerialOutputByte;
+    KD_READ_SERIAL_BUFFER KdReadSerialBuffer;
+    KD_WRITE_SERIAL_BUFFER KdWriteSerialBuffer;
 } KDNET_EXTENSIBILITY_EXPORTS, *PKDNET_EXTENSIBILITY_EXPORTS;
 
 //
@@ -570,6 +728,8 @@ extern PKDNET_EXTENSIBILITY_EXPORTS KdNetExtensibilityExports;
 #define KdSetHibernateRange KdNetExtensibilityExports->KdSetHibernateRange
 #define KdReadSerialByte KdNetExtensibilityExports->KdReadSerialByte
 #define KdWriteSerialByte KdNetExtensibilityExports->KdWriteSerialByte
+#define KdReadSerialBuffer KdNetExtensibilityExports->KdReadSerialBuffer
+#define KdWriteSerialBuffer KdNetExtensibilityExports->KdWriteSerialBuffer
 #define KdDeviceControl KdNetExtensibilityExports->KdDeviceControl
 
 #endif
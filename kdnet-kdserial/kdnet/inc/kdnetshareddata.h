@@ -99,6 +99,190 @@ Author:
 #define KDX_FORCE_DHCP_OFF 0x2
 #define KDX_VALID_FLAGS (KDX_EXTENDED_INITIAL_CONNECT | KDX_FORCE_DHCP_OFF)
 
+//
+// The rxfilter=1 loadoptions setting asks the extensibility module to narrow
+// the hardware receive filters to frames addressed to the target MAC address,
+// broadcast frames, and the IPv6 multicast groups that neighbor discovery
+// needs.  Whether it did is returned by the
+// KD_DEVICE_CONTROL_NET_QUERY_RX_FILTER device control.
+//
+// The module does not know the IPv6 address KDNET uses.  It keeps the
+// all-nodes group and the solicited-node group of the link-local address
+// formed from the MAC address (modified EUI-64), which is the address KDNET
+// uses unless it is configured with another one.  Targets configured with
+// any other IPv6 address must not set rxfilter, since neighbor solicitations
+// for that address would be dropped by the hardware.
+//
+
+#define KDNET_RX_FILTER_OPTION "rxfilter"
+#define KDNET_RX_FILTER_MULTICAST_COUNT 2
+
+FORCEINLINE
+VOID
+KdNetGetRxFilterMulticast (
+    __in_ecount(MAC_ADDRESS_SIZE) PUCHAR MacAddress,
+    __out_ecount(KDNET_RX_FILTER_MULTICAST_COUNT)
+        UCHAR Groups[KDNET_RX_FILTER_MULTICAST_COUNT][MAC_ADDRESS_SIZE]
+    )
+
+/*++
+
+Routine Description:
+
+    This routine returns the multicast MAC addresses an rxfilter module keeps
+    receiving: the IPv6 all-nodes group 33:33:00:00:00:01, and the
+    solicited-node group 33:33:FF:xx:xx:xx whose low 24 bits are those of the
+    interface identifier, and so of the MAC address.
+
+Arguments:
+
+    MacAddress - Supplies the target MAC address.
+
+    Groups - Receives the multicast MAC addresses.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    Groups[0][0] = 0x33;
+    Groups[0][1] = 0x33;
+    Groups[0][2] = 0x00;
+    Groups[0][3] = 0x00;
+    Groups[0][4] = 0x00;
+    Groups[0][5] = 0x01;
+    Groups[1][0] = 0x33;
+    Groups[1][1] = 0x33;
+    Groups[1][2] = 0xFF;
+    Groups[1][3] = MacAddress[3];
+    Groups[1][4] = MacAddress[4];
+    Groups[1][5] = MacAddress[5];
+    return;
+}
+
+#define KDNET_STANDARD_FRAME_SIZE 1514
+
+//
+// The packet rings of an extensibility module can be sized from the loader.
+// Throughput oriented targets want deep rings and many packets in flight,
+// while memory constrained targets want the smallest hardware context that
+// still works.  The request is made with the following loadoptions settings,
+// each of the form option=value.  LoaderOptions are passed to
+// KdInitializeLibrary before KdGetHardwareContextSize is called, in both the
+// loader and the kernel, so a module sizes its hardware context for the
+// request.  Settings that are absent, zero or not supported leave the module
+// default in place, and modules clamp each value to what the hardware
+// supports.  What a module ended up with is returned by the
+// KD_DEVICE_CONTROL_NET_QUERY_RING_PARAMETERS device control.
+//
+// rxdepth - Number of receive descriptors.
+//
+// txdepth - Number of transmit descriptors.
+//
+// bufsize - Size in bytes of the largest packet the module must handle.
+//     Values above the standard Ethernet frame size request jumbo frames.
+//
+// inflight - Maximum number of transmit packets handed to the hardware that
+//     have not completed yet.
+//
+
+#define KDNET_RX_DEPTH_OPTION "rxdepth"
+#define KDNET_TX_DEPTH_OPTION "txdepth"
+#define KDNET_BUFFER_SIZE_OPTION "bufsize"
+#define KDNET_IN_FLIGHT_OPTION "inflight"
+
+typedef struct _KDNET_RING_PARAMETERS
+{
+    ULONG RxDepth;
+    ULONG TxDepth;
+    ULONG BufferSize;
+    ULONG MaxInFlight;
+} KDNET_RING_PARAMETERS, *PKDNET_RING_PARAMETERS;
+
+FORCEINLINE
+ULONG
+KdNetParseLoaderOption (
+    __in_opt PCHAR LoaderOptions,
+    __in PCHAR Option
+    )
+
+/*++
+
+Routine Description:
+
+    This routine looks up a numeric loadoptions setting of the form
+    option=value.  The name only matches at the start of the string or after
+    a character that cannot be part of a name, so "txdepth" is not found
+    inside "maxtxdepth".  Modules use this for every setting defined here so
+    that they all read the loader options the same way.
+
+Arguments:
+
+    LoaderOptions - Supplies the loader options passed to the module.
+
+    Option - Supplies the name of the setting.
+
+Return Value:
+
+    The decimal value of the setting, or 0 if it is not present or has no
+    digits.  Values too large to be meaningful are returned as MAXULONG.
+
+--*/
+
+{
+    PCHAR Digit;
+    ULONG Index;
+    PCHAR Match;
+    CHAR Previous;
+    ULONG Value;
+
+    if (LoaderOptions == NULL) {
+        return 0;
+    }
+
+    for (Match = LoaderOptions; *Match != '\0'; Match += 1) {
+        if (Match != LoaderOptions) {
+            Previous = Match[-1];
+            if (((Previous >= 'a') && (Previous <= 'z')) ||
+                ((Previous >= 'A') && (Previous <= 'Z')) ||
+                ((Previous >= '0') && (Previous <= '9')) ||
+                (Previous == '_')) {
+
+                continue;
+            }
+        }
+
+        for (Index = 0;
+             (Option[Index] != '\0') && (Match[Index] == Option[Index]);
+             Index += 1) {
+
+            NOTHING;
+        }
+
+        if ((Option[Index] != '\0') || (Match[Index] != '=')) {
+            continue;
+        }
+
+        Value = 0;
+        for (Digit = &Match[Index + 1];
+             (*Digit >= '0') && (*Digit <= '9');
+             Digit += 1) {
+
+            if (Value >= (MAXULONG / 10)) {
+                return MAXULONG;
+            }
+
+            Value = (Value * 10) + (*Digit - '0');
+        }
+
+        return Value;
+    }
+
+    return 0;
+}
+
 typedef struct _KDNET_SHARED_DATA
 {
     PVOID Hardware;
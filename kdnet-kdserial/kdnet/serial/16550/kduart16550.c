@@ -25,6 +25,37 @@ const static ULONG DEFAULT_ADDRESS_SIZE_UART16550 = 8;
 #define LC_1STOPBIT 0x00
 #define LC_NOPARITY 0x00
 
+//
+// The receive trigger level lives in FCR[7:6].  On a 16750 with automatic
+// flow control, RTS is deasserted when the receive FIFO reaches this level
+// and reasserted once it has been drained, so the trigger level doubles as
+// the flow control high watermark.
+//
+
+#define FC_RX_TRIGGER_SHIFT 6
+#define FC_RX_TRIGGER_MASK 0xC0
+
+const static UCHAR Uart16550RxTriggerLevels[] = { 1, 4, 8, 14 };
+
+#define UART16550_FIFO_DEPTH 16
+
+//
+// The FIFO control register reads back as the interrupt identification
+// register, whose top two bits are set once the FIFOs are enabled.  A UART
+// without FIFOs, such as an 8250 or a 16450, leaves them clear.
+//
+
+#define IIR_FIFOS_ENABLED 0xC0
+
+//
+// Flow control threshold tuning parameters.  Each receive trigger level is
+// exercised by looping back UART16550_TUNE_BYTES through the UART.
+//
+
+#define UART16550_TUNE_BYTES 1024
+#define UART16550_TUNE_DEFAULT_POLL_INTERVAL 100
+#define UART16550_TUNE_MAX_IDLE_POLLS 1000
+
 ULONG
 Uart16550GetContextSize(
     __in PDEBUG_DEVICE_DESCRIPTOR Device
@@ -173,6 +204,67 @@ Arguments:
     Adapter->FlowAllowed = Rts;
 }
 
+NTSTATUS
+Uart16550SetFlowThresholds(
+    __in PUART_16550_ADAPTER Adapter,
+    __inout PKD_SERIAL_FLOW_THRESHOLDS Thresholds
+    )
+
+/*++
+
+Routine Description:
+
+    Programs the receive FIFO trigger level.  The 16550 has no transmit 
+    trigger level and no separate low watermark, so only FlowHighWatermark
+    (or RxTriggerLevel if the former is zero) is used.  The request is rounded
+    down to the nearest supported level.  On return Thresholds holds the
+    levels in effect.
+
+Arguments:
+
+    Adapter - the 16550 adapter object
+
+    Thresholds - the requested levels in bytes
+
+Return Value:
+
+    STATUS_SUCCESS / STATUS_INVALID_PARAMETER
+
+--*/
+
+{
+    ULONG Index;
+    ULONG Level;
+
+    Level = (Thresholds->FlowHighWatermark != 0) ? 
+            Thresholds->FlowHighWatermark : Thresholds->RxTriggerLevel;
+
+    if (Level >= UART16550_FIFO_DEPTH) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (Level != 0) {
+        for (Index = RTL_NUMBER_OF(Uart16550RxTriggerLevels) - 1; 
+             Index > 0; 
+             Index -= 1) {
+
+            if (Uart16550RxTriggerLevels[Index] <= Level) {
+                break;
+            }
+        }
+
+        Adapter->FifoControl &= ~FC_RX_TRIGGER_MASK;
+        Adapter->FifoControl |= (UCHAR)(Index << FC_RX_TRIGGER_SHIFT);
+        Adapter->RxTriggerLevel = Uart16550RxTriggerLevels[Index];
+        WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_FCR, Adapter->FifoControl);
+    }
+
+    RtlZeroMemory(Thresholds, sizeof(KD_SERIAL_FLOW_THRESHOLDS));
+    Thresholds->RxTriggerLevel = Adapter->RxTriggerLevel;
+    Thresholds->FlowHighWatermark = Adapter->RxTriggerLevel;
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS
 Uart16550InitializeController(
     __in PKDNET_SHARED_DATA KdNet
@@ -213,6 +305,9 @@ Return Value:
     Adapter->PortPresent = TRUE;
     Adapter->LegacyPort = KdNet->Device->BaseAddress[0].TranslatedAddress;
     Adapter->FlowAllowed = TRUE;
+    RtlZeroMemory(&Adapter->Statistics, sizeof(KD_SERIAL_STATISTICS));
+    Adapter->CtsStallStart = 0;
+    Adapter->CtsStallCycles = 0;
 
     //
     // Disable all uart interrupts.
@@ -225,7 +320,15 @@ Return Value:
     // Enable the FIFO.
     //
 
-    WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_FCR, FC_ENABLE);
+    Adapter->FifoControl = FC_ENABLE;
+    Adapter->RxTriggerLevel = Uart16550RxTriggerLevels[0];
+    WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_FCR, Adapter->FifoControl);
+    Adapter->FifoDepth = 1;
+    if ((READ_PORT_UCHAR(Adapter->LegacyPort + COM_FCR) & IIR_FIFOS_ENABLED) ==
+        IIR_FIFOS_ENABLED) {
+
+        Adapter->FifoDepth = UART16550_FIFO_DEPTH;
+    }
 
     //
     // We cannot support KDNET without some form of flow control.  The packets
@@ -375,6 +478,89 @@ Returns:
     return lsr;
 }
 
+VOID
+Uart16550RecordLineErrors(
+    __in PUART_16550_ADAPTER Adapter,
+    __in UCHAR Lsr
+    )
+
+/*++
+
+Routine Description:
+
+    Accounts for the receive errors reported in a line status value.
+
+Arguments:
+
+    Adapter - the 16550 adapter object
+
+    Lsr - the line status register value accompanying the received data
+
+--*/
+
+{
+    if (Lsr & (COM_FE | COM_PE | COM_OE)) {
+        if (Lsr & COM_OE) {
+            Adapter->FifoOverflows++;
+            Adapter->Statistics.Overruns++;
+        } else {
+            Adapter->ErrorCount++;
+        }
+
+        if (Lsr & COM_FE) {
+            Adapter->Statistics.FramingErrors++;
+        }
+
+        if (Lsr & COM_PE) {
+            Adapter->Statistics.ParityErrors++;
+        }
+    }
+}
+
+BOOLEAN
+Uart16550CheckClearToSend(
+    __in PUART_16550_ADAPTER Adapter
+    )
+
+/*++
+
+Routine Description:
+
+    Samples CTS for the transmit path and accounts for the time spent stalled
+    on it.  A stall starts at the first sample which finds CTS deasserted and
+    ends at the first which finds it asserted again.
+
+Arguments:
+
+    Adapter - the 16550 adapter object
+
+Return Value:
+
+    Whether we are clear to send.
+
+--*/
+
+{
+    if (Uart16550IsClearToSend(Adapter)) {
+        if (Adapter->CtsStallStart != 0) {
+            Adapter->CtsStallCycles += KdReadCycleCounter(NULL) - 
+                                       Adapter->CtsStallStart;
+
+            Adapter->CtsStallStart = 0;
+        }
+
+        return TRUE;
+    }
+
+    if (Adapter->CtsStallStart == 0) {
+        Adapter->CtsStallStart = KdReadCycleCounter(NULL);
+    }
+
+    Adapter->NotClearToSend++;
+    Adapter->Statistics.NotClearToSend++;
+    return FALSE;
+}
+
 NTSTATUS
 Uart16550WriteSerialByte (
     __in PUART_16550_ADAPTER Adapter,
@@ -405,8 +591,7 @@ Arguments:
     //
     //  Wait for port to not be busy and CTS to be asserted from the other side.
     //
-    if (!Uart16550IsClearToSend(Adapter)) {
-        Adapter->NotClearToSend++;
+    if (!Uart16550CheckClearToSend(Adapter)) {
         return STATUS_IO_TIMEOUT;
     }
 
@@ -420,6 +605,7 @@ Arguments:
     //
 
     WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_DAT, Byte);
+    Adapter->Statistics.BytesTransmitted++;
     return STATUS_SUCCESS;
 }
 
@@ -481,20 +667,12 @@ Return Value:
         //
         // Check for errors
         //
+        // Even if there is a FIFO error or an indication of an error with
+        // the byte, read it and return it.  The protocol layer will deal
+        // with this.
+        //
 
-        if (lsr & (COM_FE | COM_PE | COM_OE)) {
-            if (lsr & COM_OE) {
-                Adapter->FifoOverflows++;
-            } else {
-                Adapter->ErrorCount++;
-            }
-            
-            //
-            // Even if there is a FIFO error or an indication of an error with
-            // the byte, read it and return it.  The protocol layer will deal
-            // with this.
-            //
-        }
+        Uart16550RecordLineErrors(Adapter, lsr);
 
         //
         // fetch the byte
@@ -502,6 +680,7 @@ Return Value:
 
         value = READ_PORT_UCHAR(Adapter->LegacyPort + COM_DAT);
         *Byte = value & (UCHAR)0xff;
+        Adapter->Statistics.BytesReceived++;
         return STATUS_SUCCESS;
     }
 
@@ -509,6 +688,433 @@ Return Value:
     return STATUS_IO_TIMEOUT;
 }
 
+NTSTATUS
+Uart16550WriteSerialBuffer(
+    __in PUART_16550_ADAPTER Adapter,
+    __in_bcount(Length) const UCHAR *Buffer,
+    __in ULONG Length,
+    __out PULONG BytesWritten
+    )
+
+/*++
+
+Routine Description:
+
+    Write as much of a buffer to the specified com port as fits in the
+    transmit FIFO.  The 16550 cannot report how full its transmit FIFO is, so
+    the FIFO is only filled once the LSR reports it empty, and is then filled
+    without any further status checks.
+
+Arguments:
+
+    Adapter - the 16550 adapter object
+
+    Buffer - data to emit
+
+    Length - the number of bytes in Buffer
+
+    BytesWritten - the number of bytes placed in the transmit FIFO is
+                   returned here
+
+Return Value:
+
+    STATUS_SUCCESS - at least one byte was written
+
+    STATUS_IO_TIMEOUT - the transmitter isn't ready
+
+    other - error code
+
+--*/
+
+{
+    ULONG Count;
+    ULONG Index;
+    UCHAR lsr;
+
+    *BytesWritten = 0;
+    if (!Adapter->PortPresent) {
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    if (Length == 0) {
+        return STATUS_SUCCESS;
+    }
+
+    //
+    // CTS is checked once for the whole burst.  With automatic flow control
+    // the transmitter holds the remainder in the FIFO should the other side
+    // deassert CTS part way through.  Without it, the other side must absorb
+    // up to a FIFO load after deasserting CTS, as it already has to for the
+    // bytes in flight on the wire.
+    //
+
+    if (!Uart16550CheckClearToSend(Adapter)) {
+        return STATUS_IO_TIMEOUT;
+    }
+
+    lsr = Uart16550ReadLsr(Adapter, COM_OUTRDY);
+    if ((lsr == SERIAL_LSR_NOT_PRESENT) || ((lsr & COM_OUTRDY) == 0)) {
+        return STATUS_IO_TIMEOUT;
+    }
+
+    Count = Adapter->FifoDepth;
+    if (Count > Length) {
+        Count = Length;
+    }
+
+    for (Index = 0; Index < Count; Index += 1) {
+        WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_DAT, Buffer[Index]);
+    }
+
+    *BytesWritten = Count;
+    Adapter->Statistics.BytesTransmitted += Count;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+Uart16550ReadSerialBuffer(
+    __in PUART_16550_ADAPTER Adapter,
+    __out_bcount(Length) PUCHAR Buffer,
+    __in ULONG Length,
+    __out PULONG BytesRead
+    )
+
+/*++
+
+Routine Description:
+
+    Drain the receive FIFO into a buffer.  The 16550 cannot report how full
+    its receive FIFO is, so the LSR is checked before each byte, but the
+    whole FIFO is drained in a single call.  The number of bytes drained back
+    to back, bounded by the FIFO depth, is recorded as the receive FIFO high
+    water mark.
+
+Arguments:
+
+    Adapter - the 16550 adapter object
+
+    Buffer - address of the buffer to hold the result
+
+    Length - the size of Buffer in bytes
+
+    BytesRead - the number of bytes read from the receive FIFO is returned
+                here
+
+Return Value:
+
+    STATUS_SUCCESS if data returned.
+
+    STATUS_IO_TIMEOUT if no data available, but no error.
+
+--*/
+
+{
+    ULONG Count;
+    ULONG HighWater;
+    UCHAR lsr;
+
+    *BytesRead = 0;
+    if (!Adapter->PortPresent) {
+        if (Uart16550ReadLsr(Adapter, COM_DATRDY) == SERIAL_LSR_NOT_PRESENT) {
+
+            return STATUS_IO_TIMEOUT;
+        } else {
+            Uart16550SetBaud(Adapter, Adapter->BaudRate);
+            Adapter->PortPresent = TRUE;
+        }
+    }
+
+    if (Length == 0) {
+        return STATUS_SUCCESS;
+    }
+
+    Count = 0;
+    while (Count < Length) {
+        lsr = Uart16550ReadLsr(Adapter, COM_DATRDY);
+        if ((lsr == SERIAL_LSR_NOT_PRESENT) || ((lsr & COM_DATRDY) == 0)) {
+            break;
+        }
+
+        //
+        // As with the single byte path, errors are counted but the data is
+        // still returned to the protocol layer.
+        //
+
+        Uart16550RecordLineErrors(Adapter, lsr);
+        Buffer[Count] = READ_PORT_UCHAR(Adapter->LegacyPort + COM_DAT);
+        Count += 1;
+    }
+
+    if (Count == 0) {
+        return STATUS_IO_TIMEOUT;
+    }
+
+    HighWater = Count;
+    if (HighWater > Adapter->FifoDepth) {
+        HighWater = Adapter->FifoDepth;
+    }
+
+    if (HighWater > Adapter->Statistics.RxFifoHighWater) {
+        Adapter->Statistics.RxFifoHighWater = HighWater;
+    }
+
+    *BytesRead = Count;
+    Adapter->Statistics.BytesReceived += Count;
+    return STATUS_SUCCESS;
+}
+
+BOOLEAN
+Uart16550RunLoopbackPass(
+    __in PUART_16550_ADAPTER Adapter,
+    __in ULONG PollInterval,
+    __out PULONG64 Cycles
+    )
+
+/*++
+
+Routine Description:
+
+    Loops UART16550_TUNE_BYTES of a known pattern through the UART with the
+    currently programmed receive trigger level.  The receive FIFO is drained
+    once per poll interval to model KDNET's polling.  The UART must already
+    be in internal loopback.
+
+Arguments:
+
+    Adapter - the 16550 adapter object
+
+    PollInterval - the stall in microseconds between receive FIFO drains
+
+    Cycles - the number of cycle counter ticks the pass took is returned here
+
+Return Value:
+
+    TRUE if every byte came back intact without an overrun, FALSE otherwise.
+
+--*/
+
+{
+    UCHAR Byte;
+    ULONG FifoOverflows;
+    ULONG IdlePolls;
+    ULONG Received;
+    ULONG Sent;
+    ULONG64 Start;
+    BOOLEAN Drained;
+
+    FifoOverflows = Adapter->FifoOverflows;
+    IdlePolls = 0;
+    Received = 0;
+    Sent = 0;
+    *Cycles = 0;
+    Start = KdReadCycleCounter(NULL);
+    while (Received < UART16550_TUNE_BYTES) {
+        while ((Sent < UART16550_TUNE_BYTES) &&
+               NT_SUCCESS(Uart16550WriteSerialByte(Adapter, (UCHAR)Sent))) {
+
+            Sent += 1;
+        }
+
+        KeStallExecutionProcessor(PollInterval);
+        Drained = FALSE;
+        while (NT_SUCCESS(Uart16550ReadSerialByte(Adapter, &Byte))) {
+            if (Byte != (UCHAR)Received) {
+                return FALSE;
+            }
+
+            Received += 1;
+            Drained = TRUE;
+        }
+
+        if (!Drained) {
+            IdlePolls += 1;
+            if (IdlePolls > UART16550_TUNE_MAX_IDLE_POLLS) {
+                return FALSE;
+            }
+
+        } else {
+            IdlePolls = 0;
+        }
+    }
+
+    *Cycles = KdReadCycleCounter(NULL) - Start;
+    return (Adapter->FifoOverflows == FifoOverflows);
+}
+
+NTSTATUS
+Uart16550TuneFlowThresholds(
+    __in PUART_16550_ADAPTER Adapter,
+    __in ULONG PollInterval,
+    __out PKD_SERIAL_FLOW_THRESHOLDS Thresholds
+    )
+
+/*++
+
+Routine Description:
+
+    Finds the receive trigger level (and thus the automatic flow control 
+    watermark) giving the best loopback throughput without overruns, programs
+    it and returns the resulting thresholds.  If no level passes, the 
+    original level is restored.  The loopback pattern never crossed the link,
+    so the link statistics and overrun count are restored once tuning ends.
+
+Arguments:
+
+    Adapter - the 16550 adapter object
+
+    PollInterval - the stall in microseconds between receive FIFO drains,
+                   zero for the default
+
+    Thresholds - the thresholds in effect on return are returned here
+
+Return Value:
+
+    STATUS_SUCCESS / STATUS_UNSUCCESSFUL / STATUS_NOT_SUPPORTED
+
+--*/
+
+{
+    ULONG64 BestCycles;
+    ULONG BestLevel;
+    ULONG64 CtsStallCycles;
+    ULONG64 CtsStallStart;
+    ULONG64 Cycles;
+    ULONG FifoOverflows;
+    ULONG Index;
+    UCHAR Mcr;
+    ULONG NotClearToSend;
+    ULONG OriginalLevel;
+    KD_SERIAL_STATISTICS Statistics;
+    NTSTATUS Status;
+
+    if (!Adapter->PortPresent) {
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    //
+    // Without automatic flow control there is no watermark to tune.
+    //
+
+    if (!Adapter->AutoFlowControl) {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    if (PollInterval == 0) {
+        PollInterval = UART16550_TUNE_DEFAULT_POLL_INTERVAL;
+    }
+
+    OriginalLevel = Adapter->RxTriggerLevel;
+    Statistics = Adapter->Statistics;
+    CtsStallStart = Adapter->CtsStallStart;
+    CtsStallCycles = Adapter->CtsStallCycles;
+    FifoOverflows = Adapter->FifoOverflows;
+    NotClearToSend = Adapter->NotClearToSend;
+
+    //
+    // Internal loopback connects TX to RX and RTS to CTS, so the automatic 
+    // flow control paths are exercised exactly as they are on the wire.
+    //
+
+    Mcr = READ_PORT_UCHAR(Adapter->LegacyPort + COM_MCR);
+    WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_MCR, Mcr | SERIAL_MCR_LOOP);
+
+    BestLevel = 0;
+    BestCycles = MAXULONG64;
+
+    //
+    // A trigger level of one byte deasserts RTS on every byte and is never
+    // going to win, so start from the next level up.
+    //
+
+    for (Index = 1; Index < RTL_NUMBER_OF(Uart16550RxTriggerLevels); Index += 1) {
+        RtlZeroMemory(Thresholds, sizeof(KD_SERIAL_FLOW_THRESHOLDS));
+        Thresholds->FlowHighWatermark = Uart16550RxTriggerLevels[Index];
+        Uart16550SetFlowThresholds(Adapter, Thresholds);
+        WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_FCR, 
+                         Adapter->FifoControl | FC_CLEAR_RECEIVE | FC_CLEAR_TRANSMIT);
+
+        if (Uart16550RunLoopbackPass(Adapter, PollInterval, &Cycles)) {
+            if (Cycles < BestCycles) {
+                BestCycles = Cycles;
+                BestLevel = Uart16550RxTriggerLevels[Index];
+            }
+        }
+    }
+
+    WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_FCR, 
+                     Adapter->FifoControl | FC_CLEAR_RECEIVE | FC_CLEAR_TRANSMIT);
+    WRITE_PORT_UCHAR(Adapter->LegacyPort + COM_MCR, Mcr);
+    Adapter->Statistics = Statistics;
+    Adapter->CtsStallStart = CtsStallStart;
+    Adapter->CtsStallCycles = CtsStallCycles;
+    Adapter->FifoOverflows = FifoOverflows;
+    Adapter->NotClearToSend = NotClearToSend;
+
+    RtlZeroMemory(Thresholds, sizeof(KD_SERIAL_FLOW_THRESHOLDS));
+    if (BestLevel != 0) {
+        Thresholds->FlowHighWatermark = BestLevel;
+        Status = STATUS_SUCCESS;
+
+    } else {
+        Thresholds->FlowHighWatermark = OriginalLevel;
+        Status = STATUS_UNSUCCESSFUL;
+    }
+
+    Uart16550SetFlowThresholds(Adapter, Thresholds);
+    return Status;
+}
+
+VOID
+Uart16550QueryStatistics(
+    __in PUART_16550_ADAPTER Adapter,
+    __in BOOLEAN Reset,
+    __out PKD_SERIAL_STATISTICS Statistics
+    )
+
+/*++
+
+Routine Description:
+
+    Returns the link statistics and optionally resets them.  A CTS stall 
+    which is still in progress is accounted up to the time of the query.
+    The 16550 has no FIFO level register, so RxFifoHighWater is always zero.
+
+Arguments:
+
+    Adapter - the 16550 adapter object
+
+    Reset - whether to reset the statistics after returning them
+
+    Statistics - the statistics are returned here
+
+--*/
+
+{
+    ULONG64 Frequency;
+    ULONG64 Now;
+    ULONG64 StallCycles;
+
+    Frequency = 0;
+    Now = KdReadCycleCounter(&Frequency);
+    StallCycles = Adapter->CtsStallCycles;
+    if (Adapter->CtsStallStart != 0) {
+        StallCycles += Now - Adapter->CtsStallStart;
+    }
+
+    *Statistics = Adapter->Statistics;
+    if (Frequency != 0) {
+        Statistics->CtsStallMicroseconds = (StallCycles * 1000000) / Frequency;
+    }
+
+    if (Reset) {
+        RtlZeroMemory(&Adapter->Statistics, sizeof(KD_SERIAL_STATISTICS));
+        Adapter->CtsStallCycles = 0;
+        if (Adapter->CtsStallStart != 0) {
+            Adapter->CtsStallStart = Now;
+        }
+    }
+}
+
 NTSTATUS
 Uart16550DeviceControl(
     __in PUART_16550_ADAPTER Adapter,
@@ -546,6 +1152,7 @@ Return Value:
 --*/
 
 {
+    ULONG PollInterval;
     NTSTATUS Status;
 
     Status = STATUS_INVALID_DEVICE_REQUEST;
@@ -587,6 +1194,59 @@ Return Value:
             Uart16550RequestToSend(Adapter, *(BOOLEAN *)InputBuffer);
             break;
 
+        case KD_DEVICE_CONTROL_SERIAL_SET_FLOW_THRESHOLDS:
+            if (InputBufferSize < sizeof(KD_SERIAL_FLOW_THRESHOLDS)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            Status = Uart16550SetFlowThresholds(
+                Adapter, 
+                (PKD_SERIAL_FLOW_THRESHOLDS)InputBuffer
+                );
+
+            if (NT_SUCCESS(Status) &&
+                (OutputBufferSize >= sizeof(KD_SERIAL_FLOW_THRESHOLDS))) {
+
+                RtlCopyMemory(OutputBuffer, 
+                              InputBuffer, 
+                              sizeof(KD_SERIAL_FLOW_THRESHOLDS));
+            }
+            break;
+
+        case KD_DEVICE_CONTROL_SERIAL_TUNE_FLOW_THRESHOLDS:
+            if (OutputBufferSize < sizeof(KD_SERIAL_FLOW_THRESHOLDS)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            PollInterval = 0;
+            if (InputBufferSize >= sizeof(ULONG)) {
+                PollInterval = *(ULONG *)InputBuffer;
+            }
+
+            Status = Uart16550TuneFlowThresholds(
+                Adapter, 
+                PollInterval, 
+                (PKD_SERIAL_FLOW_THRESHOLDS)OutputBuffer
+                );
+            break;
+
+        case KD_DEVICE_CONTROL_SERIAL_QUERY_STATISTICS:
+            if (OutputBufferSize < sizeof(KD_SERIAL_STATISTICS)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            Uart16550QueryStatistics(
+                Adapter, 
+                (InputBufferSize >= sizeof(BOOLEAN)) && *(BOOLEAN *)InputBuffer, 
+                (PKD_SERIAL_STATISTICS)OutputBuffer
+                );
+
+            Status = STATUS_SUCCESS;
+            break;
+
         default:
             break;
     }
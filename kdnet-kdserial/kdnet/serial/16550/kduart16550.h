@@ -19,7 +19,10 @@ typedef struct _UART_16550_ADAPTER {
     BOOLEAN AutoFlowControl;
     BOOLEAN FlowAllowed;
     BOOLEAN PortPresent;
+    UCHAR FifoControl;
     ULONG BaudRate;
+    ULONG RxTriggerLevel;
+    ULONG FifoDepth;
 
     //
     // Debug counters:
@@ -31,6 +34,16 @@ typedef struct _UART_16550_ADAPTER {
     ULONG RxPacketFlowSpinCounts;
     ULONG FifoOverflows;
 
+    //
+    // Link statistics reported through KD_DEVICE_CONTROL_SERIAL_QUERY_STATISTICS.
+    // CTS stalls are tracked in cycle counter ticks and only converted when
+    // queried.
+    //
+
+    KD_SERIAL_STATISTICS Statistics;
+    ULONG64 CtsStallStart;
+    ULONG64 CtsStallCycles;
+
 } UART_16550_ADAPTER, *PUART_16550_ADAPTER;
 
 ULONG 
@@ -61,6 +74,22 @@ Uart16550ReadSerialByte(
     __out PUCHAR Byte
     );
 
+NTSTATUS
+Uart16550WriteSerialBuffer(
+    __in PUART_16550_ADAPTER Adapter,
+    __in_bcount(Length) const UCHAR *Buffer,
+    __in ULONG Length,
+    __out PULONG BytesWritten
+    );
+
+NTSTATUS
+Uart16550ReadSerialBuffer(
+    __in PUART_16550_ADAPTER Adapter,
+    __out_bcount(Length) PUCHAR Buffer,
+    __in ULONG Length,
+    __out PULONG BytesRead
+    );
+
 NTSTATUS
 Uart16550DeviceControl(
     __in PUART_16550_ADAPTER Adapter,
@@ -117,6 +117,78 @@ Return Value:
     return OX16PCI95XReadSerialByte(Adapter, Byte);
 }
 
+NTSTATUS
+KdWriteSerialBuffer(
+    __in PVOID Adapter,
+    __in_bcount(Length) const UCHAR *Buffer,
+    __in ULONG Length,
+    __out PULONG BytesWritten
+    )
+
+/*++
+
+Routine Description:
+
+    Write as much of a buffer to the serial port as the transmit FIFO can
+    take.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Buffer - The bytes to write to the serial port.
+
+    Length - The number of bytes in Buffer.
+
+    BytesWritten - The number of bytes written is returned here.
+
+Return Value:
+
+    STATUS_SUCCESS if at least one byte was written.
+    STATUS_IO_TIMEOUT if the transmitter is not ready.
+
+--*/
+
+{
+    return OX16PCI95XWriteSerialBuffer(Adapter, Buffer, Length, BytesWritten);
+}
+
+NTSTATUS
+KdReadSerialBuffer(
+    __in PVOID Adapter,
+    __out_bcount(Length) PUCHAR Buffer,
+    __in ULONG Length,
+    __out PULONG BytesRead
+    )
+
+/*++
+
+Routine Description:
+
+    Read the bytes waiting in the receive FIFO of the serial port.  This
+    will immediately timeout if there is not a byte on the serial FIFO.
+
+Arguments:
+
+    Adapter - Supplies a pointer to the debug adapter object.
+
+    Buffer - The bytes read from the serial port will be placed here.
+
+    Length - The size of Buffer in bytes.
+
+    BytesRead - The number of bytes read is returned here.
+
+Return Value:
+
+    STATUS_SUCCESS on a successful read from the serial port.
+    STATUS_IO_TIMEOUT if there is no data available.
+
+--*/
+
+{
+    return OX16PCI95XReadSerialBuffer(Adapter, Buffer, Length, BytesRead);
+}
+
 NTSTATUS
 KdDeviceControl(
     __in PVOID Adapter,
@@ -284,7 +356,8 @@ KdInitializeLibrary (
     }
 
     Exports = KdNetExtensibilityImports->Exports;
-    if ((Exports == NULL) || (Exports->FunctionCount != KDNET_EXT_EXPORTS)) {
+    if ((Exports == NULL) ||
+        !KDNET_EXT_EXPORTS_SUPPORTED(Exports->FunctionCount)) {
         Status = STATUS_INVALID_PARAMETER;
         goto KdInitializeLibraryEnd;
     }
@@ -300,6 +373,10 @@ KdInitializeLibrary (
     Exports->KdReadSerialByte = KdReadSerialByte;
     Exports->KdWriteSerialByte = KdWriteSerialByte;
     Exports->KdDeviceControl = KdDeviceControl;
+    if (Exports->FunctionCount >= KDNET_EXT_EXPORTS) {
+        Exports->KdWriteSerialBuffer = KdWriteSerialBuffer;
+        Exports->KdReadSerialBuffer = KdReadSerialBuffer;
+    }
 
     //
     // Return the hardware context size required to support this device.
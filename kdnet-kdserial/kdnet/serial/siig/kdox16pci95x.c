@@ -12,26 +12,27 @@ Abstract:
 
     This is specifically targeted to the 18.432 MHz clock input to the 16PCI95X
     on the SIIG CyberPro series of PCI serial cards.  Note that support for 
-    any 16PCI95X device can be easily added (up to standard 16550 baud rates) by
-    changing recognition of the device and clock prescaler parameters.
+    any 16PCI95X device can be easily added by changing recognition of the
+    device and its clock input frequency.
 
 --*/
 
 #include "pch.h"
 
-ULONG OX16PCI95XSerialBaudDividend = CLOCK_RATE;
 const static ULONG DEFAULT_ADDRESS_SIZE_UART16550 = 8;
 
 //
-// The clock on the SIIG CyberPro 2S is 18.432 MHz.  The OX16PCI95X needs 
-// to be programmed with a prescaler divisor of (M=10 + N=0/8) in order to 
-// allow the DLL and DLM divisor latch to behave identically to a 16550 
-// and be programmable as such.
+// The clock on the SIIG CyberPro 2S is 18.432 MHz.  Rather than fixing the
+// prescaler to scale this down to a standard 16550 clock, the sample clock,
+// prescaler and divisor latch are solved for together per baud rate (see
+// OX16PCI95XSolveBaudDivisor).
 //
 
 #define PCI_VID_OXFORDSEMI 0x1415
 #define PCI_DID_SIIG_CYBERPRO_OX16PCI95X 0x950A
 
+#define OX16PCI95X_SIIG_CYBERPRO_CLOCK 18432000
+
 #define ENABLED 1
 #define DISABLED 0
 
@@ -147,6 +148,14 @@ const static ULONG DEFAULT_ADDRESS_SIZE_UART16550 = 8;
 #define OX16PCI95X_CPR_PRESCALER_FRAC_SHIFT 0
 #define OX16PCI95X_CPR_PRESCALER_FRAC_MASK 0x07
 
+//
+// The prescaler is M + N/8 and is handled as a count of eighths.  M must be
+// at least one.
+//
+
+#define OX16PCI95X_CPR_MIN 0x08
+#define OX16PCI95X_CPR_MAX 0xFF
+
 //
 // TCR Indexed Register:
 //
@@ -168,6 +177,37 @@ const static ULONG DEFAULT_ADDRESS_SIZE_UART16550 = 8;
 #define OX16PCI95X_TCR_SAMPCLOCK_DIV_5 0x05
 #define OX16PCI95X_TCR_SAMPCLOCK_DIV_4 0x04
 
+//
+// Sample clocks below 4 are not supported by the part.  A sample clock of 16
+// is encoded as zero in the TCR.
+//
+
+#define OX16PCI95X_SAMPLE_CLOCK_MIN 4
+#define OX16PCI95X_SAMPLE_CLOCK_MAX 16
+
+#define OX16PCI95X_DIVISOR_MAX 0xFFFF
+
+//
+// The largest baud rate error that the solver will accept.  Asynchronous
+// framing starts to fail somewhere beyond 2%.
+//
+
+#define OX16PCI95X_MAX_BAUD_ERROR_PPM 20000
+
+//
+// TTL Indexed Register:
+//
+
+#define OX16PCI95X_IDX_TTL 0x04
+#define OX16PCI95X_TX_TRIGGER_MASK 0x7F
+
+//
+// RTL Indexed Register:
+//
+
+#define OX16PCI95X_IDX_RTL 0x05
+#define OX16PCI95X_RX_TRIGGER_MASK 0x7F
+
 //
 // FCL Indexed Register:
 //
@@ -205,6 +245,20 @@ const static ULONG DEFAULT_ADDRESS_SIZE_UART16550 = 8;
 #define OX16PCI95X_COM_950_RFL 0x03
 #define OX16PCI95X_COM_950_TFL 0x04
 
+#define OX16PCI95X_MAX_FIFO_DEPTH 128
+
+//
+// Flow control threshold tuning parameters.  Each candidate high watermark
+// is exercised by looping back OX16PCI95X_TUNE_BYTES through the UART.  The
+// loopback has none of the latency of a real remote transmitter, so the 
+// candidates stop an eighth of the FIFO short of full to leave room for the
+// bytes still in flight when RTS drops on a real link.
+//
+
+#define OX16PCI95X_TUNE_BYTES 2048
+#define OX16PCI95X_TUNE_DEFAULT_POLL_INTERVAL 100
+#define OX16PCI95X_TUNE_MAX_IDLE_POLLS 1000
+
 ULONG
 OX16PCI95XGetContextSize(
     __in PDEBUG_DEVICE_DESCRIPTOR Device
@@ -232,37 +286,35 @@ Return Value:
     return sizeof(OX16PCI95X_ADAPTER);
 }
 
-VOID
-OX16PCI95XGetClockPrescalerDivisor(
-    __in PDEBUG_DEVICE_DESCRIPTOR Device,
-    __out PUCHAR Integral,
-    __out PUCHAR Fractional
+ULONG
+OX16PCI95XGetClockFrequency(
+    __in PDEBUG_DEVICE_DESCRIPTOR Device
     )
 /*++
 
 Routine Description:
 
-    Returns the clock prescaler settings required to downsample the clock
-    input of the OX16PCI95X to the 1.8432 MHz standard clock of a 16550 UART. 
+    Returns the frequency of the clock input to the OX16PCI95X.  The baud rate
+    solver derives the sample clock, clock prescaler and divisor latch settings
+    from this.
 
 Arguments:
 
     Device - The debug device descriptor
 
-    Integral - The integral portion of the clock prescaler divisor is 
-               returned here
+Return Value:
 
-    Fractional - The fractional (as 8-ths) portion of the clock prescaler
-                 divisor is returned here.
+    The clock input frequency in Hz.
 
 --*/
 
 {
+    ULONG ClockFrequency = 0;
+
     //
     // Currently, this only supports the 18.432 MHz clock input on the SIIG 
     // CyberPro 2S board.  Any other OX16PCI95X board can be supported by
-    // returning the appropriate prescaler divisor for the clock input to the
-    // chip in this method.
+    // returning the clock input to the chip in this method.
     //
 
     switch(Device->VendorID)
@@ -271,14 +323,7 @@ Arguments:
             switch(Device->DeviceID)
             {
                 case PCI_DID_SIIG_CYBERPRO_OX16PCI95X:
-                    // 
-                    // Clock is 18.432 MHz.  Downscale to 1.8432 MHz as
-                    // standard 16550 clock rate by setting a prescaler
-                    // divisor of 10 + 0/8
-                    //
-
-                    *Integral = 10;
-                    *Fractional = 0;
+                    ClockFrequency = OX16PCI95X_SIIG_CYBERPRO_CLOCK;
                     break;
 
                 default:
@@ -303,6 +348,120 @@ Arguments:
             break;
 
     }
+
+    return ClockFrequency;
+}
+
+NTSTATUS
+OX16PCI95XSolveBaudDivisor(
+    __in ULONG ClockFrequency,
+    __in ULONG Rate,
+    __out POX16PCI95X_BAUD_SETTINGS Settings
+    )
+/*++
+
+Routine Description:
+
+    Searches the sample clock (TCR), clock prescaler (CPR) and divisor latch
+    (DLL/DLM) space for the combination which most closely produces the 
+    requested baud rate from the given clock input.  The resulting rate is
+
+        Rate = (8 * ClockFrequency) / (SampleClock * CPR * Divisor)
+
+    where CPR is expressed in eighths (M << 3 | N).  Ties are broken in favor
+    of the highest sample clock since that gives the receiver the most 
+    tolerance for clock skew.
+
+    This routine touches no hardware.
+
+Arguments:
+
+    ClockFrequency - The clock input to the chip in Hz
+
+    Rate - The requested baud rate
+
+    Settings - The best register settings found along with the rate they 
+               achieve and its error relative to Rate are returned here
+
+Return Value:
+
+    STATUS_SUCCESS - Settings within OX16PCI95X_MAX_BAUD_ERROR_PPM of Rate
+                     were found.
+
+    STATUS_NOT_SUPPORTED - The closest achievable rate is outside of the 
+                           tolerance.  Settings still describes it.
+
+    STATUS_INVALID_PARAMETER - Rate or ClockFrequency is zero.
+
+--*/
+
+{
+    ULONG64 ActualRate;
+    ULONG64 Denominator;
+    ULONG64 Divisor;
+    ULONG64 Error;
+    ULONG64 BestError;
+    ULONG64 Numerator;
+    ULONG Prescaler;
+    ULONG SampleClock;
+
+    RtlZeroMemory(Settings, sizeof(OX16PCI95X_BAUD_SETTINGS));
+    if ((Rate == 0) || (ClockFrequency == 0)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    Numerator = (ULONG64)ClockFrequency * 8;
+    BestError = MAXULONG64;
+    for (SampleClock = OX16PCI95X_SAMPLE_CLOCK_MAX;
+         SampleClock >= OX16PCI95X_SAMPLE_CLOCK_MIN;
+         SampleClock -= 1) {
+
+        for (Prescaler = OX16PCI95X_CPR_MIN;
+             Prescaler <= OX16PCI95X_CPR_MAX;
+             Prescaler += 1) {
+
+            //
+            // Round the divisor to the nearest integer and clamp it to what
+            // fits in the divisor latch.
+            //
+
+            Denominator = (ULONG64)SampleClock * Prescaler * Rate;
+            Divisor = (Numerator + (Denominator / 2)) / Denominator;
+            if (Divisor == 0) {
+                Divisor = 1;
+            } else if (Divisor > OX16PCI95X_DIVISOR_MAX) {
+                Divisor = OX16PCI95X_DIVISOR_MAX;
+            }
+
+            Denominator = (ULONG64)SampleClock * Prescaler * Divisor;
+            ActualRate = (Numerator + (Denominator / 2)) / Denominator;
+            if (ActualRate > Rate) {
+                Error = ActualRate - Rate;
+            } else {
+                Error = Rate - ActualRate;
+            }
+
+            Error = (Error * 1000000) / Rate;
+            if (Error < BestError) {
+                BestError = Error;
+                Settings->SampleClock = (UCHAR)(SampleClock & 
+                                                OX16PCI95X_TCR_SAMPCLOCK_MASK);
+                Settings->Prescaler = (UCHAR)Prescaler;
+                Settings->Divisor = (USHORT)Divisor;
+                Settings->ActualRate = (ULONG)ActualRate;
+                Settings->ErrorPpm = (ULONG)Error;
+                if (Error == 0) {
+                    return STATUS_SUCCESS;
+                }
+            }
+        }
+    }
+
+    if (BestError > OX16PCI95X_MAX_BAUD_ERROR_PPM) {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    return STATUS_SUCCESS;
 }
 
 BOOLEAN
@@ -605,6 +764,89 @@ Returns:
 }
 
 VOID
+OX16PCI95XRecordLineErrors(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __in UCHAR Lsr
+    )
+
+/*++
+
+Routine Description:
+
+    Accounts for the receive errors reported in a line status value.
+
+Arguments:
+
+    Adapter - The OX16PCI95X adapter object.
+
+    Lsr - The line status register value accompanying the received data.
+
+--*/
+
+{
+    if (Lsr & (COM_FE | COM_PE | COM_OE)) {
+        if (Lsr & COM_OE) {
+            Adapter->FifoOverflows++;
+            Adapter->Statistics.Overruns++;
+        } else {
+            Adapter->ErrorCount++;
+        }
+
+        if (Lsr & COM_FE) {
+            Adapter->Statistics.FramingErrors++;
+        }
+
+        if (Lsr & COM_PE) {
+            Adapter->Statistics.ParityErrors++;
+        }
+    }
+}
+
+BOOLEAN
+OX16PCI95XCheckClearToSend(
+    __in POX16PCI95X_ADAPTER Adapter
+    )
+
+/*++
+
+Routine Description:
+
+    Samples CTS for the transmit path and accounts for the time spent stalled
+    on it.  A stall starts at the first sample which finds CTS deasserted and
+    ends at the first which finds it asserted again.
+
+Arguments:
+
+    Adapter - The OX16PCI95X adapter object.
+
+Return Value:
+
+    Whether we are clear to send.
+
+--*/
+
+{
+    if (OX16PCI95XIsClearToSend(Adapter)) {
+        if (Adapter->CtsStallStart != 0) {
+            Adapter->CtsStallCycles += KdReadCycleCounter(NULL) - 
+                                       Adapter->CtsStallStart;
+
+            Adapter->CtsStallStart = 0;
+        }
+
+        return TRUE;
+    }
+
+    if (Adapter->CtsStallStart == 0) {
+        Adapter->CtsStallStart = KdReadCycleCounter(NULL);
+    }
+
+    Adapter->NotClearToSend++;
+    Adapter->Statistics.NotClearToSend++;
+    return FALSE;
+}
+
+NTSTATUS
 OX16PCI95XSetBaud (
     __in POX16PCI95X_ADAPTER Adapter,
     const ULONG Rate
@@ -622,65 +864,70 @@ Arguments:
 
     Rate - baud rate 
 
+Return Value:
+
+    STATUS_SUCCESS - the port was programmed within tolerance of Rate.
+
+    STATUS_NOT_SUPPORTED - the closest achievable rate was programmed but
+                           is outside of tolerance.
+
+    STATUS_INVALID_PARAMETER - Rate is zero; the port was left alone.
+
 --*/
 
 {
     //
-    // While the 16PCI95X has a register set which is compatible with a 
-    // standard 16550 UART, the clock frequency of the SIIG board is 18.432 MHz
-    // which is 10x the clock rate of the standard 16550.  Make it behave as a
-    // standard // 16550 by setting the clock pre-scaler to scale down the 
-    // hardware clock 10x.  Any set of the baud rate divisor latch will then 
-    // be standard 16550 compatible (though the device will not be able to go
-    // above 115200 baud).
+    // The 16PCI95X has a register set which is compatible with a standard
+    // 16550 UART, but the baud rate is a function of three settings: the 
+    // sample clock (TCR), the clock prescaler (CPR) and the 16550 divisor 
+    // latch.  Solve for the combination closest to the requested rate.  This
+    // is what allows the part to go well above 115200 baud.  The prescaler
+    // is only in effect once MCR[7] has been set during initialization.
     //
     // Further, setup N81.
     //
 
-    UCHAR ClockPrescale;
+    OX16PCI95X_BAUD_SETTINGS Settings;
+    NTSTATUS Status;
     UCHAR Lcr;
-    UCHAR PrescalerInt;
-    UCHAR PrescalerFrac;
+
+    Status = OX16PCI95XSolveBaudDivisor(
+        OX16PCI95XGetClockFrequency(Adapter->KdNet->Device),
+        Rate,
+        &Settings
+        );
+
+    if (Status == STATUS_INVALID_PARAMETER) {
+        return Status;
+    }
+
+    Adapter->ActualBaudRate = Settings.ActualRate;
+    Adapter->BaudRateErrorPpm = Settings.ErrorPpm;
 
     Lcr = (OX16PCI95X_LCR_PARITY_NONE << OX16PCI95X_LCR_PARITY_SHIFT) |
           (OX16PCI95X_LCR_STOP_1_BIT << OX16PCI95X_LCR_STOP_SHIFT) |
           (OX16PCI95X_LCR_DATALENGTH_8_BIT << OX16PCI95X_LCR_DATALENGTH_SHIFT);
     WRITE_PORT_UCHAR(Adapter->IoPort + COM_LCR, Lcr);
 
-    OX16PCI95XGetClockPrescalerDivisor(
-        Adapter->KdNet->Device, 
-        &PrescalerInt, 
-        &PrescalerFrac
+    OX16PCI95XWriteIndexedRegister(Adapter, OX16PCI95X_IDX_CPR, Settings.Prescaler);
+    OX16PCI95XWriteIndexedRegister(
+        Adapter, 
+        OX16PCI95X_IDX_TCR, 
+        (UCHAR)(Settings.SampleClock << OX16PCI95X_TCR_SAMPCLOCK_SHIFT)
         );
 
-    ClockPrescale = (PrescalerInt << OX16PCI95X_CPR_PRESCALER_INT_SHIFT) |
-                    (PrescalerFrac << OX16PCI95X_CPR_PRESCALER_FRAC_SHIFT);
-    OX16PCI95XWriteIndexedRegister(Adapter, OX16PCI95X_IDX_CPR, ClockPrescale);
-
-    UCHAR ClockSampling = (OX16PCI95X_TCR_SAMPCLOCK_DIV_16 << 
-                           OX16PCI95X_TCR_SAMPCLOCK_SHIFT);
-    OX16PCI95XWriteIndexedRegister(Adapter, OX16PCI95X_IDX_TCR, ClockSampling);
-
-    if (OX16PCI95XSerialBaudDividend != 0) {
-
-        //
-        // Compute the divsor
-        //
-
-        const ULONG DivisorLatch = OX16PCI95XSerialBaudDividend / Rate;
-
-        //
-        // set the divisor latch access bit (DLAB) in the line control reg
-        //
+    //
+    // set the divisor latch access bit (DLAB) in the line control reg
+    //
 
-        Lcr = READ_PORT_UCHAR(Adapter->IoPort + COM_LCR);
-        WRITE_PORT_UCHAR(Adapter->IoPort + COM_LCR, Lcr | LC_DLAB);
-        WRITE_PORT_UCHAR(Adapter->IoPort + COM_DLM,
-                           (UCHAR)((DivisorLatch >> 8) & 0xff));
+    Lcr = READ_PORT_UCHAR(Adapter->IoPort + COM_LCR);
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_LCR, Lcr | LC_DLAB);
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_DLM,
+                       (UCHAR)((Settings.Divisor >> 8) & 0xff));
 
-        WRITE_PORT_UCHAR(Adapter->IoPort, (UCHAR)(DivisorLatch & 0xff));
-        WRITE_PORT_UCHAR(Adapter->IoPort + COM_LCR, Lcr);
-    }
+    WRITE_PORT_UCHAR(Adapter->IoPort, (UCHAR)(Settings.Divisor & 0xff));
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_LCR, Lcr);
+    return Status;
 }
 
 UCHAR
@@ -723,100 +970,259 @@ Return Value:
     return RxFifoLength;
 }
 
-NTSTATUS
-OX16PCI95XInitializeController(
-    __in PKDNET_SHARED_DATA KdNet
+UCHAR
+OX16PCI95XReadTxFifoLength(
+    __in POX16PCI95X_ADAPTER Adapter
     )
 
 /*++
 
 Routine Description:
 
-    Fill in the com port port object, set the initial baud rate,
-    turn on the hardware.
+    Reads the current FIFO length of the transmit FIFO.  The adapter must be in
+    950 mode (albeit 950 registers do not need to be mapped) before this is
+    called.
 
 Arguments:
 
-    KdNet - The data shared with KdNet
+    Adapter - the OX16PCI95X adapter object
 
 Return Value:
 
-    STATUS_SUCCESS / STATUS_UNSUCCESSFUL
+    The number of bytes in the transmit FIFO
 
 --*/
 
 {
-    POX16PCI95X_ADAPTER Adapter = (POX16PCI95X_ADAPTER)KdNet->Hardware;
-    NTSTATUS Status;
-    UCHAR Asr;
-
-    Adapter->KdNet = KdNet;
-    Adapter->Are650RegistersMapped = FALSE;
-    Adapter->Are950RegistersMapped = FALSE;
+    BOOLEAN Map950 = !Adapter->Are950RegistersMapped;
+    UCHAR TxFifoLength;
 
-    //
-    // Verify that this is a supported device.
-    //
-    if (!OX16PCI95XIsSupportedDevice(KdNet->Device)) {
-        Status = STATUS_UNSUCCESSFUL;
-        goto OX16PCI95XInitializeControllerEnd;
+    if (Map950) {
+        OX16PCI95XMap950Registers(Adapter);
     }
 
-    if (!KdNet->Device->BaseAddress[0].Valid ||
-        KdNet->Device->BaseAddress[0].Type != CmResourceTypePort ||
-        KdNet->Device->BaseAddress[0].TranslatedAddress == NULL) {
-        Status = STATUS_UNSUCCESSFUL;
-        goto OX16PCI95XInitializeControllerEnd;
+    TxFifoLength = READ_PORT_UCHAR(Adapter->IoPort + OX16PCI95X_COM_950_TFL);
+
+    if (Map950) {
+        OX16PCI95XUnmap950Registers(Adapter);
     }
 
-    Adapter->BaudRate = KdNet->SerialBaudRate;
-    Adapter->PortPresent = TRUE;
-    Adapter->IoPort = KdNet->Device->BaseAddress[0].TranslatedAddress;
+    return TxFifoLength;
+}
 
-    //
-    // The ACR register cannot be read but requires manipulation for
-    // indexed registers.  The driver must keep responsibility for
-    // tracking the value of ACR rather than trying to perform a readback.
-    //
-    Adapter->ACR = 0;
+VOID
+OX16PCI95XReadFlowThresholds(
+    __in POX16PCI95X_ADAPTER Adapter
+    )
 
-    //
-    // Disable all uart interrupts.
-    //
+/*++
 
-    WRITE_PORT_UCHAR(Adapter->IoPort + COM_IEN, 0);
+Routine Description:
 
-    //
-    // Enable the FIFO.
-    //
+    Refreshes the cached FIFO trigger levels and automatic flow control
+    watermarks from the hardware.
 
-    WRITE_PORT_UCHAR(Adapter->IoPort + COM_FCR, FC_ENABLE);
+Arguments:
 
-    //
-    // Assert DTR, RTS.
-    //
+    Adapter - the OX16PCI95X adapter object
 
-    WRITE_PORT_UCHAR(Adapter->IoPort + COM_MCR, MC_DTRRTS);
+--*/
 
-    //
-    // In order to utilize the onboard clock prescaler to reduce the incoming
-    // clock rate from 18.432 MHz to 1.8432 MHz as per a standard 550, the 
-    // hardware must be put into the hardware must be put into "enhanced" 
-    // (650) register mode.  The control bit in MCR which bypasses the 
-    // prescaler (set on hardware reset) is not accessible in pure 550 mode.
-    //
+{
+    Adapter->TxTriggerLevel = OX16PCI95XReadIndexedRegister(
+        Adapter, 
+        OX16PCI95X_IDX_TTL
+        ) & OX16PCI95X_TX_TRIGGER_MASK;
+    Adapter->RxTriggerLevel = OX16PCI95XReadIndexedRegister(
+        Adapter, 
+        OX16PCI95X_IDX_RTL
+        ) & OX16PCI95X_RX_TRIGGER_MASK;
+    Adapter->LowFlowTrigger = OX16PCI95XReadIndexedRegister(
+        Adapter, 
+        OX16PCI95X_IDX_FCL
+        ) & OX16PCI95X_AUTOFLOW_LOW_MASK;
+    Adapter->HighFlowTrigger = OX16PCI95XReadIndexedRegister(
+        Adapter, 
+        OX16PCI95X_IDX_FCH
+        ) & OX16PCI95X_AUTOFLOW_HIGH_MASK;
+}
 
-    OX16PCI95XMap650Registers(Adapter);
+NTSTATUS
+OX16PCI95XSetFlowThresholds(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __inout PKD_SERIAL_FLOW_THRESHOLDS Thresholds
+    )
 
-    //
-    // The 650 registers are now overlayed in our 8 bytes of I/O space.  Turn 
-    // on the clock prescaler by setting the appropriate bits in MCR after
-    // enabling this functionality through enabling enhanced mode in EFR.
-    //
+/*++
 
-    UCHAR Efr = READ_PORT_UCHAR(Adapter->IoPort + OX16PCI95X_COM_650_EFR);
-    Efr |= (OX16PCI95X_EFR_MODE_ENHANCED << OX16PCI95X_EFR_MODE_SHIFT);
-    WRITE_PORT_UCHAR(Adapter->IoPort + OX16PCI95X_COM_650_EFR, Efr);
+Routine Description:
+
+    Programs the 950 FIFO trigger levels (TTL/RTL) and the automatic flow
+    control watermarks (FCL/FCH).  Fields of zero are left unchanged.  On
+    return Thresholds holds the levels in effect.
+
+Arguments:
+
+    Adapter - the OX16PCI95X adapter object
+
+    Thresholds - the requested levels in bytes
+
+Return Value:
+
+    STATUS_SUCCESS / STATUS_INVALID_PARAMETER
+
+--*/
+
+{
+    ULONG High;
+    ULONG Low;
+
+    if ((Thresholds->RxTriggerLevel >= Adapter->FifoDepth) ||
+        (Thresholds->TxTriggerLevel >= Adapter->FifoDepth) ||
+        (Thresholds->FlowLowWatermark >= Adapter->FifoDepth) ||
+        (Thresholds->FlowHighWatermark >= Adapter->FifoDepth)) {
+
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    //
+    // RTS must be reasserted below the level at which it is deasserted.
+    //
+
+    Low = (Thresholds->FlowLowWatermark != 0) ? 
+          Thresholds->FlowLowWatermark : Adapter->LowFlowTrigger;
+
+    High = (Thresholds->FlowHighWatermark != 0) ? 
+           Thresholds->FlowHighWatermark : Adapter->HighFlowTrigger;
+
+    if (Low >= High) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (Thresholds->TxTriggerLevel != 0) {
+        OX16PCI95XWriteIndexedRegister(
+            Adapter, 
+            OX16PCI95X_IDX_TTL, 
+            (UCHAR)Thresholds->TxTriggerLevel
+            );
+    }
+
+    if (Thresholds->RxTriggerLevel != 0) {
+        OX16PCI95XWriteIndexedRegister(
+            Adapter, 
+            OX16PCI95X_IDX_RTL, 
+            (UCHAR)Thresholds->RxTriggerLevel
+            );
+    }
+
+    OX16PCI95XWriteIndexedRegister(Adapter, OX16PCI95X_IDX_FCL, (UCHAR)Low);
+    OX16PCI95XWriteIndexedRegister(Adapter, OX16PCI95X_IDX_FCH, (UCHAR)High);
+    OX16PCI95XReadFlowThresholds(Adapter);
+
+    Thresholds->RxTriggerLevel = Adapter->RxTriggerLevel;
+    Thresholds->TxTriggerLevel = Adapter->TxTriggerLevel;
+    Thresholds->FlowLowWatermark = Adapter->LowFlowTrigger;
+    Thresholds->FlowHighWatermark = Adapter->HighFlowTrigger;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+OX16PCI95XInitializeController(
+    __in PKDNET_SHARED_DATA KdNet
+    )
+
+/*++
+
+Routine Description:
+
+    Fill in the com port port object, set the initial baud rate,
+    turn on the hardware.
+
+Arguments:
+
+    KdNet - The data shared with KdNet
+
+Return Value:
+
+    STATUS_SUCCESS / STATUS_UNSUCCESSFUL
+
+--*/
+
+{
+    POX16PCI95X_ADAPTER Adapter = (POX16PCI95X_ADAPTER)KdNet->Hardware;
+    NTSTATUS Status;
+    UCHAR Asr;
+
+    Adapter->KdNet = KdNet;
+    Adapter->Are650RegistersMapped = FALSE;
+    Adapter->Are950RegistersMapped = FALSE;
+    RtlZeroMemory(&Adapter->Statistics, sizeof(KD_SERIAL_STATISTICS));
+    Adapter->CtsStallStart = 0;
+    Adapter->CtsStallCycles = 0;
+
+    //
+    // Verify that this is a supported device.
+    //
+    if (!OX16PCI95XIsSupportedDevice(KdNet->Device)) {
+        Status = STATUS_UNSUCCESSFUL;
+        goto OX16PCI95XInitializeControllerEnd;
+    }
+
+    if (!KdNet->Device->BaseAddress[0].Valid ||
+        KdNet->Device->BaseAddress[0].Type != CmResourceTypePort ||
+        KdNet->Device->BaseAddress[0].TranslatedAddress == NULL) {
+        Status = STATUS_UNSUCCESSFUL;
+        goto OX16PCI95XInitializeControllerEnd;
+    }
+
+    Adapter->BaudRate = KdNet->SerialBaudRate;
+    Adapter->PortPresent = TRUE;
+    Adapter->IoPort = KdNet->Device->BaseAddress[0].TranslatedAddress;
+
+    //
+    // The ACR register cannot be read but requires manipulation for
+    // indexed registers.  The driver must keep responsibility for
+    // tracking the value of ACR rather than trying to perform a readback.
+    //
+    Adapter->ACR = 0;
+
+    //
+    // Disable all uart interrupts.
+    //
+
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_IEN, 0);
+
+    //
+    // Enable the FIFO.
+    //
+
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_FCR, FC_ENABLE);
+
+    //
+    // Assert DTR, RTS.
+    //
+
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_MCR, MC_DTRRTS);
+
+    //
+    // In order to utilize the onboard clock prescaler and sample clock to 
+    // derive the baud rate from the 18.432 MHz clock input, the 
+    // hardware must be put into the hardware must be put into "enhanced" 
+    // (650) register mode.  The control bit in MCR which bypasses the 
+    // prescaler (set on hardware reset) is not accessible in pure 550 mode.
+    //
+
+    OX16PCI95XMap650Registers(Adapter);
+
+    //
+    // The 650 registers are now overlayed in our 8 bytes of I/O space.  Turn 
+    // on the clock prescaler by setting the appropriate bits in MCR after
+    // enabling this functionality through enabling enhanced mode in EFR.
+    //
+
+    UCHAR Efr = READ_PORT_UCHAR(Adapter->IoPort + OX16PCI95X_COM_650_EFR);
+    Efr |= (OX16PCI95X_EFR_MODE_ENHANCED << OX16PCI95X_EFR_MODE_SHIFT);
+    WRITE_PORT_UCHAR(Adapter->IoPort + OX16PCI95X_COM_650_EFR, Efr);
 
     //
     // Further, turn on hardware flow control by setting the RTS/CTS bits.
@@ -857,19 +1263,13 @@ Return Value:
     OX16PCI95XUnmap950Registers(Adapter);
 
     //
-    // Set the flow control trigger levels based on the 128 byte FIFO.
+    // Set the flow control trigger levels based on the 128 byte FIFO.  The
+    // FIFO trigger levels are left at their reset values.  These can be
+    // changed later through KD_DEVICE_CONTROL_SERIAL_SET_FLOW_THRESHOLDS.
     //
     OX16PCI95XWriteIndexedRegister(Adapter, OX16PCI95X_IDX_FCL, 32);
     OX16PCI95XWriteIndexedRegister(Adapter, OX16PCI95X_IDX_FCH, 96);
-
-    Adapter->LowFlowTrigger = OX16PCI95XReadIndexedRegister(
-        Adapter, 
-        OX16PCI95X_IDX_FCL
-        ) & OX16PCI95X_AUTOFLOW_LOW_MASK;
-    Adapter->HighFlowTrigger = OX16PCI95XReadIndexedRegister(
-        Adapter, 
-        OX16PCI95X_IDX_FCH
-        ) & OX16PCI95X_AUTOFLOW_HIGH_MASK;
+    OX16PCI95XReadFlowThresholds(Adapter);
 
     UCHAR Mcr = READ_PORT_UCHAR(Adapter->IoPort + COM_MCR);
     Mcr |= (OX16PCI95X_MCR_BAUD_PRESCALE_CPR_MN8 << 
@@ -878,12 +1278,12 @@ Return Value:
 
     //
     // Make sure to initialize the baud rate on our side so that the appropriate clock prescaler values
-    // are set and the standard 16550 I/O can function on the device.
+    // are set and the standard 16550 I/O can function on the device.  A rate
+    // which cannot be generated within tolerance from this board's clock
+    // would only produce garbage on the wire.
     //
 
-    OX16PCI95XSetBaud(Adapter, Adapter->BaudRate);
-
-    Status = STATUS_SUCCESS;
+    Status = OX16PCI95XSetBaud(Adapter, Adapter->BaudRate);
 
 OX16PCI95XInitializeControllerEnd:
 
@@ -971,8 +1371,7 @@ Return Value:
     //  Wait for port to not be busy and CTS to be asserted from the other side.
     //
 
-    if (!OX16PCI95XIsClearToSend(Adapter)) {
-        Adapter->NotClearToSend++;
+    if (!OX16PCI95XCheckClearToSend(Adapter)) {
         return STATUS_IO_TIMEOUT;
     }
 
@@ -985,6 +1384,7 @@ Return Value:
     //
 
     WRITE_PORT_UCHAR(Adapter->IoPort + COM_DAT, Byte);
+    Adapter->Statistics.BytesTransmitted++;
     return STATUS_SUCCESS;
 }
 
@@ -1053,20 +1453,12 @@ Return Value:
         //
         // Check for errors
         //
+        // Even if there is a FIFO error or an indication of an error with
+        // the byte, read it and return it.  The protocol layer will deal
+        // with this.
+        //
 
-        if (lsr & (COM_FE | COM_PE | COM_OE)) {
-            if (lsr & COM_OE) {
-                Adapter->FifoOverflows++;
-            } else {
-                Adapter->ErrorCount++;
-            }
-            
-            //
-            // Even if there is a FIFO error or an indication of an error with
-            // the byte, read it and return it.  The protocol layer will deal
-            // with this.
-            //
-        }
+        OX16PCI95XRecordLineErrors(Adapter, lsr);
 
         //
         // fetch the byte
@@ -1074,6 +1466,7 @@ Return Value:
 
         value = READ_PORT_UCHAR(Adapter->IoPort + COM_DAT);
         *Byte = value & (UCHAR)0xff;
+        Adapter->Statistics.BytesReceived++;
         return STATUS_SUCCESS;
     }
 
@@ -1081,6 +1474,452 @@ Return Value:
     return STATUS_IO_TIMEOUT;
 }
 
+NTSTATUS
+OX16PCI95XWriteSerialBuffer(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __in_bcount(Length) const UCHAR *Buffer,
+    __in ULONG Length,
+    __out PULONG BytesWritten
+    )
+
+/*++
+
+Routine Description:
+
+    Write as much of a buffer to the specified com port as currently fits in
+    the transmit FIFO.  The FIFO level is sampled once through TFL and the
+    free space is then filled without any further status checks.
+
+Arguments:
+
+    Adapter - The OX16PCI95X adapter object.
+
+    Buffer - data to emit
+
+    Length - the number of bytes in Buffer
+
+    BytesWritten - the number of bytes placed in the transmit FIFO is
+                   returned here
+
+Return Value:
+
+    STATUS_SUCCESS - at least one byte was written
+
+    STATUS_IO_TIMEOUT - the transmitter isn't ready
+
+    other - error code
+
+--*/
+
+{
+    ULONG Count;
+    ULONG Index;
+    UCHAR TxFifoLength;
+
+    *BytesWritten = 0;
+    if (!Adapter->PortPresent) {
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    if (Length == 0) {
+        return STATUS_SUCCESS;
+    }
+
+    //
+    // CTS is checked once for the whole burst.  Automatic CTS flow control is
+    // enabled in the EFR, so should the other side deassert CTS part way
+    // through, the transmitter simply holds the remainder in the FIFO.
+    //
+
+    if (!OX16PCI95XCheckClearToSend(Adapter)) {
+        return STATUS_IO_TIMEOUT;
+    }
+
+    //
+    // A port which has gone away reads back as all ones which is beyond any
+    // valid FIFO level.
+    //
+
+    TxFifoLength = OX16PCI95XReadTxFifoLength(Adapter);
+    if (TxFifoLength >= Adapter->FifoDepth) {
+        return STATUS_IO_TIMEOUT;
+    }
+
+    Count = Adapter->FifoDepth - TxFifoLength;
+    if (Count > Length) {
+        Count = Length;
+    }
+
+    for (Index = 0; Index < Count; Index += 1) {
+        WRITE_PORT_UCHAR(Adapter->IoPort + COM_DAT, Buffer[Index]);
+    }
+
+    *BytesWritten = Count;
+    Adapter->Statistics.BytesTransmitted += Count;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+OX16PCI95XReadSerialBuffer(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __out_bcount(Length) PUCHAR Buffer,
+    __in ULONG Length,
+    __out PULONG BytesRead
+    )
+
+/*++
+
+Routine Description:
+
+    Drain the receive FIFO into a buffer.  The FIFO level is sampled once
+    through RFL and that many bytes (bounded by Length) are then read without
+    any further status checks.
+
+Arguments:
+
+    Adapter - The OX16PCI95X adapter object.
+
+    Buffer - address of the buffer to hold the result
+
+    Length - the size of Buffer in bytes
+
+    BytesRead - the number of bytes read from the receive FIFO is returned
+                here
+
+Return Value:
+
+    STATUS_SUCCESS if data returned.
+
+    STATUS_IO_TIMEOUT if no data available, but no error.
+
+--*/
+
+{
+    ULONG Count;
+    ULONG Index;
+    UCHAR lsr;
+
+    *BytesRead = 0;
+    if (!Adapter->PortPresent) {
+        if (OX16PCI95XReadLsr(Adapter, COM_DATRDY) == SERIAL_LSR_NOT_PRESENT) {
+
+            return(STATUS_IO_TIMEOUT);
+        } else {
+            OX16PCI95XSetBaud(Adapter, Adapter->BaudRate);
+            Adapter->PortPresent = TRUE;
+        }
+    }
+
+    if (Length == 0) {
+        return STATUS_SUCCESS;
+    }
+
+    lsr = OX16PCI95XReadLsr(Adapter, COM_DATRDY);
+    if (lsr == SERIAL_LSR_NOT_PRESENT) {
+        return(STATUS_IO_TIMEOUT);
+    }
+
+    if ((lsr & COM_DATRDY) == 0) {
+        OX16PCI95XReadLsr (Adapter, 0);
+        return STATUS_IO_TIMEOUT;
+    }
+
+    //
+    // The error bits in the LSR apply to the byte at the head of the FIFO.
+    // As with the single byte path, errors are counted but the data is still
+    // returned to the protocol layer.
+    //
+
+    OX16PCI95XRecordLineErrors(Adapter, lsr);
+
+    //
+    // LSR reported data ready, so always take at least the head byte even
+    // if the FIFO level reads back as empty.
+    //
+
+    Count = OX16PCI95XReadRxFifoLength(Adapter);
+    if (Count > Adapter->FifoDepth) {
+        Count = Adapter->FifoDepth;
+    }
+
+    if (Count > Adapter->Statistics.RxFifoHighWater) {
+        Adapter->Statistics.RxFifoHighWater = Count;
+    }
+
+    if (Count == 0) {
+        Count = 1;
+    }
+
+    if (Count > Length) {
+        Count = Length;
+    }
+
+    for (Index = 0; Index < Count; Index += 1) {
+        Buffer[Index] = READ_PORT_UCHAR(Adapter->IoPort + COM_DAT);
+    }
+
+    *BytesRead = Count;
+    Adapter->Statistics.BytesReceived += Count;
+    return STATUS_SUCCESS;
+}
+
+BOOLEAN
+OX16PCI95XRunLoopbackPass(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __in ULONG PollInterval,
+    __out PULONG64 Cycles
+    )
+
+/*++
+
+Routine Description:
+
+    Loops OX16PCI95X_TUNE_BYTES of a known pattern through the UART with the
+    currently programmed flow control watermarks.  The receive FIFO is 
+    drained once per poll interval to model KDNET's polling.  The UART must
+    already be in internal loopback.
+
+Arguments:
+
+    Adapter - the OX16PCI95X adapter object
+
+    PollInterval - the stall in microseconds between receive FIFO drains
+
+    Cycles - the number of cycle counter ticks the pass took is returned here
+
+Return Value:
+
+    TRUE if every byte came back intact without an overrun, FALSE otherwise.
+
+--*/
+
+{
+    UCHAR Buffer[OX16PCI95X_MAX_FIFO_DEPTH];
+    ULONG Count;
+    ULONG FifoOverflows;
+    ULONG IdlePolls;
+    ULONG Index;
+    ULONG Received;
+    ULONG Sent;
+    ULONG64 Start;
+
+    FifoOverflows = Adapter->FifoOverflows;
+    IdlePolls = 0;
+    Received = 0;
+    Sent = 0;
+    *Cycles = 0;
+    Start = KdReadCycleCounter(NULL);
+    while (Received < OX16PCI95X_TUNE_BYTES) {
+        if (Sent < OX16PCI95X_TUNE_BYTES) {
+            Count = OX16PCI95X_TUNE_BYTES - Sent;
+            if (Count > sizeof(Buffer)) {
+                Count = sizeof(Buffer);
+            }
+
+            for (Index = 0; Index < Count; Index += 1) {
+                Buffer[Index] = (UCHAR)(Sent + Index);
+            }
+
+            OX16PCI95XWriteSerialBuffer(Adapter, Buffer, Count, &Count);
+            Sent += Count;
+        }
+
+        KeStallExecutionProcessor(PollInterval);
+        OX16PCI95XReadSerialBuffer(Adapter, Buffer, sizeof(Buffer), &Count);
+        if (Count == 0) {
+            IdlePolls += 1;
+            if (IdlePolls > OX16PCI95X_TUNE_MAX_IDLE_POLLS) {
+                return FALSE;
+            }
+
+            continue;
+        }
+
+        IdlePolls = 0;
+        for (Index = 0; Index < Count; Index += 1) {
+            if (Buffer[Index] != (UCHAR)(Received + Index)) {
+                return FALSE;
+            }
+        }
+
+        Received += Count;
+    }
+
+    *Cycles = KdReadCycleCounter(NULL) - Start;
+    return (Adapter->FifoOverflows == FifoOverflows);
+}
+
+NTSTATUS
+OX16PCI95XTuneFlowThresholds(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __in ULONG PollInterval,
+    __out PKD_SERIAL_FLOW_THRESHOLDS Thresholds
+    )
+
+/*++
+
+Routine Description:
+
+    Finds the automatic flow control high watermark giving the best loopback
+    throughput without overruns, programs it and returns the resulting
+    thresholds.  The low watermark is kept at half of the high watermark.
+    If no candidate passes, the original thresholds are restored.  The
+    loopback pattern never crossed the link, so the link statistics and
+    overrun count are restored once tuning ends.
+
+Arguments:
+
+    Adapter - the OX16PCI95X adapter object
+
+    PollInterval - the stall in microseconds between receive FIFO drains,
+                   zero for the default
+
+    Thresholds - the thresholds in effect on return are returned here
+
+Return Value:
+
+    STATUS_SUCCESS / STATUS_UNSUCCESSFUL / STATUS_INVALID_PARAMETER
+
+--*/
+
+{
+    ULONG BestHigh;
+    ULONG64 BestCycles;
+    KD_SERIAL_FLOW_THRESHOLDS Candidate;
+    ULONG64 CtsStallCycles;
+    ULONG64 CtsStallStart;
+    ULONG64 Cycles;
+    ULONG FifoOverflows;
+    ULONG High;
+    UCHAR Mcr;
+    ULONG NotClearToSend;
+    KD_SERIAL_FLOW_THRESHOLDS Original;
+    KD_SERIAL_STATISTICS Statistics;
+    NTSTATUS Status;
+
+    if (!Adapter->PortPresent) {
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    if (PollInterval == 0) {
+        PollInterval = OX16PCI95X_TUNE_DEFAULT_POLL_INTERVAL;
+    }
+
+    RtlZeroMemory(&Original, sizeof(Original));
+    Original.FlowLowWatermark = Adapter->LowFlowTrigger;
+    Original.FlowHighWatermark = Adapter->HighFlowTrigger;
+    Statistics = Adapter->Statistics;
+    CtsStallStart = Adapter->CtsStallStart;
+    CtsStallCycles = Adapter->CtsStallCycles;
+    FifoOverflows = Adapter->FifoOverflows;
+    NotClearToSend = Adapter->NotClearToSend;
+
+    //
+    // Internal loopback connects TX to RX and RTS to CTS, so the automatic 
+    // flow control paths are exercised exactly as they are on the wire.
+    //
+
+    Mcr = READ_PORT_UCHAR(Adapter->IoPort + COM_MCR);
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_MCR, Mcr | SERIAL_MCR_LOOP);
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_FCR, 
+                     FC_ENABLE | FC_CLEAR_RECEIVE | FC_CLEAR_TRANSMIT);
+
+    BestHigh = 0;
+    BestCycles = MAXULONG64;
+    for (High = Adapter->FifoDepth / 8; 
+         High <= Adapter->FifoDepth - (Adapter->FifoDepth / 8);
+         High += Adapter->FifoDepth / 8) {
+
+        RtlZeroMemory(&Candidate, sizeof(Candidate));
+        Candidate.FlowLowWatermark = High / 2;
+        Candidate.FlowHighWatermark = High;
+        if (!NT_SUCCESS(OX16PCI95XSetFlowThresholds(Adapter, &Candidate))) {
+            continue;
+        }
+
+        if (OX16PCI95XRunLoopbackPass(Adapter, PollInterval, &Cycles)) {
+            if (Cycles < BestCycles) {
+                BestCycles = Cycles;
+                BestHigh = High;
+            }
+        }
+
+        WRITE_PORT_UCHAR(Adapter->IoPort + COM_FCR, 
+                         FC_ENABLE | FC_CLEAR_RECEIVE | FC_CLEAR_TRANSMIT);
+    }
+
+    WRITE_PORT_UCHAR(Adapter->IoPort + COM_MCR, Mcr);
+    Adapter->Statistics = Statistics;
+    Adapter->CtsStallStart = CtsStallStart;
+    Adapter->CtsStallCycles = CtsStallCycles;
+    Adapter->FifoOverflows = FifoOverflows;
+    Adapter->NotClearToSend = NotClearToSend;
+
+    if (BestHigh != 0) {
+        RtlZeroMemory(Thresholds, sizeof(KD_SERIAL_FLOW_THRESHOLDS));
+        Thresholds->FlowLowWatermark = BestHigh / 2;
+        Thresholds->FlowHighWatermark = BestHigh;
+        Status = OX16PCI95XSetFlowThresholds(Adapter, Thresholds);
+
+    } else {
+        *Thresholds = Original;
+        OX16PCI95XSetFlowThresholds(Adapter, Thresholds);
+        Status = STATUS_UNSUCCESSFUL;
+    }
+
+    return Status;
+}
+
+VOID
+OX16PCI95XQueryStatistics(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __in BOOLEAN Reset,
+    __out PKD_SERIAL_STATISTICS Statistics
+    )
+
+/*++
+
+Routine Description:
+
+    Returns the link statistics and optionally resets them.  A CTS stall 
+    which is still in progress is accounted up to the time of the query.
+
+Arguments:
+
+    Adapter - the OX16PCI95X adapter object
+
+    Reset - whether to reset the statistics after returning them
+
+    Statistics - the statistics are returned here
+
+--*/
+
+{
+    ULONG64 Frequency;
+    ULONG64 Now;
+    ULONG64 StallCycles;
+
+    Frequency = 0;
+    Now = KdReadCycleCounter(&Frequency);
+    StallCycles = Adapter->CtsStallCycles;
+    if (Adapter->CtsStallStart != 0) {
+        StallCycles += Now - Adapter->CtsStallStart;
+    }
+
+    *Statistics = Adapter->Statistics;
+    if (Frequency != 0) {
+        Statistics->CtsStallMicroseconds = (StallCycles * 1000000) / Frequency;
+    }
+
+    if (Reset) {
+        RtlZeroMemory(&Adapter->Statistics, sizeof(KD_SERIAL_STATISTICS));
+        Adapter->CtsStallCycles = 0;
+        if (Adapter->CtsStallStart != 0) {
+            Adapter->CtsStallStart = Now;
+        }
+    }
+}
+
 NTSTATUS
 OX16PCI95XDeviceControl(
     __in POX16PCI95X_ADAPTER Adapter,
@@ -1118,10 +1957,9 @@ Return Value:
 --*/
 
 {
+    ULONG PollInterval;
     NTSTATUS Status;
 
-    UNREFERENCED_PARAMETER(Adapter);
-
     Status = STATUS_INVALID_DEVICE_REQUEST;
 
     switch(RequestCode) {
@@ -1153,6 +1991,59 @@ Return Value:
             }
             break;
 
+        case KD_DEVICE_CONTROL_SERIAL_SET_FLOW_THRESHOLDS:
+            if (InputBufferSize < sizeof(KD_SERIAL_FLOW_THRESHOLDS)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            Status = OX16PCI95XSetFlowThresholds(
+                Adapter, 
+                (PKD_SERIAL_FLOW_THRESHOLDS)InputBuffer
+                );
+
+            if (NT_SUCCESS(Status) &&
+                (OutputBufferSize >= sizeof(KD_SERIAL_FLOW_THRESHOLDS))) {
+
+                RtlCopyMemory(OutputBuffer, 
+                              InputBuffer, 
+                              sizeof(KD_SERIAL_FLOW_THRESHOLDS));
+            }
+            break;
+
+        case KD_DEVICE_CONTROL_SERIAL_TUNE_FLOW_THRESHOLDS:
+            if (OutputBufferSize < sizeof(KD_SERIAL_FLOW_THRESHOLDS)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            PollInterval = 0;
+            if (InputBufferSize >= sizeof(ULONG)) {
+                PollInterval = *(ULONG *)InputBuffer;
+            }
+
+            Status = OX16PCI95XTuneFlowThresholds(
+                Adapter, 
+                PollInterval, 
+                (PKD_SERIAL_FLOW_THRESHOLDS)OutputBuffer
+                );
+            break;
+
+        case KD_DEVICE_CONTROL_SERIAL_QUERY_STATISTICS:
+            if (OutputBufferSize < sizeof(KD_SERIAL_STATISTICS)) {
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            OX16PCI95XQueryStatistics(
+                Adapter, 
+                (InputBufferSize >= sizeof(BOOLEAN)) && *(BOOLEAN *)InputBuffer, 
+                (PKD_SERIAL_STATISTICS)OutputBuffer
+                );
+
+            Status = STATUS_SUCCESS;
+            break;
+
         default:
             break;
     }
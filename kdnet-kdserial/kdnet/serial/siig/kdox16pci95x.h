@@ -12,11 +12,25 @@ Abstract:
 
     This is specifically targeted to the 18.432 MHz clock input to the 16PCI95X on 
     the SIIG CyberPro series of PCI serial cards.  Note that support for any 16PCI95X device
-    can be easily added (up to standard 16550 baud rates) by changing recognition of
-    the device and clock prescaler parameters.
+    can be easily added by changing recognition of the device and its clock input
+    frequency.
 
 --*/
 
+//
+// Baud rate generator settings as produced by OX16PCI95XSolveBaudDivisor.
+// SampleClock is in TCR encoding (16 is encoded as 0) and Prescaler is in
+// CPR encoding (M << 3 | N).
+//
+
+typedef struct _OX16PCI95X_BAUD_SETTINGS {
+    UCHAR SampleClock;
+    UCHAR Prescaler;
+    USHORT Divisor;
+    ULONG ActualRate;
+    ULONG ErrorPpm;
+} OX16PCI95X_BAUD_SETTINGS, *POX16PCI95X_BAUD_SETTINGS;
+
 typedef struct _OX16PCI95X_ADAPTER {
     PKDNET_SHARED_DATA KdNet;
     PUCHAR IoPort;
@@ -26,12 +40,26 @@ typedef struct _OX16PCI95X_ADAPTER {
     UCHAR ACR;
 
     ULONG BaudRate;
+    ULONG ActualBaudRate;
+    ULONG BaudRateErrorPpm;
     ULONG ErrorCount;
     ULONG NotClearToSend;
     ULONG FifoOverflows;
     ULONG FifoDepth;
     ULONG LowFlowTrigger;
     ULONG HighFlowTrigger;
+    ULONG RxTriggerLevel;
+    ULONG TxTriggerLevel;
+
+    //
+    // Link statistics reported through KD_DEVICE_CONTROL_SERIAL_QUERY_STATISTICS.
+    // CTS stalls are tracked in cycle counter ticks and only converted when
+    // queried.
+    //
+
+    KD_SERIAL_STATISTICS Statistics;
+    ULONG64 CtsStallStart;
+    ULONG64 CtsStallCycles;
 
 } OX16PCI95X_ADAPTER, *POX16PCI95X_ADAPTER;
 
@@ -40,6 +68,13 @@ OX16PCI95XGetContextSize(
     __in PDEBUG_DEVICE_DESCRIPTOR Device
     );
 
+NTSTATUS
+OX16PCI95XSolveBaudDivisor(
+    __in ULONG ClockFrequency,
+    __in ULONG Rate,
+    __out POX16PCI95X_BAUD_SETTINGS Settings
+    );
+
 NTSTATUS
 OX16PCI95XInitializeController(
     __in PKDNET_SHARED_DATA KdNet
@@ -62,6 +97,22 @@ OX16PCI95XReadSerialByte (
     __out PUCHAR Byte
     );
 
+NTSTATUS
+OX16PCI95XWriteSerialBuffer(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __in_bcount(Length) const UCHAR *Buffer,
+    __in ULONG Length,
+    __out PULONG BytesWritten
+    );
+
+NTSTATUS
+OX16PCI95XReadSerialBuffer(
+    __in POX16PCI95X_ADAPTER Adapter,
+    __out_bcount(Length) PUCHAR Buffer,
+    __in ULONG Length,
+    __out PULONG BytesRead
+    );
+
 NTSTATUS
 OX16PCI95XDeviceControl(
     __in POX16PCI95X_ADAPTER Adapter,
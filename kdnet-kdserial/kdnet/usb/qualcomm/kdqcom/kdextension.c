@@ -377,7 +377,8 @@ KdInitializeLibrary (
     KdNetExtensibilityImports = ImportTable;
 
     Exports = KdNetExtensibilityImports->Exports;
-    if ((Exports == NULL) || (Exports->FunctionCount != KDNET_EXT_EXPORTS)) {
+    if ((Exports == NULL) ||
+        !KDNET_EXT_EXPORTS_SUPPORTED(Exports->FunctionCount)) {
         Status = STATUS_INVALID_PARAMETER;
         goto KdInitializeLibraryEnd;
     }
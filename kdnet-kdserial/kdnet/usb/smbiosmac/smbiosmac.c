@@ -13,129 +13,263 @@
 __declspec(align(8))
 UCHAR KdTargetMacAddress[MAC_ADDRESS_SIZE + 2];
 
-NTSTATUS
-GetSmBiosUuid(
-    __in PLOADER_PARAMETER_BLOCK LoaderBlock,
-    __out_bcount(SMBIOS_UUID_SIZE) PUCHAR SmBiosUuid
+//
+// The derived MAC address is cached in KdTargetMacAddress along with a key
+// taken from the SMBIOS entry point: its checksum and the location and size
+// of the structure table it points at.  The key is read without mapping the
+// structure table, so reinitialization and resume from hibernate, which
+// restores the module's data, return the cached address without mapping or
+// walking the table at all.  The table is only walked when the key changes.
+// Firmware that rewrites the UUID in place, without moving the table or
+// touching the entry point, is not noticed; the address derived at boot is
+// kept.
+//
+
+typedef struct _SMBIOS_MAC_CACHE_KEY {
+    ULONG64 StructureTableAddress;
+    ULONG StructureTableMaximumSize;
+    UCHAR EntryPointChecksum;
+    UCHAR Reserved[3];
+} SMBIOS_MAC_CACHE_KEY, *PSMBIOS_MAC_CACHE_KEY;
+
+SMBIOS_MAC_CACHE_KEY KdTargetMacAddressKey;
+
+//
+// Structure type that marks the end of the SMBIOS structure table.
+//
+
+#define SMBIOS_END_OF_TABLE_TYPE 127
+
+PSMBIOS3_EPS_HEADER
+GetSmBiosEpsHeader(
+    __in PLOADER_PARAMETER_BLOCK LoaderBlock
     )
 /*++
 
 Routine Description:
 
-    This routine will get the UUID in SMBios Table.
+    This routine returns the SMBIOS entry point structure the loader found.
 
 Arguments:
 
-    LoaderBlock -
-
-    SmBiosUuid - Returned SMBIOS UUID
+    LoaderBlock - Supplies the loader parameter block.
 
 Return Value:
 
-    NT Status code.
+    The SMBIOS entry point structure, or NULL if there is none.
 
 --*/
 {
-    NTSTATUS Status;
     PLOADER_PARAMETER_EXTENSION LoaderExtension;
-    PSMBIOS3_EPS_HEADER SMBiosEPSHeader;
-    PHYSICAL_ADDRESS SMBiosTablePhysicalAddress;
-    ULONG SMBiosTableLength;
-    PUCHAR SMBiosTable;
-    PSMBIOS_SYSTEM_INFORMATION_STRUCT SMBiosInfo;
-    ULONG SMBiosTablePages;
-    ULONG Offset;
 
-    Status = STATUS_SUCCESS;    
+    LoaderExtension = LoaderBlock->Extension;
+    if ((LoaderExtension == NULL) ||
+        (LoaderExtension->Size < sizeof(LOADER_PARAMETER_EXTENSION))) {
 
-    if (LoaderBlock == NULL) {
-        Status = STATUS_INVALID_PARAMETER;
-        goto GetSmBiosUuidExit;
+        return NULL;
     }
 
-    if (SmBiosUuid == NULL) {
-        Status = STATUS_INVALID_PARAMETER;
-        goto GetSmBiosUuidExit;
-    }
+    return LoaderExtension->SMBiosEPSHeader;
+}
 
-    RtlZeroMemory(SmBiosUuid, SMBIOS_UUID_SIZE);
+BOOLEAN
+MapSmBiosTable(
+    __in PSMBIOS3_EPS_HEADER SMBiosEPSHeader,
+    __in ULONG Required,
+    __inout PUCHAR *SMBiosTable,
+    __inout PULONG SMBiosTablePages,
+    __inout PULONG MappedLength
+    )
+/*++
 
-    LoaderExtension = LoaderBlock->Extension;
-    if ((LoaderExtension == NULL) ||
-        (LoaderExtension->Size < sizeof(LOADER_PARAMETER_EXTENSION))) {
+Routine Description:
+
+    This routine makes sure that the first Required bytes of the SMBIOS
+    structure table are mapped.  The table is mapped in a window that starts
+    at a single page and doubles each time a structure runs past its end, so
+    that only the start of the table, where the system information structure
+    normally is, has to be mapped.
+
+Arguments:
+
+    SMBiosEPSHeader - Supplies the SMBIOS entry point structure.
+
+    Required - Supplies the number of bytes that must be mapped.
 
-        Status = STATUS_INVALID_PARAMETER;
-        goto GetSmBiosUuidExit;
+    SMBiosTable - Supplies the current mapping of the table, or NULL.  Receives
+        the new mapping.
+
+    SMBiosTablePages - Supplies the number of pages currently mapped.
+        Receives the number of pages in the new mapping.
+
+    MappedLength - Supplies the number of bytes currently mapped.  Receives
+        the number of bytes in the new mapping.
+
+Return Value:
+
+    TRUE if the required bytes are mapped, FALSE if they lie outside the table
+    or could not be mapped.  The table is left unmapped on failure.
+
+--*/
+{
+    PHYSICAL_ADDRESS SMBiosTablePhysicalAddress;
+    ULONG SMBiosTableLength;
+    ULONG Length;
+
+    if (Required <= *MappedLength) {
+        return TRUE;
     }
 
-    SMBiosEPSHeader = LoaderExtension->SMBiosEPSHeader;
-    if (SMBiosEPSHeader == NULL) {
-        Status = STATUS_INVALID_PARAMETER;
-        goto GetSmBiosUuidExit;
+    SMBiosTableLength = SMBiosEPSHeader->StructureTableMaximumSize;
+    if (*SMBiosTable != NULL) {
+        KdUnmapVirtualAddress(*SMBiosTable, *SMBiosTablePages, FALSE);
+        *SMBiosTable = NULL;
+        *SMBiosTablePages = 0;
+        *MappedLength = 0;
     }
 
-    //
-    // Map SMBios Table to memory
-    //
+    if (Required > SMBiosTableLength) {
+        return FALSE;
+    }
 
     SMBiosTablePhysicalAddress.QuadPart = SMBiosEPSHeader->StructureTableAddress;
-    SMBiosTableLength = SMBiosEPSHeader->StructureTableMaximumSize;
-    SMBiosTablePages = ADDRESS_AND_SIZE_TO_SPAN_PAGES(
-        SMBiosTablePhysicalAddress.LowPart, SMBiosTableLength
+    Length = PAGE_SIZE - BYTE_OFFSET(SMBiosTablePhysicalAddress.LowPart);
+    while ((Length < Required) && (Length < SMBiosTableLength)) {
+        Length *= 2;
+    }
+
+    if (Length > SMBiosTableLength) {
+        Length = SMBiosTableLength;
+    }
+
+    *SMBiosTablePages = ADDRESS_AND_SIZE_TO_SPAN_PAGES(
+        SMBiosTablePhysicalAddress.LowPart, Length
         );
-    SMBiosTable = KdMapPhysicalMemory64(SMBiosTablePhysicalAddress,
-                                        SMBiosTablePages, 
-                                        FALSE);
 
-    if (SMBiosTable == NULL) {
-        Status = STATUS_INSUFFICIENT_RESOURCES;
-        goto GetSmBiosUuidExit;
+    *SMBiosTable = KdMapPhysicalMemory64(SMBiosTablePhysicalAddress,
+                                         *SMBiosTablePages,
+                                         FALSE);
+
+    if (*SMBiosTable == NULL) {
+        *SMBiosTablePages = 0;
+        return FALSE;
     }
 
+    *MappedLength = Length;
+    return TRUE;
+}
+
+NTSTATUS
+GetSmBiosUuid(
+    __in PSMBIOS3_EPS_HEADER SMBiosEPSHeader,
+    __out_bcount(SMBIOS_UUID_SIZE) PUCHAR SmBiosUuid
+    )
+/*++
+
+Routine Description:
+
+    This routine will get the UUID in SMBios Table.  The table is walked only
+    as far as the System Information structure, and only that much of it is
+    mapped.
+
+Arguments:
+
+    SMBiosEPSHeader - Supplies the SMBIOS entry point structure.
+
+    SmBiosUuid - Returned SMBIOS UUID
+
+Return Value:
+
+    NT Status code.
+
+--*/
+{
+    NTSTATUS Status;
+    PUCHAR SMBiosTable;
+    PSMBIOS_STRUCT_HEADER Header;
+    PSMBIOS_SYSTEM_INFORMATION_STRUCT SMBiosInfo;
+    ULONG SMBiosTablePages;
+    ULONG MappedLength;
+    ULONG Offset;
+
+    Status = STATUS_NOT_FOUND;
+    RtlZeroMemory(SmBiosUuid, SMBIOS_UUID_SIZE);
+    SMBiosTable = NULL;
+    SMBiosTablePages = 0;
+    MappedLength = 0;
+
     //
     // Look for SMBios System Information
     //
-    SMBiosInfo = NULL;
+
     Offset = 0;
-    while (Offset < SMBiosTableLength) {
-        PSMBIOS_STRUCT_HEADER Header;
+    for (;;) {
+        if (!MapSmBiosTable(SMBiosEPSHeader,
+                            Offset + sizeof(SMBIOS_STRUCT_HEADER),
+                            &SMBiosTable,
+                            &SMBiosTablePages,
+                            &MappedLength)) {
+
+            break;
+        }
+
+        Header = (PSMBIOS_STRUCT_HEADER)&SMBiosTable[Offset];
+        if ((Header->Length < sizeof(SMBIOS_STRUCT_HEADER)) ||
+            (Header->Type == SMBIOS_END_OF_TABLE_TYPE)) {
+
+            break;
+        }
+
+        if (!MapSmBiosTable(SMBiosEPSHeader,
+                            Offset + Header->Length,
+                            &SMBiosTable,
+                            &SMBiosTablePages,
+                            &MappedLength)) {
+
+            break;
+        }
 
         Header = (PSMBIOS_STRUCT_HEADER)&SMBiosTable[Offset];
         if (Header->Type == SMBIOS_SYSTEM_INFORMATION) {
             SMBiosInfo = (PSMBIOS_SYSTEM_INFORMATION_STRUCT)Header;
+            if (SMBiosInfo->Length > SMBIOS_SYSTEM_INFORMATION_LENGTH_20) {
+                RtlCopyMemory(SmBiosUuid, SMBiosInfo->Uuid, SMBIOS_UUID_SIZE);
+                Status = STATUS_SUCCESS;
+            }
+
             break;
         }
 
         //
-        // Move to next header, but include two null bytes
+        // Move to next header, skipping the strings that follow the
+        // structure up to and including the two null bytes that end them.
         //
-        Offset += Header->Length + 2;
 
-        // 
-        // Just in case there is more data than header declared
-        //
-        while ((SMBiosTable[Offset - 2] != 0) ||
-            (SMBiosTable[Offset - 1] != 0)) {
+        Offset += Header->Length;
+        for (;;) {
+            if (!MapSmBiosTable(SMBiosEPSHeader,
+                                Offset + 2,
+                                &SMBiosTable,
+                                &SMBiosTablePages,
+                                &MappedLength)) {
+
+                goto GetSmBiosUuidExit;
+            }
+
+            if ((SMBiosTable[Offset] == 0) && (SMBiosTable[Offset + 1] == 0)) {
+                Offset += 2;
+                break;
+            }
+
             Offset++;
-            if (Offset >= SMBiosTableLength) break;
         }
     }
 
-    //
-    // Exit if SMBios System Information wasn't found
-    //
-    if ((SMBiosInfo == NULL) ||
-        (SMBiosInfo->Length <= SMBIOS_SYSTEM_INFORMATION_LENGTH_20)) {
-
-        Status = STATUS_NOT_FOUND;
+GetSmBiosUuidExit:
+    if (SMBiosTable != NULL) {
         KdUnmapVirtualAddress(SMBiosTable, SMBiosTablePages, FALSE);
-        goto GetSmBiosUuidExit;
     }
 
-    RtlCopyMemory(SmBiosUuid, SMBiosInfo->Uuid, SMBIOS_UUID_SIZE);
-    KdUnmapVirtualAddress(SMBiosTable, SMBiosTablePages, FALSE);
-
-GetSmBiosUuidExit:
     return Status;
 }
 
@@ -169,24 +303,45 @@ Return Value:
     UCHAR SmBiosUuid[SMBIOS_UUID_SIZE];
     SYMCRYPT_HMAC_SHA256_EXPANDED_KEY HmacKey;
     BYTE HmacResult[SYMCRYPT_HMAC_SHA256_RESULT_SIZE];
+    PSMBIOS3_EPS_HEADER SMBiosEPSHeader;
+    SMBIOS_MAC_CACHE_KEY Key;
 
     //
-    // Return any previously calculated MAC address.
+    // Without a LoaderBlock the table cannot be found, so return any
+    // previously calculated MAC address.  Bail if there is none, since the
+    // LoaderBlock is required to calculate a reasonable address.
     //
 
-    if (*(PULONG64)KdTargetMacAddress != 0) {
-        goto MacAddressFromSmBiosUuidExit;
+    if (LoaderBlock == NULL) {
+        if (*(PULONG64)KdTargetMacAddress != 0) {
+            goto MacAddressFromSmBiosUuidExit;
+        }
+
+        return;
     }
 
     //
-    // Bail if no LoaderBlock was passed, since that is required to calculate
-    // a reasonable address.
+    // Return the previously calculated MAC address if it was derived from
+    // the table the same entry point describes.
     //
 
-    if (LoaderBlock == NULL) {
-        return;
+    RtlZeroMemory(&Key, sizeof(Key));
+    SMBiosEPSHeader = GetSmBiosEpsHeader(LoaderBlock);
+    if (SMBiosEPSHeader != NULL) {
+        Key.StructureTableAddress = SMBiosEPSHeader->StructureTableAddress;
+        Key.StructureTableMaximumSize = SMBiosEPSHeader->StructureTableMaximumSize;
+        Key.EntryPointChecksum = SMBiosEPSHeader->Checksum;
+    }
+
+    if ((*(PULONG64)KdTargetMacAddress != 0) &&
+        (RtlCompareMemory(&Key, &KdTargetMacAddressKey, sizeof(Key)) ==
+         sizeof(Key))) {
+
+        goto MacAddressFromSmBiosUuidExit;
     }
 
+    KdTargetMacAddressKey = Key;
+
     //
     // In case of failure we will try to use a PRIVATE MAC address
     //
@@ -198,7 +353,11 @@ Return Value:
     KdTargetMacAddress[4] = 0x00;
     KdTargetMacAddress[5] = 0x00;
 
-    Status = GetSmBiosUuid(LoaderBlock, SmBiosUuid);
+    Status = STATUS_NOT_FOUND;
+    if (SMBiosEPSHeader != NULL) {
+        Status = GetSmBiosUuid(SMBiosEPSHeader, SmBiosUuid);
+    }
+
     if (!NT_SUCCESS(Status)) {
         goto MacAddressFromSmBiosUuidExit;
     }
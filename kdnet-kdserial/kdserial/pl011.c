@@ -36,6 +36,8 @@ Abstract:
 
 #define TOTAL_UART_REGISTER_SIZE 0x4C
 
+#define PL011_RX_FIFO_DEPTH 32          // Receive FIFO depth in characters
+
 //
 // Register Masks
 //
@@ -431,6 +433,10 @@ Return Value:
         return UartNotReady;
     }
 
+    if (UartpPollDue(Port, PL011_RX_FIFO_DEPTH) == FALSE) {
+        return UartNoData;
+    }
+
     Force32Bit = ((Port->Flags & PORT_FORCE_32BIT_IO) != 0);
 
     //
@@ -445,6 +451,7 @@ Return Value:
     //
 
     if ((Fsr & UART_FR_RXFE) == 0) {
+        UartpPollComplete(Port, TRUE);
 
         //
         // Fetch the data byte and associated error information.
@@ -467,6 +474,7 @@ Return Value:
         return UartSuccess;
     }
 
+    UartpPollComplete(Port, FALSE);
     return UartNoData;
 }
 
@@ -567,6 +575,10 @@ Return Value:
         return FALSE;
     }
 
+    if (UartpPollDue(Port, PL011_RX_FIFO_DEPTH) == FALSE) {
+        return FALSE;
+    }
+
     //
     // Read the Flag Register to determine if there is any pending
     // data to read.
@@ -583,9 +595,11 @@ Return Value:
     //
 
     if (CHECK_FLAG(Flags, UART_FR_RXFE) == 0) {
+        UartpPollComplete(Port, TRUE);
         return TRUE;
     }
 
+    UartpPollComplete(Port, FALSE);
     return FALSE;
 }
 
@@ -924,6 +924,14 @@ Abstract:
 #define MAX_RX_FIFO_SIZE 128
 #define MAX_RETRIES 0x100000
 
+//
+// The GENI receive FIFO depth depends on the serial engine configuration.
+// Bound the receive poll backoff by the smallest depth in use so that an
+// idle port is never left unpolled long enough to overrun.
+//
+
+#define SDM845_RX_POLL_FIFO_DEPTH 32
+
 // --------------------------------------------------------------------- Macros
 
 #define UART_DM_READ_REG(addr, offset)          \
@@ -1237,6 +1245,10 @@ Return Value:
     //
 
     if (Transfer.AvailableBytes == 0) {
+        if (UartpPollDue(Port, SDM845_RX_POLL_FIFO_DEPTH) == FALSE) {
+            return UartNoData;
+        }
+
         Transfer.PtrToFifoBuffer = (UCHAR *)Transfer.FifoBuffer;
         IrqStatus = UART_DM_READ_REG(BaseAddress + GENI4_DATA, HWIO_GENI_S_IRQ_STATUS_OFFS);
         UART_DM_WRITE_REG(BaseAddress + GENI4_DATA, HWIO_GENI_S_IRQ_CLEAR_OFFS, IrqStatus);
@@ -1268,6 +1280,7 @@ Return Value:
         }
 
         Transfer.AvailableBytes = AvailableBytes;
+        UartpPollComplete(Port, (BOOLEAN)(AvailableBytes != 0));
         for (Index = 0; Index < WordsToRead; Index += 1) {
             RxFifo = UART_DM_READ_REG(BaseAddress + GENI4_DATA, HWIO_GENI_RX_FIFOn_OFFS(BaseAddress, Index));
             Transfer.FifoBuffer[0 + ArrayIndex] = (UCHAR)(RxFifo >>  0);
@@ -1397,6 +1410,10 @@ Return Value:
         goto SDM845ReceiveDataAvailableEnd;
     }
 
+    if (UartpPollDue(Port, SDM845_RX_POLL_FIFO_DEPTH) == FALSE) {
+        return FALSE;
+    }
+
     //
     // Read the FIFO status register
     //
@@ -1423,6 +1440,8 @@ Return Value:
         }
     }
 
+    UartpPollComplete(Port, IsAvailableBytes);
+
 SDM845ReceiveDataAvailableEnd:
     return IsAvailableBytes;
 }
@@ -17,6 +17,35 @@ Abstract:
 #include "common.h"
 #include "kdcom.h"
 
+// ---------------------------------------------------------------- Definitions
+
+//
+// Receive FIFO depth of a 16550A, used to bound the receive poll backoff.
+//
+
+#define UART16550_RX_FIFO_DEPTH 16
+
+// ----------------------------------------------- Internal Function Prototypes
+
+BOOLEAN
+Uart16550SetBaud (
+    _Inout_ PCPPORT Port,
+    ULONG Rate
+    );
+
+UART_STATUS
+Uart16550GetByte (
+    _Inout_ PCPPORT Port,
+    _Out_ PUCHAR Byte
+    );
+
+UART_STATUS
+Uart16550PutByte (
+    _Inout_ PCPPORT Port,
+    UCHAR Byte,
+    BOOLEAN BusyWait
+    );
+
 // ----------------------------------------------- Function Test
 
 
@@ -96,15 +125,6 @@ UINT64 KdSinaTest(UINT16 Byte)
 
 }
 
-
-// ----------------------------------------------- Internal Function Prototypes
-
-BOOLEAN
-Uart16550SetBaud (
-    _Inout_ PCPPORT Port,
-    ULONG Rate
-    );
-
 // ------------------------------------------------------------------ Functions
 
 BOOLEAN
@@ -556,6 +576,10 @@ Return Value:
         return UartNotReady;
     }
 
+    if (UartpPollDue(Port, UART16550_RX_FIFO_DEPTH) == FALSE) {
+        return UartNoData;
+    }
+
     //
     // Check to see if all bits are set in LSR. If this is the case, it means
     // the port I/O address is invalid as 0xFF is nonsense for LSR.
@@ -567,6 +591,7 @@ Return Value:
     }
 
     if (CHECK_FLAG(Lsr, COM_DATRDY)) {
+        UartpPollComplete(Port, TRUE);
 
         //
         // Return unsuccessfully if any errors are indicated by the
@@ -613,6 +638,7 @@ Return Value:
             Port->Flags |= PORT_MODEM_CONTROL;
         }
 
+        UartpPollComplete(Port, FALSE);
         return UartNoData;
     }
 }
@@ -749,6 +775,10 @@ Return Value:
         return FALSE;
     }
 
+    if (UartpPollDue(Port, UART16550_RX_FIFO_DEPTH) == FALSE) {
+        return FALSE;
+    }
+
     //
     // Check to see if all bits are set in LSR. If this is the case, it means
     // the port I/O address is invalid as 0xFF is nonsense for LSR. This
@@ -768,9 +798,11 @@ Return Value:
     //
 
     if (CHECK_FLAG(Lsr, COM_DATRDY)) {
+        UartpPollComplete(Port, TRUE);
         return TRUE;
     }
 
+    UartpPollComplete(Port, FALSE);
     return FALSE;
 }
 
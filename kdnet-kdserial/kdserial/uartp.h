@@ -66,3 +66,15 @@ UartpSetAccess (
     const UCHAR AccessSize,
     const UCHAR BitWidth
     );
+
+BOOLEAN
+UartpPollDue (
+    _In_ PCPPORT Port,
+    const ULONG FifoDepth
+    );
+
+VOID
+UartpPollComplete (
+    _In_ PCPPORT Port,
+    const BOOLEAN DataFound
+    );
@@ -0,0 +1,350 @@
+/*++
+
+Copyright (c) Microsoft Corporation.  All rights reserved.
+
+Module Name:
+
+    uartpoll.c
+
+Abstract:
+
+    This module implements an adaptive polling scheduler for the serial port
+    hardware drivers.
+
+    The debugger polls GetByte / RxReady in a tight loop with no notion of
+    when data can actually arrive.  On SoCs where every status register read
+    is an uncached bus transaction this needlessly loads the system while the
+    debugger is attached.  A FIFO of N bytes can absorb N character times of
+    data before it overruns, so while the line is idle the scheduler answers
+    calls without touching the hardware for a window of at most N/2
+    character times, worked out from the baud rate, and it polls on every
+    call while data is streaming.
+
+    The scheduler runs in the debugger and in early boot, where no timer or
+    performance counter service can be relied on, so windows are measured on
+    the processor's free running counter: the generic timer on ARM and
+    ARM64, whose frequency the architecture reports, and the time stamp
+    counter on x86 and x64, whose frequency is taken to be no lower than
+    UART_POLL_MIN_TSC_FREQUENCY.  Polls are never skipped where there is no
+    such counter.
+
+    A window delays the next poll by at most N/2 character times plus one
+    pass through the caller's loop, so the scheduler is safe as long as the
+    caller gets back to it within the remaining N/2 character times.  The
+    cost of the caller's loop no longer scales the window, as it did when
+    windows were counted in calls.
+
+--*/
+
+// ------------------------------------------------------------------- Includes
+
+#include <ntddk.h>
+#include "common.h"
+
+// ---------------------------------------------------------------- Definitions
+
+//
+// Skipped polls spin for a few pause instructions, roughly the cost of the
+// register read they avoid, so that callers which time out by counting
+// iterations keep approximately the same timeout.
+//
+
+#define UART_POLL_SKIP_PAUSES 8
+
+//
+// A character on the wire is a start bit, eight data bits and a stop bit.
+//
+
+#define UART_POLL_BITS_PER_CHARACTER 10
+
+//
+// The time stamp counter on x86 and x64 runs at a constant rate that is not
+// reported architecturally.  Windows are converted to ticks assuming this
+// rate, so a faster counter only makes them shorter than computed.
+//
+
+#define UART_POLL_MIN_TSC_FREQUENCY 500000000ULL
+
+//
+// Generic timer registers on ARM64: the counter frequency and the virtual
+// count.
+//
+
+#define UART_POLL_ARM64_CNTFRQ ARM64_SYSREG(3, 3, 14, 0, 0)
+#define UART_POLL_ARM64_CNTVCT ARM64_SYSREG(3, 3, 14, 0, 2)
+
+// ----------------------------------------------------------------- Data Types
+
+//
+// There is only ever one debug port, so the scheduler state is global.
+// Backoff and MaximumBackoff are in character times, and BackoffTicks is the
+// current window in counter ticks, or 0 when the next call polls.  The
+// statistics are kept for inspection from a debugger; HardwarePolls divided
+// by DataPolls gives the number of register polls spent per poll which found
+// data.
+//
+
+typedef struct _UART_POLL_SCHEDULER {
+    PCPPORT Port;
+    ULONG BaudRate;
+    ULONG FifoDepth;
+    ULONG64 CharacterTicks;
+    ULONG MaximumBackoff;
+    ULONG Backoff;
+    ULONG64 BackoffStart;
+    ULONG64 BackoffTicks;
+    ULONG64 HardwarePolls;
+    ULONG64 SkippedPolls;
+    ULONG64 DataPolls;
+} UART_POLL_SCHEDULER, *PUART_POLL_SCHEDULER;
+
+// -------------------------------------------------------------------- Globals
+
+UART_POLL_SCHEDULER UartPollScheduler;
+
+// ------------------------------------------------------------------ Functions
+
+static
+ULONG64
+UartpPollClock (
+    _Out_opt_ PULONG64 Frequency
+    )
+
+/*++
+
+Routine Description:
+
+    This routine reads the counter that backoff windows are measured on.
+
+Arguments:
+
+    Frequency - Supplies an optional pointer to a variable that receives the
+        counter frequency in ticks per second, or 0 if there is no counter.
+
+Return Value:
+
+    The current counter value.
+
+--*/
+
+{
+
+#if defined(_X86_) || defined(_AMD64_)
+
+    if (Frequency != NULL) {
+        *Frequency = UART_POLL_MIN_TSC_FREQUENCY;
+    }
+
+    return ReadTimeStampCounter();
+
+#elif defined(_ARM64_)
+
+    if (Frequency != NULL) {
+        *Frequency = (ULONG)_ReadStatusReg(UART_POLL_ARM64_CNTFRQ);
+    }
+
+    return (ULONG64)_ReadStatusReg(UART_POLL_ARM64_CNTVCT);
+
+#elif defined(_ARM_)
+
+    //
+    // CNTFRQ and CNTVCT.
+    //
+
+    if (Frequency != NULL) {
+        *Frequency = _MoveFromCoprocessor(15, 0, 14, 0, 0);
+    }
+
+    return _MoveFromCoprocessor64(15, 1, 14);
+
+#else
+
+    if (Frequency != NULL) {
+        *Frequency = 0;
+    }
+
+    return 0;
+
+#endif
+
+}
+
+static
+VOID
+UartpPollReset (
+    _In_ PCPPORT Port,
+    const ULONG FifoDepth
+    )
+
+/*++
+
+Routine Description:
+
+    This routine (re)computes the scheduling parameters for a port.  Polls are
+    only skipped when the baud rate is known, the hardware has a FIFO to
+    absorb characters arriving between polls and there is a counter to time
+    the window on.  Ports which inherit the firmware's baud rate are always
+    polled since the rate they run at, and so the character time, is not
+    known.
+
+Arguments:
+
+    Port - Supplies the address of the port object that describes the UART.
+
+    FifoDepth - Supplies the depth of the UART's receive FIFO in bytes.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+
+    ULONG64 Frequency;
+    PUART_POLL_SCHEDULER Scheduler;
+
+    Scheduler = &UartPollScheduler;
+    Scheduler->Port = Port;
+    Scheduler->BaudRate = Port->BaudRate;
+    Scheduler->FifoDepth = FifoDepth;
+    Scheduler->CharacterTicks = 0;
+    Scheduler->MaximumBackoff = 0;
+    Scheduler->Backoff = 0;
+    Scheduler->BackoffStart = 0;
+    Scheduler->BackoffTicks = 0;
+    if ((Port->BaudRate != 0) &&
+        (FifoDepth > 1) &&
+        !CHECK_FLAG(Port->Flags, PORT_DEFAULT_RATE)) {
+
+        UartpPollClock(&Frequency);
+        Scheduler->CharacterTicks =
+            (Frequency * UART_POLL_BITS_PER_CHARACTER) / Port->BaudRate;
+
+        if (Scheduler->CharacterTicks != 0) {
+            Scheduler->MaximumBackoff = FifoDepth / 2;
+        }
+    }
+
+    return;
+}
+
+BOOLEAN
+UartpPollDue (
+    _In_ PCPPORT Port,
+    const ULONG FifoDepth
+    )
+
+/*++
+
+Routine Description:
+
+    This routine determines whether a receive poll should touch the hardware.
+    Until the current backoff window has elapsed, it spins briefly instead.
+
+Arguments:
+
+    Port - Supplies the address of the port object that describes the UART.
+
+    FifoDepth - Supplies the depth of the UART's receive FIFO in bytes.
+
+Return Value:
+
+    TRUE if the caller should poll the hardware, FALSE if it should report
+    that no data is available without doing so.
+
+--*/
+
+{
+
+    ULONG Pause;
+    PUART_POLL_SCHEDULER Scheduler;
+
+    Scheduler = &UartPollScheduler;
+    if ((Scheduler->Port != Port) ||
+        (Scheduler->BaudRate != Port->BaudRate) ||
+        (Scheduler->FifoDepth != FifoDepth)) {
+
+        UartpPollReset(Port, FifoDepth);
+    }
+
+    if ((Scheduler->BackoffTicks == 0) ||
+        ((UartpPollClock(NULL) - Scheduler->BackoffStart) >=
+         Scheduler->BackoffTicks)) {
+
+        Scheduler->BackoffTicks = 0;
+        Scheduler->HardwarePolls += 1;
+        return TRUE;
+    }
+
+    Scheduler->SkippedPolls += 1;
+    for (Pause = 0; Pause < UART_POLL_SKIP_PAUSES; Pause += 1) {
+        YieldProcessor();
+    }
+
+    return FALSE;
+}
+
+VOID
+UartpPollComplete (
+    _In_ PCPPORT Port,
+    const BOOLEAN DataFound
+    )
+
+/*++
+
+Routine Description:
+
+    This routine schedules the next receive poll based on the outcome of the
+    one just made.  Once data is found the FIFO is polled on every call until
+    it runs dry.  Each consecutive empty poll doubles the window before the
+    next one, starting at one character time and capped at half the FIFO
+    depth in character times, so that a burst which starts just after a poll
+    leaves half the FIFO to cover the caller's own loop.
+
+Arguments:
+
+    Port - Supplies the address of the port object that describes the UART.
+
+    DataFound - Supplies a boolean indicating whether the poll found data.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+
+    PUART_POLL_SCHEDULER Scheduler;
+
+    Scheduler = &UartPollScheduler;
+    if (Scheduler->Port != Port) {
+        return;
+    }
+
+    if (DataFound != FALSE) {
+        Scheduler->DataPolls += 1;
+        Scheduler->Backoff = 0;
+        Scheduler->BackoffTicks = 0;
+        return;
+    }
+
+    if (Scheduler->MaximumBackoff == 0) {
+        return;
+    }
+
+    if (Scheduler->Backoff == 0) {
+        Scheduler->Backoff = 1;
+
+    } else if (Scheduler->Backoff < Scheduler->MaximumBackoff) {
+        Scheduler->Backoff *= 2;
+        if (Scheduler->Backoff > Scheduler->MaximumBackoff) {
+            Scheduler->Backoff = Scheduler->MaximumBackoff;
+        }
+    }
+
+    Scheduler->BackoffStart = UartpPollClock(NULL);
+    Scheduler->BackoffTicks = Scheduler->Backoff * Scheduler->CharacterTicks;
+    return;
+}
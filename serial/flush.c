@@ -67,11 +67,20 @@ Return Value:
 
     PAGED_CODE();
 
-    WdfIoQueueStopSynchronously(extension->WriteQueue);
     //
-    // Flush is done - restart the queue
+    // Nothing to wait for if no write is queued or in progress, which
+    // is the usual case for a terminal that flushes after each command.
     //
-    WdfIoQueueStart(extension->WriteQueue);
+
+    if (!IsQueueEmpty(extension->WriteQueue)) {
+
+        WdfIoQueueStopSynchronously(extension->WriteQueue);
+        //
+        // Flush is done - restart the queue
+        //
+        WdfIoQueueStart(extension->WriteQueue);
+
+    }
 
     Irp->IoStatus.Information = 0L;
     Irp->IoStatus.Status = STATUS_SUCCESS;
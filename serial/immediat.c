@@ -122,7 +122,7 @@ Return Value:
         BOOLEAN result;
 
         result = SerialSetTimer(
-            Extension->ImmediateTotalTimer,
+            &Extension->ImmediateTotalTimer,
             TotalTime
             );
 
@@ -172,7 +172,7 @@ SerialCompleteImmediate(
         &Extension->CurrentImmediateRequest,
         NULL,
         NULL,
-        Extension->ImmediateTotalTimer,
+        &Extension->ImmediateTotalTimer,
         NULL,
         SerialGetNextImmediate,
         SERIAL_REF_ISR
@@ -184,13 +184,13 @@ SerialCompleteImmediate(
 
 VOID
 SerialTimeoutImmediate(
-    IN WDFTIMER Timer
+    IN PSERIAL_TIMER Timer
     )
 {
 
     PSERIAL_DEVICE_EXTENSION Extension = NULL;
 
-    Extension = SerialGetDeviceExtension(WdfTimerGetParentObject(Timer));
+    Extension = Timer->Extension;
 
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_IOCTLS, ">SerialTimeoutImmediate(%p)\n",
                      Extension);
@@ -202,7 +202,7 @@ SerialTimeoutImmediate(
         &Extension->CurrentImmediateRequest,
         NULL,
         NULL,
-        Extension->ImmediateTotalTimer,
+        &Extension->ImmediateTotalTimer,
         NULL,
         SerialGetNextImmediate,
         SERIAL_REF_TOTAL_TIMER
@@ -308,7 +308,7 @@ Return Value:
         &Extension->CurrentImmediateRequest,
         NULL,
         NULL,
-        Extension->ImmediateTotalTimer,
+        &Extension->ImmediateTotalTimer,
         NULL,
         SerialGetNextImmediate,
         SERIAL_REF_CANCEL
@@ -78,6 +78,13 @@ Routine Description:
     case IOCTL_SERIAL_CONFIG_SIZE: return "IOCTL_SERIAL_CONFIG_SIZE";
     case IOCTL_SERIAL_GET_STATS: return "IOCTL_SERIAL_GET_STATS";
     case IOCTL_SERIAL_CLEAR_STATS: return "IOCTL_SERIAL_CLEAR_STATS";
+    case IOCTL_SERIAL_SET_ADAPTIVE_BUFFER: return "IOCTL_SERIAL_SET_ADAPTIVE_BUFFER";
+    case IOCTL_SERIAL_MAP_RECEIVE_RING: return "IOCTL_SERIAL_MAP_RECEIVE_RING";
+    case IOCTL_SERIAL_UNMAP_RECEIVE_RING: return "IOCTL_SERIAL_UNMAP_RECEIVE_RING";
+    case IOCTL_SERIAL_WRITE_SEGMENTS: return "IOCTL_SERIAL_WRITE_SEGMENTS";
+    case IOCTL_SERIAL_SET_RX_TIMESTAMPS: return "IOCTL_SERIAL_SET_RX_TIMESTAMPS";
+    case IOCTL_SERIAL_READ_TIMESTAMPED: return "IOCTL_SERIAL_READ_TIMESTAMPED";
+    case IOCTL_SERIAL_GET_DRIVER_STATS: return "IOCTL_SERIAL_GET_DRIVER_STATS";
     default: return "UnKnown ioctl";
     }
 }
@@ -156,11 +163,15 @@ Return Value:
     RtlZeroMemory(&((PSERIAL_DEVICE_EXTENSION)Context)->WmiPerfData,
                  sizeof(SERIAL_WMI_PERF_DATA));
 
+    ((PSERIAL_DEVICE_EXTENSION)Context)->PurgeCount = 0;
+    ((PSERIAL_DEVICE_EXTENSION)Context)->PurgeTicks = 0;
+    ((PSERIAL_DEVICE_EXTENSION)Context)->LastPurgeTicks = 0;
+    InterlockedExchange(&((PSERIAL_DEVICE_EXTENSION)Context)->CompletionContentionCount, 0);
+
     return FALSE;
 }
 
 
-
 BOOLEAN
 SerialSetChars(
     IN WDFINTERRUPT  Interrupt,
@@ -192,6 +203,8 @@ Return Value:
     ((PSERIAL_IOCTL_SYNC)Context)->Extension->SpecialChars =
         *((PSERIAL_CHARS)(((PSERIAL_IOCTL_SYNC)Context)->Data));
 
+    SerialUpdateSpecialCharMap(((PSERIAL_IOCTL_SYNC)Context)->Extension);
+
     return FALSE;
 }
 
@@ -478,7 +491,9 @@ Return Value:
         ASSERT(Stat->AmountInOutQueue >= Extension->WriteLength);
 
      reqContext = SerialGetRequestContext(Extension->CurrentWriteRequest);
-        Stat->AmountInOutQueue -= reqContext->Length - (Extension->WriteLength);
+        Stat->AmountInOutQueue -= reqContext->Length -
+                                  (Extension->WriteLength +
+                                   Extension->WriteSegmentBytesLeft);
 
     }
 
@@ -571,6 +586,8 @@ Return Value:
 
     extension->EscapeChar = *(PUCHAR)reqContext->SystemBuffer;
 
+    SerialUpdateSpecialCharMap(extension);
+
     return FALSE;
 }
 
@@ -617,7 +634,6 @@ Return Value:
     PREQUEST_CONTEXT reqContext;
     size_t  bufSize;
 
-    UNREFERENCED_PARAMETER(OutputBufferLength);
     UNREFERENCED_PARAMETER(InputBufferLength);
 
     reqContext = SerialGetRequestContext(Request);
@@ -1872,6 +1888,185 @@ Return Value:
                 );
             break;
         }
+        case IOCTL_SERIAL_SET_ADAPTIVE_BUFFER: {
+
+            ULONG maximum;
+
+            Status = WdfRequestRetrieveInputBuffer ( Request, sizeof(ULONG), &buffer, &bufSize );
+            if( !NT_SUCCESS(Status) ) {
+                SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_IOCTLS, "Could not get request memory buffer %X\n", Status);
+                break;
+            }
+
+            maximum = *(PULONG)buffer;
+
+            if (maximum > SERIAL_ADAPTIVE_MAX_BUFFER) {
+
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+
+            }
+
+            if (maximum && !Extension->AdaptiveBufferMaximum) {
+
+                Extension->AdaptiveBufferBase = Extension->BufferSize;
+                Extension->AdaptiveLastReceived =
+                    Extension->PerfStats.ReceivedCount;
+                Extension->AdaptiveRxRate = 0;
+                Extension->AdaptiveIdleSamples = 0;
+
+                WdfTimerStart(
+                    Extension->AdaptiveSampleTimer,
+                    WDF_REL_TIMEOUT_IN_MS(SERIAL_ADAPTIVE_SAMPLE_MS)
+                    );
+
+            } else if (!maximum && Extension->AdaptiveBufferMaximum) {
+
+                WdfTimerStop(Extension->AdaptiveSampleTimer, FALSE);
+
+            }
+
+            Extension->AdaptiveBufferMaximum = maximum;
+
+            break;
+        }
+        case IOCTL_SERIAL_MAP_RECEIVE_RING: {
+
+            //
+            // The doorbell event was referenced on the way in, see
+            // SerialEvtIoInCallerContext.  On success the request
+            // belongs to the ring until it is unmapped.
+            //
+
+            Status = SerialMapReceiveRing(Extension, Request);
+
+            if (Status == STATUS_PENDING) {
+                return;
+            }
+
+            break;
+        }
+        case IOCTL_SERIAL_UNMAP_RECEIVE_RING: {
+
+            SerialUnmapReceiveRing(Extension);
+
+            break;
+        }
+        case IOCTL_SERIAL_WRITE_SEGMENTS: {
+
+            ULONG totalLength;
+
+            Status = WdfRequestRetrieveInputBuffer ( Request, FIELD_OFFSET(SERIAL_WRITE_SEGMENTS, Segments), &buffer, &bufSize );
+            if( !NT_SUCCESS(Status) ) {
+                SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_IOCTLS, "Could not get request memory buffer %X\n", Status);
+                break;
+            }
+
+            if (OutputBufferLength < sizeof(ULONG)) {
+
+                Status = STATUS_BUFFER_TOO_SMALL;
+                break;
+
+            }
+
+            Status = SerialValidateWriteSegments(buffer, bufSize, &totalLength);
+
+            if (!NT_SUCCESS(Status)) {
+                break;
+            }
+
+            //
+            // From here on this is a write as far as the write code
+            // is concerned, apart from where the characters come from
+            // and how the count written gets back.
+            //
+
+            reqContext->SystemBuffer = buffer;
+            reqContext->Length = totalLength;
+            reqContext->MajorFunction = IRP_MJ_WRITE;
+            reqContext->IoctlCode = IoControlCode;
+
+            SerialStartOrQueue(
+                       Extension,
+                       Request,
+                       Extension->WriteQueue,
+                       &Extension->CurrentWriteRequest,
+                       SerialStartWrite
+                       );
+            return;
+        }
+        case IOCTL_SERIAL_SET_RX_TIMESTAMPS: {
+
+            SERIAL_IOCTL_SYNC S;
+
+            Status = WdfRequestRetrieveInputBuffer ( Request, sizeof(ULONG), &buffer, &bufSize );
+            if( !NT_SUCCESS(Status) ) {
+                SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_IOCTLS, "Could not get request memory buffer %X\n", Status);
+                break;
+            }
+
+            S.Extension = Extension;
+            S.Data = buffer;
+
+            WdfInterruptSynchronize(
+                Extension->WdfInterrupt,
+                SerialSetRxTimestamps,
+                &S
+                );
+
+            break;
+        }
+        case IOCTL_SERIAL_READ_TIMESTAMPED: {
+
+            ULONG information;
+
+            Status = WdfRequestRetrieveOutputBuffer ( Request, FIELD_OFFSET(SERIAL_TIMESTAMPED_READ, Runs), &buffer, &bufSize );
+            if( !NT_SUCCESS(Status) ) {
+                SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_IOCTLS, "Could not get request memory buffer %X\n", Status);
+                break;
+            }
+
+            Status = SerialReadTimestamped(
+                         Extension,
+                         buffer,
+                         (ULONG)bufSize,
+                         &information
+                         );
+
+            if (NT_SUCCESS(Status)) {
+
+                reqContext->Information = information;
+
+            }
+
+            break;
+        }
+        case IOCTL_SERIAL_GET_DRIVER_STATS: {
+
+            PSERIAL_DRIVER_STATS driverStats;
+            LARGE_INTEGER frequency;
+
+            Status = WdfRequestRetrieveOutputBuffer ( Request, sizeof(SERIAL_DRIVER_STATS), &buffer, &bufSize );
+            if( !NT_SUCCESS(Status) ) {
+                SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_IOCTLS, "Could not get request memory buffer %X\n", Status);
+                break;
+            }
+
+            driverStats = buffer;
+            RtlZeroMemory(driverStats, sizeof(SERIAL_DRIVER_STATS));
+
+            driverStats->CompletionContentionCount =
+                (ULONG)InterlockedCompareExchange(&Extension->CompletionContentionCount, 0, 0);
+            driverStats->PurgeCount = Extension->PurgeCount;
+            driverStats->PurgeTicks = Extension->PurgeTicks;
+            driverStats->LastPurgeTicks = Extension->LastPurgeTicks;
+
+            KeQueryPerformanceCounter(&frequency);
+            driverStats->Frequency = frequency.QuadPart;
+
+            reqContext->Information = sizeof(SERIAL_DRIVER_STATS);
+            break;
+        }
         default: {
 
             Status = STATUS_INVALID_PARAMETER;
@@ -238,6 +238,7 @@ Return Value:
     } else {
 
         ServicedAnInterrupt = TRUE;
+        Extension->DeferWaitEvents = TRUE;
         do {
 
             //
@@ -279,6 +280,26 @@ Return Value:
                     //
                     UCHAR ReceivedChar;
 
+                    //
+                    // Nonzero if the character might be null, xon,
+                    // xoff, the event character or the escape
+                    // character.  The checks for those are skipped
+                    // for everything else.
+                    //
+                    UCHAR Special;
+
+                    //
+                    // Everything this drain puts in the interrupt
+                    // buffer is stamped with the time it started.
+                    //
+                    if (Extension->RxTimestamps) {
+
+                        Extension->RxBatchTime =
+                            KeQueryPerformanceCounter(NULL).QuadPart;
+                        Extension->RxBatchOpen = FALSE;
+
+                    }
+
                     do {
 
                         ReceivedChar =
@@ -288,7 +309,9 @@ Return Value:
 
                         ReceivedChar &= Extension->ValidDataMask;
 
-                        if (!ReceivedChar &&
+                        Special = Extension->SpecialCharMap[ReceivedChar];
+
+                        if (Special && !ReceivedChar &&
                             (Extension->HandFlow.FlowReplace &
                              SERIAL_NULL_STRIPPING)) {
 
@@ -302,7 +325,8 @@ Return Value:
 
                         }
 
-                        if ((Extension->HandFlow.FlowReplace &
+                        if (Special &&
+                            (Extension->HandFlow.FlowReplace &
                              SERIAL_AUTO_TRANSMIT) &&
                             ((ReceivedChar ==
                               Extension->SpecialChars.XonChar) ||
@@ -370,7 +394,8 @@ Return Value:
 
                             }
 
-                            if ((Extension->IsrWaitMask &
+                            if (Special &&
+                                (Extension->IsrWaitMask &
                                  SERIAL_EV_RXFLAG) &&
                                 (Extension->SpecialChars.EventChar ==
                                  ReceivedChar)) {
@@ -379,21 +404,6 @@ Return Value:
 
                             }
 
-                            if (Extension->IrpMaskLocation &&
-                                Extension->HistoryMask) {
-
-                                *Extension->IrpMaskLocation =
-                                 Extension->HistoryMask;
-                                Extension->IrpMaskLocation = NULL;
-                                Extension->HistoryMask = 0;
-                                reqContext = SerialGetRequestContext(Extension->CurrentWaitRequest);
-                                reqContext->Information = sizeof(ULONG);
-                                SerialInsertQueueDpc(
-                                    Extension->CommWaitDpc
-                                    );
-
-                            }
-
                         }
 
                         SerialPutChar(
@@ -410,7 +420,8 @@ Return Value:
                         // escape.
                         //
 
-                        if (Extension->EscapeChar &&
+                        if (Special &&
+                            Extension->EscapeChar &&
                             (Extension->EscapeChar ==
                              ReceivedChar)) {
 
@@ -704,7 +715,8 @@ doTrasmitStuff:;
                                 Extension->CompleteImmediateDpc
                                 );
 
-                        } else if (!Extension->TXHolding) {
+                        } else if (!Extension->TXHolding &&
+                                   !Extension->WriteGap) {
 
                             ULONG amountToWrite;
 
@@ -784,6 +796,18 @@ doTrasmitStuff:;
                             Extension->WriteCurrentChar += amountToWrite;
                             Extension->WriteLength -= amountToWrite;
 
+                            if (!Extension->WriteLength &&
+                                Extension->WriteSegmentsLeft) {
+
+                                //
+                                // On to the next segment of a
+                                // segmented write.
+                                //
+
+                                SerialNextWriteSegment(Extension);
+
+                            }
+
                             if (!Extension->WriteLength) {
 
                                 //
@@ -839,7 +863,7 @@ doTrasmitStuff:;
         if (SerialProcessLSR(Extension) & SERIAL_LSR_THRE) {
 
             if (!Extension->TXHolding &&
-                (Extension->WriteLength ||
+                ((Extension->WriteLength && !Extension->WriteGap) ||
                  Extension->TransmitImmediate)) {
 
                 goto doTrasmitStuff;
@@ -848,6 +872,14 @@ doTrasmitStuff:;
 
         }
 
+        //
+        // Hand whatever events this pass noted to the wait, if
+        // there is one.
+        //
+
+        Extension->DeferWaitEvents = FALSE;
+        SerialSignalWaitEvents(Extension);
+
     }
 
     return ServicedAnInterrupt;
@@ -929,6 +961,20 @@ Return Value:
 
     }
 
+    //
+    // A mapped receive ring takes every character.
+    //
+
+    if (Extension->ReceiveRing != NULL) {
+
+        SerialPutRingChar(
+            Extension,
+            CharToPut
+            );
+        return;
+
+    }
+
     //
     // Check to see if we are copying into the
     // users buffer or into the interrupt buffer.
@@ -1018,6 +1064,26 @@ Return Value:
         // will not prevent us from reading whatever
         // characters are available.
         //
+        // In adaptive buffer mode we ask for a bigger buffer
+        // once we are half way to that threshold so that the
+        // flow control doesn't have to kick in at all.
+        //
+
+        if (Extension->AdaptiveBufferMaximum &&
+            !Extension->AdaptiveGrowPending &&
+            (Extension->BufferSize <
+             Extension->AdaptiveBufferMaximum) &&
+            (((Extension->BufferSize -
+               Extension->HandFlow.XoffLimit) >> 1)
+             <= (Extension->CharsInInterruptBuffer+1))) {
+
+            Extension->AdaptiveGrowPending = TRUE;
+
+            SerialInsertQueueDpc(
+                Extension->AdaptiveGrowDpc
+                );
+
+        }
 
         if ((Extension->HandFlow.ControlHandShake
              & SERIAL_DTR_MASK) ==
@@ -1113,6 +1179,30 @@ Return Value:
             *Extension->CurrentCharSlot = CharToPut;
             Extension->CharsInInterruptBuffer++;
 
+            if (Extension->RxTimestamps) {
+
+                //
+                // The first character of a drain starts a new batch,
+                // which takes the place of the oldest one we remember.
+                //
+
+                if (!Extension->RxBatchOpen) {
+
+                    Extension->RxBatches[Extension->RxBatchCount %
+                        SERIAL_RX_TIMESTAMP_RUNS].Timestamp =
+                        Extension->RxBatchTime;
+                    Extension->RxBatches[Extension->RxBatchCount %
+                        SERIAL_RX_TIMESTAMP_RUNS].Sequence =
+                        Extension->RxSequence;
+                    Extension->RxBatchCount++;
+                    Extension->RxBatchOpen = TRUE;
+
+                }
+
+                Extension->RxSequence++;
+
+            }
+
             //
             // If we've become 80% full on this character
             // and this is an interesting event, note it.
@@ -1126,20 +1216,7 @@ Return Value:
 
                     Extension->HistoryMask |= SERIAL_EV_RX80FULL;
 
-                    if (Extension->IrpMaskLocation) {
-
-                        *Extension->IrpMaskLocation =
-                         Extension->HistoryMask;
-                        Extension->IrpMaskLocation = NULL;
-                        Extension->HistoryMask = 0;
-
-                        reqContext = SerialGetRequestContext(Extension->CurrentWaitRequest);
-                        reqContext->Information =  sizeof(ULONG);
-                        SerialInsertQueueDpc(
-                            Extension->CommWaitDpc
-                            );
-
-                    }
+                    SerialSignalWaitEvents(Extension);
 
                 }
 
@@ -1245,8 +1322,6 @@ Return Value:
 --*/
 
 {
-    PREQUEST_CONTEXT reqContext = NULL;
-
     UCHAR LineStatus = READ_LINE_STATUS(Extension, Extension->Controller);
 
 
@@ -1460,20 +1535,7 @@ Return Value:
 
             }
 
-            if (Extension->IrpMaskLocation &&
-                Extension->HistoryMask) {
-
-                *Extension->IrpMaskLocation =
-                 Extension->HistoryMask;
-                Extension->IrpMaskLocation = NULL;
-                Extension->HistoryMask = 0;
-                reqContext = SerialGetRequestContext(Extension->CurrentWaitRequest);
-                reqContext->Information =  sizeof(ULONG);
-                SerialInsertQueueDpc(
-                    Extension->CommWaitDpc
-                    );
-
-            }
+            SerialSignalWaitEvents(Extension);
 
         }
 
@@ -1159,7 +1159,6 @@ Return Value:
     // Holds the value in the mode status register.
     //
     UCHAR ModemStatus;
-    PREQUEST_CONTEXT reqContext;
 
     ModemStatus =
     READ_MODEM_STATUS(Extension, Extension->Controller);
@@ -1271,21 +1270,7 @@ Return Value:
 
         }
 
-        if (Extension->IrpMaskLocation &&
-            Extension->HistoryMask) {
-
-            *Extension->IrpMaskLocation =
-             Extension->HistoryMask;
-            Extension->IrpMaskLocation = NULL;
-            Extension->HistoryMask = 0;
-
-            reqContext = SerialGetRequestContext(Extension->CurrentWaitRequest);
-            reqContext->Information = sizeof(ULONG);
-            SerialInsertQueueDpc(
-                Extension->CommWaitDpc
-                );
-
-        }
+        SerialSignalWaitEvents(Extension);
 
     }
 
@@ -1606,7 +1591,7 @@ Return Value:
     CharTime.QuadPart = -CharTime.QuadPart;
 
     if (SerialSetTimer(
-            Extension->LowerRTSTimer,
+            &Extension->LowerRTSTimer,
             CharTime
             )) {
 
@@ -1632,7 +1617,7 @@ Return Value:
 
 VOID
 SerialInvokePerhapsLowerRTS(
-    IN WDFTIMER Timer
+    IN PSERIAL_TIMER Timer
     )
 
 /*++
@@ -1645,7 +1630,7 @@ Routine Description:
 
 Arguments:
 
-     WDFTIMER
+     Timer - The expired timer on the device's timer wheel.
 
 Return Value:
 
@@ -1657,7 +1642,7 @@ Return Value:
 
     PSERIAL_DEVICE_EXTENSION Extension = NULL;
 
-    Extension = SerialGetDeviceExtension(WdfTimerGetParentObject(Timer));
+    Extension = Timer->Extension;
 
     WdfInterruptSynchronize(
         Extension->WdfInterrupt,
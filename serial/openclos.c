@@ -225,6 +225,13 @@ SerialDeviceFileCreateWorker (
 
     extension->TotalCharsQueued = 0;
 
+    //
+    // Adaptive buffer mode is per open.
+    //
+
+    extension->AdaptiveBufferMaximum = 0;
+    extension->AdaptiveGrowPending = FALSE;
+
     //
     // We set up the default xon/xoff limits.
     //
@@ -579,9 +586,16 @@ SerialFileCloseWorker(
 
     //
     // All is done.  The port has been disabled from interrupting
-    // so there is no point in keeping the memory around.
+    // so there is no point in keeping the memory around.  Make sure
+    // adaptive buffer mode isn't about to resize it first.  Receive
+    // timestamps are per open as well.
     //
 
+    extension->AdaptiveBufferMaximum = 0;
+    WdfTimerStop(extension->AdaptiveSampleTimer, TRUE);
+    WdfDpcCancel(extension->AdaptiveGrowDpc, TRUE);
+    extension->RxTimestamps = FALSE;
+
     extension->BufferSize = 0;
     if (extension->InterruptReadBuffer != NULL) {
        ExFreePool(extension->InterruptReadBuffer);
@@ -174,6 +174,13 @@ Return Value:
 
     WdfDeviceInitSetRequestAttributes(DeviceInit, &attributes);
 
+    //
+    // The receive ring map ioctl carries an event handle, which has to
+    // be referenced in the caller's context.
+    //
+    WdfDeviceInitSetIoInCallerContextCallback(DeviceInit,
+                                              SerialEvtIoInCallerContext);
+
     //
     // Zero out the PnpPowerCallbacks structure.
     //
@@ -293,7 +300,7 @@ Return Value:
                             &fileobjectConfig,
                             SerialEvtDeviceFileCreate,
                             SerialEvtFileClose,
-                            WDF_NO_EVENT_CALLBACK // Cleanup
+                            SerialEvtFileCleanup
                             );
 
         WdfDeviceInitSetFileObjectConfig(
@@ -1362,6 +1369,8 @@ Return Value:
     pDevExt->HandFlow.ControlHandShake = SERIAL_DTR_CONTROL;
     pDevExt->HandFlow.FlowReplace      = SERIAL_RTS_CONTROL;
 
+    SerialUpdateSpecialCharMap(pDevExt);
+
 
     //
     // Default Line control protocol. 7E1
@@ -53,10 +53,14 @@ Return Value:
 
     WDFREQUEST NewRequest;
     PREQUEST_CONTEXT reqContext;
+    LARGE_INTEGER start;
 
     do {
 
         ULONG Mask;
+
+        start = KeQueryPerformanceCounter(NULL);
+
         reqContext = SerialGetRequestContext(Extension->CurrentPurgeRequest);
         Mask = *((ULONG *) (reqContext->SystemBuffer));
 
@@ -103,6 +107,11 @@ Return Value:
 
         }
 
+        Extension->LastPurgeTicks = KeQueryPerformanceCounter(NULL).QuadPart -
+                                    start.QuadPart;
+        Extension->PurgeTicks += Extension->LastPurgeTicks;
+        Extension->PurgeCount++;
+
         reqContext->Status = STATUS_SUCCESS;
         reqContext->Information = 0;
 
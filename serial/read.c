@@ -48,6 +48,12 @@ SerialMoveToNewIntBuffer(
     PUCHAR NewBuffer
     );
 
+VOID
+SerialAdaptiveResize(
+    IN PSERIAL_DEVICE_EXTENSION Extension,
+    IN ULONG NewBufferSize
+    );
+
 VOID
 SerialEvtIoRead(
     IN WDFQUEUE         Queue,
@@ -100,6 +106,19 @@ Return Value:
 
     }
 
+    //
+    // Received characters go to the mapped receive ring while there
+    // is one, so a read would never see any.
+    //
+
+    if (extension->ReceiveRingRequest != NULL) {
+
+        SerialCompleteRequest(Request, STATUS_INVALID_DEVICE_STATE, 0);
+        SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_READ, "<SerialEvtIoRead (6) %X\n", STATUS_INVALID_DEVICE_STATE);
+        return;
+
+    }
+
     WDF_REQUEST_PARAMETERS_INIT(&params);
 
     WdfRequestGetParameters(
@@ -244,8 +263,8 @@ Return Value:
             // life.
             //
 
-            SerialCancelTimer(Extension->ReadRequestTotalTimer, Extension);
-            SerialCancelTimer(Extension->ReadRequestIntervalTimer, Extension);
+            SerialCancelTimer(&Extension->ReadRequestTotalTimer, Extension);
+            SerialCancelTimer(&Extension->ReadRequestIntervalTimer, Extension);
 
             //
             // We get the *current* timeout values to use for timing
@@ -470,7 +489,7 @@ Return Value:
                         BOOLEAN result;
 
                         result = SerialSetTimer(
-                            Extension->ReadRequestTotalTimer,
+                            &Extension->ReadRequestTotalTimer,
                             totalTime
                             );
 
@@ -492,7 +511,7 @@ Return Value:
 
                             );
                         result = SerialSetTimer(
-                            Extension->ReadRequestIntervalTimer,
+                            &Extension->ReadRequestIntervalTimer,
                             *Extension->IntervalTimeToUse
                             );
 
@@ -568,6 +587,8 @@ Return Value:
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_READ, ">SerialCompleteRead(%p)\n",
                      extension);
 
+    SerialAcquireCompletionLock(extension);
+
     //
     // We set this to indicate to the interval timer
     // that the read has completed.
@@ -584,13 +605,14 @@ Return Value:
         STATUS_SUCCESS,
         &extension->CurrentReadRequest,
         extension->ReadQueue,
-        extension->ReadRequestIntervalTimer,
-        extension->ReadRequestTotalTimer,
+        &extension->ReadRequestIntervalTimer,
+        &extension->ReadRequestTotalTimer,
         SerialStartRead,
         SerialGetNextRequest,
         SERIAL_REF_ISR
         );
 
+    SerialReleaseCompletionLock(extension);
 
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_READ, "<SerialCompleteRead\n");
 }
@@ -643,8 +665,8 @@ Return Value:
         STATUS_CANCELLED,
         &extension->CurrentReadRequest,
         extension->ReadQueue,
-        extension->ReadRequestIntervalTimer,
-        extension->ReadRequestTotalTimer,
+        &extension->ReadRequestIntervalTimer,
+        &extension->ReadRequestTotalTimer,
         SerialStartRead,
         SerialGetNextRequest,
         SERIAL_REF_CANCEL
@@ -734,7 +756,7 @@ Return Value:
 
 VOID
 SerialReadTimeout(
-    IN WDFTIMER Timer
+    IN PSERIAL_TIMER Timer
     )
 
 /*++
@@ -757,7 +779,7 @@ Return Value:
 
     PSERIAL_DEVICE_EXTENSION extension = NULL;
 
-    extension = SerialGetDeviceExtension(WdfTimerGetParentObject(Timer));
+    extension = Timer->Extension;
 
 
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_READ, ">SerialReadTimeout(%p)\n",
@@ -779,8 +801,8 @@ Return Value:
         STATUS_TIMEOUT,
         &extension->CurrentReadRequest,
         extension->ReadQueue,
-        extension->ReadRequestIntervalTimer,
-        extension->ReadRequestTotalTimer,
+        &extension->ReadRequestIntervalTimer,
+        &extension->ReadRequestTotalTimer,
         SerialStartRead,
         SerialGetNextRequest,
         SERIAL_REF_TOTAL_TIMER
@@ -835,7 +857,7 @@ Return Value:
 
 VOID
 SerialIntervalReadTimeout(
-    IN WDFTIMER Timer
+    IN PSERIAL_TIMER Timer
     )
 
 /*++
@@ -864,7 +886,7 @@ Return Value:
 {
     PSERIAL_DEVICE_EXTENSION extension = NULL;
 
-    extension = SerialGetDeviceExtension(WdfTimerGetParentObject(Timer));
+    extension = Timer->Extension;
 
 
     //SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_READ, ">SerialIntervalReadTimeout(%p)\n",
@@ -885,8 +907,8 @@ Return Value:
             STATUS_TIMEOUT,
             &extension->CurrentReadRequest,
             extension->ReadQueue,
-            extension->ReadRequestIntervalTimer,
-            extension->ReadRequestTotalTimer,
+            &extension->ReadRequestIntervalTimer,
+            &extension->ReadRequestTotalTimer,
             SerialStartRead,
             SerialGetNextRequest,
             SERIAL_REF_INT_TIMER
@@ -908,8 +930,8 @@ Return Value:
             STATUS_SUCCESS,
             &extension->CurrentReadRequest,
             extension->ReadQueue,
-            extension->ReadRequestIntervalTimer,
-            extension->ReadRequestTotalTimer,
+            &extension->ReadRequestIntervalTimer,
+            &extension->ReadRequestTotalTimer,
             SerialStartRead,
             SerialGetNextRequest,
             SERIAL_REF_INT_TIMER
@@ -931,8 +953,8 @@ Return Value:
             STATUS_CANCELLED,
             &extension->CurrentReadRequest,
             extension->ReadQueue,
-            extension->ReadRequestIntervalTimer,
-            extension->ReadRequestTotalTimer,
+            &extension->ReadRequestIntervalTimer,
+            &extension->ReadRequestTotalTimer,
             SerialStartRead,
             SerialGetNextRequest,
             SERIAL_REF_INT_TIMER
@@ -968,7 +990,7 @@ Return Value:
                 );
 
             SerialSetTimer(
-                extension->ReadRequestIntervalTimer,
+                &extension->ReadRequestIntervalTimer,
                 *extension->IntervalTimeToUse
                 );
 
@@ -1002,8 +1024,8 @@ Return Value:
                     STATUS_TIMEOUT,
                     &extension->CurrentReadRequest,
                     extension->ReadQueue,
-                    extension->ReadRequestIntervalTimer,
-                    extension->ReadRequestTotalTimer,
+                    &extension->ReadRequestIntervalTimer,
+                    &extension->ReadRequestTotalTimer,
                     SerialStartRead,
                     SerialGetNextRequest,
                     SERIAL_REF_INT_TIMER
@@ -1012,7 +1034,7 @@ Return Value:
             } else {
 
                 SerialSetTimer(
-                    extension->ReadRequestIntervalTimer,
+                    &extension->ReadRequestIntervalTimer,
                     *extension->IntervalTimeToUse
                     );
 
@@ -1029,7 +1051,7 @@ Return Value:
         //
 
         SerialSetTimer(
-            extension->ReadRequestIntervalTimer,
+            &extension->ReadRequestIntervalTimer,
             *extension->IntervalTimeToUse
             );
 
@@ -1422,8 +1444,11 @@ typedef struct _SERIAL_RESIZE_PARAMS {
     PSERIAL_DEVICE_EXTENSION Extension;
     PUCHAR OldBuffer;
     PUCHAR NewBuffer;
+    ULONG OldBufferSize;
     ULONG NewBufferSize;
     ULONG NumberMoved;
+    BOOLEAN Adaptive;
+    BOOLEAN Switched;
     } SERIAL_RESIZE_PARAMS,*PSERIAL_RESIZE_PARAMS;
 
 
@@ -1469,6 +1494,17 @@ Return Value:
     reqContext->Information = 0L;
     reqContext->Status = STATUS_SUCCESS;
 
+    //
+    // Adaptive buffer mode never shrinks below what was asked for here,
+    // even when the buffer has already grown past it.
+    //
+
+    if (rs->InSize > Extension->AdaptiveBufferBase) {
+
+        Extension->AdaptiveBufferBase = rs->InSize;
+
+    }
+
     if (rs->InSize <= Extension->BufferSize) {
 
         //
@@ -1517,7 +1553,10 @@ Return Value:
         rp.Extension = Extension;
         rp.OldBuffer = Extension->InterruptReadBuffer;
         rp.NewBuffer = newBuffer;
+        rp.OldBufferSize = Extension->BufferSize;
         rp.NewBufferSize = rs->InSize;
+        rp.Adaptive = FALSE;
+        rp.Switched = TRUE;
 
         rp.NumberMoved = SerialMoveToNewIntBuffer(
                              Extension,
@@ -1685,6 +1724,22 @@ Return Value:
 
     UNREFERENCED_PARAMETER(Interrupt);
 
+    //
+    // An adaptive resize can find a read using its own buffer or,
+    // when shrinking, more characters than will fit.  Leave things
+    // alone in that case; nothing has been moved yet.
+    //
+
+    if (params->Adaptive &&
+        ((extension->ReadBufferBase != extension->InterruptReadBuffer) ||
+         (extension->CharsInInterruptBuffer >= params->NewBufferSize))) {
+
+        ASSERT(params->NumberMoved == 0);
+        params->Switched = FALSE;
+        return FALSE;
+
+    }
+
     ASSERT(extension->CharsInInterruptBuffer >= params->NumberMoved);
 
     //
@@ -1714,19 +1769,37 @@ Return Value:
     extension->BufferSize = params->NewBufferSize;
 
     //
-    // We *KNOW* that the new interrupt buffer is larger than the
-    // old buffer.  We don't need to worry about it being full.
+    // We *KNOW* that the new interrupt buffer can hold everything
+    // in the old one.  We don't need to worry about it being full.
     //
 
     extension->CurrentCharSlot = extension->InterruptReadBuffer +
                                  extension->CharsInInterruptBuffer;
 
-    //
-    // We set up the default xon/xoff limits.
-    //
+    if (params->Adaptive) {
+
+        //
+        // The application didn't ask for this resize so keep the
+        // xon/xoff limits it set, scaled to the new size.
+        //
+
+        extension->HandFlow.XoffLimit = (LONG)(((ULONGLONG)
+            extension->HandFlow.XoffLimit * params->NewBufferSize) /
+            params->OldBufferSize);
+        extension->HandFlow.XonLimit = (LONG)(((ULONGLONG)
+            extension->HandFlow.XonLimit * params->NewBufferSize) /
+            params->OldBufferSize);
+
+    } else {
+
+        //
+        // We set up the default xon/xoff limits.
+        //
+
+        extension->HandFlow.XoffLimit = extension->BufferSize >> 3;
+        extension->HandFlow.XonLimit = extension->BufferSize >> 1;
 
-    extension->HandFlow.XoffLimit = extension->BufferSize >> 3;
-    extension->HandFlow.XonLimit = extension->BufferSize >> 1;
+    }
 
     extension->WmiCommData.XoffXmitThreshold = extension->HandFlow.XoffLimit;
     extension->WmiCommData.XonXmitThreshold = extension->HandFlow.XonLimit;
@@ -1746,3 +1819,573 @@ Return Value:
 }
 
 
+VOID
+SerialAdaptiveResize(
+    IN PSERIAL_DEVICE_EXTENSION Extension,
+    IN ULONG NewBufferSize
+    )
+
+/*++
+
+Routine Description:
+
+    This routine moves the interrupt buffer to a new buffer of the given
+    size on behalf of adaptive buffer mode.  It works like the resize
+    done for IOCTL_SERIAL_SET_QUEUE_SIZE, except that it can also make
+    the buffer smaller and it quietly gives up if it can't allocate the
+    memory or the characters wouldn't fit.
+
+    NOTE: This is called with the device lock held, so no read can
+    start using its own buffer while we are at it.
+
+Arguments:
+
+    Extension - Pointer to the device extension for the port.
+
+    NewBufferSize - The size of the new interrupt buffer.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+
+    SERIAL_RESIZE_PARAMS rp;
+    PUCHAR newBuffer;
+
+    if (!Extension->InterruptReadBuffer ||
+        (NewBufferSize == Extension->BufferSize) ||
+        (Extension->ReadBufferBase != Extension->InterruptReadBuffer)) {
+
+        return;
+
+    }
+
+    newBuffer = ExAllocatePoolWithTag(
+                    NonPagedPoolNx,
+                    NewBufferSize,
+                    POOL_TAG
+                    );
+
+    if (!newBuffer) {
+
+        return;
+
+    }
+
+    rp.Extension = Extension;
+    rp.OldBuffer = Extension->InterruptReadBuffer;
+    rp.NewBuffer = newBuffer;
+    rp.OldBufferSize = Extension->BufferSize;
+    rp.NewBufferSize = NewBufferSize;
+    rp.Adaptive = TRUE;
+    rp.Switched = TRUE;
+    rp.NumberMoved = 0;
+
+    //
+    // When growing, move what we can before we synchronize with the
+    // isr as SerialResizeBuffer does.  When shrinking the buffer is
+    // (nearly) empty, so everything is moved in the synchronize
+    // routine once it has checked that it fits.
+    //
+
+    if (NewBufferSize > Extension->BufferSize) {
+
+        rp.NumberMoved = SerialMoveToNewIntBuffer(
+                             Extension,
+                             newBuffer
+                             );
+
+    }
+
+    WdfInterruptSynchronize(
+        Extension->WdfInterrupt,
+        SerialUpdateAndSwitchToNew,
+        &rp
+        );
+
+    if (rp.Switched) {
+
+        SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_READ,
+                         "Adaptive buffer resized from %u to %u\n",
+                         rp.OldBufferSize, NewBufferSize);
+
+        ExFreePool(rp.OldBuffer);
+
+    } else {
+
+        ExFreePool(newBuffer);
+
+    }
+
+}
+
+
+VOID
+SerialAdaptiveGrow(
+    IN WDFDPC Dpc
+    )
+
+/*++
+
+Routine Description:
+
+    This dpc is queued by the isr in adaptive buffer mode when the
+    interrupt buffer is half way to its flow control threshold.  The
+    buffer is at least doubled, and made big enough to hold what was
+    received in the last sample period, up to the mode's maximum.
+
+Arguments:
+
+    Dpc - Not Used.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+
+    PSERIAL_DEVICE_EXTENSION extension = NULL;
+    ULONG newSize;
+
+    extension = SerialGetDeviceExtension(WdfDpcGetParentObject(Dpc));
+
+    if (extension->AdaptiveBufferMaximum) {
+
+        newSize = extension->BufferSize << 1;
+
+        if (newSize < extension->AdaptiveRxRate) {
+
+            newSize = extension->AdaptiveRxRate;
+
+        }
+
+        if (newSize > extension->AdaptiveBufferMaximum) {
+
+            newSize = extension->AdaptiveBufferMaximum;
+
+        }
+
+        if (newSize > extension->BufferSize) {
+
+            SerialAdaptiveResize(extension, newSize);
+
+        }
+
+    }
+
+    extension->AdaptiveGrowPending = FALSE;
+
+}
+
+
+VOID
+SerialAdaptiveSample(
+    IN WDFTIMER Timer
+    )
+
+/*++
+
+Routine Description:
+
+    This periodic timer runs while adaptive buffer mode is on.  It
+    records the number of characters received since the last sample
+    and puts the interrupt buffer back to its base size once the port
+    has been idle for SERIAL_ADAPTIVE_IDLE_SAMPLES samples.
+
+Arguments:
+
+    Timer - The sample timer; its parent is the device.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+
+    PSERIAL_DEVICE_EXTENSION extension = NULL;
+    ULONG received;
+
+    extension = SerialGetDeviceExtension(WdfTimerGetParentObject(Timer));
+
+    if (!extension->AdaptiveBufferMaximum) {
+
+        return;
+
+    }
+
+    //
+    // The perf stats can be cleared under us, in which case everything
+    // counted so far is new.
+    //
+
+    received = extension->PerfStats.ReceivedCount;
+
+    if (received >= extension->AdaptiveLastReceived) {
+
+        extension->AdaptiveRxRate = received - extension->AdaptiveLastReceived;
+
+    } else {
+
+        extension->AdaptiveRxRate = received;
+
+    }
+
+    extension->AdaptiveLastReceived = received;
+
+    if (extension->AdaptiveRxRate) {
+
+        extension->AdaptiveIdleSamples = 0;
+
+    } else if (++extension->AdaptiveIdleSamples >=
+               SERIAL_ADAPTIVE_IDLE_SAMPLES) {
+
+        extension->AdaptiveIdleSamples = 0;
+
+        if (extension->BufferSize > extension->AdaptiveBufferBase) {
+
+            SerialAdaptiveResize(extension, extension->AdaptiveBufferBase);
+
+        }
+
+    }
+
+}
+
+
+BOOLEAN
+SerialSetRxTimestamps(
+    IN WDFINTERRUPT  Interrupt,
+    IN PVOID Context
+    )
+
+/*++
+
+Routine Description:
+
+    This routine turns receive timestamps on or off.  Turning them on
+    starts the receive sequence over with no batches remembered, so the
+    characters already in the interrupt buffer have no known time.
+
+    NOTE: This is called by WdfInterruptSynchronize.
+
+Arguments:
+
+    Context - Points to a SERIAL_IOCTL_SYNC whose data is the ULONG
+              passed in by the application.
+
+Return Value:
+
+    Always FALSE.
+
+--*/
+
+{
+
+    PSERIAL_IOCTL_SYNC sync = Context;
+    PSERIAL_DEVICE_EXTENSION extension = sync->Extension;
+
+    UNREFERENCED_PARAMETER(Interrupt);
+
+    if (*(PULONG)sync->Data) {
+
+        if (!extension->RxTimestamps) {
+
+            extension->RxSequence = extension->CharsInInterruptBuffer;
+            extension->RxBatchCount = 0;
+            extension->RxBatchOpen = FALSE;
+            extension->RxTimestamps = TRUE;
+
+        }
+
+    } else {
+
+        extension->RxTimestamps = FALSE;
+
+    }
+
+    return FALSE;
+
+}
+
+
+BOOLEAN
+SerialGetRxTimestampRuns(
+    IN WDFINTERRUPT  Interrupt,
+    IN PVOID Context
+    )
+
+/*++
+
+Routine Description:
+
+    This routine works out which of the characters in the interrupt
+    buffer fit the caller's output buffer and splits them into runs by
+    the batch they came in with.  It fills in the runs, RunCount and
+    DataLength but doesn't touch the interrupt buffer; the characters
+    are copied and taken out of the buffer afterwards.
+
+    NOTE: This is called by WdfInterruptSynchronize.
+
+Arguments:
+
+    Context - Points to a SERIAL_RX_TIMESTAMP_SYNC.
+
+Return Value:
+
+    Always FALSE.
+
+--*/
+
+{
+
+    PSERIAL_RX_TIMESTAMP_SYNC sync = Context;
+    PSERIAL_DEVICE_EXTENSION extension = sync->Extension;
+    PSERIAL_TIMESTAMPED_READ read = sync->Read;
+    PSERIAL_RX_TIMESTAMP_RUN run;
+    ULONGLONG first;
+    ULONGLONG position;
+    ULONGLONG runEnd;
+    ULONGLONG batchEnd = 0;
+    LONGLONG timestamp;
+    ULONG batch;
+    ULONG room;
+    ULONG take;
+
+    UNREFERENCED_PARAMETER(Interrupt);
+
+    //
+    // Every character put in the interrupt buffer since timestamps
+    // were turned on has a sequence number, so the ones still in it
+    // are the last CharsInInterruptBuffer of those.
+    //
+
+    first = extension->RxSequence - extension->CharsInInterruptBuffer;
+    position = first;
+    room = sync->Length - FIELD_OFFSET(SERIAL_TIMESTAMPED_READ, Runs);
+    read->RunCount = 0;
+
+    batch = 0;
+
+    if (extension->RxBatchCount > SERIAL_RX_TIMESTAMP_RUNS) {
+
+        batch = extension->RxBatchCount - SERIAL_RX_TIMESTAMP_RUNS;
+
+    }
+
+    while (position < extension->RxSequence) {
+
+        //
+        // Skip the batches that end before this character.  What is
+        // left is either the batch it came in with or, if that one has
+        // been forgotten, the next batch we still know about.
+        //
+
+        for (;;) {
+
+            if (batch == extension->RxBatchCount) {
+                break;
+            }
+
+            if (batch + 1 == extension->RxBatchCount) {
+
+                batchEnd = extension->RxSequence;
+
+            } else {
+
+                batchEnd = extension->RxBatches[(batch + 1) %
+                    SERIAL_RX_TIMESTAMP_RUNS].Sequence;
+
+            }
+
+            if (batchEnd > position) {
+                break;
+            }
+
+            batch++;
+
+        }
+
+        if ((batch < extension->RxBatchCount) &&
+            (extension->RxBatches[batch % SERIAL_RX_TIMESTAMP_RUNS].Sequence <=
+             position)) {
+
+            timestamp =
+                extension->RxBatches[batch % SERIAL_RX_TIMESTAMP_RUNS].Timestamp;
+            runEnd = batchEnd;
+
+        } else {
+
+            timestamp = 0;
+            runEnd = (batch < extension->RxBatchCount) ?
+                     extension->RxBatches[batch % SERIAL_RX_TIMESTAMP_RUNS].Sequence :
+                     extension->RxSequence;
+
+        }
+
+        if (room <= sizeof(SERIAL_RX_TIMESTAMP_RUN)) {
+            break;
+        }
+
+        take = room - sizeof(SERIAL_RX_TIMESTAMP_RUN);
+
+        if (take > runEnd - position) {
+
+            take = (ULONG)(runEnd - position);
+
+        }
+
+        run = &read->Runs[read->RunCount];
+        run->Timestamp = timestamp;
+        run->Offset = (ULONG)(position - first);
+        run->Length = take;
+
+        read->RunCount++;
+        room -= sizeof(SERIAL_RX_TIMESTAMP_RUN) + take;
+        position += take;
+
+    }
+
+    read->DataLength = (ULONG)(position - first);
+
+    return FALSE;
+
+}
+
+
+NTSTATUS
+SerialReadTimestamped(
+    IN PSERIAL_DEVICE_EXTENSION Extension,
+    IN PSERIAL_TIMESTAMPED_READ Read,
+    IN ULONG Length,
+    OUT PULONG Information
+    )
+
+/*++
+
+Routine Description:
+
+    This routine takes the characters in the interrupt buffer, as many
+    as fit, for IOCTL_SERIAL_READ_TIMESTAMPED along with the times
+    they arrived.  It never waits for characters.
+
+    NOTE: This is called with the device lock held.
+
+Arguments:
+
+    Extension - A pointer to the device extension.
+
+    Read - The request's system buffer.
+
+    Length - The length of the output buffer, at least
+             FIELD_OFFSET(SERIAL_TIMESTAMPED_READ, Runs).
+
+    Information - Gets the number of bytes returned.
+
+Return Value:
+
+    STATUS_SUCCESS, or STATUS_INVALID_DEVICE_STATE if timestamps
+    aren't on or the receive ring is mapped.
+
+--*/
+
+{
+
+    SERIAL_RX_TIMESTAMP_SYNC sync;
+    SERIAL_UPDATE_CHAR updateChar;
+    LARGE_INTEGER frequency;
+    PUCHAR data;
+    ULONG firstTryNumberToGet;
+
+    if (!Extension->RxTimestamps ||
+        (Extension->ReceiveRingRequest != NULL)) {
+
+        return STATUS_INVALID_DEVICE_STATE;
+
+    }
+
+    KeQueryPerformanceCounter(&frequency);
+
+    sync.Extension = Extension;
+    sync.Read = Read;
+    sync.Length = Length;
+
+    WdfInterruptSynchronize(
+        Extension->WdfInterrupt,
+        SerialGetRxTimestampRuns,
+        &sync
+        );
+
+    Read->Frequency = frequency.QuadPart;
+    Read->DataOffset = FIELD_OFFSET(SERIAL_TIMESTAMPED_READ, Runs) +
+                       (Read->RunCount * sizeof(SERIAL_RX_TIMESTAMP_RUN));
+    Read->Reserved = 0;
+
+    *Information = Read->DataOffset + Read->DataLength;
+
+    if (!Read->DataLength) {
+
+        return STATUS_SUCCESS;
+
+    }
+
+    //
+    // The isr only adds characters behind the ones counted above, so
+    // they can be copied out without holding it off.  This is the same
+    // copy SerialGetCharsFromIntBuffer does.
+    //
+
+    data = (PUCHAR)Read + Read->DataOffset;
+
+    firstTryNumberToGet = (ULONG)(Extension->LastCharSlot -
+                                  Extension->FirstReadableChar) + 1;
+
+    if (firstTryNumberToGet > Read->DataLength) {
+
+        RtlMoveMemory(
+            data,
+            Extension->FirstReadableChar,
+            Read->DataLength
+            );
+
+        Extension->FirstReadableChar += Read->DataLength;
+
+    } else {
+
+        RtlMoveMemory(
+            data,
+            Extension->FirstReadableChar,
+            firstTryNumberToGet
+            );
+
+        RtlMoveMemory(
+            data + firstTryNumberToGet,
+            Extension->InterruptReadBuffer,
+            Read->DataLength - firstTryNumberToGet
+            );
+
+        Extension->FirstReadableChar = Extension->InterruptReadBuffer +
+                                       (Read->DataLength -
+                                        firstTryNumberToGet);
+
+    }
+
+    updateChar.Extension = Extension;
+    updateChar.CharsCopied = Read->DataLength;
+    updateChar.Completed = FALSE;
+
+    WdfInterruptSynchronize(
+        Extension->WdfInterrupt,
+        SerialUpdateInterruptBuffer,
+        &updateChar
+        );
+
+    return STATUS_SUCCESS;
+
+}
@@ -0,0 +1,672 @@
+/*++
+
+Copyright (c) Microsoft Corporation
+
+Module Name:
+
+    ring.c
+
+Abstract:
+
+    This module contains the code that is very specific to the mapped
+    receive ring in the serial driver.  While a ring is mapped the isr
+    puts received characters straight into memory shared with the
+    client, which consumes them without issuing any read requests.
+
+    The ring is the output buffer of a METHOD_OUT_DIRECT request that
+    stays pending for as long as the ring is in use, so the pages stay
+    locked and the mapping goes away with the request however the
+    client lets go of it.
+
+Environment:
+
+    Kernel mode
+
+--*/
+
+#include "precomp.h"
+
+#if defined(EVENT_TRACING)
+#include "ring.tmh"
+#endif
+
+EVT_WDF_REQUEST_CANCEL SerialCancelReceiveRing;
+EVT_WDF_OBJECT_CONTEXT_CLEANUP SerialEvtRingRequestCleanup;
+
+EVT_WDF_INTERRUPT_SYNCHRONIZE SerialStartReceiveRing;
+EVT_WDF_INTERRUPT_SYNCHRONIZE SerialStopReceiveRing;
+
+WDFREQUEST
+SerialDetachReceiveRing(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    );
+
+
+VOID
+SerialEvtIoInCallerContext(
+    IN WDFDEVICE  Device,
+    IN WDFREQUEST Request
+    )
+
+/*++
+
+Routine Description:
+
+    This routine sees every request before it is queued, in the
+    context of the thread that sent it.  The only thing done here is
+    to reference the doorbell event handle of a receive ring map
+    request, which can only be done in the caller's process.
+
+Arguments:
+
+    Device - Handle to the framework device object
+
+    Request - Handle to the request
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    NTSTATUS status;
+    WDF_REQUEST_PARAMETERS params;
+    WDF_OBJECT_ATTRIBUTES attributes;
+    PSERIAL_RING_REQUEST_CONTEXT ringContext;
+    PSERIAL_RECEIVE_RING_MAP map;
+    PVOID buffer;
+    PVOID object;
+    size_t bufSize;
+
+    WDF_REQUEST_PARAMETERS_INIT(&params);
+
+    WdfRequestGetParameters(Request, &params);
+
+    if ((params.Type != WdfRequestTypeDeviceIoControl) ||
+        (params.Parameters.DeviceIoControl.IoControlCode !=
+         IOCTL_SERIAL_MAP_RECEIVE_RING)) {
+
+        goto EnqueueRequest;
+
+    }
+
+    status = WdfRequestRetrieveInputBuffer(Request,
+                                           sizeof(SERIAL_RECEIVE_RING_MAP),
+                                           &buffer,
+                                           &bufSize);
+
+    if (!NT_SUCCESS(status)) {
+        goto CompleteRequest;
+    }
+
+    map = (PSERIAL_RECEIVE_RING_MAP)buffer;
+
+    WDF_OBJECT_ATTRIBUTES_INIT_CONTEXT_TYPE(&attributes,
+                                            SERIAL_RING_REQUEST_CONTEXT);
+    attributes.EvtCleanupCallback = SerialEvtRingRequestCleanup;
+
+    status = WdfObjectAllocateContext(Request, &attributes, &buffer);
+
+    if (!NT_SUCCESS(status)) {
+        goto CompleteRequest;
+    }
+
+    ringContext = (PSERIAL_RING_REQUEST_CONTEXT)buffer;
+
+    ringContext->DoorbellEvent = NULL;
+
+    if (map->DoorbellEvent != 0) {
+
+        status = ObReferenceObjectByHandle(
+                     (HANDLE)(ULONG_PTR)map->DoorbellEvent,
+                     EVENT_MODIFY_STATE,
+                     *ExEventObjectType,
+                     WdfRequestGetRequestorMode(Request),
+                     &object,
+                     NULL
+                     );
+
+        if (!NT_SUCCESS(status)) {
+            goto CompleteRequest;
+        }
+
+        ringContext->DoorbellEvent = (PKEVENT)object;
+
+    }
+
+EnqueueRequest:;
+
+    status = WdfDeviceEnqueueRequest(Device, Request);
+
+    if (NT_SUCCESS(status)) {
+        return;
+    }
+
+CompleteRequest:;
+
+    SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_IOCTLS,
+                     "SerialEvtIoInCallerContext failed %X\n", status);
+
+    WdfRequestComplete(Request, status);
+
+    return;
+
+}
+
+
+VOID
+SerialEvtRingRequestCleanup(
+    IN WDFOBJECT Object
+    )
+
+/*++
+
+Routine Description:
+
+    This routine drops the reference on the doorbell event taken when
+    a receive ring map request came in.
+
+Arguments:
+
+    Object - The request
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    PSERIAL_RING_REQUEST_CONTEXT ringContext;
+
+    ringContext = SerialGetRingRequestContext(Object);
+
+    if (ringContext->DoorbellEvent != NULL) {
+
+        ObDereferenceObject(ringContext->DoorbellEvent);
+        ringContext->DoorbellEvent = NULL;
+
+    }
+
+}
+
+
+NTSTATUS
+SerialMapReceiveRing(
+    IN PSERIAL_DEVICE_EXTENSION Extension,
+    IN WDFREQUEST Request
+    )
+
+/*++
+
+Routine Description:
+
+    This routine takes the output buffer of a receive ring map request
+    as the ring for received characters.  Anything already in the
+    interrupt buffer is moved into the ring.  Reads are refused until
+    the ring is unmapped.
+
+    NOTE: This must be called with the device lock held.
+
+Arguments:
+
+    Extension - The serial device extension.
+
+    Request - The map request.
+
+Return Value:
+
+    STATUS_PENDING if the ring is now in use and the request is owned
+    by the ring, otherwise a failure status to complete it with.
+
+--*/
+
+{
+    NTSTATUS status;
+    PSERIAL_RING_REQUEST_CONTEXT ringContext;
+    PREQUEST_CONTEXT reqContext;
+    PSERIAL_RECEIVE_RING ring;
+    PVOID buffer;
+    size_t bufSize;
+    ULONG size;
+
+    if ((Extension->ReceiveRingRequest != NULL) ||
+        (Extension->CurrentReadRequest != NULL)) {
+
+        return STATUS_DEVICE_BUSY;
+
+    }
+
+    status = WdfRequestRetrieveOutputBuffer(
+                 Request,
+                 FIELD_OFFSET(SERIAL_RECEIVE_RING, Data) +
+                 SERIAL_RECEIVE_RING_MIN_SIZE,
+                 &buffer,
+                 &bufSize
+                 );
+
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    ring = (PSERIAL_RECEIVE_RING)buffer;
+
+    //
+    // Use the largest power of two that fits, so the isr can wrap with
+    // a mask.
+    //
+
+    bufSize -= FIELD_OFFSET(SERIAL_RECEIVE_RING, Data);
+
+    if (bufSize > SERIAL_RECEIVE_RING_MAX_SIZE) {
+        bufSize = SERIAL_RECEIVE_RING_MAX_SIZE;
+    }
+
+    for (size = SERIAL_RECEIVE_RING_MIN_SIZE;
+         (size << 1) <= bufSize;
+         size <<= 1) {
+        ;
+    }
+
+    ring->Head = 0;
+    ring->Tail = 0;
+    ring->ReaderWaiting = 0;
+    ring->Size = size;
+    ring->Overruns = 0;
+
+    ringContext = SerialGetRingRequestContext(Request);
+    reqContext = SerialGetRequestContext(Request);
+    reqContext->Extension = Extension;
+
+    Extension->ReceiveRingRequest = Request;
+    Extension->ReceiveRingEvent = ringContext->DoorbellEvent;
+    Extension->ReceiveRingHead = 0;
+    Extension->ReceiveRingSize = size;
+    Extension->ReceiveRingOverruns = 0;
+
+    WdfInterruptSynchronize(
+        Extension->WdfInterrupt,
+        SerialStartReceiveRing,
+        ring
+        );
+
+    SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_IOCTLS,
+                     "Mapped receive ring %p, %u bytes\n", ring, size);
+
+    //
+    // Last, since this can cancel the request (and so undo all of the
+    // above) right away.
+    //
+
+    SerialSetCancelRoutine(Request, SerialCancelReceiveRing);
+
+    return STATUS_PENDING;
+
+}
+
+
+BOOLEAN
+SerialStartReceiveRing(
+    IN WDFINTERRUPT Interrupt,
+    IN PVOID Context
+    )
+
+/*++
+
+Routine Description:
+
+    This routine hands the ring to the isr.  It moves whatever is in
+    the interrupt buffer into the ring first, so nothing received
+    before the ring was mapped is lost, and then lets flow control
+    know the interrupt buffer is empty.
+
+Arguments:
+
+    Interrupt - The interrupt object.
+
+    Context - The ring.
+
+Return Value:
+
+    Always FALSE.
+
+--*/
+
+{
+    PSERIAL_DEVICE_EXTENSION extension;
+    PSERIAL_RECEIVE_RING ring = Context;
+
+    extension = SerialGetDeviceExtension(WdfInterruptGetDevice(Interrupt));
+
+    extension->ReceiveRing = ring;
+
+    while (extension->CharsInInterruptBuffer) {
+
+        SerialPutRingChar(extension, *extension->FirstReadableChar);
+
+        extension->CharsInInterruptBuffer--;
+
+        if (extension->FirstReadableChar == extension->LastCharSlot) {
+            extension->FirstReadableChar = extension->InterruptReadBuffer;
+        } else {
+            extension->FirstReadableChar++;
+        }
+
+    }
+
+    extension->CurrentCharSlot = extension->InterruptReadBuffer;
+    extension->FirstReadableChar = extension->InterruptReadBuffer;
+
+    SerialHandleReducedIntBuffer(extension);
+
+    return FALSE;
+
+}
+
+
+BOOLEAN
+SerialStopReceiveRing(
+    IN WDFINTERRUPT Interrupt,
+    IN PVOID Context
+    )
+
+/*++
+
+Routine Description:
+
+    This routine takes the ring away from the isr.  Characters received
+    from here on go to the interrupt buffer again.
+
+Arguments:
+
+    Interrupt - Not used.
+
+    Context - The serial device extension.
+
+Return Value:
+
+    Always FALSE.
+
+--*/
+
+{
+    PSERIAL_DEVICE_EXTENSION extension = Context;
+
+    UNREFERENCED_PARAMETER(Interrupt);
+
+    extension->ReceiveRing = NULL;
+
+    return FALSE;
+
+}
+
+
+WDFREQUEST
+SerialDetachReceiveRing(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    )
+
+/*++
+
+Routine Description:
+
+    This routine stops the isr from using the ring and forgets about
+    it.  A doorbell dpc that is still queued finds no event and does
+    nothing.
+
+    NOTE: This must be called with the device lock held.
+
+Arguments:
+
+    Extension - The serial device extension.
+
+Return Value:
+
+    The request that owned the ring, NULL if there wasn't one.
+
+--*/
+
+{
+    WDFREQUEST request = Extension->ReceiveRingRequest;
+
+    if (request == NULL) {
+        return NULL;
+    }
+
+    WdfInterruptSynchronize(
+        Extension->WdfInterrupt,
+        SerialStopReceiveRing,
+        Extension
+        );
+
+    Extension->ReceiveRingRequest = NULL;
+    Extension->ReceiveRingEvent = NULL;
+
+    return request;
+
+}
+
+
+VOID
+SerialUnmapReceiveRing(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    )
+
+/*++
+
+Routine Description:
+
+    This routine gives the ring back to the client by completing the
+    request that owns it.  If the request is being cancelled the
+    cancel routine completes it instead.
+
+    NOTE: This must be called with the device lock held.
+
+Arguments:
+
+    Extension - The serial device extension.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    WDFREQUEST request;
+    PREQUEST_CONTEXT reqContext;
+
+    request = SerialDetachReceiveRing(Extension);
+
+    if (request == NULL) {
+        return;
+    }
+
+    if (NT_SUCCESS(SerialClearCancelRoutine(request, TRUE))) {
+
+        reqContext = SerialGetRequestContext(request);
+        reqContext->Status = STATUS_SUCCESS;
+
+        SerialCompleteRequest(request, STATUS_SUCCESS, 0);
+
+    }
+
+}
+
+
+VOID
+SerialCancelReceiveRing(
+    IN WDFREQUEST Request
+    )
+
+/*++
+
+Routine Description:
+
+    This routine is used to cancel the request that owns the receive
+    ring.
+
+Arguments:
+
+    Request - The request that owns (or owned) the ring.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    PREQUEST_CONTEXT reqContext = SerialGetRequestContext(Request);
+    PSERIAL_DEVICE_EXTENSION extension = reqContext->Extension;
+
+    if (extension->ReceiveRingRequest == Request) {
+        SerialDetachReceiveRing(extension);
+    }
+
+    SERIAL_CLEAR_REFERENCE(reqContext, SERIAL_REF_CANCEL);
+    reqContext->CancelRoutine = NULL;
+
+    SerialCompleteRequest(Request, STATUS_CANCELLED, 0);
+
+}
+
+
+VOID
+SerialPutRingChar(
+    IN PSERIAL_DEVICE_EXTENSION Extension,
+    IN UCHAR CharToPut
+    )
+
+/*++
+
+Routine Description:
+
+    This routine, which only runs at device level, puts a received
+    character into the mapped receive ring.
+
+    The ring is shared with the client, so nothing read from it is
+    trusted: the index written comes from the driver's own head and
+    size, and a tail that makes no sense just makes the ring look full.
+    No receive flow control is done against the ring; a full ring
+    counts an overrun and drops the character.
+
+Arguments:
+
+    Extension - The serial device extension.
+
+    CharToPut - The character.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    PSERIAL_RECEIVE_RING ring = Extension->ReceiveRing;
+    ULONG head = Extension->ReceiveRingHead;
+
+    if ((head - ring->Tail) >= Extension->ReceiveRingSize) {
+
+        Extension->PerfStats.BufferOverrunErrorCount++;
+        Extension->WmiPerfData.BufferOverrunErrorCount++;
+        Extension->ErrorWord |= SERIAL_ERROR_QUEUEOVERRUN;
+        ring->Overruns = ++Extension->ReceiveRingOverruns;
+        return;
+
+    }
+
+    ring->Data[head & (Extension->ReceiveRingSize - 1)] = CharToPut;
+
+    Extension->ReceiveRingHead = ++head;
+
+    //
+    // The character has to be visible before the head that covers it.
+    //
+
+    KeMemoryBarrier();
+    ring->Head = head;
+
+    if (ring->ReaderWaiting &&
+        InterlockedExchange((PLONG)&ring->ReaderWaiting, 0) &&
+        (Extension->ReceiveRingEvent != NULL)) {
+
+        SerialInsertQueueDpc(Extension->ReceiveRingDpc);
+
+    }
+
+}
+
+
+VOID
+SerialRingDoorbell(
+    IN WDFDPC Dpc
+    )
+
+/*++
+
+Routine Description:
+
+    This dpc signals the doorbell event of the receive ring for a
+    reader that went to sleep on it.
+
+Arguments:
+
+    Dpc - The doorbell dpc; its parent is the device.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    PSERIAL_DEVICE_EXTENSION extension;
+
+    extension = SerialGetDeviceExtension(WdfDpcGetParentObject(Dpc));
+
+    if (extension->ReceiveRingEvent != NULL) {
+
+        KeSetEvent(extension->ReceiveRingEvent, IO_SERIAL_INCREMENT, FALSE);
+
+    }
+
+}
+
+
+VOID
+SerialEvtFileCleanup(
+    IN WDFFILEOBJECT FileObject
+    )
+
+/*++
+
+Routine Description:
+
+    This routine is called when the last handle to the device is
+    closed.  The close doesn't come until every request on the file
+    completes, so the ring request has to be completed here.
+
+Arguments:
+
+    FileObject - The file object being cleaned up.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    WDFDEVICE device = WdfFileObjectGetDevice(FileObject);
+    PSERIAL_DEVICE_EXTENSION extension = SerialGetDeviceExtension(device);
+
+    WdfObjectAcquireLock(device);
+
+    SerialUnmapReceiveRing(extension);
+
+    WdfObjectReleaseLock(device);
+
+}
@@ -515,6 +515,160 @@ typedef struct _SERIAL_FIRMWARE_DATA {
 //
 #define SERIAL_BAD_VALUE ((ULONG)-1)
 
+//
+// Private ioctls.  These use function codes from the range reserved
+// for vendors so they can never collide with the ntddser.h set.
+//
+#define SERIAL_PRIVATE_IOCTL(Function) \
+    CTL_CODE(FILE_DEVICE_SERIAL_PORT, 0x800 + (Function), METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+#define IOCTL_SERIAL_SET_ADAPTIVE_BUFFER SERIAL_PRIVATE_IOCTL(1)
+#define IOCTL_SERIAL_UNMAP_RECEIVE_RING SERIAL_PRIVATE_IOCTL(2)
+#define IOCTL_SERIAL_MAP_RECEIVE_RING \
+    CTL_CODE(FILE_DEVICE_SERIAL_PORT, 0x800 + 3, METHOD_OUT_DIRECT, FILE_ANY_ACCESS)
+#define IOCTL_SERIAL_WRITE_SEGMENTS SERIAL_PRIVATE_IOCTL(4)
+#define IOCTL_SERIAL_SET_RX_TIMESTAMPS SERIAL_PRIVATE_IOCTL(5)
+#define IOCTL_SERIAL_READ_TIMESTAMPED SERIAL_PRIVATE_IOCTL(6)
+#define IOCTL_SERIAL_GET_DRIVER_STATS SERIAL_PRIVATE_IOCTL(7)
+
+//
+// Driver statistics returned by IOCTL_SERIAL_GET_DRIVER_STATS and
+// reset along with the perf stats by IOCTL_SERIAL_CLEAR_STATS.
+// CompletionContentionCount is the number of times the read or the
+// write completion dpc found the other one already holding or waiting
+// for the device lock, that is how often completions in one direction
+// stalled behind the other's.  PurgeCount is the number of purge
+// requests carried out; PurgeTicks is the time they took in total and
+// LastPurgeTicks the time the latest one took, both in performance
+// counter ticks of Frequency per second.
+//
+typedef struct _SERIAL_DRIVER_STATS {
+    ULONG CompletionContentionCount;
+    ULONG PurgeCount;
+    LONGLONG PurgeTicks;
+    LONGLONG LastPurgeTicks;
+    LONGLONG Frequency;
+} SERIAL_DRIVER_STATS,*PSERIAL_DRIVER_STATS;
+
+//
+// Mapped receive ring.  IOCTL_SERIAL_MAP_RECEIVE_RING takes a
+// SERIAL_RECEIVE_RING_MAP as its input and the ring itself as its
+// output buffer, and stays pending for as long as the ring is in use.
+// Meanwhile received characters go into the ring instead of to reads,
+// and reads fail.  The ring is handed back by
+// IOCTL_SERIAL_UNMAP_RECEIVE_RING, by cancelling the map request or by
+// closing the handle.
+//
+// Head and Tail run freely; the character at index I is in
+// Data[I & (Size - 1)].  The driver writes Head and Overruns and the
+// client writes Tail.  A client that wants to sleep sets ReaderWaiting,
+// checks Head once more and then waits on the doorbell event, which
+// the driver signals (clearing ReaderWaiting) when the next character
+// arrives.  Size is the largest power of two that fits the buffer,
+// from SERIAL_RECEIVE_RING_MIN_SIZE up to SERIAL_RECEIVE_RING_MAX_SIZE.
+//
+#define SERIAL_RECEIVE_RING_MIN_SIZE    256
+#define SERIAL_RECEIVE_RING_MAX_SIZE    (1024*1024)
+
+//
+// Segmented write.  The input buffer of IOCTL_SERIAL_WRITE_SEGMENTS is
+// a SERIAL_WRITE_SEGMENTS followed by the data; each segment gives the
+// offset of its data from the start of the input buffer and its length,
+// which can't be zero.  The segments are sent back to back as a single
+// write (same queue, timeouts and flow control) with one completion.
+// GapMicroseconds holds the line idle for at least that long after the
+// segment's last character has been sent before the next one starts,
+// rounded up to the driver's timer tick; the gap after the last segment
+// is ignored.  Write timeouts are worked out from the number of
+// characters alone.  The output buffer gets the number of characters
+// written (a ULONG).
+//
+#define SERIAL_MAX_WRITE_SEGMENTS       1024
+
+typedef struct _SERIAL_WRITE_SEGMENT {
+    ULONG Offset;
+    ULONG Length;
+    ULONG GapMicroseconds;
+} SERIAL_WRITE_SEGMENT,*PSERIAL_WRITE_SEGMENT;
+
+typedef struct _SERIAL_WRITE_SEGMENTS {
+    ULONG SegmentCount;
+    ULONG Reserved;
+    SERIAL_WRITE_SEGMENT Segments[ANYSIZE_ARRAY];
+} SERIAL_WRITE_SEGMENTS,*PSERIAL_WRITE_SEGMENTS;
+
+//
+// Receive timestamps, turned on by passing a nonzero ULONG to
+// IOCTL_SERIAL_SET_RX_TIMESTAMPS and off by passing zero.  While they
+// are on the isr reads the performance counter once each time it starts
+// draining the receive fifo, and every character that batch puts in
+// the interrupt buffer is stamped with that time.  The isr remembers
+// the last SERIAL_RX_TIMESTAMP_RUNS batches.
+//
+// IOCTL_SERIAL_READ_TIMESTAMPED takes whatever is in the interrupt
+// buffer, as much as fits the output buffer, and never waits; use
+// IOCTL_SERIAL_WAIT_ON_MASK with SERIAL_EV_RXCHAR to wait for data.  The
+// output is a SERIAL_TIMESTAMPED_READ, then RunCount runs, then
+// DataLength characters at DataOffset.  Each run covers Length
+// characters from Offset in the data that arrived in the same batch.
+// A Timestamp of zero means the time is not known: the characters came
+// in before timestamps were turned on or their batch has been
+// forgotten.  Characters that the isr puts straight into the buffer of
+// a pending read are not stamped.
+//
+#define SERIAL_RX_TIMESTAMP_RUNS        128
+
+typedef struct _SERIAL_RX_TIMESTAMP_RUN {
+    LONGLONG Timestamp;
+    ULONG Offset;
+    ULONG Length;
+} SERIAL_RX_TIMESTAMP_RUN,*PSERIAL_RX_TIMESTAMP_RUN;
+
+typedef struct _SERIAL_TIMESTAMPED_READ {
+    LONGLONG Frequency;
+    ULONG RunCount;
+    ULONG DataOffset;
+    ULONG DataLength;
+    ULONG Reserved;
+    SERIAL_RX_TIMESTAMP_RUN Runs[ANYSIZE_ARRAY];
+} SERIAL_TIMESTAMPED_READ,*PSERIAL_TIMESTAMPED_READ;
+
+//
+// The isr's record of one batch: when it was drained and the receive
+// sequence number of its first character.
+//
+typedef struct _SERIAL_RX_BATCH {
+    LONGLONG Timestamp;
+    ULONGLONG Sequence;
+} SERIAL_RX_BATCH,*PSERIAL_RX_BATCH;
+
+typedef struct _SERIAL_RECEIVE_RING_MAP {
+    ULONGLONG DoorbellEvent;
+} SERIAL_RECEIVE_RING_MAP,*PSERIAL_RECEIVE_RING_MAP;
+
+typedef struct _SERIAL_RECEIVE_RING {
+    volatile ULONG Head;
+    volatile ULONG Tail;
+    volatile LONG ReaderWaiting;
+    ULONG Size;
+    volatile ULONG Overruns;
+    ULONG Reserved[3];
+    UCHAR Data[ANYSIZE_ARRAY];
+} SERIAL_RECEIVE_RING,*PSERIAL_RECEIVE_RING;
+
+//
+// Adaptive interrupt buffer sizing, turned on by passing the largest
+// size the buffer may grow to (a ULONG) to IOCTL_SERIAL_SET_ADAPTIVE_BUFFER
+// and off by passing zero.  The receive rate is sampled every
+// SERIAL_ADAPTIVE_SAMPLE_MS and the buffer goes back to its base size
+// after SERIAL_ADAPTIVE_IDLE_SAMPLES samples in a row with nothing
+// received.
+//
+#define SERIAL_ADAPTIVE_SAMPLE_MS       250
+#define SERIAL_ADAPTIVE_IDLE_SAMPLES    8
+#define SERIAL_ADAPTIVE_MAX_BUFFER      (256*1024)
+
+
 
 typedef struct _SERIAL_DEVICE_STATE {
    //
@@ -553,6 +707,52 @@ VOID
     IN UCHAR  Value
     );
 
+//
+// Timeouts are not WDFTIMERs of their own.  Each device has a timer
+// wheel with one slot per SERIAL_WHEEL_TICK (in 100ns units) for the
+// next SERIAL_WHEEL_INNER_SLOTS ticks, an outer ring of slots each
+// covering a full turn of the inner one, and an overflow list for
+// anything further out.  Setting or cancelling a timer is a list
+// insert or remove.  A single periodic WDFTIMER advances the wheel and
+// runs whatever has expired; it only runs while a timer is set.
+//
+// All of this is protected by the device lock, which every path that
+// sets or cancels these timers already holds.
+//
+#define SERIAL_WHEEL_TICK           10000
+#define SERIAL_WHEEL_INNER_BITS     8
+#define SERIAL_WHEEL_INNER_SLOTS    (1 << SERIAL_WHEEL_INNER_BITS)
+#define SERIAL_WHEEL_OUTER_BITS     6
+#define SERIAL_WHEEL_OUTER_SLOTS    (1 << SERIAL_WHEEL_OUTER_BITS)
+#define SERIAL_WHEEL_SPAN           (SERIAL_WHEEL_INNER_SLOTS * SERIAL_WHEEL_OUTER_SLOTS)
+
+typedef struct _SERIAL_TIMER SERIAL_TIMER, *PSERIAL_TIMER;
+
+typedef
+VOID
+SERIAL_TIMER_ROUTINE(
+    IN PSERIAL_TIMER Timer
+    );
+
+typedef SERIAL_TIMER_ROUTINE *PSERIAL_TIMER_ROUTINE;
+
+struct _SERIAL_TIMER {
+    LIST_ENTRY TimerLink;
+    ULONGLONG DueTick;
+    PSERIAL_TIMER_ROUTINE Routine;
+    struct _SERIAL_DEVICE_EXTENSION *Extension;
+    BOOLEAN Queued;
+    };
+
+typedef struct _SERIAL_TIMER_WHEEL {
+    ULONGLONG CurrentTick;
+    ULONG TimersQueued;
+    BOOLEAN Running;
+    LIST_ENTRY Inner[SERIAL_WHEEL_INNER_SLOTS];
+    LIST_ENTRY Outer[SERIAL_WHEEL_OUTER_SLOTS];
+    LIST_ENTRY Overflow;
+    } SERIAL_TIMER_WHEEL,*PSERIAL_TIMER_WHEEL;
+
 typedef struct _SERIAL_DEVICE_EXTENSION {
     //
     // WDF device handle
@@ -834,6 +1034,24 @@ typedef struct _SERIAL_DEVICE_EXTENSION {
     //
     PUCHAR WriteCurrentChar;
 
+    //
+    // For a segmented write: the start of the request's buffer, the
+    // segment being sent and the number of segments and characters
+    // after it.  WriteGap is set from the end of a segment until the
+    // gap after it is over.  WriteGapIdle is set once the transmitter
+    // has emptied and the line has been idle since; the gap lasts
+    // WriteGapTime (in 100ns units) from then.
+    //
+    // These are only accessed while at interrupt level.
+    //
+    PUCHAR WriteSegmentBase;
+    PSERIAL_WRITE_SEGMENT WriteSegment;
+    ULONG WriteSegmentsLeft;
+    ULONG WriteSegmentBytesLeft;
+    LONGLONG WriteGapTime;
+    BOOLEAN WriteGap;
+    BOOLEAN WriteGapIdle;
+
     //
     // This is a buffer for the read processing.
     //
@@ -906,6 +1124,24 @@ typedef struct _SERIAL_DEVICE_EXTENSION {
     //
     ULONG BufferSizePt8;
 
+    //
+    // Adaptive buffer mode state.  AdaptiveBufferMaximum is zero when
+    // the mode is off.  AdaptiveBufferBase is what the buffer shrinks
+    // back to; it is never less than what was asked for with
+    // IOCTL_SERIAL_SET_QUEUE_SIZE.  AdaptiveRxRate is the number of
+    // characters received in the last sample period.
+    //
+    // AdaptiveGrowPending is set by the isr when it queues the grow
+    // dpc and cleared by that dpc.  The rest is only touched with the
+    // device lock held.
+    //
+    ULONG AdaptiveBufferMaximum;
+    ULONG AdaptiveBufferBase;
+    ULONG AdaptiveRxRate;
+    ULONG AdaptiveLastReceived;
+    ULONG AdaptiveIdleSamples;
+    BOOLEAN AdaptiveGrowPending;
+
     //
     // This value holds the number of characters desired for a
     // particular read.  It is initially set by read length in the
@@ -957,6 +1193,15 @@ typedef struct _SERIAL_DEVICE_EXTENSION {
     //
     ULONG *IrpMaskLocation;
 
+    //
+    // Set by the isr while it services the device.  Events noted
+    // meanwhile only go into the history mask; the isr completes the
+    // wait once on its way out, so a burst of characters costs at most
+    // one CommWaitDpc however many of them are interesting.  Only
+    // accessed at device level.
+    //
+    BOOLEAN DeferWaitEvents;
+
     //
     // This mask holds all of the reason that transmission
     // is not proceeding.  Normal transmission can not occur
@@ -1062,6 +1307,16 @@ typedef struct _SERIAL_DEVICE_EXTENSION {
     //
     SERIAL_CHARS SpecialChars;
 
+    //
+    // Nonzero for every received character value that the isr has to
+    // look at more closely: null, the xon, xoff and event characters
+    // and the escape character.  Everything else goes straight to the
+    // buffer.  Extra entries only cost a trip down the slow path, so
+    // the map is rebuilt when a special character is set but not when
+    // one is cleared.  See SerialUpdateSpecialCharMap.
+    //
+    UCHAR SpecialCharMap[256];
+
     //
     // This structure holds the handshake and control flow
     // settings for the serial driver.
@@ -1078,6 +1333,51 @@ typedef struct _SERIAL_DEVICE_EXTENSION {
     //
     SERIALPERF_STATS PerfStats;
 
+    //
+    // Number of purge requests carried out and the performance counter
+    // ticks they took.  Only touched with the device lock held.
+    //
+    ULONG PurgeCount;
+    LONGLONG PurgeTicks;
+    LONGLONG LastPurgeTicks;
+
+    //
+    // Number of users of the completion lock (the read and write
+    // completion dpcs) and the number of times one of them found the
+    // other already holding or waiting for it.  Only touched with
+    // interlocked operations.
+    //
+    LONG CompletionLockUsers;
+    LONG CompletionContentionCount;
+
+    //
+    // The mapped receive ring, if there is one: the request that owns
+    // it and its doorbell event, only touched with the device lock
+    // held; and the ring and the isr's own copies of its head, size and
+    // overrun count, so nothing the client writes to the ring can send
+    // the isr outside of it.  ReceiveRing is only set at device level.
+    //
+    WDFREQUEST ReceiveRingRequest;
+    PKEVENT ReceiveRingEvent;
+    PSERIAL_RECEIVE_RING ReceiveRing;
+    ULONG ReceiveRingHead;
+    ULONG ReceiveRingSize;
+    ULONG ReceiveRingOverruns;
+
+    //
+    // Receive timestamps; all of this is only touched at interrupt
+    // level.  RxSequence counts the characters put in the interrupt
+    // buffer since timestamps were turned on, so the characters in
+    // the buffer are always the last CharsInInterruptBuffer of them.
+    // RxBatches is a ring indexed by RxBatchCount.
+    //
+    BOOLEAN RxTimestamps;
+    BOOLEAN RxBatchOpen;
+    LONGLONG RxBatchTime;
+    ULONGLONG RxSequence;
+    ULONG RxBatchCount;
+    SERIAL_RX_BATCH RxBatches[SERIAL_RX_TIMESTAMP_RUNS];
+
     //
     // This holds what we beleive to be the current value of
     // the line control register.
@@ -1219,30 +1519,49 @@ typedef struct _SERIAL_DEVICE_EXTENSION {
     //
     WDFDPC StartTimerLowerRTSDpc;
 
+    //
+    // This dpc is fired off by the isr in adaptive buffer mode when
+    // the interrupt buffer is half way to the flow control threshold.
+    // It grows the buffer.
+    //
+    WDFDPC AdaptiveGrowDpc;
+
+    //
+    // This dpc is fired off by the isr to ring the receive ring's
+    // doorbell for a reader that is waiting on it.
+    //
+    WDFDPC ReceiveRingDpc;
+
+    //
+    // This dpc is fired off by the isr to start the timer for a
+    // gap between the segments of a segmented write.
+    //
+    WDFDPC WriteGapDpc;
+
     //
     // This timer used to handle total read request timing.
     //
-    WDFTIMER ReadRequestTotalTimer;
+    SERIAL_TIMER ReadRequestTotalTimer;
 
     //
     // This timer used to handle interval read request timing.
     //
-    WDFTIMER ReadRequestIntervalTimer;
+    SERIAL_TIMER ReadRequestIntervalTimer;
 
     //
     // This timer used to handle total write request timing.
     //
-    WDFTIMER WriteRequestTotalTimer;
+    SERIAL_TIMER WriteRequestTotalTimer;
 
     //
     // This is timer structure used to handle total time request timing.
     //
-    WDFTIMER ImmediateTotalTimer;
+    SERIAL_TIMER ImmediateTotalTimer;
 
     //
     // This timer is used to timeout the xoff counter io.
     //
-    WDFTIMER XoffCountTimer;
+    SERIAL_TIMER XoffCountTimer;
 
     //
     // This timer is used to invoke a dpc one character time
@@ -1250,7 +1569,26 @@ typedef struct _SERIAL_DEVICE_EXTENSION {
     // whether we should lower the RTS line if we are doing
     // transmit toggling.
     //
-    WDFTIMER LowerRTSTimer;
+    SERIAL_TIMER LowerRTSTimer;
+
+    //
+    // This timer ends the gap between the segments of a segmented
+    // write.
+    //
+    SERIAL_TIMER WriteGapTimer;
+
+    //
+    // The wheel the timers above are set on and the periodic timer
+    // that turns it.
+    //
+    SERIAL_TIMER_WHEEL TimerWheel;
+    WDFTIMER TimerWheelTimer;
+
+    //
+    // This periodic timer samples the receive rate and shrinks the
+    // interrupt buffer when the port idles in adaptive buffer mode.
+    //
+    WDFTIMER AdaptiveSampleTimer;
 
     //
     // WMI Information
@@ -1304,6 +1642,18 @@ typedef struct _REQUEST_CONTEXT {
 WDF_DECLARE_CONTEXT_TYPE_WITH_NAME(REQUEST_CONTEXT,
                                         SerialGetRequestContext)
 
+//
+// Extra context of a receive ring map request.  The doorbell event is
+// referenced in the caller's context and dereferenced when the request
+// goes away.
+//
+typedef struct _SERIAL_RING_REQUEST_CONTEXT {
+    PKEVENT DoorbellEvent;
+} SERIAL_RING_REQUEST_CONTEXT, *PSERIAL_RING_REQUEST_CONTEXT;
+
+WDF_DECLARE_CONTEXT_TYPE_WITH_NAME(SERIAL_RING_REQUEST_CONTEXT,
+                                        SerialGetRingRequestContext)
+
 
 //
 // This is the Interrupt context for the Serial device. This structure is used
@@ -49,6 +49,8 @@ EVT_WDF_DEVICE_RELEASE_HARDWARE SerialEvtReleaseHardware;
 
 EVT_WDF_DEVICE_FILE_CREATE SerialEvtDeviceFileCreate;
 EVT_WDF_FILE_CLOSE SerialEvtFileClose;
+EVT_WDF_FILE_CLEANUP SerialEvtFileCleanup;
+EVT_WDF_IO_IN_CALLER_CONTEXT SerialEvtIoInCallerContext;
 
 EVT_WDF_IO_QUEUE_IO_READ SerialEvtIoRead;
 EVT_WDF_IO_QUEUE_IO_WRITE SerialEvtIoWrite;
@@ -68,13 +70,19 @@ EVT_WDF_DPC SerialCompleteImmediate;
 EVT_WDF_DPC SerialCompleteXoff;
 EVT_WDF_DPC SerialCompleteWait;
 EVT_WDF_DPC SerialStartTimerLowerRTS;
+EVT_WDF_DPC SerialAdaptiveGrow;
+EVT_WDF_DPC SerialRingDoorbell;
+EVT_WDF_DPC SerialStartWriteGap;
 
-EVT_WDF_TIMER SerialReadTimeout;
-EVT_WDF_TIMER SerialIntervalReadTimeout;
-EVT_WDF_TIMER SerialWriteTimeout;
-EVT_WDF_TIMER SerialTimeoutImmediate;
-EVT_WDF_TIMER SerialTimeoutXoff;
-EVT_WDF_TIMER SerialInvokePerhapsLowerRTS;
+SERIAL_TIMER_ROUTINE SerialReadTimeout;
+SERIAL_TIMER_ROUTINE SerialIntervalReadTimeout;
+SERIAL_TIMER_ROUTINE SerialWriteTimeout;
+SERIAL_TIMER_ROUTINE SerialTimeoutImmediate;
+SERIAL_TIMER_ROUTINE SerialTimeoutXoff;
+SERIAL_TIMER_ROUTINE SerialInvokePerhapsLowerRTS;
+SERIAL_TIMER_ROUTINE SerialWriteGapTimeout;
+EVT_WDF_TIMER SerialTimerWheelTick;
+EVT_WDF_TIMER SerialAdaptiveSample;
 
 VOID
 SerialStartRead(
@@ -91,6 +99,11 @@ SerialStartMask(
     IN PSERIAL_DEVICE_EXTENSION Extension
     );
 
+VOID
+SerialSignalWaitEvents(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    );
+
 VOID
 SerialStartImmediate(
     IN PSERIAL_DEVICE_EXTENSION Extension
@@ -150,6 +163,8 @@ EVT_WDF_INTERRUPT_SYNCHRONIZE SerialSetChars;
 EVT_WDF_INTERRUPT_SYNCHRONIZE SerialSetMCRContents;
 EVT_WDF_INTERRUPT_SYNCHRONIZE SerialGetMCRContents;
 EVT_WDF_INTERRUPT_SYNCHRONIZE SerialSetFCRContents;
+EVT_WDF_INTERRUPT_SYNCHRONIZE SerialSetRxTimestamps;
+EVT_WDF_INTERRUPT_SYNCHRONIZE SerialGetRxTimestampRuns;
 
 BOOLEAN
 SerialSetupNewHandFlow(
@@ -186,6 +201,11 @@ SerialFlushRequests(
     IN WDFREQUEST *CurrentOpRequest
     );
 
+VOID
+SerialCancelCurrentRequest(
+    IN WDFREQUEST *CurrentOpRequest
+    );
+
 VOID
 SerialGetNextRequest(
     IN WDFREQUEST *CurrentOpRequest,
@@ -203,8 +223,8 @@ SerialTryToCompleteCurrent(
     IN NTSTATUS StatusToUse,
     IN WDFREQUEST *CurrentOpRequest,
     IN WDFQUEUE QueueToProcess,
-    IN WDFTIMER IntervalTimer,
-    IN WDFTIMER TotalTimer,
+    IN PSERIAL_TIMER IntervalTimer,
+    IN PSERIAL_TIMER TotalTimer,
     IN PSERIAL_START_ROUTINE Starter,
     IN PSERIAL_GET_NEXT_ROUTINE GetNextIrp,
     IN LONG RefType
@@ -408,15 +428,79 @@ SerialInsertQueueDpc(
     IN WDFDPC Dpc
     );
 
+VOID
+SerialUpdateSpecialCharMap(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    );
+
+VOID
+SerialAcquireCompletionLock(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    );
+
+VOID
+SerialReleaseCompletionLock(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    );
+
+NTSTATUS
+SerialValidateWriteSegments(
+    IN PSERIAL_WRITE_SEGMENTS Segments,
+    IN size_t BufferLength,
+    OUT PULONG TotalLength
+    );
+
+NTSTATUS
+SerialReadTimestamped(
+    IN PSERIAL_DEVICE_EXTENSION Extension,
+    IN PSERIAL_TIMESTAMPED_READ Read,
+    IN ULONG Length,
+    OUT PULONG Information
+    );
+
+VOID
+SerialNextWriteSegment(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    );
+
+NTSTATUS
+SerialMapReceiveRing(
+    IN PSERIAL_DEVICE_EXTENSION Extension,
+    IN WDFREQUEST Request
+    );
+
+VOID
+SerialUnmapReceiveRing(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    );
+
+VOID
+SerialPutRingChar(
+    IN PSERIAL_DEVICE_EXTENSION Extension,
+    IN UCHAR CharToPut
+    );
+
+VOID
+SerialInitializeTimerWheel(
+    IN PSERIAL_DEVICE_EXTENSION PDevExt
+    );
+
+VOID
+SerialInitializeTimer(
+    IN PSERIAL_TIMER Timer,
+    IN PSERIAL_DEVICE_EXTENSION PDevExt,
+    IN PSERIAL_TIMER_ROUTINE Routine
+    );
+
 BOOLEAN
 SerialSetTimer(
-    IN WDFTIMER Timer,
+    IN PSERIAL_TIMER Timer,
     IN LARGE_INTEGER DueTime
     );
 
 BOOLEAN
 SerialCancelTimer(
-    IN WDFTIMER Timer,
+    IN PSERIAL_TIMER Timer,
     IN PSERIAL_DEVICE_EXTENSION PDevExt
     );
 
@@ -529,6 +613,16 @@ typedef struct _SERIAL_IOCTL_SYNC {
     PVOID Data;
     } SERIAL_IOCTL_SYNC,*PSERIAL_IOCTL_SYNC;
 
+//
+// Used to work out the runs of a timestamped read in sync with
+// the isr.
+//
+typedef struct _SERIAL_RX_TIMESTAMP_SYNC {
+    PSERIAL_DEVICE_EXTENSION Extension;
+    PSERIAL_TIMESTAMPED_READ Read;
+    ULONG Length;
+    } SERIAL_RX_TIMESTAMP_SYNC,*PSERIAL_RX_TIMESTAMP_SYNC;
+
 
 //
 // The following three macros are used to initialize, set
@@ -34,12 +34,30 @@ Environment:
 VOID
 SerialRundownIrpRefs(
     IN WDFREQUEST *CurrentOpRequest,
-    IN WDFTIMER IntervalTimer,
-    IN WDFTIMER TotalTimer,
+    IN PSERIAL_TIMER IntervalTimer,
+    IN PSERIAL_TIMER TotalTimer,
     IN PSERIAL_DEVICE_EXTENSION PDevExt,
     IN LONG RefType
     );
 
+VOID
+SerialInsertWheelTimer(
+    IN PSERIAL_TIMER_WHEEL Wheel,
+    IN PSERIAL_TIMER Timer
+    );
+
+VOID
+SerialCascadeWheelTimers(
+    IN PSERIAL_TIMER_WHEEL Wheel,
+    IN PLIST_ENTRY Slot
+    );
+
+VOID
+SerialResyncTimerWheel(
+    IN PSERIAL_TIMER_WHEEL Wheel,
+    IN ULONGLONG Now
+    );
+
 static const PHYSICAL_ADDRESS SerialPhysicalZero = {0};
 
 VOID
@@ -68,9 +86,6 @@ Return Value:
 --*/
 
 {
-    NTSTATUS status;
-    PREQUEST_CONTEXT reqContext;
-
     WdfIoQueuePurge(QueueToClean, WDF_NO_EVENT_CALLBACK, WDF_NO_CONTEXT);
 
     //
@@ -78,6 +93,36 @@ Return Value:
     // it's there.
     //
 
+    SerialCancelCurrentRequest(CurrentOpRequest);
+}
+
+VOID
+SerialCancelCurrentRequest(
+    IN WDFREQUEST *CurrentOpRequest
+    )
+
+/*++
+
+Routine Description:
+
+    This function is used to cancel the current read or write request,
+    if there is one, through its own cancel routine.  Called at DPC
+    level.
+
+Arguments:
+
+    CurrentOpRequest - Pointer to a pointer to the current request.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    NTSTATUS status;
+    PREQUEST_CONTEXT reqContext;
+
     if (*CurrentOpRequest) {
 
         PFN_WDF_REQUEST_CANCEL CancelRoutine;
@@ -126,6 +171,25 @@ Return Value:
 --*/
 
 {
+    ULONG queuedRequests;
+
+    //
+    // Requests only get into these queues from our own dispatch code,
+    // which is serialized with us, so an empty queue stays empty.
+    // Skip taking it through the purged and started states for
+    // nothing; a port that is purged after every command usually has
+    // at most the current request to cancel.
+    //
+
+    WdfIoQueueGetState(QueueToClean, &queuedRequests, NULL);
+
+    if (!queuedRequests) {
+
+        SerialCancelCurrentRequest(CurrentOpRequest);
+        return;
+
+    }
+
     SerialPurgeRequests(QueueToClean,  CurrentOpRequest);
 
     //
@@ -227,8 +291,8 @@ SerialTryToCompleteCurrent(
     IN NTSTATUS StatusToUse,
     IN WDFREQUEST *CurrentOpRequest,
     IN WDFQUEUE QueueToProcess OPTIONAL,
-    IN WDFTIMER IntervalTimer OPTIONAL,
-    IN WDFTIMER TotalTimer OPTIONAL,
+    IN PSERIAL_TIMER IntervalTimer OPTIONAL,
+    IN PSERIAL_TIMER TotalTimer OPTIONAL,
     IN PSERIAL_START_ROUTINE Starter OPTIONAL,
     IN PSERIAL_GET_NEXT_ROUTINE GetNextRequest OPTIONAL,
     IN LONG RefType
@@ -516,8 +580,8 @@ Return Value:
 VOID
 SerialRundownIrpRefs(
     IN WDFREQUEST *CurrentOpRequest,
-    IN WDFTIMER IntervalTimer OPTIONAL,
-    IN WDFTIMER TotalTimer OPTIONAL,
+    IN PSERIAL_TIMER IntervalTimer OPTIONAL,
+    IN PSERIAL_TIMER TotalTimer OPTIONAL,
     IN PSERIAL_DEVICE_EXTENSION PDevExt,
     IN LONG RefType
     )
@@ -711,7 +775,9 @@ Return Value:
     // to write and add it to the count of characters to write.
     //
 
-    if (params.Type == WdfRequestTypeWrite) {
+    if ((params.Type == WdfRequestTypeWrite) ||
+        ((params.Type == WdfRequestTypeDeviceControl) &&
+         (params.Parameters.DeviceIoControl.IoControlCode == IOCTL_SERIAL_WRITE_SEGMENTS))) {
 
         Extension->TotalCharsQueued += reqContext->Length;
 
@@ -932,14 +998,16 @@ Return Value:
    WDF_OBJECT_ATTRIBUTES timerAttributes;
 
    //
-   // Initialize all the timers used to timeout operations.
-   //
-   //
-   // This timer dpc is fired off if the timer for the total timeout
-   // for the read expires.  It will cause the current read to complete.
+   // Initialize all the timers used to timeout operations.  They are
+   // all set on the device's timer wheel, so the only WDFTIMER needed
+   // is the one that turns the wheel.
    //
 
-   WDF_TIMER_CONFIG_INIT(&timerConfig, SerialReadTimeout);
+   SerialInitializeTimerWheel(pDevExt);
+
+   WDF_TIMER_CONFIG_INIT_PERIODIC(&timerConfig,
+                                  SerialTimerWheelTick,
+                                  SERIAL_WHEEL_TICK / 10000);
 
    timerConfig.AutomaticSerialization = TRUE;
 
@@ -948,130 +1016,83 @@ Return Value:
 
    status = WdfTimerCreate(&timerConfig,
                            &timerAttributes,
-                                    &pDevExt->ReadRequestTotalTimer);
+                           &pDevExt->TimerWheelTimer);
 
    if (!NT_SUCCESS(status)) {
-      SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfTimerCreate(ReadRequestTotalTimer) failed  [%#08lx]\n",   status);
+      SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfTimerCreate(TimerWheelTimer) failed  [%#08lx]\n",   status);
       return status;
    }
 
    //
-   // This dpc is fired off if the timer for the interval timeout
-   // expires.  If no more characters have been read then the
-   // dpc routine will cause the read to complete.  However, if
-   // more characters have been read then the dpc routine will
-   // resubmit the timer.
+   // This timer fires if the total timeout for the read expires.
+   // It will cause the current read to complete.
    //
-   WDF_TIMER_CONFIG_INIT(&timerConfig,   SerialIntervalReadTimeout);
-
-   timerConfig.AutomaticSerialization = TRUE;
 
-   WDF_OBJECT_ATTRIBUTES_INIT(&timerAttributes);
-   timerAttributes.ParentObject = pDevExt->WdfDevice;
-
-   status = WdfTimerCreate(&timerConfig,
-                           &timerAttributes,
-                                        &pDevExt->ReadRequestIntervalTimer);
-
-   if (!NT_SUCCESS(status)) {
-      SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfTimerCreate(ReadRequestIntervalTimer) failed  [%#08lx]\n",   status);
-      return status;
-   }
+   SerialInitializeTimer(&pDevExt->ReadRequestTotalTimer, pDevExt,
+                         SerialReadTimeout);
 
    //
-   // This dpc is fired off if the timer for the total timeout
-   // for the write expires.  It will queue a dpc routine that
-   // will cause the current write to complete.
+   // This timer fires if the interval timeout expires.  If no more
+   // characters have been read then it will cause the read to
+   // complete.  However, if more characters have been read then it
+   // will set itself again.
    //
-   //
-
-   WDF_TIMER_CONFIG_INIT(&timerConfig,    SerialWriteTimeout);
 
-   timerConfig.AutomaticSerialization = TRUE;
-
-   WDF_OBJECT_ATTRIBUTES_INIT(&timerAttributes);
-   timerAttributes.ParentObject = pDevExt->WdfDevice;
-
-   status = WdfTimerCreate(&timerConfig,
-                                &timerAttributes,
-                                &pDevExt->WriteRequestTotalTimer);
-
-   if (!NT_SUCCESS(status)) {
-      SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfTimerCreate(WriteRequestTotalTimer) failed  [%#08lx]\n",   status);
-      return status;
-   }
+   SerialInitializeTimer(&pDevExt->ReadRequestIntervalTimer, pDevExt,
+                         SerialIntervalReadTimeout);
 
    //
-   // This dpc is fired off if the transmit immediate char
-   // character times out.  The dpc routine will "grab" the
-   // request from the isr and time it out.
+   // This timer fires if the total timeout for the write expires.
+   // It will cause the current write to complete.
    //
-   WDF_TIMER_CONFIG_INIT(&timerConfig,   SerialTimeoutImmediate);
-
-   timerConfig.AutomaticSerialization = TRUE;
 
-   WDF_OBJECT_ATTRIBUTES_INIT(&timerAttributes);
-   timerAttributes.ParentObject = pDevExt->WdfDevice;
+   SerialInitializeTimer(&pDevExt->WriteRequestTotalTimer, pDevExt,
+                         SerialWriteTimeout);
 
-   status = WdfTimerCreate(&timerConfig,
-                           &timerAttributes,
-                                        &pDevExt->ImmediateTotalTimer);
+   //
+   // This timer fires if the transmit immediate char times out.  It
+   // will "grab" the request from the isr and time it out.
+   //
 
-   if (!NT_SUCCESS(status)) {
-      SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfTimerCreate(ImmediateTotalTimer) failed  [%#08lx]\n",   status);
-      return status;
-   }
+   SerialInitializeTimer(&pDevExt->ImmediateTotalTimer, pDevExt,
+                         SerialTimeoutImmediate);
 
    //
-   // This dpc is fired off if the timer used to "timeout" counting
+   // This timer fires if the timer used to "timeout" counting
    // the number of characters received after the Xoff ioctl is started
    // expired.
    //
 
-   WDF_TIMER_CONFIG_INIT(&timerConfig,   SerialTimeoutXoff);
-
-   timerConfig.AutomaticSerialization = TRUE;
-
-   WDF_OBJECT_ATTRIBUTES_INIT(&timerAttributes);
-   timerAttributes.ParentObject = pDevExt->WdfDevice;
+   SerialInitializeTimer(&pDevExt->XoffCountTimer, pDevExt,
+                         SerialTimeoutXoff);
 
-   status = WdfTimerCreate(&timerConfig,
-                                    &timerAttributes,
-                                    &pDevExt->XoffCountTimer);
+   //
+   // This timer fires one character time after it is set, so that
+   // code can be invoked that will check to see if we should lower
+   // the RTS line when doing transmit toggling.
+   //
 
-    if (!NT_SUCCESS(status)) {
-      SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfTimerCreate(XoffCountTimer) failed  [%#08lx]\n",   status);
-      return status;
-   }
+   SerialInitializeTimer(&pDevExt->LowerRTSTimer, pDevExt,
+                         SerialInvokePerhapsLowerRTS);
 
    //
-   // This dpc is fired off when a timer expires (after one
-   // character time), so that code can be invoked that will
-   // check to see if we should lower the RTS line when
-   // doing transmit toggling.
+   // This timer fires at the end of a gap between the segments of
+   // a segmented write and lets the isr carry on with the write.
    //
-   WDF_TIMER_CONFIG_INIT(&timerConfig,  SerialInvokePerhapsLowerRTS);
 
-   timerConfig.AutomaticSerialization = TRUE;
-
-   WDF_OBJECT_ATTRIBUTES_INIT(&timerAttributes);
-   timerAttributes.ParentObject = pDevExt->WdfDevice;
-
-   status = WdfTimerCreate(&timerConfig,
-                           &timerAttributes,
-                                    &pDevExt->LowerRTSTimer);
-    if (!NT_SUCCESS(status)) {
-        SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfTimerCreate(LowerRTSTimer) failed  [%#08lx]\n",   status);
-        return status;
-    }
+   SerialInitializeTimer(&pDevExt->WriteGapTimer, pDevExt,
+                         SerialWriteGapTimeout);
 
     //
-    // Create a DPC to complete read requests.
+    // Create a DPC to complete write requests.  The read and write
+    // completion dpcs take the device lock themselves (see
+    // SerialAcquireCompletionLock) so they are not automatically
+    // serialized.
     //
 
    WDF_DPC_CONFIG_INIT(&dpcConfig, SerialCompleteWrite);
 
-   dpcConfig.AutomaticSerialization = TRUE;
+   dpcConfig.AutomaticSerialization = FALSE;
 
    WDF_OBJECT_ATTRIBUTES_INIT(&dpcAttributes);
    dpcAttributes.ParentObject = pDevExt->WdfDevice;
@@ -1092,7 +1113,7 @@ Return Value:
 
     WDF_DPC_CONFIG_INIT(&dpcConfig, SerialCompleteRead);
 
-    dpcConfig.AutomaticSerialization = TRUE;
+    dpcConfig.AutomaticSerialization = FALSE;
 
     WDF_OBJECT_ATTRIBUTES_INIT(&dpcAttributes);
     dpcAttributes.ParentObject = pDevExt->WdfDevice;
@@ -1211,6 +1232,84 @@ Return Value:
         return status;
     }
 
+    //
+    // This dpc is fired off by the isr to grow the interrupt buffer
+    // in adaptive buffer mode.
+    //
+    WDF_DPC_CONFIG_INIT(&dpcConfig, SerialAdaptiveGrow);
+
+    dpcConfig.AutomaticSerialization = TRUE;
+
+    WDF_OBJECT_ATTRIBUTES_INIT(&dpcAttributes);
+    dpcAttributes.ParentObject = pDevExt->WdfDevice;
+
+    status = WdfDpcCreate(&dpcConfig,
+                                &dpcAttributes,
+                                &pDevExt->AdaptiveGrowDpc);
+    if (!NT_SUCCESS(status)) {
+        SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfDpcCreate(AdaptiveGrowDpc) failed  [%#08lx]\n",   status);
+        return status;
+    }
+
+    //
+    // This dpc is fired off by the isr to wake a reader waiting on
+    // the mapped receive ring.
+    //
+    WDF_DPC_CONFIG_INIT(&dpcConfig, SerialRingDoorbell);
+
+    dpcConfig.AutomaticSerialization = TRUE;
+
+    WDF_OBJECT_ATTRIBUTES_INIT(&dpcAttributes);
+    dpcAttributes.ParentObject = pDevExt->WdfDevice;
+
+    status = WdfDpcCreate(&dpcConfig,
+                                &dpcAttributes,
+                                &pDevExt->ReceiveRingDpc);
+    if (!NT_SUCCESS(status)) {
+        SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfDpcCreate(ReceiveRingDpc) failed  [%#08lx]\n",   status);
+        return status;
+    }
+
+    //
+    // This dpc is fired off by the isr to time a gap between the
+    // segments of a segmented write.
+    //
+    WDF_DPC_CONFIG_INIT(&dpcConfig, SerialStartWriteGap);
+
+    dpcConfig.AutomaticSerialization = TRUE;
+
+    WDF_OBJECT_ATTRIBUTES_INIT(&dpcAttributes);
+    dpcAttributes.ParentObject = pDevExt->WdfDevice;
+
+    status = WdfDpcCreate(&dpcConfig,
+                                &dpcAttributes,
+                                &pDevExt->WriteGapDpc);
+    if (!NT_SUCCESS(status)) {
+        SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfDpcCreate(WriteGapDpc) failed  [%#08lx]\n",   status);
+        return status;
+    }
+
+    //
+    // This timer samples the receive rate while adaptive buffer mode
+    // is on.
+    //
+    WDF_TIMER_CONFIG_INIT_PERIODIC(&timerConfig,
+                                   SerialAdaptiveSample,
+                                   SERIAL_ADAPTIVE_SAMPLE_MS);
+
+    timerConfig.AutomaticSerialization = TRUE;
+
+    WDF_OBJECT_ATTRIBUTES_INIT(&timerAttributes);
+    timerAttributes.ParentObject = pDevExt->WdfDevice;
+
+    status = WdfTimerCreate(&timerConfig,
+                           &timerAttributes,
+                                    &pDevExt->AdaptiveSampleTimer);
+    if (!NT_SUCCESS(status)) {
+        SerialDbgPrintEx(TRACE_LEVEL_ERROR, DBG_PNP,  "WdfTimerCreate(AdaptiveSampleTimer) failed  [%#08lx]\n",   status);
+        return status;
+    }
+
     return status;
 }
 
@@ -1244,33 +1343,513 @@ Return Value:
 }
 
 
+VOID
+SerialAcquireCompletionLock(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    )
+/*++
+
+Routine Description:
+
+   This function is called by the read and write completion dpcs in
+   place of automatic serialization.  It acquires the same device
+   lock, but first notes whether the other completion dpc already
+   holds or is waiting for it, and counts that as contention.
+
+Arguments:
+
+   Extension - Pointer to the device extension for the device
+
+Return Value:
+
+   None.
+
+--*/
+{
+    if (InterlockedIncrement(&Extension->CompletionLockUsers) > 1) {
+        InterlockedIncrement(&Extension->CompletionContentionCount);
+    }
+
+    WdfObjectAcquireLock(Extension->WdfDevice);
+}
+
+
+VOID
+SerialReleaseCompletionLock(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    )
+/*++
+
+Routine Description:
+
+   Releases the lock acquired by SerialAcquireCompletionLock.
+
+Arguments:
+
+   Extension - Pointer to the device extension for the device
+
+Return Value:
+
+   None.
+
+--*/
+{
+    WdfObjectReleaseLock(Extension->WdfDevice);
+
+    InterlockedDecrement(&Extension->CompletionLockUsers);
+}
+
+
+VOID
+SerialUpdateSpecialCharMap(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    )
+/*++
+
+Routine Description:
+
+   This function rebuilds the map the isr uses to tell ordinary
+   received characters from ones that might need special handling.
+
+   It must be called at interrupt level (from a synchronize routine)
+   once the device is running, since the isr reads the map.
+
+Arguments:
+
+   Extension - Pointer to the device extension for the device
+
+Return Value:
+
+   None.
+
+--*/
+{
+    RtlZeroMemory(Extension->SpecialCharMap,
+                  sizeof(Extension->SpecialCharMap));
+
+    Extension->SpecialCharMap[0] = 1;
+    Extension->SpecialCharMap[Extension->SpecialChars.XonChar] = 1;
+    Extension->SpecialCharMap[Extension->SpecialChars.XoffChar] = 1;
+    Extension->SpecialCharMap[Extension->SpecialChars.EventChar] = 1;
+    Extension->SpecialCharMap[Extension->EscapeChar] = 1;
+}
+
+
+VOID
+SerialInitializeTimerWheel(
+    IN PSERIAL_DEVICE_EXTENSION PDevExt
+    )
+/*++
+
+Routine Description:
+
+   This function initializes the device's timer wheel to empty.
+
+Arguments:
+
+   PDevExt - Pointer to the device extension for the device
+
+Return Value:
+
+   None.
+
+--*/
+{
+    PSERIAL_TIMER_WHEEL wheel = &PDevExt->TimerWheel;
+    ULONG i;
+
+    wheel->CurrentTick = 0;
+    wheel->TimersQueued = 0;
+    wheel->Running = FALSE;
+
+    for (i = 0; i < SERIAL_WHEEL_INNER_SLOTS; i++) {
+        InitializeListHead(&wheel->Inner[i]);
+    }
+
+    for (i = 0; i < SERIAL_WHEEL_OUTER_SLOTS; i++) {
+        InitializeListHead(&wheel->Outer[i]);
+    }
+
+    InitializeListHead(&wheel->Overflow);
+}
+
+
+VOID
+SerialInitializeTimer(
+    IN PSERIAL_TIMER Timer,
+    IN PSERIAL_DEVICE_EXTENSION PDevExt,
+    IN PSERIAL_TIMER_ROUTINE Routine
+    )
+/*++
+
+Routine Description:
+
+   This function initializes a timer that is set on the device's timer
+   wheel with SerialSetTimer.
+
+Arguments:
+
+   Timer - The timer to initialize
+
+   PDevExt - Pointer to the device extension for the device
+
+   Routine - What to call when the timer expires
+
+Return Value:
+
+   None.
+
+--*/
+{
+    InitializeListHead(&Timer->TimerLink);
+    Timer->DueTick = 0;
+    Timer->Routine = Routine;
+    Timer->Extension = PDevExt;
+    Timer->Queued = FALSE;
+}
+
+
+VOID
+SerialInsertWheelTimer(
+    IN PSERIAL_TIMER_WHEEL Wheel,
+    IN PSERIAL_TIMER Timer
+    )
+/*++
+
+Routine Description:
+
+   This function puts a timer in the wheel slot for its due tick.  A
+   timer due on the current tick (only possible when cascading) goes
+   in the slot about to be run.
+
+Arguments:
+
+   Wheel - The device's timer wheel
+
+   Timer - The timer, with DueTick set
+
+Return Value:
+
+   None.
+
+--*/
+{
+    ULONGLONG distance = Timer->DueTick - Wheel->CurrentTick;
+    PLIST_ENTRY slot;
+
+    ASSERT(Timer->DueTick >= Wheel->CurrentTick);
+
+    if (distance < SERIAL_WHEEL_INNER_SLOTS) {
+
+        slot = &Wheel->Inner[Timer->DueTick & (SERIAL_WHEEL_INNER_SLOTS - 1)];
+
+    } else if (distance < SERIAL_WHEEL_SPAN) {
+
+        slot = &Wheel->Outer[(Timer->DueTick >> SERIAL_WHEEL_INNER_BITS) &
+                             (SERIAL_WHEEL_OUTER_SLOTS - 1)];
+
+    } else {
+
+        slot = &Wheel->Overflow;
+
+    }
+
+    InsertTailList(slot, &Timer->TimerLink);
+}
+
+
+VOID
+SerialCascadeWheelTimers(
+    IN PSERIAL_TIMER_WHEEL Wheel,
+    IN PLIST_ENTRY Slot
+    )
+/*++
+
+Routine Description:
+
+   This function moves the timers in an outer slot (or the overflow
+   list) closer in, now that the wheel has come round to them.
+
+Arguments:
+
+   Wheel - The device's timer wheel
+
+   Slot - The list to cascade
+
+Return Value:
+
+   None.
+
+--*/
+{
+    LIST_ENTRY cascade;
+    PSERIAL_TIMER timer;
+
+    if (IsListEmpty(Slot)) {
+        return;
+    }
+
+    //
+    // Move the whole list aside first; some of the timers may land
+    // right back in it.
+    //
+
+    cascade = *Slot;
+    cascade.Flink->Blink = &cascade;
+    cascade.Blink->Flink = &cascade;
+    InitializeListHead(Slot);
+
+    while (!IsListEmpty(&cascade)) {
+        timer = CONTAINING_RECORD(RemoveHeadList(&cascade),
+                                  SERIAL_TIMER, TimerLink);
+        SerialInsertWheelTimer(Wheel, timer);
+    }
+}
+
+
+VOID
+SerialResyncTimerWheel(
+    IN PSERIAL_TIMER_WHEEL Wheel,
+    IN ULONGLONG Now
+    )
+/*++
+
+Routine Description:
+
+   This function is used when the wheel has fallen more than a full
+   turn behind (the tick timer was held off, or the machine slept).
+   Rather than stepping through every missed tick, every timer is
+   put back at its place relative to Now.  Timers that are already
+   due end up in the slot for Now and run on this tick.
+
+Arguments:
+
+   Wheel - The device's timer wheel
+
+   Now - The current tick
+
+Return Value:
+
+   None.
+
+--*/
+{
+    LIST_ENTRY all;
+    PSERIAL_TIMER timer;
+    ULONG i;
+
+    InitializeListHead(&all);
+
+    for (i = 0; i < SERIAL_WHEEL_INNER_SLOTS; i++) {
+        while (!IsListEmpty(&Wheel->Inner[i])) {
+            InsertTailList(&all, RemoveHeadList(&Wheel->Inner[i]));
+        }
+    }
+
+    for (i = 0; i < SERIAL_WHEEL_OUTER_SLOTS; i++) {
+        while (!IsListEmpty(&Wheel->Outer[i])) {
+            InsertTailList(&all, RemoveHeadList(&Wheel->Outer[i]));
+        }
+    }
+
+    while (!IsListEmpty(&Wheel->Overflow)) {
+        InsertTailList(&all, RemoveHeadList(&Wheel->Overflow));
+    }
+
+    //
+    // The tick loop advances before running a slot, so leave the wheel
+    // one tick behind Now.
+    //
+
+    Wheel->CurrentTick = Now - 1;
+
+    while (!IsListEmpty(&all)) {
+        timer = CONTAINING_RECORD(RemoveHeadList(&all),
+                                  SERIAL_TIMER, TimerLink);
+
+        if (timer->DueTick <= Now) {
+            timer->DueTick = Now;
+        }
+
+        SerialInsertWheelTimer(Wheel, timer);
+    }
+}
+
+
+VOID
+SerialTimerWheelTick(
+    IN WDFTIMER Timer
+    )
+/*++
+
+Routine Description:
+
+   This periodic timer turns the device's timer wheel up to the
+   current time, running every timer that expires on the way.  It is
+   automatically serialized, so the timer routines run with the device
+   lock held just as the WDFTIMER callbacks they replace did.  It stops
+   itself once no timer is left on the wheel.
+
+Arguments:
+
+   Timer - The wheel timer; its parent is the device.
+
+Return Value:
+
+   None.
+
+--*/
+{
+    PSERIAL_DEVICE_EXTENSION extension;
+    PSERIAL_TIMER_WHEEL wheel;
+    PSERIAL_TIMER timer;
+    PLIST_ENTRY slot;
+    ULONGLONG now;
+
+    extension = SerialGetDeviceExtension(WdfTimerGetParentObject(Timer));
+    wheel = &extension->TimerWheel;
+
+    now = KeQueryInterruptTime() / SERIAL_WHEEL_TICK;
+
+    if (wheel->TimersQueued && (now - wheel->CurrentTick) > SERIAL_WHEEL_SPAN) {
+        SerialResyncTimerWheel(wheel, now);
+    }
+
+    while (wheel->TimersQueued && (wheel->CurrentTick < now)) {
+
+        wheel->CurrentTick++;
+
+        if ((wheel->CurrentTick & (SERIAL_WHEEL_INNER_SLOTS - 1)) == 0) {
+
+            if ((wheel->CurrentTick & (SERIAL_WHEEL_SPAN - 1)) == 0) {
+                SerialCascadeWheelTimers(wheel, &wheel->Overflow);
+            }
+
+            SerialCascadeWheelTimers(
+                wheel,
+                &wheel->Outer[(wheel->CurrentTick >> SERIAL_WHEEL_INNER_BITS) &
+                              (SERIAL_WHEEL_OUTER_SLOTS - 1)]
+                );
+        }
+
+        slot = &wheel->Inner[wheel->CurrentTick & (SERIAL_WHEEL_INNER_SLOTS - 1)];
+
+        while (!IsListEmpty(slot)) {
+
+            timer = CONTAINING_RECORD(RemoveHeadList(slot),
+                                      SERIAL_TIMER, TimerLink);
+            InitializeListHead(&timer->TimerLink);
+            timer->Queued = FALSE;
+            wheel->TimersQueued--;
+
+            //
+            // The routine may set or cancel any timer, itself included.
+            // A timer set now is due on a later tick, so it can't end
+            // up back in this slot.
+            //
+
+            timer->Routine(timer);
+        }
+    }
+
+    if (!wheel->TimersQueued) {
+
+        wheel->CurrentTick = now;
+        wheel->Running = FALSE;
+        WdfTimerStop(Timer, FALSE);
+
+    }
+}
+
 
 BOOLEAN
-SerialSetTimer(IN WDFTIMER Timer, IN LARGE_INTEGER DueTime)
+SerialSetTimer(
+    IN PSERIAL_TIMER Timer,
+    IN LARGE_INTEGER DueTime
+    )
 /*++
 
 Routine Description:
 
    This function must be called to set timers for the serial driver.
+   The timer is put on the device's timer wheel, starting the wheel
+   if it wasn't running.  The due time is rounded up to the next tick
+   and is never less than one tick, so a timer that keeps setting
+   itself with a tiny interval runs once per tick rather than as
+   fast as the system can reprogram a timer.
+
+   NOTE: This must be called with the device lock held.
 
 Arguments:
 
-   Timer - pointer to timer dispatcher object
+   Timer - The timer to set
 
-   DueTime - time at which the timer should expire
+   DueTime - time at which the timer should expire, relative if
+             negative, as for KeSetTimer
 
 
 Return Value:
 
-   Kicks up return value from KeSetTimerEx()
+   TRUE if the timer was already set (it has been moved to the new
+   due time), FALSE otherwise.
 
 --*/
 {
+    PSERIAL_TIMER_WHEEL wheel = &Timer->Extension->TimerWheel;
+    LONGLONG delay;
+    LARGE_INTEGER systemTime;
+    ULONGLONG interruptTime;
     BOOLEAN result;
-    //
-    // If the timer object was already in the system timer queue, WdfTimerStart returns TRUE
-    //
-    result = WdfTimerStart(Timer, DueTime.QuadPart);
+
+    result = Timer->Queued;
+
+    if (result) {
+        RemoveEntryList(&Timer->TimerLink);
+        wheel->TimersQueued--;
+    }
+
+    if (DueTime.QuadPart < 0) {
+
+        delay = -DueTime.QuadPart;
+
+    } else {
+
+        KeQuerySystemTime(&systemTime);
+        delay = DueTime.QuadPart - systemTime.QuadPart;
+
+        if (delay < 0) {
+            delay = 0;
+        }
+
+    }
+
+    interruptTime = KeQueryInterruptTime();
+
+    if (!wheel->Running) {
+
+        //
+        // Nothing is on the wheel, so it can simply be moved up to now.
+        //
+
+        ASSERT(wheel->TimersQueued == 0);
+        wheel->CurrentTick = interruptTime / SERIAL_WHEEL_TICK;
+        wheel->Running = TRUE;
+
+        WdfTimerStart(Timer->Extension->TimerWheelTimer,
+                      WDF_REL_TIMEOUT_IN_MS(SERIAL_WHEEL_TICK / 10000));
+
+    }
+
+    Timer->DueTick = (interruptTime + delay + SERIAL_WHEEL_TICK - 1) /
+                     SERIAL_WHEEL_TICK;
+
+    if (Timer->DueTick <= wheel->CurrentTick) {
+        Timer->DueTick = wheel->CurrentTick + 1;
+    }
+
+    SerialInsertWheelTimer(wheel, Timer);
+    Timer->Queued = TRUE;
+    wheel->TimersQueued++;
 
     return result;
 
@@ -1297,17 +1876,10 @@ Return Value:
 
 --*/
 {
-    WdfTimerStop(PDevExt->ReadRequestTotalTimer, TRUE);
-
-    WdfTimerStop(PDevExt->ReadRequestIntervalTimer, TRUE);
-
-    WdfTimerStop(PDevExt->WriteRequestTotalTimer, TRUE);
-
-    WdfTimerStop(PDevExt->ImmediateTotalTimer, TRUE);
-
-    WdfTimerStop(PDevExt->XoffCountTimer, TRUE);
-
-    WdfTimerStop(PDevExt->LowerRTSTimer, TRUE);
+    //
+    // The dpcs go first.  A completion dpc that is already running may
+    // still set a timer and so start the wheel again.
+    //
 
     WdfDpcCancel(PDevExt->CompleteWriteDpc, TRUE);
 
@@ -1323,6 +1895,44 @@ Return Value:
 
     WdfDpcCancel(PDevExt->StartTimerLowerRTSDpc, TRUE);
 
+    WdfDpcCancel(PDevExt->AdaptiveGrowDpc, TRUE);
+
+    WdfDpcCancel(PDevExt->ReceiveRingDpc, TRUE);
+
+    WdfDpcCancel(PDevExt->WriteGapDpc, TRUE);
+
+    //
+    // Then wait for a wheel tick that may already be running.  Only once
+    // it is over can the wheel be emptied and marked stopped, under the
+    // lock the wheel runs with, without a tick starting it up again.
+    //
+
+    WdfTimerStop(PDevExt->TimerWheelTimer, TRUE);
+
+    WdfTimerStop(PDevExt->AdaptiveSampleTimer, TRUE);
+
+    WdfObjectAcquireLock(PDevExt->WdfDevice);
+
+    SerialCancelTimer(&PDevExt->ReadRequestTotalTimer, PDevExt);
+
+    SerialCancelTimer(&PDevExt->ReadRequestIntervalTimer, PDevExt);
+
+    SerialCancelTimer(&PDevExt->WriteRequestTotalTimer, PDevExt);
+
+    SerialCancelTimer(&PDevExt->ImmediateTotalTimer, PDevExt);
+
+    SerialCancelTimer(&PDevExt->XoffCountTimer, PDevExt);
+
+    SerialCancelTimer(&PDevExt->LowerRTSTimer, PDevExt);
+
+    SerialCancelTimer(&PDevExt->WriteGapTimer, PDevExt);
+
+    ASSERT(PDevExt->TimerWheel.TimersQueued == 0);
+
+    SerialInitializeTimerWheel(PDevExt);
+
+    WdfObjectReleaseLock(PDevExt->WdfDevice);
+
     return;
 }
 
@@ -1330,7 +1940,7 @@ Return Value:
 
 BOOLEAN
 SerialCancelTimer(
-    IN WDFTIMER                 Timer,
+    IN PSERIAL_TIMER            Timer,
     IN PSERIAL_DEVICE_EXTENSION PDevExt
     )
 /*++
@@ -1338,10 +1948,14 @@ SerialCancelTimer(
 Routine Description:
 
    This function must be called to cancel timers for the serial driver.
+   The wheel itself is left running; it stops on its next tick if
+   nothing else is set.
+
+   NOTE: This must be called with the device lock held.
 
 Arguments:
 
-   Timer - pointer to timer dispatcher object
+   Timer - The timer to cancel
 
    PDevExt - Pointer to the device extension for the device that needs to
              set a timer
@@ -1352,9 +1966,16 @@ Return Value:
 
 --*/
 {
-    UNREFERENCED_PARAMETER(PDevExt);
+    if (!Timer->Queued) {
+        return FALSE;
+    }
+
+    RemoveEntryList(&Timer->TimerLink);
+    InitializeListHead(&Timer->TimerLink);
+    Timer->Queued = FALSE;
+    PDevExt->TimerWheel.TimersQueued--;
 
-    return WdfTimerStop(Timer, FALSE);
+    return TRUE;
 }
 
 SERIAL_MEM_COMPARES
@@ -497,6 +497,55 @@ Return Value:
     return FALSE;
 }
 
+VOID
+SerialSignalWaitEvents(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    )
+
+/*++
+
+Routine Description:
+
+    This routine completes the current wait if the isr still owns it
+    and any of the events it waits on have occurred.  While the isr is
+    servicing the device it does nothing; the isr calls it once more
+    when it is done, so all the events of one pass go out together
+    with a single queueing of the CommWaitDpc.
+
+    NOTE: This is only called at device level.
+
+Arguments:
+
+    Extension - A pointer to the device extension.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+
+    if (Extension->DeferWaitEvents) {
+        return;
+    }
+
+    if (Extension->IrpMaskLocation && Extension->HistoryMask) {
+
+        *Extension->IrpMaskLocation = Extension->HistoryMask;
+        Extension->IrpMaskLocation = NULL;
+        Extension->HistoryMask = 0;
+
+        SerialGetRequestContext(Extension->CurrentWaitRequest)->Information =
+            sizeof(ULONG);
+        SerialInsertQueueDpc(
+            Extension->CommWaitDpc
+            );
+
+    }
+
+}
+
 VOID
 SerialCancelWait(
      IN WDFREQUEST Request
@@ -29,10 +29,7 @@ EVT_WDF_INTERRUPT_SYNCHRONIZE SerialGiveWriteToIsr;
 EVT_WDF_INTERRUPT_SYNCHRONIZE SerialGiveXoffToIsr;
 EVT_WDF_INTERRUPT_SYNCHRONIZE SerialGrabWriteFromIsr;
 EVT_WDF_INTERRUPT_SYNCHRONIZE SerialGrabXoffFromIsr;
-
-
-PUINT64 g_Buffer = 0;
-
+EVT_WDF_INTERRUPT_SYNCHRONIZE SerialEndWriteGap;
 
 VOID
 SerialEvtIoWrite(
@@ -66,14 +63,6 @@ Return Value:
 --*/
 
 {
-    if (g_Buffer == 0)
-    {
-        g_Buffer = (PUINT64)ExAllocatePoolWithTag(NonPagedPool, PAGE_SIZE, 0x41414141);
-        RtlZeroMemory(g_Buffer, PAGE_SIZE);
-        memset(g_Buffer, 0x41414141, 0x20);
-
-    }
-
     PSERIAL_DEVICE_EXTENSION extension;
     NTSTATUS status;
     WDFDEVICE hDevice;
@@ -159,12 +148,6 @@ Return Value:
     PREQUEST_CONTEXT reqContext;
     PREQUEST_CONTEXT reqContextXoff;
 
-    DbgBreakPoint();
-    DbgBreakPoint();
-    DbgBreakPoint();
-    DbgBreakPoint();
-    DbgBreakPoint();
-
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_WRITE,
                      ">SerialStartWrite(%p)\n", Extension);
 
@@ -222,7 +205,7 @@ Return Value:
                     &Extension->CurrentXoffRequest,
                     NULL,
                     NULL,
-                    Extension->XoffCountTimer,
+                    &Extension->XoffCountTimer,
                     NULL,
                     NULL,
                     SERIAL_REF_XOFF_REF
@@ -275,6 +258,13 @@ Return Value:
 
         }
 
+        //
+        // A gap timer left over from an earlier segmented write
+        // mustn't cut short a gap in this one.
+        //
+
+        SerialCancelTimer(&Extension->WriteGapTimer, Extension);
+
         //
         // The request may be going to the isr shortly.  Now
         // is a good time to initialize its reference counts.
@@ -294,7 +284,7 @@ Return Value:
             BOOLEAN result;
 
             result = SerialSetTimer(
-                Extension->WriteRequestTotalTimer,
+                &Extension->WriteRequestTotalTimer,
                 TotalTime
                 );
             if(result == FALSE) {
@@ -305,26 +295,12 @@ Return Value:
                 SERIAL_SET_REFERENCE( reqContext, SERIAL_REF_TOTAL_TIMER );
             }
         }
-        DbgBreakPoint();
-
-        typedef struct _WDF_INTERRUPT_SIMULATOR {
-            INT32 Unused;
-        } WDF_INTERRUPT_SIMULATOR, * PWDF_INTERRUPT_SIMULATOR;
-
-        WDF_INTERRUPT_SIMULATOR WdfTest = { 0 };
-        WdfTest.Unused = 1220838216;
-       
-        DbgBreakPoint();
 
         WdfInterruptSynchronize(
             Extension->WdfInterrupt,
-            // (WDFINTERRUPT)&WdfTest,
             SerialGiveWriteToIsr,
             Extension
-        );
-
-        DbgBreakPoint();
-
+            );
 
     } WHILE (FALSE);
 
@@ -400,6 +376,19 @@ Return Value:
 
             Extension->TotalCharsQueued -= reqContext->Length;
 
+            if (reqContext->IoctlCode == IOCTL_SERIAL_WRITE_SEGMENTS) {
+
+                //
+                // The segments are no longer needed; the (shared)
+                // buffer goes back with the count written.
+                //
+
+                *(PULONG)reqContext->SystemBuffer =
+                    (ULONG)reqContext->Information;
+                reqContext->Information = sizeof(ULONG);
+
+            }
+
         } else if (reqContext->MajorFunction == IRP_MJ_DEVICE_CONTROL) {
 
             WDFREQUEST request = *CurrentOpRequest;
@@ -476,7 +465,7 @@ Return Value:
                                                      ));
 
                     result = SerialSetTimer(
-                        Extension->XoffCountTimer,
+                        &Extension->XoffCountTimer,
                         delta
 
                         );
@@ -583,14 +572,17 @@ Return Value:
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_WRITE, ">SerialCompleteWrite(%p)\n",
                      Extension);
 
+    SerialAcquireCompletionLock(Extension);
 
     SerialTryToCompleteCurrent(Extension, NULL, STATUS_SUCCESS,
                                &Extension->CurrentWriteRequest,
                                Extension->WriteQueue, NULL,
-                               Extension->WriteRequestTotalTimer,
+                               &Extension->WriteRequestTotalTimer,
                                SerialStartWrite, SerialGetNextWrite,
                                SERIAL_REF_ISR);
 
+    SerialReleaseCompletionLock(Extension);
+
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_WRITE, "<SerialCompleteWrite\n");
 
 }
@@ -638,18 +630,7 @@ Return Value:
         (!Extension->CurrentWriteRequest) && IsQueueEmpty(Extension->WriteQueue)) {
 
         Extension->HistoryMask |= SERIAL_EV_TXEMPTY;
-        if (Extension->IrpMaskLocation) {
-
-            *Extension->IrpMaskLocation = Extension->HistoryMask;
-            Extension->IrpMaskLocation = NULL;
-            Extension->HistoryMask = 0;
-
-            SerialGetRequestContext(Extension->CurrentWaitRequest)->Information = sizeof(ULONG);
-            SerialInsertQueueDpc(
-                Extension->CommWaitDpc
-                );
-
-        }
+        SerialSignalWaitEvents(Extension);
 
         Extension->CountOfTryingToLowerRTS++;
         SerialPerhapsLowerRTS(Extension->WdfInterrupt, Extension);
@@ -693,8 +674,6 @@ Return Value:
 --*/
 
 {
-    DbgBreakPoint();
-
 
     PSERIAL_DEVICE_EXTENSION Extension = Context;
 
@@ -716,11 +695,33 @@ Return Value:
     // the data supplied by the user.
     //
 
-    if (reqContext->MajorFunction == IRP_MJ_WRITE) {
+    Extension->WriteSegmentsLeft = 0;
+    Extension->WriteSegmentBytesLeft = 0;
+    Extension->WriteGap = FALSE;
+
+    if ((reqContext->MajorFunction == IRP_MJ_WRITE) &&
+        (reqContext->IoctlCode == IOCTL_SERIAL_WRITE_SEGMENTS)) {
+
+        PSERIAL_WRITE_SEGMENTS segments = reqContext->SystemBuffer;
+
+        //
+        // A segmented write.  Start on the first segment; the isr
+        // moves on to the others as each one is sent.
+        //
+
+        Extension->WriteSegmentBase = reqContext->SystemBuffer;
+        Extension->WriteSegment = &segments->Segments[0];
+        Extension->WriteSegmentsLeft = segments->SegmentCount - 1;
+        Extension->WriteSegmentBytesLeft =
+            reqContext->Length - Extension->WriteSegment->Length;
+        Extension->WriteLength = Extension->WriteSegment->Length;
+        Extension->WriteCurrentChar =
+            Extension->WriteSegmentBase + Extension->WriteSegment->Offset;
+
+    } else if (reqContext->MajorFunction == IRP_MJ_WRITE) {
 
         Extension->WriteLength = reqContext->Length;
-       // Extension->WriteCurrentChar = reqContext->SystemBuffer;
-        Extension->WriteCurrentChar = (PUCHAR) g_Buffer;
+        Extension->WriteCurrentChar = reqContext->SystemBuffer;
 
     } else {
 
@@ -792,6 +793,287 @@ Return Value:
 }
 
 
+NTSTATUS
+SerialValidateWriteSegments(
+    IN PSERIAL_WRITE_SEGMENTS Segments,
+    IN size_t BufferLength,
+    OUT PULONG TotalLength
+    )
+
+/*++
+
+Routine Description:
+
+    This routine checks the input buffer of a segmented write: every
+    segment has to be in the buffer, and so does its data.
+
+Arguments:
+
+    Segments - The input buffer.
+
+    BufferLength - The length of the input buffer.
+
+    TotalLength - Receives the number of characters in all of the
+                  segments.
+
+Return Value:
+
+    STATUS_SUCCESS if the buffer describes a write that can be sent,
+    STATUS_INVALID_PARAMETER otherwise.
+
+--*/
+
+{
+    ULONG i;
+    ULONG total = 0;
+    PSERIAL_WRITE_SEGMENT segment;
+
+    if ((Segments->SegmentCount == 0) ||
+        (Segments->SegmentCount > SERIAL_MAX_WRITE_SEGMENTS) ||
+        (BufferLength < FIELD_OFFSET(SERIAL_WRITE_SEGMENTS, Segments) +
+                        (Segments->SegmentCount * sizeof(SERIAL_WRITE_SEGMENT)))) {
+
+        return STATUS_INVALID_PARAMETER;
+
+    }
+
+    for (i = 0; i < Segments->SegmentCount; i++) {
+
+        segment = &Segments->Segments[i];
+
+        if ((segment->Length == 0) ||
+            (segment->Offset > BufferLength) ||
+            (segment->Length > BufferLength - segment->Offset) ||
+            (total + segment->Length < total)) {
+
+            return STATUS_INVALID_PARAMETER;
+
+        }
+
+        total += segment->Length;
+
+    }
+
+    *TotalLength = total;
+
+    return STATUS_SUCCESS;
+
+}
+
+
+VOID
+SerialNextWriteSegment(
+    IN PSERIAL_DEVICE_EXTENSION Extension
+    )
+
+/*++
+
+Routine Description:
+
+    This routine moves a segmented write on to its next segment once
+    the last character of the current one has been given to the
+    hardware.  If the segment just sent asks for a gap after it, the
+    isr holds off the next one until the gap timer ends it.  The
+    characters just given to the hardware are still going out, so the
+    gap only starts counting once the transmitter is empty.
+
+    NOTE: This routine assumes that it is working at interrupt level.
+
+Arguments:
+
+    Extension - A pointer to the device extension.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    ULONG gap = Extension->WriteSegment->GapMicroseconds;
+
+    ASSERT(Extension->WriteSegmentsLeft);
+
+    Extension->WriteSegment++;
+    Extension->WriteSegmentsLeft--;
+    Extension->WriteSegmentBytesLeft -= Extension->WriteSegment->Length;
+    Extension->WriteLength = Extension->WriteSegment->Length;
+    Extension->WriteCurrentChar =
+        Extension->WriteSegmentBase + Extension->WriteSegment->Offset;
+
+    if (gap) {
+
+        Extension->WriteGap = TRUE;
+        Extension->WriteGapIdle = FALSE;
+        Extension->WriteGapTime = (LONGLONG)gap * 10;
+
+        SerialInsertQueueDpc(
+            Extension->WriteGapDpc
+            );
+
+    }
+
+}
+
+
+VOID
+SerialStartWriteGap(
+    IN WDFDPC Dpc
+    )
+
+/*++
+
+Routine Description:
+
+    This dpc starts the timer for a gap between the segments of a
+    segmented write.  Until the transmitter has emptied the timer only
+    runs for a character time, to look again; after that it runs for
+    the gap itself.
+
+Arguments:
+
+    Dpc - The dpc; its parent is the device.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    PSERIAL_DEVICE_EXTENSION Extension;
+    LARGE_INTEGER gapTime;
+
+    Extension = SerialGetDeviceExtension(WdfDpcGetParentObject(Dpc));
+
+    //
+    // The write may have been grabbed from the isr since.
+    //
+
+    if (!Extension->WriteGap) {
+        return;
+    }
+
+    if (Extension->WriteGapIdle) {
+
+        gapTime.QuadPart = -Extension->WriteGapTime;
+
+    } else {
+
+        gapTime.QuadPart = -SerialGetCharTime(Extension).QuadPart;
+
+    }
+
+    SerialSetTimer(
+        &Extension->WriteGapTimer,
+        gapTime
+        );
+
+}
+
+
+VOID
+SerialWriteGapTimeout(
+    IN PSERIAL_TIMER Timer
+    )
+
+/*++
+
+Routine Description:
+
+    This routine is invoked when the write gap timer expires, either to
+    look at the transmitter again or because the gap is over.
+
+Arguments:
+
+    Timer - The expired timer on the device's timer wheel.
+
+Return Value:
+
+    None.
+
+--*/
+
+{
+    PSERIAL_DEVICE_EXTENSION Extension = Timer->Extension;
+
+    WdfInterruptSynchronize(
+        Extension->WdfInterrupt,
+        SerialEndWriteGap,
+        Extension
+        );
+
+}
+
+
+BOOLEAN
+SerialEndWriteGap(
+    IN WDFINTERRUPT Interrupt,
+    IN PVOID Context
+    )
+
+/*++
+
+Routine Description:
+
+    While the last characters before a gap are still going out, this
+    routine checks whether the holding and shift registers have emptied.
+    Once they have, the gap proper is timed; until then the check is
+    repeated a character time later.
+
+    Once the gap is over it lets the isr carry on with the segmented
+    write, "tickling" the UART into interrupting if the transmit holding
+    register is already empty.
+
+    NOTE: This routine is called by WdfInterruptSynchronize.
+
+Arguments:
+
+    Context - Really a pointer to the device extension.
+
+Return Value:
+
+    This routine always returns FALSE.
+
+--*/
+
+{
+    PSERIAL_DEVICE_EXTENSION Extension = Context;
+
+    UNREFERENCED_PARAMETER(Interrupt);
+
+    if (Extension->WriteGap && !Extension->WriteGapIdle) {
+
+        if ((SerialProcessLSR(Extension) &
+             (SERIAL_LSR_THRE | SERIAL_LSR_TEMT)) ==
+             (SERIAL_LSR_THRE | SERIAL_LSR_TEMT)) {
+
+            Extension->WriteGapIdle = TRUE;
+
+        }
+
+        SerialInsertQueueDpc(
+            Extension->WriteGapDpc
+            );
+
+    } else if (Extension->WriteGap) {
+
+        Extension->WriteGap = FALSE;
+
+        if (Extension->WriteLength && Extension->HoldingEmpty) {
+
+            DISABLE_ALL_INTERRUPTS(Extension, Extension->Controller);
+            ENABLE_ALL_INTERRUPTS(Extension, Extension->Controller);
+
+        }
+
+    }
+
+    return FALSE;
+
+}
+
+
 VOID
 SerialCancelCurrentWrite(
     IN WDFREQUEST Request
@@ -831,7 +1113,7 @@ Return Value:
         &Extension->CurrentWriteRequest,
         Extension->WriteQueue,
         NULL,
-        Extension->WriteRequestTotalTimer,
+        &Extension->WriteRequestTotalTimer,
         SerialStartWrite,
         SerialGetNextWrite,
         SERIAL_REF_CANCEL
@@ -842,7 +1124,7 @@ Return Value:
 
 VOID
 SerialWriteTimeout(
-    IN WDFTIMER Timer
+    IN PSERIAL_TIMER Timer
     )
 
 /*++
@@ -863,7 +1145,7 @@ Return Value:
 
     PSERIAL_DEVICE_EXTENSION Extension = NULL;
 
-    Extension = SerialGetDeviceExtension(WdfTimerGetParentObject(Timer));
+    Extension = Timer->Extension;
 
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_WRITE, ">SerialWriteTimeout(%p)\n",
                      Extension);
@@ -871,7 +1153,7 @@ Return Value:
     SerialTryToCompleteCurrent(Extension, SerialGrabWriteFromIsr,
                                STATUS_TIMEOUT, &Extension->CurrentWriteRequest,
                                Extension->WriteQueue, NULL,
-                               Extension->WriteRequestTotalTimer,
+                               &Extension->WriteRequestTotalTimer,
                                SerialStartWrite, SerialGetNextWrite,
                                SERIAL_REF_TOTAL_TIMER);
 
@@ -936,7 +1218,9 @@ Return Value:
 
         if (reqContext->MajorFunction == IRP_MJ_WRITE) {
 
-            reqContext->Information = reqContext->Length -Extension->WriteLength;
+            reqContext->Information = reqContext->Length -
+                                      (Extension->WriteLength +
+                                       Extension->WriteSegmentBytesLeft);
 
         } else {
 
@@ -955,6 +1239,9 @@ Return Value:
             );
 
         Extension->WriteLength = 0;
+        Extension->WriteSegmentsLeft = 0;
+        Extension->WriteSegmentBytesLeft = 0;
+        Extension->WriteGap = FALSE;
 
     }
 
@@ -1071,7 +1358,7 @@ Return Value:
 
     SerialTryToCompleteCurrent(Extension, NULL, STATUS_SUCCESS,
                                &Extension->CurrentXoffRequest, NULL, NULL,
-                               Extension->XoffCountTimer, NULL, NULL,
+                               &Extension->XoffCountTimer, NULL, NULL,
                                SERIAL_REF_ISR);
 
 
@@ -1082,7 +1369,7 @@ Return Value:
 
 VOID
 SerialTimeoutXoff(
-    IN WDFTIMER Timer
+    IN PSERIAL_TIMER Timer
     )
 
 /*++
@@ -1105,7 +1392,7 @@ Return Value:
 
     PSERIAL_DEVICE_EXTENSION Extension = NULL;
 
-    Extension = SerialGetDeviceExtension(WdfTimerGetParentObject(Timer));
+    Extension = Timer->Extension;
 
     SerialDbgPrintEx(TRACE_LEVEL_INFORMATION, DBG_WRITE, ">SerialTimeoutXoff(%p)\n", Extension);
 
@@ -1157,7 +1444,7 @@ Return Value:
         &Extension->CurrentXoffRequest,
         NULL,
         NULL,
-        Extension->XoffCountTimer,
+        &Extension->XoffCountTimer,
         NULL,
         NULL,
         SERIAL_REF_CANCEL